@@ -52,7 +52,8 @@ UINTN                         mOptionCount = 0;
 CHAR16                        *mKeyNames   = NULL;
 
 /**
-  Helper internal function to reset all local variable in this file.
+  Helper internal function to reset all local variable in this file. The boot options are kept
+  for the next visit of this page, until CONF_APP_STATE_BOOT_OPTIONS is invalidated.
 **/
 STATIC
 VOID
@@ -60,10 +61,8 @@ ResetGlobals (
   VOID
   )
 {
-  mBootOptState    = BootOptInit;
-  mBootOptions     = NULL;
-  mBootOptionCount = 0;
-  mOpCandidate     = 0;
+  mBootOptState = BootOptInit;
+  mOpCandidate  = 0;
 
   mOptionCount = 0;
   if (mKeyOptions != NULL) {
@@ -80,7 +79,8 @@ ResetGlobals (
 /**
   Helper function to print registered boot options.
 
-  Note: this function will not register new options.
+  Note: this function will not register new options, and only reads the options again once
+  CONF_APP_STATE_BOOT_OPTIONS is invalidated.
 
   @retval EFI_SUCCESS                   This function always returns success.
 **/
@@ -96,9 +96,17 @@ PrintBootOptions (
   Print (L"Boot Options:\n");
   Print (L"\n");
 
-  mBootOptions = EfiBootManagerGetLoadOptions (&mBootOptionCount, LoadOptionTypeBoot);
-  mKeyOptions  = AllocatePool (sizeof (ConfAppKeyOptions) * (mBootOptionCount + STATIC_BOOT_OPTIONS));
-  mKeyNames    = AllocatePool (sizeof (L"#####") * (mBootOptionCount));
+  if ((mConfAppState.Valid & CONF_APP_STATE_BOOT_OPTIONS) == 0) {
+    if (mBootOptions != NULL) {
+      EfiBootManagerFreeLoadOptions (mBootOptions, mBootOptionCount);
+    }
+
+    mBootOptions         = EfiBootManagerGetLoadOptions (&mBootOptionCount, LoadOptionTypeBoot);
+    mConfAppState.Valid |= CONF_APP_STATE_BOOT_OPTIONS;
+  }
+
+  mKeyOptions = AllocatePool (sizeof (ConfAppKeyOptions) * (mBootOptionCount + STATIC_BOOT_OPTIONS));
+  mKeyNames   = AllocatePool (sizeof (L"#####") * (mBootOptionCount));
   for (OptionIndex = 0; OptionIndex < mBootOptionCount; OptionIndex++) {
     UnicodeSPrint ((CHAR16 *)((CHAR8 *)mKeyNames + OptionIndex * sizeof (L"#####")), sizeof (L"#####"), L"%d", OptionIndex + 1);
     mKeyOptions[OptionIndex].KeyName             = (CHAR16 *)((CHAR8 *)mKeyNames + OptionIndex * sizeof (L"#####"));
@@ -88,6 +88,42 @@ ConfState_t                        mConfState       = MainInit;
 EFI_SIMPLE_TEXT_INPUT_EX_PROTOCOL  *mSimpleTextInEx = NULL;
 SECURE_BOOT_PAYLOAD_INFO           *mSecureBootKeys;
 UINT8                              mSecureBootKeysCount;
+CONF_APP_STATE_CACHE               mConfAppState = { 0 };
+
+/**
+  Drop cached firmware state so that it is queried again the next time a page needs it. This should be invoked
+  whenever the state is changed.
+
+  @param[in]  Mask    The CONF_APP_STATE_* bits of the state to drop.
+**/
+VOID
+EFIAPI
+InvalidateConfAppState (
+  IN  UINT32  Mask
+  )
+{
+  mConfAppState.Valid &= ~Mask;
+}
+
+/**
+  Quick helper function to see if the system is in manufacturing mode, queried once for all pages.
+
+  @retval     TRUE    The system is in manufacturing mode.
+  @retval     FALSE   Otherwise...
+
+**/
+BOOLEAN
+IsConfAppInManufacturingMode (
+  VOID
+  )
+{
+  if ((mConfAppState.Valid & CONF_APP_STATE_MFG_MODE) == 0) {
+    mConfAppState.ManufacturingMode = IsSystemInManufacturingMode ();
+    mConfAppState.Valid            |= CONF_APP_STATE_MFG_MODE;
+  }
+
+  return mConfAppState.ManufacturingMode;
+}
 
 /**
   Quick helper function to see if ReadyToBoot has already been signalled.
@@ -107,6 +143,10 @@ IsPostReadyToBoot (
   UINTN            Size;
   BOOLEAN          Result = FALSE;
 
+  if ((mConfAppState.Valid & CONF_APP_STATE_READY_TO_BOOT) != 0) {
+    return mConfAppState.PostReadyToBoot;
+  }
+
   Size = sizeof (Indicator);
 
   Status = gRT->GetVariable (
@@ -118,6 +158,12 @@ IsPostReadyToBoot (
                   );
   Result = (!EFI_ERROR (Status) && (Attributes == READY_TO_BOOT_INDICATOR_VAR_ATTR));
 
+  // ReadyToBoot cannot be undone, so only a signalled ReadyToBoot is kept
+  if (Result) {
+    mConfAppState.PostReadyToBoot = TRUE;
+    mConfAppState.Valid          |= CONF_APP_STATE_READY_TO_BOOT;
+  }
+
   return Result;
 } // IsPostReadyToBoot()
 
@@ -63,6 +63,52 @@ typedef enum SetupConfState_t_def {
   SetupConfMax
 } SetupConfState_t;
 
+//
+// Bulk serial transfer: sending SVD_SERIAL_BULK_START as the first keystroke of a serial update switches to reading
+// a SVD_SERIAL_BULK_HEADER, the XML or binary settings packet and the CRC32 of the payload straight from the
+// console input serial port. The terminal driver is stopped on that port for the transfer, ConfApp then writes
+// SVD_SERIAL_BULK_READY and the sender must not send the frame before it sees it. The transfer ends with
+// SVD_SERIAL_BULK_ACK once the settings are applied, or SVD_SERIAL_BULK_NAK. Tools/SendSvdSerialBulk.py is the sender.
+//
+#define SVD_SERIAL_BULK_START          0x02                   // Ctrl-B
+#define SVD_SERIAL_BULK_SIGNATURE      SIGNATURE_32 ('S', 'V', 'D', 'B')
+#define SVD_SERIAL_BULK_READY          SIGNATURE_32 ('S', 'V', 'D', 'R')
+#define SVD_SERIAL_BULK_ACK            SIGNATURE_32 ('S', 'V', 'D', 'A')
+#define SVD_SERIAL_BULK_NAK            SIGNATURE_32 ('S', 'V', 'D', 'N')
+#define SVD_SERIAL_BULK_MAX_SIZE       SIZE_16MB
+#define SVD_SERIAL_BULK_IDLE_STALL     100000                 // 100ms between reads that return nothing
+#define SVD_SERIAL_BULK_IDLE_RETRIES   50                     // Give up after 5s without any data
+#define SVD_SERIAL_BULK_PROGRESS_STEP  10                     // Percent
+
+//
+// Binary settings packet: a SVD_BINARY_PACKET_HEADER followed by a raw variable list, the same payload a XML
+// settings packet carries Base64 encoded in each Value element, and a WIN_CERTIFICATE_UEFI_GUID holding a detached
+// PKCS7 signature of the header and variable list. The signature must chain to
+// PcdConfigurationBinarySettingsTrustedCert, binary settings packets are rejected while it is empty.
+//
+#define SVD_BINARY_PACKET_SIGNATURE       SIGNATURE_32 ('S', 'V', 'D', 'P')
+#define SVD_BINARY_PACKET_HEADER_VERSION  2
+
+//
+// Firmware state the pages query when they are drawn, cached in mConfAppState so that moving between pages does not
+// query it again. Each bit marks a piece of state as cached, a page clears the bits of the state it changes through
+// InvalidateConfAppState. The boot options and the configuration policies are big enough to be kept by the page
+// showing them, only their bits are held here.
+//
+#define CONF_APP_STATE_MFG_MODE       BIT0
+#define CONF_APP_STATE_READY_TO_BOOT  BIT1
+#define CONF_APP_STATE_SECURE_BOOT    BIT2
+#define CONF_APP_STATE_BOOT_OPTIONS   BIT3
+#define CONF_APP_STATE_POLICY         BIT4
+#define CONF_APP_STATE_ALL            (BIT0 | BIT1 | BIT2 | BIT3 | BIT4)
+
+typedef struct {
+  UINT32     Valid;                     // CONF_APP_STATE_* bits of the state that is cached
+  BOOLEAN    ManufacturingMode;         // CONF_APP_STATE_MFG_MODE
+  BOOLEAN    PostReadyToBoot;           // CONF_APP_STATE_READY_TO_BOOT
+  UINTN      SecureBootConfig;          // CONF_APP_STATE_SECURE_BOOT
+} CONF_APP_STATE_CACHE;
+
 #pragma pack (push, 1)
 
 typedef struct {
@@ -77,6 +123,21 @@ typedef struct {
 
 STATIC_ASSERT (sizeof (UINT32) == sizeof (ConfState_t), "sizeof (UINT32) does not match sizeof (enum) in this environment");
 
+typedef struct {
+  UINT32    Signature;
+  UINT32    PayloadSize;
+} SVD_SERIAL_BULK_HEADER;
+
+typedef struct {
+  UINT32    Signature;                  // SVD_BINARY_PACKET_SIGNATURE
+  UINT16    HeaderVersion;              // SVD_BINARY_PACKET_HEADER_VERSION
+  UINT16    HeaderSize;                 // Offset of the payload from the start of the packet
+  UINT32    Version;                    // Same as the Version element of a XML settings packet
+  UINT32    LowestSupportedVersion;     // Same as the LowestSupportedVersion element of a XML settings packet
+  UINT32    PayloadSize;                // Size of the variable list following the header, the signature follows it
+  UINT32    PayloadCrc32;               // CRC32 of the variable list
+} SVD_BINARY_PACKET_HEADER;
+
 #pragma pack (pop)
 
 /**
@@ -165,6 +226,30 @@ PrintScreenInit (
   VOID
   );
 
+/**
+  Drop cached firmware state so that it is queried again the next time a page needs it. This should be invoked
+  whenever the state is changed.
+
+  @param[in]  Mask    The CONF_APP_STATE_* bits of the state to drop.
+**/
+VOID
+EFIAPI
+InvalidateConfAppState (
+  IN  UINT32  Mask
+  );
+
+/**
+  Quick helper function to see if the system is in manufacturing mode, queried once for all pages.
+
+  @retval     TRUE    The system is in manufacturing mode.
+  @retval     FALSE   Otherwise...
+
+**/
+BOOLEAN
+IsConfAppInManufacturingMode (
+  VOID
+  );
+
 /**
   State machine for system information page. It will display fundamental information, including
   UEFI version, system time, and configuration settings.
@@ -224,5 +309,6 @@ SetupConfMgr (
 extern EFI_SIMPLE_TEXT_INPUT_EX_PROTOCOL  *mSimpleTextInEx;
 extern SECURE_BOOT_PAYLOAD_INFO           *mSecureBootKeys;
 extern UINT8                              mSecureBootKeysCount;
+extern CONF_APP_STATE_CACHE               mConfAppState;
 
 #endif // CONF_APP_H_
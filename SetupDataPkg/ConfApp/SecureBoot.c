@@ -110,7 +110,12 @@ PrintSBOptions (
   gST->ConOut->SetAttribute (gST->ConOut, EFI_TEXT_ATTR (EFI_WHITE, EFI_BLACK));
   Print (L"Current Status:\t\t");
 
-  mCurrentState = GetCurrentSecureBootConfig ();
+  if ((mConfAppState.Valid & CONF_APP_STATE_SECURE_BOOT) == 0) {
+    mConfAppState.SecureBootConfig = GetCurrentSecureBootConfig ();
+    mConfAppState.Valid           |= CONF_APP_STATE_SECURE_BOOT;
+  }
+
+  mCurrentState = mConfAppState.SecureBootConfig;
   if (mCurrentState == MU_SB_CONFIG_NONE) {
     gST->ConOut->SetAttribute (gST->ConOut, EFI_TEXT_ATTR (EFI_RED, EFI_BLACK));
     Print (L"None\n");
@@ -229,6 +234,7 @@ SecureBootMgr (
     case SecureBootClear:
       DEBUG ((DEBUG_INFO, "Selected clear Secure Boot Key\n"));
       if (mCurrentState != MU_SB_CONFIG_NONE) {
+        InvalidateConfAppState (CONF_APP_STATE_SECURE_BOOT);
         Status = DeleteSecureBootVariables ();
         if (!EFI_ERROR (Status)) {
           mSecBootState = SecureBootConfChange;
@@ -244,6 +250,7 @@ SecureBootMgr (
       DEBUG ((DEBUG_INFO, "Selected %s\n", mSecureBootKeys[mSelectedKeyIndex].SecureBootKeyName));
       if (mCurrentState != mSelectedKeyIndex) {
         // First wipe off existing variables if it is enrolled somehow
+        InvalidateConfAppState (CONF_APP_STATE_SECURE_BOOT);
         if (mCurrentState != MU_SB_CONFIG_NONE) {
           Status = DeleteSecureBootVariables ();
           if (EFI_ERROR (Status)) {
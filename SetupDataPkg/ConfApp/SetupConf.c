@@ -10,6 +10,9 @@
 #include <XmlTypes.h>
 
 #include <Protocol/Policy.h>
+#include <Protocol/SerialIo.h>
+#include <Guid/GlobalVariable.h>
+#include <Guid/WinCertificate.h>
 
 #include <Library/DebugLib.h>
 #include <Library/PcdLib.h>
@@ -19,13 +22,18 @@
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
 #include <Library/UefiLib.h>
+#include <Library/DevicePathLib.h>
 #include <Library/ResetSystemLib.h>
+#include <Library/BaseCryptLib.h>
 #include <Library/XmlTreeLib.h>
 #include <Library/XmlTreeQueryLib.h>
 #include <Library/SvdXmlSettingSchemaSupportLib.h>
 #include <Library/PerformanceLib.h>
 #include <Library/ConfigVariableListLib.h>
+#include <Library/ConfigCrcLib.h>
+#include <Library/ConfigBase64Lib.h>
 #include <Library/ConfigSystemModeLib.h>
+#include <Library/ConfigKnobShimLib.h>
 
 #include "ConfApp.h"
 #include "SvdUsb/SvdUsb.h"
@@ -156,7 +164,7 @@ PrintOptions (
   Print (L"Setup Configuration Options:\n");
   Print (L"\n");
 
-  if (!IsSystemInManufacturingMode ()) {
+  if (!IsConfAppInManufacturingMode ()) {
     gST->ConOut->SetAttribute (gST->ConOut, EFI_TEXT_ATTR (EFI_YELLOW, EFI_BLACK));
     Print (L"Updating configuration will not take any effect per platform state:\n");
     SetupConfStateOptions[0].DescriptionTextAttr = EFI_TEXT_ATTR (EFI_DARKGRAY, EFI_BLACK);
@@ -174,277 +182,456 @@ PrintOptions (
   return Status;
 }
 
+// How WriteSVDSetting commits each variable of an SVD blob
+#define SVD_VAR_UNCHANGED  0     // Current contents already match, nothing to do
+#define SVD_VAR_WRITE      1     // Write over the current variable, if any
+#define SVD_VAR_REPLACE    2     // Size or attributes change, delete before writing
+
 /**
   Set arbitrary SVD values to variable storage
 
-  @param Value     a pointer to the variable list
-  @param ValueSize Size of the data for this setting.
+  Every variable is compared against its current contents first, so unchanged variables are not
+  written and variables are only deleted when their size or attributes change. All deletes are
+  issued before any writes, letting the variable driver reclaim the deleted space at most once
+  for the whole blob rather than once per variable. The config policy cached by ConfigKnobShimLib
+  is invalidated before the first variable changes. A compressed variable list is expanded first.
+
+  @param Value          a pointer to the variable list
+  @param ValueSize      Size of the data for this setting.
+  @param FlashWrites    Incremented by the number of SetVariable calls issued.
 
-  @retval EFI_SUCCESS If setting could be set.
-  @retval Error       Setting not set.
+  @retval EFI_SUCCESS           If setting could be set.
+  @retval EFI_OUT_OF_RESOURCES  Not enough memory to compare against current variables.
+  @retval Error                 Setting not set.
 **/
 STATIC
 EFI_STATUS
 WriteSVDSetting (
-  IN  CONST UINT8  *Value,
-  IN        UINTN  ValueSize
+  IN      CONST UINT8  *Value,
+  IN            UINTN  ValueSize,
+  IN OUT        UINTN  *FlashWrites
   )
 {
-  EFI_STATUS             Status             = EFI_SUCCESS;
-  UINT32                 ListIndex          = 0;
-  CONFIG_VAR_LIST_ENTRY  *ConfigVarListPtr  = NULL;
-  UINTN                  ConfigVarListCount = 0;
-
-  if ((Value == NULL) || (ValueSize == 0)) {
+  EFI_STATUS                  Status;
+  EFI_STATUS                  WriteStatus;
+  CONFIG_VAR_LIST_ITERATOR    Iterator;
+  CONFIG_VAR_LIST_ENTRY_VIEW  Entry;
+  UINTN                       EntryCount;
+  UINTN                       MaxDataSize;
+  UINTN                       Index;
+  UINT8                       *Plan    = NULL;
+  UINT8                       *Current = NULL;
+  VOID                        *Packed  = NULL;
+  UINTN                       CurrentSize;
+  UINT32                      CurrentAttributes;
+
+  if ((Value == NULL) || (ValueSize == 0) || (FlashWrites == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
 
-  Status = RetrieveActiveConfigVarList (Value, ValueSize, &ConfigVarListPtr, &ConfigVarListCount);
+  if (IsCompressedConfigVarList (Value, ValueSize)) {
+    // Every pass below iterates the list in place, so expand it once up front
+    Status = RetrieveDecompressedConfigVarList (Value, ValueSize, &Packed, &ValueSize);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "Failed to expand compressed configuration elements - %r\n", Status));
+      return Status;
+    }
+
+    Value = Packed;
+  }
+
+  Status = ConfigVarListIterInit (Value, ValueSize, &Iterator);
   if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to initialize configuration element iterator - %r\n", Status));
+    goto Done;
+  }
+
+  // Validate every element before touching variable storage, so a corrupted blob leaves it unchanged
+  EntryCount  = 0;
+  MaxDataSize = 0;
+  do {
+    Status = ConfigVarListIterNext (&Iterator, &Entry);
+    if (!EFI_ERROR (Status)) {
+      EntryCount++;
+      MaxDataSize = MAX (MaxDataSize, Entry.DataSize);
+    }
+  } while (!EFI_ERROR (Status));
+
+  if (Status != EFI_NOT_FOUND) {
     DEBUG ((DEBUG_ERROR, "Failed to extract all configuration elements - %r\n", Status));
     goto Done;
   }
 
-  for (ListIndex = 0; ListIndex < ConfigVarListCount; ListIndex++) {
-    // first delete the variable in case of size or attributes change, not validated here as this is only allowed
-    // in manufacturing mode. Don't retrieve the status, if we fail to delete, try to write it anyway. If we fail
-    // there, just log it and move on
+  Status = EFI_SUCCESS;
+  if (EntryCount == 0) {
+    goto Done;
+  }
+
+  Plan    = AllocatePool (EntryCount);
+  Current = AllocatePool (MAX (MaxDataSize, 1));
+  if ((Plan == NULL) || (Current == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a - Failed to allocate buffers to compare %d variables\n", __FUNCTION__, EntryCount));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Done;
+  }
+
+  // Decide what each variable needs, reading a larger current variable fails as too small and so gets replaced
+  ConfigVarListIterInit (Value, ValueSize, &Iterator);
+  for (Index = 0; !EFI_ERROR (ConfigVarListIterNext (&Iterator, &Entry)); Index++) {
+    CurrentSize = Entry.DataSize;
+    Status      = gRT->GetVariable (
+                         (CHAR16 *)Entry.Name,
+                         (EFI_GUID *)Entry.Guid,
+                         &CurrentAttributes,
+                         &CurrentSize,
+                         Current
+                         );
+    if (Status == EFI_NOT_FOUND) {
+      Plan[Index] = SVD_VAR_WRITE;
+    } else if (EFI_ERROR (Status) || (CurrentSize != Entry.DataSize) || (CurrentAttributes != Entry.Attributes)) {
+      Plan[Index] = SVD_VAR_REPLACE;
+    } else if (CompareMem (Current, Entry.Data, Entry.DataSize) != 0) {
+      Plan[Index] = SVD_VAR_WRITE;
+    } else {
+      DEBUG ((DEBUG_INFO, "SVD Setting %s is unchanged, skipping\n", Entry.Name));
+      Plan[Index] = SVD_VAR_UNCHANGED;
+    }
+  }
+
+  for (Index = 0; Index < EntryCount; Index++) {
+    if (Plan[Index] != SVD_VAR_UNCHANGED) {
+      break;
+    }
+  }
+
+  if (Index < EntryCount) {
+    // The cached policy no longer matches the settings, and would not match their new fingerprint either. Deleting it
+    // fails if there is none, or once the cache is locked at ReadyToBoot
+    InvalidateConfAppState (CONF_APP_STATE_POLICY);
     gRT->SetVariable (
-           ConfigVarListPtr->Name,
-           &ConfigVarListPtr->Guid,
+           CONFIG_KNOB_POLICY_CACHE_INFO_VARIABLE_NAME,
+           &gConfigKnobPolicyCacheVariableGuid,
            0,
            0,
            NULL
            );
+    (*FlashWrites)++;
+  }
 
-    // write variable directly to var storage
-    Status = gRT->SetVariable (
-                    ConfigVarListPtr->Name,
-                    &ConfigVarListPtr->Guid,
-                    ConfigVarListPtr->Attributes,
-                    ConfigVarListPtr->DataSize,
-                    ConfigVarListPtr->Data
-                    );
+  // Delete the variables changing size or attributes, not validated here as this is only allowed in manufacturing
+  // mode. Don't retrieve the status, if we fail to delete, try to write it anyway.
+  ConfigVarListIterInit (Value, ValueSize, &Iterator);
+  for (Index = 0; !EFI_ERROR (ConfigVarListIterNext (&Iterator, &Entry)); Index++) {
+    if (Plan[Index] == SVD_VAR_REPLACE) {
+      gRT->SetVariable (
+             (CHAR16 *)Entry.Name,
+             (EFI_GUID *)Entry.Guid,
+             0,
+             0,
+             NULL
+             );
+      (*FlashWrites)++;
+    }
+  }
 
-    if (EFI_ERROR (Status)) {
-      // failed to set variable, continue to try with other variables
-      DEBUG ((DEBUG_ERROR, "Failed to set SVD Setting %s, continuing to try next variables\n", ConfigVarListPtr->Name));
+  // write variables directly to var storage, if we fail there, just log it and move on
+  Status = EFI_SUCCESS;
+  ConfigVarListIterInit (Value, ValueSize, &Iterator);
+  for (Index = 0; !EFI_ERROR (ConfigVarListIterNext (&Iterator, &Entry)); Index++) {
+    if (Plan[Index] == SVD_VAR_UNCHANGED) {
+      continue;
     }
 
-    FreePool (ConfigVarListPtr->Name);
-    FreePool (ConfigVarListPtr->Data);
+    WriteStatus = gRT->SetVariable (
+                         (CHAR16 *)Entry.Name,
+                         (EFI_GUID *)Entry.Guid,
+                         Entry.Attributes,
+                         Entry.DataSize,
+                         (VOID *)Entry.Data
+                         );
+    (*FlashWrites)++;
+
+    if (EFI_ERROR (WriteStatus)) {
+      // failed to set variable, continue to try with other variables
+      DEBUG ((DEBUG_ERROR, "Failed to set SVD Setting %s, continuing to try next variables\n", Entry.Name));
+      Status = WriteStatus;
+    }
   }
 
 Done:
-  if (ConfigVarListPtr != NULL) {
-    FreePool (ConfigVarListPtr);
+  if (Plan != NULL) {
+    FreePool (Plan);
+  }
+
+  if (Current != NULL) {
+    FreePool (Current);
+  }
+
+  if (Packed != NULL) {
+    FreePool (Packed);
   }
 
   return Status;
 }
 
 /**
-  Apply all settings from XML to their associated setting providers.
+  Apply the variable list carried by a binary settings packet.
 
-  @param[in] Buffer         Complete buffer of config settings in the format of XML.
-  @param[in] Count          Number of bytes inside buffer, excluding NULL terminator.
+  @param[in] Buffer         Complete binary settings packet, starting with a SVD_BINARY_PACKET_HEADER.
+  @param[in] Count          Number of bytes inside buffer.
 
-  @retval EFI_SUCCESS       Settings are applied successfully.
-  @retval other             Error occurred while attempting to apply supplied settings.
+  @retval EFI_SUCCESS               Settings are applied successfully.
+  @retval EFI_NO_MAPPING            The packet header or signature is malformed or its version information is invalid.
+  @retval EFI_CRC_ERROR             The payload does not match the CRC32 in the header.
+  @retval EFI_SECURITY_VIOLATION    The packet is not signed by PcdConfigurationBinarySettingsTrustedCert.
+  @retval other                     Error occurred while attempting to apply supplied settings.
 **/
+STATIC
 EFI_STATUS
-ApplySettings (
-  IN  CHAR8  *Buffer,
-  IN  UINTN  Count
+ApplyBinarySettings (
+  IN  CONST UINT8  *Buffer,
+  IN  UINTN        Count
   )
 {
-  XmlNode  *InputRootNode     = NULL;                     // The root xml node for the Input list.
-  XmlNode  *InputPacketNode   = NULL;                     // The SettingsPacket node in the Input list
-  XmlNode  *InputSettingsNode = NULL;                     // The Settings node for the Input list.
-  XmlNode  *InputTempNode     = NULL;                     // Temp node ptr to use when moving thru the Input list
-
-  XmlNode  *ResultRootNode     = NULL;                    // The root xml node in the result list
-  XmlNode  *ResultPacketNode   = NULL;                    // The ResultsPacket node in the result list
-  XmlNode  *ResultSettingsNode = NULL;                    // The Settings Node in the result list
-
-  LIST_ENTRY  *Link = NULL;
-  EFI_STATUS  Status;
-  EFI_TIME    ApplyTime;
-  UINTN       Version       = 0;
-  UINTN       Lsv           = 0;
-  BOOLEAN     ResetRequired = FALSE;
-
-  UINTN       b64Size;
-  UINTN       ValueSize;
-  UINT8       *ByteArray = NULL;
-  CONST VOID  *SetValue  = NULL;
-
-  //
-  // Create Node List from input
-  //
-  Status = CreateXmlTree ((CHAR8 *)Buffer, Count, &InputRootNode);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "%a - Couldn't create a node list from the payload xml  %r\n", __FUNCTION__, Status));
+  EFI_STATUS                 Status;
+  SVD_BINARY_PACKET_HEADER   Header;
+  WIN_CERTIFICATE_UEFI_GUID  CertHeader;
+  CONST UINT8                *Payload;
+  UINTN                      SignedSize;
+  UINTN                      FlashWrites = 0;
+
+  // The packet may come from a file or the serial port at any alignment
+  CopyMem (&Header, Buffer, sizeof (Header));
+  if ((Header.HeaderVersion != SVD_BINARY_PACKET_HEADER_VERSION) ||
+      (Header.HeaderSize < sizeof (Header)) ||
+      (Header.HeaderSize > Count) ||
+      (Header.PayloadSize > Count - Header.HeaderSize) ||
+      (Count - Header.HeaderSize - Header.PayloadSize <= OFFSET_OF (WIN_CERTIFICATE_UEFI_GUID, CertData)))
+  {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a - Invalid binary settings packet header, version %d, header size 0x%x, payload size 0x%x, packet size 0x%x\n",
+      __FUNCTION__,
+      Header.HeaderVersion,
+      Header.HeaderSize,
+      Header.PayloadSize,
+      Count
+      ));
     Status = EFI_NO_MAPPING;
     goto EXIT;
   }
 
-  // Print the list
-  DEBUG ((DEBUG_INFO, "PRINTING INPUT XML - Start\n"));
-  DebugPrintXmlTree (InputRootNode, 0);
-  DEBUG ((DEBUG_INFO, "PRINTING INPUT XML - End\n"));
-
-  //
-  // Create Node List for output
-  //
-  Status = gRT->GetTime (&ApplyTime, NULL);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "%a - Failed to get time. %r\n", __FUNCTION__, Status));
-    Status = EFI_ABORTED;
+  // The signature covers the header and payload and takes the rest of the packet
+  SignedSize = Header.HeaderSize + Header.PayloadSize;
+  CopyMem (&CertHeader, Buffer + SignedSize, OFFSET_OF (WIN_CERTIFICATE_UEFI_GUID, CertData));
+  if ((CertHeader.Hdr.dwLength != Count - SignedSize) ||
+      (CertHeader.Hdr.wRevision != 0x0200) ||
+      (CertHeader.Hdr.wCertificateType != WIN_CERT_TYPE_EFI_GUID) ||
+      !CompareGuid (&CertHeader.CertType, &gEfiCertPkcs7Guid))
+  {
+    DEBUG ((DEBUG_ERROR, "%a - Invalid binary settings packet signature, length 0x%x\n", __FUNCTION__, CertHeader.Hdr.dwLength));
+    Status = EFI_NO_MAPPING;
     goto EXIT;
   }
 
-  ResultRootNode = New_ResultPacketNodeList (&ApplyTime);
-  if (ResultRootNode == NULL) {
-    DEBUG ((DEBUG_ERROR, "%a - Couldn't create a node list from the result xml.\n", __FUNCTION__));
-    Status = EFI_ABORTED;
+  DEBUG ((DEBUG_INFO, "Incoming Version: %d\n", Header.Version));
+  DEBUG ((DEBUG_INFO, "Incoming LSV: %d\n", Header.LowestSupportedVersion));
+  if (Header.LowestSupportedVersion > Header.Version) {
+    DEBUG ((DEBUG_ERROR, "%a - LSV (%d) can't be larger than current version\n", __FUNCTION__, Header.LowestSupportedVersion));
+    Status = EFI_NO_MAPPING;
     goto EXIT;
   }
 
-  // Get Input SettingsPacket Node
-  InputPacketNode = GetSettingsPacketNode (InputRootNode);
-  if (InputPacketNode == NULL) {
-    DEBUG ((DEBUG_ERROR, "Failed to Get Input SettingsPacket Node\n"));
-    Status = EFI_NO_MAPPING;
+  Payload = Buffer + Header.HeaderSize;
+  if (ConfigCalculateCrc32 (Payload, Header.PayloadSize) != Header.PayloadCrc32) {
+    DEBUG ((DEBUG_ERROR, "%a - Binary settings payload CRC32 mismatch, expected 0x%x\n", __FUNCTION__, Header.PayloadCrc32));
+    Status = EFI_CRC_ERROR;
     goto EXIT;
   }
 
-  // Get Output ResultsPacket Node
-  ResultPacketNode = GetResultsPacketNode (ResultRootNode);
-  if (ResultPacketNode == NULL) {
-    DEBUG ((DEBUG_ERROR, "Failed to Get Output ResultsPacket Node\n"));
-    Status = EFI_NO_MAPPING;
+  // The CRC32 only catches corruption, the settings are only taken from a trusted signer
+  if ((PcdGetSize (PcdConfigurationBinarySettingsTrustedCert) <= 1) ||
+      !Pkcs7Verify (
+         Buffer + SignedSize + OFFSET_OF (WIN_CERTIFICATE_UEFI_GUID, CertData),
+         Count - SignedSize - OFFSET_OF (WIN_CERTIFICATE_UEFI_GUID, CertData),
+         PcdGetPtr (PcdConfigurationBinarySettingsTrustedCert),
+         PcdGetSize (PcdConfigurationBinarySettingsTrustedCert),
+         Buffer,
+         SignedSize
+         ))
+  {
+    DEBUG ((DEBUG_ERROR, "%a - Binary settings packet is not signed by the trusted certificate\n", __FUNCTION__));
+    Status = EFI_SECURITY_VIOLATION;
     goto EXIT;
   }
 
-  //
-  // Get input version
-  //
-  InputTempNode = FindFirstChildNodeByName (InputPacketNode, SETTINGS_VERSION_ELEMENT_NAME);
-  if (InputTempNode == NULL) {
-    DEBUG ((DEBUG_ERROR, "Failed to Get Version Node\n"));
-    Status = EFI_NO_MAPPING;
-    goto EXIT;
+  DUMP_HEX (DEBUG_VERBOSE, 0, Payload, Header.PayloadSize, "");
+
+  // An empty payload is a valid packet that changes nothing
+  if (Header.PayloadSize > 0) {
+    Status = WriteSVDSetting (Payload, Header.PayloadSize, &FlashWrites);
+    DEBUG ((DEBUG_INFO, "%a - Set %d bytes of binary settings. Result = %r\n", __FUNCTION__, Header.PayloadSize, Status));
   }
 
-  DEBUG ((DEBUG_INFO, "Incoming Version: %a\n", InputTempNode->Value));
-  Version = AsciiStrDecimalToUintn (InputTempNode->Value);
+  DEBUG ((DEBUG_INFO, "%a - Settings applied with %d variable writes\n", __FUNCTION__, FlashWrites));
+  Status = EFI_SUCCESS;
 
-  if (Version > 0xFFFFFFFF) {
-    DEBUG ((DEBUG_ERROR, "Version Value invalid.  0x%x\n", Version));
-    Status = EFI_NO_MAPPING;
-    goto EXIT;
+EXIT:
+  return Status;
+}
+
+/**
+  Apply all settings from XML to their associated setting providers.
+
+  A buffer starting with SVD_BINARY_PACKET_SIGNATURE is taken as a binary settings packet instead, and its variable
+  list is applied without any XML parsing.
+
+  @param[in] Buffer         Complete buffer of config settings in the format of XML, or a binary settings packet.
+  @param[in] Count          Number of bytes inside buffer, excluding NULL terminator.
+
+  @retval EFI_SUCCESS       Settings are applied successfully.
+  @retval other             Error occurred while attempting to apply supplied settings.
+**/
+EFI_STATUS
+ApplySettings (
+  IN  CHAR8  *Buffer,
+  IN  UINTN  Count
+  )
+{
+  SVD_SETTINGS_READER  Reader;                            // Streaming reader over the Input packet
+  XmlNode              *ResultRootNode = NULL;            // The root xml node in the result list
+
+  EFI_STATUS  Status;
+  EFI_TIME    ApplyTime;
+  BOOLEAN     ResetRequired = FALSE;
+  UINTN       FlashWrites   = 0;
+  CHAR8       FlashWritesString[21];
+
+  CONST CHAR8  *Id;
+  CONST CHAR8  *Value;
+  UINTN        IdLength;
+  UINTN        ValueLength;
+  UINTN        b64Size;
+  UINTN        ValueSize;
+  UINT8        *ByteArray    = NULL;                      // Decode buffer, reused across settings
+  UINTN        ByteArraySize = 0;
+
+  if ((Buffer != NULL) && (Count >= sizeof (SVD_BINARY_PACKET_HEADER)) && (ReadUnaligned32 ((UINT32 *)Buffer) == SVD_BINARY_PACKET_SIGNATURE)) {
+    return ApplyBinarySettings ((CONST UINT8 *)Buffer, Count);
   }
 
   //
-  // Get Incoming LSV
+  // Walk the input in place rather than building a node list from it
   //
-  InputTempNode = FindFirstChildNodeByName (InputPacketNode, SETTINGS_LSV_ELEMENT_NAME);
-  if (InputTempNode == NULL) {
-    DEBUG ((DEBUG_ERROR, "Failed to Get LSV Node\n"));
+  Status = SvdSettingsReaderInit (&Reader, Buffer, Count);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a - Couldn't read the settings packet from the payload xml  %r\n", __FUNCTION__, Status));
     Status = EFI_NO_MAPPING;
     goto EXIT;
   }
 
-  DEBUG ((DEBUG_INFO, "Incoming LSV: %a\n", InputTempNode->Value));
-  Lsv = AsciiStrDecimalToUintn (InputTempNode->Value);
-
-  if (Lsv > 0xFFFFFFFF) {
-    DEBUG ((DEBUG_ERROR, "Lowest Supported Version Value invalid.  0x%x\n", Lsv));
+  DEBUG ((DEBUG_INFO, "Incoming Version: %ld\n", (UINT64)Reader.Version));
+  if (Reader.Version > 0xFFFFFFFF) {
+    DEBUG ((DEBUG_ERROR, "Version Value invalid.  0x%x\n", Reader.Version));
     Status = EFI_NO_MAPPING;
     goto EXIT;
   }
 
-  if (Lsv > Version) {
-    DEBUG ((DEBUG_ERROR, "%a - LSV (%a) can't be larger than current version\n", __FUNCTION__, InputTempNode->Value));
+  DEBUG ((DEBUG_INFO, "Incoming LSV: %ld\n", (UINT64)Reader.Lsv));
+  if (Reader.Lsv > 0xFFFFFFFF) {
+    DEBUG ((DEBUG_ERROR, "Lowest Supported Version Value invalid.  0x%x\n", Reader.Lsv));
     Status = EFI_NO_MAPPING;
     goto EXIT;
   }
 
-  // Get the Xml Node for the SettingsList
-  InputSettingsNode = GetSettingsListNodeFromPacketNode (InputPacketNode);
-
-  if (InputSettingsNode == NULL) {
-    DEBUG ((DEBUG_ERROR, "Failed to Get Input Settings List Node\n"));
+  if (Reader.Lsv > Reader.Version) {
+    DEBUG ((DEBUG_ERROR, "%a - LSV (%ld) can't be larger than current version\n", __FUNCTION__, (UINT64)Reader.Lsv));
     Status = EFI_NO_MAPPING;
     goto EXIT;
   }
 
-  ResultSettingsNode = GetSettingsListNodeFromPacketNode (ResultPacketNode);
-
-  if (ResultSettingsNode == NULL) {
-    DEBUG ((DEBUG_ERROR, "Failed to Get Result Settings List Node\n"));
-    Status = EFI_ABORTED;  // internal xml..should never fail
-    goto EXIT;
-  }
-
   // All verified.   Now lets walk thru the Settings and try to apply each one.
-  BASE_LIST_FOR_EACH (Link, &(InputSettingsNode->ChildrenListHead)) {
-    XmlNode      *NodeThis = NULL;
-    CONST CHAR8  *Id       = NULL;
-    CONST CHAR8  *Value    = NULL;
+  while (TRUE) {
+    Status = SvdSettingsReaderNext (&Reader, &Id, &IdLength, &Value, &ValueLength);
+    if (Status == EFI_NOT_FOUND) {
+      break;
+    }
 
-    NodeThis = (XmlNode *)Link;   // Link is first member so just cast it.  this is the <Setting> node
-    Status   = GetInputSettings (NodeThis, &Id, &Value);
     if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "Failed to GetInputSettings.  Bad XML Data. %r\n", Status));
+      DEBUG ((DEBUG_ERROR, "Failed to read the next setting.  Bad XML Data. %r\n", Status));
       Status = EFI_NO_MAPPING;
       goto EXIT;
     }
 
-    // Now we have an Id and Value
-    b64Size   = AsciiStrnLenS (Value, PcdGet32 (PcdMaxVariableSize));
-    ValueSize = 0;
-    Status    = Base64Decode (Value, b64Size, NULL, &ValueSize);
-    if (Status != EFI_BUFFER_TOO_SMALL) {
-      DEBUG ((DEBUG_ERROR, "Cannot query binary blob size. Code = %r\n", Status));
+    // Now we have an Id and Value, sized from its length so that it is decoded in a single pass
+    b64Size   = MIN (ValueLength, PcdGet32 (PcdMaxVariableSize));
+    ValueSize = ConfigBase64DecodedSize (Value, b64Size);
+    if (ValueSize == 0) {
+      DEBUG ((DEBUG_ERROR, "Cannot query binary blob size of an empty value.\n"));
       Status = EFI_INVALID_PARAMETER;
       goto EXIT;
     }
 
-    ByteArray = (UINT8 *)AllocatePool (ValueSize);
+    if (ValueSize > ByteArraySize) {
+      if (ByteArray != NULL) {
+        FreePool (ByteArray);
+      }
+
+      ByteArray = (UINT8 *)AllocatePool (ValueSize);
+      if (ByteArray == NULL) {
+        ByteArraySize = 0;
+        DEBUG ((DEBUG_ERROR, "Cannot allocate 0x%x bytes for binary data\n", ValueSize));
+        Status = EFI_OUT_OF_RESOURCES;
+        goto EXIT;
+      }
+
+      ByteArraySize = ValueSize;
+    }
 
-    Status = Base64Decode (Value, b64Size, ByteArray, &ValueSize);
+    ValueSize = ByteArraySize;
+    Status    = ConfigBase64Decode (Value, b64Size, ByteArray, &ValueSize);
     if (EFI_ERROR (Status)) {
-      FreePool (ByteArray);
       DEBUG ((DEBUG_ERROR, "Cannot set binary data. Code=%r\n", Status));
       goto EXIT;
     }
 
-    SetValue = ByteArray;
     DEBUG ((DEBUG_INFO, "Setting BINARY data\n"));
-    DUMP_HEX (DEBUG_VERBOSE, 0, SetValue, ValueSize, "");
+    DUMP_HEX (DEBUG_VERBOSE, 0, ByteArray, ValueSize, "");
 
     // Just write the variable
-    Status = WriteSVDSetting (SetValue, ValueSize);
+    Status = WriteSVDSetting (ByteArray, ValueSize, &FlashWrites);
 
-    DEBUG ((DEBUG_INFO, "%a - Set %a = %a. Result = %r\n", __FUNCTION__, Id, Value, Status));
+    DEBUG ((DEBUG_INFO, "%a - Set %.*a = %.*a. Result = %r\n", __FUNCTION__, IdLength, Id, ValueLength, Value, Status));
 
     // all done.
   } // end for loop
 
-  // PRINT OUT XML HERE
-  DEBUG ((DEBUG_INFO, "PRINTING OUT XML - Start\n"));
-  DebugPrintXmlTree (ResultRootNode, 0);
-  DEBUG ((DEBUG_INFO, "PRINTING OUTPUT XML - End\n"));
+  DEBUG ((DEBUG_INFO, "%a - Settings applied with %d variable writes\n", __FUNCTION__, FlashWrites));
 
-  Status = EFI_SUCCESS;
+  //
+  // The result packet is only ever printed, so only build it when it will be seen
+  //
+  if (DebugPrintLevelEnabled (DEBUG_INFO)) {
+    if (!EFI_ERROR (gRT->GetTime (&ApplyTime, NULL))) {
+      ResultRootNode = New_ResultPacketNodeList (&ApplyTime);
+    }
 
-EXIT:
-  if (InputRootNode) {
-    FreeXmlTree (&InputRootNode);
+    if (ResultRootNode != NULL) {
+      AsciiSPrint (FlashWritesString, sizeof (FlashWritesString), "%ld", (UINT64)FlashWrites);
+      AddResultsFlashWritesNode (GetResultsPacketNode (ResultRootNode), FlashWritesString);
+
+      // PRINT OUT XML HERE
+      DEBUG ((DEBUG_INFO, "PRINTING OUT XML - Start\n"));
+      DebugPrintXmlTree (ResultRootNode, 0);
+      DEBUG ((DEBUG_INFO, "PRINTING OUTPUT XML - End\n"));
+    } else {
+      DEBUG ((DEBUG_WARN, "%a - Couldn't create a node list for the result xml.\n", __FUNCTION__));
+    }
   }
 
+  Status = EFI_SUCCESS;
+
+EXIT:
   if (ResultRootNode) {
     FreeXmlTree (&ResultRootNode);
   }
@@ -537,6 +724,273 @@ ProcessSvdUsbInput (
   return Status;
 }
 
+/**
+  Read exactly Size bytes from a serial port.
+
+  @param[in]  SerialIo      Serial port to read from.
+  @param[out] Buffer        Buffer to read into.
+  @param[in]  Size          Number of bytes to read.
+  @param[in]  ShowProgress  Print the percentage received as the read progresses.
+
+  @retval EFI_SUCCESS       All bytes were read.
+  @retval EFI_TIMEOUT       No data arrived for SVD_SERIAL_BULK_IDLE_RETRIES reads in a row.
+  @retval Others            The serial port failed.
+**/
+STATIC
+EFI_STATUS
+ReadSerialBulk (
+  IN  EFI_SERIAL_IO_PROTOCOL  *SerialIo,
+  OUT VOID                    *Buffer,
+  IN  UINTN                   Size,
+  IN  BOOLEAN                 ShowProgress
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Offset;
+  UINTN       Chunk;
+  UINTN       Idle;
+  UINTN       Percent;
+  UINTN       LastPercent;
+
+  Idle        = 0;
+  LastPercent = 0;
+  for (Offset = 0; Offset < Size; Offset += Chunk) {
+    Chunk  = Size - Offset;
+    Status = SerialIo->Read (SerialIo, &Chunk, (UINT8 *)Buffer + Offset);
+    if (EFI_ERROR (Status) && (Status != EFI_TIMEOUT)) {
+      return Status;
+    }
+
+    if (Chunk == 0) {
+      if (++Idle >= SVD_SERIAL_BULK_IDLE_RETRIES) {
+        return EFI_TIMEOUT;
+      }
+
+      gBS->Stall (SVD_SERIAL_BULK_IDLE_STALL);
+      continue;
+    }
+
+    Idle = 0;
+    if (ShowProgress) {
+      Percent = (UINTN)DivU64x64Remainder (MultU64x32 (Offset + Chunk, 100), Size, NULL);
+      if (Percent >= LastPercent + SVD_SERIAL_BULK_PROGRESS_STEP) {
+        Print (L"\rReceived %d%%", Percent);
+        LastPercent = Percent;
+      }
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Write a bulk transfer handshake code to a serial port.
+
+  @param[in]  SerialIo      Serial port to write to.
+  @param[in]  Code          SVD_SERIAL_BULK_READY, SVD_SERIAL_BULK_ACK or SVD_SERIAL_BULK_NAK.
+
+  @retval EFI_SUCCESS       The code was written.
+  @retval EFI_TIMEOUT       The serial port did not take the whole code.
+  @retval Others            The serial port failed.
+**/
+STATIC
+EFI_STATUS
+WriteSerialBulkCode (
+  IN  EFI_SERIAL_IO_PROTOCOL  *SerialIo,
+  IN  UINT32                  Code
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Size;
+
+  Size   = sizeof (Code);
+  Status = SerialIo->Write (SerialIo, &Size, &Code);
+  if (!EFI_ERROR (Status) && (Size != sizeof (Code))) {
+    Status = EFI_TIMEOUT;
+  }
+
+  return Status;
+}
+
+/**
+  Find the serial port the console input is read from, out of the ConIn device paths.
+
+  @param[out] SerialHandle  Handle of the console input serial port.
+  @param[out] SerialIo      Serial I/O protocol of the console input serial port.
+
+  @retval EFI_SUCCESS       The console input serial port was found.
+  @retval EFI_NOT_FOUND     None of the console input devices is on a serial port.
+  @retval Others            The ConIn variable could not be read.
+**/
+STATIC
+EFI_STATUS
+LocateConsoleSerialIo (
+  OUT EFI_HANDLE              *SerialHandle,
+  OUT EFI_SERIAL_IO_PROTOCOL  **SerialIo
+  )
+{
+  EFI_STATUS                Status;
+  UINT32                    Attributes;
+  UINTN                     Size;
+  UINTN                     InstanceSize;
+  EFI_DEVICE_PATH_PROTOCOL  *ConIn = NULL;
+  EFI_DEVICE_PATH_PROTOCOL  *Remaining;
+  EFI_DEVICE_PATH_PROTOCOL  *Instance;
+  EFI_DEVICE_PATH_PROTOCOL  *Node;
+
+  Size   = 0;
+  Status = gRT->GetVariable (EFI_CON_IN_VARIABLE_NAME, &gEfiGlobalVariableGuid, &Attributes, &Size, NULL);
+  if (Status != EFI_BUFFER_TOO_SMALL) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to get the size of ConIn - %r\n", __FUNCTION__, Status));
+    return EFI_ERROR (Status) ? Status : EFI_NOT_FOUND;
+  }
+
+  ConIn = AllocatePool (Size);
+  if (ConIn == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = gRT->GetVariable (EFI_CON_IN_VARIABLE_NAME, &gEfiGlobalVariableGuid, &Attributes, &Size, ConIn);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to get ConIn - %r\n", __FUNCTION__, Status));
+    goto Exit;
+  }
+
+  if (!IsDevicePathValid (ConIn, Size)) {
+    DEBUG ((DEBUG_ERROR, "%a ConIn is not a valid device path\n", __FUNCTION__));
+    Status = EFI_NOT_FOUND;
+    goto Exit;
+  }
+
+  // Any console input other than the serial port the user typed on is skipped
+  Status    = EFI_NOT_FOUND;
+  Remaining = ConIn;
+  while (EFI_ERROR (Status) && (Remaining != NULL)) {
+    Instance = GetNextDevicePathInstance (&Remaining, &InstanceSize);
+    if (Instance == NULL) {
+      break;
+    }
+
+    Node   = Instance;
+    Status = gBS->LocateDevicePath (&gEfiSerialIoProtocolGuid, &Node, SerialHandle);
+    if (!EFI_ERROR (Status)) {
+      Status = gBS->HandleProtocol (*SerialHandle, &gEfiSerialIoProtocolGuid, (VOID **)SerialIo);
+    }
+
+    FreePool (Instance);
+  }
+
+Exit:
+  FreePool (ConIn);
+  return Status;
+}
+
+/**
+  Receive a framed settings payload in one transfer from the console input serial port and apply it.
+
+  @return -- This routine does not return to the caller on success
+**/
+STATIC
+EFI_STATUS
+ProcessSvdSerialBulkInput (
+  VOID
+  )
+{
+  EFI_STATUS              Status;
+  EFI_HANDLE              SerialHandle;
+  EFI_SERIAL_IO_PROTOCOL  *SerialIo;
+  SVD_SERIAL_BULK_HEADER  Header;
+  UINT32                  Crc32;
+  CHAR8                   *Payload = NULL;
+
+  Status = LocateConsoleSerialIo (&SerialHandle, &SerialIo);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to locate console serial port - %r\n", __FUNCTION__, Status));
+    return Status;
+  }
+
+  Print (L"\nReceiving bulk configuration payload...\n");
+
+  // Stop the terminal driver polling the port, it would otherwise take the frame off the port as keystrokes
+  Status = gBS->DisconnectController (SerialHandle, NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to stop the serial terminal - %r\n", __FUNCTION__, Status));
+    return Status;
+  }
+
+  // The sender holds the frame back until the port is read from here only
+  Status = WriteSerialBulkCode (SerialIo, SVD_SERIAL_BULK_READY);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to signal ready - %r\n", __FUNCTION__, Status));
+    goto Exit;
+  }
+
+  Status = ReadSerialBulk (SerialIo, &Header, sizeof (Header), FALSE);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to read bulk header - %r\n", __FUNCTION__, Status));
+    goto Exit;
+  }
+
+  if ((Header.Signature != SVD_SERIAL_BULK_SIGNATURE) || (Header.PayloadSize == 0) || (Header.PayloadSize > SVD_SERIAL_BULK_MAX_SIZE)) {
+    DEBUG ((DEBUG_ERROR, "%a Invalid bulk header, signature 0x%x and size 0x%x\n", __FUNCTION__, Header.Signature, Header.PayloadSize));
+    Status = EFI_COMPROMISED_DATA;
+    goto Exit;
+  }
+
+  Payload = AllocatePool (Header.PayloadSize + 1);
+  if (Payload == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a Cannot allocate 0x%x bytes for bulk payload\n", __FUNCTION__, Header.PayloadSize));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  Status = ReadSerialBulk (SerialIo, Payload, Header.PayloadSize, TRUE);
+  if (!EFI_ERROR (Status)) {
+    Status = ReadSerialBulk (SerialIo, &Crc32, sizeof (Crc32), FALSE);
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to read bulk payload - %r\n", __FUNCTION__, Status));
+    goto Exit;
+  }
+
+  Payload[Header.PayloadSize] = '\0';
+  if (ConfigCalculateCrc32 (Payload, Header.PayloadSize) != Crc32) {
+    DEBUG ((DEBUG_ERROR, "%a Bulk payload CRC mismatch\n", __FUNCTION__));
+    Status = EFI_CRC_ERROR;
+    goto Exit;
+  }
+
+  Print (L"\nReceived 0x%x bytes\n", Header.PayloadSize);
+
+  Status = ApplySettings (Payload, Header.PayloadSize);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to apply received settings - %r\n", __FUNCTION__, Status));
+    // An untrusted packet is the sender's fault, it is only refused
+    if (Status != EFI_SECURITY_VIOLATION) {
+      ASSERT_EFI_ERROR (Status);
+    }
+
+    goto Exit;
+  }
+
+  WriteSerialBulkCode (SerialIo, SVD_SERIAL_BULK_ACK);
+
+  ResetCold ();
+  // Should not be here
+  CpuDeadLoop ();
+
+Exit:
+  WriteSerialBulkCode (SerialIo, SVD_SERIAL_BULK_NAK);
+  gBS->ConnectController (SerialHandle, NULL, NULL, TRUE);
+
+  if (Payload != NULL) {
+    FreePool (Payload);
+  }
+
+  return Status;
+}
+
 /**
  * Issue SvdSerialRequest - load settings from a USB drive
  *
@@ -553,6 +1007,12 @@ ProcessSvdSerialInput (
   EFI_STATUS  Status        = EFI_SUCCESS;
   CHAR8       *TempAsciiStr = NULL;
 
+  // The start of a bulk transfer is only recognized as the first keystroke, otherwise keep the keystroke mode
+  if ((UnicodeChar == SVD_SERIAL_BULK_START) && ((mConfDataBuffer == NULL) || (mConfDataOffset == 0))) {
+    Status = ProcessSvdSerialBulkInput ();
+    goto Exit;
+  }
+
   // Simple resizable array and store them at mConfDataBuffer
   if (mConfDataBuffer == NULL) {
     mConfDataSize   = EFI_PAGE_SIZE;
@@ -609,99 +1069,368 @@ Exit:
   return Status;
 }
 
+//
+// The current settings packet, as XmlTreeToString would print it, around the list of settings
+//
+#define CURRENT_XML_PREFIX         "<?xml version=\"1.0\" encoding=\"utf-8\"?><" CURRENT_PACKET_ELEMENT_NAME "><" CURRENT_DATE_ELEMENT_NAME ">"
+#define CURRENT_XML_SETTINGS_OPEN  "</" CURRENT_DATE_ELEMENT_NAME "><" CURRENT_SETTINGS_LIST_ELEMENT_NAME ">"
+#define CURRENT_XML_SUFFIX         "</" CURRENT_SETTINGS_LIST_ELEMENT_NAME "><" CURRENT_LSV_ELEMENT_NAME ">%u</" CURRENT_LSV_ELEMENT_NAME "></" CURRENT_PACKET_ELEMENT_NAME ">"
+#define CURRENT_XML_SETTING_OPEN   "<" CURRENT_SETTING_ELEMENT_NAME "><" CURRENT_SETTING_ID_ELEMENT_NAME ">"
+#define CURRENT_XML_SETTING_VALUE  "</" CURRENT_SETTING_ID_ELEMENT_NAME "><" CURRENT_SETTING_VALUE_ELEMENT_NAME ">"
+#define CURRENT_XML_SETTING_CLOSE  "</" CURRENT_SETTING_VALUE_ELEMENT_NAME "></" CURRENT_SETTING_ELEMENT_NAME ">"
+
+// Fits the date and the LSV
+#define CURRENT_XML_FIELD_SIZE  32
+
+typedef struct {
+  UINT32    Crc32;        // CRC of the raw variable list entry the fragment was encoded from
+  UINTN     RawSize;      // Size of that entry
+  CHAR8     *Fragment;    // Encoded <SettingCurrent> element, not NULL terminated
+  UINTN     FragmentSize;
+} CURRENT_SETTING_CACHE_ENTRY;
+
+// Encoded settings of the last dump, by position in the dump
+STATIC CURRENT_SETTING_CACHE_ENTRY  *mCurrentSettingsCache     = NULL;
+STATIC UINTN                        mCurrentSettingsCacheCount = 0;
+
+typedef struct {
+  VOID     *Data;                     // Expanded variable list of the policy, NULL if not retrieved yet
+  UINTN    DataSize;
+} CONFIG_POLICY_CACHE_ENTRY;
+
+// Configuration policies retrieved for the dumps, by position in PcdConfigurationPolicyGuid, valid while
+// CONF_APP_STATE_POLICY is set in mConfAppState
+STATIC CONFIG_POLICY_CACHE_ENTRY  *mConfigPolicyCache     = NULL;
+STATIC UINTN                      mConfigPolicyCacheCount = 0;
+
 /**
-Create an XML string from all the current settings
+  Prepare the configuration policy cache for a dump of PolicyCount policies, dropping the cached
+  policies if CONF_APP_STATE_POLICY was invalidated.
 
+  @param[in]  PolicyCount   Number of policies in PcdConfigurationPolicyGuid.
+
+  @retval EFI_SUCCESS           The cache holds an entry for each policy.
+  @retval EFI_OUT_OF_RESOURCES  Not enough memory for the cache.
 **/
+STATIC
 EFI_STATUS
-EFIAPI
-CreateXmlStringFromCurrentSettings (
-  OUT CHAR8  **XmlString,
-  OUT UINTN  *StringSize
+PrepareConfigPolicyCache (
+  IN UINTN  PolicyCount
   )
 {
-  EFI_STATUS             Status;
-  XmlNode                *List                    = NULL;
-  XmlNode                *CurrentSettingsNode     = NULL;
-  XmlNode                *CurrentSettingsListNode = NULL;
-  CHAR8                  LsvString[20];
-  EFI_TIME               Time;
-  UINT32                 Lsv            = 1;
-  UINTN                  DataSize       = 0;
-  UINTN                  VarListSize    = 0;
-  UINTN                  Offset         = 0;
-  CHAR8                  *EncodedBuffer = NULL;
-  UINTN                  EncodedSize    = 0;
-  VOID                   *Data          = NULL;
-  CHAR8                  *AsciiName;
-  UINTN                  AsciiSize;
-  UINTN                  i;
-  UINTN                  NumPolicies;
-  EFI_GUID               *TargetGuids;
-  CONFIG_VAR_LIST_ENTRY  ConfigVarList;
+  UINTN  Index;
 
-  if ((XmlString == NULL) || (StringSize == NULL)) {
-    return EFI_INVALID_PARAMETER;
+  if (((mConfAppState.Valid & CONF_APP_STATE_POLICY) != 0) && (mConfigPolicyCacheCount == PolicyCount)) {
+    return EFI_SUCCESS;
   }
 
-  PERF_FUNCTION_BEGIN ();
+  if (mConfigPolicyCache != NULL) {
+    for (Index = 0; Index < mConfigPolicyCacheCount; Index++) {
+      if (mConfigPolicyCache[Index].Data != NULL) {
+        FreePool (mConfigPolicyCache[Index].Data);
+      }
+    }
 
-  // Clear any uncertainty.
-  ZeroMem (&ConfigVarList, sizeof (CONFIG_VAR_LIST_ENTRY));
+    FreePool (mConfigPolicyCache);
+    mConfigPolicyCache      = NULL;
+    mConfigPolicyCacheCount = 0;
+  }
+
+  mConfigPolicyCache = AllocateZeroPool (PolicyCount * sizeof (CONFIG_POLICY_CACHE_ENTRY));
+  if (mConfigPolicyCache == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  mConfigPolicyCacheCount = PolicyCount;
+  mConfAppState.Valid    |= CONF_APP_STATE_POLICY;
+  return EFI_SUCCESS;
+}
+
+/**
+  Escape a setting Id for use as XML element text.
+
+  @param[in]      Id          NULL terminated Id to escape.
+  @param[out]     Escaped     Buffer to write the escaped Id to, can be NULL to only get its size.
+
+  @retval The size of the escaped Id, excluding any NULL terminator.
+**/
+STATIC
+UINTN
+EscapeSettingId (
+  IN  CONST CHAR8  *Id,
+  OUT CHAR8        *Escaped OPTIONAL
+  )
+{
+  CONST CHAR8  *Replacement;
+  UINTN        ReplacementSize;
+  UINTN        Size;
+
+  for (Size = 0; *Id != '\0'; Id++) {
+    switch (*Id) {
+      case '&':
+        Replacement = "&amp;";
+        break;
+      case '<':
+        Replacement = "&lt;";
+        break;
+      case '>':
+        Replacement = "&gt;";
+        break;
+      case '"':
+        Replacement = "&quot;";
+        break;
+      case '\'':
+        Replacement = "&apos;";
+        break;
+      default:
+        Replacement = NULL;
+        break;
+    }
+
+    ReplacementSize = (Replacement == NULL) ? 1 : AsciiStrLen (Replacement);
+    if (Escaped != NULL) {
+      CopyMem (Escaped + Size, (Replacement == NULL) ? Id : Replacement, ReplacementSize);
+    }
+
+    Size += ReplacementSize;
+  }
+
+  return Size;
+}
+
+/**
+  Rebuild an aligned variable list in the packed variable list format. The views of aligned entries
+  describe their descriptors, so only the entries of a packed list can be dumped as they are read
+  back from an SVD, with their header and CRC32.
+
+  @param[in]  Aligned       Pointer to the aligned variable list.
+  @param[in]  AlignedSize   Size of Aligned.
+  @param[out] Packed        Pointer to the packed variable list, to be freed by the caller with FreePool.
+  @param[out] PackedSize    Size of Packed.
+
+  @retval EFI_SUCCESS           Packed holds every entry of Aligned.
+  @retval EFI_OUT_OF_RESOURCES  Not enough memory for the packed variable list.
+  @retval EFI_COMPROMISED_DATA  An entry does not convert to the size it was given.
+  @retval Others                The aligned variable list is corrupted.
+**/
+STATIC
+EFI_STATUS
+ExpandAlignedConfigVarList (
+  IN  CONST VOID  *Aligned,
+  IN  UINTN       AlignedSize,
+  OUT VOID        **Packed,
+  OUT UINTN       *PackedSize
+  )
+{
+  EFI_STATUS                  Status;
+  CONFIG_VAR_LIST_ITERATOR    Iterator;
+  CONFIG_VAR_LIST_ENTRY_VIEW  View;
+  CONFIG_VAR_LIST_ENTRY       Entry;
+  UINT32                      EntrySize;
+  UINTN                       Size;
+  UINTN                       Offset;
+  UINTN                       SizeLeft;
+  UINT8                       *Buffer;
+
+  // Size the packed entries first, which also validates the aligned list
+  Size   = 0;
+  Status = ConfigVarListIterInit (Aligned, AlignedSize, &Iterator);
+  while (!EFI_ERROR (Status)) {
+    Status = ConfigVarListIterNext (&Iterator, &View);
+    if (!EFI_ERROR (Status)) {
+      Status = GetVarListSize (View.NameSize, View.DataSize, &EntrySize);
+      if (!EFI_ERROR (Status)) {
+        Size += EntrySize;
+      }
+    }
+  }
+
+  if (Status != EFI_NOT_FOUND) {
+    return Status;
+  }
+
+  Buffer = AllocatePool (MAX (Size, 1));
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = ConfigVarListIterInit (Aligned, AlignedSize, &Iterator);
+  for (Offset = 0; !EFI_ERROR (Status) && !EFI_ERROR (ConfigVarListIterNext (&Iterator, &View)); Offset += SizeLeft) {
+    Entry.Name       = (CHAR16 *)View.Name;
+    Entry.Attributes = View.Attributes;
+    Entry.Data       = (VOID *)View.Data;
+    Entry.DataSize   = View.DataSize;
+    CopyMem (&Entry.Guid, View.Guid, sizeof (EFI_GUID));
+
+    SizeLeft = Size - Offset;
+    Status   = ConvertVariableEntryToVariableList (&Entry, Buffer + Offset, &SizeLeft);
+  }
+
+  // A name holding a NULL before its end would convert to a shorter entry
+  if (!EFI_ERROR (Status) && (Offset != Size)) {
+    Status = EFI_COMPROMISED_DATA;
+  }
 
-  // create basic xml
-  Status = gRT->GetTime (&Time, NULL);
   if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "%a - Failed to get time. %r\n", __FUNCTION__, Status));
-    goto EXIT;
+    FreePool (Buffer);
+    return Status;
   }
 
-  List = New_CurrentSettingsPacketNodeList (&Time);
-  if (List == NULL) {
-    DEBUG ((DEBUG_ERROR, "%a - Failed to create new Current Settings Packet List Node\n", __FUNCTION__));
-    Status = EFI_ABORTED;
-    goto EXIT;
+  *Packed     = Buffer;
+  *PackedSize = Size;
+  return EFI_SUCCESS;
+}
+
+/**
+  Get the encoded <SettingCurrent> element of a variable list entry, only encoding it when the
+  entry in this position of the previous dump was different.
+
+  @param[in]  CacheIndex    Position of the entry in the dump.
+  @param[in]  Entry         Entry to encode.
+
+  @retval EFI_SUCCESS           The cache holds the encoded entry at CacheIndex.
+  @retval EFI_OUT_OF_RESOURCES  Not enough memory to encode the entry.
+  @retval Others                The entry could not be encoded.
+**/
+STATIC
+EFI_STATUS
+GetCachedSettingFragment (
+  IN UINTN                             CacheIndex,
+  IN CONST CONFIG_VAR_LIST_ENTRY_VIEW  *Entry
+  )
+{
+  EFI_STATUS                   Status;
+  CURRENT_SETTING_CACHE_ENTRY  *Cached;
+  CHAR8                        AsciiName[CONF_VAR_NAME_LEN + 1];
+  UINT32                       Crc32;
+  UINTN                        IdSize;
+  UINTN                        EncodedSize;
+  UINTN                        FragmentSize;
+  CHAR8                        *Fragment;
+  CHAR8                        *Cursor;
+
+  if (CacheIndex >= mCurrentSettingsCacheCount) {
+    Cached = ReallocatePool (
+               mCurrentSettingsCacheCount * sizeof (CURRENT_SETTING_CACHE_ENTRY),
+               (CacheIndex + 1) * sizeof (CURRENT_SETTING_CACHE_ENTRY),
+               mCurrentSettingsCache
+               );
+    if (Cached == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    ZeroMem (&Cached[mCurrentSettingsCacheCount], (CacheIndex + 1 - mCurrentSettingsCacheCount) * sizeof (CURRENT_SETTING_CACHE_ENTRY));
+    mCurrentSettingsCache      = Cached;
+    mCurrentSettingsCacheCount = CacheIndex + 1;
   }
 
-  // Get SettingsPacket Node
-  CurrentSettingsNode = GetCurrentSettingsPacketNode (List);
-  if (CurrentSettingsNode == NULL) {
-    DEBUG ((DEBUG_INFO, "Failed to Get GetCurrentSettingsPacketNode Node\n"));
-    Status = EFI_NO_MAPPING;
-    goto EXIT;
+  Cached = &mCurrentSettingsCache[CacheIndex];
+  Crc32  = ConfigCalculateCrc32 (Entry->Raw, Entry->RawSize);
+  if ((Cached->Fragment != NULL) && (Cached->Crc32 == Crc32) && (Cached->RawSize == Entry->RawSize)) {
+    return EFI_SUCCESS;
   }
 
-  // Record Status result
-  //
-  // Add the Lowest Supported Version Node
-  //
-  ZeroMem (LsvString, sizeof (LsvString));
-  AsciiValueToStringS (&(LsvString[0]), sizeof (LsvString), 0, (UINT32)Lsv, 19);
-  Status = AddSettingsLsvNode (CurrentSettingsNode, LsvString);
+  AsciiSPrint (AsciiName, sizeof (AsciiName), "%s", Entry->Name);
+  IdSize = EscapeSettingId (AsciiName, NULL);
+
+  // First size the binary blob, the encoded size includes a NULL terminator
+  EncodedSize = ConfigBase64EncodedSize (Entry->RawSize);
+  if (EncodedSize == 0) {
+    DEBUG ((DEBUG_ERROR, "Cannot query binary blob size of 0x%x bytes.\n", Entry->RawSize));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  FragmentSize = sizeof (CURRENT_XML_SETTING_OPEN) - 1 + IdSize + sizeof (CURRENT_XML_SETTING_VALUE) - 1 +
+                 EncodedSize - 1 + sizeof (CURRENT_XML_SETTING_CLOSE) - 1;
+  Fragment = AllocatePool (FragmentSize + 1);
+  if (Fragment == NULL) {
+    DEBUG ((DEBUG_ERROR, "Cannot allocate encoded buffer of size 0x%x.\n", FragmentSize + 1));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Cursor = Fragment;
+  CopyMem (Cursor, CURRENT_XML_SETTING_OPEN, sizeof (CURRENT_XML_SETTING_OPEN) - 1);
+  Cursor += sizeof (CURRENT_XML_SETTING_OPEN) - 1;
+  Cursor += EscapeSettingId (AsciiName, Cursor);
+  CopyMem (Cursor, CURRENT_XML_SETTING_VALUE, sizeof (CURRENT_XML_SETTING_VALUE) - 1);
+  Cursor += sizeof (CURRENT_XML_SETTING_VALUE) - 1;
+
+  // Encode in place, the NULL terminator is overwritten by the closing tags
+  Status = ConfigBase64Encode ((CONST UINT8 *)Entry->Raw, Entry->RawSize, Cursor, &EncodedSize);
   if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_INFO, "Failed to set LSV Node for current settings. %r\n", Status));
-    goto EXIT;
+    DEBUG ((DEBUG_ERROR, "Failed to encode binary data into Base 64 format. Code = %r\n", Status));
+    FreePool (Fragment);
+    return EFI_INVALID_PARAMETER;
   }
 
-  //
-  // Get the Settings Node List Node
-  //
-  CurrentSettingsListNode = GetSettingsListNodeFromPacketNode (CurrentSettingsNode);
-  if (CurrentSettingsListNode == NULL) {
-    DEBUG ((DEBUG_INFO, "Failed to Get Settings List Node from Packet Node\n"));
-    Status = EFI_NO_MAPPING;
-    goto EXIT;
+  Cursor += EncodedSize - 1;
+  CopyMem (Cursor, CURRENT_XML_SETTING_CLOSE, sizeof (CURRENT_XML_SETTING_CLOSE) - 1);
+
+  if (Cached->Fragment != NULL) {
+    FreePool (Cached->Fragment);
   }
 
-  // Need to fit in a GUID : %08x-%04x-%04x-%02x%02x-%02x%02x%02x%02x%02x%02x
-  AsciiSize = sizeof (EFI_GUID) * 2 + 4 + 1;
-  AsciiName = AllocateZeroPool (AsciiSize);
-  if (AsciiName == NULL) {
-    DEBUG ((DEBUG_ERROR, "Failed to allocate buffer for initial variable name.\n"));
-    Status = EFI_OUT_OF_RESOURCES;
+  Cached->Crc32        = Crc32;
+  Cached->RawSize      = Entry->RawSize;
+  Cached->Fragment     = Fragment;
+  Cached->FragmentSize = FragmentSize;
+
+  return EFI_SUCCESS;
+}
+
+/**
+Create an XML string from all the current settings
+
+The XML is written directly rather than built as a tree, and the encoded settings are cached
+between calls so only the settings that changed since the previous call are encoded again.
+The policies are only retrieved again once CONF_APP_STATE_POLICY is invalidated.
+
+**/
+EFI_STATUS
+EFIAPI
+CreateXmlStringFromCurrentSettings (
+  OUT CHAR8  **XmlString,
+  OUT UINTN  *StringSize
+  )
+{
+  EFI_STATUS                  Status;
+  CHAR8                       DateString[CURRENT_XML_FIELD_SIZE];
+  CHAR8                       SuffixString[sizeof (CURRENT_XML_SUFFIX) + CURRENT_XML_FIELD_SIZE];
+  EFI_TIME                    Time;
+  UINT32                      Lsv           = 1;
+  UINTN                       DataSize      = 0;
+  VOID                        *Data         = NULL;
+  UINTN                       SettingsCount = 0;
+  UINTN                       Size;
+  UINTN                       DateSize;
+  UINTN                       SuffixSize;
+  CHAR8                       *Cursor;
+  UINTN                       i;
+  UINTN                       NumPolicies;
+  EFI_GUID                    *TargetGuids;
+  CONFIG_VAR_LIST_ITERATOR    Iterator;
+  CONFIG_VAR_LIST_ENTRY_VIEW  ConfigVarList;
+  VOID                        *Packed;
+  UINTN                       PackedSize;
+  CONFIG_POLICY_CACHE_ENTRY   *Policy;
+
+  if ((XmlString == NULL) || (StringSize == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  PERF_FUNCTION_BEGIN ();
+
+  *XmlString = NULL;
+
+  Status = gRT->GetTime (&Time, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a - Failed to get time. %r\n", __FUNCTION__, Status));
     goto EXIT;
   }
 
+  DateSize   = AsciiSPrint (DateString, sizeof (DateString), "%d-%02d-%02dT%02d:%02d:%02d", Time.Year, Time.Month, Time.Day, Time.Hour, Time.Minute, Time.Second);
+  SuffixSize = AsciiSPrint (SuffixString, sizeof (SuffixString), CURRENT_XML_SUFFIX, Lsv);
+
   // Inspect the size of PCD first.
   NumPolicies = PcdGetSize (PcdConfigurationPolicyGuid);
 
@@ -719,123 +1448,127 @@ CreateXmlStringFromCurrentSettings (
       DEBUG ((DEBUG_ERROR, "%a Failed to get list of valid GUIDs!\n", __FUNCTION__));
       ASSERT (FALSE);
     } else {
-      // Try to locate all config policies specified in this PCD
-      for (i = 0; i < NumPolicies; i++) {
-        DataSize = 0;
-        Status   = mPolicyProtocol->GetPolicy (&TargetGuids[i], NULL, Data, (UINT16 *)&DataSize);
-        if (Status != EFI_BUFFER_TOO_SMALL) {
-          DEBUG ((DEBUG_ERROR, "%a Failed to get configuration policy size %g - %r\n", __FUNCTION__, TargetGuids[i], Status));
-          ASSERT (FALSE);
-          continue;
-        }
+      Status = PrepareConfigPolicyCache (NumPolicies);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "%a Unable to allocate pool for %d configuration policies\n", __FUNCTION__, NumPolicies));
+        goto EXIT;
+      }
 
-        Data = AllocatePool (DataSize);
-        if (Data == NULL) {
-          DEBUG ((DEBUG_ERROR, "%a Unable to allocate pool for configuration policy %g\n", __FUNCTION__, TargetGuids[i]));
-          break;
-        }
+      // Try to locate all config policies specified in this PCD, only the ones not retrieved by a previous dump
+      for (i = 0; i < NumPolicies; i++) {
+        Policy = &mConfigPolicyCache[i];
+        if (Policy->Data == NULL) {
+          DataSize = 0;
+          Status   = mPolicyProtocol->GetPolicy (&TargetGuids[i], NULL, Data, (UINT16 *)&DataSize);
+          if (Status != EFI_BUFFER_TOO_SMALL) {
+            DEBUG ((DEBUG_ERROR, "%a Failed to get configuration policy size %g - %r\n", __FUNCTION__, TargetGuids[i], Status));
+            ASSERT (FALSE);
+            continue;
+          }
 
-        Status = mPolicyProtocol->GetPolicy (&TargetGuids[i], NULL, Data, (UINT16 *)&DataSize);
-        if (EFI_ERROR (Status)) {
-          DEBUG ((DEBUG_ERROR, "%a Failed to get configuration policy %g - %r\n", __FUNCTION__, TargetGuids[i], Status));
-          ASSERT (FALSE);
-          FreePool (Data);
-          Data = NULL;
-          continue;
-        }
+          Data = AllocatePool (DataSize);
+          if (Data == NULL) {
+            DEBUG ((DEBUG_ERROR, "%a Unable to allocate pool for configuration policy %g\n", __FUNCTION__, TargetGuids[i]));
+            break;
+          }
 
-        Offset = 0;
-        while (Offset < DataSize) {
-          VarListSize = DataSize - Offset;
-          Status      = ConvertVariableListToVariableEntry ((UINT8 *)Data + Offset, &VarListSize, &ConfigVarList);
+          Status = mPolicyProtocol->GetPolicy (&TargetGuids[i], NULL, Data, (UINT16 *)&DataSize);
           if (EFI_ERROR (Status)) {
-            DEBUG ((DEBUG_ERROR, "%a Failed to convert variable list to variable entry - %r\n", __FUNCTION__, Status));
-            goto EXIT;
+            DEBUG ((DEBUG_ERROR, "%a Failed to get configuration policy %g - %r\n", __FUNCTION__, TargetGuids[i], Status));
+            ASSERT (FALSE);
+            FreePool (Data);
+            Data = NULL;
+            continue;
           }
 
-          AsciiSize = StrnSizeS (ConfigVarList.Name, CONF_VAR_NAME_LEN) / sizeof (CHAR16);
-          AsciiName = AllocatePool (AsciiSize);
-          if (AsciiName == NULL) {
-            DEBUG ((DEBUG_ERROR, "Failed to allocate buffer for ID %s.\n", ConfigVarList.Name));
-            Status = EFI_OUT_OF_RESOURCES;
-            goto EXIT;
+          // Only packed entries are dumped as an SVD reads them back, so the cache holds every policy packed
+          Packed = NULL;
+          if (IsCompressedConfigVarList (Data, DataSize)) {
+            Status = RetrieveDecompressedConfigVarList (Data, DataSize, &Packed, &PackedSize);
+          } else if ((DataSize >= sizeof (CONFIG_VAR_LIST_ALIGNED_HDR)) && (ReadUnaligned32 ((UINT32 *)Data) == CONFIG_VAR_LIST_ALIGNED_SIGNATURE)) {
+            Status = ExpandAlignedConfigVarList (Data, DataSize, &Packed, &PackedSize);
           }
 
-          AsciiSPrint (AsciiName, AsciiSize, "%s", ConfigVarList.Name);
-
-          // First encode the binary blob
-          EncodedSize = 0;
-          Status      = Base64Encode ((UINT8 *)Data + Offset, VarListSize, NULL, &EncodedSize);
-          if (Status != EFI_BUFFER_TOO_SMALL) {
-            DEBUG ((DEBUG_ERROR, "Cannot query binary blob size. Code = %r\n", Status));
-            Status = EFI_INVALID_PARAMETER;
+          if (EFI_ERROR (Status)) {
+            DEBUG ((DEBUG_ERROR, "%a Failed to expand configuration policy %g - %r\n", __FUNCTION__, TargetGuids[i], Status));
             goto EXIT;
           }
 
-          EncodedBuffer = (CHAR8 *)AllocatePool (EncodedSize);
-          if (EncodedBuffer == NULL) {
-            DEBUG ((DEBUG_ERROR, "Cannot allocate encoded buffer of size 0x%x.\n", EncodedSize));
-            Status = EFI_OUT_OF_RESOURCES;
-            goto EXIT;
+          if (Packed != NULL) {
+            FreePool (Data);
+            Data     = Packed;
+            DataSize = PackedSize;
           }
 
-          Status = Base64Encode ((UINT8 *)Data + Offset, VarListSize, EncodedBuffer, &EncodedSize);
-          if (EFI_ERROR (Status)) {
-            DEBUG ((DEBUG_ERROR, "Failed to encode binary data into Base 64 format. Code = %r\n", Status));
-            Status = EFI_INVALID_PARAMETER;
+          // The cache owns the policy from here on
+          Policy->Data     = Data;
+          Policy->DataSize = DataSize;
+          Data             = NULL;
+        }
+
+        // The policy is walked in place
+        Status = ConfigVarListIterInit (Policy->Data, Policy->DataSize, &Iterator);
+        if (EFI_ERROR (Status)) {
+          DEBUG ((DEBUG_ERROR, "%a Failed to walk configuration policy %g - %r\n", __FUNCTION__, TargetGuids[i], Status));
+          InvalidateConfAppState (CONF_APP_STATE_POLICY);
+          goto EXIT;
+        }
+
+        while (TRUE) {
+          // Entries are validated in place, Name and Data point into the policy buffer
+          Status = ConfigVarListIterNext (&Iterator, &ConfigVarList);
+          if (Status == EFI_NOT_FOUND) {
+            break;
+          } else if (EFI_ERROR (Status)) {
+            DEBUG ((DEBUG_ERROR, "%a Failed to convert variable list to variable entry - %r\n", __FUNCTION__, Status));
+            InvalidateConfAppState (CONF_APP_STATE_POLICY);
             goto EXIT;
           }
 
-          Status = SetCurrentSettings (CurrentSettingsListNode, AsciiName, EncodedBuffer);
-
+          Status = GetCachedSettingFragment (SettingsCount, &ConfigVarList);
           if (EFI_ERROR (Status)) {
-            DEBUG ((DEBUG_ERROR, "%a - Error from Set Current Settings.  Status = %r\n", __FUNCTION__, Status));
+            DEBUG ((DEBUG_ERROR, "%a - Failed to encode current setting %s.  Status = %r\n", __FUNCTION__, ConfigVarList.Name, Status));
+            goto EXIT;
           }
 
-          Offset += VarListSize;
-          FreePool (ConfigVarList.Name);
-          FreePool (ConfigVarList.Data);
-          FreePool (AsciiName);
-          ConfigVarList.Data = NULL;
-          ConfigVarList.Name = NULL;
-          AsciiName          = NULL;
+          SettingsCount++;
         }
-
-        FreePool (Data);
-        Data = NULL;
       }
     }
   }
 
-  // now output as xml string
-  Status = XmlTreeToString (List, TRUE, StringSize, XmlString);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "%a - XmlTreeToString failed.  %r\n", __FUNCTION__, Status));
-  }
-
-EXIT:
-  if (List != NULL) {
-    FreeXmlTree (&List);
-  }
-
-  if (Data != NULL) {
-    FreePool (Data);
+  // now output as xml string, sized up front so it is written in one go
+  Size = sizeof (CURRENT_XML_PREFIX) - 1 + DateSize + sizeof (CURRENT_XML_SETTINGS_OPEN) - 1 + SuffixSize + 1;
+  for (i = 0; i < SettingsCount; i++) {
+    Size += mCurrentSettingsCache[i].FragmentSize;
   }
 
-  if (ConfigVarList.Name != NULL) {
-    FreePool (ConfigVarList.Name);
+  *XmlString = AllocatePool (Size);
+  if (*XmlString == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a - Cannot allocate 0x%x bytes for the xml string.\n", __FUNCTION__, Size));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
   }
 
-  if (ConfigVarList.Data != NULL) {
-    FreePool (ConfigVarList.Data);
+  Cursor = *XmlString;
+  CopyMem (Cursor, CURRENT_XML_PREFIX, sizeof (CURRENT_XML_PREFIX) - 1);
+  Cursor += sizeof (CURRENT_XML_PREFIX) - 1;
+  CopyMem (Cursor, DateString, DateSize);
+  Cursor += DateSize;
+  CopyMem (Cursor, CURRENT_XML_SETTINGS_OPEN, sizeof (CURRENT_XML_SETTINGS_OPEN) - 1);
+  Cursor += sizeof (CURRENT_XML_SETTINGS_OPEN) - 1;
+  for (i = 0; i < SettingsCount; i++) {
+    CopyMem (Cursor, mCurrentSettingsCache[i].Fragment, mCurrentSettingsCache[i].FragmentSize);
+    Cursor += mCurrentSettingsCache[i].FragmentSize;
   }
 
-  if (EncodedBuffer != NULL) {
-    FreePool (EncodedBuffer);
-  }
+  CopyMem (Cursor, SuffixString, SuffixSize + 1);
+  *StringSize = Size;
+  Status      = EFI_SUCCESS;
 
-  if (AsciiName != NULL) {
-    FreePool (AsciiName);
+EXIT:
+  if (Data != NULL) {
+    FreePool (Data);
   }
 
   if (EFI_ERROR (Status)) {
@@ -930,7 +1663,7 @@ SetupConfMgr (
       mSetupConfState = SetupConfExit;
       break;
     case SetupConfUpdateSerialHint:
-      Print (L"\nPaste or send the formatted configuration payload here:\n");
+      Print (L"\nPaste or send the formatted configuration payload here, or Ctrl-B to start a bulk transfer:\n");
       mSetupConfState = SetupConfUpdateSerial;
     case SetupConfUpdateSerial:
       // Wait for incoming unicode chars. This is performance sensitive, thus invoking the protocol function directly.
@@ -965,6 +1698,8 @@ SetupConfMgr (
         Status = InspectDumpOutput (StrBuf, StrBufSize);
         if (EFI_ERROR (Status)) {
           Print (L"\nGenerated print failed to pass inspection - %r\n", Status);
+          FreePool (StrBuf);
+          StrBuf = NULL;
           Status = EFI_SUCCESS;
           break;
         }
@@ -982,6 +1717,8 @@ SetupConfMgr (
         }
 
         Print (L"\n");
+        FreePool (StrBuf);
+        StrBuf = NULL;
       }
 
       mSetupConfState = SetupConfDumpComplete;
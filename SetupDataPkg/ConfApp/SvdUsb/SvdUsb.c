@@ -23,6 +23,203 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "SvdUsb.h"
 
+//
+// A volume being probed for the update file. Every probe is issued before waiting on any of them, so the file systems
+// that support EFI_FILE_IO_TOKEN look for the file in parallel.
+//
+typedef struct {
+  EFI_FILE_PROTOCOL    *VolHandle;
+  EFI_FILE_PROTOCOL    *FileHandle;
+  EFI_FILE_IO_TOKEN    Token;
+} SVD_USB_PROBE;
+
+/**
+*
+*  Check the device path of a handle for a USB node, without touching the device itself.
+*
+*  @param[in]     Handle          Handle to check.
+*
+*  @retval   TRUE            The handle is on a USB device.
+*  @retval   FALSE           The handle is not on a USB device, or has no device path.
+*
+**/
+STATIC
+BOOLEAN
+IsUsbDevicePath (
+  IN  EFI_HANDLE  Handle
+  )
+{
+  EFI_DEVICE_PATH_PROTOCOL  *DevicePath;
+
+  DevicePath = DevicePathFromHandle (Handle);
+  if (DevicePath == NULL) {
+    return FALSE;
+  }
+
+  while (!IsDevicePathEnd (DevicePath)) {
+    if ((DevicePathType (DevicePath) == MESSAGING_DEVICE_PATH) &&
+        ((DevicePathSubType (DevicePath) == MSG_USB_DP) ||
+         (DevicePathSubType (DevicePath) == MSG_USB_CLASS_DP) ||
+         (DevicePathSubType (DevicePath) == MSG_USB_WWID_DP)))
+    {
+      return TRUE;
+    }
+
+    DevicePath = NextDevicePathNode (DevicePath);
+  }
+
+  return FALSE;
+}
+
+/**
+*
+*  Start looking for the update file on a volume. File systems supporting OpenEx signal the probe event when done,
+*  others are opened synchronously and complete the probe immediately.
+*
+*  @param[in]     Probe           Probe of an opened volume.
+*  @param[in]     PktFileName     Name of update file to open.
+*
+**/
+STATIC
+VOID
+StartSvdUsbProbe (
+  IN  SVD_USB_PROBE  *Probe,
+  IN  CHAR16         *PktFileName
+  )
+{
+  EFI_STATUS  Status;
+
+  if (Probe->VolHandle->Revision >= EFI_FILE_PROTOCOL_REVISION2) {
+    Status = gBS->CreateEvent (0, TPL_CALLBACK, NULL, NULL, &Probe->Token.Event);
+    if (!EFI_ERROR (Status)) {
+      Status = Probe->VolHandle->OpenEx (Probe->VolHandle, &Probe->FileHandle, PktFileName, EFI_FILE_MODE_READ, 0, &Probe->Token);
+      if (!EFI_ERROR (Status)) {
+        return;
+      }
+
+      gBS->CloseEvent (Probe->Token.Event);
+      Probe->Token.Event = NULL;
+    }
+  }
+
+  Probe->FileHandle   = NULL;
+  Probe->Token.Status = Probe->VolHandle->Open (Probe->VolHandle, &Probe->FileHandle, PktFileName, EFI_FILE_MODE_READ, 0);
+}
+
+/**
+*
+*  Wait for a probe started by StartSvdUsbProbe to complete.
+*
+*  @param[in]     Probe           Probe to wait for.
+*
+*  @retval   EFI_SUCCESS     The update file is open in Probe->FileHandle.
+*  @retval   Others          The update file could not be opened on this volume.
+*
+**/
+STATIC
+EFI_STATUS
+WaitSvdUsbProbe (
+  IN  SVD_USB_PROBE  *Probe
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       EventIndex;
+
+  if (Probe->Token.Event != NULL) {
+    Status = gBS->WaitForEvent (1, &Probe->Token.Event, &EventIndex);
+    gBS->CloseEvent (Probe->Token.Event);
+    Probe->Token.Event = NULL;
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  if (!EFI_ERROR (Probe->Token.Status) && (Probe->FileHandle == NULL)) {
+    return EFI_NOT_FOUND;
+  }
+
+  return Probe->Token.Status;
+}
+
+/**
+*
+*  Read an opened update file into a buffer sized to fit it.
+*
+*  @param[in]     FileHandle      Update file to read.
+*  @param[out]    Buffer          Where to store a buffer pointer.
+*  @param[out]    BufferSize      Where to store the buffer size.
+*
+*  @retval   EFI_SUCCESS           The file was read, with a terminating NULL appended.
+*  @retval   EFI_BAD_BUFFER_SIZE   The file is empty, or changed size while being read.
+*  @retval   EFI_OUT_OF_RESOURCES  There is no memory to hold the file.
+*  @retval   Others                The file could not be read.
+*
+**/
+STATIC
+EFI_STATUS
+ReadSvdUsbFile (
+  IN  EFI_FILE_PROTOCOL  *FileHandle,
+  OUT CHAR8              **Buffer,
+  OUT UINTN              *BufferSize
+  )
+{
+  EFI_STATUS     Status;
+  EFI_FILE_INFO  *FileInfo;
+  UINTN          FileSize;
+  UINTN          Offset;
+  UINTN          ReadSize;
+
+  *Buffer  = NULL;
+  FileInfo = FileHandleGetInfo (FileHandle);
+  if (FileInfo == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a: Error getting file info.\n", __FUNCTION__));
+    return EFI_DEVICE_ERROR;
+  }
+
+  FileSize = (UINTN)FileInfo->FileSize;
+  FreePool (FileInfo);
+
+  //
+  // Do not accept empty files
+  //
+  if (FileSize == 0) {
+    DEBUG ((DEBUG_ERROR, "%a: Invalid file size %d.\n", __FUNCTION__, FileSize));
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  *Buffer = AllocatePool (FileSize + sizeof (CHAR8));     // Add 1 for a terminating NULL
+  if (*Buffer == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a: Unable to allocate buffer.\n", __FUNCTION__));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  DEBUG ((DEBUG_INFO, "Reading file into buffer @ %p, size = %d\n", *Buffer, FileSize + sizeof (CHAR8)));
+
+  //
+  // Ask for the whole file at once, the file system only returns less if it has to split the transfer
+  //
+  Status = EFI_SUCCESS;
+  for (Offset = 0; Offset < FileSize; Offset += ReadSize) {
+    ReadSize = FileSize - Offset;
+    Status   = FileHandleRead (FileHandle, &ReadSize, *Buffer + Offset);
+    if (EFI_ERROR (Status) || (ReadSize == 0)) {
+      break;
+    }
+  }
+
+  if (EFI_ERROR (Status) || (Offset != FileSize)) {
+    DEBUG ((DEBUG_ERROR, "%a: Unable to read file. ReadSize=%d, Size=%d. Code=%r\n", __FUNCTION__, Offset, FileSize, Status));
+    FreePool (*Buffer);
+    *Buffer = NULL;
+    return EFI_ERROR (Status) ? Status : EFI_BAD_BUFFER_SIZE;
+  }
+
+  (*Buffer)[FileSize] = '\0';      // Add a terminating NULL
+  *BufferSize         = FileSize + sizeof (CHAR8);
+
+  return EFI_SUCCESS;
+}
+
 /**
 *
 *  Scan USB Drives looking for the file name passed in.
@@ -44,19 +241,16 @@ FindUsbDriveWithSvdUpdate (
   OUT UINTN   *BufferSize
   )
 {
-  EFI_FILE_PROTOCOL                *FileHandle;
-  EFI_FILE_PROTOCOL                *VolHandle;
   EFI_HANDLE                       *HandleBuffer;
   UINTN                            Index;
   UINTN                            NumHandles;
+  UINTN                            NumProbes;
   EFI_STATUS                       Status;
   EFI_STATUS                       Status2;
   EFI_DEVICE_PATH_PROTOCOL         *BlkIoDevicePath;
-  EFI_DEVICE_PATH_PROTOCOL         *UsbDevicePath;
   EFI_SIMPLE_FILE_SYSTEM_PROTOCOL  *SfProtocol;
   EFI_HANDLE                       Handle;
-  EFI_FILE_INFO                    *FileInfo;
-  UINTN                            ReadSize;
+  SVD_USB_PROBE                    *Probes;
 
   if ((NULL == PktFileName) ||
       (NULL == Buffer) ||
@@ -66,8 +260,10 @@ FindUsbDriveWithSvdUpdate (
   }
 
   NumHandles   = 0;
+  NumProbes    = 0;
   HandleBuffer = NULL;
   SfProtocol   = NULL;
+  Probes       = NULL;
 
   //
   // Locate all handles that are using the SFS protocol.
@@ -87,27 +283,24 @@ FindUsbDriveWithSvdUpdate (
 
   DEBUG ((DEBUG_INFO, "Processing %d handles\n", NumHandles));
 
+  Probes = AllocateZeroPool (NumHandles * sizeof (SVD_USB_PROBE));
+  if (Probes == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a: Unable to allocate probes for %d handles.\n", __FUNCTION__, NumHandles));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto CleanUp;
+  }
+
   //
-  // Search the handles to find one that has has a USB node in the device path.
+  // Filter the handles down to USB block devices from their device paths alone, then start probing each of their
+  // volumes for the update file.
   //
   for (Index = 0; (Index < NumHandles); Index += 1) {
     //
     // Ensure this device is on a USB controller
     //
-    UsbDevicePath = DevicePathFromHandle (HandleBuffer[Index]);
-    if (UsbDevicePath == NULL) {
-      DEBUG ((DEBUG_ERROR, "No device path on handle %d\n", Index));
-      continue;
-    }
-
-    Status = gBS->LocateDevicePath (
-                    &gEfiUsbIoProtocolGuid,
-                    &UsbDevicePath,
-                    &Handle
-                    );
-    if (EFI_ERROR (Status)) {
+    if (!IsUsbDevicePath (HandleBuffer[Index])) {
       // Device is not USB;
-      DEBUG ((DEBUG_ERROR, "Not a USB Device on Handle %d\n", Index));
+      DEBUG ((DEBUG_INFO, "Not a USB Device on Handle %d\n", Index));
       continue;
     }
 
@@ -115,16 +308,11 @@ FindUsbDriveWithSvdUpdate (
     // Check if this is a block IO device path.
     //
     BlkIoDevicePath = DevicePathFromHandle (HandleBuffer[Index]);
-    if (BlkIoDevicePath == NULL) {
-      DEBUG ((DEBUG_ERROR, "This cannot happen on %d\n", Index));
-      continue;
-    }
-
-    Status = gBS->LocateDevicePath (
-                    &gEfiBlockIoProtocolGuid,
-                    &BlkIoDevicePath,
-                    &Handle
-                    );
+    Status          = gBS->LocateDevicePath (
+                             &gEfiBlockIoProtocolGuid,
+                             &BlkIoDevicePath,
+                             &Handle
+                             );
     if (EFI_ERROR (Status)) {
       // Device is not BlockIo;
       DEBUG ((DEBUG_ERROR, "Not a BlockIo Device on Handle %d\n", Index));
@@ -145,91 +333,65 @@ FindUsbDriveWithSvdUpdate (
     //
     // Open the volume/partition.
     //
-    Status = SfProtocol->OpenVolume (SfProtocol, &VolHandle);
+    Status = SfProtocol->OpenVolume (SfProtocol, &Probes[NumProbes].VolHandle);
     if (EFI_ERROR (Status) != FALSE) {
       DEBUG ((DEBUG_ERROR, "%a: Unable to open SimpleFileSystem. Code = %r\n", __FUNCTION__, Status));
       continue;
     }
 
-    //
-    // Ensure the PktName file is present
-    //
-    Status = VolHandle->Open (VolHandle, &FileHandle, PktFileName, EFI_FILE_MODE_READ, 0);
-    if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_INFO, "%a: Unable to locate %s. Code = %r\n", __FUNCTION__, PktFileName, Status));
-      Status2 = FileHandleClose (VolHandle);
-      if (EFI_ERROR (Status2)) {
-        DEBUG ((DEBUG_ERROR, "%a: Error closing Vol Handle. Code = %r\n", __FUNCTION__, Status2));
-      }
+    StartSvdUsbProbe (&Probes[NumProbes], PktFileName);
+    NumProbes++;
+  }
 
+  //
+  // Collect the probes in handle order, so the first drive holding the PktName file is still the one used
+  //
+  Status = EFI_NOT_FOUND;
+  for (Index = 0; Index < NumProbes; Index++) {
+    Status2 = WaitSvdUsbProbe (&Probes[Index]);
+    if (EFI_ERROR (Status2)) {
+      DEBUG ((DEBUG_INFO, "%a: Unable to locate %s. Code = %r\n", __FUNCTION__, PktFileName, Status2));
+      Probes[Index].FileHandle = NULL;
       continue;
     }
 
-    FileInfo = FileHandleGetInfo (FileHandle);
-
-    if (FileInfo == NULL) {
-      DEBUG ((DEBUG_ERROR, "%a: Error getting file info.\n", __FUNCTION__));
-      FileHandleClose (FileHandle);
-      FileHandleClose (VolHandle);
-      continue;
-    }
+    if (EFI_ERROR (Status)) {
+      Status = ReadSvdUsbFile (Probes[Index].FileHandle, Buffer, BufferSize);
+      if (Status == EFI_OUT_OF_RESOURCES) {
+        break;      // Fatal error, don't try anymore
+      }
 
-    //
-    // Do not accept empty files
-    //
-    if (FileInfo->FileSize == 0) {
-      DEBUG ((DEBUG_ERROR, "%a: Invalid file size %d.\n", __FUNCTION__, FileInfo->FileSize));
-      Status = EFI_BAD_BUFFER_SIZE;
-      FileHandleClose (FileHandle);
-      FileHandleClose (VolHandle);
-      continue;
+      if (!EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_INFO, "Finished Reading File\n"));
+      }
     }
+  }
 
-    *Buffer = AllocatePool (FileInfo->FileSize + sizeof (CHAR8));     // Add 1 for a terminating NULL
-    if (*Buffer == NULL) {
-      FileHandleClose (FileHandle);
-      FileHandleClose (VolHandle);
-      DEBUG ((DEBUG_ERROR, "%a: Unable to allocate buffer.\n", __FUNCTION__));
-      Status = EFI_OUT_OF_RESOURCES;
-      goto CleanUp;       // Fatal error, don't try anymore
+  //
+  // Wait for any probes left behind by a fatal error, before closing their volumes
+  //
+  for ( ; Index < NumProbes; Index++) {
+    if (EFI_ERROR (WaitSvdUsbProbe (&Probes[Index]))) {
+      Probes[Index].FileHandle = NULL;
     }
+  }
 
-    *BufferSize = FileInfo->FileSize + sizeof (CHAR8);
-
-    DEBUG ((DEBUG_INFO, "Reading file into buffer @ %p, size = %d\n", *Buffer, *BufferSize));
-
-    ReadSize = FileInfo->FileSize;
-    Status   = FileHandleRead (FileHandle, &ReadSize, *Buffer);
-    if (EFI_ERROR (Status) || (ReadSize != FileInfo->FileSize)) {
-      FileHandleClose (FileHandle);
-      FileHandleClose (VolHandle);
-      DEBUG ((
-        DEBUG_ERROR,
-        "%a: Unable to read file. ReadSize=%d, Size=%d. Code=%r\n",
-        __FUNCTION__,
-        ReadSize,
-        FileInfo->FileSize,
-        Status
-        ));
-
-      if (Status == EFI_SUCCESS) {
-        Status = EFI_BAD_BUFFER_SIZE;
+CleanUp:
+  if (Probes != NULL) {
+    for (Index = 0; Index < NumProbes; Index++) {
+      if (Probes[Index].FileHandle != NULL) {
+        FileHandleClose (Probes[Index].FileHandle);
       }
 
-      FreePool (*Buffer);
-      *Buffer = NULL;
-      continue;
+      Status2 = FileHandleClose (Probes[Index].VolHandle);
+      if (EFI_ERROR (Status2)) {
+        DEBUG ((DEBUG_ERROR, "%a: Error closing Vol Handle. Code = %r\n", __FUNCTION__, Status2));
+      }
     }
 
-    (*Buffer)[FileInfo->FileSize] = '\0';      // Add a terminating NULL
-    DEBUG ((DEBUG_INFO, "Finished Reading File\n"));
-    FileHandleClose (FileHandle);
-    FileHandleClose (VolHandle);
-    Status = EFI_SUCCESS;
-    break;
+    FreePool (Probes);
   }
 
-CleanUp:
   if (HandleBuffer != NULL) {
     FreePool (HandleBuffer);
   }
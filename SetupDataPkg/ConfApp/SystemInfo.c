@@ -12,10 +12,12 @@
 #include <Library/PcdLib.h>
 #include <Library/PrintLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/BaseMemoryLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
 #include <Library/MuUefiVersionLib.h>
 #include <Library/UefiLib.h>
+#include <Library/ConfigPerfCounterLib.h>
 
 #include "ConfApp.h"
 
@@ -33,11 +35,23 @@ CONST ConfAppKeyOptions  SysInfoStateOptions[SYS_INFO_STATE_OPTIONS] = {
   }
 };
 
+STATIC CONST CHAR16  *CONST  mConfigPerfCounterNames[ConfigPerfCounterMax] = {
+  L"Entries parsed",
+  L"Bytes CRC'd",
+  L"Allocations",
+  L"GetVariable calls",
+  L"SetVariable calls",
+  L"Override hits",
+  L"Override misses"
+};
+
 SysInfoState_t  mSysInfoState = SysInfoInit;
 UINTN           mDateTimeCol  = 0;
 UINTN           mDateTimeRow  = 0;
 UINTN           mEndCol       = 0;
 UINTN           mEndRow       = 0;
+BOOLEAN         mTimePrinted  = FALSE;
+EFI_TIME        mPrintedTime;
 
 /**
   Helper internal function to reset all local variable in this file.
@@ -53,6 +67,7 @@ ResetGlobals (
   mDateTimeRow  = 0;
   mEndCol       = 0;
   mEndRow       = 0;
+  mTimePrinted  = FALSE;
 }
 
 /**
@@ -180,7 +195,8 @@ Done:
 }
 
 /**
-  Helper internal function to print system date and time.
+  Helper internal function to print system date and time. The time is polled much more often than
+  once a second, so it is only printed again once it differs from the time printed last.
 **/
 EFI_STATUS
 PrintDateTime (
@@ -195,6 +211,20 @@ PrintDateTime (
     return Status;
   }
 
+  if (mTimePrinted &&
+      (CurrentTime.Second == mPrintedTime.Second) &&
+      (CurrentTime.Minute == mPrintedTime.Minute) &&
+      (CurrentTime.Hour == mPrintedTime.Hour) &&
+      (CurrentTime.Day == mPrintedTime.Day) &&
+      (CurrentTime.Month == mPrintedTime.Month) &&
+      (CurrentTime.Year == mPrintedTime.Year))
+  {
+    return Status;
+  }
+
+  CopyMem (&mPrintedTime, &CurrentTime, sizeof (EFI_TIME));
+  mTimePrinted = TRUE;
+
   gST->ConOut->SetCursorPosition (gST->ConOut, mDateTimeCol, mDateTimeRow);
   gST->ConOut->SetAttribute (gST->ConOut, EFI_TEXT_ATTR (EFI_WHITE, EFI_BLACK));
   Print (
@@ -213,6 +243,35 @@ PrintDateTime (
   return Status;
 }
 
+/**
+  Helper internal function to print the counters of the configuration libraries for this boot, if they are
+  published.
+**/
+VOID
+PrintConfigPerfCounters (
+  VOID
+  )
+{
+  EFI_STATUS                 Status;
+  CONFIG_PERF_COUNTER_TABLE  *Table;
+  UINTN                      Index;
+
+  Status = EfiGetSystemConfigurationTable (&gConfigPerfCounterTableGuid, (VOID **)&Table);
+  if (EFI_ERROR (Status) || (Table == NULL) || (Table->Signature != CONFIG_PERF_COUNTER_TABLE_SIGNATURE)) {
+    return;
+  }
+
+  Print (L"\nConfiguration Counters:\tPEI\tDXE\n");
+  for (Index = 0; (Index < Table->CounterCount) && (Index < ConfigPerfCounterMax); Index++) {
+    Print (
+      L"\t%-18s\t%ld\t%ld\n",
+      mConfigPerfCounterNames[Index],
+      Table->PeiCounters[Index],
+      Table->DxeCounters[Index]
+      );
+  }
+}
+
 /**
   Helper function to print system information to ConOut.
 **/
@@ -233,11 +292,14 @@ PrintSysInfoOptions (
 
   mDateTimeCol = gST->ConOut->Mode->CursorColumn;
   mDateTimeRow = gST->ConOut->Mode->CursorRow;
+  mTimePrinted = FALSE;
   Status       = PrintDateTime ();
   if (EFI_ERROR (Status)) {
     return Status;
   }
 
+  PrintConfigPerfCounters ();
+
   Print (L"\n");
   Status = PrintAvailableOptions (SysInfoStateOptions, SYS_INFO_STATE_OPTIONS);
   if (EFI_ERROR (Status)) {
@@ -33,6 +33,8 @@
 
 extern EFI_SIMPLE_TEXT_INPUT_EX_PROTOCOL  MockSimpleInput;
 extern BootOptState_t                     mBootOptState;
+extern EFI_BOOT_MANAGER_LOAD_OPTION       *mBootOptions;
+extern UINTN                              mBootOptionCount;
 
 /**
   State machine for system information page. It will display fundamental information, including
@@ -138,6 +140,30 @@ EfiBootManagerGetLoadOptions (
   return NULL;
 }
 
+/**
+  Mock version of EfiBootManagerFreeLoadOptions.
+
+  @param  LoadOptions       Pointer to the array of load options to free.
+  @param  LoadOptionCount   Number of array entries in LoadOptions.
+
+  @return EFI_STATUS        This function always returns success.
+
+**/
+EFI_STATUS
+EFIAPI
+EfiBootManagerFreeLoadOptions (
+  IN  EFI_BOOT_MANAGER_LOAD_OPTION  *LoadOptions,
+  IN  UINTN                         LoadOptionCount
+  )
+{
+  // The mocked options are shallow copies, only the array is allocated
+  if (LoadOptions != NULL) {
+    FreePool (LoadOptions);
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
   Mocked version of EfiBootManagerBoot
 
@@ -255,6 +281,7 @@ BootOptionsCleanup (
   )
 {
   mBootOptState = BootOptInit;
+  InvalidateConfAppState (CONF_APP_STATE_ALL);
 }
 
 /**
@@ -535,6 +562,73 @@ ConfAppBootOptSelectMore (
   return UNIT_TEST_PASSED;
 }
 
+/**
+  Unit test for BootOptions page when it is visited again.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfAppBootOptCached (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS                    Status;
+  EFI_KEY_DATA                  KeyData1;
+  EFI_BOOT_MANAGER_LOAD_OPTION  BootOption = {
+    .Description = L"Test1",
+    .Attributes  = 0xFEEDF00D
+  };
+
+  will_return_count (MockClearScreen, EFI_SUCCESS, 2);
+  will_return_always (MockSetAttribute, EFI_SUCCESS);
+
+  // Expect the prints twice
+  expect_any_count (MockSetCursorPosition, Column, 2);
+  expect_any_count (MockSetCursorPosition, Row, 2);
+  will_return_count (MockSetCursorPosition, EFI_SUCCESS, 2);
+
+  // The boot options are only read on the first visit
+  will_return (EfiBootManagerGetLoadOptions, 1);
+  will_return (EfiBootManagerGetLoadOptions, &BootOption);
+
+  Status = BootOptionMgr ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mBootOptState, BootOptWait);
+
+  mSimpleTextInEx = &MockSimpleInput;
+
+  KeyData1.Key.UnicodeChar = CHAR_NULL;
+  KeyData1.Key.ScanCode    = SCAN_ESC;
+  will_return (MockReadKey, &KeyData1);
+
+  Status = BootOptionMgr ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mBootOptState, BootOptExit);
+
+  Status = BootOptionMgr ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mBootOptState, BootOptInit);
+
+  Status = BootOptionMgr ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mBootOptState, BootOptWait);
+  UT_ASSERT_EQUAL (mBootOptionCount, 1);
+  UT_ASSERT_MEM_EQUAL (mBootOptions, &BootOption, sizeof (EFI_BOOT_MANAGER_LOAD_OPTION));
+
+  return UNIT_TEST_PASSED;
+}
+
 /**
   Initialize the unit test framework, suite, and unit tests for the
   ConfApp and run the ConfApp unit test.
@@ -585,6 +679,7 @@ UnitTestingEntry (
   AddTestCase (MiscTests, "Boot Options page select others should do nothing", "SelectOther", ConfAppBootOptSelectOther, NULL, BootOptionsCleanup, NULL);
   AddTestCase (MiscTests, "Boot Options page should boot to single option", "BootOptionSingle", ConfAppBootOptSelectOne, NULL, BootOptionsCleanup, NULL);
   AddTestCase (MiscTests, "Boot Options page should boot to multiple options", "BootOptionMultiple", ConfAppBootOptSelectMore, NULL, BootOptionsCleanup, NULL);
+  AddTestCase (MiscTests, "Boot Options page should only read boot options once", "BootOptionCached", ConfAppBootOptCached, NULL, BootOptionsCleanup, NULL);
 
   //
   // Execute the tests.
@@ -254,6 +254,7 @@ SecureBootCleanup (
   )
 {
   mSecBootState = SecureBootInit;
+  InvalidateConfAppState (CONF_APP_STATE_ALL);
 }
 
 /**
@@ -17,8 +17,12 @@
 #include <Pi/PiFirmwareFile.h>
 #include <Guid/VariableFormat.h>
 #include <Guid/MuVarPolicyFoundationDxe.h>
+#include <Guid/GlobalVariable.h>
+#include <Guid/WinCertificate.h>
 #include <Protocol/VariablePolicy.h>
 #include <Protocol/Policy.h>
+#include <Protocol/SerialIo.h>
+#include <Protocol/DevicePath.h>
 
 #include <Library/BaseLib.h>
 #include <Library/PrintLib.h>
@@ -27,6 +31,9 @@
 #include <Library/MemoryAllocationLib.h>
 #include <Library/UefiBootManagerLib.h>
 #include <Library/ConfigVariableListLib.h>
+#include <Library/ConfigCrcLib.h>
+#include <Library/ConfigKnobShimLib.h>
+#include <Library/BaseCryptLib.h>
 
 #include <Library/UnitTestLib.h>
 
@@ -40,6 +47,13 @@ extern EFI_SIMPLE_TEXT_INPUT_EX_PROTOCOL  MockSimpleInput;
 extern SetupConfState_t                   mSetupConfState;
 extern POLICY_PROTOCOL                    *mPolicyProtocol;
 
+EFI_STATUS
+EFIAPI
+CreateXmlStringFromCurrentSettings (
+  OUT CHAR8  **XmlString,
+  OUT UINTN  *StringSize
+  );
+
 typedef struct {
   UINTN    Tag;
   UINT8    *Data;
@@ -235,6 +249,66 @@ MockGetTime (
 ///
 extern EFI_RUNTIME_SERVICES  MockRuntime;
 
+/**
+  Mocked version of GetVariable, which also mocks the attributes of the variable so the
+  comparison against current variables can be tested.
+
+  @param[in]       VariableName  A Null-terminated string that is the name of the vendor's variable.
+  @param[in]       VendorGuid    A unique identifier for the vendor.
+  @param[out]      Attributes    If not NULL, a pointer to the memory location to return the
+                                 attributes bitmask for the variable.
+  @param[in, out]  DataSize      On input, the size in bytes of the return Data buffer.
+                                 On output the size of data returned in Data.
+  @param[out]      Data          The buffer to return the contents of the variable.
+
+  @retval EFI_SUCCESS            The function completed successfully.
+  @retval EFI_NOT_FOUND          The variable was not found.
+  @retval EFI_BUFFER_TOO_SMALL   The DataSize is too small for the result.
+
+**/
+EFI_STATUS
+EFIAPI
+MockGetSvdVariable (
+  IN     CHAR16    *VariableName,
+  IN     EFI_GUID  *VendorGuid,
+  OUT    UINT32    *Attributes     OPTIONAL,
+  IN OUT UINTN     *DataSize,
+  OUT    VOID      *Data           OPTIONAL
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Size;
+  UINT32      Attr;
+  VOID        *RetData;
+
+  check_expected (VariableName);
+  check_expected (VendorGuid);
+  assert_non_null (DataSize);
+
+  Status = (EFI_STATUS)mock ();
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Size    = (UINTN)mock ();
+  Attr    = (UINT32)mock ();
+  RetData = (VOID *)mock ();
+
+  if (Attributes != NULL) {
+    *Attributes = Attr;
+  }
+
+  if (Size > *DataSize) {
+    *DataSize = Size;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  *DataSize = Size;
+  CopyMem (Data, RetData, Size);
+  return EFI_SUCCESS;
+}
+
+
 /**
   Mocked version of MockWaitForEvent.
 
@@ -300,6 +374,124 @@ MockLocateProtocol (
   return EFI_SUCCESS;
 }
 
+/**
+  Mocked version of LocateDevicePath.
+
+  @param[in]      Protocol      Specifies the protocol to search for.
+  @param[in,out]  DevicePath    On input, a pointer to a pointer to the device path. On output, the device
+                                path pointer is modified to point to the remaining part of the device
+                                path.
+  @param[out]     Device        A pointer to the returned device handle.
+
+  @retval EFI_SUCCESS           The resulting handle was returned.
+  @retval EFI_NOT_FOUND         No handles match the search.
+
+**/
+EFI_STATUS
+EFIAPI
+MockLocateDevicePath (
+  IN     EFI_GUID                  *Protocol,
+  IN OUT EFI_DEVICE_PATH_PROTOCOL  **DevicePath,
+  OUT    EFI_HANDLE                *Device
+  )
+{
+  EFI_STATUS                Status;
+  EFI_DEVICE_PATH_PROTOCOL  *Node;
+
+  assert_non_null (DevicePath);
+  assert_non_null (Device);
+
+  Node = *DevicePath;
+  check_expected_ptr (Protocol);
+  check_expected_ptr (Node);
+
+  Status = (EFI_STATUS)mock ();
+  if (!EFI_ERROR (Status)) {
+    *Device = (EFI_HANDLE)mock ();
+  }
+
+  return Status;
+}
+
+/**
+  Mocked version of HandleProtocol.
+
+  @param[in]   Handle           The handle being queried.
+  @param[in]   Protocol         The published unique identifier of the protocol.
+  @param[out]  Interface        Supplies the address where a pointer to the corresponding Protocol
+                                Interface is returned.
+
+  @retval EFI_SUCCESS           The interface information for the specified protocol was returned.
+
+**/
+EFI_STATUS
+EFIAPI
+MockHandleProtocol (
+  IN  EFI_HANDLE  Handle,
+  IN  EFI_GUID    *Protocol,
+  OUT VOID        **Interface
+  )
+{
+  check_expected_ptr (Handle);
+  check_expected_ptr (Protocol);
+
+  *Interface = (VOID *)mock ();
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Mocked version of ConnectController.
+
+  @param[in]  ControllerHandle     The handle of the controller to which driver(s) are to be connected.
+  @param[in]  DriverImageHandle    A pointer to an ordered list handles that support the
+                                   EFI_DRIVER_BINDING_PROTOCOL.
+  @param[in]  RemainingDevicePath  A pointer to the device path that specifies a child of the
+                                   controller specified by ControllerHandle.
+  @param[in]  Recursive            If TRUE, then ConnectController() is called recursively
+                                   until the entire tree of controllers below the controller specified
+                                   by ControllerHandle have been created.
+
+  @retval EFI_SUCCESS              One or more drivers were connected to ControllerHandle.
+
+**/
+EFI_STATUS
+EFIAPI
+MockConnectController (
+  IN  EFI_HANDLE                ControllerHandle,
+  IN  EFI_HANDLE                *DriverImageHandle    OPTIONAL,
+  IN  EFI_DEVICE_PATH_PROTOCOL  *RemainingDevicePath  OPTIONAL,
+  IN  BOOLEAN                   Recursive
+  )
+{
+  check_expected_ptr (ControllerHandle);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Mocked version of DisconnectController.
+
+  @param[in]  ControllerHandle     The handle of the controller from which driver(s) are to be disconnected.
+  @param[in]  DriverImageHandle    The driver to disconnect from ControllerHandle.
+  @param[in]  ChildHandle          The handle of the child to destroy.
+
+  @retval EFI_SUCCESS              One or more drivers were disconnected from the controller.
+
+**/
+EFI_STATUS
+EFIAPI
+MockDisconnectController (
+  IN  EFI_HANDLE  ControllerHandle,
+  IN  EFI_HANDLE  DriverImageHandle  OPTIONAL,
+  IN  EFI_HANDLE  ChildHandle        OPTIONAL
+  )
+{
+  check_expected_ptr (ControllerHandle);
+
+  return EFI_SUCCESS;
+}
+
 ///
 /// Mock version of the UEFI Boot Services Table
 ///
@@ -311,10 +503,194 @@ EFI_BOOT_SERVICES  MockBoot = {
     0,
     0
   },
-  .WaitForEvent   = MockWaitForEvent,
-  .LocateProtocol = MockLocateProtocol
+  .WaitForEvent         = MockWaitForEvent,
+  .HandleProtocol       = MockHandleProtocol,
+  .LocateDevicePath     = MockLocateDevicePath,
+  .ConnectController    = MockConnectController,
+  .DisconnectController = MockDisconnectController,
+  .LocateProtocol       = MockLocateProtocol
+};
+
+// Bytes the mocked serial port hands out per read, like a UART FIFO
+#define MOCK_SERIAL_FIFO_SIZE  64
+
+// Bytes the mocked serial port keeps of what is written to it, enough for every handshake code of a transfer
+#define MOCK_SERIAL_WRITE_SIZE  16
+
+#define MOCK_SERIAL_HANDLE  ((EFI_HANDLE)(UINTN)0x5E41A1)
+
+UINT8  *mSerialData      = NULL;
+UINTN  mSerialDataSize   = 0;
+UINTN  mSerialDataOffset = 0;
+UINT8  mSerialWritten[MOCK_SERIAL_WRITE_SIZE];
+UINTN  mSerialWrittenSize = 0;
+
+//
+// ConIn holding a keyboard and a serial terminal, only the second one is a serial port.
+//
+typedef struct {
+  VENDOR_DEVICE_PATH          Keyboard;
+  EFI_DEVICE_PATH_PROTOCOL    EndInstance;
+  VENDOR_DEVICE_PATH          Serial;
+  EFI_DEVICE_PATH_PROTOCOL    End;
+} MOCK_CON_IN_DEVICE_PATH;
+
+MOCK_CON_IN_DEVICE_PATH  mMockConIn = {
+  {
+    { HARDWARE_DEVICE_PATH, HW_VENDOR_DP, { sizeof (VENDOR_DEVICE_PATH), 0 }
+    },
+    { 0x2C5F9B4A, 0x8E3D, 0x4B1A, { 0x9F, 0x6E, 0x1D, 0x2C, 0x3B, 0x4A, 0x59, 0x68 }
+    }
+  },
+  { END_DEVICE_PATH_TYPE, END_INSTANCE_DEVICE_PATH_SUBTYPE, { END_DEVICE_PATH_LENGTH, 0 }
+  },
+  {
+    { HARDWARE_DEVICE_PATH, HW_VENDOR_DP, { sizeof (VENDOR_DEVICE_PATH), 0 }
+    },
+    { 0x7A1E3C5D, 0x2B4F, 0x4E6A, { 0x8C, 0x1D, 0x3E, 0x5F, 0x7A, 0x9B, 0x0C, 0x2D }
+    }
+  },
+  { END_DEVICE_PATH_TYPE, END_ENTIRE_DEVICE_PATH_SUBTYPE, { END_DEVICE_PATH_LENGTH, 0 }
+  }
+};
+
+/**
+  Mocked version of the serial port Read, handing out mSerialData in FIFO sized chunks.
+
+  @param[in]      This        Protocol instance pointer.
+  @param[in,out]  BufferSize  On input, the size of the Buffer. On output, the amount of
+                              data returned in Buffer.
+  @param[out]     Buffer      The buffer to return the data into.
+
+  @retval EFI_SUCCESS         The data was read.
+  @retval EFI_TIMEOUT         The data could not be read.
+
+**/
+EFI_STATUS
+EFIAPI
+MockSerialRead (
+  IN EFI_SERIAL_IO_PROTOCOL  *This,
+  IN OUT UINTN               *BufferSize,
+  OUT VOID                   *Buffer
+  )
+{
+  UINTN  Size;
+
+  assert_non_null (BufferSize);
+  assert_non_null (Buffer);
+
+  Size = MIN (MIN (*BufferSize, mSerialDataSize - mSerialDataOffset), MOCK_SERIAL_FIFO_SIZE);
+  CopyMem (Buffer, mSerialData + mSerialDataOffset, Size);
+  mSerialDataOffset += Size;
+  *BufferSize        = Size;
+
+  return (Size == 0) ? EFI_TIMEOUT : EFI_SUCCESS;
+}
+
+/**
+  Mocked version of the serial port Write, keeping the written bytes in mSerialWritten.
+
+  @param[in]      This        Protocol instance pointer.
+  @param[in,out]  BufferSize  On input, the size of the Buffer. On output, the amount of
+                              data actually written.
+  @param[in]      Buffer      The buffer of data to write.
+
+  @retval EFI_SUCCESS         The data was written.
+
+**/
+EFI_STATUS
+EFIAPI
+MockSerialWrite (
+  IN EFI_SERIAL_IO_PROTOCOL  *This,
+  IN OUT UINTN               *BufferSize,
+  IN VOID                    *Buffer
+  )
+{
+  assert_non_null (BufferSize);
+  assert_non_null (Buffer);
+  assert_true (*BufferSize <= sizeof (mSerialWritten) - mSerialWrittenSize);
+
+  CopyMem (mSerialWritten + mSerialWrittenSize, Buffer, *BufferSize);
+  mSerialWrittenSize += *BufferSize;
+
+  return EFI_SUCCESS;
+}
+
+EFI_SERIAL_IO_PROTOCOL  mMockedSerialIo = {
+  .Write = MockSerialWrite,
+  .Read  = MockSerialRead
 };
 
+/**
+  Expect the bulk transfer to find the serial port in ConIn and to stop its terminal.
+
+**/
+VOID
+ExpectConsoleSerialIo (
+  VOID
+  )
+{
+  // Size query, then the device paths
+  expect_memory (MockGetVariable, VariableName, EFI_CON_IN_VARIABLE_NAME, sizeof (EFI_CON_IN_VARIABLE_NAME));
+  expect_memory (MockGetVariable, VendorGuid, &gEfiGlobalVariableGuid, sizeof (EFI_GUID));
+  will_return (MockGetVariable, sizeof (mMockConIn));
+
+  expect_memory (MockGetVariable, VariableName, EFI_CON_IN_VARIABLE_NAME, sizeof (EFI_CON_IN_VARIABLE_NAME));
+  expect_memory (MockGetVariable, VendorGuid, &gEfiGlobalVariableGuid, sizeof (EFI_GUID));
+  will_return (MockGetVariable, sizeof (mMockConIn));
+  will_return (MockGetVariable, &mMockConIn);
+  will_return (MockGetVariable, EFI_SUCCESS);
+
+  // The keyboard is skipped
+  expect_memory (MockLocateDevicePath, Protocol, &gEfiSerialIoProtocolGuid, sizeof (EFI_GUID));
+  expect_memory (MockLocateDevicePath, Node, &mMockConIn.Keyboard, sizeof (VENDOR_DEVICE_PATH));
+  will_return (MockLocateDevicePath, EFI_NOT_FOUND);
+
+  expect_memory (MockLocateDevicePath, Protocol, &gEfiSerialIoProtocolGuid, sizeof (EFI_GUID));
+  expect_memory (MockLocateDevicePath, Node, &mMockConIn.Serial, sizeof (VENDOR_DEVICE_PATH));
+  will_return (MockLocateDevicePath, EFI_SUCCESS);
+  will_return (MockLocateDevicePath, MOCK_SERIAL_HANDLE);
+
+  expect_value (MockHandleProtocol, Handle, MOCK_SERIAL_HANDLE);
+  expect_memory (MockHandleProtocol, Protocol, &gEfiSerialIoProtocolGuid, sizeof (EFI_GUID));
+  will_return (MockHandleProtocol, &mMockedSerialIo);
+
+  expect_value (MockDisconnectController, ControllerHandle, MOCK_SERIAL_HANDLE);
+}
+
+/**
+  Set up the mocked serial port to send a bulk transfer frame of a payload.
+
+  @param[in]  Payload       Payload to send.
+  @param[in]  PayloadSize   Size of the payload.
+  @param[in]  CrcXor        Value to corrupt the CRC of the payload with.
+
+**/
+VOID
+SetSerialBulkFrame (
+  IN CONST VOID  *Payload,
+  IN UINTN       PayloadSize,
+  IN UINT32      CrcXor
+  )
+{
+  SVD_SERIAL_BULK_HEADER  Header;
+  UINT32                  Crc32;
+
+  Header.Signature   = SVD_SERIAL_BULK_SIGNATURE;
+  Header.PayloadSize = (UINT32)PayloadSize;
+  Crc32              = ConfigCalculateCrc32 (Payload, PayloadSize) ^ CrcXor;
+
+  mSerialDataSize    = sizeof (Header) + PayloadSize + sizeof (Crc32);
+  mSerialDataOffset  = 0;
+  mSerialWrittenSize = 0;
+  mSerialData       = AllocatePool (mSerialDataSize);
+  assert_non_null (mSerialData);
+
+  CopyMem (mSerialData, &Header, sizeof (Header));
+  CopyMem (mSerialData + sizeof (Header), Payload, PayloadSize);
+  CopyMem (mSerialData + sizeof (Header) + PayloadSize, &Crc32, sizeof (Crc32));
+}
+
 /**
   Mocked version of GetPolicy.
 
@@ -400,6 +776,12 @@ SetupConfCleanup (
   SetupConfMgr ();
   mSetupConfState = SetupConfInit;
   mPolicyProtocol = NULL;
+  InvalidateConfAppState (CONF_APP_STATE_ALL);
+
+  if (mSerialData != NULL) {
+    FreePool (mSerialData);
+    mSerialData = NULL;
+  }
 }
 
 /**
@@ -602,11 +984,20 @@ ConfAppSetupConfSelectUsb (
   will_return (SvdRequestXmlFromUSB, sizeof (KNOWN_GOOD_VARLIST_XML) - 1);
   will_return (SvdRequestXmlFromUSB, KNOWN_GOOD_VARLIST_XML);
 
+  // Neither variable is stored yet, so both are written without deleting first
+  expect_memory (MockGetSvdVariable, VariableName, L"COMPLEX_KNOB1a", StrSize (L"COMPLEX_KNOB1a"));
+  expect_memory (MockGetSvdVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
+  will_return (MockGetSvdVariable, EFI_NOT_FOUND);
+
+  expect_memory (MockGetSvdVariable, VariableName, L"INTEGER_KNOB", StrSize (L"INTEGER_KNOB"));
+  expect_memory (MockGetSvdVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
+  will_return (MockGetSvdVariable, EFI_NOT_FOUND);
+
   will_return_always (MockSetVariable, EFI_SUCCESS);
 
-  // first time through is delete
-  expect_memory (MockSetVariable, VariableName, L"COMPLEX_KNOB1a", StrSize (L"COMPLEX_KNOB1a"));
-  expect_memory (MockSetVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
+  // The cached config policy is invalidated before any setting changes
+  expect_memory (MockSetVariable, VariableName, CONFIG_KNOB_POLICY_CACHE_INFO_VARIABLE_NAME, StrSize (CONFIG_KNOB_POLICY_CACHE_INFO_VARIABLE_NAME));
+  expect_memory (MockSetVariable, VendorGuid, &gConfigKnobPolicyCacheVariableGuid, sizeof (EFI_GUID));
   expect_value (MockSetVariable, DataSize, 0x00);
   expect_value (MockSetVariable, Data, NULL);
 
@@ -615,12 +1006,6 @@ ConfAppSetupConfSelectUsb (
   expect_value (MockSetVariable, DataSize, mKnown_Good_VarList_DataSizes[2]);
   expect_memory (MockSetVariable, Data, mKnown_Good_VarList_Entries[2], mKnown_Good_VarList_DataSizes[2]);
 
-  // first time through is delete
-  expect_memory (MockSetVariable, VariableName, L"INTEGER_KNOB", StrSize (L"INTEGER_KNOB"));
-  expect_memory (MockSetVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
-  expect_value (MockSetVariable, DataSize, 0x00);
-  expect_value (MockSetVariable, Data, NULL);
-
   expect_memory (MockSetVariable, VariableName, L"INTEGER_KNOB", StrSize (L"INTEGER_KNOB"));
   expect_memory (MockSetVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
   expect_value (MockSetVariable, DataSize, mKnown_Good_VarList_DataSizes[5]);
@@ -636,7 +1021,7 @@ ConfAppSetupConfSelectUsb (
 }
 
 /**
-  Unit test for SetupConf page when selecting configure from serial and passing in arbitrary SVD variables.
+  Unit test for SetupConf page when selecting configure from USB over variables that are already stored.
 
   @param[in]  Context    [Optional] An optional parameter that enables:
                          1) test-case reuse with varied parameters and
@@ -652,14 +1037,12 @@ ConfAppSetupConfSelectUsb (
 **/
 UNIT_TEST_STATUS
 EFIAPI
-ConfAppSetupConfSelectSerialWithArbitrarySVD (
+ConfAppSetupConfSelectUsbStored (
   IN UNIT_TEST_CONTEXT  Context
   )
 {
   EFI_STATUS                Status;
   EFI_KEY_DATA              KeyData1;
-  UINTN                     Index;
-  CHAR8                     *KnowGoodXml;
   BASE_LIBRARY_JUMP_BUFFER  JumpBuf;
 
   will_return (IsSystemInManufacturingMode, TRUE);
@@ -681,42 +1064,42 @@ ConfAppSetupConfSelectSerialWithArbitrarySVD (
 
   mSimpleTextInEx = &MockSimpleInput;
 
-  KeyData1.Key.UnicodeChar = '2';
+  KeyData1.Key.UnicodeChar = '1';
   KeyData1.Key.ScanCode    = SCAN_NULL;
   will_return (MockReadKey, &KeyData1);
 
   Status = SetupConfMgr ();
   UT_ASSERT_NOT_EFI_ERROR (Status);
-  UT_ASSERT_EQUAL (mSetupConfState, SetupConfUpdateSerialHint);
+  UT_ASSERT_EQUAL (mSetupConfState, SetupConfUpdateUsb);
 
-  Index       = 0;
-  KnowGoodXml = KNOWN_GOOD_VARLIST_XML;
-  while (KnowGoodXml[Index] != 0) {
-    KeyData1.Key.UnicodeChar = KnowGoodXml[Index];
-    KeyData1.Key.ScanCode    = SCAN_NULL;
-    will_return (MockReadKey, &KeyData1);
-    Status = SetupConfMgr ();
-    Index++;
-  }
+  expect_memory (SvdRequestXmlFromUSB, FileName, PcdGetPtr (PcdConfigurationFileName), PcdGetSize (PcdConfigurationFileName));
+  will_return (SvdRequestXmlFromUSB, sizeof (KNOWN_GOOD_VARLIST_XML) - 1);
+  will_return (SvdRequestXmlFromUSB, KNOWN_GOOD_VARLIST_XML);
 
-  KeyData1.Key.UnicodeChar = CHAR_CARRIAGE_RETURN;
-  KeyData1.Key.ScanCode    = SCAN_NULL;
-  will_return (MockReadKey, &KeyData1);
+  // COMPLEX_KNOB1a is stored as is, so must not be written at all
+  expect_memory (MockGetSvdVariable, VariableName, L"COMPLEX_KNOB1a", StrSize (L"COMPLEX_KNOB1a"));
+  expect_memory (MockGetSvdVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
+  will_return (MockGetSvdVariable, EFI_SUCCESS);
+  will_return (MockGetSvdVariable, mKnown_Good_VarList_DataSizes[2]);
+  will_return (MockGetSvdVariable, EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS);
+  will_return (MockGetSvdVariable, mKnown_Good_VarList_Entries[2]);
+
+  // INTEGER_KNOB is stored larger, so is deleted before being written
+  expect_memory (MockGetSvdVariable, VariableName, L"INTEGER_KNOB", StrSize (L"INTEGER_KNOB"));
+  expect_memory (MockGetSvdVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
+  will_return (MockGetSvdVariable, EFI_SUCCESS);
+  will_return (MockGetSvdVariable, mKnown_Good_VarList_DataSizes[7]);
+  will_return (MockGetSvdVariable, EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS);
+  will_return (MockGetSvdVariable, mKnown_Good_VarList_Entries[7]);
 
   will_return_always (MockSetVariable, EFI_SUCCESS);
 
-  // first time through is delete
-  expect_memory (MockSetVariable, VariableName, L"COMPLEX_KNOB1a", StrSize (L"COMPLEX_KNOB1a"));
-  expect_memory (MockSetVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
+  // The cached config policy is invalidated before any setting changes
+  expect_memory (MockSetVariable, VariableName, CONFIG_KNOB_POLICY_CACHE_INFO_VARIABLE_NAME, StrSize (CONFIG_KNOB_POLICY_CACHE_INFO_VARIABLE_NAME));
+  expect_memory (MockSetVariable, VendorGuid, &gConfigKnobPolicyCacheVariableGuid, sizeof (EFI_GUID));
   expect_value (MockSetVariable, DataSize, 0x00);
   expect_value (MockSetVariable, Data, NULL);
 
-  expect_memory (MockSetVariable, VariableName, L"COMPLEX_KNOB1a", StrSize (L"COMPLEX_KNOB1a"));
-  expect_memory (MockSetVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
-  expect_value (MockSetVariable, DataSize, mKnown_Good_VarList_DataSizes[2]);
-  expect_memory (MockSetVariable, Data, mKnown_Good_VarList_Entries[2], mKnown_Good_VarList_DataSizes[2]);
-
-  // first time through is delete
   expect_memory (MockSetVariable, VariableName, L"INTEGER_KNOB", StrSize (L"INTEGER_KNOB"));
   expect_memory (MockSetVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
   expect_value (MockSetVariable, DataSize, 0x00);
@@ -736,8 +1119,102 @@ ConfAppSetupConfSelectSerialWithArbitrarySVD (
   return UNIT_TEST_PASSED;
 }
 
+// The variable list carried by KNOWN_GOOD_VARLIST_XML, in the form a binary settings packet carries it
+STATIC CONST UINT8  mKnown_Good_VarList_Binary[] = {
+  0x1e, 0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x43, 0x00, 0x4f, 0x00, 0x4d, 0x00, 0x50, 0x00,
+  0x4c, 0x00, 0x45, 0x00, 0x58, 0x00, 0x5f, 0x00, 0x4b, 0x00, 0x4e, 0x00, 0x4f, 0x00, 0x42, 0x00,
+  0x31, 0x00, 0x61, 0x00, 0x00, 0x00, 0xfe, 0x3e, 0xd4, 0x9f, 0xb1, 0x73, 0x41, 0xed, 0x90, 0x76,
+  0x35, 0x66, 0x61, 0xd4, 0x6a, 0x42, 0x06, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x00,
+  0x00, 0x00, 0x00, 0x2f, 0x40, 0xdd, 0x59, 0x1a, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x49,
+  0x00, 0x4e, 0x00, 0x54, 0x00, 0x45, 0x00, 0x47, 0x00, 0x45, 0x00, 0x52, 0x00, 0x5f, 0x00, 0x4b,
+  0x00, 0x4e, 0x00, 0x4f, 0x00, 0x42, 0x00, 0x00, 0x00, 0xfe, 0x3e, 0xd4, 0x9f, 0xb1, 0x73, 0x41,
+  0xed, 0x90, 0x76, 0x35, 0x66, 0x61, 0xd4, 0x6a, 0x42, 0x06, 0x00, 0x00, 0x00, 0x64, 0x00, 0x00,
+  0x00, 0x0f, 0xe0, 0xf8, 0xdf,
+};
+
+// Stands in for the detached PKCS7 signature of a binary settings packet, only compared by the mocked Pkcs7Verify
+STATIC CONST UINT8  mMockPkcs7Signature[] = {
+  0x30, 0x82, 0x05, 0x5a, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x07, 0x02,
+};
+
+#define KNOWN_GOOD_BINARY_PACKET_SIGNED_SIZE  (sizeof (SVD_BINARY_PACKET_HEADER) + sizeof (mKnown_Good_VarList_Binary))
+#define KNOWN_GOOD_BINARY_PACKET_SIZE         (KNOWN_GOOD_BINARY_PACKET_SIGNED_SIZE +\
+                                               OFFSET_OF (WIN_CERTIFICATE_UEFI_GUID, CertData) + sizeof (mMockPkcs7Signature))
+
 /**
-  Unit test for SetupConf page when selecting configure from serial and return in the middle.
+  Mocked version of Pkcs7Verify.
+
+  @param[in]  P7Data       Pointer to the PKCS#7 message to verify.
+  @param[in]  P7Length     Length of the PKCS#7 message in bytes.
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+  @param[in]  InData       Pointer to the content to be verified.
+  @param[in]  DataLength   Length of InData in bytes.
+
+  @retval  TRUE   The specified PKCS#7 signed data is valid.
+  @retval  FALSE  Invalid PKCS#7 signed data.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7Verify (
+  IN  CONST UINT8  *P7Data,
+  IN  UINTN        P7Length,
+  IN  CONST UINT8  *TrustedCert,
+  IN  UINTN        CertLength,
+  IN  CONST UINT8  *InData,
+  IN  UINTN        DataLength
+  )
+{
+  assert_int_equal (P7Length, sizeof (mMockPkcs7Signature));
+  assert_memory_equal (P7Data, mMockPkcs7Signature, sizeof (mMockPkcs7Signature));
+  assert_int_equal (CertLength, PcdGetSize (PcdConfigurationBinarySettingsTrustedCert));
+  assert_memory_equal (TrustedCert, PcdGetPtr (PcdConfigurationBinarySettingsTrustedCert), CertLength);
+  assert_int_equal (DataLength, KNOWN_GOOD_BINARY_PACKET_SIGNED_SIZE);
+  assert_int_equal (ReadUnaligned32 ((UINT32 *)InData), SVD_BINARY_PACKET_SIGNATURE);
+
+  return (BOOLEAN)mock ();
+}
+
+/**
+  Build a signed binary settings packet of mKnown_Good_VarList_Binary.
+
+  @param[out] Packet    Buffer of KNOWN_GOOD_BINARY_PACKET_SIZE bytes to build the packet in.
+
+**/
+VOID
+BuildKnownGoodBinaryPacket (
+  OUT UINT8  *Packet
+  )
+{
+  SVD_BINARY_PACKET_HEADER   Header;
+  WIN_CERTIFICATE_UEFI_GUID  Cert;
+
+  Header.Signature              = SVD_BINARY_PACKET_SIGNATURE;
+  Header.HeaderVersion          = SVD_BINARY_PACKET_HEADER_VERSION;
+  Header.HeaderSize             = sizeof (SVD_BINARY_PACKET_HEADER);
+  Header.Version                = 1;
+  Header.LowestSupportedVersion = 1;
+  Header.PayloadSize            = sizeof (mKnown_Good_VarList_Binary);
+  Header.PayloadCrc32           = ConfigCalculateCrc32 (mKnown_Good_VarList_Binary, sizeof (mKnown_Good_VarList_Binary));
+
+  Cert.Hdr.dwLength         = OFFSET_OF (WIN_CERTIFICATE_UEFI_GUID, CertData) + sizeof (mMockPkcs7Signature);
+  Cert.Hdr.wRevision        = 0x0200;
+  Cert.Hdr.wCertificateType = WIN_CERT_TYPE_EFI_GUID;
+  CopyGuid (&Cert.CertType, &gEfiCertPkcs7Guid);
+
+  CopyMem (Packet, &Header, sizeof (Header));
+  CopyMem (Packet + sizeof (Header), mKnown_Good_VarList_Binary, sizeof (mKnown_Good_VarList_Binary));
+  CopyMem (Packet + KNOWN_GOOD_BINARY_PACKET_SIGNED_SIZE, &Cert, OFFSET_OF (WIN_CERTIFICATE_UEFI_GUID, CertData));
+  CopyMem (
+    Packet + KNOWN_GOOD_BINARY_PACKET_SIGNED_SIZE + OFFSET_OF (WIN_CERTIFICATE_UEFI_GUID, CertData),
+    mMockPkcs7Signature,
+    sizeof (mMockPkcs7Signature)
+    );
+}
+
+/**
+  Unit test for SetupConf page when selecting configure from USB with a binary settings packet.
 
   @param[in]  Context    [Optional] An optional parameter that enables:
                          1) test-case reuse with varied parameters and
@@ -753,14 +1230,17 @@ ConfAppSetupConfSelectSerialWithArbitrarySVD (
 **/
 UNIT_TEST_STATUS
 EFIAPI
-ConfAppSetupConfSelectSerialEsc (
+ConfAppSetupConfSelectUsbBinary (
   IN UNIT_TEST_CONTEXT  Context
   )
 {
-  EFI_STATUS    Status;
-  EFI_KEY_DATA  KeyData1;
-  UINTN         Index;
-  CHAR8         *KnowGoodXml;
+  EFI_STATUS                Status;
+  EFI_KEY_DATA              KeyData1;
+  BASE_LIBRARY_JUMP_BUFFER  JumpBuf;
+  UINT8                     Packet[KNOWN_GOOD_BINARY_PACKET_SIZE + 1];
+
+  BuildKnownGoodBinaryPacket (Packet);
+  Packet[sizeof (Packet) - 1] = '\0';
 
   will_return (IsSystemInManufacturingMode, TRUE);
   will_return (MockClearScreen, EFI_SUCCESS);
@@ -781,41 +1261,499 @@ ConfAppSetupConfSelectSerialEsc (
 
   mSimpleTextInEx = &MockSimpleInput;
 
-  KeyData1.Key.UnicodeChar = '2';
+  KeyData1.Key.UnicodeChar = '1';
   KeyData1.Key.ScanCode    = SCAN_NULL;
   will_return (MockReadKey, &KeyData1);
 
   Status = SetupConfMgr ();
   UT_ASSERT_NOT_EFI_ERROR (Status);
-  UT_ASSERT_EQUAL (mSetupConfState, SetupConfUpdateSerialHint);
+  UT_ASSERT_EQUAL (mSetupConfState, SetupConfUpdateUsb);
 
-  Index       = 0;
-  KnowGoodXml = KNOWN_GOOD_VARLIST_XML;
-  while (KnowGoodXml[Index] != 0) {
-    KeyData1.Key.UnicodeChar = KnowGoodXml[Index];
-    KeyData1.Key.ScanCode    = SCAN_NULL;
-    will_return (MockReadKey, &KeyData1);
-    Status = SetupConfMgr ();
-    UT_ASSERT_NOT_EFI_ERROR (Status);
-    UT_ASSERT_EQUAL (mSetupConfState, SetupConfUpdateSerial);
-    Index++;
-  }
+  // The USB file is read with a terminating NULL appended, which is not part of the packet
+  expect_memory (SvdRequestXmlFromUSB, FileName, PcdGetPtr (PcdConfigurationFileName), PcdGetSize (PcdConfigurationFileName));
+  will_return (SvdRequestXmlFromUSB, sizeof (Packet));
+  will_return (SvdRequestXmlFromUSB, Packet);
 
-  KeyData1.Key.UnicodeChar = CHAR_NULL;
-  KeyData1.Key.ScanCode    = SCAN_ESC;
-  will_return (MockReadKey, &KeyData1);
+  will_return (Pkcs7Verify, TRUE);
 
-  Status = SetupConfMgr ();
-  UT_ASSERT_NOT_EFI_ERROR (Status);
-  UT_ASSERT_EQUAL (mSetupConfState, SetupConfExit);
+  // The same variables as the XML packet are applied
+  expect_memory (MockGetSvdVariable, VariableName, L"COMPLEX_KNOB1a", StrSize (L"COMPLEX_KNOB1a"));
+  expect_memory (MockGetSvdVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
+  will_return (MockGetSvdVariable, EFI_NOT_FOUND);
 
-  return UNIT_TEST_PASSED;
-}
+  expect_memory (MockGetSvdVariable, VariableName, L"INTEGER_KNOB", StrSize (L"INTEGER_KNOB"));
+  expect_memory (MockGetSvdVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
+  will_return (MockGetSvdVariable, EFI_NOT_FOUND);
 
-/**
-  Unit test for SetupConf page when selecting dumping configure from serial.
+  will_return_always (MockSetVariable, EFI_SUCCESS);
 
-  @param[in]  Context    [Optional] An optional parameter that enables:
+  // The cached config policy is invalidated before any setting changes
+  expect_memory (MockSetVariable, VariableName, CONFIG_KNOB_POLICY_CACHE_INFO_VARIABLE_NAME, StrSize (CONFIG_KNOB_POLICY_CACHE_INFO_VARIABLE_NAME));
+  expect_memory (MockSetVariable, VendorGuid, &gConfigKnobPolicyCacheVariableGuid, sizeof (EFI_GUID));
+  expect_value (MockSetVariable, DataSize, 0x00);
+  expect_value (MockSetVariable, Data, NULL);
+
+  expect_memory (MockSetVariable, VariableName, L"COMPLEX_KNOB1a", StrSize (L"COMPLEX_KNOB1a"));
+  expect_memory (MockSetVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
+  expect_value (MockSetVariable, DataSize, mKnown_Good_VarList_DataSizes[2]);
+  expect_memory (MockSetVariable, Data, mKnown_Good_VarList_Entries[2], mKnown_Good_VarList_DataSizes[2]);
+
+  expect_memory (MockSetVariable, VariableName, L"INTEGER_KNOB", StrSize (L"INTEGER_KNOB"));
+  expect_memory (MockSetVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
+  expect_value (MockSetVariable, DataSize, mKnown_Good_VarList_DataSizes[5]);
+  expect_memory (MockSetVariable, Data, mKnown_Good_VarList_Entries[5], mKnown_Good_VarList_DataSizes[5]);
+
+  will_return (ResetCold, &JumpBuf);
+
+  if (!SetJump (&JumpBuf)) {
+    SetupConfMgr ();
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for SetupConf page when selecting configure from serial and passing in arbitrary SVD variables.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfAppSetupConfSelectSerialWithArbitrarySVD (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS                Status;
+  EFI_KEY_DATA              KeyData1;
+  UINTN                     Index;
+  CHAR8                     *KnowGoodXml;
+  BASE_LIBRARY_JUMP_BUFFER  JumpBuf;
+
+  will_return (IsSystemInManufacturingMode, TRUE);
+  will_return (MockClearScreen, EFI_SUCCESS);
+  will_return_always (MockSetAttribute, EFI_SUCCESS);
+
+  expect_memory (MockLocateProtocol, Protocol, &gPolicyProtocolGuid, sizeof (EFI_GUID));
+  will_return (MockLocateProtocol, &mMockedPolicy);
+
+  // Expect the prints twice
+  expect_any (MockSetCursorPosition, Column);
+  expect_any (MockSetCursorPosition, Row);
+  will_return (MockSetCursorPosition, EFI_SUCCESS);
+
+  // Initial run
+  Status = SetupConfMgr ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mSetupConfState, SetupConfWait);
+
+  mSimpleTextInEx = &MockSimpleInput;
+
+  KeyData1.Key.UnicodeChar = '2';
+  KeyData1.Key.ScanCode    = SCAN_NULL;
+  will_return (MockReadKey, &KeyData1);
+
+  Status = SetupConfMgr ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mSetupConfState, SetupConfUpdateSerialHint);
+
+  Index       = 0;
+  KnowGoodXml = KNOWN_GOOD_VARLIST_XML;
+  while (KnowGoodXml[Index] != 0) {
+    KeyData1.Key.UnicodeChar = KnowGoodXml[Index];
+    KeyData1.Key.ScanCode    = SCAN_NULL;
+    will_return (MockReadKey, &KeyData1);
+    Status = SetupConfMgr ();
+    Index++;
+  }
+
+  KeyData1.Key.UnicodeChar = CHAR_CARRIAGE_RETURN;
+  KeyData1.Key.ScanCode    = SCAN_NULL;
+  will_return (MockReadKey, &KeyData1);
+
+  // Neither variable is stored yet, so both are written without deleting first
+  expect_memory (MockGetSvdVariable, VariableName, L"COMPLEX_KNOB1a", StrSize (L"COMPLEX_KNOB1a"));
+  expect_memory (MockGetSvdVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
+  will_return (MockGetSvdVariable, EFI_NOT_FOUND);
+
+  expect_memory (MockGetSvdVariable, VariableName, L"INTEGER_KNOB", StrSize (L"INTEGER_KNOB"));
+  expect_memory (MockGetSvdVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
+  will_return (MockGetSvdVariable, EFI_NOT_FOUND);
+
+  will_return_always (MockSetVariable, EFI_SUCCESS);
+
+  // The cached config policy is invalidated before any setting changes
+  expect_memory (MockSetVariable, VariableName, CONFIG_KNOB_POLICY_CACHE_INFO_VARIABLE_NAME, StrSize (CONFIG_KNOB_POLICY_CACHE_INFO_VARIABLE_NAME));
+  expect_memory (MockSetVariable, VendorGuid, &gConfigKnobPolicyCacheVariableGuid, sizeof (EFI_GUID));
+  expect_value (MockSetVariable, DataSize, 0x00);
+  expect_value (MockSetVariable, Data, NULL);
+
+  expect_memory (MockSetVariable, VariableName, L"COMPLEX_KNOB1a", StrSize (L"COMPLEX_KNOB1a"));
+  expect_memory (MockSetVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
+  expect_value (MockSetVariable, DataSize, mKnown_Good_VarList_DataSizes[2]);
+  expect_memory (MockSetVariable, Data, mKnown_Good_VarList_Entries[2], mKnown_Good_VarList_DataSizes[2]);
+
+  expect_memory (MockSetVariable, VariableName, L"INTEGER_KNOB", StrSize (L"INTEGER_KNOB"));
+  expect_memory (MockSetVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
+  expect_value (MockSetVariable, DataSize, mKnown_Good_VarList_DataSizes[5]);
+  expect_memory (MockSetVariable, Data, mKnown_Good_VarList_Entries[5], mKnown_Good_VarList_DataSizes[5]);
+
+  will_return (ResetCold, &JumpBuf);
+
+  if (!SetJump (&JumpBuf)) {
+    SetupConfMgr ();
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for SetupConf page when selecting configure from serial and sending a bulk transfer.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfAppSetupConfSelectSerialBulk (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS                Status;
+  EFI_KEY_DATA              KeyData1;
+  BASE_LIBRARY_JUMP_BUFFER  JumpBuf;
+
+  will_return (IsSystemInManufacturingMode, TRUE);
+  will_return (MockClearScreen, EFI_SUCCESS);
+  will_return_always (MockSetAttribute, EFI_SUCCESS);
+
+  expect_memory (MockLocateProtocol, Protocol, &gPolicyProtocolGuid, sizeof (EFI_GUID));
+  will_return (MockLocateProtocol, &mMockedPolicy);
+
+  // Expect the prints twice
+  expect_any (MockSetCursorPosition, Column);
+  expect_any (MockSetCursorPosition, Row);
+  will_return (MockSetCursorPosition, EFI_SUCCESS);
+
+  // Initial run
+  Status = SetupConfMgr ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mSetupConfState, SetupConfWait);
+
+  mSimpleTextInEx = &MockSimpleInput;
+
+  KeyData1.Key.UnicodeChar = '2';
+  KeyData1.Key.ScanCode    = SCAN_NULL;
+  will_return (MockReadKey, &KeyData1);
+
+  Status = SetupConfMgr ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mSetupConfState, SetupConfUpdateSerialHint);
+
+  // Start the bulk transfer
+  KeyData1.Key.UnicodeChar = SVD_SERIAL_BULK_START;
+  KeyData1.Key.ScanCode    = SCAN_NULL;
+  will_return (MockReadKey, &KeyData1);
+
+  ExpectConsoleSerialIo ();
+  SetSerialBulkFrame (KNOWN_GOOD_VARLIST_XML, sizeof (KNOWN_GOOD_VARLIST_XML) - 1, 0);
+
+  expect_memory (MockGetSvdVariable, VariableName, L"COMPLEX_KNOB1a", StrSize (L"COMPLEX_KNOB1a"));
+  expect_memory (MockGetSvdVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
+  will_return (MockGetSvdVariable, EFI_NOT_FOUND);
+
+  expect_memory (MockGetSvdVariable, VariableName, L"INTEGER_KNOB", StrSize (L"INTEGER_KNOB"));
+  expect_memory (MockGetSvdVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
+  will_return (MockGetSvdVariable, EFI_NOT_FOUND);
+
+  will_return_always (MockSetVariable, EFI_SUCCESS);
+
+  // The cached config policy is invalidated before any setting changes
+  expect_memory (MockSetVariable, VariableName, CONFIG_KNOB_POLICY_CACHE_INFO_VARIABLE_NAME, StrSize (CONFIG_KNOB_POLICY_CACHE_INFO_VARIABLE_NAME));
+  expect_memory (MockSetVariable, VendorGuid, &gConfigKnobPolicyCacheVariableGuid, sizeof (EFI_GUID));
+  expect_value (MockSetVariable, DataSize, 0x00);
+  expect_value (MockSetVariable, Data, NULL);
+
+  expect_memory (MockSetVariable, VariableName, L"COMPLEX_KNOB1a", StrSize (L"COMPLEX_KNOB1a"));
+  expect_memory (MockSetVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
+  expect_value (MockSetVariable, DataSize, mKnown_Good_VarList_DataSizes[2]);
+  expect_memory (MockSetVariable, Data, mKnown_Good_VarList_Entries[2], mKnown_Good_VarList_DataSizes[2]);
+
+  expect_memory (MockSetVariable, VariableName, L"INTEGER_KNOB", StrSize (L"INTEGER_KNOB"));
+  expect_memory (MockSetVariable, VendorGuid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
+  expect_value (MockSetVariable, DataSize, mKnown_Good_VarList_DataSizes[5]);
+  expect_memory (MockSetVariable, Data, mKnown_Good_VarList_Entries[5], mKnown_Good_VarList_DataSizes[5]);
+
+  will_return (ResetCold, &JumpBuf);
+
+  if (!SetJump (&JumpBuf)) {
+    SetupConfMgr ();
+  }
+
+  UT_ASSERT_EQUAL (mSerialDataOffset, mSerialDataSize);
+
+  // Ready before the frame, acknowledged once applied
+  UT_ASSERT_EQUAL (mSerialWrittenSize, 2 * sizeof (UINT32));
+  UT_ASSERT_EQUAL (ReadUnaligned32 ((UINT32 *)mSerialWritten), SVD_SERIAL_BULK_READY);
+  UT_ASSERT_EQUAL (ReadUnaligned32 ((UINT32 *)(mSerialWritten + sizeof (UINT32))), SVD_SERIAL_BULK_ACK);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for SetupConf page when a bulk transfer from serial is corrupted.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfAppSetupConfSelectSerialBulkBadCrc (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS    Status;
+  EFI_KEY_DATA  KeyData1;
+
+  will_return (IsSystemInManufacturingMode, TRUE);
+  will_return (MockClearScreen, EFI_SUCCESS);
+  will_return_always (MockSetAttribute, EFI_SUCCESS);
+
+  expect_memory (MockLocateProtocol, Protocol, &gPolicyProtocolGuid, sizeof (EFI_GUID));
+  will_return (MockLocateProtocol, &mMockedPolicy);
+
+  // Expect the prints twice
+  expect_any (MockSetCursorPosition, Column);
+  expect_any (MockSetCursorPosition, Row);
+  will_return (MockSetCursorPosition, EFI_SUCCESS);
+
+  // Initial run
+  Status = SetupConfMgr ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mSetupConfState, SetupConfWait);
+
+  mSimpleTextInEx = &MockSimpleInput;
+
+  KeyData1.Key.UnicodeChar = '2';
+  KeyData1.Key.ScanCode    = SCAN_NULL;
+  will_return (MockReadKey, &KeyData1);
+
+  Status = SetupConfMgr ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mSetupConfState, SetupConfUpdateSerialHint);
+
+  // Start the bulk transfer
+  KeyData1.Key.UnicodeChar = SVD_SERIAL_BULK_START;
+  KeyData1.Key.ScanCode    = SCAN_NULL;
+  will_return (MockReadKey, &KeyData1);
+
+  ExpectConsoleSerialIo ();
+  SetSerialBulkFrame (KNOWN_GOOD_VARLIST_XML, sizeof (KNOWN_GOOD_VARLIST_XML) - 1, BIT0);
+
+  // The terminal is given the port back
+  expect_value (MockConnectController, ControllerHandle, MOCK_SERIAL_HANDLE);
+
+  // Nothing may be written from a corrupted payload
+  Status = SetupConfMgr ();
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_CRC_ERROR);
+  UT_ASSERT_EQUAL (mSetupConfState, SetupConfExit);
+  UT_ASSERT_EQUAL (mSerialDataOffset, mSerialDataSize);
+
+  UT_ASSERT_EQUAL (mSerialWrittenSize, 2 * sizeof (UINT32));
+  UT_ASSERT_EQUAL (ReadUnaligned32 ((UINT32 *)mSerialWritten), SVD_SERIAL_BULK_READY);
+  UT_ASSERT_EQUAL (ReadUnaligned32 ((UINT32 *)(mSerialWritten + sizeof (UINT32))), SVD_SERIAL_BULK_NAK);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for SetupConf page when a binary settings packet sent over serial is not signed by the trusted certificate.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfAppSetupConfSelectSerialBulkUntrustedBinary (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS    Status;
+  EFI_KEY_DATA  KeyData1;
+  UINT8         Packet[KNOWN_GOOD_BINARY_PACKET_SIZE];
+
+  BuildKnownGoodBinaryPacket (Packet);
+
+  will_return (IsSystemInManufacturingMode, TRUE);
+  will_return (MockClearScreen, EFI_SUCCESS);
+  will_return_always (MockSetAttribute, EFI_SUCCESS);
+
+  expect_memory (MockLocateProtocol, Protocol, &gPolicyProtocolGuid, sizeof (EFI_GUID));
+  will_return (MockLocateProtocol, &mMockedPolicy);
+
+  // Expect the prints twice
+  expect_any (MockSetCursorPosition, Column);
+  expect_any (MockSetCursorPosition, Row);
+  will_return (MockSetCursorPosition, EFI_SUCCESS);
+
+  // Initial run
+  Status = SetupConfMgr ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mSetupConfState, SetupConfWait);
+
+  mSimpleTextInEx = &MockSimpleInput;
+
+  KeyData1.Key.UnicodeChar = '2';
+  KeyData1.Key.ScanCode    = SCAN_NULL;
+  will_return (MockReadKey, &KeyData1);
+
+  Status = SetupConfMgr ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mSetupConfState, SetupConfUpdateSerialHint);
+
+  // Start the bulk transfer
+  KeyData1.Key.UnicodeChar = SVD_SERIAL_BULK_START;
+  KeyData1.Key.ScanCode    = SCAN_NULL;
+  will_return (MockReadKey, &KeyData1);
+
+  ExpectConsoleSerialIo ();
+  SetSerialBulkFrame (Packet, sizeof (Packet), 0);
+
+  // The frame and payload CRC32s are intact, only the signature fails
+  will_return (Pkcs7Verify, FALSE);
+
+  // The terminal is given the port back
+  expect_value (MockConnectController, ControllerHandle, MOCK_SERIAL_HANDLE);
+
+  // Nothing may be written from an untrusted packet
+  Status = SetupConfMgr ();
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_SECURITY_VIOLATION);
+  UT_ASSERT_EQUAL (mSetupConfState, SetupConfExit);
+  UT_ASSERT_EQUAL (mSerialDataOffset, mSerialDataSize);
+
+  UT_ASSERT_EQUAL (mSerialWrittenSize, 2 * sizeof (UINT32));
+  UT_ASSERT_EQUAL (ReadUnaligned32 ((UINT32 *)mSerialWritten), SVD_SERIAL_BULK_READY);
+  UT_ASSERT_EQUAL (ReadUnaligned32 ((UINT32 *)(mSerialWritten + sizeof (UINT32))), SVD_SERIAL_BULK_NAK);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for SetupConf page when selecting configure from serial and return in the middle.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfAppSetupConfSelectSerialEsc (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS    Status;
+  EFI_KEY_DATA  KeyData1;
+  UINTN         Index;
+  CHAR8         *KnowGoodXml;
+
+  will_return (IsSystemInManufacturingMode, TRUE);
+  will_return (MockClearScreen, EFI_SUCCESS);
+  will_return_always (MockSetAttribute, EFI_SUCCESS);
+
+  expect_memory (MockLocateProtocol, Protocol, &gPolicyProtocolGuid, sizeof (EFI_GUID));
+  will_return (MockLocateProtocol, &mMockedPolicy);
+
+  // Expect the prints twice
+  expect_any (MockSetCursorPosition, Column);
+  expect_any (MockSetCursorPosition, Row);
+  will_return (MockSetCursorPosition, EFI_SUCCESS);
+
+  // Initial run
+  Status = SetupConfMgr ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mSetupConfState, SetupConfWait);
+
+  mSimpleTextInEx = &MockSimpleInput;
+
+  KeyData1.Key.UnicodeChar = '2';
+  KeyData1.Key.ScanCode    = SCAN_NULL;
+  will_return (MockReadKey, &KeyData1);
+
+  Status = SetupConfMgr ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mSetupConfState, SetupConfUpdateSerialHint);
+
+  Index       = 0;
+  KnowGoodXml = KNOWN_GOOD_VARLIST_XML;
+  while (KnowGoodXml[Index] != 0) {
+    KeyData1.Key.UnicodeChar = KnowGoodXml[Index];
+    KeyData1.Key.ScanCode    = SCAN_NULL;
+    will_return (MockReadKey, &KeyData1);
+    Status = SetupConfMgr ();
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_EQUAL (mSetupConfState, SetupConfUpdateSerial);
+    Index++;
+  }
+
+  KeyData1.Key.UnicodeChar = CHAR_NULL;
+  KeyData1.Key.ScanCode    = SCAN_ESC;
+  will_return (MockReadKey, &KeyData1);
+
+  Status = SetupConfMgr ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mSetupConfState, SetupConfExit);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for SetupConf page when selecting dumping configure from serial.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
                          1) test-case reuse with varied parameters and
                          2) test-case re-entry for Target tests that need a
                          reboot.  This parameter is a VOID* and it is the
@@ -989,6 +1927,215 @@ ConfAppSetupConfDumpSerial (
   return UNIT_TEST_PASSED;
 }
 
+/**
+  Unit test for dumping current settings again after they changed, so cached settings must be re-encoded.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfAppSetupConfDumpCached (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS             Status;
+  CONFIG_VAR_LIST_ENTRY  Entry;
+  VOID                   *Buffer;
+  UINTN                  BufferSize = 0;
+  UINTN                  Offset;
+  UINTN                  SizeLeft;
+  UINT32                 TmpSize;
+  CHAR8                  *XmlString;
+  UINTN                  XmlStringSize;
+  UINTN                  Index;
+  UINTN                  Knobs[] = { 2, 5 };
+
+  for (Index = 0; Index < ARRAY_SIZE (Knobs); Index++) {
+    Status = GetVarListSize ((UINT32)StrSize (mKnown_Good_VarList_Names[Knobs[Index]]), (UINT32)mKnown_Good_VarList_DataSizes[Knobs[Index]], &TmpSize);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    BufferSize += (UINTN)TmpSize;
+  }
+
+  Buffer = AllocatePool (BufferSize);
+  UT_ASSERT_NOT_NULL (Buffer);
+
+  // Populate COMPLEX_KNOB1a and INTEGER_KNOB
+  Offset = 0;
+  for (Index = 0; Index < ARRAY_SIZE (Knobs); Index++) {
+    Entry.Name       = mKnown_Good_VarList_Names[Knobs[Index]];
+    Entry.Guid       = mKnown_Good_Xml_Guid;
+    Entry.Data       = mKnown_Good_VarList_Entries[Knobs[Index]];
+    Entry.DataSize   = mKnown_Good_VarList_DataSizes[Knobs[Index]];
+    Entry.Attributes = VARIABLE_ATTRIBUTE_BS_RT;
+
+    SizeLeft = BufferSize - Offset;
+    Status   = ConvertVariableEntryToVariableList (&Entry, (UINT8 *)Buffer + Offset, &SizeLeft);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    Offset += SizeLeft;
+  }
+
+  mPolicyProtocol = &mMockedPolicy;
+
+  // Dump the two knobs, everything else, then the two knobs again
+  expect_memory_count (MockGetPolicy, PolicyGuid, &gZeroGuid, sizeof (EFI_GUID), 2);
+  will_return_count (MockGetPolicy, BufferSize, 2);
+  will_return (MockGetPolicy, Buffer);
+
+  Status = CreateXmlStringFromCurrentSettings (&XmlString, &XmlStringSize);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (XmlStringSize, sizeof (KNOWN_GOOD_VARLIST_SVD));
+  UT_ASSERT_MEM_EQUAL (XmlString, KNOWN_GOOD_VARLIST_SVD, sizeof (KNOWN_GOOD_VARLIST_SVD));
+  FreePool (XmlString);
+
+  // The policy is not retrieved again until it is invalidated
+  Status = CreateXmlStringFromCurrentSettings (&XmlString, &XmlStringSize);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (XmlStringSize, sizeof (KNOWN_GOOD_VARLIST_SVD));
+  UT_ASSERT_MEM_EQUAL (XmlString, KNOWN_GOOD_VARLIST_SVD, sizeof (KNOWN_GOOD_VARLIST_SVD));
+  FreePool (XmlString);
+
+  InvalidateConfAppState (CONF_APP_STATE_POLICY);
+  expect_memory_count (MockGetPolicy, PolicyGuid, &gZeroGuid, sizeof (EFI_GUID), 2);
+  will_return_count (MockGetPolicy, sizeof (mKnown_Good_Generic_Profile), 2);
+  will_return (MockGetPolicy, mKnown_Good_Generic_Profile);
+
+  Status = CreateXmlStringFromCurrentSettings (&XmlString, &XmlStringSize);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_NOT_EQUAL (XmlStringSize, sizeof (KNOWN_GOOD_VARLIST_SVD));
+  FreePool (XmlString);
+
+  InvalidateConfAppState (CONF_APP_STATE_POLICY);
+  expect_memory_count (MockGetPolicy, PolicyGuid, &gZeroGuid, sizeof (EFI_GUID), 2);
+  will_return_count (MockGetPolicy, BufferSize, 2);
+  will_return (MockGetPolicy, Buffer);
+
+  Status = CreateXmlStringFromCurrentSettings (&XmlString, &XmlStringSize);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (XmlStringSize, sizeof (KNOWN_GOOD_VARLIST_SVD));
+  UT_ASSERT_MEM_EQUAL (XmlString, KNOWN_GOOD_VARLIST_SVD, sizeof (KNOWN_GOOD_VARLIST_SVD));
+  FreePool (XmlString);
+
+  FreePool (Buffer);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for dumping current settings from a configuration policy in the aligned variable list format.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfAppSetupConfDumpAligned (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS                     Status;
+  CONFIG_VAR_LIST_ALIGNED_HDR    *Hdr;
+  CONFIG_VAR_LIST_ALIGNED_ENTRY  *Entry;
+  UINT8                          *Buffer;
+  UINTN                          BufferSize;
+  UINT32                         NamesSize = 0;
+  UINT32                         DataSize  = 0;
+  UINT32                         NamesOffset;
+  UINT32                         DataOffset;
+  CHAR8                          *XmlString;
+  UINTN                          XmlStringSize;
+  UINTN                          Index;
+  UINTN                          Knobs[] = { 2, 5 };
+
+  // Lay out COMPLEX_KNOB1a and INTEGER_KNOB as an aligned variable list
+  for (Index = 0; Index < ARRAY_SIZE (Knobs); Index++) {
+    NamesSize += (UINT32)StrSize (mKnown_Good_VarList_Names[Knobs[Index]]);
+    DataSize   = ALIGN_VALUE (DataSize, CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT) + (UINT32)mKnown_Good_VarList_DataSizes[Knobs[Index]];
+  }
+
+  NamesOffset = sizeof (CONFIG_VAR_LIST_ALIGNED_HDR) + ARRAY_SIZE (Knobs) * sizeof (CONFIG_VAR_LIST_ALIGNED_ENTRY);
+  DataOffset  = ALIGN_VALUE (NamesOffset + NamesSize, CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT);
+  BufferSize  = DataOffset + DataSize;
+  Buffer      = AllocateZeroPool (BufferSize);
+  UT_ASSERT_NOT_NULL (Buffer);
+
+  Hdr              = (CONFIG_VAR_LIST_ALIGNED_HDR *)Buffer;
+  Hdr->Signature   = CONFIG_VAR_LIST_ALIGNED_SIGNATURE;
+  Hdr->Version     = CONFIG_VAR_LIST_ALIGNED_VERSION;
+  Hdr->HeaderSize  = sizeof (CONFIG_VAR_LIST_ALIGNED_HDR);
+  Hdr->EntryCount  = ARRAY_SIZE (Knobs);
+  Hdr->NamesOffset = NamesOffset;
+  Hdr->NamesSize   = NamesSize;
+  Hdr->DataOffset  = DataOffset;
+  Hdr->DataSize    = DataSize;
+
+  Entry     = (CONFIG_VAR_LIST_ALIGNED_ENTRY *)(Hdr + 1);
+  NamesSize = 0;
+  DataSize  = 0;
+  for (Index = 0; Index < ARRAY_SIZE (Knobs); Index++, Entry++) {
+    DataSize = ALIGN_VALUE (DataSize, CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT);
+
+    CopyMem (&Entry->Guid, &mKnown_Good_Xml_Guid, sizeof (EFI_GUID));
+    Entry->Attributes = VARIABLE_ATTRIBUTE_BS_RT;
+    Entry->NameOffset = NamesSize;
+    Entry->NameSize   = (UINT32)StrSize (mKnown_Good_VarList_Names[Knobs[Index]]);
+    Entry->DataOffset = DataSize;
+    Entry->DataSize   = (UINT32)mKnown_Good_VarList_DataSizes[Knobs[Index]];
+    CopyMem (Buffer + NamesOffset + NamesSize, mKnown_Good_VarList_Names[Knobs[Index]], Entry->NameSize);
+    CopyMem (Buffer + DataOffset + DataSize, mKnown_Good_VarList_Entries[Knobs[Index]], Entry->DataSize);
+
+    NamesSize += Entry->NameSize;
+    DataSize  += Entry->DataSize;
+  }
+
+  Hdr->Crc32 = ConfigCalculateCrc32 (Buffer + Hdr->HeaderSize, BufferSize - Hdr->HeaderSize);
+
+  mPolicyProtocol = &mMockedPolicy;
+
+  // The aligned policy dumps the same settings as the packed one
+  expect_memory_count (MockGetPolicy, PolicyGuid, &gZeroGuid, sizeof (EFI_GUID), 2);
+  will_return_count (MockGetPolicy, BufferSize, 2);
+  will_return (MockGetPolicy, Buffer);
+
+  Status = CreateXmlStringFromCurrentSettings (&XmlString, &XmlStringSize);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (XmlStringSize, sizeof (KNOWN_GOOD_VARLIST_SVD));
+  UT_ASSERT_MEM_EQUAL (XmlString, KNOWN_GOOD_VARLIST_SVD, sizeof (KNOWN_GOOD_VARLIST_SVD));
+  FreePool (XmlString);
+
+  // A corrupted aligned policy fails the dump rather than being partially walked
+  InvalidateConfAppState (CONF_APP_STATE_POLICY);
+  Buffer[BufferSize - 1] ^= 0xFF;
+  expect_memory_count (MockGetPolicy, PolicyGuid, &gZeroGuid, sizeof (EFI_GUID), 2);
+  will_return_count (MockGetPolicy, BufferSize, 2);
+  will_return (MockGetPolicy, Buffer);
+
+  Status = CreateXmlStringFromCurrentSettings (&XmlString, &XmlStringSize);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+
+  FreePool (Buffer);
+
+  return UNIT_TEST_PASSED;
+}
+
 /**
   Unit test for SetupConf page when selecting update configuration at non-mfg mode.
 
@@ -1103,7 +2250,8 @@ UnitTestingEntry (
     goto EXIT;
   }
 
-  MockRuntime.GetTime = MockGetTime;
+  MockRuntime.GetTime     = MockGetTime;
+  MockRuntime.GetVariable = MockGetSvdVariable;
 
   //
   // --------------Suite-----------Description--------------Name----------Function--------Pre---Post-------------------Context-----------
@@ -1112,10 +2260,17 @@ UnitTestingEntry (
   AddTestCase (MiscTests, "Setup Configuration page select Esc should go to previous menu", "SelectEsc", ConfAppSetupConfSelectEsc, NULL, SetupConfCleanup, NULL);
   AddTestCase (MiscTests, "Setup Configuration page select others should do nothing", "SelectOther", ConfAppSetupConfSelectOther, NULL, SetupConfCleanup, NULL);
   AddTestCase (MiscTests, "Setup Configuration page should setup configuration from USB", "SelectUsb", ConfAppSetupConfSelectUsb, NULL, SetupConfCleanup, NULL);
+  AddTestCase (MiscTests, "Setup Configuration page should only write changed configuration from USB", "SelectUsbStored", ConfAppSetupConfSelectUsbStored, NULL, SetupConfCleanup, NULL);
+  AddTestCase (MiscTests, "Setup Configuration page should setup configuration from a binary packet on USB", "SelectUsbBinary", ConfAppSetupConfSelectUsbBinary, NULL, SetupConfCleanup, NULL);
   AddTestCase (MiscTests, "Setup Configuration page should setup configuration from serial", "SelectSerialWithArbitrarySVD", ConfAppSetupConfSelectSerialWithArbitrarySVD, NULL, SetupConfCleanup, NULL);
+  AddTestCase (MiscTests, "Setup Configuration page should setup configuration from serial bulk transfer", "SelectSerialBulk", ConfAppSetupConfSelectSerialBulk, NULL, SetupConfCleanup, NULL);
+  AddTestCase (MiscTests, "Setup Configuration page should reject corrupted serial bulk transfer", "SelectSerialBulkBadCrc", ConfAppSetupConfSelectSerialBulkBadCrc, NULL, SetupConfCleanup, NULL);
+  AddTestCase (MiscTests, "Setup Configuration page should reject untrusted binary packet from serial bulk transfer", "SelectSerialBulkUntrustedBinary", ConfAppSetupConfSelectSerialBulkUntrustedBinary, NULL, SetupConfCleanup, NULL);
   AddTestCase (MiscTests, "Setup Configuration page should return with ESC key during serial transport", "SelectSerial", ConfAppSetupConfSelectSerialEsc, NULL, SetupConfCleanup, NULL);
   AddTestCase (MiscTests, "Setup Configuration page should dump 2 configurations from serial", "ConfDumpMini", ConfAppSetupConfDumpSerialMini, NULL, SetupConfCleanup, NULL);
   AddTestCase (MiscTests, "Setup Configuration page should dump all configurations from serial", "ConfDump", ConfAppSetupConfDumpSerial, NULL, SetupConfCleanup, NULL);
+  AddTestCase (MiscTests, "Setup Configuration dump should follow changed configurations", "ConfDumpCached", ConfAppSetupConfDumpCached, NULL, SetupConfCleanup, NULL);
+  AddTestCase (MiscTests, "Setup Configuration dump should read aligned configurations", "ConfDumpAligned", ConfAppSetupConfDumpAligned, NULL, SetupConfCleanup, NULL);
   AddTestCase (MiscTests, "Setup Configuration page should ignore updating configurations when in non-mfg mode", "ConfNonMfg", ConfAppSetupConfNonMfg, NULL, SetupConfCleanup, NULL);
 
   //
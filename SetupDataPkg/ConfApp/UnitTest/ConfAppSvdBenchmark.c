@@ -0,0 +1,1166 @@
+/** @file
+  Host based benchmark of the ConfApp SVD apply and dump paths.
+
+  Synthetic settings packets of 8 to 4,096 knobs are applied through ApplySettings, both as XML and as binary
+  packets, and then dumped back through CreateXmlStringFromCurrentSettings. The runtime services and the policy
+  protocol are replaced by in memory versions that count their calls. Results are written to stdout as CSV, one
+  line per operation and knob count, so that runs can be compared against each other:
+
+    Operation,KnobCount,PacketSize,Iterations,NsPerOp,AllocationsPerOp,PeakPoolBytes,SetVariablePerOp,
+    GetVariablePerOp,GetPolicyPerOp
+
+  PeakPoolBytes is the largest pool usage reached above the usage before the operation. The pool allocation
+  routines used by ConfApp are redirected to this file by the INF build options, so only the allocations made by
+  the ConfApp sources are counted, not the ones made within the libraries it links.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <Uefi.h>
+#include <Protocol/Policy.h>
+#include <Guid/WinCertificate.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PrintLib.h>
+#include <Library/ConfigVariableListLib.h>
+#include <Library/ConfigBase64Lib.h>
+#include <Library/ConfigCrcLib.h>
+#include <Library/BaseCryptLib.h>
+
+#include "ConfApp.h"
+
+#define BENCHMARK_NAME_PREFIX_LEN  10
+#define BENCHMARK_MAX_NAME_LEN     24
+#define BENCHMARK_MAX_DATA_SIZE    16
+
+// Each operation processes about this many knobs in total, whatever the packet size
+#define BENCHMARK_KNOBS_PER_OPERATION  16384
+
+// Slots of the in memory variable store, at least twice the largest knob count
+#define BENCHMARK_VARIABLE_SLOTS  8192
+
+#define BENCHMARK_XML_PREFIX                                                                          \
+  "<?xml version=\"1.0\" encoding=\"utf-8\"?><SettingsPacket xmlns=\"urn:UefiSettings-Schema\">"     \
+  "<CreatedBy>ConfApp Benchmark</CreatedBy><CreatedOn>2022-12-07 14:21</CreatedOn><Version>1</Version>" \
+  "<LowestSupportedVersion>1</LowestSupportedVersion><Settings>"
+#define BENCHMARK_XML_SETTING_OPEN   "<Setting><Id>"
+#define BENCHMARK_XML_SETTING_VALUE  "</Id><Value>"
+#define BENCHMARK_XML_SETTING_CLOSE  "</Value></Setting>"
+#define BENCHMARK_XML_SUFFIX         "</Settings></SettingsPacket>"
+
+// Size of the stand in signature of the binary packets, which are taken as signed without any verification
+#define BENCHMARK_SIGNATURE_SIZE  1024
+
+EFI_STATUS
+ApplySettings (
+  IN  CHAR8  *Buffer,
+  IN  UINTN  Count
+  );
+
+EFI_STATUS
+EFIAPI
+CreateXmlStringFromCurrentSettings (
+  OUT CHAR8  **XmlString,
+  OUT UINTN  *StringSize
+  );
+
+extern POLICY_PROTOCOL  *mPolicyProtocol;
+
+STATIC CONST UINTN  mKnobCounts[] = { 8, 64, 512, 4096 };
+
+typedef struct {
+  UINT64    Allocations;
+  UINT64    SetVariableCalls;
+  UINT64    GetVariableCalls;
+  UINT64    GetPolicyCalls;
+} BENCHMARK_COUNTERS;
+
+typedef struct {
+  CHAR16      *Name;                    // NULL for a free slot
+  EFI_GUID    Guid;
+  UINT32      Attributes;
+  UINTN       DataSize;                 // 0 once the variable is deleted, the slot is kept for the name
+  VOID        *Data;
+} BENCHMARK_VARIABLE;
+
+// Pool allocations are preceded by their size, so the pool usage can be tracked as they are freed
+typedef struct {
+  UINT64    Size;
+  UINT64    Reserved;
+} BENCHMARK_POOL_HEADER;
+
+STATIC BENCHMARK_COUNTERS  mCounters;
+STATIC UINT64              mPoolInUse;
+STATIC UINT64              mPoolPeak;
+STATIC UINT32              mRandomState;
+STATIC BENCHMARK_VARIABLE  mVariables[BENCHMARK_VARIABLE_SLOTS];
+
+// The synthetic packet, serialized once per knob count
+STATIC UINT8  *mVarList;
+STATIC UINTN  *mEntryOffsets;         // Offset of each entry in mVarList, then the size of mVarList
+STATIC UINTN  mEntryCount;
+
+/**
+  Allocate a pool buffer for ConfApp, counting it and its size.
+
+  @param[in]  AllocationSize  The number of bytes to allocate.
+  @param[in]  Zero            Whether to zero the buffer.
+
+  @return A pointer to the allocated buffer or NULL if allocation fails.
+**/
+STATIC
+VOID *
+BenchmarkAllocate (
+  IN UINTN    AllocationSize,
+  IN BOOLEAN  Zero
+  )
+{
+  BENCHMARK_POOL_HEADER  *Header;
+
+  Header = Zero ? calloc (1, sizeof (*Header) + AllocationSize) : malloc (sizeof (*Header) + AllocationSize);
+  if (Header == NULL) {
+    return NULL;
+  }
+
+  Header->Size = AllocationSize;
+  mCounters.Allocations++;
+  mPoolInUse += AllocationSize;
+  mPoolPeak   = MAX (mPoolPeak, mPoolInUse);
+  return Header + 1;
+}
+
+/**
+  Count and perform a pool allocation for ConfApp.
+
+  @param[in]  AllocationSize  The number of bytes to allocate.
+
+  @return A pointer to the allocated buffer or NULL if allocation fails.
+**/
+VOID *
+EFIAPI
+BenchmarkAllocatePool (
+  IN UINTN  AllocationSize
+  )
+{
+  return BenchmarkAllocate (AllocationSize, FALSE);
+}
+
+/**
+  Count and perform a zeroed pool allocation for ConfApp.
+
+  @param[in]  AllocationSize  The number of bytes to allocate and zero.
+
+  @return A pointer to the allocated buffer or NULL if allocation fails.
+**/
+VOID *
+EFIAPI
+BenchmarkAllocateZeroPool (
+  IN UINTN  AllocationSize
+  )
+{
+  return BenchmarkAllocate (AllocationSize, TRUE);
+}
+
+/**
+  Free a pool allocation made by one of the benchmark allocation routines.
+
+  @param[in]  Buffer        The pointer to the buffer to free.
+**/
+VOID
+EFIAPI
+BenchmarkFreePool (
+  IN VOID  *Buffer
+  )
+{
+  BENCHMARK_POOL_HEADER  *Header;
+
+  if (Buffer != NULL) {
+    Header      = (BENCHMARK_POOL_HEADER *)Buffer - 1;
+    mPoolInUse -= Header->Size;
+    free (Header);
+  }
+}
+
+/**
+  Count and perform a pool allocation holding a copy of a buffer for ConfApp.
+
+  @param[in]  AllocationSize  The number of bytes to allocate and copy.
+  @param[in]  Buffer          The buffer to copy.
+
+  @return A pointer to the allocated buffer or NULL if allocation fails.
+**/
+VOID *
+EFIAPI
+BenchmarkAllocateCopyPool (
+  IN UINTN       AllocationSize,
+  IN CONST VOID  *Buffer
+  )
+{
+  VOID  *Copy;
+
+  Copy = BenchmarkAllocate (AllocationSize, FALSE);
+  if (Copy != NULL) {
+    CopyMem (Copy, Buffer, AllocationSize);
+  }
+
+  return Copy;
+}
+
+/**
+  Count and perform a pool reallocation for ConfApp.
+
+  @param[in]  OldSize       The size, in bytes, of OldBuffer.
+  @param[in]  NewSize       The size, in bytes, of the buffer to reallocate.
+  @param[in]  OldBuffer     The buffer to copy to the allocated buffer, may be NULL.
+
+  @return A pointer to the allocated buffer or NULL if allocation fails.
+**/
+VOID *
+EFIAPI
+BenchmarkReallocatePool (
+  IN UINTN  OldSize,
+  IN UINTN  NewSize,
+  IN VOID   *OldBuffer  OPTIONAL
+  )
+{
+  VOID  *NewBuffer;
+
+  NewBuffer = BenchmarkAllocate (NewSize, TRUE);
+  if ((NewBuffer != NULL) && (OldBuffer != NULL)) {
+    CopyMem (NewBuffer, OldBuffer, MIN (OldSize, NewSize));
+    BenchmarkFreePool (OldBuffer);
+  }
+
+  return NewBuffer;
+}
+
+/**
+  Return the next value of a fixed seed pseudo random sequence, so every run uses the same packets.
+
+  @return The next pseudo random value.
+**/
+STATIC
+UINT32
+BenchmarkRandom (
+  VOID
+  )
+{
+  mRandomState = mRandomState * 1103515245 + 12345;
+  return mRandomState >> 8;
+}
+
+/**
+  Return a monotonic timestamp in nanoseconds.
+
+  @return The current timestamp.
+**/
+STATIC
+UINT64
+BenchmarkNow (
+  VOID
+  )
+{
+  struct timespec  Now;
+
+  timespec_get (&Now, TIME_UTC);
+  return (UINT64)Now.tv_sec * 1000000000ULL + (UINT64)Now.tv_nsec;
+}
+
+/**
+  Find the slot of a variable in the in memory variable store.
+
+  @param[in]  VariableName  Name of the variable.
+  @param[in]  VendorGuid    Namespace of the variable.
+
+  @return The slot holding the variable, or the free slot it is to be stored in.
+**/
+STATIC
+BENCHMARK_VARIABLE *
+FindVariableSlot (
+  IN CONST CHAR16    *VariableName,
+  IN CONST EFI_GUID  *VendorGuid
+  )
+{
+  UINT32        Hash;
+  CONST CHAR16  *Char;
+  UINTN         Slot;
+
+  // FNV-1a over the name and the first GUID field, the rest of the GUID only matters on a name match
+  Hash = 2166136261u ^ VendorGuid->Data1;
+  for (Char = VariableName; *Char != L'\0'; Char++) {
+    Hash = (Hash ^ *Char) * 16777619u;
+  }
+
+  for (Slot = Hash % BENCHMARK_VARIABLE_SLOTS; ; Slot = (Slot + 1) % BENCHMARK_VARIABLE_SLOTS) {
+    if ((mVariables[Slot].Name == NULL) ||
+        ((StrCmp (mVariables[Slot].Name, VariableName) == 0) && CompareGuid (&mVariables[Slot].Guid, VendorGuid)))
+    {
+      return &mVariables[Slot];
+    }
+  }
+}
+
+/**
+  Empty the in memory variable store.
+**/
+STATIC
+VOID
+ClearVariables (
+  VOID
+  )
+{
+  UINTN  Slot;
+
+  for (Slot = 0; Slot < BENCHMARK_VARIABLE_SLOTS; Slot++) {
+    free (mVariables[Slot].Name);
+    free (mVariables[Slot].Data);
+  }
+
+  ZeroMem (mVariables, sizeof (mVariables));
+}
+
+/**
+  Count the variables of the in memory variable store.
+
+  @return The number of variables that are set.
+**/
+STATIC
+UINTN
+CountVariables (
+  VOID
+  )
+{
+  UINTN  Slot;
+  UINTN  Count;
+
+  Count = 0;
+  for (Slot = 0; Slot < BENCHMARK_VARIABLE_SLOTS; Slot++) {
+    if ((mVariables[Slot].Name != NULL) && (mVariables[Slot].DataSize != 0)) {
+      Count++;
+    }
+  }
+
+  return Count;
+}
+
+/**
+  Counting version of GetVariable, over the in memory variable store.
+
+  @param[in]       VariableName  A Null-terminated string that is the name of the vendor's variable.
+  @param[in]       VendorGuid    A unique identifier for the vendor.
+  @param[out]      Attributes    If not NULL, a pointer to the memory location to return the
+                                 attributes bitmask for the variable.
+  @param[in, out]  DataSize      On input, the size in bytes of the return Data buffer.
+                                 On output the size of data returned in Data.
+  @param[out]      Data          The buffer to return the contents of the variable.
+
+  @retval EFI_SUCCESS            The function completed successfully.
+  @retval EFI_NOT_FOUND          The variable was not found.
+  @retval EFI_BUFFER_TOO_SMALL   The DataSize is too small for the result.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+BenchmarkGetVariable (
+  IN     CHAR16    *VariableName,
+  IN     EFI_GUID  *VendorGuid,
+  OUT    UINT32    *Attributes     OPTIONAL,
+  IN OUT UINTN     *DataSize,
+  OUT    VOID      *Data           OPTIONAL
+  )
+{
+  BENCHMARK_VARIABLE  *Variable;
+
+  mCounters.GetVariableCalls++;
+  Variable = FindVariableSlot (VariableName, VendorGuid);
+  if ((Variable->Name == NULL) || (Variable->DataSize == 0)) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (Attributes != NULL) {
+    *Attributes = Variable->Attributes;
+  }
+
+  if (*DataSize < Variable->DataSize) {
+    *DataSize = Variable->DataSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  *DataSize = Variable->DataSize;
+  CopyMem (Data, Variable->Data, Variable->DataSize);
+  return EFI_SUCCESS;
+}
+
+/**
+  Counting version of SetVariable, over the in memory variable store.
+
+  @param[in]  VariableName       A Null-terminated string that is the name of the vendor's variable.
+  @param[in]  VendorGuid         A unique identifier for the vendor.
+  @param[in]  Attributes         Attributes bitmask to set for the variable.
+  @param[in]  DataSize           The size in bytes of the Data buffer, 0 to delete the variable.
+  @param[in]  Data               The contents for the variable.
+
+  @retval EFI_SUCCESS            The variable was stored.
+  @retval EFI_NOT_FOUND          The variable to delete was not found.
+  @retval EFI_OUT_OF_RESOURCES   Not enough memory to hold the variable.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+BenchmarkSetVariable (
+  IN  CHAR16    *VariableName,
+  IN  EFI_GUID  *VendorGuid,
+  IN  UINT32    Attributes,
+  IN  UINTN     DataSize,
+  IN  VOID      *Data
+  )
+{
+  BENCHMARK_VARIABLE  *Variable;
+
+  mCounters.SetVariableCalls++;
+  Variable = FindVariableSlot (VariableName, VendorGuid);
+  if (DataSize == 0) {
+    if ((Variable->Name == NULL) || (Variable->DataSize == 0)) {
+      return EFI_NOT_FOUND;
+    }
+
+    free (Variable->Data);
+    Variable->Data     = NULL;
+    Variable->DataSize = 0;
+    return EFI_SUCCESS;
+  }
+
+  if (Variable->Name == NULL) {
+    Variable->Name = malloc (StrSize (VariableName));
+    if (Variable->Name == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    CopyMem (Variable->Name, VariableName, StrSize (VariableName));
+    CopyGuid (&Variable->Guid, VendorGuid);
+  }
+
+  free (Variable->Data);
+  Variable->Data = malloc (DataSize);
+  if (Variable->Data == NULL) {
+    Variable->DataSize = 0;
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  CopyMem (Variable->Data, Data, DataSize);
+  Variable->DataSize   = DataSize;
+  Variable->Attributes = Attributes;
+  return EFI_SUCCESS;
+}
+
+/**
+  Fixed version of GetTime.
+
+  @param[out]  Time             A pointer to storage to receive a snapshot of the current time.
+  @param[out]  Capabilities     An optional pointer to a buffer to receive the real time clock
+                                device's capabilities.
+
+  @retval EFI_SUCCESS           The operation completed successfully.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+BenchmarkGetTime (
+  OUT  EFI_TIME               *Time,
+  OUT  EFI_TIME_CAPABILITIES  *Capabilities OPTIONAL
+  )
+{
+  ZeroMem (Time, sizeof (EFI_TIME));
+  Time->Year  = 2022;
+  Time->Month = 4;
+  Time->Day   = 29;
+  return EFI_SUCCESS;
+}
+
+/**
+  Counting version of GetPolicy, handing the entries of the synthetic packet out evenly over the policies of
+  PcdConfigurationPolicyGuid.
+
+  @param[in]      PolicyGuid        The GUID of the policy being retrieved.
+  @param[out]     Attributes        The attributes of the stored policy.
+  @param[out]     Policy            The buffer where the policy data is copied.
+  @param[in,out]  PolicySize        The size of the stored policy data buffer.
+                                    On output, contains the size of the stored policy.
+
+  @retval   EFI_SUCCESS           The policy was retrieved.
+  @retval   EFI_BUFFER_TOO_SMALL  The provided buffer size was too small.
+  @retval   EFI_NOT_FOUND         The policy does not exist.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+BenchmarkGetPolicy (
+  IN CONST EFI_GUID  *PolicyGuid,
+  OUT UINT64         *Attributes OPTIONAL,
+  OUT VOID           *Policy,
+  IN OUT UINT16      *PolicySize
+  )
+{
+  CONST EFI_GUID  *TargetGuids;
+  UINTN           PolicyCount;
+  UINTN           Index;
+  UINTN           Start;
+  UINTN           Size;
+
+  mCounters.GetPolicyCalls++;
+  TargetGuids = (CONST EFI_GUID *)PcdGetPtr (PcdConfigurationPolicyGuid);
+  PolicyCount = PcdGetSize (PcdConfigurationPolicyGuid) / sizeof (EFI_GUID);
+  for (Index = 0; Index < PolicyCount; Index++) {
+    if (CompareGuid (&TargetGuids[Index], PolicyGuid)) {
+      break;
+    }
+  }
+
+  if (Index == PolicyCount) {
+    return EFI_NOT_FOUND;
+  }
+
+  Start = mEntryOffsets[Index * mEntryCount / PolicyCount];
+  Size  = mEntryOffsets[(Index + 1) * mEntryCount / PolicyCount] - Start;
+  if (*PolicySize < Size) {
+    *PolicySize = (UINT16)Size;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  *PolicySize = (UINT16)Size;
+  CopyMem (Policy, mVarList + Start, Size);
+  return EFI_SUCCESS;
+}
+
+///
+/// Runtime services of the benchmark, for MockUefiRuntimeServicesTableLib
+///
+EFI_RUNTIME_SERVICES  MockRuntime = {
+  .GetVariable = BenchmarkGetVariable,
+  .SetVariable = BenchmarkSetVariable,
+  .GetTime     = BenchmarkGetTime
+};
+
+///
+/// Boot services and system table of the benchmark, for MockUefiBootServicesTableLib. Unused by the
+/// benchmarked paths.
+///
+EFI_BOOT_SERVICES  MockBoot;
+EFI_SYSTEM_TABLE   MockSys;
+
+STATIC POLICY_PROTOCOL  mBenchmarkPolicy = {
+  .GetPolicy = BenchmarkGetPolicy
+};
+
+/**
+  Benchmark version of InspectDumpOutput.
+
+  @param[in]  Buffer        Dumped settings.
+  @param[in]  BufferSize    Size of the dumped settings.
+
+  @retval EFI_SUCCESS       Always.
+**/
+EFI_STATUS
+InspectDumpOutput (
+  IN VOID   *Buffer,
+  IN UINTN  BufferSize
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Unused version of SvdRequestXmlFromUSB.
+
+  @param[in]     FileName        What file to read.
+  @param[out]    JsonString      Where to store the Json String
+  @param[out]    JsonStringSize  Size of Json String
+
+  @retval   EFI_UNSUPPORTED      Always.
+
+**/
+EFI_STATUS
+EFIAPI
+SvdRequestXmlFromUSB (
+  IN  CHAR16  *FileName,
+  OUT CHAR8   **JsonString,
+  OUT UINTN   *JsonStringSize
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Unused version of the system information page state machine.
+
+  @retval EFI_ACCESS_DENIED     Always.
+**/
+EFI_STATUS
+EFIAPI
+SysInfoMgr (
+  VOID
+  )
+{
+  return EFI_ACCESS_DENIED;
+}
+
+/**
+  Unused version of the boot option page state machine.
+
+  @retval EFI_ACCESS_DENIED     Always.
+**/
+EFI_STATUS
+EFIAPI
+BootOptionMgr (
+  VOID
+  )
+{
+  return EFI_ACCESS_DENIED;
+}
+
+/**
+  Unused version of the secure boot page state machine.
+
+  @retval EFI_ACCESS_DENIED     Always.
+**/
+EFI_STATUS
+EFIAPI
+SecureBootMgr (
+  VOID
+  )
+{
+  return EFI_ACCESS_DENIED;
+}
+
+/**
+  Unused version of EfiBootManagerConnectAll.
+
+**/
+VOID
+EFIAPI
+EfiBootManagerConnectAll (
+  VOID
+  )
+{
+}
+
+/**
+  Unused version of EfiSignalEventReadyToBoot.
+
+**/
+VOID
+EFIAPI
+EfiSignalEventReadyToBoot (
+  VOID
+  )
+{
+}
+
+/**
+  Benchmark version of Print, discarding the output.
+
+  @param Format   A Null-terminated Unicode format string.
+  @param ...      A Variable argument list whose contents are accessed based
+                  on the format string specified by Format.
+
+  @return 0, no character is printed.
+
+**/
+UINTN
+EFIAPI
+Print (
+  IN CONST CHAR16  *Format,
+  ...
+  )
+{
+  return 0;
+}
+
+/**
+  Benchmark version of Pkcs7Verify, taking every signature as valid so that only ConfApp is measured.
+
+  @param[in]  P7Data       Pointer to the PKCS#7 message to verify.
+  @param[in]  P7Length     Length of the PKCS#7 message in bytes.
+  @param[in]  TrustedCert  Pointer to a trusted/root certificate encoded in DER.
+  @param[in]  CertLength   Length of the trusted certificate in bytes.
+  @param[in]  InData       Pointer to the content to be verified.
+  @param[in]  DataLength   Length of InData in bytes.
+
+  @retval  TRUE   Always.
+
+**/
+BOOLEAN
+EFIAPI
+Pkcs7Verify (
+  IN  CONST UINT8  *P7Data,
+  IN  UINTN        P7Length,
+  IN  CONST UINT8  *TrustedCert,
+  IN  UINTN        CertLength,
+  IN  CONST UINT8  *InData,
+  IN  UINTN        DataLength
+  )
+{
+  return TRUE;
+}
+
+/**
+  Start measuring an operation.
+
+  @param[out] Snapshot      Counters before the operation.
+**/
+STATIC
+VOID
+BenchmarkBegin (
+  OUT BENCHMARK_COUNTERS  *Snapshot
+  )
+{
+  CopyMem (Snapshot, &mCounters, sizeof (mCounters));
+  mPoolPeak = mPoolInUse;
+}
+
+/**
+  Write one result line.
+
+  @param[in]  Operation     Name of the benchmarked operation.
+  @param[in]  KnobCount     Number of knobs in the benchmarked packet.
+  @param[in]  PacketSize    Size in bytes of the benchmarked packet.
+  @param[in]  Iterations    Number of times the operation was performed.
+  @param[in]  Elapsed       Nanoseconds spent in all iterations.
+  @param[in]  Snapshot      Counters before the first iteration.
+  @param[in]  PoolBase      Pool usage before the first iteration.
+**/
+STATIC
+VOID
+BenchmarkReport (
+  IN CONST CHAR8               *Operation,
+  IN UINTN                     KnobCount,
+  IN UINTN                     PacketSize,
+  IN UINTN                     Iterations,
+  IN UINT64                    Elapsed,
+  IN CONST BENCHMARK_COUNTERS  *Snapshot,
+  IN UINT64                    PoolBase
+  )
+{
+  printf (
+    "%s,%llu,%llu,%llu,%llu,%.2f,%llu,%.2f,%.2f,%.2f\n",
+    Operation,
+    (unsigned long long)KnobCount,
+    (unsigned long long)PacketSize,
+    (unsigned long long)Iterations,
+    (unsigned long long)(Elapsed / Iterations),
+    (double)(mCounters.Allocations - Snapshot->Allocations) / (double)Iterations,
+    (unsigned long long)(mPoolPeak - PoolBase),
+    (double)(mCounters.SetVariableCalls - Snapshot->SetVariableCalls) / (double)Iterations,
+    (double)(mCounters.GetVariableCalls - Snapshot->GetVariableCalls) / (double)Iterations,
+    (double)(mCounters.GetPolicyCalls - Snapshot->GetPolicyCalls) / (double)Iterations
+    );
+}
+
+/**
+  Create the synthetic packet as a packed variable list in mVarList. Names are 11 to 24 characters and data is 1
+  to 16 bytes, spread over 4 namespace GUIDs.
+
+  @param[in]  KnobCount     Number of entries to create.
+
+  @retval EFI_SUCCESS           The packet was created.
+  @retval EFI_OUT_OF_RESOURCES  Not enough memory for the packet.
+  @retval Others                An entry could not be serialized.
+**/
+STATIC
+EFI_STATUS
+CreateVarList (
+  IN UINTN  KnobCount
+  )
+{
+  EFI_STATUS             Status;
+  CONFIG_VAR_LIST_ENTRY  Entry;
+  CHAR16                 Name[BENCHMARK_MAX_NAME_LEN + 1];
+  CHAR8                  AsciiName[BENCHMARK_MAX_NAME_LEN + 1];
+  UINT8                  Data[BENCHMARK_MAX_DATA_SIZE];
+  UINTN                  MaxSize;
+  UINTN                  NameLen;
+  UINTN                  Index;
+  UINTN                  Char;
+  UINTN                  Size;
+
+  MaxSize = KnobCount * (sizeof (CONFIG_VAR_LIST_HDR) + sizeof (Name) + sizeof (EFI_GUID) + sizeof (UINT32) +
+                         sizeof (Data) + sizeof (UINT32));
+  mVarList      = malloc (MaxSize);
+  mEntryOffsets = malloc ((KnobCount + 1) * sizeof (UINTN));
+  if ((mVarList == NULL) || (mEntryOffsets == NULL)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  ZeroMem (&Entry, sizeof (Entry));
+  Entry.Name       = Name;
+  Entry.Data       = Data;
+  Entry.Attributes = EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS;
+  Entry.Guid.Data2 = 0x4E43;
+  Entry.Guid.Data3 = 0x8F1B;
+  mEntryOffsets[0] = 0;
+  for (Index = 0; Index < KnobCount; Index++) {
+    NameLen = BENCHMARK_NAME_PREFIX_LEN + 1 + BenchmarkRandom () % (BENCHMARK_MAX_NAME_LEN - BENCHMARK_NAME_PREFIX_LEN);
+    snprintf (AsciiName, sizeof (AsciiName), "Knob%06u", (unsigned)Index);
+    for (Char = BENCHMARK_NAME_PREFIX_LEN; Char < NameLen; Char++) {
+      AsciiName[Char] = (CHAR8)('a' + BenchmarkRandom () % 26);
+    }
+
+    AsciiName[NameLen] = '\0';
+    AsciiStrToUnicodeStrS (AsciiName, Name, ARRAY_SIZE (Name));
+
+    Entry.Guid.Data1 = 0x6BC2D2F6 + (UINT32)(Index % 4);
+    Entry.DataSize   = 1 + BenchmarkRandom () % BENCHMARK_MAX_DATA_SIZE;
+    for (Char = 0; Char < Entry.DataSize; Char++) {
+      Data[Char] = (UINT8)BenchmarkRandom ();
+    }
+
+    Size   = MaxSize - mEntryOffsets[Index];
+    Status = ConvertVariableEntryToVariableList (&Entry, mVarList + mEntryOffsets[Index], &Size);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    mEntryOffsets[Index + 1] = mEntryOffsets[Index] + Size;
+  }
+
+  mEntryCount = KnobCount;
+  return EFI_SUCCESS;
+}
+
+/**
+  Create a XML settings packet of the entries of mVarList, one Setting per entry as dumped by ConfApp.
+
+  @param[out] PacketSize    Length of the packet, not including its NULL terminator.
+
+  @return The packet, or NULL on failure.
+**/
+STATIC
+CHAR8 *
+CreateXmlPacket (
+  OUT UINTN  *PacketSize
+  )
+{
+  EFI_STATUS  Status;
+  CHAR8       *Packet;
+  UINTN       MaxSize;
+  UINTN       Offset;
+  UINTN       Index;
+  UINTN       Size;
+
+  MaxSize = sizeof (BENCHMARK_XML_PREFIX) + sizeof (BENCHMARK_XML_SUFFIX);
+  for (Index = 0; Index < mEntryCount; Index++) {
+    MaxSize += sizeof (BENCHMARK_XML_SETTING_OPEN) + BENCHMARK_MAX_NAME_LEN + sizeof (BENCHMARK_XML_SETTING_VALUE) +
+               ConfigBase64EncodedSize (mEntryOffsets[Index + 1] - mEntryOffsets[Index]) + sizeof (BENCHMARK_XML_SETTING_CLOSE);
+  }
+
+  Packet = malloc (MaxSize);
+  if (Packet == NULL) {
+    return NULL;
+  }
+
+  Offset = AsciiSPrint (Packet, MaxSize, "%a", BENCHMARK_XML_PREFIX);
+  for (Index = 0; Index < mEntryCount; Index++) {
+    // The name follows the CONFIG_VAR_LIST_HDR of the entry
+    Offset += AsciiSPrint (
+                Packet + Offset,
+                MaxSize - Offset,
+                "%a%s%a",
+                BENCHMARK_XML_SETTING_OPEN,
+                (CHAR16 *)(mVarList + mEntryOffsets[Index] + sizeof (CONFIG_VAR_LIST_HDR)),
+                BENCHMARK_XML_SETTING_VALUE
+                );
+
+    Size   = MaxSize - Offset;
+    Status = ConfigBase64Encode (mVarList + mEntryOffsets[Index], mEntryOffsets[Index + 1] - mEntryOffsets[Index], Packet + Offset, &Size);
+    if (EFI_ERROR (Status)) {
+      free (Packet);
+      return NULL;
+    }
+
+    Offset += Size - 1;
+    Offset += AsciiSPrint (Packet + Offset, MaxSize - Offset, "%a", BENCHMARK_XML_SETTING_CLOSE);
+  }
+
+  Offset     += AsciiSPrint (Packet + Offset, MaxSize - Offset, "%a", BENCHMARK_XML_SUFFIX);
+  *PacketSize = Offset;
+  return Packet;
+}
+
+/**
+  Create a binary settings packet of mVarList.
+
+  @param[out] PacketSize    Size of the packet.
+
+  @return The packet, or NULL on failure.
+**/
+STATIC
+CHAR8 *
+CreateBinaryPacket (
+  OUT UINTN  *PacketSize
+  )
+{
+  SVD_BINARY_PACKET_HEADER   *Header;
+  WIN_CERTIFICATE_UEFI_GUID  *Cert;
+  UINTN                      PayloadSize;
+
+  PayloadSize = mEntryOffsets[mEntryCount];
+  Header      = calloc (1, sizeof (*Header) + PayloadSize + OFFSET_OF (WIN_CERTIFICATE_UEFI_GUID, CertData) + BENCHMARK_SIGNATURE_SIZE);
+  if (Header == NULL) {
+    return NULL;
+  }
+
+  Header->Signature              = SVD_BINARY_PACKET_SIGNATURE;
+  Header->HeaderVersion          = SVD_BINARY_PACKET_HEADER_VERSION;
+  Header->HeaderSize             = sizeof (*Header);
+  Header->Version                = 1;
+  Header->LowestSupportedVersion = 1;
+  Header->PayloadSize            = (UINT32)PayloadSize;
+  Header->PayloadCrc32           = ConfigCalculateCrc32 (mVarList, PayloadSize);
+  CopyMem (Header + 1, mVarList, PayloadSize);
+
+  Cert = (WIN_CERTIFICATE_UEFI_GUID *)((UINT8 *)(Header + 1) + PayloadSize);
+  WriteUnaligned32 (&Cert->Hdr.dwLength, OFFSET_OF (WIN_CERTIFICATE_UEFI_GUID, CertData) + BENCHMARK_SIGNATURE_SIZE);
+  WriteUnaligned16 (&Cert->Hdr.wRevision, 0x0200);
+  WriteUnaligned16 (&Cert->Hdr.wCertificateType, WIN_CERT_TYPE_EFI_GUID);
+  CopyGuid (&Cert->CertType, &gEfiCertPkcs7Guid);
+
+  *PacketSize = sizeof (*Header) + PayloadSize + OFFSET_OF (WIN_CERTIFICATE_UEFI_GUID, CertData) + BENCHMARK_SIGNATURE_SIZE;
+  return (CHAR8 *)Header;
+}
+
+/**
+  Benchmark applying a settings packet, either to an empty variable store so that every knob is written, or to a
+  store already holding the packet so that every knob is unchanged.
+
+  @param[in]  Operation     Name of the benchmarked operation.
+  @param[in]  Packet        Settings packet to apply.
+  @param[in]  PacketSize    Size of the packet.
+  @param[in]  Unchanged     Whether the store already holds the packet.
+
+  @retval EFI_SUCCESS       The packet was applied and reported.
+  @retval Others            Applying the packet failed.
+**/
+STATIC
+EFI_STATUS
+BenchmarkApply (
+  IN CONST CHAR8  *Operation,
+  IN CHAR8        *Packet,
+  IN UINTN        PacketSize,
+  IN BOOLEAN      Unchanged
+  )
+{
+  EFI_STATUS          Status;
+  BENCHMARK_COUNTERS  Snapshot;
+  UINT64              PoolBase;
+  UINT64              Elapsed;
+  UINT64              Start;
+  UINTN               Iterations;
+  UINTN               Iteration;
+
+  ClearVariables ();
+  if (Unchanged) {
+    Status = ApplySettings (Packet, PacketSize);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  Iterations = BENCHMARK_KNOBS_PER_OPERATION / mEntryCount;
+  Elapsed    = 0;
+  PoolBase   = mPoolInUse;
+  BenchmarkBegin (&Snapshot);
+  for (Iteration = 0; Iteration < Iterations; Iteration++) {
+    if (!Unchanged) {
+      ClearVariables ();
+    }
+
+    Start   = BenchmarkNow ();
+    Status  = ApplySettings (Packet, PacketSize);
+    Elapsed = Elapsed + BenchmarkNow () - Start;
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    // ApplySettings only logs the knobs failing to be written
+    if (CountVariables () != mEntryCount) {
+      return EFI_COMPROMISED_DATA;
+    }
+  }
+
+  BenchmarkReport (Operation, mEntryCount, PacketSize, Iterations, Elapsed, &Snapshot, PoolBase);
+  return EFI_SUCCESS;
+}
+
+/**
+  Benchmark dumping the current settings of mVarList, served by the policy protocol.
+
+  @param[in]  Operation     Name of the benchmarked operation.
+  @param[in]  Iterations    Number of dumps.
+  @param[in]  Reload        Whether the policies are retrieved again for each dump.
+
+  @retval EFI_SUCCESS       The settings were dumped and reported.
+  @retval Others            Dumping the settings failed.
+**/
+STATIC
+EFI_STATUS
+BenchmarkDump (
+  IN CONST CHAR8  *Operation,
+  IN UINTN        Iterations,
+  IN BOOLEAN      Reload
+  )
+{
+  EFI_STATUS          Status;
+  BENCHMARK_COUNTERS  Snapshot;
+  CHAR8               *XmlString;
+  UINTN               XmlStringSize;
+  UINT64              PoolBase;
+  UINT64              Elapsed;
+  UINT64              Start;
+  UINTN               Iteration;
+
+  Elapsed       = 0;
+  XmlStringSize = 0;
+  PoolBase      = mPoolInUse;
+  BenchmarkBegin (&Snapshot);
+  for (Iteration = 0; Iteration < Iterations; Iteration++) {
+    if (Reload) {
+      InvalidateConfAppState (CONF_APP_STATE_POLICY);
+    }
+
+    Start   = BenchmarkNow ();
+    Status  = CreateXmlStringFromCurrentSettings (&XmlString, &XmlStringSize);
+    Elapsed = Elapsed + BenchmarkNow () - Start;
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    FreePool (XmlString);
+  }
+
+  BenchmarkReport (Operation, mEntryCount, XmlStringSize, Iterations, Elapsed, &Snapshot, PoolBase);
+  return EFI_SUCCESS;
+}
+
+/**
+  Benchmark every apply and dump path against one synthetic settings packet.
+
+  @param[in]  KnobCount     Number of knobs in the settings packet.
+
+  @retval EFI_SUCCESS       All operations succeeded and were reported.
+  @retval Others            An operation failed.
+**/
+STATIC
+EFI_STATUS
+BenchmarkKnobCount (
+  IN UINTN  KnobCount
+  )
+{
+  EFI_STATUS  Status;
+  CHAR8       *XmlPacket;
+  CHAR8       *BinaryPacket;
+  UINTN       XmlPacketSize;
+  UINTN       BinaryPacketSize;
+
+  XmlPacket    = NULL;
+  BinaryPacket = NULL;
+
+  Status = CreateVarList (KnobCount);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  XmlPacket    = CreateXmlPacket (&XmlPacketSize);
+  BinaryPacket = CreateBinaryPacket (&BinaryPacketSize);
+  if ((XmlPacket == NULL) || (BinaryPacket == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Done;
+  }
+
+  Status = BenchmarkApply ("ApplySettingsXmlWrite", XmlPacket, XmlPacketSize, FALSE);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  Status = BenchmarkApply ("ApplySettingsXmlUnchanged", XmlPacket, XmlPacketSize, TRUE);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  Status = BenchmarkApply ("ApplySettingsBinaryWrite", BinaryPacket, BinaryPacketSize, FALSE);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  Status = BenchmarkApply ("ApplySettingsBinaryUnchanged", BinaryPacket, BinaryPacketSize, TRUE);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  // The first dump of a packet encodes every setting, later ones only encode the settings that changed
+  Status = BenchmarkDump ("CreateXmlStringFirst", 1, TRUE);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  Status = BenchmarkDump ("CreateXmlStringPolicyReload", BENCHMARK_KNOBS_PER_OPERATION / KnobCount, TRUE);
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  Status = BenchmarkDump ("CreateXmlStringCached", BENCHMARK_KNOBS_PER_OPERATION / KnobCount, FALSE);
+
+Done:
+  free (XmlPacket);
+  free (BinaryPacket);
+  free (mVarList);
+  free (mEntryOffsets);
+  mVarList      = NULL;
+  mEntryOffsets = NULL;
+  return Status;
+}
+
+/**
+  Benchmark entry point.
+
+  @param[in]  argc  Number of command line arguments, unused.
+  @param[in]  argv  Command line arguments, unused.
+
+  @retval 0   All benchmarks completed.
+  @retval 1   A benchmarked operation failed.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+
+  mRandomState    = 0x5EED;
+  mPolicyProtocol = &mBenchmarkPolicy;
+  printf ("Operation,KnobCount,PacketSize,Iterations,NsPerOp,AllocationsPerOp,PeakPoolBytes,SetVariablePerOp,GetVariablePerOp,GetPolicyPerOp\n");
+  for (Index = 0; Index < ARRAY_SIZE (mKnobCounts); Index++) {
+    Status = BenchmarkKnobCount (mKnobCounts[Index]);
+    if (EFI_ERROR (Status)) {
+      fprintf (stderr, "Benchmark of %llu knobs failed: %llx\n", (unsigned long long)mKnobCounts[Index], (unsigned long long)Status);
+      return 1;
+    }
+  }
+
+  ClearVariables ();
+  return 0;
+}
@@ -24,6 +24,7 @@
 #include <Library/DebugLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/DxeServicesLib.h>
+#include <Library/ConfigPerfCounterLib.h>
 
 #include <Library/UnitTestLib.h>
 
@@ -36,6 +37,7 @@
 #define MOCK_TIMER_EVENT  0xFEEDF00D
 
 extern EFI_SIMPLE_TEXT_INPUT_EX_PROTOCOL  MockSimpleInput;
+extern EFI_SYSTEM_TABLE                   MockSys;
 extern SysInfoState_t                     mSysInfoState;
 extern UINTN                              mEndCol;
 extern UINTN                              mEndRow;
@@ -113,6 +115,10 @@ EfiBootManagerConnectAll (
   return;
 }
 
+// Seconds the mocked clock advances by on each GetTime
+UINT8  mMockTimeStep   = 1;
+UINT8  mMockTimeSecond = 0;
+
 /**
   Mocked version of GetTime.
 
@@ -140,6 +146,8 @@ MockGetTime (
 
   assert_non_null (Time);
   CopyMem (Time, &DefaultPayloadTimestamp, sizeof (EFI_TIME));
+  Time->Second    = mMockTimeSecond;
+  mMockTimeSecond = (mMockTimeSecond + mMockTimeStep) % 60;
 
   return EFI_SUCCESS;
 }
@@ -149,6 +157,9 @@ MockGetTime (
 ///
 extern EFI_RUNTIME_SERVICES  MockRuntime;
 
+// Set by the mocked Print when the configuration counters heading is printed
+BOOLEAN  mConfigCountersPrinted = FALSE;
+
 /**
   Mock version of Print.
 
@@ -176,6 +187,10 @@ Print (
 
   DEBUG ((DEBUG_INFO, "%a", Buffer));
 
+  if (AsciiStrStr (Buffer, "Configuration Counters") != NULL) {
+    mConfigCountersPrinted = TRUE;
+  }
+
   return Ret;
 }
 
@@ -433,6 +448,11 @@ SysInfoCleanup (
   mSysInfoState = SysInfoInit;
   mEndCol       = 0;
   mEndRow       = 0;
+  mMockTimeStep = 1;
+
+  mConfigCountersPrinted       = FALSE;
+  MockSys.NumberOfTableEntries = 0;
+  MockSys.ConfigurationTable   = NULL;
 }
 
 /**
@@ -675,6 +695,114 @@ ConfAppSysInfoTimeRefresh (
   return UNIT_TEST_PASSED;
 }
 
+/**
+  Unit test for SystemInfo page when the time has not changed since it was printed.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfAppSysInfoTimeUnchanged (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS  Status;
+
+  mMockTimeStep = 0;
+
+  will_return (MockClearScreen, EFI_SUCCESS);
+  will_return_always (MockSetAttribute, EFI_SUCCESS);
+
+  will_return (EfiLocateProtocolBuffer, 1);
+  will_return (EfiLocateProtocolBuffer, MockFmpArray);
+
+  // Expect the prints only once
+  expect_any_count (MockSetCursorPosition, Column, 2);
+  expect_any_count (MockSetCursorPosition, Row, 2);
+  will_return_count (MockSetCursorPosition, EFI_SUCCESS, 2);
+
+  // Initial run
+  Status = SysInfoMgr ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mSysInfoState, SysInfoWait);
+
+  mSimpleTextInEx = &MockSimpleInput;
+
+  will_return (MockCreateEvent, EFI_SUCCESS);
+  will_return (MockSetTimer, EFI_SUCCESS);
+  will_return (MockWaitForEvent, 1);
+
+  // Time out, nothing to print
+  Status = SysInfoMgr ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mSysInfoState, SysInfoWait);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for SystemInfo page when the configuration counter table is published.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfAppSysInfoConfigCounters (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS                 Status;
+  CONFIG_PERF_COUNTER_TABLE  Table;
+  EFI_CONFIGURATION_TABLE    ConfigTable;
+
+  ZeroMem (&Table, sizeof (Table));
+  Table.Signature                                      = CONFIG_PERF_COUNTER_TABLE_SIGNATURE;
+  Table.Version                                        = CONFIG_PERF_COUNTER_TABLE_VERSION;
+  Table.CounterCount                                   = ConfigPerfCounterMax;
+  Table.PeiCounters[ConfigPerfCounterGetVariableCalls] = 12;
+  Table.DxeCounters[ConfigPerfCounterGetVariableCalls] = 34;
+
+  CopyGuid (&ConfigTable.VendorGuid, &gConfigPerfCounterTableGuid);
+  ConfigTable.VendorTable      = &Table;
+  MockSys.NumberOfTableEntries = 1;
+  MockSys.ConfigurationTable   = &ConfigTable;
+
+  will_return (MockClearScreen, EFI_SUCCESS);
+  will_return_always (MockSetAttribute, EFI_SUCCESS);
+
+  will_return (EfiLocateProtocolBuffer, 0);
+
+  expect_any_count (MockSetCursorPosition, Column, 2);
+  expect_any_count (MockSetCursorPosition, Row, 2);
+  will_return_count (MockSetCursorPosition, EFI_SUCCESS, 2);
+
+  Status = SysInfoMgr ();
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_TRUE (mConfigCountersPrinted);
+
+  return UNIT_TEST_PASSED;
+}
+
 /**
   Initialize the unit test framework, suite, and unit tests for the
   ConfApp and run the ConfApp unit test.
@@ -727,6 +855,8 @@ UnitTestingEntry (
   AddTestCase (MiscTests, "System Info page select Esc should go to previous menu", "SelectEsc", ConfAppSysInfoSelectEsc, NULL, SysInfoCleanup, NULL);
   AddTestCase (MiscTests, "System Info page select others should do nothing", "SelectOther", ConfAppSysInfoSelectOther, NULL, SysInfoCleanup, NULL);
   AddTestCase (MiscTests, "System Info page should auto refresh time display", "TimeRefresh", ConfAppSysInfoTimeRefresh, NULL, SysInfoCleanup, NULL);
+  AddTestCase (MiscTests, "System Info page should not reprint an unchanged time", "TimeUnchanged", ConfAppSysInfoTimeUnchanged, NULL, SysInfoCleanup, NULL);
+  AddTestCase (MiscTests, "System Info page should print the config counters when published", "ConfigCounters", ConfAppSysInfoConfigCounters, NULL, SysInfoCleanup, NULL);
 
   //
   // Execute the tests.
@@ -42,4 +42,51 @@ typedef struct {
   UINTN            OverrideCount;
 } PROFILE;
 
+//
+// Profile encoding generated by KnobService.py --bitmapprofiles. Bit N of Bitmap is set when the profile overrides
+// knob N, and Values holds the values of the overridden knobs back to back in knob order.
+//
+typedef struct {
+  CONST UINT8    *Bitmap;
+  CONST UINT8    *Values;
+  UINTN          ValuesSize;
+} PROFILE_BITMAP;
+
+//
+// Config policy of a profile generated by KnobService.py --policyblobs. Policy holds the knob defaults with the
+// profile overrides applied, serialized in the variable list format with the CRC of every entry already computed.
+//
+typedef struct {
+  CONST UINT8    *Policy;
+  UINTN          PolicySize;
+} PROFILE_POLICY;
+
+//
+// A config policy generated by KnobService.py holds KnobCount knobs starting at FirstKnob, serialized in knob order.
+// The Nth config policy is published under the Nth GUID of PcdConfigurationPolicyGuid.
+//
+typedef struct {
+  UINTN    FirstKnob;
+  UINTN    KnobCount;
+  UINTN    PolicySize;
+} CONFIG_POLICY_RANGE;
+
+//
+// A constraint on one leaf of a knob value, generated by KnobService.py --constrainttable. The leaf is Width bytes at
+// Offset into its knob, or ValueOffset into the KNOB_VALUES structure. UNSIGNED and SIGNED leaves must lie within
+// [Min, Max]. An ENUM leaf is valid when bit (Value - Min) of Max is set.
+//
+#define KNOB_CONSTRAINT_UNSIGNED  0
+#define KNOB_CONSTRAINT_SIGNED    1
+#define KNOB_CONSTRAINT_ENUM      2
+
+typedef struct {
+  UINT64    Min;
+  UINT64    Max;
+  UINT32    ValueOffset;
+  UINT32    Offset;
+  UINT8     Width;
+  UINT8     Kind;
+} KNOB_CONSTRAINT;
+
 #endif // CONFIG_STD_STRUCT_DEFS_LIB_H_
@@ -0,0 +1,101 @@
+/** @file
+  Library interface to encode and decode the Base64 data of configuration settings, e.g. the values of SVD
+  settings packets.
+
+  The codec accepts the same input as Base64Encode and Base64Decode from BaseLib, but the output sizes are
+  computed without a pass over the data, so that a caller can size its buffer and convert in a single pass.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef CONFIG_BASE64_LIB_H_
+#define CONFIG_BASE64_LIB_H_
+
+/**
+  Get the size of the Base64 encoding of binary data.
+
+  @param[in]  SourceLength  Size of the binary data in bytes.
+
+  @return The number of ASCII characters of the encoding, including the NULL terminator, or 0 if the
+          encoding would not fit a UINTN.
+**/
+UINTN
+EFIAPI
+ConfigBase64EncodedSize (
+  IN UINTN  SourceLength
+  );
+
+/**
+  Get the size of the binary data decoded from a Base64 encoding, from the length of the encoding and its
+  trailing padding only.
+
+  The size is exact for an encoding without whitespace, as written by ConfigBase64Encode, and an upper bound
+  of the decoded size otherwise. A buffer of this size is always large enough for ConfigBase64Decode.
+
+  @param[in]  Source      Pointer to the Base64 encoding, may be NULL if SourceSize is 0.
+  @param[in]  SourceSize  Number of ASCII characters in Source, not including any NULL terminator.
+
+  @return The number of bytes ConfigBase64Decode needs for the decoded data.
+**/
+UINTN
+EFIAPI
+ConfigBase64DecodedSize (
+  IN CONST CHAR8  *Source OPTIONAL,
+  IN UINTN        SourceSize
+  );
+
+/**
+  Encode binary data into a NULL terminated Base64 ASCII string, as Base64Encode of BaseLib does.
+
+  @param[in]      Source           Pointer to the binary data, may be NULL if SourceLength is 0.
+  @param[in]      SourceLength     Size of the binary data in bytes.
+  @param[out]     Destination      Pointer to the output buffer, may be NULL if *DestinationSize is 0.
+  @param[in,out]  DestinationSize  On input, the size of Destination in characters. On output, the number of
+                                   characters of the encoding including the NULL terminator, see
+                                   ConfigBase64EncodedSize.
+
+  @retval EFI_SUCCESS             The data was encoded.
+  @retval EFI_BUFFER_TOO_SMALL    Destination is too small, *DestinationSize holds the size needed.
+  @retval EFI_INVALID_PARAMETER   Source or Destination is NULL while its size is not 0, DestinationSize is
+                                  NULL, the buffers overlap or the encoding would not fit a UINTN.
+**/
+EFI_STATUS
+EFIAPI
+ConfigBase64Encode (
+  IN     CONST UINT8  *Source OPTIONAL,
+  IN     UINTN        SourceLength,
+  OUT    CHAR8        *Destination OPTIONAL,
+  IN OUT UINTN        *DestinationSize
+  );
+
+/**
+  Decode a Base64 ASCII string into binary data, as Base64Decode of BaseLib does: whitespace is ignored at all
+  positions and at most two padding characters may end the encoding.
+
+  When *DestinationSize is at least ConfigBase64DecodedSize, the data is validated and decoded in a single
+  pass. Otherwise the encoding is first measured, as it may hold whitespace that makes the data fit.
+
+  @param[in]      Source           Pointer to the Base64 encoding, may be NULL if SourceSize is 0.
+  @param[in]      SourceSize       Number of ASCII characters in Source, not including any NULL terminator.
+  @param[out]     Destination      Pointer to the output buffer, may be NULL if *DestinationSize is 0.
+  @param[in,out]  DestinationSize  On input, the size of Destination in bytes. On output, the number of bytes
+                                   decoded, or needed when EFI_BUFFER_TOO_SMALL is returned.
+
+  @retval EFI_SUCCESS             The data was decoded.
+  @retval EFI_BUFFER_TOO_SMALL    Destination is too small, *DestinationSize holds the size needed.
+  @retval EFI_INVALID_PARAMETER   Source or Destination is NULL while its size is not 0, DestinationSize is
+                                  NULL, the buffers overlap or Source is not a valid Base64 encoding. The
+                                  contents of Destination are undefined.
+**/
+EFI_STATUS
+EFIAPI
+ConfigBase64Decode (
+  IN     CONST CHAR8  *Source OPTIONAL,
+  IN     UINTN        SourceSize,
+  OUT    UINT8        *Destination OPTIONAL,
+  IN OUT UINTN        *DestinationSize
+  );
+
+#endif // CONFIG_BASE64_LIB_H_
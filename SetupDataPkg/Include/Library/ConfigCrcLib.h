@@ -0,0 +1,47 @@
+/** @file
+  Library interface to calculate the CRC32 checksums used by configuration data.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef CONFIG_CRC_LIB_H_
+#define CONFIG_CRC_LIB_H_
+
+/**
+  Calculate the CRC32 of a buffer. This is the same IEEE 802.3 CRC32 as CalculateCrc32 from
+  BaseLib and zlib's crc32, which the configuration tools use to produce their checksums.
+
+  @param[in]  Buffer  Pointer to the buffer. May be NULL if Length is 0.
+  @param[in]  Length  Size of Buffer in bytes.
+
+  @return The CRC32 of Buffer.
+**/
+UINT32
+EFIAPI
+ConfigCalculateCrc32 (
+  IN CONST VOID  *Buffer,
+  IN UINTN       Length
+  );
+
+/**
+  Continue a CRC32 calculation with more data, so that a buffer can be checksummed in pieces.
+  ConfigUpdateCrc32 (ConfigCalculateCrc32 (A, LengthA), B, LengthB) returns the CRC32 of A and B
+  concatenated, and ConfigUpdateCrc32 (0, Buffer, Length) equals ConfigCalculateCrc32 (Buffer, Length).
+
+  @param[in]  Crc     CRC32 of the data preceding Buffer, 0 if there is none.
+  @param[in]  Buffer  Pointer to the buffer. May be NULL if Length is 0.
+  @param[in]  Length  Size of Buffer in bytes.
+
+  @return The CRC32 of the preceding data followed by Buffer.
+**/
+UINT32
+EFIAPI
+ConfigUpdateCrc32 (
+  IN UINT32      Crc,
+  IN CONST VOID  *Buffer,
+  IN UINTN       Length
+  );
+
+#endif // CONFIG_CRC_LIB_H_
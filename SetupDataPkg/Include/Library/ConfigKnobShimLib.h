@@ -9,6 +9,27 @@
 #ifndef CONFIG_KNOB_SHIM_LIB_H_
 #define CONFIG_KNOB_SHIM_LIB_H_
 
+#include <ConfigStdStructDefs.h>
+
+//
+// A validated config policy is cached in variable storage under gConfigKnobPolicyCacheVariableGuid, with the
+// fingerprint of the knob values it was built from and the SHA-256 of the policy kept in a separate info variable.
+// Deleting the info variable invalidates the cached policy, which is done whenever config knob variables are written.
+// The DXE shim locks both variables through variable policy once ReadyToBoot is signalled.
+//
+#define CONFIG_KNOB_POLICY_CACHE_VARIABLE_NAME       L"ConfigKnobPolicyCache"
+#define CONFIG_KNOB_POLICY_CACHE_INFO_VARIABLE_NAME  L"ConfigKnobPolicyCacheInfo"
+#define CONFIG_KNOB_POLICY_CACHE_ATTRIBUTES          (EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS)
+
+// Size of a fingerprint, a SHA-256 digest
+#define CONFIG_KNOB_FINGERPRINT_SIZE  32
+
+typedef struct {
+  UINT8    Digest[CONFIG_KNOB_FINGERPRINT_SIZE];
+} CONFIG_KNOB_FINGERPRINT;
+
+extern EFI_GUID  gConfigKnobPolicyCacheVariableGuid;
+
 /**
   GetConfigKnobOverride searches for an override to the given config knob.
 
@@ -43,4 +64,113 @@ GetConfigKnobOverride (
   IN UINTN     ConfigKnobDataSize
   );
 
+/**
+  GetConfigKnobOverrides searches for overrides to a list of config knobs, locating variable services only once for
+  the whole list. Knobs that fit in CONFIG_KNOB_READ_BUFFER_SIZE are read from variable storage with a single call, as
+  their size is already known.
+
+  For each knob, if the config override is found and the data size matches ValueSize, the buffer at CacheValueAddress
+  will be written with the override value. Otherwise, the buffer at CacheValueAddress is left untouched.
+
+  This function is only expected to be called from an OEM config policy creator.
+
+  @param[in]  Knobs               Array of config knobs to search overrides for, i.e. gKnobData. Entries with a NULL
+                                  Name or CacheValueAddress, such as the KNOB_MAX terminator, are skipped and marked
+                                  EFI_INVALID_PARAMETER.
+  @param[in]  KnobCount           Number of entries in Knobs and KnobStatus.
+  @param[out] KnobStatus          Array of per knob results, with the same meaning as the return values of
+                                  GetConfigKnobOverride. If variable services cannot be located, every entry is set
+                                  to that error.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null or KnobCount is 0.
+  @retval !EFI_SUCCESS            Failed to locate variable services.
+  @retval EFI_SUCCESS             Every knob was searched, see KnobStatus for the result of each one.
+
+**/
+EFI_STATUS
+EFIAPI
+GetConfigKnobOverrides (
+  IN  CONST KNOB_DATA  *Knobs,
+  IN  UINTN            KnobCount,
+  OUT EFI_STATUS       *KnobStatus
+  );
+
+/**
+  GetConfigKnobFingerprint computes a fingerprint of the current values of a list of config knobs, for a config policy
+  creator to tell whether the policy it validated and cached on a previous boot can be published as is.
+
+  The fingerprint is the SHA-256 of the active profile index, the namespace, name and size of every knob, and the
+  value at the CacheValueAddress of every knob. It is expected to be computed once the active profile and the
+  overrides found by GetConfigKnobOverrides have been applied to the cached knob values, and before any knob is
+  validated.
+
+  @param[in]  Knobs               Array of config knobs, i.e. gKnobData. Entries with a NULL Name or
+                                  CacheValueAddress, such as the KNOB_MAX terminator, are skipped.
+  @param[in]  KnobCount           Number of entries in Knobs.
+  @param[in]  ActiveProfileIndex  The active profile index for this boot, as returned by GetActiveProfileIndex.
+  @param[out] Fingerprint         The fingerprint of the knob values.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null or KnobCount is 0.
+  @retval EFI_OUT_OF_RESOURCES    The hash context could not be allocated.
+  @retval EFI_ABORTED             Hashing the knob values failed.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+GetConfigKnobFingerprint (
+  IN  CONST KNOB_DATA          *Knobs,
+  IN  UINTN                    KnobCount,
+  IN  UINT32                   ActiveProfileIndex,
+  OUT CONFIG_KNOB_FINGERPRINT  *Fingerprint
+  );
+
+/**
+  GetConfigKnobCachedPolicy returns the config policy cached by SetConfigKnobCachedPolicy, if it was cached with the
+  same fingerprint. The policy is checked against the SHA-256 it was cached with.
+
+  @param[in]  Fingerprint         The fingerprint of the current knob values, from GetConfigKnobFingerprint.
+  @param[out] Policy              The cached policy. This parameter is acceptable to be NULL if *PolicySize is 0.
+  @param[in out] PolicySize       The allocated size of Policy. On return, the size of the cached policy.
+
+  @retval EFI_INVALID_PARAMETER   Fingerprint or PolicySize is null, or Policy is null and *PolicySize is not 0.
+  @retval EFI_NOT_FOUND           No policy is cached, or it was cached with another fingerprint.
+  @retval EFI_BUFFER_TOO_SMALL    *PolicySize was too small for the cached policy, and is updated with its size.
+  @retval EFI_COMPROMISED_DATA    The cached policy is corrupted.
+  @retval !EFI_SUCCESS            Failed to read the cached policy from variable storage.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+GetConfigKnobCachedPolicy (
+  IN     CONST CONFIG_KNOB_FINGERPRINT  *Fingerprint,
+  OUT    VOID                           *Policy OPTIONAL,
+  IN OUT UINTN                          *PolicySize
+  );
+
+/**
+  SetConfigKnobCachedPolicy caches a validated config policy in variable storage, for GetConfigKnobCachedPolicy to
+  return on the next boots with the same fingerprint. Variable storage is read only in PEI, so the policy has to be
+  cached from DXE or Standalone MM, and before ReadyToBoot once the DXE shim locked the cache.
+
+  @param[in]  Fingerprint         The fingerprint of the knob values the policy was built from.
+  @param[in]  Policy              The validated policy.
+  @param[in]  PolicySize          The size of Policy.
+
+  @retval EFI_INVALID_PARAMETER   Fingerprint or Policy is null, or PolicySize is 0 or larger than MAX_UINT32.
+  @retval EFI_WRITE_PROTECTED     Variable storage cannot be written in this phase, or the cache is locked.
+  @retval EFI_ABORTED             Hashing the policy failed.
+  @retval !EFI_SUCCESS            Failed to write the cached policy to variable storage.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+SetConfigKnobCachedPolicy (
+  IN CONST CONFIG_KNOB_FINGERPRINT  *Fingerprint,
+  IN CONST VOID                     *Policy,
+  IN UINTN                          PolicySize
+  );
+
 #endif // CONFIG_KNOB_SHIM_LIB_H_
@@ -0,0 +1,105 @@
+/** @file ConfigPerfCounterLib.h
+  Library interface to count the work done by the configuration libraries, e.g. the variable list entries parsed or
+  the variable services calls made, and to publish those counters for the current boot.
+
+  The counters of PEI are kept in a GUID HOB and the counters of DXE in a configuration table, both found under
+  gConfigPerfCounterTableGuid. The DXE configuration table also holds a copy of the PEI counters.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef CONFIG_PERF_COUNTER_LIB_H_
+#define CONFIG_PERF_COUNTER_LIB_H_
+
+#define CONFIG_PERF_COUNTER_TABLE_SIGNATURE  SIGNATURE_32 ('C', 'P', 'C', 'T')
+#define CONFIG_PERF_COUNTER_TABLE_VERSION    1
+
+//
+// Volatile variable SaveConfigPerfCounterTable copies the configuration table to, under gConfigPerfCounterTableGuid,
+// for tools running in the OS to read.
+//
+#define CONFIG_PERF_COUNTER_VARIABLE_NAME        L"ConfigPerfCounters"
+#define CONFIG_PERF_COUNTER_VARIABLE_ATTRIBUTES  (EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS)
+
+//
+// New counters are only to be added before ConfigPerfCounterMax, so that the table of an older producer can still be
+// read up to its CounterCount.
+//
+typedef enum {
+  ConfigPerfCounterEntriesParsed,     // Variable list entries validated
+  ConfigPerfCounterBytesCrced,        // Bytes checksummed by ConfigCrcLib
+  ConfigPerfCounterAllocations,       // Pool allocations made for config data
+  ConfigPerfCounterGetVariableCalls,  // GetVariable calls made for config knobs
+  ConfigPerfCounterSetVariableCalls,  // SetVariable calls made for config knobs
+  ConfigPerfCounterOverrideHits,      // Config knobs found overridden
+  ConfigPerfCounterOverrideMisses,    // Config knobs left at their profile value
+  ConfigPerfCounterMax
+} CONFIG_PERF_COUNTER;
+
+#pragma pack(push, 1)
+
+typedef struct {
+  UINT32    Signature;                        // CONFIG_PERF_COUNTER_TABLE_SIGNATURE
+  UINT32    Version;                          // CONFIG_PERF_COUNTER_TABLE_VERSION
+  UINT32    CounterCount;                     // Number of entries in each counter array
+  UINT32    Reserved;
+  UINT64    PeiCounters[ConfigPerfCounterMax];
+  UINT64    DxeCounters[ConfigPerfCounterMax];
+} CONFIG_PERF_COUNTER_TABLE;
+
+#pragma pack(pop)
+
+extern EFI_GUID  gConfigPerfCounterTableGuid;
+
+/**
+  Add to a counter of the current phase. The counter table of the phase is created on first use.
+
+  The counters are best effort: they are silently dropped if the table cannot be created.
+
+  @param[in]  Counter   The counter to add to.
+  @param[in]  Value     The amount to add.
+
+**/
+VOID
+EFIAPI
+ConfigPerfCounterAdd (
+  IN CONFIG_PERF_COUNTER  Counter,
+  IN UINT64               Value
+  );
+
+/**
+  Get the counter table of the current phase.
+
+  @param[out] Table     The counter table. It is owned by the library and must not be freed.
+
+  @retval EFI_INVALID_PARAMETER   Table is NULL.
+  @retval EFI_NOT_FOUND           Nothing has been counted in this phase yet.
+  @retval EFI_UNSUPPORTED         This library instance does not count.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+GetConfigPerfCounterTable (
+  OUT CONFIG_PERF_COUNTER_TABLE  **Table
+  );
+
+/**
+  Copy the counter table of the current phase to the CONFIG_PERF_COUNTER_VARIABLE_NAME volatile variable, so that
+  it can be read once the OS is running. Platforms are expected to call this at ReadyToBoot.
+
+  @retval EFI_NOT_FOUND           Nothing has been counted in this phase yet.
+  @retval EFI_UNSUPPORTED         This library instance or phase does not publish a variable.
+  @retval Others                  The variable could not be written.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+SaveConfigPerfCounterTable (
+  VOID
+  );
+
+#endif // CONFIG_PERF_COUNTER_LIB_H_
@@ -1,6 +1,9 @@
 /** @file
   Library interface to process the list of configuration variables.
 
+  The ConfigVariableListLibNoAlloc instance, for modules without a usable heap, only implements the functions that
+  work in place over caller provided buffers. The functions that allocate return EFI_UNSUPPORTED in that instance.
+
   Copyright (c) Microsoft Corporation.
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -46,6 +49,184 @@ typedef struct {
 } CONFIG_VAR_LIST_HDR;
 #pragma pack(pop)
 
+/*
+ * Alternate, aligned variable list format. A single header is followed by an array of fixed
+ * size entry descriptors, a region holding all UTF-16LE names and a region holding all data,
+ * in that order. Every value in the data region starts at a multiple of
+ * CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT from the start of the buffer, so when the buffer
+ * itself is suitably aligned the data can be read in place. Buffers starting with
+ * CONFIG_VAR_LIST_ALIGNED_SIGNATURE are parsed in this format, all others as packed entries.
+ */
+#define CONFIG_VAR_LIST_ALIGNED_SIGNATURE       SIGNATURE_32 ('C', 'V', 'L', 'A')
+#define CONFIG_VAR_LIST_ALIGNED_VERSION         1
+#define CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT  8
+
+typedef struct {
+  /* CONFIG_VAR_LIST_ALIGNED_SIGNATURE */
+  UINT32    Signature;
+
+  /* CONFIG_VAR_LIST_ALIGNED_VERSION */
+  UINT16    Version;
+
+  /* Size of this header in bytes, the entry descriptors start right after it */
+  UINT16    HeaderSize;
+
+  /* Number of CONFIG_VAR_LIST_ALIGNED_ENTRY descriptors */
+  UINT32    EntryCount;
+
+  /* Offset and size in bytes of the name region, from the start of the buffer */
+  UINT32    NamesOffset;
+  UINT32    NamesSize;
+
+  /* Offset and size in bytes of the data region, from the start of the buffer. The data region ends the buffer. */
+  UINT32    DataOffset;
+  UINT32    DataSize;
+
+  /* CRC32 of all bytes from the end of this header to the end of the data region */
+  UINT32    Crc32;
+} CONFIG_VAR_LIST_ALIGNED_HDR;
+
+typedef struct {
+  /* namespace Guid */
+  EFI_GUID    Guid;
+
+  /* UEFI attributes */
+  UINT32      Attributes;
+
+  /* Offset from the start of the name region and size in bytes of the null terminated UTF-16LE name */
+  UINT32      NameOffset;
+  UINT32      NameSize;
+
+  /* Offset from the start of the data region and size in bytes of the variable value */
+  UINT32      DataOffset;
+  UINT32      DataSize;
+
+  /* Must be 0 */
+  UINT32      Reserved;
+} CONFIG_VAR_LIST_ALIGNED_ENTRY;
+
+/*
+ * Alternate, compressed variable list format, for storage and transport. A single header is followed
+ * by a LZ block holding the dictionary, GuidCount EFI_GUIDs followed by the null terminated UTF-16LE
+ * names of all entries, then by EntryCount entry records. Each record is the varints GuidIndex,
+ * NameOffset (from the first name of the dictionary), NameSize, Attributes and DataSize, followed by
+ * a LZ block holding the DataSize bytes of the value.
+ *
+ * Varints are unsigned LEB128 values of up to 32 bits. A LZ block is a sequence of tokens: a token
+ * below CONFIG_VAR_LIST_LZ_MATCH_FLAG is followed by token + 1 literal bytes, any other token is
+ * followed by a varint distance and copies (token & ~CONFIG_VAR_LIST_LZ_MATCH_FLAG) +
+ * CONFIG_VAR_LIST_LZ_MIN_MATCH bytes from that distance back in the same block, which may overlap
+ * the bytes being copied.
+ *
+ * Buffers starting with CONFIG_VAR_LIST_COMPRESSED_SIGNATURE are only read by ConfigVarListStreamNext,
+ * or by the functions allocating a copy of their entries.
+ */
+#define CONFIG_VAR_LIST_COMPRESSED_SIGNATURE  SIGNATURE_32 ('C', 'V', 'L', 'Z')
+#define CONFIG_VAR_LIST_COMPRESSED_VERSION    2
+#define CONFIG_VAR_LIST_LZ_MATCH_FLAG         0x80
+#define CONFIG_VAR_LIST_LZ_MIN_MATCH          3
+
+typedef struct {
+  /* CONFIG_VAR_LIST_COMPRESSED_SIGNATURE */
+  UINT32    Signature;
+
+  /* CONFIG_VAR_LIST_COMPRESSED_VERSION */
+  UINT16    Version;
+
+  /* Size of this header in bytes, the dictionary block starts right after it */
+  UINT16    HeaderSize;
+
+  /* Number of entry records */
+  UINT32    EntryCount;
+
+  /* Number of EFI_GUIDs at the start of the dictionary */
+  UINT32    GuidCount;
+
+  /* Size in bytes of the decompressed dictionary, at most PackedSize */
+  UINT32    DictionarySize;
+
+  /* Size in bytes of the largest entry in the packed format, at most PackedSize */
+  UINT32    MaxEntrySize;
+
+  /* Size in bytes of all entries in the packed format */
+  UINT32    PackedSize;
+
+  /* CRC32 of the whole buffer, this header included with Crc32 taken as 0 */
+  UINT32    Crc32;
+} CONFIG_VAR_LIST_COMPRESSED_HDR;
+
+/*
+ * Read-only view of a single variable list entry. All pointers reference the
+ * original variable list buffer, they must not be freed and are only valid as
+ * long as that buffer is. The entries are packed, so pointers may be unaligned.
+ */
+typedef struct {
+  CONST CHAR16      *Name;
+  UINT32            NameSize;
+  CONST EFI_GUID    *Guid;
+  UINT32            Attributes;
+  CONST VOID        *Data;
+  UINT32            DataSize;
+
+  /* Start and total size of the raw variable list entry, including its header and CRC32 */
+  CONST VOID        *Raw;
+  UINT32            RawSize;
+} CONFIG_VAR_LIST_ENTRY_VIEW;
+
+/*
+ * Cursor used to walk a packed or aligned variable list buffer in place. Callers should treat the
+ * content as opaque and only use ConfigVarListIterInit/ConfigVarListIterNext.
+ */
+typedef struct {
+  CONST UINT8                        *Buffer;
+  UINTN                              BufferSize;
+  UINTN                              Offset;     // Next packed entry
+  CONST CONFIG_VAR_LIST_ALIGNED_HDR  *AlignedHdr; // NULL for a packed variable list
+  UINTN                              Index;      // Next aligned entry
+} CONFIG_VAR_LIST_ITERATOR;
+
+/*
+ * Cursor used to walk a compressed variable list buffer. Each entry is decompressed into caller provided
+ * scratch memory. Callers should treat the content as opaque and only use ConfigVarListStreamInit/
+ * ConfigVarListStreamNext.
+ */
+typedef struct {
+  CONST UINT8    *Buffer;
+  UINTN          BufferSize;
+  UINTN          Offset;
+  UINTN          Index;
+  UINTN          EntryCount;
+  UINTN          GuidCount;
+  CONST UINT8    *Dictionary;
+  UINTN          DictionarySize;
+  UINT8          *Entry;
+  UINTN          MaxEntrySize;
+  UINTN          PackedSize;
+} CONFIG_VAR_LIST_STREAM;
+
+/*
+ * Slot of a variable list index. Offset is the offset of a packed entry in the buffer, or the index of an aligned
+ * entry, biased by one so that zero marks an empty slot.
+ */
+typedef struct {
+  UINT32    Hash;
+  UINT32    Offset;
+} CONFIG_VAR_LIST_INDEX_SLOT;
+
+/*
+ * Hash index over a raw packed or aligned variable list buffer, created by BuildConfigVarListIndex and
+ * released by FreeConfigVarListIndex, or initialized over caller provided slots by
+ * InitConfigVarListIndex. Callers should treat the content as opaque.
+ */
+typedef struct {
+  CONST UINT8                          *Buffer;
+  UINTN                                BufferSize;
+  UINTN                                EntryCount;
+  UINTN                                SlotCount;
+  CONFIG_VAR_LIST_INDEX_SLOT           *Slots;
+  CONST CONFIG_VAR_LIST_ALIGNED_HDR    *AlignedHdr; // NULL for a packed variable list
+} CONFIG_VAR_LIST_INDEX;
+
 /**
   Return the size of the variable list given a NameSize (including null terminator) and DataSize
 
@@ -68,6 +249,8 @@ GetVarListSize (
 /**
   Find all active configuration variables for this platform.
 
+  The buffer may be in the packed, the aligned or the compressed variable list format.
+
   @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
   @param[in]  VariableListBufferSize  Size of VariableListBuffer.
   @param[out] ConfigVarListPtr        Pointer to configuration data. User is responsible to free the
@@ -78,6 +261,7 @@ GetVarListSize (
   @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
   @retval EFI_NOT_FOUND           The requested variable is not found in VariableListBuffer.
   @retval EFI_COMPROMISED_DATA    The variable list buffer contains data that does not fit within the structure defined.
+  @retval EFI_UNSUPPORTED         The aligned variable list buffer has an unknown version.
   @retval EFI_SUCCESS             The operation succeeds.
 
 **/
@@ -90,15 +274,94 @@ RetrieveActiveConfigVarList (
   OUT UINTN                  *ConfigVarListCount
   );
 
+/**
+  Find all active configuration variables for this platform, from a buffer whose producer
+  provides the CRC32 of the whole buffer, e.g. the generated default profile. The buffer is
+  checked against that CRC32 once, instead of checking the CRC32 of each entry.
+
+  The buffer may be in the packed, the aligned or the compressed variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]  BlobCrc32               CRC32 of all VariableListBufferSize bytes of VariableListBuffer.
+  @param[out] ConfigVarListPtr        Pointer to configuration data. User is responsible to free the
+                                      returned buffer and the Data, Name fields for each entry.
+  @param[out] ConfigVarListCount      Number of variable list entries.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null.
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_NOT_FOUND           The requested variable is not found in VariableListBuffer.
+  @retval EFI_COMPROMISED_DATA    The CRC32 of the buffer does not match BlobCrc32, or the variable
+                                  list buffer contains data that does not fit within the structure defined.
+  @retval EFI_UNSUPPORTED         The aligned variable list buffer has an unknown version.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+RetrieveActiveConfigVarListWithBlobCrc (
+  IN  CONST VOID             *VariableListBuffer,
+  IN  UINTN                  VariableListBufferSize,
+  IN  UINT32                 BlobCrc32,
+  OUT CONFIG_VAR_LIST_ENTRY  **ConfigVarListPtr,
+  OUT UINTN                  *ConfigVarListCount
+  );
+
+/**
+  Find all active configuration variables for this platform, returned in a single allocation.
+
+  The buffer is walked once to validate and size all entries, then the entry array and all
+  of its names and data are copied into one pool allocation. Each entry data is aligned to
+  8 bytes. The buffer may be in the packed, the aligned or the compressed variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[out] ConfigVarListPtr        Pointer to configuration data. User is responsible to free the
+                                      returned buffer with FreeConfigVarList only, the Name and Data
+                                      fields of the entries must not be freed separately.
+  @param[out] ConfigVarListCount      Number of variable list entries.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null.
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_NOT_FOUND           VariableListBuffer contains no entries.
+  @retval EFI_BUFFER_TOO_SMALL    The buffer does not contain a full variable list.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains data that does not fit within the structure defined.
+  @retval EFI_UNSUPPORTED         The aligned variable list buffer has an unknown version.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+RetrieveActiveConfigVarListSingleAllocation (
+  IN  CONST VOID             *VariableListBuffer,
+  IN  UINTN                  VariableListBufferSize,
+  OUT CONFIG_VAR_LIST_ENTRY  **ConfigVarListPtr,
+  OUT UINTN                  *ConfigVarListCount
+  );
+
+/**
+  Free a variable list returned by RetrieveActiveConfigVarListSingleAllocation.
+
+  @param[in]  ConfigVarList   Pointer to the variable list, may be NULL.
+
+**/
+VOID
+EFIAPI
+FreeConfigVarList (
+  IN CONFIG_VAR_LIST_ENTRY  *ConfigVarList
+  );
+
 /**
   Find specified active configuration variable for this platform.
 
+  The buffer may be in the packed, the aligned or the compressed variable list format.
+
   @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
   @param[in]  VariableListBufferSize  Size of VariableListBuffer.
   @param[in]  VarListName             NULL terminated unicode variable name of interest.
   @param[out] ConfigVarListPtr        Pointer to hold variable list entry from VariableListBuffer.
 
-  @retval EFI_UNSUPPORTED         Unsupported operation on this platform.
+  @retval EFI_UNSUPPORTED         Unsupported operation on this platform, or unknown aligned variable list version.
   @retval EFI_INVALID_PARAMETER   Input argument is null.
   @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
   @retval EFI_NOT_FOUND           The requested variable is not found in VariableListBuffer.
@@ -118,12 +381,14 @@ QuerySingleActiveConfigUnicodeVarList (
 /**
   Find specified active configuration variable for this platform.
 
+  The buffer may be in the packed, the aligned or the compressed variable list format.
+
   @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
   @param[in]  VariableListBufferSize  Size of VariableListBuffer.
   @param[in]  VarListName             NULL terminated ascii variable name of interest.
   @param[out] ConfigVarListPtr        Pointer to hold variable list entry from VariableListBuffer.
 
-  @retval EFI_UNSUPPORTED         Unsupported operation on this platform.
+  @retval EFI_UNSUPPORTED         Unsupported operation on this platform, or unknown aligned variable list version.
   @retval EFI_INVALID_PARAMETER   Input argument is null.
   @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
   @retval EFI_NOT_FOUND           The requested variable is not found in VariableListBuffer.
@@ -190,4 +455,331 @@ ConvertVariableEntryToVariableList (
   IN OUT UINTN                     *Size
   );
 
+/**
+  Initialize an iterator to walk the variable list entries of a raw packed or aligned variable list buffer
+  without allocating or copying any of the entries. The header and CRC32 of an aligned buffer are checked here.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer. Must remain valid
+                                      for as long as the iterator is in use.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[out] Iterator                Pointer to iterator to be initialized.
+
+  @retval EFI_INVALID_PARAMETER   Iterator is null, VariableListBuffer is null with a non-zero size, or the
+                                  aligned buffer is not aligned to CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT.
+  @retval EFI_UNSUPPORTED         The aligned variable list buffer has an unknown version, or the buffer is a
+                                  compressed variable list, to be read with ConfigVarListStreamNext.
+  @retval EFI_COMPROMISED_DATA    The aligned variable list header or CRC32 is corrupted.
+  @retval EFI_SUCCESS             The iterator is initialized.
+
+**/
+EFI_STATUS
+EFIAPI
+ConfigVarListIterInit (
+  IN  CONST VOID                *VariableListBuffer,
+  IN  UINTN                     VariableListBufferSize,
+  OUT CONFIG_VAR_LIST_ITERATOR  *Iterator
+  );
+
+/**
+  Validate the next variable list entry in place and return a view into the original buffer.
+  The iterator only advances when the entry is valid.
+
+  @param[in,out]  Iterator    Pointer to iterator initialized by ConfigVarListIterInit.
+  @param[out]     EntryView   Pointer to view of the next entry. Upon successful return, the
+                              pointers in this view reference the iterated buffer.
+
+  @retval EFI_INVALID_PARAMETER   One or more input arguments are null.
+  @retval EFI_NOT_FOUND           There are no more entries in the buffer.
+  @retval EFI_BUFFER_TOO_SMALL    The remaining buffer does not contain a full variable list.
+  @retval EFI_COMPROMISED_DATA    The next variable list entry has a corrupted CRC, or does not fit the regions
+                                  of an aligned variable list.
+  @retval EFI_SUCCESS             EntryView describes the next entry.
+
+**/
+EFI_STATUS
+EFIAPI
+ConfigVarListIterNext (
+  IN OUT CONFIG_VAR_LIST_ITERATOR    *Iterator,
+  OUT    CONFIG_VAR_LIST_ENTRY_VIEW  *EntryView
+  );
+
+/**
+  Check whether a raw variable list buffer is in the compressed variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+
+  @retval TRUE    The buffer starts with a compressed variable list header.
+  @retval FALSE   The buffer is in the packed or aligned variable list format.
+**/
+BOOLEAN
+EFIAPI
+IsCompressedConfigVarList (
+  IN  CONST VOID  *VariableListBuffer,
+  IN  UINTN       VariableListBufferSize
+  );
+
+/**
+  Initialize a stream to walk the entries of a compressed variable list buffer, decompressing one entry at a time
+  into caller provided scratch memory, so that the whole list is never expanded.
+
+  The header and the CRC32 of the buffer are checked here, and the dictionary is decompressed into the scratch memory.
+
+  @param[in]      VariableListBuffer      Pointer to raw compressed variable list buffer. Must remain valid for as
+                                          long as the stream is in use.
+  @param[in]      VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]      Scratch                 Scratch memory used by the stream, may be NULL to query its size. Must
+                                          remain valid for as long as the stream is in use.
+  @param[in,out]  ScratchSize             On input, the size of Scratch. On output, the size of scratch memory
+                                          the stream needs. Updated on EFI_SUCCESS and EFI_BUFFER_TOO_SMALL returns.
+  @param[out]     Stream                  Pointer to stream to be initialized.
+
+  @retval EFI_INVALID_PARAMETER   One or more input arguments are null.
+  @retval EFI_UNSUPPORTED         The buffer is not a compressed variable list, or has an unknown version.
+  @retval EFI_BUFFER_TOO_SMALL    Scratch is too small, ScratchSize is updated with the size needed.
+  @retval EFI_COMPROMISED_DATA    The header, dictionary or CRC32 of the buffer is corrupted.
+  @retval EFI_SUCCESS             The stream is initialized.
+
+**/
+EFI_STATUS
+EFIAPI
+ConfigVarListStreamInit (
+  IN      CONST VOID              *VariableListBuffer,
+  IN      UINTN                   VariableListBufferSize,
+  IN      VOID                    *Scratch OPTIONAL,
+  IN OUT  UINTN                   *ScratchSize,
+  OUT     CONFIG_VAR_LIST_STREAM  *Stream
+  );
+
+/**
+  Decompress the next entry of a compressed variable list into the scratch memory of the stream and return a view
+  of it. The entry is rebuilt in the packed variable list format, with its CRC32, so Raw and RawSize describe a
+  packed entry. The stream only advances when the entry is valid.
+
+  @param[in,out]  Stream      Pointer to stream initialized by ConfigVarListStreamInit.
+  @param[out]     EntryView   Pointer to view of the next entry. Upon successful return, the pointers in this view
+                              reference the scratch memory of the stream, and are only valid until the next call.
+
+  @retval EFI_INVALID_PARAMETER   One or more input arguments are null.
+  @retval EFI_NOT_FOUND           There are no more entries in the buffer.
+  @retval EFI_COMPROMISED_DATA    The next entry record is corrupted.
+  @retval EFI_SUCCESS             EntryView describes the next entry.
+
+**/
+EFI_STATUS
+EFIAPI
+ConfigVarListStreamNext (
+  IN OUT CONFIG_VAR_LIST_STREAM      *Stream,
+  OUT    CONFIG_VAR_LIST_ENTRY_VIEW  *EntryView
+  );
+
+/**
+  Expand a compressed variable list buffer into a newly allocated buffer holding the same entries in the packed
+  variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw compressed variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[out] PackedBuffer            Pointer to the packed variable list, to be freed by the caller with FreePool.
+  @param[out] PackedBufferSize        Size of PackedBuffer.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null.
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_COMPROMISED_DATA    The compressed variable list is corrupted.
+  @retval EFI_UNSUPPORTED         This library instance does not allocate, or the buffer is not a compressed
+                                  variable list of a known version.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+RetrieveDecompressedConfigVarList (
+  IN  CONST VOID  *VariableListBuffer,
+  IN  UINTN       VariableListBufferSize,
+  OUT VOID        **PackedBuffer,
+  OUT UINTN       *PackedBufferSize
+  );
+
+/**
+  Find specified configuration variable in a raw variable list buffer and return a view into that buffer,
+  without allocating or copying the entry.
+
+  The buffer may be in either the packed or the aligned variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]  VarName                 NULL terminated unicode variable name of interest.
+  @param[in]  VarGuid                 Namespace GUID of the variable of interest. If NULL, the first entry
+                                      in the buffer with a matching name is returned.
+  @param[out] EntryView               Pointer to view of the entry, pointing into VariableListBuffer.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null, or the aligned buffer is not aligned.
+  @retval EFI_NOT_FOUND           The requested variable is not found in VariableListBuffer.
+  @retval EFI_BUFFER_TOO_SMALL    The buffer does not contain a full variable list.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains data that does not fit within the structure defined.
+  @retval EFI_UNSUPPORTED         The aligned variable list buffer has an unknown version, or the buffer is a
+                                  compressed variable list, to be read with ConfigVarListStreamNext.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+QueryConfigVarListViewUnicode (
+  IN  CONST VOID                  *VariableListBuffer,
+  IN  UINTN                       VariableListBufferSize,
+  IN  CONST CHAR16                *VarName,
+  IN  CONST EFI_GUID              *VarGuid OPTIONAL,
+  OUT CONFIG_VAR_LIST_ENTRY_VIEW  *EntryView
+  );
+
+/**
+  Find specified configuration variable in a raw variable list buffer and return a view into that buffer,
+  without allocating or copying the entry.
+
+  The buffer may be in either the packed or the aligned variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]  VarName                 NULL terminated ascii variable name of interest.
+  @param[in]  VarGuid                 Namespace GUID of the variable of interest. If NULL, the first entry
+                                      in the buffer with a matching name is returned.
+  @param[out] EntryView               Pointer to view of the entry, pointing into VariableListBuffer.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null, or the aligned buffer is not aligned.
+  @retval EFI_NOT_FOUND           The requested variable is not found in VariableListBuffer.
+  @retval EFI_BUFFER_TOO_SMALL    The buffer does not contain a full variable list.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains data that does not fit within the structure defined.
+  @retval EFI_UNSUPPORTED         The aligned variable list buffer has an unknown version, or the buffer is a
+                                  compressed variable list, to be read with ConfigVarListStreamNext.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+QueryConfigVarListViewAscii (
+  IN  CONST VOID                  *VariableListBuffer,
+  IN  UINTN                       VariableListBufferSize,
+  IN  CONST CHAR8                 *VarName,
+  IN  CONST EFI_GUID              *VarGuid OPTIONAL,
+  OUT CONFIG_VAR_LIST_ENTRY_VIEW  *EntryView
+  );
+
+/**
+  Validate all entries of a raw packed or aligned variable list buffer once and build a hash index of them, keyed
+  on variable name and namespace GUID, so that subsequent queries do not need to rescan the buffer.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer. Must remain valid
+                                      and unchanged for as long as the index is in use.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[out] Index                   Pointer to the created index. Caller is responsible to free
+                                      it with FreeConfigVarListIndex.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null or VariableListBufferSize is 0.
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_BAD_BUFFER_SIZE     VariableListBufferSize is too large to be indexed.
+  @retval EFI_BUFFER_TOO_SMALL    The buffer does not end with a full variable list.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains an entry with a corrupted CRC.
+  @retval EFI_SUCCESS             The index is created.
+
+**/
+EFI_STATUS
+EFIAPI
+BuildConfigVarListIndex (
+  IN  CONST VOID             *VariableListBuffer,
+  IN  UINTN                  VariableListBufferSize,
+  OUT CONFIG_VAR_LIST_INDEX  **Index
+  );
+
+/**
+  Free an index created by BuildConfigVarListIndex. The indexed buffer is not freed.
+
+  @param[in]  Index   Pointer to the index to free, NULL is ignored.
+
+**/
+VOID
+EFIAPI
+FreeConfigVarListIndex (
+  IN  CONFIG_VAR_LIST_INDEX  *Index
+  );
+
+/**
+  Validate all entries of a raw packed or aligned variable list buffer once and build a hash index of them into caller
+  provided slots, without allocating. The index is queried as one created by BuildConfigVarListIndex, but must
+  not be freed with FreeConfigVarListIndex.
+
+  @param[in]      VariableListBuffer      Pointer to raw variable list buffer. Must remain valid
+                                          and unchanged for as long as the index is in use.
+  @param[in]      VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]      Slots                   Array of *SlotCount slots, may be NULL to only get the slot count.
+                                          Must remain valid for as long as the index is in use.
+  @param[in,out]  SlotCount               On input, the number of slots in Slots, a power of 2. On output,
+                                          the number of slots needed to index the buffer.
+  @param[out]     Index                   Pointer to the index to initialize.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null, VariableListBufferSize is 0 or *SlotCount is not a
+                                  power of 2.
+  @retval EFI_OUT_OF_RESOURCES    Slots is NULL or too small, *SlotCount holds the slot count needed.
+  @retval EFI_BAD_BUFFER_SIZE     VariableListBufferSize is too large to be indexed.
+  @retval EFI_BUFFER_TOO_SMALL    The buffer does not end with a full variable list.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains an entry with a corrupted CRC.
+  @retval EFI_SUCCESS             The index is initialized.
+
+**/
+EFI_STATUS
+EFIAPI
+InitConfigVarListIndex (
+  IN      CONST VOID                  *VariableListBuffer,
+  IN      UINTN                       VariableListBufferSize,
+  IN      CONFIG_VAR_LIST_INDEX_SLOT  *Slots OPTIONAL,
+  IN OUT  UINTN                       *SlotCount,
+  OUT     CONFIG_VAR_LIST_INDEX       *Index
+  );
+
+/**
+  Find specified configuration variable through an index built by BuildConfigVarListIndex or
+  InitConfigVarListIndex.
+
+  @param[in]  Index       Pointer to index of the variable list buffer.
+  @param[in]  VarName     NULL terminated unicode variable name of interest.
+  @param[in]  VarGuid     Namespace GUID of the variable of interest. If NULL, the first entry
+                          in the buffer with a matching name is returned.
+  @param[out] EntryView   Pointer to view of the entry, pointing into the indexed buffer.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null.
+  @retval EFI_NOT_FOUND           The requested variable is not found in the index.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+QueryConfigVarListIndexUnicode (
+  IN  CONST CONFIG_VAR_LIST_INDEX  *Index,
+  IN  CONST CHAR16                 *VarName,
+  IN  CONST EFI_GUID               *VarGuid OPTIONAL,
+  OUT CONFIG_VAR_LIST_ENTRY_VIEW   *EntryView
+  );
+
+/**
+  Find specified configuration variable through an index built by BuildConfigVarListIndex or
+  InitConfigVarListIndex.
+
+  @param[in]  Index       Pointer to index of the variable list buffer.
+  @param[in]  VarName     NULL terminated ascii variable name of interest.
+  @param[in]  VarGuid     Namespace GUID of the variable of interest. If NULL, the first entry
+                          in the buffer with a matching name is returned.
+  @param[out] EntryView   Pointer to view of the entry, pointing into the indexed buffer.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null.
+  @retval EFI_NOT_FOUND           The requested variable is not found in the index.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+QueryConfigVarListIndexAscii (
+  IN  CONST CONFIG_VAR_LIST_INDEX  *Index,
+  IN  CONST CHAR8                  *VarName,
+  IN  CONST EFI_GUID               *VarGuid OPTIONAL,
+  OUT CONFIG_VAR_LIST_ENTRY_VIEW   *EntryView
+  );
+
 #endif // CONFIG_VAR_LIST_LIB_H_
@@ -18,11 +18,93 @@
 
 extern KNOB_DATA  gKnobData[];
 extern UINTN      gNumKnobs;
+// the config policies the knobs are published in, policies larger than MAX_UINT16 are split across several
+extern CONFIG_POLICY_RANGE  gConfigPolicyRanges[];
+extern UINTN                gNumConfigPolicies;
 extern PROFILE    gProfileData[];
 // number of profile overrides (i.e. into gProfileData)
 // this does not count the generic profile, which is not
 // in gProfileData, but rather in gKnobData's defaults
 extern UINTN  gNumProfiles;
 extern CHAR8  *gProfileFlavorNames[];
+// profiles generated with KnobService.py --bitmapprofiles, in place of gProfileData
+extern PROFILE_BITMAP  gProfileBitmapData[];
+// precomputed config policies generated with KnobService.py --policyblobs, one per profile followed by the generic
+// profile at index gNumProfiles
+extern PROFILE_POLICY  gProfilePolicyData[];
+
+/**
+  Find a config knob by its namespace and name.
+
+  The autogenerated data header implements this with a minimal perfect hash over the knobs in gKnobData, so the
+  lookup costs one hash and one compare regardless of the number of knobs.
+
+  @param[in]  VendorNamespace   The GUID namespace of the knob.
+  @param[in]  Name              The null terminated ASCII name of the knob.
+
+  @retval NULL                  VendorNamespace or Name is NULL, or no such knob exists.
+  @retval Others                The entry in gKnobData describing the knob.
+
+**/
+KNOB_DATA *
+LookupKnobByName (
+  IN CONST EFI_GUID  *VendorNamespace,
+  IN CONST CHAR8     *Name
+  );
+
+/**
+  Validate every knob in a KNOB_VALUES structure, such as the cached knob values.
+
+  The autogenerated data header implements this when generated with KnobService.py --constrainttable. It checks the
+  leaves of every knob against a single table of constraints in one loop, instead of calling the Validator of each
+  knob.
+
+  @param[in]  KnobValues        The KNOB_VALUES structure to validate.
+
+  @retval TRUE                  Every knob value meets its constraints.
+  @retval FALSE                 At least one knob value is out of range or not a value of its enum.
+
+**/
+BOOLEAN
+ValidateKnobValues (
+  IN CONST VOID  *KnobValues
+  );
+
+/**
+  Apply the overrides of a bitmap encoded profile to the cached knob values.
+
+  The autogenerated profile header implements this when generated with KnobService.py --bitmapprofiles. It walks the
+  bitmap once, copying each overridden value from the packed value stream to the CacheValueAddress of its knob.
+
+  @param[in]  Profile           The profile to apply, an entry of gProfileBitmapData.
+
+  @retval TRUE                  Every override of the profile was applied.
+  @retval FALSE                 Profile is NULL or the terminating entry, its values do not match the knobs, or an
+                                overridden knob has no cache.
+
+**/
+BOOLEAN
+ApplyProfileBitmap (
+  IN CONST PROFILE_BITMAP  *Profile
+  );
+
+/**
+  Get the precomputed config policy of a profile.
+
+  The autogenerated profile header implements this when generated with KnobService.py --policyblobs. The returned
+  policy is ready to be published as is, so a policy creator on the default path does not need to merge the profile
+  into gKnobData or serialize and checksum the result.
+
+  @param[in]  ProfileIndex      The profile index, as returned by GetActiveProfileIndex. Any index that is not a
+                                profile, including GENERIC_PROFILE_INDEX, selects the generic profile.
+
+  @retval NULL                  The platform data has no precomputed policies.
+  @retval Others                The config policy of the profile.
+
+**/
+CONST PROFILE_POLICY *
+GetProfilePolicy (
+  IN UINT32  ProfileIndex
+  );
 
 #endif // PLATFORM_CONFIG_DATA_LIB_H_
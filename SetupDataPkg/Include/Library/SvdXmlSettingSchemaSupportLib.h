@@ -40,6 +40,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 #define RESULTS_PACKET_ELEMENT_NAME          "ResultsPacket"
 #define RESULTS_APPLIED_ON_ELEMENT_NAME      "AppliedOn"
+#define RESULTS_FLASH_WRITES_ELEMENT_NAME    "FlashWrites"
 #define RESULTS_SETTINGS_LIST_ELEMENT_NAME   SETTINGS_LIST_ELEMENT_NAME
 #define RESULTS_SETTING_ELEMENT_NAME         "SettingResult"
 #define RESULTS_SETTING_ID_ELEMENT_NAME      "Id"
@@ -135,6 +136,87 @@ AddSettingsLsvNode (
   IN CONST CHAR8    *Lsv
   );
 
+/**
+Add the <FlashWrites> element to a ResultsPacket, counting the variable writes issued to apply it.
+
+@param[in] ResultsPacketNode:  The <ResultsPacket> element node
+@param[in] FlashWrites:        Decimal string of the number of writes
+
+@retval Success if created and added to the xml successfully
+@retval Error if it could not be created or added to the xml
+**/
+EFI_STATUS
+EFIAPI
+AddResultsFlashWritesNode (
+  IN CONST XmlNode  *ResultsPacketNode,
+  IN CONST CHAR8    *FlashWrites
+  );
+
+/**
+State of a pull reader over a Settings Input XML packet, see SvdSettingsReaderInit.
+All members are private to the library, except Version and Lsv once initialized.
+**/
+typedef struct {
+  CONST CHAR8    *Buffer;
+  UINTN          BufferSize;
+  UINTN          SettingsOffset; // Just past the Settings start tag
+  BOOLEAN        SettingsEmpty;  // <Settings/>
+  UINTN          Offset;         // Next setting
+  UINTN          Version;        // Version of the packet
+  UINTN          Lsv;            // LowestSupportedVersion of the packet
+} SVD_SETTINGS_READER;
+
+/**
+Start reading a Settings Input XML packet.
+
+The whole packet structure is checked, and the Version and LowestSupportedVersion are read,
+but none of the settings are decoded until SvdSettingsReaderNext is called. No XML tree is
+built and nothing is allocated.
+
+@param[out] Reader:       Reader to initialize
+@param[in]  Buffer:       Packet buffer, must remain valid while the reader is in use
+@param[in]  BufferSize:   Size of Buffer, excluding any NULL terminator
+
+@retval EFI_SUCCESS           The reader is positioned before the first setting.
+@retval EFI_INVALID_PARAMETER An argument is NULL.
+@retval EFI_NOT_FOUND         The packet does not have a Version, LowestSupportedVersion or Settings element.
+@retval EFI_COMPROMISED_DATA  The packet is not well formed, or a version is not decimal.
+@retval EFI_UNSUPPORTED       The packet uses XML features not supported by the reader.
+**/
+EFI_STATUS
+EFIAPI
+SvdSettingsReaderInit (
+  OUT SVD_SETTINGS_READER  *Reader,
+  IN  CONST CHAR8          *Buffer,
+  IN  UINTN                BufferSize
+  );
+
+/**
+Read the next setting of a Settings Input XML packet.
+
+Don't free the outputs as they point into the packet buffer. They are not NULL terminated.
+
+@param[in,out]  Reader:       Reader initialized by SvdSettingsReaderInit
+@param[out]     Id:           Updated to point to the Id of the setting
+@param[out]     IdLength:     Length of Id
+@param[out]     Value:        Updated to point to the Value of the setting
+@param[out]     ValueLength:  Length of Value
+
+@retval EFI_SUCCESS           Id and Value describe the next setting.
+@retval EFI_INVALID_PARAMETER An argument is NULL.
+@retval EFI_NOT_FOUND         There are no more settings.
+@retval EFI_COMPROMISED_DATA  The next setting has no Id or Value, or is not well formed.
+**/
+EFI_STATUS
+EFIAPI
+SvdSettingsReaderNext (
+  IN OUT SVD_SETTINGS_READER  *Reader,
+  OUT    CONST CHAR8          **Id,
+  OUT    UINTN                *IdLength,
+  OUT    CONST CHAR8          **Value,
+  OUT    UINTN                *ValueLength
+  );
+
 // ***************************** EXAMPLE SETTINGS PACKET (INTPUT TO UEFI) *******************************//
 
 /*
@@ -189,6 +271,7 @@ AddSettingsLsvNode (
       <Result>0x0</Result>
     </SettingResult>
   </Settings>
+  <FlashWrites>2</FlashWrites>
 </ResultsPacket>
 */
 
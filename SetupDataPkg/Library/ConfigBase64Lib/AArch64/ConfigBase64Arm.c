@@ -0,0 +1,129 @@
+/** @file
+  Base64 acceleration for AARCH64 with Advanced SIMD, which is architectural, so it needs no check. The
+  blocks are converted by ConfigBase64Neon.S, 48 bytes and 64 characters at a time.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <Base.h>
+
+#include "../ConfigBase64LibInternal.h"
+
+// Characters and bytes of a block
+#define B64_BLOCK_CHARACTERS  64
+#define B64_BLOCK_BYTES       48
+
+/**
+  Encode blocks of 48 bytes into 64 characters.
+
+  @param[in]  Source        Pointer to the binary data.
+  @param[in]  Blocks        Number of blocks to encode, at least 1.
+  @param[out] Destination   Pointer to the output buffer.
+  @param[in]  Alphabet      The 64 characters of the alphabet.
+
+  @return The number of blocks encoded, which is Blocks.
+**/
+UINTN
+ConfigBase64EncodeNeon (
+  IN  CONST UINT8  *Source,
+  IN  UINTN        Blocks,
+  OUT CHAR8        *Destination,
+  IN  CONST CHAR8  *Alphabet
+  );
+
+/**
+  Decode blocks of 64 characters into 48 bytes, up to the first block holding a character outside of the
+  alphabet. That block is not written.
+
+  @param[in]  Source        Pointer to the Base64 encoding.
+  @param[in]  Blocks        Number of blocks to decode, at least 1.
+  @param[out] Destination   Pointer to the output buffer.
+  @param[in]  DecodeTable   The first 128 entries of mConfigBase64DecodeTable.
+
+  @return The number of blocks decoded.
+**/
+UINTN
+ConfigBase64DecodeNeon (
+  IN  CONST CHAR8  *Source,
+  IN  UINTN        Blocks,
+  OUT UINT8        *Destination,
+  IN  CONST UINT8  *DecodeTable
+  );
+
+/**
+  Check whether the running CPU supports the Base64 acceleration of this architecture.
+
+  @retval TRUE    ConfigBase64EncodeAccelerated and ConfigBase64DecodeAccelerated may be called.
+  @retval FALSE   There is no acceleration.
+**/
+BOOLEAN
+ConfigBase64AccelerationSupported (
+  VOID
+  )
+{
+  return TRUE;
+}
+
+/**
+  Encode the leading whole blocks of binary data with the Base64 acceleration of the running CPU.
+  Implementations may leave a tail of the data unprocessed, which the caller finishes, so the number of bytes
+  processed is always a multiple of 3.
+
+  @param[in]      Source        Pointer to the binary data.
+  @param[in,out]  SourceLength  On input, size of Source in bytes. On output, the number of bytes at the end
+                                of Source that were not processed.
+  @param[out]     Destination   Pointer to the output buffer, with room for the encoding of all of Source.
+
+  @return The number of characters written to Destination.
+**/
+UINTN
+ConfigBase64EncodeAccelerated (
+  IN     CONST UINT8  *Source,
+  IN OUT UINTN        *SourceLength,
+  OUT    CHAR8        *Destination
+  )
+{
+  UINTN  Blocks;
+
+  Blocks = *SourceLength / B64_BLOCK_BYTES;
+  if (Blocks == 0) {
+    return 0;
+  }
+
+  Blocks         = ConfigBase64EncodeNeon (Source, Blocks, Destination, mConfigBase64Alphabet);
+  *SourceLength -= Blocks * B64_BLOCK_BYTES;
+  return Blocks * B64_BLOCK_CHARACTERS;
+}
+
+/**
+  Decode the leading whole blocks of a Base64 encoding with the Base64 acceleration of the running CPU. A
+  block holding any character outside of the alphabet, e.g. whitespace or padding, ends the processing, so
+  the number of characters processed is always a multiple of 4 and all of them are alphabet characters.
+
+  @param[in]      Source        Pointer to the Base64 encoding.
+  @param[in,out]  SourceSize    On input, number of characters in Source. On output, the number of characters
+                                at the end of Source that were not processed.
+  @param[out]     Destination   Pointer to the output buffer, with room for the decoded data of Source. Only
+                                the bytes decoded are written.
+
+  @return The number of bytes written to Destination.
+**/
+UINTN
+ConfigBase64DecodeAccelerated (
+  IN     CONST CHAR8  *Source,
+  IN OUT UINTN        *SourceSize,
+  OUT    UINT8        *Destination
+  )
+{
+  UINTN  Blocks;
+
+  Blocks = *SourceSize / B64_BLOCK_CHARACTERS;
+  if (Blocks == 0) {
+    return 0;
+  }
+
+  Blocks       = ConfigBase64DecodeNeon (Source, Blocks, Destination, mConfigBase64DecodeTable);
+  *SourceSize -= Blocks * B64_BLOCK_CHARACTERS;
+  return Blocks * B64_BLOCK_BYTES;
+}
@@ -0,0 +1,394 @@
+/** @file
+  Library instance to encode and decode the Base64 data of configuration settings. Uses the vector
+  instructions of the CPU for the bulk of the data when they are available, and a table driven
+  conversion otherwise and for the tails.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <Uefi.h>
+#include <Library/DebugLib.h>
+#include <Library/ConfigBase64Lib.h>
+
+#include "ConfigBase64LibInternal.h"
+
+// The Base64 alphabet of RFC 4648, indexed by 6 bit value
+CONST CHAR8  mConfigBase64Alphabet[64] = {
+  'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
+  'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
+  'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
+  'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'
+};
+
+// The 6 bit value of each ASCII character. The whitespace skipped by Base64Decode of BaseLib is
+// CONFIG_BASE64_SPACE: horizontal tab, new line, vertical tab, form feed, carriage return and space.
+CONST UINT8  mConfigBase64DecodeTable[256] = {
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xFE, 0xFE, 0xFE, 0xFE, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F,
+  0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFD, 0xFF, 0xFF,
+  0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+  0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+  0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
+/**
+  Check whether two buffers overlap.
+
+  @param[in]  First       Start of the first buffer.
+  @param[in]  FirstSize   Size of the first buffer in bytes.
+  @param[in]  Second      Start of the second buffer.
+  @param[in]  SecondSize  Size of the second buffer in bytes.
+
+  @retval TRUE    The buffers overlap.
+  @retval FALSE   The buffers do not overlap.
+**/
+STATIC
+BOOLEAN
+ConfigBase64Overlaps (
+  IN CONST VOID  *First,
+  IN UINTN       FirstSize,
+  IN CONST VOID  *Second,
+  IN UINTN       SecondSize
+  )
+{
+  if ((FirstSize == 0) || (SecondSize == 0)) {
+    return FALSE;
+  }
+
+  return ((UINTN)First < (UINTN)Second + SecondSize) && ((UINTN)Second < (UINTN)First + FirstSize);
+}
+
+/**
+  Get the size of the Base64 encoding of binary data.
+
+  @param[in]  SourceLength  Size of the binary data in bytes.
+
+  @return The number of ASCII characters of the encoding, including the NULL terminator, or 0 if the
+          encoding would not fit a UINTN.
+**/
+UINTN
+EFIAPI
+ConfigBase64EncodedSize (
+  IN UINTN  SourceLength
+  )
+{
+  UINTN  Quanta;
+
+  Quanta = SourceLength / 3 + ((SourceLength % 3) != 0);
+  if (Quanta > (MAX_UINTN - 1) / 4) {
+    return 0;
+  }
+
+  return Quanta * 4 + 1;
+}
+
+/**
+  Get the size of the binary data decoded from a Base64 encoding, from the length of the encoding and its
+  trailing padding only.
+
+  The size is exact for an encoding without whitespace, as written by ConfigBase64Encode, and an upper bound
+  of the decoded size otherwise. A buffer of this size is always large enough for ConfigBase64Decode.
+
+  @param[in]  Source      Pointer to the Base64 encoding, may be NULL if SourceSize is 0.
+  @param[in]  SourceSize  Number of ASCII characters in Source, not including any NULL terminator.
+
+  @return The number of bytes ConfigBase64Decode needs for the decoded data.
+**/
+UINTN
+EFIAPI
+ConfigBase64DecodedSize (
+  IN CONST CHAR8  *Source OPTIONAL,
+  IN UINTN        SourceSize
+  )
+{
+  UINTN  PadCount;
+  UINTN  Size;
+
+  if (Source == NULL) {
+    return 0;
+  }
+
+  // Whitespace may trail the padding, and the last quantum is the one padded
+  while ((SourceSize > 0) && (mConfigBase64DecodeTable[(UINT8)Source[SourceSize - 1]] == CONFIG_BASE64_SPACE)) {
+    SourceSize--;
+  }
+
+  PadCount = 0;
+  while ((PadCount < 2) && (SourceSize > PadCount) && (Source[SourceSize - 1 - PadCount] == '=')) {
+    PadCount++;
+  }
+
+  Size = (SourceSize / 4) * 3;
+  return (Size >= PadCount) ? Size - PadCount : 0;
+}
+
+/**
+  Encode binary data into a NULL terminated Base64 ASCII string, as Base64Encode of BaseLib does.
+
+  @param[in]      Source           Pointer to the binary data, may be NULL if SourceLength is 0.
+  @param[in]      SourceLength     Size of the binary data in bytes.
+  @param[out]     Destination      Pointer to the output buffer, may be NULL if *DestinationSize is 0.
+  @param[in,out]  DestinationSize  On input, the size of Destination in characters. On output, the number of
+                                   characters of the encoding including the NULL terminator, see
+                                   ConfigBase64EncodedSize.
+
+  @retval EFI_SUCCESS             The data was encoded.
+  @retval EFI_BUFFER_TOO_SMALL    Destination is too small, *DestinationSize holds the size needed.
+  @retval EFI_INVALID_PARAMETER   Source or Destination is NULL while its size is not 0, DestinationSize is
+                                  NULL, the buffers overlap or the encoding would not fit a UINTN.
+**/
+EFI_STATUS
+EFIAPI
+ConfigBase64Encode (
+  IN     CONST UINT8  *Source OPTIONAL,
+  IN     UINTN        SourceLength,
+  OUT    CHAR8        *Destination OPTIONAL,
+  IN OUT UINTN        *DestinationSize
+  )
+{
+  UINTN   EncodedSize;
+  UINTN   Index;
+  UINTN   Length;
+  UINTN   LeftLength;
+  UINT32  Quantum;
+
+  if ((DestinationSize == NULL) || ((Source == NULL) && (SourceLength != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  EncodedSize = ConfigBase64EncodedSize (SourceLength);
+  if (EncodedSize == 0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (*DestinationSize < EncodedSize) {
+    *DestinationSize = EncodedSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  if ((Destination == NULL) || ConfigBase64Overlaps (Source, SourceLength, Destination, EncodedSize)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Index  = 0;
+  Length = 0;
+  if ((SourceLength >= CONFIG_BASE64_ACCEL_MIN_LENGTH) && ConfigBase64AccelerationSupported ()) {
+    LeftLength = SourceLength;
+    Length     = ConfigBase64EncodeAccelerated (Source, &LeftLength, Destination);
+    Index      = SourceLength - LeftLength;
+  }
+
+  while (SourceLength - Index >= 3) {
+    Quantum = ((UINT32)Source[Index] << 16) | ((UINT32)Source[Index + 1] << 8) | Source[Index + 2];
+
+    Destination[Length]     = mConfigBase64Alphabet[(Quantum >> 18) & 0x3F];
+    Destination[Length + 1] = mConfigBase64Alphabet[(Quantum >> 12) & 0x3F];
+    Destination[Length + 2] = mConfigBase64Alphabet[(Quantum >> 6) & 0x3F];
+    Destination[Length + 3] = mConfigBase64Alphabet[Quantum & 0x3F];
+
+    Index  += 3;
+    Length += 4;
+  }
+
+  if (SourceLength - Index > 0) {
+    Quantum = (UINT32)Source[Index] << 16;
+    if (SourceLength - Index > 1) {
+      Quantum |= (UINT32)Source[Index + 1] << 8;
+    }
+
+    Destination[Length]     = mConfigBase64Alphabet[(Quantum >> 18) & 0x3F];
+    Destination[Length + 1] = mConfigBase64Alphabet[(Quantum >> 12) & 0x3F];
+    Destination[Length + 2] = (SourceLength - Index > 1) ? mConfigBase64Alphabet[(Quantum >> 6) & 0x3F] : '=';
+    Destination[Length + 3] = '=';
+
+    Length += 4;
+  }
+
+  ASSERT (Length + 1 == EncodedSize);
+  Destination[Length] = '\0';
+  *DestinationSize    = EncodedSize;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Validate and decode a Base64 encoding in a single pass.
+
+  @param[in]  Source        Pointer to the Base64 encoding.
+  @param[in]  SourceSize    Number of characters in Source.
+  @param[out] Destination   Pointer to the output buffer, large enough for the decoded data. NULL to only
+                            validate the encoding and measure the decoded data.
+  @param[out] DecodedSize   The number of bytes of the decoded data.
+
+  @retval EFI_SUCCESS             The encoding is valid.
+  @retval EFI_INVALID_PARAMETER   Source is not a valid Base64 encoding.
+**/
+STATIC
+EFI_STATUS
+ConfigBase64DecodeInternal (
+  IN  CONST CHAR8  *Source,
+  IN  UINTN        SourceSize,
+  OUT UINT8        *Destination OPTIONAL,
+  OUT UINTN        *DecodedSize
+  )
+{
+  BOOLEAN  Accelerated;
+  BOOLEAN  TryAccelerated;
+  UINT32   Quantum;
+  UINTN    QuantumLength;
+  UINTN    PadCount;
+  UINTN    Index;
+  UINTN    Length;
+  UINTN    LeftSize;
+  UINT8    Value;
+
+  Accelerated    = (Destination != NULL) && (SourceSize >= CONFIG_BASE64_ACCEL_MIN_LENGTH) &&
+                   ConfigBase64AccelerationSupported ();
+  TryAccelerated = Accelerated;
+  Quantum        = 0;
+  QuantumLength  = 0;
+  PadCount       = 0;
+  Index          = 0;
+  Length         = 0;
+
+  while (Index < SourceSize) {
+    if (TryAccelerated) {
+      TryAccelerated = FALSE;
+      LeftSize       = SourceSize - Index;
+      Length        += ConfigBase64DecodeAccelerated (Source + Index, &LeftSize, Destination + Length);
+      Index          = SourceSize - LeftSize;
+      continue;
+    }
+
+    Value = mConfigBase64DecodeTable[(UINT8)Source[Index++]];
+    if (Value < 64) {
+      if (PadCount != 0) {
+        return EFI_INVALID_PARAMETER;
+      }
+
+      Quantum = (Quantum << 6) | Value;
+      if (++QuantumLength == 4) {
+        if (Destination != NULL) {
+          Destination[Length]     = (UINT8)(Quantum >> 16);
+          Destination[Length + 1] = (UINT8)(Quantum >> 8);
+          Destination[Length + 2] = (UINT8)Quantum;
+        }
+
+        Length       += 3;
+        Quantum       = 0;
+        QuantumLength = 0;
+      }
+    } else if (Value == CONFIG_BASE64_SPACE) {
+      // Whitespace between whole quanta, e.g. line breaks, may be followed by more whole blocks
+      TryAccelerated = Accelerated && (QuantumLength == 0) && (PadCount == 0);
+    } else if (Value == CONFIG_BASE64_PAD) {
+      // Padding completes a last quantum of 2 or 3 characters
+      PadCount++;
+      if ((QuantumLength < 2) || (QuantumLength + PadCount > 4)) {
+        return EFI_INVALID_PARAMETER;
+      }
+    } else {
+      return EFI_INVALID_PARAMETER;
+    }
+  }
+
+  if ((PadCount == 0) ? (QuantumLength != 0) : (QuantumLength + PadCount != 4)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (QuantumLength == 2) {
+    if (Destination != NULL) {
+      Destination[Length] = (UINT8)(Quantum >> 4);
+    }
+
+    Length += 1;
+  } else if (QuantumLength == 3) {
+    if (Destination != NULL) {
+      Destination[Length]     = (UINT8)(Quantum >> 10);
+      Destination[Length + 1] = (UINT8)(Quantum >> 2);
+    }
+
+    Length += 2;
+  }
+
+  *DecodedSize = Length;
+  return EFI_SUCCESS;
+}
+
+/**
+  Decode a Base64 ASCII string into binary data, as Base64Decode of BaseLib does: whitespace is ignored at all
+  positions and at most two padding characters may end the encoding.
+
+  When *DestinationSize is at least ConfigBase64DecodedSize, the data is validated and decoded in a single
+  pass. Otherwise the encoding is first measured, as it may hold whitespace that makes the data fit.
+
+  @param[in]      Source           Pointer to the Base64 encoding, may be NULL if SourceSize is 0.
+  @param[in]      SourceSize       Number of ASCII characters in Source, not including any NULL terminator.
+  @param[out]     Destination      Pointer to the output buffer, may be NULL if *DestinationSize is 0.
+  @param[in,out]  DestinationSize  On input, the size of Destination in bytes. On output, the number of bytes
+                                   decoded, or needed when EFI_BUFFER_TOO_SMALL is returned.
+
+  @retval EFI_SUCCESS             The data was decoded.
+  @retval EFI_BUFFER_TOO_SMALL    Destination is too small, *DestinationSize holds the size needed.
+  @retval EFI_INVALID_PARAMETER   Source or Destination is NULL while its size is not 0, DestinationSize is
+                                  NULL, the buffers overlap or Source is not a valid Base64 encoding. The
+                                  contents of Destination are undefined.
+**/
+EFI_STATUS
+EFIAPI
+ConfigBase64Decode (
+  IN     CONST CHAR8  *Source OPTIONAL,
+  IN     UINTN        SourceSize,
+  OUT    UINT8        *Destination OPTIONAL,
+  IN OUT UINTN        *DestinationSize
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       DecodedSize;
+
+  if ((DestinationSize == NULL) || ((Source == NULL) && (SourceSize != 0)) ||
+      ((Destination == NULL) && (*DestinationSize != 0)))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (ConfigBase64Overlaps (Source, SourceSize, Destination, *DestinationSize)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (*DestinationSize < ConfigBase64DecodedSize (Source, SourceSize)) {
+    Status = ConfigBase64DecodeInternal (Source, SourceSize, NULL, &DecodedSize);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (*DestinationSize < DecodedSize) {
+      *DestinationSize = DecodedSize;
+      return EFI_BUFFER_TOO_SMALL;
+    }
+  }
+
+  if (SourceSize == 0) {
+    *DestinationSize = 0;
+    return EFI_SUCCESS;
+  }
+
+  Status = ConfigBase64DecodeInternal (Source, SourceSize, Destination, &DecodedSize);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  *DestinationSize = DecodedSize;
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,79 @@
+/** @file
+  Internal definitions shared by the ConfigBase64Lib sources.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef CONFIG_BASE64_LIB_INTERNAL_H_
+#define CONFIG_BASE64_LIB_INTERNAL_H_
+
+//
+// Values of mConfigBase64DecodeTable other than the 6 bit values of the alphabet. All of them have the high bit
+// set, so that a vectorized lookup can reject a block by testing that bit alone.
+//
+#define CONFIG_BASE64_PAD      0xFD
+#define CONFIG_BASE64_SPACE    0xFE
+#define CONFIG_BASE64_INVALID  0xFF
+
+// The vector instructions only pay off, and CPUID is only worth its cost, for data of at least this size
+#define CONFIG_BASE64_ACCEL_MIN_LENGTH  64
+
+// The Base64 alphabet of RFC 4648, indexed by 6 bit value
+extern CONST CHAR8  mConfigBase64Alphabet[64];
+
+// The 6 bit value of each ASCII character, or one of the values above
+extern CONST UINT8  mConfigBase64DecodeTable[256];
+
+/**
+  Check whether the running CPU supports the Base64 acceleration of this architecture.
+
+  @retval TRUE    ConfigBase64EncodeAccelerated and ConfigBase64DecodeAccelerated may be called.
+  @retval FALSE   There is no acceleration.
+**/
+BOOLEAN
+ConfigBase64AccelerationSupported (
+  VOID
+  );
+
+/**
+  Encode the leading whole blocks of binary data with the Base64 acceleration of the running CPU.
+  Implementations may leave a tail of the data unprocessed, which the caller finishes, so the number of bytes
+  processed is always a multiple of 3.
+
+  @param[in]      Source        Pointer to the binary data.
+  @param[in,out]  SourceLength  On input, size of Source in bytes. On output, the number of bytes at the end
+                                of Source that were not processed.
+  @param[out]     Destination   Pointer to the output buffer, with room for the encoding of all of Source.
+
+  @return The number of characters written to Destination.
+**/
+UINTN
+ConfigBase64EncodeAccelerated (
+  IN     CONST UINT8  *Source,
+  IN OUT UINTN        *SourceLength,
+  OUT    CHAR8        *Destination
+  );
+
+/**
+  Decode the leading whole blocks of a Base64 encoding with the Base64 acceleration of the running CPU. A
+  block holding any character outside of the alphabet, e.g. whitespace or padding, ends the processing, so
+  the number of characters processed is always a multiple of 4 and all of them are alphabet characters.
+
+  @param[in]      Source        Pointer to the Base64 encoding.
+  @param[in,out]  SourceSize    On input, number of characters in Source. On output, the number of characters
+                                at the end of Source that were not processed.
+  @param[out]     Destination   Pointer to the output buffer, with room for the decoded data of Source. Only
+                                the bytes decoded are written.
+
+  @return The number of bytes written to Destination.
+**/
+UINTN
+ConfigBase64DecodeAccelerated (
+  IN     CONST CHAR8  *Source,
+  IN OUT UINTN        *SourceSize,
+  OUT    UINT8        *Destination
+  );
+
+#endif // CONFIG_BASE64_LIB_INTERNAL_H_
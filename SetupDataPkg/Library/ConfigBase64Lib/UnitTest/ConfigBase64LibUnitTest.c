@@ -0,0 +1,472 @@
+/** @file
+  Unit tests of the ConfigBase64Lib instance.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/ConfigBase64Lib.h>
+
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "Config Base64 Lib Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+// Large enough for the accelerated paths to handle several blocks and leave a tail
+#define TEST_BUFFER_SIZE  520
+#define TEST_MAX_OFFSET   4
+
+// Encoded size of TEST_BUFFER_SIZE bytes, including the NULL terminator
+#define TEST_ENCODED_SIZE  (((TEST_BUFFER_SIZE + 2) / 3) * 4 + 1)
+
+// Line length of wrapped encodings, as in PEM
+#define TEST_LINE_LENGTH  64
+
+/**
+  Fill a buffer with a repeatable pattern.
+
+  @param[out] Buffer  Buffer to fill.
+  @param[in]  Length  Size of Buffer in bytes.
+**/
+STATIC
+VOID
+FillTestBuffer (
+  OUT UINT8  *Buffer,
+  IN  UINTN  Length
+  )
+{
+  UINTN   Index;
+  UINT32  Seed;
+
+  Seed = 0x12345678;
+  for (Index = 0; Index < Length; Index++) {
+    Seed          = Seed * 1103515245 + 12345;
+    Buffer[Index] = (UINT8)(Seed >> 16);
+  }
+}
+
+/**
+  Unit test for ConfigBase64Encode and ConfigBase64Decode with the test vectors of RFC 4648.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigBase64KnownValues (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST CHAR8  *Encodings[] = { "", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy" };
+  CHAR8               Encoded[16];
+  UINT8               Decoded[8];
+  EFI_STATUS          Status;
+  UINTN               Size;
+  UINTN               Length;
+
+  for (Length = 0; Length < ARRAY_SIZE (Encodings); Length++) {
+    UT_ASSERT_EQUAL (ConfigBase64EncodedSize (Length), AsciiStrSize (Encodings[Length]));
+    UT_ASSERT_EQUAL (ConfigBase64DecodedSize (Encodings[Length], AsciiStrLen (Encodings[Length])), Length);
+
+    Size   = sizeof (Encoded);
+    Status = ConfigBase64Encode ((CONST UINT8 *)"foobar", Length, Encoded, &Size);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_EQUAL (Size, AsciiStrSize (Encodings[Length]));
+    UT_ASSERT_MEM_EQUAL (Encoded, Encodings[Length], Size);
+
+    Size   = sizeof (Decoded);
+    Status = ConfigBase64Decode (Encodings[Length], AsciiStrLen (Encodings[Length]), Decoded, &Size);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_EQUAL (Size, Length);
+    UT_ASSERT_MEM_EQUAL (Decoded, "foobar", Length);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for ConfigBase64Encode and ConfigBase64Decode against BaseLib Base64Encode and
+  Base64Decode, for all lengths of a buffer at several offsets, so that every accelerated and
+  portable path is covered.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigBase64MatchesBaseLib (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC UINT8  Buffer[TEST_BUFFER_SIZE + TEST_MAX_OFFSET];
+  STATIC CHAR8  Encoded[TEST_ENCODED_SIZE + TEST_MAX_OFFSET];
+  STATIC CHAR8  Expected[TEST_ENCODED_SIZE];
+  STATIC UINT8  Decoded[TEST_BUFFER_SIZE + TEST_MAX_OFFSET];
+  EFI_STATUS    Status;
+  UINTN         Offset;
+  UINTN         Length;
+  UINTN         Size;
+  UINTN         ExpectedSize;
+
+  FillTestBuffer (Buffer, sizeof (Buffer));
+
+  for (Offset = 0; Offset < TEST_MAX_OFFSET; Offset++) {
+    for (Length = 0; Length <= TEST_BUFFER_SIZE; Length++) {
+      ExpectedSize = sizeof (Expected);
+      Status       = Base64Encode (Buffer + Offset, Length, Expected, &ExpectedSize);
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+
+      Size   = ConfigBase64EncodedSize (Length);
+      Status = ConfigBase64Encode (Buffer + Offset, Length, Encoded + Offset, &Size);
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+      UT_ASSERT_EQUAL (Size, ExpectedSize);
+      UT_ASSERT_MEM_EQUAL (Encoded + Offset, Expected, Size);
+
+      // The size from the encoding alone is exact, so decoding is done in a single pass
+      Size = ConfigBase64DecodedSize (Encoded + Offset, ExpectedSize - 1);
+      UT_ASSERT_EQUAL (Size, Length);
+      Status = ConfigBase64Decode (Encoded + Offset, ExpectedSize - 1, Decoded + Offset, &Size);
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+      UT_ASSERT_EQUAL (Size, Length);
+      UT_ASSERT_MEM_EQUAL (Decoded + Offset, Buffer + Offset, Length);
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for ConfigBase64Decode of an encoding wrapped in lines with whitespace, which only
+  gets an upper bound from ConfigBase64DecodedSize.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigBase64DecodeWhitespace (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC UINT8  Buffer[TEST_BUFFER_SIZE];
+  STATIC CHAR8  Encoded[TEST_ENCODED_SIZE];
+  STATIC CHAR8  Wrapped[TEST_ENCODED_SIZE * 2];
+  STATIC UINT8  Decoded[TEST_BUFFER_SIZE * 2];
+  EFI_STATUS    Status;
+  UINTN         Index;
+  UINTN         Length;
+  UINTN         Size;
+
+  FillTestBuffer (Buffer, sizeof (Buffer));
+
+  Size   = sizeof (Encoded);
+  Status = ConfigBase64Encode (Buffer, sizeof (Buffer), Encoded, &Size);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  Length = 0;
+  for (Index = 0; Index < Size - 1; Index++) {
+    if ((Index % TEST_LINE_LENGTH) == 0) {
+      Wrapped[Length++] = '\r';
+      Wrapped[Length++] = '\n';
+      Wrapped[Length++] = ' ';
+    }
+
+    Wrapped[Length++] = Encoded[Index];
+  }
+
+  Wrapped[Length++] = '\t';
+
+  UT_ASSERT_TRUE (ConfigBase64DecodedSize (Wrapped, Length) >= sizeof (Buffer));
+
+  // With room for the upper bound, and with room for the exact size only
+  Size   = sizeof (Decoded);
+  Status = ConfigBase64Decode (Wrapped, Length, Decoded, &Size);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Size, sizeof (Buffer));
+  UT_ASSERT_MEM_EQUAL (Decoded, Buffer, Size);
+
+  ZeroMem (Decoded, sizeof (Decoded));
+  Size   = sizeof (Buffer);
+  Status = ConfigBase64Decode (Wrapped, Length, Decoded, &Size);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Size, sizeof (Buffer));
+  UT_ASSERT_MEM_EQUAL (Decoded, Buffer, Size);
+
+  Size   = sizeof (Buffer) - 1;
+  Status = ConfigBase64Decode (Wrapped, Length, Decoded, &Size);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (Size, sizeof (Buffer));
+
+  // Whitespace may also be found between the padding characters
+  Size   = sizeof (Decoded);
+  Status = ConfigBase64Decode ("Zg= =\n", 6, Decoded, &Size);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Size, 1);
+  UT_ASSERT_EQUAL (Decoded[0], 'f');
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for ConfigBase64Decode of invalid encodings, with an invalid character at every
+  position of a valid encoding and with bad padding.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigBase64DecodeInvalid (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST CHAR8  *BadPadding[] = { "Zg=", "Z===", "Zg==Zg==", "Zm9v=", "Zm9vY", "=Zm9", "Zm=v" };
+  STATIC CONST CHAR8  BadCharacters[] = { '-', '_', '.', '\0', '@', '[', '`', '{', '\x7F', '\x80', '\xC1', '\xFF' };
+  STATIC UINT8        Buffer[TEST_BUFFER_SIZE];
+  STATIC CHAR8        Encoded[TEST_ENCODED_SIZE];
+  STATIC UINT8        Decoded[TEST_BUFFER_SIZE];
+  EFI_STATUS          Status;
+  CHAR8               Saved;
+  UINTN               EncodedSize;
+  UINTN               Index;
+  UINTN               Bad;
+  UINTN               Size;
+
+  FillTestBuffer (Buffer, sizeof (Buffer));
+
+  // Whole blocks only, so that any character may be replaced
+  EncodedSize = sizeof (Encoded);
+  Status      = ConfigBase64Encode (Buffer, 384, Encoded, &EncodedSize);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  EncodedSize--;
+
+  for (Index = 0; Index < EncodedSize; Index++) {
+    Saved = Encoded[Index];
+    for (Bad = 0; Bad < ARRAY_SIZE (BadCharacters); Bad++) {
+      Encoded[Index] = BadCharacters[Bad];
+      Size           = sizeof (Decoded);
+      Status         = ConfigBase64Decode (Encoded, EncodedSize, Decoded, &Size);
+      UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+    }
+
+    Encoded[Index] = Saved;
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (BadPadding); Index++) {
+    Size   = sizeof (Decoded);
+    Status = ConfigBase64Decode (BadPadding[Index], AsciiStrLen (BadPadding[Index]), Decoded, &Size);
+    UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+    Size   = sizeof (Decoded);
+    Status = Base64Decode (BadPadding[Index], AsciiStrLen (BadPadding[Index]), Decoded, &Size);
+    UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for the sizing and parameter checks of ConfigBase64Encode and ConfigBase64Decode.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigBase64Parameters (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CHAR8       Encoded[16];
+  UINT8       Decoded[8];
+  EFI_STATUS  Status;
+  UINTN       Size;
+
+  UT_ASSERT_EQUAL (ConfigBase64EncodedSize (MAX_UINTN), 0);
+  UT_ASSERT_EQUAL (ConfigBase64DecodedSize (NULL, 0), 0);
+  UT_ASSERT_EQUAL (ConfigBase64DecodedSize ("==", 2), 0);
+
+  Size   = 0;
+  Status = ConfigBase64Encode ((CONST UINT8 *)"foobar", 6, NULL, &Size);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (Size, 9);
+
+  Size   = 8;
+  Status = ConfigBase64Encode ((CONST UINT8 *)"foobar", 6, Encoded, &Size);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (Size, 9);
+
+  Size   = sizeof (Encoded);
+  Status = ConfigBase64Encode (NULL, 6, Encoded, &Size);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = ConfigBase64Encode ((CONST UINT8 *)"foobar", 6, Encoded, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  // Encoding in place overlaps
+  CopyMem (Encoded, "foobar", 6);
+  Size   = sizeof (Encoded);
+  Status = ConfigBase64Encode ((CONST UINT8 *)Encoded, 6, Encoded, &Size);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Size   = 0;
+  Status = ConfigBase64Decode ("Zm9vYmFy", 8, NULL, &Size);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (Size, 6);
+
+  Size   = 5;
+  Status = ConfigBase64Decode ("Zm9vYmFy", 8, Decoded, &Size);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (Size, 6);
+
+  Size   = 0;
+  Status = ConfigBase64Decode (" \r\n", 3, NULL, &Size);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Size, 0);
+
+  Size   = sizeof (Decoded);
+  Status = ConfigBase64Decode (NULL, 8, Decoded, &Size);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Size   = sizeof (Decoded);
+  Status = ConfigBase64Decode ("Zm9vYmFy", 8, NULL, &Size);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = ConfigBase64Decode ("Zm9vYmFy", 8, Decoded, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  sample unit tests and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      ConfigBase64Lib;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the ConfigBase64Lib Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&ConfigBase64Lib, Framework, "ConfigBase64Lib Conversion Tests", "ConfigBase64Lib.Convert", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for ConfigBase64Lib\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----------Description--------------Name----------Function--------Pre---Post-------------------Context-----------
+  //
+  AddTestCase (ConfigBase64Lib, "RFC 4648 test vectors should match", "ConfigBase64KnownValues", ConfigBase64KnownValues, NULL, NULL, NULL);
+  AddTestCase (ConfigBase64Lib, "All lengths and offsets should match BaseLib", "ConfigBase64MatchesBaseLib", ConfigBase64MatchesBaseLib, NULL, NULL, NULL);
+  AddTestCase (ConfigBase64Lib, "Wrapped encodings should decode", "ConfigBase64DecodeWhitespace", ConfigBase64DecodeWhitespace, NULL, NULL, NULL);
+  AddTestCase (ConfigBase64Lib, "Invalid encodings should fail", "ConfigBase64DecodeInvalid", ConfigBase64DecodeInvalid, NULL, NULL, NULL);
+  AddTestCase (ConfigBase64Lib, "Sizes and parameters should be checked", "ConfigBase64Parameters", ConfigBase64Parameters, NULL, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -0,0 +1,235 @@
+/** @file
+  Base64 acceleration for X64 with the SSSE3 byte shuffle instruction.
+
+  Each block of 12 bytes is encoded into 16 characters, and each block of 16 characters is validated and
+  decoded into 12 bytes, with PSHUFB table lookups as described by Wojciech Mula and Daniel Lemire in
+  "Faster Base64 Encoding and Decoding Using AVX2 Instructions", narrowed to 128 bit vectors.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <Base.h>
+#include <Library/BaseLib.h>
+
+#include "../ConfigBase64LibInternal.h"
+
+#if defined (_MSC_VER)
+  #include <tmmintrin.h>
+
+typedef __m128i B64_VECTOR;
+
+  #define B64_LOAD(Ptr)             _mm_loadu_si128 ((CONST __m128i *)(Ptr))
+  #define B64_STORE(Ptr, Value)     _mm_storeu_si128 ((__m128i *)(Ptr), (Value))
+  #define B64_BYTES(...)            _mm_setr_epi8 (__VA_ARGS__)
+  #define B64_DUP8(Value)           _mm_set1_epi8 ((CHAR8)(Value))
+  #define B64_DUP32(Value)          _mm_set1_epi32 ((INT32)(Value))
+  #define B64_AND(A, B)             _mm_and_si128 ((A), (B))
+  #define B64_OR(A, B)              _mm_or_si128 ((A), (B))
+  #define B64_ADD8(A, B)            _mm_add_epi8 ((A), (B))
+  #define B64_SUBS_U8(A, B)         _mm_subs_epu8 ((A), (B))
+  #define B64_CMPEQ8(A, B)          _mm_cmpeq_epi8 ((A), (B))
+  #define B64_CMPGT8(A, B)          _mm_cmpgt_epi8 ((A), (B))
+  #define B64_SRL32(A, Count)       _mm_srli_epi32 ((A), (Count))
+  #define B64_MULHI_U16(A, B)       _mm_mulhi_epu16 ((A), (B))
+  #define B64_MULLO16(A, B)         _mm_mullo_epi16 ((A), (B))
+  #define B64_MADDUBS(A, B)         _mm_maddubs_epi16 ((A), (B))
+  #define B64_MADD16(A, B)          _mm_madd_epi16 ((A), (B))
+  #define B64_SHUFFLE(Table, Index) _mm_shuffle_epi8 ((Table), (Index))
+  #define B64_MOVEMASK8(A)          _mm_movemask_epi8 (A)
+  #define B64_TARGET
+#else
+// Vector types and builtins are used directly, as the intrinsic headers are not freestanding
+typedef long long B64_VECTOR __attribute__ ((vector_size (16)));
+typedef long long B64_UNALIGNED_VECTOR __attribute__ ((vector_size (16), aligned (1), may_alias));
+typedef char B64_V16QI __attribute__ ((vector_size (16)));
+typedef signed char B64_V16QS __attribute__ ((vector_size (16)));
+typedef unsigned char B64_V16QU __attribute__ ((vector_size (16)));
+typedef short B64_V8HI __attribute__ ((vector_size (16)));
+typedef int B64_V4SI __attribute__ ((vector_size (16)));
+typedef unsigned int B64_V4SU __attribute__ ((vector_size (16)));
+
+  #define B64_LOAD(Ptr)             (*(CONST B64_UNALIGNED_VECTOR *)(Ptr))
+  #define B64_STORE(Ptr, Value)     (*(B64_UNALIGNED_VECTOR *)(Ptr) = (Value))
+  #define B64_BYTES(...)            ((B64_VECTOR)(B64_V16QI){ __VA_ARGS__ })
+  #define B64_DUP8(Value)           B64_BYTES (Value, Value, Value, Value, Value, Value, Value, Value, \
+                                               Value, Value, Value, Value, Value, Value, Value, Value)
+  #define B64_DUP32(Value)          ((B64_VECTOR)(B64_V4SI){ (INT32)(Value), (INT32)(Value), \
+                                                             (INT32)(Value), (INT32)(Value) })
+  #define B64_AND(A, B)             ((A) & (B))
+  #define B64_OR(A, B)              ((A) | (B))
+  #define B64_ADD8(A, B)            ((B64_VECTOR)((B64_V16QI)(A) + (B64_V16QI)(B)))
+  #define B64_SUBS_U8(A, B)         ((B64_VECTOR)(((B64_V16QU)(A) - (B64_V16QU)(B)) & \
+                                                  (B64_V16QU)((B64_V16QU)(A) > (B64_V16QU)(B))))
+  #define B64_CMPEQ8(A, B)          ((B64_VECTOR)((B64_V16QI)(A) == (B64_V16QI)(B)))
+  #define B64_CMPGT8(A, B)          ((B64_VECTOR)((B64_V16QS)(A) > (B64_V16QS)(B)))
+  #define B64_SRL32(A, Count)       ((B64_VECTOR)((B64_V4SU)(A) >> (Count)))
+  #define B64_MULHI_U16(A, B)       ((B64_VECTOR)__builtin_ia32_pmulhuw128 ((B64_V8HI)(A), (B64_V8HI)(B)))
+  #define B64_MULLO16(A, B)         ((B64_VECTOR)((B64_V8HI)(A) * (B64_V8HI)(B)))
+  #define B64_MADDUBS(A, B)         ((B64_VECTOR)__builtin_ia32_pmaddubsw128 ((B64_V16QI)(A), (B64_V16QI)(B)))
+  #define B64_MADD16(A, B)          ((B64_VECTOR)__builtin_ia32_pmaddwd128 ((B64_V8HI)(A), (B64_V8HI)(B)))
+  #define B64_SHUFFLE(Table, Index) ((B64_VECTOR)__builtin_ia32_pshufb128 ((B64_V16QI)(Table), (B64_V16QI)(Index)))
+  #define B64_MOVEMASK8(A)          __builtin_ia32_pmovmskb128 ((B64_V16QI)(A))
+  #define B64_TARGET                __attribute__ ((target ("sse2,ssse3")))
+#endif
+
+// Characters and bytes of a block
+#define B64_BLOCK_CHARACTERS  16
+#define B64_BLOCK_BYTES       12
+
+/**
+  Check whether the running CPU supports the Base64 acceleration of this architecture.
+
+  @retval TRUE    ConfigBase64EncodeAccelerated and ConfigBase64DecodeAccelerated may be called.
+  @retval FALSE   There is no acceleration.
+**/
+BOOLEAN
+ConfigBase64AccelerationSupported (
+  VOID
+  )
+{
+  UINT32  Ecx;
+
+  // Not cached in a global, as this library may run from read-only memory in PEI
+  AsmCpuid (1, NULL, NULL, &Ecx, NULL);
+  return (Ecx & BIT9) != 0;
+}
+
+/**
+  Encode the leading whole blocks of binary data with the Base64 acceleration of the running CPU.
+  Implementations may leave a tail of the data unprocessed, which the caller finishes, so the number of bytes
+  processed is always a multiple of 3.
+
+  @param[in]      Source        Pointer to the binary data.
+  @param[in,out]  SourceLength  On input, size of Source in bytes. On output, the number of bytes at the end
+                                of Source that were not processed.
+  @param[out]     Destination   Pointer to the output buffer, with room for the encoding of all of Source.
+
+  @return The number of characters written to Destination.
+**/
+B64_TARGET
+UINTN
+ConfigBase64EncodeAccelerated (
+  IN     CONST UINT8  *Source,
+  IN OUT UINTN        *SourceLength,
+  OUT    CHAR8        *Destination
+  )
+{
+  B64_VECTOR  In;
+  B64_VECTOR  Indices;
+  B64_VECTOR  Result;
+  UINTN       LeftLength;
+  UINTN       Length;
+
+  LeftLength = *SourceLength;
+  Length     = 0;
+
+  // Each block is loaded as 16 bytes, of which the last 4 are left to the next block
+  while (LeftLength >= B64_BLOCK_CHARACTERS) {
+    In = B64_SHUFFLE (B64_LOAD (Source), B64_BYTES (1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+
+    // Split each 3 bytes into four 6 bit indices, one per byte
+    Indices = B64_OR (
+                B64_MULHI_U16 (B64_AND (In, B64_DUP32 (0x0FC0FC00)), B64_DUP32 (0x04000040)),
+                B64_MULLO16 (B64_AND (In, B64_DUP32 (0x003F03F0)), B64_DUP32 (0x01000010))
+                );
+
+    // Map the indices to the offset of their alphabet range: 0 for 'a'-'z', 1 to 10 for '0'-'9',
+    // 11 for '+', 12 for '/' and 13 for 'A'-'Z'
+    Result = B64_SUBS_U8 (Indices, B64_DUP8 (51));
+    Result = B64_OR (Result, B64_AND (B64_CMPGT8 (B64_DUP8 (26), Indices), B64_DUP8 (13)));
+    Result = B64_SHUFFLE (
+               B64_BYTES (
+                 'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                 '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0
+                 ),
+               Result
+               );
+
+    B64_STORE (Destination + Length, B64_ADD8 (Result, Indices));
+
+    Source     += B64_BLOCK_BYTES;
+    LeftLength -= B64_BLOCK_BYTES;
+    Length     += B64_BLOCK_CHARACTERS;
+  }
+
+  *SourceLength = LeftLength;
+  return Length;
+}
+
+/**
+  Decode the leading whole blocks of a Base64 encoding with the Base64 acceleration of the running CPU. A
+  block holding any character outside of the alphabet, e.g. whitespace or padding, ends the processing, so
+  the number of characters processed is always a multiple of 4 and all of them are alphabet characters.
+
+  @param[in]      Source        Pointer to the Base64 encoding.
+  @param[in,out]  SourceSize    On input, number of characters in Source. On output, the number of characters
+                                at the end of Source that were not processed.
+  @param[out]     Destination   Pointer to the output buffer, with room for the decoded data of Source. Only
+                                the bytes decoded are written.
+
+  @return The number of bytes written to Destination.
+**/
+B64_TARGET
+UINTN
+ConfigBase64DecodeAccelerated (
+  IN     CONST CHAR8  *Source,
+  IN OUT UINTN        *SourceSize,
+  OUT    UINT8        *Destination
+  )
+{
+  B64_VECTOR  In;
+  B64_VECTOR  HiNibbles;
+  B64_VECTOR  Lo;
+  B64_VECTOR  Hi;
+  B64_VECTOR  Values;
+  UINT64      Block[2];
+  UINTN       LeftSize;
+  UINTN       Length;
+
+  LeftSize = *SourceSize;
+  Length   = 0;
+
+  while (LeftSize >= B64_BLOCK_CHARACTERS) {
+    In        = B64_LOAD (Source);
+    HiNibbles = B64_AND (B64_SRL32 (In, 4), B64_DUP8 (0x0F));
+
+    // Each nibble maps to a class bitmask, a character is in the alphabet when its two masks are disjoint
+    Lo = B64_SHUFFLE (
+           B64_BYTES (0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A),
+           B64_AND (In, B64_DUP8 (0x0F))
+           );
+    Hi = B64_SHUFFLE (
+           B64_BYTES (0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10),
+           HiNibbles
+           );
+    if (B64_MOVEMASK8 (B64_CMPEQ8 (B64_AND (Lo, Hi), B64_DUP8 (0))) != 0xFFFF) {
+      break;
+    }
+
+    // Offset each character by its range to get its 6 bit value, '/' being the only one not found by nibble
+    Values = B64_ADD8 (
+               In,
+               B64_SHUFFLE (
+                 B64_BYTES (0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0),
+                 B64_ADD8 (B64_CMPEQ8 (In, B64_DUP8 ('/')), HiNibbles)
+                 )
+               );
+
+    // Pack each four 6 bit values into 3 bytes, in the first 12 bytes of the vector
+    Values = B64_MADD16 (B64_MADDUBS (Values, B64_DUP32 (0x01400140)), B64_DUP32 (0x00011000));
+    Values = B64_SHUFFLE (Values, B64_BYTES (2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+    // Only the decoded bytes are written, the destination may end right after them
+    B64_STORE (Block, Values);
+    WriteUnaligned64 ((UINT64 *)(Destination + Length), Block[0]);
+    WriteUnaligned32 ((UINT32 *)(Destination + Length + sizeof (UINT64)), (UINT32)Block[1]);
+
+    Source   += B64_BLOCK_CHARACTERS;
+    LeftSize -= B64_BLOCK_CHARACTERS;
+    Length   += B64_BLOCK_BYTES;
+  }
+
+  *SourceSize = LeftSize;
+  return Length;
+}
@@ -0,0 +1,134 @@
+/** @file
+  CRC32 acceleration for AARCH64 with the ARMv8 CRC32 instructions, which implement the same
+  IEEE 802.3 polynomial as configuration data. The instructions are optional before ARMv8.1,
+  so their presence is checked in ID_AA64ISAR0_EL1.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <Base.h>
+
+#include "../ConfigCrcLibInternal.h"
+
+#if defined (_MSC_VER)
+  #include <intrin.h>
+
+  #define CRC_READ_ID_AA64ISAR0()        ((UINT64)_ReadStatusReg (ARM64_SYSREG (3, 0, 0, 6, 0)))
+  #define CRC_UPDATE_8(State, Value)     __crc32b ((State), (Value))
+  #define CRC_UPDATE_64(State, Value)    __crc32d ((State), (Value))
+#else
+
+/**
+  Read the ID_AA64ISAR0_EL1 instruction set attribute register.
+
+  @return The register value.
+**/
+STATIC
+UINT64
+CrcReadIdAa64Isar0 (
+  VOID
+  )
+{
+  UINT64  Value;
+
+  __asm__ __volatile__ ("mrs %0, id_aa64isar0_el1" : "=r" (Value));
+  return Value;
+}
+
+/**
+  Advance a CRC32 state over one byte with the CRC32B instruction.
+
+  @param[in]  State   CRC32 state.
+  @param[in]  Value   Byte to add.
+
+  @return The CRC32 state after Value.
+**/
+STATIC
+UINT32
+CrcUpdate8 (
+  IN UINT32  State,
+  IN UINT8   Value
+  )
+{
+  // The extension is enabled for this instruction only, it is checked for before use
+  __asm__ (".arch_extension crc\n\tcrc32b %w0, %w0, %w1" : "+r" (State) : "r" (Value));
+  return State;
+}
+
+/**
+  Advance a CRC32 state over eight bytes with the CRC32X instruction.
+
+  @param[in]  State   CRC32 state.
+  @param[in]  Value   Little endian bytes to add.
+
+  @return The CRC32 state after Value.
+**/
+STATIC
+UINT32
+CrcUpdate64 (
+  IN UINT32  State,
+  IN UINT64  Value
+  )
+{
+  __asm__ (".arch_extension crc\n\tcrc32x %w0, %w0, %x1" : "+r" (State) : "r" (Value));
+  return State;
+}
+
+  #define CRC_READ_ID_AA64ISAR0()        CrcReadIdAa64Isar0 ()
+  #define CRC_UPDATE_8(State, Value)     CrcUpdate8 ((State), (Value))
+  #define CRC_UPDATE_64(State, Value)    CrcUpdate64 ((State), (Value))
+#endif
+
+// ID_AA64ISAR0_EL1.CRC32, bits [19:16]
+#define CRC_ID_AA64ISAR0_CRC32_SHIFT  16
+#define CRC_ID_AA64ISAR0_CRC32_MASK   0xF
+
+// Buffers shorter than this are not worth aligning
+#define CRC_ARM_MIN_LENGTH  16
+
+/**
+  Advance a CRC32 state over a buffer with the CRC acceleration of the running CPU, when it has any.
+  Implementations may leave a tail of the buffer unprocessed, which the caller finishes with
+  ConfigCrc32Portable.
+
+  @param[in]      State   CRC32 state before Buffer.
+  @param[in]      Buffer  Pointer to the buffer.
+  @param[in,out]  Length  On input, size of Buffer in bytes. On output, the number of bytes
+                          at the end of Buffer that were not processed.
+
+  @return The CRC32 state after the processed part of Buffer.
+**/
+UINT32
+ConfigCrc32Accelerated (
+  IN     UINT32       State,
+  IN     CONST UINT8  *Buffer,
+  IN OUT UINTN        *Length
+  )
+{
+  UINTN  LeftLength;
+
+  LeftLength = *Length;
+  if (LeftLength < CRC_ARM_MIN_LENGTH) {
+    return State;
+  }
+
+  if (((CRC_READ_ID_AA64ISAR0 () >> CRC_ID_AA64ISAR0_CRC32_SHIFT) & CRC_ID_AA64ISAR0_CRC32_MASK) == 0) {
+    return State;
+  }
+
+  while (((UINTN)Buffer & (sizeof (UINT64) - 1)) != 0) {
+    State = CRC_UPDATE_8 (State, *Buffer);
+    Buffer++;
+    LeftLength--;
+  }
+
+  while (LeftLength >= sizeof (UINT64)) {
+    State       = CRC_UPDATE_64 (State, *(CONST UINT64 *)Buffer);
+    Buffer     += sizeof (UINT64);
+    LeftLength -= sizeof (UINT64);
+  }
+
+  *Length = LeftLength;
+  return State;
+}
@@ -0,0 +1,48 @@
+/** @file
+  Internal definitions shared by the ConfigCrcLib sources.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef CONFIG_CRC_LIB_INTERNAL_H_
+#define CONFIG_CRC_LIB_INTERNAL_H_
+
+/**
+  Advance a CRC32 state over a buffer, one byte at a time. The state is the CRC32 register
+  before the final inversion, i.e. the bitwise complement of a ConfigUpdateCrc32 value.
+
+  @param[in]  State   CRC32 state before Buffer.
+  @param[in]  Buffer  Pointer to the buffer.
+  @param[in]  Length  Size of Buffer in bytes.
+
+  @return The CRC32 state after Buffer.
+**/
+UINT32
+ConfigCrc32Portable (
+  IN UINT32       State,
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Length
+  );
+
+/**
+  Advance a CRC32 state over a buffer with the CRC acceleration of the running CPU, when it has any.
+  Implementations may leave a tail of the buffer unprocessed, which the caller finishes with
+  ConfigCrc32Portable.
+
+  @param[in]      State   CRC32 state before Buffer.
+  @param[in]      Buffer  Pointer to the buffer.
+  @param[in,out]  Length  On input, size of Buffer in bytes. On output, the number of bytes
+                          at the end of Buffer that were not processed.
+
+  @return The CRC32 state after the processed part of Buffer.
+**/
+UINT32
+ConfigCrc32Accelerated (
+  IN     UINT32       State,
+  IN     CONST UINT8  *Buffer,
+  IN OUT UINTN        *Length
+  );
+
+#endif // CONFIG_CRC_LIB_INTERNAL_H_
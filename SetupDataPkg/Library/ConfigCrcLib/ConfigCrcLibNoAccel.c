@@ -0,0 +1,33 @@
+/** @file
+  CRC32 acceleration stub for architectures without a supported CRC instruction.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <Base.h>
+
+#include "ConfigCrcLibInternal.h"
+
+/**
+  Advance a CRC32 state over a buffer with the CRC acceleration of the running CPU, when it has any.
+  Implementations may leave a tail of the buffer unprocessed, which the caller finishes with
+  ConfigCrc32Portable.
+
+  @param[in]      State   CRC32 state before Buffer.
+  @param[in]      Buffer  Pointer to the buffer.
+  @param[in,out]  Length  On input, size of Buffer in bytes. On output, the number of bytes
+                          at the end of Buffer that were not processed.
+
+  @return The CRC32 state after the processed part of Buffer.
+**/
+UINT32
+ConfigCrc32Accelerated (
+  IN     UINT32       State,
+  IN     CONST UINT8  *Buffer,
+  IN OUT UINTN        *Length
+  )
+{
+  // Nothing processed, the whole buffer is left to the portable calculation
+  return State;
+}
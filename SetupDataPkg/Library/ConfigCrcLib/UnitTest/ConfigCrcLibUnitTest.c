@@ -0,0 +1,237 @@
+/** @file
+  Unit tests of the ConfigCrcLib instance.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/ConfigCrcLib.h>
+
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME     "Config CRC Lib Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+// Large enough for the accelerated paths to handle several blocks and leave a tail
+#define TEST_BUFFER_SIZE  1100
+#define TEST_MAX_OFFSET   16
+
+/**
+  Fill a buffer with a repeatable pattern.
+
+  @param[out] Buffer  Buffer to fill.
+  @param[in]  Length  Size of Buffer in bytes.
+**/
+STATIC
+VOID
+FillTestBuffer (
+  OUT UINT8  *Buffer,
+  IN  UINTN  Length
+  )
+{
+  UINTN   Index;
+  UINT32  Seed;
+
+  Seed = 0x12345678;
+  for (Index = 0; Index < Length; Index++) {
+    Seed          = Seed * 1103515245 + 12345;
+    Buffer[Index] = (UINT8)(Seed >> 16);
+  }
+}
+
+/**
+  Unit test for ConfigCalculateCrc32 with well known check values.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigCalculateCrc32KnownValues (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  Zeros[32];
+
+  ZeroMem (Zeros, sizeof (Zeros));
+
+  UT_ASSERT_EQUAL (ConfigCalculateCrc32 ("123456789", 9), 0xCBF43926);
+  UT_ASSERT_EQUAL (ConfigCalculateCrc32 (Zeros, sizeof (Zeros)), 0x190A55AD);
+  UT_ASSERT_EQUAL (ConfigCalculateCrc32 (Zeros, 0), 0);
+  UT_ASSERT_EQUAL (ConfigCalculateCrc32 (NULL, 0), 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for ConfigCalculateCrc32 against BaseLib CalculateCrc32, for all lengths of a
+  buffer at several misalignments, so that every accelerated and portable path is covered.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigCalculateCrc32MatchesBaseLib (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC UINT8  Buffer[TEST_BUFFER_SIZE + TEST_MAX_OFFSET];
+  UINTN         Offset;
+  UINTN         Length;
+
+  FillTestBuffer (Buffer, sizeof (Buffer));
+
+  for (Offset = 0; Offset < TEST_MAX_OFFSET; Offset++) {
+    for (Length = 1; Length <= TEST_BUFFER_SIZE; Length++) {
+      UT_ASSERT_EQUAL (ConfigCalculateCrc32 (Buffer + Offset, Length), CalculateCrc32 (Buffer + Offset, Length));
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for ConfigUpdateCrc32 continuing a calculation over split buffers.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigUpdateCrc32Chained (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC UINT8  Buffer[TEST_BUFFER_SIZE];
+  UINT32        Expected;
+  UINT32        Crc;
+  UINTN         Split;
+
+  FillTestBuffer (Buffer, sizeof (Buffer));
+  Expected = CalculateCrc32 (Buffer, sizeof (Buffer));
+
+  UT_ASSERT_EQUAL (ConfigUpdateCrc32 (0, Buffer, sizeof (Buffer)), Expected);
+  UT_ASSERT_EQUAL (ConfigUpdateCrc32 (Expected, NULL, 0), Expected);
+
+  for (Split = 0; Split <= sizeof (Buffer); Split += 37) {
+    Crc = ConfigCalculateCrc32 (Buffer, Split);
+    Crc = ConfigUpdateCrc32 (Crc, Buffer + Split, sizeof (Buffer) - Split);
+    UT_ASSERT_EQUAL (Crc, Expected);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  sample unit tests and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      ConfigCrcLib;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the ConfigCrcLib Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&ConfigCrcLib, Framework, "ConfigCrcLib Calculation Tests", "ConfigCrcLib.Calculate", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for ConfigCrcLib\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----------Description--------------Name----------Function--------Pre---Post-------------------Context-----------
+  //
+  AddTestCase (ConfigCrcLib, "Known check values should match", "ConfigCalculateCrc32KnownValues", ConfigCalculateCrc32KnownValues, NULL, NULL, NULL);
+  AddTestCase (ConfigCrcLib, "All lengths and offsets should match BaseLib", "ConfigCalculateCrc32MatchesBaseLib", ConfigCalculateCrc32MatchesBaseLib, NULL, NULL, NULL);
+  AddTestCase (ConfigCrcLib, "Chained calculation should match single pass", "ConfigUpdateCrc32Chained", ConfigUpdateCrc32Chained, NULL, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
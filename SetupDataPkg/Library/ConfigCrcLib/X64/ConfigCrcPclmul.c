@@ -0,0 +1,174 @@
+/** @file
+  CRC32 acceleration for X64 with the PCLMULQDQ carry-less multiply instruction.
+
+  The SSE4.2 CRC32 instruction implements the Castagnoli polynomial, not the IEEE 802.3 one
+  used by configuration data, so the buffer is instead folded 64 bytes at a time with carry-less
+  multiplications, as described in Intel's "Fast CRC Computation for Generic Polynomials Using
+  PCLMULQDQ Instruction". The folded remainder is then reduced with the portable calculation.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <Base.h>
+#include <Library/BaseLib.h>
+
+#include "../ConfigCrcLibInternal.h"
+
+#if defined (_MSC_VER)
+  #include <wmmintrin.h>
+
+typedef __m128i CRC_VECTOR;
+
+  #define CRC_LOAD(Ptr)           _mm_loadu_si128 ((CONST __m128i *)(Ptr))
+  #define CRC_STORE(Ptr, Value)   _mm_storeu_si128 ((__m128i *)(Ptr), (Value))
+  #define CRC_XOR(A, B)           _mm_xor_si128 ((A), (B))
+  #define CRC_CLMUL(A, B, Imm)    _mm_clmulepi64_si128 ((A), (B), (Imm))
+  #define CRC_FROM_STATE(State)   _mm_cvtsi32_si128 ((INT32)(State))
+  #define CRC_CONSTANTS(Lo, Hi)   _mm_set_epi64x ((Hi), (Lo))
+  #define CRC_TARGET
+#else
+// Vector types and builtins are used directly, as the intrinsic headers are not freestanding
+typedef long long CRC_VECTOR __attribute__ ((vector_size (16)));
+typedef long long CRC_UNALIGNED_VECTOR __attribute__ ((vector_size (16), aligned (1), may_alias));
+
+  #define CRC_LOAD(Ptr)           (*(CONST CRC_UNALIGNED_VECTOR *)(Ptr))
+  #define CRC_STORE(Ptr, Value)   (*(CRC_UNALIGNED_VECTOR *)(Ptr) = (Value))
+  #define CRC_XOR(A, B)           ((A) ^ (B))
+  #define CRC_CLMUL(A, B, Imm)    __builtin_ia32_pclmulqdq128 ((A), (B), (Imm))
+  #define CRC_FROM_STATE(State)   ((CRC_VECTOR){ (long long)(UINT32)(State), 0 })
+  #define CRC_CONSTANTS(Lo, Hi)   ((CRC_VECTOR){ (long long)(Lo), (long long)(Hi) })
+  #define CRC_TARGET              __attribute__ ((target ("sse2,pclmul")))
+#endif
+
+// Folding constants for the reflected polynomial: x^(4*128+32) and x^(4*128-32) mod P for
+// folding across four lanes, x^(128+32) and x^(128-32) mod P for folding into one lane
+#define CRC_FOLD4_LO  0x154442BD4ULL
+#define CRC_FOLD4_HI  0x1C6E41596ULL
+#define CRC_FOLD1_LO  0x1751997D0ULL
+#define CRC_FOLD1_HI  0x0CCAA009EULL
+
+// CPUID is not free, notably when virtualized, so only check for buffers where folding pays off
+#define CRC_PCLMUL_MIN_LENGTH  256
+
+/**
+  Fold a buffer of at least 64 bytes into a 128 bit remainder and reduce it.
+
+  @param[in]      State   CRC32 state before Buffer.
+  @param[in]      Buffer  Pointer to the buffer.
+  @param[in,out]  Length  On input, size of Buffer in bytes, at least 64. On output, the
+                          number of bytes at the end of Buffer that were not processed.
+
+  @return The CRC32 state after the processed part of Buffer.
+**/
+CRC_TARGET
+STATIC
+UINT32
+ConfigCrc32Pclmul (
+  IN     UINT32       State,
+  IN     CONST UINT8  *Buffer,
+  IN OUT UINTN        *Length
+  )
+{
+  CRC_VECTOR  X1, X2, X3, X4;
+  CRC_VECTOR  X5, X6, X7, X8;
+  CRC_VECTOR  Constants;
+  UINT8       Remainder[16];
+  UINTN       LeftLength;
+
+  LeftLength = *Length;
+
+  // The state is folded in with the first bytes
+  X1 = CRC_XOR (CRC_LOAD (Buffer), CRC_FROM_STATE (State));
+  X2 = CRC_LOAD (Buffer + 16);
+  X3 = CRC_LOAD (Buffer + 32);
+  X4 = CRC_LOAD (Buffer + 48);
+
+  Buffer     += 64;
+  LeftLength -= 64;
+
+  Constants = CRC_CONSTANTS (CRC_FOLD4_LO, CRC_FOLD4_HI);
+  while (LeftLength >= 64) {
+    X5 = CRC_CLMUL (X1, Constants, 0x00);
+    X6 = CRC_CLMUL (X2, Constants, 0x00);
+    X7 = CRC_CLMUL (X3, Constants, 0x00);
+    X8 = CRC_CLMUL (X4, Constants, 0x00);
+
+    X1 = CRC_CLMUL (X1, Constants, 0x11);
+    X2 = CRC_CLMUL (X2, Constants, 0x11);
+    X3 = CRC_CLMUL (X3, Constants, 0x11);
+    X4 = CRC_CLMUL (X4, Constants, 0x11);
+
+    X1 = CRC_XOR (CRC_XOR (X1, X5), CRC_LOAD (Buffer));
+    X2 = CRC_XOR (CRC_XOR (X2, X6), CRC_LOAD (Buffer + 16));
+    X3 = CRC_XOR (CRC_XOR (X3, X7), CRC_LOAD (Buffer + 32));
+    X4 = CRC_XOR (CRC_XOR (X4, X8), CRC_LOAD (Buffer + 48));
+
+    Buffer     += 64;
+    LeftLength -= 64;
+  }
+
+  // Fold the four lanes into one
+  Constants = CRC_CONSTANTS (CRC_FOLD1_LO, CRC_FOLD1_HI);
+
+  X5 = CRC_CLMUL (X1, Constants, 0x00);
+  X1 = CRC_CLMUL (X1, Constants, 0x11);
+  X1 = CRC_XOR (CRC_XOR (X1, X5), X2);
+
+  X5 = CRC_CLMUL (X1, Constants, 0x00);
+  X1 = CRC_CLMUL (X1, Constants, 0x11);
+  X1 = CRC_XOR (CRC_XOR (X1, X5), X3);
+
+  X5 = CRC_CLMUL (X1, Constants, 0x00);
+  X1 = CRC_CLMUL (X1, Constants, 0x11);
+  X1 = CRC_XOR (CRC_XOR (X1, X5), X4);
+
+  while (LeftLength >= 16) {
+    X5 = CRC_CLMUL (X1, Constants, 0x00);
+    X1 = CRC_CLMUL (X1, Constants, 0x11);
+    X1 = CRC_XOR (CRC_XOR (X1, X5), CRC_LOAD (Buffer));
+
+    Buffer     += 16;
+    LeftLength -= 16;
+  }
+
+  // The remainder is congruent to all processed bytes, so its CRC from a zero state is the new state
+  CRC_STORE (Remainder, X1);
+  *Length = LeftLength;
+
+  return ConfigCrc32Portable (0, Remainder, sizeof (Remainder));
+}
+
+/**
+  Advance a CRC32 state over a buffer with the CRC acceleration of the running CPU, when it has any.
+  Implementations may leave a tail of the buffer unprocessed, which the caller finishes with
+  ConfigCrc32Portable.
+
+  @param[in]      State   CRC32 state before Buffer.
+  @param[in]      Buffer  Pointer to the buffer.
+  @param[in,out]  Length  On input, size of Buffer in bytes. On output, the number of bytes
+                          at the end of Buffer that were not processed.
+
+  @return The CRC32 state after the processed part of Buffer.
+**/
+UINT32
+ConfigCrc32Accelerated (
+  IN     UINT32       State,
+  IN     CONST UINT8  *Buffer,
+  IN OUT UINTN        *Length
+  )
+{
+  UINT32  Ecx;
+
+  if (*Length < CRC_PCLMUL_MIN_LENGTH) {
+    return State;
+  }
+
+  // Not cached in a global, as this library may run from read-only memory in PEI
+  AsmCpuid (1, NULL, NULL, &Ecx, NULL);
+  if ((Ecx & BIT1) == 0) {
+    return State;
+  }
+
+  return ConfigCrc32Pclmul (State, Buffer, Length);
+}
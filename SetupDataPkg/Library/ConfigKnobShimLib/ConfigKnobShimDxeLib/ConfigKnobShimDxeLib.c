@@ -5,50 +5,132 @@
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
-#include <Uefi.h>
+#include <PiDxe.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
+#include <Library/ConfigPerfCounterLib.h>
 
 #include "../ConfigKnobShimLibCommon.h"
 
 /**
-  GetConfigKnobFromVariable returns the configuration knob from variable storage if it exists. This function is
-  abstracted to work with PEI, DXE, and Standalone MM.
+  LocateConfigKnobVariableServices finds the variable services of the current phase, so that several config knobs can
+  be read with a single lookup.
 
-  This function is only expected to be called by GetConfigKnobOverride.
+  @param[out] VariableServices    Phase specific variable services, only to be passed to
+                                  GetConfigKnobFromVariableServices.
 
+  @retval EFI_NOT_READY           Variable Services not available.
+  @retval !EFI_SUCCESS            Failed to locate variable services.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+LocateConfigKnobVariableServices (
+  OUT VOID  **VariableServices
+  )
+{
+  if (gRT == NULL) {
+    return EFI_NOT_READY;
+  }
+
+  *VariableServices = gRT;
+  return EFI_SUCCESS;
+}
+
+/**
+  GetConfigKnobFromVariableServices returns the configuration knob from variable storage if it exists, using variable
+  services returned by LocateConfigKnobVariableServices.
+
+  @param[in]  VariableServices      Variable services returned by LocateConfigKnobVariableServices.
   @param[in]  ConfigKnobGuid        The GUID of the requested config knob.
   @param[in]  ConfigKnobName        The name of the requested config knob.
-  @param[out] ConfigKnobData        The retrieved data of the requested config knob. The caller will allocate memory for
-                                    this buffer and is responsible for freeing it. This parameter is acceptable to be
+  @param[out] ConfigKnobData        The retrieved data of the requested config knob. This parameter is acceptable to be
                                     NULL if the data size is all that is requested.
-  @param[in out] ConfigKnobDataSize The allocated size of ConfigKnobData. This is expected to be set to the correct
-                                    value for the size of ConfigKnobData. If this size is too small for the config knob,
-                                    EFI_BUFFER_TOO_SMALL will be returned. This represents a mismatch in the profile
-                                    expected size and what is stored in variable storage, so the profile value will
-                                    take precedence.
-
-  @retval EFI_NOT_FOUND           The requested config knob was not found in the policy cache or variable storage. This
-                                  is expected when the config knob has not been updated from the profile default.
-  @retval EFI_BUFFER_TOO_SMALL    ConfigKnobDataSize as passed in was too small for this config knob. This is expected
-                                  if stale variables exist in flash.
-  @retval EFI_NOT_READY           Variable Services not available.
+  @param[in out] ConfigKnobDataSize The allocated size of ConfigKnobData. On return, the size of the config knob in
+                                    variable storage.
+
+  @retval EFI_NOT_FOUND           The requested config knob was not found in variable storage.
+  @retval EFI_BUFFER_TOO_SMALL    ConfigKnobDataSize as passed in was too small for this config knob.
   @retval !EFI_SUCCESS            Failed to read variable from variable storage.
   @retval EFI_SUCCESS             The operation succeeds.
 
 **/
 EFI_STATUS
-GetConfigKnobFromVariable (
+GetConfigKnobFromVariableServices (
+  IN VOID       *VariableServices,
   IN EFI_GUID   *ConfigKnobGuid,
   IN CHAR16     *ConfigKnobName,
   OUT VOID      *ConfigKnobData,
   IN OUT UINTN  *ConfigKnobDataSize
   )
 {
-  return gRT->GetVariable (
-                ConfigKnobName,
-                ConfigKnobGuid,
-                NULL,
-                ConfigKnobDataSize,
-                ConfigKnobData
-                );
+  EFI_RUNTIME_SERVICES  *RuntimeServices;
+
+  RuntimeServices = (EFI_RUNTIME_SERVICES *)VariableServices;
+
+  ConfigPerfCounterAdd (ConfigPerfCounterGetVariableCalls, 1);
+
+  return RuntimeServices->GetVariable (
+                            ConfigKnobName,
+                            ConfigKnobGuid,
+                            NULL,
+                            ConfigKnobDataSize,
+                            ConfigKnobData
+                            );
+}
+
+/**
+  SetConfigKnobToVariableServices writes a variable using variable services returned by
+  LocateConfigKnobVariableServices.
+
+  @param[in]  VariableServices      Variable services returned by LocateConfigKnobVariableServices.
+  @param[in]  VariableGuid          The GUID of the variable.
+  @param[in]  VariableName          The name of the variable.
+  @param[in]  Attributes            The attributes of the variable.
+  @param[in]  DataSize              The size of Data, 0 to delete the variable.
+  @param[in]  Data                  The contents of the variable.
+
+  @retval !EFI_SUCCESS            Failed to write the variable to variable storage.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+SetConfigKnobToVariableServices (
+  IN VOID      *VariableServices,
+  IN EFI_GUID  *VariableGuid,
+  IN CHAR16    *VariableName,
+  IN UINT32    Attributes,
+  IN UINTN     DataSize,
+  IN VOID      *Data
+  )
+{
+  EFI_RUNTIME_SERVICES  *RuntimeServices;
+
+  RuntimeServices = (EFI_RUNTIME_SERVICES *)VariableServices;
+
+  ConfigPerfCounterAdd (ConfigPerfCounterSetVariableCalls, 1);
+
+  return RuntimeServices->SetVariable (
+                            VariableName,
+                            VariableGuid,
+                            Attributes,
+                            DataSize,
+                            Data
+                            );
+}
+
+/**
+  BuildConfigKnobSnapshot allocates the snapshot of the overrides found by GetConfigKnobOverrides. Only PEI publishes
+  a snapshot, as the HOB list can no longer be extended by DXE drivers.
+
+  @param[in]  SnapshotSize        Size in bytes of the snapshot, including its CONFIG_KNOB_SNAPSHOT header.
+
+  @return NULL, this phase does not publish a snapshot.
+
+**/
+VOID *
+BuildConfigKnobSnapshot (
+  IN UINTN  SnapshotSize
+  )
+{
+  return NULL;
 }
@@ -0,0 +1,96 @@
+/** @file
+  Constructor of the DXE config knob shim, locking the cached config policy at ReadyToBoot.
+
+  The cached policy is trusted by GetConfigKnobCachedPolicy without validating the knobs again, so it must not be
+  writable once third party code can run.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <PiDxe.h>
+#include <Guid/MuVarPolicyFoundationDxe.h>
+#include <Protocol/VariablePolicy.h>
+#include <Library/DebugLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/VariablePolicyHelperLib.h>
+
+#include "../ConfigKnobShimLibCommon.h"
+
+/**
+  Register the ReadyToBoot lock of one variable of the cached config policy.
+
+  @param[in]  VariablePolicy    The variable policy protocol.
+  @param[in]  VariableName      The name of the variable to lock.
+
+  @retval EFI_SUCCESS             The lock is registered, possibly by another module linking this library.
+  @retval !EFI_SUCCESS            Failed to register the lock.
+
+**/
+STATIC
+EFI_STATUS
+RegisterConfigKnobPolicyCacheLock (
+  IN EDKII_VARIABLE_POLICY_PROTOCOL  *VariablePolicy,
+  IN CHAR16                          *VariableName
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = RegisterVarStateVariablePolicy (
+             VariablePolicy,
+             &gConfigKnobPolicyCacheVariableGuid,
+             VariableName,
+             VARIABLE_POLICY_NO_MIN_SIZE,
+             VARIABLE_POLICY_NO_MAX_SIZE,
+             CONFIG_KNOB_POLICY_CACHE_ATTRIBUTES,
+             (UINT32) ~CONFIG_KNOB_POLICY_CACHE_ATTRIBUTES,
+             &gMuVarPolicyDxePhaseGuid,
+             READY_TO_BOOT_INDICATOR_VAR_NAME,
+             PHASE_INDICATOR_SET
+             );
+
+  // Every driver linking this library registers the same policies
+  if (Status == EFI_ALREADY_STARTED) {
+    Status = EFI_SUCCESS;
+  }
+
+  return Status;
+}
+
+/**
+  Lock both variables of the cached config policy at ReadyToBoot, and allow only the attributes they are written with.
+
+  @param[in]  ImageHandle   The firmware allocated handle for the EFI image.
+  @param[in]  SystemTable   A pointer to the EFI System Table.
+
+  @retval EFI_SUCCESS       Always, a missing variable policy is reported but does not fail the driver.
+
+**/
+EFI_STATUS
+EFIAPI
+ConfigKnobShimDxeLibConstructor (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  )
+{
+  EFI_STATUS                      Status;
+  EDKII_VARIABLE_POLICY_PROTOCOL  *VariablePolicy = NULL;
+
+  Status = gBS->LocateProtocol (&gEdkiiVariablePolicyProtocolGuid, NULL, (VOID **)&VariablePolicy);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "%a: Variable policy not found, the cached config policy is not locked - %r\n", __FUNCTION__, Status));
+    return EFI_SUCCESS;
+  }
+
+  Status = RegisterConfigKnobPolicyCacheLock (VariablePolicy, CONFIG_KNOB_POLICY_CACHE_INFO_VARIABLE_NAME);
+  if (!EFI_ERROR (Status)) {
+    Status = RegisterConfigKnobPolicyCacheLock (VariablePolicy, CONFIG_KNOB_POLICY_CACHE_VARIABLE_NAME);
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to lock the cached config policy - %r\n", __FUNCTION__, Status));
+    ASSERT_EFI_ERROR (Status);
+  }
+
+  return EFI_SUCCESS;
+}
@@ -6,13 +6,81 @@
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
 **/
+#include <PiPei.h>
 #include <Uefi.h>
 #include <Library/BaseLib.h>
 #include <Library/DebugLib.h>
 #include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/HobLib.h>
+#include <Library/BaseCryptLib.h>
+#include <Library/ConfigCrcLib.h>
 #include <Library/ConfigKnobShimLib.h>
+#include <Library/ConfigPerfCounterLib.h>
+#include <Library/PerformanceLib.h>
 #include "ConfigKnobShimLibCommon.h"
 
+STATIC_ASSERT (CONFIG_KNOB_FINGERPRINT_SIZE == SHA256_DIGEST_SIZE, "A config knob fingerprint is a SHA-256 digest");
+
+/**
+  GetConfigKnobFromVariable returns the configuration knob from variable storage if it exists. This function is
+  abstracted to work with PEI, DXE, and Standalone MM.
+
+  This function is only expected to be called by GetConfigKnobOverride.
+
+  @param[in]  ConfigKnobGuid        The GUID of the requested config knob.
+  @param[in]  ConfigKnobName        The name of the requested config knob.
+  @param[out] ConfigKnobData        The retrieved data of the requested config knob. The caller will allocate memory for
+                                    this buffer and is responsible for freeing it. This parameter is acceptable to be
+                                    NULL if the data size is all that is requested.
+  @param[in out] ConfigKnobDataSize The allocated size of ConfigKnobData. This is expected to be set to the correct
+                                    value for the size of ConfigKnobData. If this size is too small for the config knob,
+                                    EFI_BUFFER_TOO_SMALL will be returned. This represents a mismatch in the profile
+                                    expected size and what is stored in variable storage, so the profile value will
+                                    take precedence.
+
+  @retval EFI_NOT_FOUND           The requested config knob was not found in the policy cache or variable storage. This
+                                  is expected when the config knob has not been updated from the profile default.
+  @retval EFI_BUFFER_TOO_SMALL    ConfigKnobDataSize as passed in was too small for this config knob. This is expected
+                                  if stale variables exist in flash.
+  @retval EFI_NOT_READY           Variable Services not available.
+  @retval !EFI_SUCCESS            Failed to read variable from variable storage.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+GetConfigKnobFromVariable (
+  IN EFI_GUID   *ConfigKnobGuid,
+  IN CHAR16     *ConfigKnobName,
+  OUT VOID      *ConfigKnobData,
+  IN OUT UINTN  *ConfigKnobDataSize
+  )
+{
+  EFI_STATUS  Status;
+  VOID        *VariableServices;
+
+  Status = LocateConfigKnobVariableServices (&VariableServices);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: Failed to locate variable services with status %r, falling back to profile value for config knob %s\n",
+      __FUNCTION__,
+      Status,
+      ConfigKnobName
+      ));
+
+    return Status;
+  }
+
+  return GetConfigKnobFromVariableServices (
+           VariableServices,
+           ConfigKnobGuid,
+           ConfigKnobName,
+           ConfigKnobData,
+           ConfigKnobDataSize
+           );
+}
+
 /**
   GetConfigKnobOverride searches for an override to the given config knob.
 
@@ -76,6 +144,8 @@ GetConfigKnobOverride (
 
 Exit:
   if (EFI_ERROR (Status)) {
+    ConfigPerfCounterAdd (ConfigPerfCounterOverrideMisses, 1);
+
     // we didn't find the override in variable storage, which is expected if the knob has not been overridden, or
     // the size mismatched. Only debug verbose here as this is expected to happen in the majority of cases.
     DEBUG ((
@@ -87,6 +157,681 @@ Exit:
       ConfigKnobDataSize,
       VariableSize
       ));
+  } else {
+    ConfigPerfCounterAdd (ConfigPerfCounterOverrideHits, 1);
+  }
+
+  return Status;
+}
+
+/**
+  Check that an entry of a list of config knobs can hold an override. The KNOB_MAX terminator of gKnobData cannot.
+
+  @param[in]  Knob    The config knob entry.
+
+  @retval TRUE        The entry has a name and a cache to write an override to.
+  @retval FALSE       The entry is skipped by GetConfigKnobOverrides.
+
+**/
+STATIC
+BOOLEAN
+IsConfigKnobEntryValid (
+  IN  CONST KNOB_DATA  *Knob
+  )
+{
+  return (Knob->Name != NULL) && (Knob->CacheValueAddress != NULL) && (Knob->ValueSize != 0);
+}
+
+/**
+  Checksum the namespace, name and size of every knob of a list, so that snapshots and fingerprints are tied to the list
+  of knobs they were taken from. Entries skipped by GetConfigKnobOverrides only count towards the knob count.
+
+  @param[in]  Knobs       Array of config knobs, as passed to GetConfigKnobOverrides.
+  @param[in]  KnobCount   Number of entries in Knobs.
+
+  @return The CRC32 of the layout of Knobs.
+
+**/
+STATIC
+UINT32
+GetConfigKnobLayoutCrc (
+  IN  CONST KNOB_DATA  *Knobs,
+  IN  UINTN            KnobCount
+  )
+{
+  UINT32  Crc;
+  UINT32  ValueSize;
+  UINTN   Index;
+
+  Crc = 0;
+  for (Index = 0; Index < KnobCount; Index++) {
+    if (!IsConfigKnobEntryValid (&Knobs[Index])) {
+      continue;
+    }
+
+    ValueSize = (UINT32)Knobs[Index].ValueSize;
+    Crc       = ConfigUpdateCrc32 (Crc, &Knobs[Index].VendorNamespace, sizeof (Knobs[Index].VendorNamespace));
+    Crc       = ConfigUpdateCrc32 (Crc, Knobs[Index].Name, AsciiStrSize (Knobs[Index].Name));
+    Crc       = ConfigUpdateCrc32 (Crc, &ValueSize, sizeof (ValueSize));
+  }
+
+  return Crc;
+}
+
+/**
+  Fetch the overrides of a list of config knobs from the snapshot published by an earlier phase, if there is one and
+  it was taken from the same list of knobs.
+
+  @param[in]  Knobs               Array of config knobs to search overrides for.
+  @param[in]  KnobCount           Number of entries in Knobs and KnobStatus.
+  @param[out] KnobStatus          Array of per knob results. Knobs without an override in the snapshot are set to
+                                  EFI_NOT_FOUND.
+
+  @retval EFI_NOT_FOUND           No snapshot was published.
+  @retval EFI_COMPROMISED_DATA    The snapshot is corrupted or was taken from another list of knobs, nothing was
+                                  written.
+  @retval EFI_SUCCESS             Every knob was resolved from the snapshot.
+
+**/
+STATIC
+EFI_STATUS
+GetConfigKnobOverridesFromSnapshot (
+  IN  CONST KNOB_DATA  *Knobs,
+  IN  UINTN            KnobCount,
+  OUT EFI_STATUS       *KnobStatus
+  )
+{
+  EFI_HOB_GUID_TYPE     *GuidHob;
+  CONFIG_KNOB_SNAPSHOT  *Snapshot;
+  UINT8                 *Bitmap;
+  UINT8                 *Values;
+  UINTN                 BitmapSize;
+  UINTN                 Offset;
+  UINTN                 Index;
+
+  GuidHob = GetFirstGuidHob (&gConfigKnobShimSnapshotHobGuid);
+  if (GuidHob == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  Snapshot   = (CONFIG_KNOB_SNAPSHOT *)GET_GUID_HOB_DATA (GuidHob);
+  BitmapSize = (KnobCount + 7) / 8;
+  if ((GET_GUID_HOB_DATA_SIZE (GuidHob) < sizeof (*Snapshot)) ||
+      (Snapshot->Signature != CONFIG_KNOB_SNAPSHOT_SIGNATURE) ||
+      (Snapshot->Version != CONFIG_KNOB_SNAPSHOT_VERSION) ||
+      (Snapshot->KnobCount != KnobCount) ||
+      (GET_GUID_HOB_DATA_SIZE (GuidHob) - sizeof (*Snapshot) < BitmapSize + Snapshot->ValuesSize) ||
+      (Snapshot->LayoutCrc32 != GetConfigKnobLayoutCrc (Knobs, KnobCount)) ||
+      (Snapshot->Crc32 != ConfigCalculateCrc32 (Snapshot + 1, BitmapSize + Snapshot->ValuesSize)))
+  {
+    DEBUG ((
+      DEBUG_WARN,
+      "%a: Config knob snapshot does not match the %u config knobs, ignoring it\n",
+      __FUNCTION__,
+      KnobCount
+      ));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  Bitmap = (UINT8 *)(Snapshot + 1);
+  Values = Bitmap + BitmapSize;
+
+  // Check the overridden knobs account for every value before writing any of them
+  Offset = 0;
+  for (Index = 0; Index < KnobCount; Index++) {
+    if ((Bitmap[Index / 8] & (1 << (Index % 8))) != 0) {
+      if (!IsConfigKnobEntryValid (&Knobs[Index])) {
+        break;
+      }
+
+      Offset += Knobs[Index].ValueSize;
+    }
+  }
+
+  if ((Index != KnobCount) || (Offset != Snapshot->ValuesSize)) {
+    DEBUG ((
+      DEBUG_WARN,
+      "%a: Config knob snapshot values do not match the %u config knobs, ignoring it\n",
+      __FUNCTION__,
+      KnobCount
+      ));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  Offset = 0;
+  for (Index = 0; Index < KnobCount; Index++) {
+    if (!IsConfigKnobEntryValid (&Knobs[Index])) {
+      KnobStatus[Index] = EFI_INVALID_PARAMETER;
+    } else if ((Bitmap[Index / 8] & (1 << (Index % 8))) != 0) {
+      CopyMem (Knobs[Index].CacheValueAddress, Values + Offset, Knobs[Index].ValueSize);
+      Offset           += Knobs[Index].ValueSize;
+      KnobStatus[Index] = EFI_SUCCESS;
+    } else {
+      KnobStatus[Index] = EFI_NOT_FOUND;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Publish the overrides found for a list of config knobs as a snapshot, if the current phase publishes one. No snapshot
+  is published if any knob failed with an unexpected error, as that may not fail again in a later phase.
+
+  @param[in]  Knobs               Array of config knobs searched by GetConfigKnobOverrides.
+  @param[in]  KnobCount           Number of entries in Knobs and KnobStatus.
+  @param[in]  KnobStatus          Array of per knob results of GetConfigKnobOverrides.
+
+**/
+STATIC
+VOID
+PublishConfigKnobSnapshot (
+  IN  CONST KNOB_DATA   *Knobs,
+  IN  UINTN             KnobCount,
+  IN  CONST EFI_STATUS  *KnobStatus
+  )
+{
+  CONFIG_KNOB_SNAPSHOT  *Snapshot;
+  UINT8                 *Bitmap;
+  UINT8                 *Values;
+  UINTN                 BitmapSize;
+  UINTN                 ValuesSize;
+  UINTN                 Index;
+
+  ValuesSize = 0;
+  for (Index = 0; Index < KnobCount; Index++) {
+    if (KnobStatus[Index] == EFI_SUCCESS) {
+      ValuesSize += Knobs[Index].ValueSize;
+    } else if ((KnobStatus[Index] != EFI_NOT_FOUND) && (KnobStatus[Index] != EFI_BAD_BUFFER_SIZE) &&
+               (KnobStatus[Index] != EFI_INVALID_PARAMETER))
+    {
+      return;
+    }
+  }
+
+  BitmapSize = (KnobCount + 7) / 8;
+  if (ValuesSize > CONFIG_KNOB_SNAPSHOT_MAX_SIZE - sizeof (*Snapshot) - BitmapSize) {
+    DEBUG ((
+      DEBUG_WARN,
+      "%a: %u bytes of config knob overrides are too large for a snapshot\n",
+      __FUNCTION__,
+      ValuesSize
+      ));
+    return;
+  }
+
+  Snapshot = (CONFIG_KNOB_SNAPSHOT *)BuildConfigKnobSnapshot (sizeof (*Snapshot) + BitmapSize + ValuesSize);
+  if (Snapshot == NULL) {
+    return;
+  }
+
+  Bitmap = (UINT8 *)(Snapshot + 1);
+  Values = Bitmap + BitmapSize;
+  ZeroMem (Bitmap, BitmapSize);
+
+  for (Index = 0; Index < KnobCount; Index++) {
+    if (KnobStatus[Index] == EFI_SUCCESS) {
+      Bitmap[Index / 8] |= (UINT8)(1 << (Index % 8));
+      CopyMem (Values, Knobs[Index].CacheValueAddress, Knobs[Index].ValueSize);
+      Values += Knobs[Index].ValueSize;
+    }
+  }
+
+  Snapshot->Signature   = CONFIG_KNOB_SNAPSHOT_SIGNATURE;
+  Snapshot->Version     = CONFIG_KNOB_SNAPSHOT_VERSION;
+  Snapshot->KnobCount   = (UINT32)KnobCount;
+  Snapshot->ValuesSize  = (UINT32)ValuesSize;
+  Snapshot->LayoutCrc32 = GetConfigKnobLayoutCrc (Knobs, KnobCount);
+  Snapshot->Crc32       = ConfigCalculateCrc32 (Bitmap, BitmapSize + ValuesSize);
+}
+
+/**
+  Count the overrides found and missed for a list of config knobs. Skipped entries, such as the KNOB_MAX terminator,
+  are not counted.
+
+  @param[in]  KnobCount           Number of entries in KnobStatus.
+  @param[in]  KnobStatus          Array of per knob results of GetConfigKnobOverrides.
+
+**/
+STATIC
+VOID
+CountConfigKnobOverrides (
+  IN  UINTN             KnobCount,
+  IN  CONST EFI_STATUS  *KnobStatus
+  )
+{
+  UINTN  Hits;
+  UINTN  Misses;
+  UINTN  Index;
+
+  Hits   = 0;
+  Misses = 0;
+  for (Index = 0; Index < KnobCount; Index++) {
+    if (KnobStatus[Index] == EFI_SUCCESS) {
+      Hits++;
+    } else if (KnobStatus[Index] != EFI_INVALID_PARAMETER) {
+      Misses++;
+    }
+  }
+
+  ConfigPerfCounterAdd (ConfigPerfCounterOverrideHits, Hits);
+  ConfigPerfCounterAdd (ConfigPerfCounterOverrideMisses, Misses);
+}
+
+/**
+  GetConfigKnobOverrides searches for overrides to a list of config knobs, locating variable services only once for
+  the whole list. Knobs that fit in CONFIG_KNOB_READ_BUFFER_SIZE are read from variable storage with a single call, as
+  their size is already known.
+
+  The overrides found in PEI are published as a snapshot HOB, which later calls for the same list of knobs, in PEI,
+  DXE or Standalone MM, resolve the knobs from instead of variable storage. The snapshot is ignored if it is corrupted
+  or was taken from another list of knobs.
+
+  For each knob, if the config override is found and the data size matches ValueSize, the buffer at CacheValueAddress
+  will be written with the override value. Otherwise, the buffer at CacheValueAddress is left untouched.
+
+  This function is only expected to be called from an OEM config policy creator.
+
+  @param[in]  Knobs               Array of config knobs to search overrides for, i.e. gKnobData. Entries with a NULL
+                                  Name or CacheValueAddress, such as the KNOB_MAX terminator, are skipped and marked
+                                  EFI_INVALID_PARAMETER.
+  @param[in]  KnobCount           Number of entries in Knobs and KnobStatus.
+  @param[out] KnobStatus          Array of per knob results, with the same meaning as the return values of
+                                  GetConfigKnobOverride. If variable services cannot be located, every entry is set
+                                  to that error.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null or KnobCount is 0.
+  @retval !EFI_SUCCESS            Failed to locate variable services.
+  @retval EFI_SUCCESS             Every knob was searched, see KnobStatus for the result of each one.
+
+**/
+EFI_STATUS
+EFIAPI
+GetConfigKnobOverrides (
+  IN  CONST KNOB_DATA  *Knobs,
+  IN  UINTN            KnobCount,
+  OUT EFI_STATUS       *KnobStatus
+  )
+{
+  EFI_STATUS  Status;
+  EFI_STATUS  SnapshotStatus;
+  VOID        *VariableServices = NULL;
+  UINTN       VariableSize;
+  UINTN       Index;
+  CHAR16      KnobName[CONFIG_KNOB_NAME_MAX_LENGTH];
+  UINT8       ReadBuffer[CONFIG_KNOB_READ_BUFFER_SIZE];
+
+  if ((Knobs == NULL) || (KnobCount == 0) || (KnobStatus == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a: Invalid parameter!\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  PERF_FUNCTION_BEGIN ();
+
+  SnapshotStatus = GetConfigKnobOverridesFromSnapshot (Knobs, KnobCount, KnobStatus);
+  if (!EFI_ERROR (SnapshotStatus)) {
+    Status = EFI_SUCCESS;
+    goto Exit;
+  }
+
+  Status = LocateConfigKnobVariableServices (&VariableServices);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: Failed to locate variable services with status %r, falling back to profile values for %u config knobs\n",
+      __FUNCTION__,
+      Status,
+      KnobCount
+      ));
+
+    for (Index = 0; Index < KnobCount; Index++) {
+      KnobStatus[Index] = Status;
+    }
+
+    goto Exit;
+  }
+
+  for (Index = 0; Index < KnobCount; Index++) {
+    if (!IsConfigKnobEntryValid (&Knobs[Index])) {
+      KnobStatus[Index] = EFI_INVALID_PARAMETER;
+      continue;
+    }
+
+    Status = AsciiStrToUnicodeStrS (Knobs[Index].Name, KnobName, ARRAY_SIZE (KnobName));
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a: Config knob %a has an invalid name\n", __FUNCTION__, Knobs[Index].Name));
+      KnobStatus[Index] = EFI_INVALID_PARAMETER;
+      continue;
+    }
+
+    VariableSize = Knobs[Index].ValueSize;
+    if (VariableSize <= sizeof (ReadBuffer)) {
+      // Read in one go. A smaller variable would be returned successfully, so read aside to not clobber the knob.
+      Status = GetConfigKnobFromVariableServices (
+                 VariableServices,
+                 (EFI_GUID *)&Knobs[Index].VendorNamespace,
+                 KnobName,
+                 ReadBuffer,
+                 &VariableSize
+                 );
+      if (!EFI_ERROR (Status) && (VariableSize == Knobs[Index].ValueSize)) {
+        CopyMem (Knobs[Index].CacheValueAddress, ReadBuffer, VariableSize);
+      }
+    } else {
+      // Too large to read aside, check the size in variable storage first
+      VariableSize = 0;
+      Status       = GetConfigKnobFromVariableServices (
+                       VariableServices,
+                       (EFI_GUID *)&Knobs[Index].VendorNamespace,
+                       KnobName,
+                       NULL,
+                       &VariableSize
+                       );
+      if ((Status == EFI_BUFFER_TOO_SMALL) && (VariableSize == Knobs[Index].ValueSize)) {
+        Status = GetConfigKnobFromVariableServices (
+                   VariableServices,
+                   (EFI_GUID *)&Knobs[Index].VendorNamespace,
+                   KnobName,
+                   Knobs[Index].CacheValueAddress,
+                   &VariableSize
+                   );
+      }
+    }
+
+    if ((Status == EFI_BUFFER_TOO_SMALL) || (!EFI_ERROR (Status) && (VariableSize != Knobs[Index].ValueSize))) {
+      // we will only accept this variable if it is the correct size
+      Status = EFI_BAD_BUFFER_SIZE;
+    }
+
+    if (EFI_ERROR (Status)) {
+      // Only debug verbose here as this is expected to happen in the majority of cases.
+      DEBUG ((
+        DEBUG_VERBOSE,
+        "%a: failed to find override for config knob %a with status %r. Expected size: %u, found size: %u.\n",
+        __FUNCTION__,
+        Knobs[Index].Name,
+        Status,
+        Knobs[Index].ValueSize,
+        VariableSize
+        ));
+    }
+
+    KnobStatus[Index] = Status;
+  }
+
+  // Only the first snapshot is ever found, so never publish another one
+  if (SnapshotStatus == EFI_NOT_FOUND) {
+    PublishConfigKnobSnapshot (Knobs, KnobCount, KnobStatus);
+  }
+
+  Status = EFI_SUCCESS;
+
+Exit:
+  CountConfigKnobOverrides (KnobCount, KnobStatus);
+  PERF_FUNCTION_END ();
+  return Status;
+}
+
+/**
+  GetConfigKnobFingerprint computes a fingerprint of the current values of a list of config knobs, for a config policy
+  creator to tell whether the policy it validated and cached on a previous boot can be published as is.
+
+  The fingerprint is the SHA-256 of the active profile index, the namespace, name and size of every knob, and the
+  value at the CacheValueAddress of every knob. It is expected to be computed once the active profile and the
+  overrides found by GetConfigKnobOverrides have been applied to the cached knob values, and before any knob is
+  validated.
+
+  @param[in]  Knobs               Array of config knobs, i.e. gKnobData. Entries with a NULL Name or
+                                  CacheValueAddress, such as the KNOB_MAX terminator, are skipped.
+  @param[in]  KnobCount           Number of entries in Knobs.
+  @param[in]  ActiveProfileIndex  The active profile index for this boot, as returned by GetActiveProfileIndex.
+  @param[out] Fingerprint         The fingerprint of the knob values.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null or KnobCount is 0.
+  @retval EFI_OUT_OF_RESOURCES    The hash context could not be allocated.
+  @retval EFI_ABORTED             Hashing the knob values failed.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+GetConfigKnobFingerprint (
+  IN  CONST KNOB_DATA          *Knobs,
+  IN  UINTN                    KnobCount,
+  IN  UINT32                   ActiveProfileIndex,
+  OUT CONFIG_KNOB_FINGERPRINT  *Fingerprint
+  )
+{
+  VOID     *HashContext;
+  UINT32   ValueSize;
+  UINTN    Index;
+  BOOLEAN  Result;
+
+  if ((Knobs == NULL) || (KnobCount == 0) || (Fingerprint == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a: Invalid parameter!\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  HashContext = AllocatePool (Sha256GetContextSize ());
+  if (HashContext == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  // The layout is hashed in full rather than through its CRC32, so that no part of the fingerprint can be forged
+  Result = Sha256Init (HashContext) &&
+           Sha256Update (HashContext, &ActiveProfileIndex, sizeof (ActiveProfileIndex));
+  for (Index = 0; Result && (Index < KnobCount); Index++) {
+    if (IsConfigKnobEntryValid (&Knobs[Index])) {
+      ValueSize = (UINT32)Knobs[Index].ValueSize;
+      Result    = Sha256Update (HashContext, &Knobs[Index].VendorNamespace, sizeof (Knobs[Index].VendorNamespace)) &&
+                  Sha256Update (HashContext, Knobs[Index].Name, AsciiStrSize (Knobs[Index].Name)) &&
+                  Sha256Update (HashContext, &ValueSize, sizeof (ValueSize)) &&
+                  Sha256Update (HashContext, Knobs[Index].CacheValueAddress, Knobs[Index].ValueSize);
+    }
+  }
+
+  Result = Result && Sha256Final (HashContext, Fingerprint->Digest);
+  FreePool (HashContext);
+
+  if (!Result) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to hash the knob values!\n", __FUNCTION__));
+    return EFI_ABORTED;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  GetConfigKnobCachedPolicy returns the config policy cached by SetConfigKnobCachedPolicy, if it was cached with the
+  same fingerprint. The policy is checked against the SHA-256 it was cached with.
+
+  @param[in]  Fingerprint         The fingerprint of the current knob values, from GetConfigKnobFingerprint.
+  @param[out] Policy              The cached policy. This parameter is acceptable to be NULL if *PolicySize is 0.
+  @param[in out] PolicySize       The allocated size of Policy. On return, the size of the cached policy.
+
+  @retval EFI_INVALID_PARAMETER   Fingerprint or PolicySize is null, or Policy is null and *PolicySize is not 0.
+  @retval EFI_NOT_FOUND           No policy is cached, or it was cached with another fingerprint.
+  @retval EFI_BUFFER_TOO_SMALL    *PolicySize was too small for the cached policy, and is updated with its size.
+  @retval EFI_COMPROMISED_DATA    The cached policy is corrupted.
+  @retval !EFI_SUCCESS            Failed to read the cached policy from variable storage.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+GetConfigKnobCachedPolicy (
+  IN     CONST CONFIG_KNOB_FINGERPRINT  *Fingerprint,
+  OUT    VOID                           *Policy OPTIONAL,
+  IN OUT UINTN                          *PolicySize
+  )
+{
+  EFI_STATUS                     Status;
+  VOID                           *VariableServices = NULL;
+  CONFIG_KNOB_POLICY_CACHE_INFO  Info;
+  UINTN                          VariableSize;
+  UINT8                          PolicyDigest[SHA256_DIGEST_SIZE];
+
+  if ((Fingerprint == NULL) || (PolicySize == NULL) || ((Policy == NULL) && (*PolicySize != 0))) {
+    DEBUG ((DEBUG_ERROR, "%a: Invalid parameter!\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = LocateConfigKnobVariableServices (&VariableServices);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to locate variable services with status %r\n", __FUNCTION__, Status));
+    return Status;
+  }
+
+  VariableSize = sizeof (Info);
+  Status       = GetConfigKnobFromVariableServices (
+                   VariableServices,
+                   &gConfigKnobPolicyCacheVariableGuid,
+                   CONFIG_KNOB_POLICY_CACHE_INFO_VARIABLE_NAME,
+                   &Info,
+                   &VariableSize
+                   );
+  if (Status == EFI_BUFFER_TOO_SMALL) {
+    Status = EFI_COMPROMISED_DATA;
+  }
+
+  if (!EFI_ERROR (Status) &&
+      ((VariableSize != sizeof (Info)) || (Info.Signature != CONFIG_KNOB_POLICY_CACHE_SIGNATURE)))
+  {
+    Status = EFI_COMPROMISED_DATA;
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "%a: No usable cached config policy (%r)\n", __FUNCTION__, Status));
+    return Status;
+  }
+
+  if (CompareMem (&Info.Fingerprint, Fingerprint, sizeof (Info.Fingerprint)) != 0) {
+    DEBUG ((DEBUG_INFO, "%a: Cached config policy is for another fingerprint\n", __FUNCTION__));
+    return EFI_NOT_FOUND;
+  }
+
+  if (*PolicySize < Info.PolicySize) {
+    *PolicySize = Info.PolicySize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  VariableSize = *PolicySize;
+  Status       = GetConfigKnobFromVariableServices (
+                   VariableServices,
+                   &gConfigKnobPolicyCacheVariableGuid,
+                   CONFIG_KNOB_POLICY_CACHE_VARIABLE_NAME,
+                   Policy,
+                   &VariableSize
+                   );
+  if ((Status == EFI_NOT_FOUND) || (Status == EFI_BUFFER_TOO_SMALL) ||
+      (!EFI_ERROR (Status) && ((VariableSize != Info.PolicySize) ||
+                               !Sha256HashAll (Policy, VariableSize, PolicyDigest) ||
+                               (CompareMem (PolicyDigest, Info.PolicyDigest, sizeof (PolicyDigest)) != 0))))
+  {
+    DEBUG ((DEBUG_WARN, "%a: Cached config policy does not match its info, ignoring it\n", __FUNCTION__));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  *PolicySize = VariableSize;
+  return EFI_SUCCESS;
+}
+
+/**
+  SetConfigKnobCachedPolicy caches a validated config policy in variable storage, for GetConfigKnobCachedPolicy to
+  return on the next boots with the same fingerprint. Variable storage is read only in PEI, so the policy has to be
+  cached from DXE or Standalone MM, and before ReadyToBoot once the DXE shim locked the cache.
+
+  The info variable is deleted first and written last, so an interrupted update leaves no cached policy rather than a
+  mismatched one.
+
+  @param[in]  Fingerprint         The fingerprint of the knob values the policy was built from.
+  @param[in]  Policy              The validated policy.
+  @param[in]  PolicySize          The size of Policy.
+
+  @retval EFI_INVALID_PARAMETER   Fingerprint or Policy is null, or PolicySize is 0 or larger than MAX_UINT32.
+  @retval EFI_WRITE_PROTECTED     Variable storage cannot be written in this phase, or the cache is locked.
+  @retval EFI_ABORTED             Hashing the policy failed.
+  @retval !EFI_SUCCESS            Failed to write the cached policy to variable storage.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+SetConfigKnobCachedPolicy (
+  IN CONST CONFIG_KNOB_FINGERPRINT  *Fingerprint,
+  IN CONST VOID                     *Policy,
+  IN UINTN                          PolicySize
+  )
+{
+  EFI_STATUS                     Status;
+  VOID                           *VariableServices = NULL;
+  CONFIG_KNOB_POLICY_CACHE_INFO  Info;
+
+  if ((Fingerprint == NULL) || (Policy == NULL) || (PolicySize == 0) || (PolicySize > MAX_UINT32)) {
+    DEBUG ((DEBUG_ERROR, "%a: Invalid parameter!\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Info.Signature  = CONFIG_KNOB_POLICY_CACHE_SIGNATURE;
+  Info.PolicySize = (UINT32)PolicySize;
+  CopyMem (&Info.Fingerprint, Fingerprint, sizeof (Info.Fingerprint));
+  if (!Sha256HashAll (Policy, PolicySize, Info.PolicyDigest)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to hash the config policy!\n", __FUNCTION__));
+    return EFI_ABORTED;
+  }
+
+  Status = LocateConfigKnobVariableServices (&VariableServices);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to locate variable services with status %r\n", __FUNCTION__, Status));
+    return Status;
+  }
+
+  Status = SetConfigKnobToVariableServices (
+             VariableServices,
+             &gConfigKnobPolicyCacheVariableGuid,
+             CONFIG_KNOB_POLICY_CACHE_INFO_VARIABLE_NAME,
+             0,
+             0,
+             NULL
+             );
+  if (EFI_ERROR (Status) && (Status != EFI_NOT_FOUND)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to invalidate the cached config policy with status %r\n", __FUNCTION__, Status));
+    return Status;
+  }
+
+  Status = SetConfigKnobToVariableServices (
+             VariableServices,
+             &gConfigKnobPolicyCacheVariableGuid,
+             CONFIG_KNOB_POLICY_CACHE_VARIABLE_NAME,
+             CONFIG_KNOB_POLICY_CACHE_ATTRIBUTES,
+             PolicySize,
+             (VOID *)Policy
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a: Failed to cache a %u byte config policy with status %r\n",
+      __FUNCTION__,
+      PolicySize,
+      Status
+      ));
+    return Status;
+  }
+
+  Status = SetConfigKnobToVariableServices (
+             VariableServices,
+             &gConfigKnobPolicyCacheVariableGuid,
+             CONFIG_KNOB_POLICY_CACHE_INFO_VARIABLE_NAME,
+             CONFIG_KNOB_POLICY_CACHE_ATTRIBUTES,
+             sizeof (Info),
+             &Info
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: Failed to write the cached config policy info with status %r\n", __FUNCTION__, Status));
   }
 
   return Status;
@@ -9,6 +9,46 @@
 #ifndef CONFIG_KNOB_SHIM_LIB_COMMON_H_
 #define CONFIG_KNOB_SHIM_LIB_COMMON_H_
 
+// Maximum config knob name length accepted in characters, matching CONF_VAR_NAME_LEN of ConfigVariableListLib.
+#define CONFIG_KNOB_NAME_MAX_LENGTH  0x80
+
+// Knobs up to this size in bytes are read from variable storage with a single call when fetched in a batch.
+#define CONFIG_KNOB_READ_BUFFER_SIZE  0x100
+
+#define CONFIG_KNOB_SNAPSHOT_SIGNATURE  SIGNATURE_32 ('C', 'K', 'S', 'S')
+#define CONFIG_KNOB_SNAPSHOT_VERSION    1
+
+// Largest snapshot that fits in the data of a GUID HOB.
+#define CONFIG_KNOB_SNAPSHOT_MAX_SIZE  (0xFFF8 - sizeof (EFI_HOB_GUID_TYPE))
+
+//
+// Snapshot of the overrides found by GetConfigKnobOverrides, published by the PEI shim as a GUID HOB so that later
+// phases resolve the same list of knobs without reading variable storage again. The header is followed by a bitmap
+// of the knobs with an override, one bit per knob, then the override values of those knobs in knob order.
+//
+typedef struct {
+  UINT32    Signature;   // CONFIG_KNOB_SNAPSHOT_SIGNATURE
+  UINT32    Version;     // CONFIG_KNOB_SNAPSHOT_VERSION
+  UINT32    KnobCount;   // Number of knobs, and bits of the override bitmap
+  UINT32    ValuesSize;  // Size in bytes of the override values following the bitmap
+  UINT32    LayoutCrc32; // CRC32 of the namespace, name and size of every knob, see GetConfigKnobLayoutCrc
+  UINT32    Crc32;       // CRC32 of the override bitmap and values
+  // UINT8  OverrideBitmap[(KnobCount + 7) / 8];
+  // UINT8  Values[ValuesSize];
+} CONFIG_KNOB_SNAPSHOT;
+
+#define CONFIG_KNOB_POLICY_CACHE_SIGNATURE  SIGNATURE_32 ('C', 'K', 'P', 'C')
+
+//
+// Contents of the CONFIG_KNOB_POLICY_CACHE_INFO_VARIABLE_NAME variable, describing the cached config policy.
+//
+typedef struct {
+  UINT32                     Signature;                                  // CONFIG_KNOB_POLICY_CACHE_SIGNATURE
+  UINT32                     PolicySize;                                 // Size in bytes of the cached policy
+  CONFIG_KNOB_FINGERPRINT    Fingerprint;                                // Of the knob values the policy was built from
+  UINT8                      PolicyDigest[CONFIG_KNOB_FINGERPRINT_SIZE]; // SHA-256 of the cached policy
+} CONFIG_KNOB_POLICY_CACHE_INFO;
+
 /**
   GetConfigKnobFromVariable returns the configuration knob from variable storage if it exists. This function is
   abstracted to work with PEI, DXE, and Standalone MM.
@@ -43,4 +83,90 @@ GetConfigKnobFromVariable (
   IN OUT UINTN  *ConfigKnobDataSize
   );
 
+/**
+  LocateConfigKnobVariableServices finds the variable services of the current phase, so that several config knobs can
+  be read with a single lookup. This function is implemented separately for PEI, DXE, and Standalone MM.
+
+  @param[out] VariableServices    Phase specific variable services, only to be passed to
+                                  GetConfigKnobFromVariableServices.
+
+  @retval EFI_NOT_READY           Variable Services not available.
+  @retval !EFI_SUCCESS            Failed to locate variable services.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+LocateConfigKnobVariableServices (
+  OUT VOID  **VariableServices
+  );
+
+/**
+  GetConfigKnobFromVariableServices returns the configuration knob from variable storage if it exists, using variable
+  services returned by LocateConfigKnobVariableServices. This function is implemented separately for PEI, DXE, and
+  Standalone MM.
+
+  @param[in]  VariableServices      Variable services returned by LocateConfigKnobVariableServices.
+  @param[in]  ConfigKnobGuid        The GUID of the requested config knob.
+  @param[in]  ConfigKnobName        The name of the requested config knob.
+  @param[out] ConfigKnobData        The retrieved data of the requested config knob. This parameter is acceptable to be
+                                    NULL if the data size is all that is requested.
+  @param[in out] ConfigKnobDataSize The allocated size of ConfigKnobData. On return, the size of the config knob in
+                                    variable storage.
+
+  @retval EFI_NOT_FOUND           The requested config knob was not found in variable storage.
+  @retval EFI_BUFFER_TOO_SMALL    ConfigKnobDataSize as passed in was too small for this config knob.
+  @retval !EFI_SUCCESS            Failed to read variable from variable storage.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+GetConfigKnobFromVariableServices (
+  IN VOID       *VariableServices,
+  IN EFI_GUID   *ConfigKnobGuid,
+  IN CHAR16     *ConfigKnobName,
+  OUT VOID      *ConfigKnobData,
+  IN OUT UINTN  *ConfigKnobDataSize
+  );
+
+/**
+  SetConfigKnobToVariableServices writes a variable using variable services returned by
+  LocateConfigKnobVariableServices. This function is implemented separately for PEI, DXE, and Standalone MM.
+
+  @param[in]  VariableServices      Variable services returned by LocateConfigKnobVariableServices.
+  @param[in]  VariableGuid          The GUID of the variable.
+  @param[in]  VariableName          The name of the variable.
+  @param[in]  Attributes            The attributes of the variable.
+  @param[in]  DataSize              The size of Data, 0 to delete the variable.
+  @param[in]  Data                  The contents of the variable.
+
+  @retval EFI_WRITE_PROTECTED     Variable storage cannot be written in this phase.
+  @retval !EFI_SUCCESS            Failed to write the variable to variable storage.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+SetConfigKnobToVariableServices (
+  IN VOID      *VariableServices,
+  IN EFI_GUID  *VariableGuid,
+  IN CHAR16    *VariableName,
+  IN UINT32    Attributes,
+  IN UINTN     DataSize,
+  IN VOID      *Data
+  );
+
+/**
+  BuildConfigKnobSnapshot allocates the snapshot of the overrides found by GetConfigKnobOverrides, for later lookups
+  to use instead of variable storage. This function is implemented separately for PEI, DXE, and Standalone MM, only
+  PEI publishes a snapshot.
+
+  @param[in]  SnapshotSize        Size in bytes of the snapshot, including its CONFIG_KNOB_SNAPSHOT header.
+
+  @return The buffer to fill in with the snapshot, or NULL if this phase does not publish one.
+
+**/
+VOID *
+BuildConfigKnobSnapshot (
+  IN UINTN  SnapshotSize
+  );
+
 #endif // CONFIG_KNOB_SHIM_LIB_COMMON_H_
@@ -9,66 +9,170 @@
 #include <Uefi.h>
 #include <Library/BaseLib.h>
 #include <Library/DebugLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/HobLib.h>
 #include <Library/PeiServicesLib.h>
 #include <Ppi/ReadOnlyVariable2.h>
+#include <Ppi/MemoryDiscovered.h>
+#include <Library/ConfigPerfCounterLib.h>
 
 #include "../ConfigKnobShimLibCommon.h"
 
+//
+// PEI module globals may live in flash, so the located variable PPI is cached in a GUID HOB instead.
+//
+typedef struct {
+  EFI_PEI_READ_ONLY_VARIABLE2_PPI    *VariablePpi;
+  BOOLEAN                            NotifyRegistered;
+} CONFIG_KNOB_SHIM_VARIABLE_CACHE;
+
+/**
+  Keep the cached variable PPI in sync with the PPI database.
+
+  When the variable PPI is installed or reinstalled, e.g. after its PEIM is shadowed to memory, the cache is updated
+  with the new instance. When permanent memory is installed, the cache is dropped, as the PPI may have been migrated
+  out of temporary RAM.
+
+  @param[in]  PeiServices       An indirect pointer to the EFI_PEI_SERVICES table published by the PEI Foundation.
+  @param[in]  NotifyDescriptor  Address of the notification descriptor data structure.
+  @param[in]  Ppi               Address of the PPI that was installed.
+
+  @retval EFI_SUCCESS           The cache was updated.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+ConfigKnobShimVariablePpiNotify (
+  IN EFI_PEI_SERVICES           **PeiServices,
+  IN EFI_PEI_NOTIFY_DESCRIPTOR  *NotifyDescriptor,
+  IN VOID                       *Ppi
+  )
+{
+  EFI_HOB_GUID_TYPE                *GuidHob;
+  CONFIG_KNOB_SHIM_VARIABLE_CACHE  *Cache;
+
+  GuidHob = GetFirstGuidHob (&gConfigKnobShimVariableCacheHobGuid);
+  if (GuidHob == NULL) {
+    return EFI_SUCCESS;
+  }
+
+  Cache = (CONFIG_KNOB_SHIM_VARIABLE_CACHE *)GET_GUID_HOB_DATA (GuidHob);
+  if (CompareGuid (NotifyDescriptor->Guid, &gEfiPeiReadOnlyVariable2PpiGuid)) {
+    Cache->VariablePpi = (EFI_PEI_READ_ONLY_VARIABLE2_PPI *)Ppi;
+  } else {
+    Cache->VariablePpi = NULL;
+  }
+
+  return EFI_SUCCESS;
+}
+
+STATIC CONST EFI_PEI_NOTIFY_DESCRIPTOR  mConfigKnobShimNotifyList[] = {
+  {
+    EFI_PEI_PPI_DESCRIPTOR_NOTIFY_CALLBACK,
+    &gEfiPeiReadOnlyVariable2PpiGuid,
+    ConfigKnobShimVariablePpiNotify
+  },
+  {
+    (EFI_PEI_PPI_DESCRIPTOR_NOTIFY_CALLBACK | EFI_PEI_PPI_DESCRIPTOR_TERMINATE_LIST),
+    &gEfiPeiMemoryDiscoveredPpiGuid,
+    ConfigKnobShimVariablePpiNotify
+  }
+};
+
 /**
-  GetConfigKnobFromVariable returns the configuration knob from variable storage if it exists. This function is
-  abstracted to work with PEI, DXE, and Standalone MM.
+  LocateConfigKnobVariableServices finds the variable services of the current phase, so that several config knobs can
+  be read with a single lookup.
+
+  The variable PPI is cached in a GUID HOB once located, so later calls skip the PPI database walk.
 
-  This function is only expected to be called by GetConfigKnobOverride.
+  @param[out] VariableServices    Phase specific variable services, only to be passed to
+                                  GetConfigKnobFromVariableServices.
 
+  @retval EFI_NOT_READY           Variable Services not available.
+  @retval !EFI_SUCCESS            Failed to locate variable services.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+LocateConfigKnobVariableServices (
+  OUT VOID  **VariableServices
+  )
+{
+  EFI_STATUS                       Status;
+  EFI_HOB_GUID_TYPE                *GuidHob;
+  CONFIG_KNOB_SHIM_VARIABLE_CACHE  *Cache;
+
+  GuidHob = GetFirstGuidHob (&gConfigKnobShimVariableCacheHobGuid);
+  if (GuidHob != NULL) {
+    Cache = (CONFIG_KNOB_SHIM_VARIABLE_CACHE *)GET_GUID_HOB_DATA (GuidHob);
+  } else {
+    Cache = (CONFIG_KNOB_SHIM_VARIABLE_CACHE *)BuildGuidHob (&gConfigKnobShimVariableCacheHobGuid, sizeof (*Cache));
+    if (Cache != NULL) {
+      ZeroMem (Cache, sizeof (*Cache));
+    }
+  }
+
+  if ((Cache != NULL) && !Cache->NotifyRegistered) {
+    // If the variable PPI is already installed, this fills the cache straight away
+    Status = PeiServicesNotifyPpi (mConfigKnobShimNotifyList);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "%a: Failed to register for variable PPI notifications (%r), not caching it\n", __FUNCTION__, Status));
+    } else {
+      Cache->NotifyRegistered = TRUE;
+    }
+  }
+
+  if ((Cache != NULL) && Cache->NotifyRegistered && (Cache->VariablePpi != NULL)) {
+    *VariableServices = Cache->VariablePpi;
+    return EFI_SUCCESS;
+  }
+
+  Status = PeiServicesLocatePpi (
+             &gEfiPeiReadOnlyVariable2PpiGuid,
+             0,
+             NULL,
+             VariableServices
+             );
+  if (!EFI_ERROR (Status) && (Cache != NULL) && Cache->NotifyRegistered) {
+    Cache->VariablePpi = (EFI_PEI_READ_ONLY_VARIABLE2_PPI *)*VariableServices;
+  }
+
+  return Status;
+}
+
+/**
+  GetConfigKnobFromVariableServices returns the configuration knob from variable storage if it exists, using variable
+  services returned by LocateConfigKnobVariableServices.
+
+  @param[in]  VariableServices      Variable services returned by LocateConfigKnobVariableServices.
   @param[in]  ConfigKnobGuid        The GUID of the requested config knob.
   @param[in]  ConfigKnobName        The name of the requested config knob.
-  @param[out] ConfigKnobData        The retrieved data of the requested config knob. The caller will allocate memory for
-                                    this buffer and is responsible for freeing it. This parameter is acceptable to be
+  @param[out] ConfigKnobData        The retrieved data of the requested config knob. This parameter is acceptable to be
                                     NULL if the data size is all that is requested.
-  @param[in out] ConfigKnobDataSize The allocated size of ConfigKnobData. This is expected to be set to the correct
-                                    value for the size of ConfigKnobData. If this size is too small for the config knob,
-                                    EFI_BUFFER_TOO_SMALL will be returned. This represents a mismatch in the profile
-                                    expected size and what is stored in variable storage, so the profile value will
-                                    take precedence.
-
-  @retval EFI_NOT_FOUND           The requested config knob was not found in the policy cache or variable storage. This
-                                  is expected when the config knob has not been updated from the profile default.
-  @retval EFI_BUFFER_TOO_SMALL    ConfigKnobDataSize as passed in was too small for this config knob. This is expected
-                                  if stale variables exist in flash.
-  @retval EFI_NOT_READY           Variable Services not available.
+  @param[in out] ConfigKnobDataSize The allocated size of ConfigKnobData. On return, the size of the config knob in
+                                    variable storage.
+
+  @retval EFI_NOT_FOUND           The requested config knob was not found in variable storage.
+  @retval EFI_BUFFER_TOO_SMALL    ConfigKnobDataSize as passed in was too small for this config knob.
   @retval !EFI_SUCCESS            Failed to read variable from variable storage.
   @retval EFI_SUCCESS             The operation succeeds.
 
 **/
 EFI_STATUS
-GetConfigKnobFromVariable (
+GetConfigKnobFromVariableServices (
+  IN VOID       *VariableServices,
   IN EFI_GUID   *ConfigKnobGuid,
   IN CHAR16     *ConfigKnobName,
   OUT VOID      *ConfigKnobData,
   IN OUT UINTN  *ConfigKnobDataSize
   )
 {
-  EFI_STATUS                       Status;
   EFI_PEI_READ_ONLY_VARIABLE2_PPI  *PPIVariableServices;
 
-  Status = PeiServicesLocatePpi (
-             &gEfiPeiReadOnlyVariable2PpiGuid,
-             0,
-             NULL,
-             (VOID **)&PPIVariableServices
-             );
+  PPIVariableServices = (EFI_PEI_READ_ONLY_VARIABLE2_PPI *)VariableServices;
 
-  if (EFI_ERROR (Status)) {
-    DEBUG ((
-      DEBUG_ERROR,
-      "%a: Failed to locate variable services with status %r, falling back to profile value for config knob %a\n",
-      __FUNCTION__,
-      Status,
-      ConfigKnobName
-      ));
-
-    return Status;
-  }
+  ConfigPerfCounterAdd (ConfigPerfCounterGetVariableCalls, 1);
 
   return PPIVariableServices->GetVariable (
                                 PPIVariableServices,
@@ -79,3 +183,52 @@ GetConfigKnobFromVariable (
                                 ConfigKnobData
                                 );
 }
+
+/**
+  SetConfigKnobToVariableServices writes a variable using variable services returned by
+  LocateConfigKnobVariableServices. Variable storage is read only in PEI, so this always
+  fails.
+
+  @param[in]  VariableServices      Variable services returned by LocateConfigKnobVariableServices.
+  @param[in]  VariableGuid          The GUID of the variable.
+  @param[in]  VariableName          The name of the variable.
+  @param[in]  Attributes            The attributes of the variable.
+  @param[in]  DataSize              The size of Data, 0 to delete the variable.
+  @param[in]  Data                  The contents of the variable.
+
+  @retval EFI_WRITE_PROTECTED     Variable storage cannot be written in PEI.
+
+**/
+EFI_STATUS
+SetConfigKnobToVariableServices (
+  IN VOID      *VariableServices,
+  IN EFI_GUID  *VariableGuid,
+  IN CHAR16    *VariableName,
+  IN UINT32    Attributes,
+  IN UINTN     DataSize,
+  IN VOID      *Data
+  )
+{
+  return EFI_WRITE_PROTECTED;
+}
+
+/**
+  BuildConfigKnobSnapshot allocates the snapshot of the overrides found by GetConfigKnobOverrides as a GUID HOB, so
+  that DXE and Standalone MM resolve the same knobs without reading variable storage again.
+
+  @param[in]  SnapshotSize        Size in bytes of the snapshot, including its CONFIG_KNOB_SNAPSHOT header.
+
+  @return The data of the snapshot HOB, or NULL if it could not be built.
+
+**/
+VOID *
+BuildConfigKnobSnapshot (
+  IN UINTN  SnapshotSize
+  )
+{
+  if (SnapshotSize > CONFIG_KNOB_SNAPSHOT_MAX_SIZE) {
+    return NULL;
+  }
+
+  return BuildGuidHob (&gConfigKnobShimSnapshotHobGuid, SnapshotSize);
+}
@@ -12,63 +12,118 @@
 #include <Library/PeiServicesLib.h>
 #include <Library/MmServicesTableLib.h>
 #include <Protocol/SmmVariable.h>
+#include <Library/ConfigPerfCounterLib.h>
 
 #include "../ConfigKnobShimLibCommon.h"
 
+STATIC EFI_SMM_VARIABLE_PROTOCOL  *mMmVariableServices     = NULL;
+STATIC VOID                       *mMmVariableRegistration = NULL;
+
 /**
-  GetConfigKnobFromVariable returns the configuration knob from variable storage if it exists. This function is
-  abstracted to work with PEI, DXE, and Standalone MM.
+  Drop the cached variable protocol when it is reinstalled, so the next lookup finds the current instance.
+
+  @param[in] Protocol   Points to the protocol's unique identifier.
+  @param[in] Interface  Points to the interface instance.
+  @param[in] Handle     The handle on which the interface was installed.
+
+  @retval EFI_SUCCESS   The cache was dropped.
+
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+ConfigKnobShimMmVariableNotify (
+  IN CONST EFI_GUID  *Protocol,
+  IN VOID            *Interface,
+  IN EFI_HANDLE      Handle
+  )
+{
+  mMmVariableServices = NULL;
+  return EFI_SUCCESS;
+}
+
+/**
+  LocateConfigKnobVariableServices finds the variable services of the current phase, so that several config knobs can
+  be read with a single lookup.
+
+  The variable protocol is cached once located, so later calls skip the protocol database walk.
+
+  @param[out] VariableServices    Phase specific variable services, only to be passed to
+                                  GetConfigKnobFromVariableServices.
+
+  @retval EFI_NOT_READY           Variable Services not available.
+  @retval !EFI_SUCCESS            Failed to locate variable services.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+LocateConfigKnobVariableServices (
+  OUT VOID  **VariableServices
+  )
+{
+  EFI_STATUS  Status;
 
-  This function is only expected to be called by GetConfigKnobOverride.
+  if (mMmVariableServices != NULL) {
+    *VariableServices = mMmVariableServices;
+    return EFI_SUCCESS;
+  }
+
+  if (mMmVariableRegistration == NULL) {
+    Status = gMmst->MmRegisterProtocolNotify (
+                      &gEfiSmmVariableProtocolGuid,
+                      ConfigKnobShimMmVariableNotify,
+                      &mMmVariableRegistration
+                      );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "%a: Failed to register for variable protocol notifications (%r), not caching it\n", __FUNCTION__, Status));
+      mMmVariableRegistration = NULL;
+    }
+  }
+
+  Status = gMmst->MmLocateProtocol (
+                    &gEfiSmmVariableProtocolGuid,
+                    NULL,
+                    VariableServices
+                    );
+  if (!EFI_ERROR (Status) && (mMmVariableRegistration != NULL)) {
+    mMmVariableServices = (EFI_SMM_VARIABLE_PROTOCOL *)*VariableServices;
+  }
+
+  return Status;
+}
+
+/**
+  GetConfigKnobFromVariableServices returns the configuration knob from variable storage if it exists, using variable
+  services returned by LocateConfigKnobVariableServices.
 
+  @param[in]  VariableServices      Variable services returned by LocateConfigKnobVariableServices.
   @param[in]  ConfigKnobGuid        The GUID of the requested config knob.
   @param[in]  ConfigKnobName        The name of the requested config knob.
-  @param[out] ConfigKnobData        The retrieved data of the requested config knob. The caller will allocate memory for
-                                    this buffer and is responsible for freeing it. This parameter is acceptable to be
+  @param[out] ConfigKnobData        The retrieved data of the requested config knob. This parameter is acceptable to be
                                     NULL if the data size is all that is requested.
-  @param[in out] ConfigKnobDataSize The allocated size of ConfigKnobData. This is expected to be set to the correct
-                                    value for the size of ConfigKnobData. If this size is too small for the config knob,
-                                    EFI_BUFFER_TOO_SMALL will be returned. This represents a mismatch in the profile
-                                    expected size and what is stored in variable storage, so the profile value will
-                                    take precedence.
-
-  @retval EFI_NOT_FOUND           The requested config knob was not found in the policy cache or variable storage. This
-                                  is expected when the config knob has not been updated from the profile default.
-  @retval EFI_BUFFER_TOO_SMALL    ConfigKnobDataSize as passed in was too small for this config knob. This is expected
-                                  if stale variables exist in flash.
-  @retval EFI_NOT_READY           Variable Services not available.
+  @param[in out] ConfigKnobDataSize The allocated size of ConfigKnobData. On return, the size of the config knob in
+                                    variable storage.
+
+  @retval EFI_NOT_FOUND           The requested config knob was not found in variable storage.
+  @retval EFI_BUFFER_TOO_SMALL    ConfigKnobDataSize as passed in was too small for this config knob.
   @retval !EFI_SUCCESS            Failed to read variable from variable storage.
   @retval EFI_SUCCESS             The operation succeeds.
 
 **/
 EFI_STATUS
-GetConfigKnobFromVariable (
+GetConfigKnobFromVariableServices (
+  IN VOID       *VariableServices,
   IN EFI_GUID   *ConfigKnobGuid,
   IN CHAR16     *ConfigKnobName,
   OUT VOID      *ConfigKnobData,
   IN OUT UINTN  *ConfigKnobDataSize
   )
 {
-  EFI_STATUS                 Status;
   EFI_SMM_VARIABLE_PROTOCOL  *MmVariableServices;
 
-  Status = gMmst->MmLocateProtocol (
-                    &gEfiSmmVariableProtocolGuid,
-                    NULL,
-                    (VOID **)&MmVariableServices
-                    );
-
-  if (EFI_ERROR (Status)) {
-    DEBUG ((
-      DEBUG_ERROR,
-      "%a: Failed to locate variable services with status %r, falling back to profile value for config knob %a\n",
-      __FUNCTION__,
-      Status,
-      ConfigKnobName
-      ));
+  MmVariableServices = (EFI_SMM_VARIABLE_PROTOCOL *)VariableServices;
 
-    return Status;
-  }
+  ConfigPerfCounterAdd (ConfigPerfCounterGetVariableCalls, 1);
 
   return MmVariableServices->SmmGetVariable (
                                ConfigKnobName,
@@ -78,3 +133,60 @@ GetConfigKnobFromVariable (
                                ConfigKnobData
                                );
 }
+
+/**
+  SetConfigKnobToVariableServices writes a variable using variable services returned by
+  LocateConfigKnobVariableServices.
+
+  @param[in]  VariableServices      Variable services returned by LocateConfigKnobVariableServices.
+  @param[in]  VariableGuid          The GUID of the variable.
+  @param[in]  VariableName          The name of the variable.
+  @param[in]  Attributes            The attributes of the variable.
+  @param[in]  DataSize              The size of Data, 0 to delete the variable.
+  @param[in]  Data                  The contents of the variable.
+
+  @retval !EFI_SUCCESS            Failed to write the variable to variable storage.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+SetConfigKnobToVariableServices (
+  IN VOID      *VariableServices,
+  IN EFI_GUID  *VariableGuid,
+  IN CHAR16    *VariableName,
+  IN UINT32    Attributes,
+  IN UINTN     DataSize,
+  IN VOID      *Data
+  )
+{
+  EFI_SMM_VARIABLE_PROTOCOL  *MmVariableServices;
+
+  MmVariableServices = (EFI_SMM_VARIABLE_PROTOCOL *)VariableServices;
+
+  ConfigPerfCounterAdd (ConfigPerfCounterSetVariableCalls, 1);
+
+  return MmVariableServices->SmmSetVariable (
+                               VariableName,
+                               VariableGuid,
+                               Attributes,
+                               DataSize,
+                               Data
+                               );
+}
+
+/**
+  BuildConfigKnobSnapshot allocates the snapshot of the overrides found by GetConfigKnobOverrides. Only PEI publishes
+  a snapshot, as the HOB list can no longer be extended by Standalone MM drivers.
+
+  @param[in]  SnapshotSize        Size in bytes of the snapshot, including its CONFIG_KNOB_SNAPSHOT header.
+
+  @return NULL, this phase does not publish a snapshot.
+
+**/
+VOID *
+BuildConfigKnobSnapshot (
+  IN UINTN  SnapshotSize
+  )
+{
+  return NULL;
+}
@@ -18,6 +18,7 @@
 #include <Library/DebugLib.h>
 #include <Library/BaseMemoryLib.h>
 #include <Library/UnitTestLib.h>
+#include <Library/HobLib.h>
 #include <Ppi/ReadOnlyVariable2.h>
 #include <Library/MmServicesTableLib.h>
 #include <Protocol/SmmVariable.h>
@@ -32,6 +33,16 @@
 
 #define CONFIG_KNOB_GUID  {0x52d39693, 0x4f64, 0x4ee6, {0x81, 0xde, 0x45, 0x89, 0x37, 0x72, 0x78, 0x55}}
 
+///
+/// Backing store of the HOB used by the PEI shim to cache the variable PPI.
+///
+MOCK_GUID_HOB  mVariableCacheHob;
+
+///
+/// Notification registered by the Standalone MM shim to drop its cached variable protocol.
+///
+EFI_MM_NOTIFY_FN  mMmVariableNotify = NULL;
+
 /**
   Mocked version of GetVariable.
 
@@ -148,12 +159,40 @@ MockMmLocateProtocol (
 {
   MM_PROTOCOL_STATUS  *ProtocolStatus = (MM_PROTOCOL_STATUS *)mock ();
 
+  ProtocolStatus->LocateCount++;
+
   // Set the protocol to one of our mock protocols
   *Interface = ProtocolStatus->Protocol;
 
   return ProtocolStatus->Status;
 }
 
+/**
+  Mocked version of MmRegisterProtocolNotify, which records the notification function so that tests can
+  invalidate cached protocols.
+
+  @param[in]  Protocol     The unique ID of the protocol for which the event is to be registered.
+  @param[in]  Function     Points to the notification function.
+  @param[out] Registration A pointer to a memory location to receive the registration value.
+
+  @retval EFI_SUCCESS           Successfully returned the registration record
+                                that has been added or unhooked.
+
+**/
+EFI_STATUS
+EFIAPI
+MockMmRegisterProtocolNotify (
+  IN  CONST EFI_GUID     *Protocol,
+  IN  EFI_MM_NOTIFY_FN   Function,
+  OUT VOID               **Registration
+  )
+{
+  mMmVariableNotify = Function;
+  *Registration     = (VOID *)&mMmVariableNotify;
+
+  return EFI_SUCCESS;
+}
+
 ///
 /// Mock version of the UEFI Runtime Services Table
 ///
@@ -176,9 +215,41 @@ EFI_SMM_VARIABLE_PROTOCOL  MockVariableSmm = {
 };
 
 EFI_MM_SYSTEM_TABLE  MockMmServices = {
-  .MmLocateProtocol = MockMmLocateProtocol
+  .MmLocateProtocol         = MockMmLocateProtocol,
+  .MmRegisterProtocolNotify = MockMmRegisterProtocolNotify
 };
 
+/**
+  Drop any variable services cached by the shim library under test, so that each test
+  starts by locating them.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The cache was dropped.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ResetVariableServicesCache (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  // PEI caches variable services in a HOB
+  ZeroMem (&mVariableCacheHob, sizeof (mVariableCacheHob));
+
+  // Standalone MM caches variable services until the protocol is reinstalled
+  if (mMmVariableNotify != NULL) {
+    mMmVariableNotify (NULL, NULL, NULL);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
 /**
   Unit test for GetConfigKnobOverrideInvalidParamTest.
 
@@ -260,6 +331,8 @@ GetConfigKnobOverrideFromVariableStorageSucceedTest (
   // PEI and Standalone MM, don't fail for other phases so that we can keep the unit test common
   will_return_maybe (PeiServicesLocatePpi, &PpiStatus);
   will_return_maybe (MockMmLocateProtocol, &MmProtocolStatus);
+  will_return_maybe (GetFirstGuidHob, &mVariableCacheHob);
+  will_return_maybe (BuildGuidHob, &mVariableCacheHob);
 
   // first GetVariable call to get size
   will_return (MockGetVariable, EFI_BUFFER_TOO_SMALL);
@@ -313,6 +386,8 @@ GetConfigKnobOverrideFromVariableStorageFailTest (
   // PEI and Standalone MM, don't fail for other phases so that we can keep the unit test common
   will_return_maybe (PeiServicesLocatePpi, &PpiStatus);
   will_return_maybe (MockMmLocateProtocol, &MmProtocolStatus);
+  will_return_maybe (GetFirstGuidHob, &mVariableCacheHob);
+  will_return_maybe (BuildGuidHob, &mVariableCacheHob);
 
   // first GetVariable call to get size
   will_return (MockGetVariable, EFI_NOT_FOUND);
@@ -361,6 +436,8 @@ GetConfigKnobOverrideFromVariableStorageFailSizeTest (
   // PEI and Standalone MM, don't fail for other phases so that we can keep the unit test common
   will_return_maybe (PeiServicesLocatePpi, &PpiStatus);
   will_return_maybe (MockMmLocateProtocol, &MmProtocolStatus);
+  will_return_maybe (GetFirstGuidHob, &mVariableCacheHob);
+  will_return_maybe (BuildGuidHob, &mVariableCacheHob);
 
   will_return (MockGetVariable, EFI_BUFFER_TOO_SMALL);
   will_return (MockGetVariable, sizeof (UINT32));
@@ -409,6 +486,8 @@ GetConfigKnobOverrideFromVariableStorageFailPpiTest (
   // PEI and Standalone MM, don't fail for other phases so that we can keep the unit test common
   will_return_maybe (PeiServicesLocatePpi, &PpiStatus);
   will_return_maybe (MockMmLocateProtocol, &MmProtocolStatus);
+  will_return_maybe (GetFirstGuidHob, &mVariableCacheHob);
+  will_return_maybe (BuildGuidHob, &mVariableCacheHob);
 
   // in this case, DXE only, as PEI and Standalone MM failed to find variable service
   will_return_maybe (MockGetVariable, EFI_NOT_FOUND);
@@ -421,6 +500,525 @@ GetConfigKnobOverrideFromVariableStorageFailPpiTest (
   return UNIT_TEST_PASSED;
 }
 
+/**
+  Unit test for GetConfigKnobOverridesInvalidParamTest.
+
+  Null or empty params should fail the whole batch.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+GetConfigKnobOverridesInvalidParamTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      CacheValue = 0;
+  EFI_STATUS  KnobStatus[1];
+  KNOB_DATA   Knobs[1] = {
+    { .Knob = 0, .CacheValueAddress = &CacheValue, .ValueSize = sizeof (CacheValue), .Name = "MyKnob", .VendorNamespace = CONFIG_KNOB_GUID }
+  };
+
+  Status = GetConfigKnobOverrides (NULL, ARRAY_SIZE (Knobs), KnobStatus);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = GetConfigKnobOverrides (Knobs, 0, KnobStatus);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = GetConfigKnobOverrides (Knobs, ARRAY_SIZE (Knobs), NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for GetConfigKnobOverridesSucceedTest.
+
+  Fetch a list of config knobs from variable storage in one batch. Only the knobs with a
+  correctly sized override should be updated, the rest should keep their profile values.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+GetConfigKnobOverridesSucceedTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS          Status;
+  UINT64              KnobA            = 0xDEADBEEFDEADBEEF;
+  UINT32              KnobB            = 0xDEADBEEF;
+  UINT32              KnobC            = 0xDEADBEEF;
+  UINT32              KnobD            = 0xDEADBEEF;
+  UINT8               KnobE[CONFIG_KNOB_READ_BUFFER_SIZE * 2];
+  UINT8               VariableE[sizeof (KnobE)];
+  UINT64              VariableA        = 0xBEEF7777BEEF7777;
+  UINT16              VariableC        = 0x7777;
+  PPI_STATUS          PpiStatus        = { .Ppi = &MockVariablePpi, .Status = EFI_SUCCESS };
+  MM_PROTOCOL_STATUS  MmProtocolStatus = { .Protocol = &MockVariableSmm, .Status = EFI_SUCCESS };
+  EFI_STATUS          KnobStatus[6];
+  KNOB_DATA           Knobs[6] = {
+    { .Knob = 0, .CacheValueAddress = &KnobA, .ValueSize = sizeof (KnobA), .Name = "KnobA", .VendorNamespace = CONFIG_KNOB_GUID },
+    { .Knob = 1, .CacheValueAddress = &KnobB, .ValueSize = sizeof (KnobB), .Name = "KnobB", .VendorNamespace = CONFIG_KNOB_GUID },
+    { .Knob = 2, .CacheValueAddress = &KnobC, .ValueSize = sizeof (KnobC), .Name = "KnobC", .VendorNamespace = CONFIG_KNOB_GUID },
+    { .Knob = 3, .CacheValueAddress = &KnobD, .ValueSize = sizeof (KnobD), .Name = "KnobD", .VendorNamespace = CONFIG_KNOB_GUID },
+    { .Knob = 4, .CacheValueAddress = KnobE,  .ValueSize = sizeof (KnobE), .Name = "KnobE", .VendorNamespace = CONFIG_KNOB_GUID },
+    { .Knob = 5, .CacheValueAddress = NULL,   .ValueSize = 0,              .Name = NULL }
+  };
+
+  SetMem (KnobE, sizeof (KnobE), 0xAA);
+  SetMem (VariableE, sizeof (VariableE), 0x55);
+
+  // PEI and Standalone MM, don't fail for other phases so that we can keep the unit test common
+  will_return_maybe (PeiServicesLocatePpi, &PpiStatus);
+  will_return_maybe (MockMmLocateProtocol, &MmProtocolStatus);
+  will_return_maybe (GetFirstGuidHob, &mVariableCacheHob);
+  will_return_maybe (BuildGuidHob, &mVariableCacheHob);
+
+  // KnobA has a correctly sized override, fetched in a single call
+  will_return (MockGetVariable, EFI_SUCCESS);
+  will_return (MockGetVariable, sizeof (VariableA));
+  will_return (MockGetVariable, &VariableA);
+
+  // KnobB has no override
+  will_return (MockGetVariable, EFI_NOT_FOUND);
+
+  // KnobC has an override that is too small, this must not be written to the knob
+  will_return (MockGetVariable, EFI_SUCCESS);
+  will_return (MockGetVariable, sizeof (VariableC));
+  will_return (MockGetVariable, &VariableC);
+
+  // KnobD has an override that is too large
+  will_return (MockGetVariable, EFI_BUFFER_TOO_SMALL);
+  will_return (MockGetVariable, sizeof (UINT64));
+
+  // KnobE is too large to read aside, so the size is checked first
+  will_return (MockGetVariable, EFI_BUFFER_TOO_SMALL);
+  will_return (MockGetVariable, sizeof (VariableE));
+
+  will_return (MockGetVariable, EFI_SUCCESS);
+  will_return (MockGetVariable, sizeof (VariableE));
+  will_return (MockGetVariable, VariableE);
+
+  Status = GetConfigKnobOverrides (Knobs, ARRAY_SIZE (Knobs), KnobStatus);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
+
+  UT_ASSERT_STATUS_EQUAL (KnobStatus[0], EFI_SUCCESS);
+  UT_ASSERT_EQUAL (KnobA, VariableA);
+
+  UT_ASSERT_STATUS_EQUAL (KnobStatus[1], EFI_NOT_FOUND);
+  UT_ASSERT_EQUAL (KnobB, 0xDEADBEEF);
+
+  UT_ASSERT_STATUS_EQUAL (KnobStatus[2], EFI_BAD_BUFFER_SIZE);
+  UT_ASSERT_EQUAL (KnobC, 0xDEADBEEF);
+
+  UT_ASSERT_STATUS_EQUAL (KnobStatus[3], EFI_BAD_BUFFER_SIZE);
+  UT_ASSERT_EQUAL (KnobD, 0xDEADBEEF);
+
+  UT_ASSERT_STATUS_EQUAL (KnobStatus[4], EFI_SUCCESS);
+  UT_ASSERT_MEM_EQUAL (KnobE, VariableE, sizeof (KnobE));
+
+  UT_ASSERT_STATUS_EQUAL (KnobStatus[5], EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for GetConfigKnobOverridesFailPpiTest.
+
+  Fail to locate variable services, every knob should keep its profile value.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+GetConfigKnobOverridesFailPpiTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS          Status;
+  UINT64              KnobA            = 0xDEADBEEFDEADBEEF;
+  UINT32              KnobB            = 0xDEADBEEF;
+  PPI_STATUS          PpiStatus        = { .Ppi = NULL, .Status = EFI_NOT_FOUND };
+  MM_PROTOCOL_STATUS  MmProtocolStatus = { .Protocol = NULL, .Status = EFI_NOT_FOUND };
+  EFI_STATUS          KnobStatus[2];
+  KNOB_DATA           Knobs[2] = {
+    { .Knob = 0, .CacheValueAddress = &KnobA, .ValueSize = sizeof (KnobA), .Name = "KnobA", .VendorNamespace = CONFIG_KNOB_GUID },
+    { .Knob = 1, .CacheValueAddress = &KnobB, .ValueSize = sizeof (KnobB), .Name = "KnobB", .VendorNamespace = CONFIG_KNOB_GUID }
+  };
+
+  // PEI and Standalone MM, don't fail for other phases so that we can keep the unit test common
+  will_return_maybe (PeiServicesLocatePpi, &PpiStatus);
+  will_return_maybe (MockMmLocateProtocol, &MmProtocolStatus);
+  will_return_maybe (GetFirstGuidHob, &mVariableCacheHob);
+  will_return_maybe (BuildGuidHob, &mVariableCacheHob);
+
+  // in this case, DXE only, as PEI and Standalone MM failed to find variable service
+  will_return_maybe (MockGetVariable, EFI_NOT_FOUND);
+
+  Status = GetConfigKnobOverrides (Knobs, ARRAY_SIZE (Knobs), KnobStatus);
+
+  // PEI and Standalone MM fail the whole batch, DXE fails each knob
+  UT_ASSERT_TRUE ((Status == EFI_NOT_FOUND) || (Status == EFI_SUCCESS));
+  UT_ASSERT_STATUS_EQUAL (KnobStatus[0], EFI_NOT_FOUND);
+  UT_ASSERT_STATUS_EQUAL (KnobStatus[1], EFI_NOT_FOUND);
+
+  UT_ASSERT_EQUAL (KnobA, 0xDEADBEEFDEADBEEF);
+  UT_ASSERT_EQUAL (KnobB, 0xDEADBEEF);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for GetConfigKnobOverrideCachedVariableServicesTest.
+
+  Fetch config knobs several times, one by one and in a batch. Variable services should
+  only be located for the first lookup, until the cache is dropped.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+GetConfigKnobOverrideCachedVariableServicesTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS          Status;
+  EFI_GUID            ConfigKnobGuid   = CONFIG_KNOB_GUID;
+  UINT64              ConfigKnobData;
+  UINT64              VariableData     = 0xBEEF7777BEEF7777;
+  UINT64              KnobA            = 0xDEADBEEFDEADBEEF;
+  UINT64              KnobB            = 0xDEADBEEFDEADBEEF;
+  UINTN               Index;
+  UINTN               LocateCount;
+  PPI_STATUS          PpiStatus        = { .Ppi = &MockVariablePpi, .Status = EFI_SUCCESS };
+  MM_PROTOCOL_STATUS  MmProtocolStatus = { .Protocol = &MockVariableSmm, .Status = EFI_SUCCESS };
+  EFI_STATUS          KnobStatus[2];
+  KNOB_DATA           Knobs[2] = {
+    { .Knob = 0, .CacheValueAddress = &KnobA, .ValueSize = sizeof (KnobA), .Name = "KnobA", .VendorNamespace = CONFIG_KNOB_GUID },
+    { .Knob = 1, .CacheValueAddress = &KnobB, .ValueSize = sizeof (KnobB), .Name = "KnobB", .VendorNamespace = CONFIG_KNOB_GUID }
+  };
+
+  // PEI and Standalone MM, don't fail for other phases so that we can keep the unit test common
+  will_return_maybe (PeiServicesLocatePpi, &PpiStatus);
+  will_return_maybe (MockMmLocateProtocol, &MmProtocolStatus);
+  will_return_maybe (GetFirstGuidHob, &mVariableCacheHob);
+  will_return_maybe (BuildGuidHob, &mVariableCacheHob);
+
+  for (Index = 0; Index < 3; Index++) {
+    will_return (MockGetVariable, EFI_BUFFER_TOO_SMALL);
+    will_return (MockGetVariable, sizeof (VariableData));
+
+    will_return (MockGetVariable, EFI_SUCCESS);
+    will_return (MockGetVariable, sizeof (VariableData));
+    will_return (MockGetVariable, &VariableData);
+
+    ConfigKnobData = 0xDEADBEEFDEADBEEF;
+    Status         = GetConfigKnobOverride (&ConfigKnobGuid, L"MyDeadBeefDelivery", &ConfigKnobData, sizeof (ConfigKnobData));
+    UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
+    UT_ASSERT_EQUAL (ConfigKnobData, VariableData);
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (Knobs); Index++) {
+    will_return (MockGetVariable, EFI_SUCCESS);
+    will_return (MockGetVariable, sizeof (VariableData));
+    will_return (MockGetVariable, &VariableData);
+  }
+
+  Status = GetConfigKnobOverrides (Knobs, ARRAY_SIZE (Knobs), KnobStatus);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
+  UT_ASSERT_STATUS_EQUAL (KnobStatus[0], EFI_SUCCESS);
+  UT_ASSERT_STATUS_EQUAL (KnobStatus[1], EFI_SUCCESS);
+  UT_ASSERT_EQUAL (KnobA, VariableData);
+  UT_ASSERT_EQUAL (KnobB, VariableData);
+
+  // PEI and Standalone MM locate variable services once, DXE uses gRT and never locates them
+  LocateCount = PpiStatus.LocateCount + MmProtocolStatus.LocateCount;
+  UT_ASSERT_TRUE (LocateCount <= 1);
+
+  // Once the cache is dropped, the next lookup has to locate variable services again
+  ResetVariableServicesCache (Context);
+
+  will_return (MockGetVariable, EFI_BUFFER_TOO_SMALL);
+  will_return (MockGetVariable, sizeof (VariableData));
+
+  will_return (MockGetVariable, EFI_SUCCESS);
+  will_return (MockGetVariable, sizeof (VariableData));
+  will_return (MockGetVariable, &VariableData);
+
+  Status = GetConfigKnobOverride (&ConfigKnobGuid, L"MyDeadBeefDelivery", &ConfigKnobData, sizeof (ConfigKnobData));
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
+
+  UT_ASSERT_EQUAL (PpiStatus.LocateCount + MmProtocolStatus.LocateCount, 2 * LocateCount);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for GetConfigKnobOverridesSnapshotTest.
+
+  Fetch a list of config knobs from a snapshot HOB published by PEI, without reading variable
+  storage. Once the snapshot is corrupted, the knobs should be read from variable storage again.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+GetConfigKnobOverridesSnapshotTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS            Status;
+  UINT64                KnobA            = 0xDEADBEEFDEADBEEF;
+  UINT32                KnobB            = 0xDEADBEEF;
+  UINT64                SnapshotA        = 0xBEEF7777BEEF7777;
+  UINT64                VariableA        = 0x7777BEEF7777BEEF;
+  CONFIG_KNOB_SNAPSHOT  *Snapshot;
+  UINT8                 *Bitmap;
+  PPI_STATUS            PpiStatus        = { .Ppi = &MockVariablePpi, .Status = EFI_SUCCESS };
+  MM_PROTOCOL_STATUS    MmProtocolStatus = { .Protocol = &MockVariableSmm, .Status = EFI_SUCCESS };
+  EFI_STATUS            KnobStatus[3];
+  KNOB_DATA             Knobs[3] = {
+    { .Knob = 0, .CacheValueAddress = &KnobA, .ValueSize = sizeof (KnobA), .Name = "KnobA", .VendorNamespace = CONFIG_KNOB_GUID },
+    { .Knob = 1, .CacheValueAddress = &KnobB, .ValueSize = sizeof (KnobB), .Name = "KnobB", .VendorNamespace = CONFIG_KNOB_GUID },
+    { .Knob = 2, .CacheValueAddress = NULL,   .ValueSize = 0,              .Name = NULL }
+  };
+  struct {
+    EFI_HOB_GUID_TYPE    Header;
+    UINT8                Data[sizeof (CONFIG_KNOB_SNAPSHOT) + 1 + sizeof (SnapshotA)];
+  } SnapshotHob;
+
+  // Only KnobA has an override in the snapshot
+  ZeroMem (&SnapshotHob, sizeof (SnapshotHob));
+  SnapshotHob.Header.Header.HobType   = EFI_HOB_TYPE_GUID_EXTENSION;
+  SnapshotHob.Header.Header.HobLength = (UINT16)sizeof (SnapshotHob);
+  CopyGuid (&SnapshotHob.Header.Name, &gConfigKnobShimSnapshotHobGuid);
+
+  Snapshot  = (CONFIG_KNOB_SNAPSHOT *)SnapshotHob.Data;
+  Bitmap    = (UINT8 *)(Snapshot + 1);
+  Bitmap[0] = 0x01;
+  CopyMem (Bitmap + 1, &SnapshotA, sizeof (SnapshotA));
+
+  Snapshot->Signature   = CONFIG_KNOB_SNAPSHOT_SIGNATURE;
+  Snapshot->Version     = CONFIG_KNOB_SNAPSHOT_VERSION;
+  Snapshot->KnobCount   = ARRAY_SIZE (Knobs);
+  Snapshot->ValuesSize  = sizeof (SnapshotA);
+  Snapshot->LayoutCrc32 = GetConfigKnobLayoutCrc (Knobs, ARRAY_SIZE (Knobs));
+  Snapshot->Crc32       = ConfigCalculateCrc32 (Bitmap, 1 + sizeof (SnapshotA));
+
+  // Every phase looks for the snapshot first, once for each batch
+  will_return (GetFirstGuidHob, &SnapshotHob);
+  will_return (GetFirstGuidHob, &SnapshotHob);
+
+  // PEI and Standalone MM, don't fail for other phases so that we can keep the unit test common
+  will_return_maybe (PeiServicesLocatePpi, &PpiStatus);
+  will_return_maybe (MockMmLocateProtocol, &MmProtocolStatus);
+  will_return_maybe (GetFirstGuidHob, &mVariableCacheHob);
+  will_return_maybe (BuildGuidHob, &mVariableCacheHob);
+
+  Status = GetConfigKnobOverrides (Knobs, ARRAY_SIZE (Knobs), KnobStatus);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
+
+  UT_ASSERT_STATUS_EQUAL (KnobStatus[0], EFI_SUCCESS);
+  UT_ASSERT_EQUAL (KnobA, SnapshotA);
+
+  UT_ASSERT_STATUS_EQUAL (KnobStatus[1], EFI_NOT_FOUND);
+  UT_ASSERT_EQUAL (KnobB, 0xDEADBEEF);
+
+  UT_ASSERT_STATUS_EQUAL (KnobStatus[2], EFI_INVALID_PARAMETER);
+
+  // Nothing should have been read from variable storage
+  UT_ASSERT_EQUAL (PpiStatus.LocateCount + MmProtocolStatus.LocateCount, 0);
+
+  // A corrupted snapshot is ignored
+  Bitmap[1] ^= 0xFF;
+
+  will_return (MockGetVariable, EFI_SUCCESS);
+  will_return (MockGetVariable, sizeof (VariableA));
+  will_return (MockGetVariable, &VariableA);
+
+  will_return (MockGetVariable, EFI_NOT_FOUND);
+
+  Status = GetConfigKnobOverrides (Knobs, ARRAY_SIZE (Knobs), KnobStatus);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
+
+  UT_ASSERT_STATUS_EQUAL (KnobStatus[0], EFI_SUCCESS);
+  UT_ASSERT_EQUAL (KnobA, VariableA);
+
+  UT_ASSERT_STATUS_EQUAL (KnobStatus[1], EFI_NOT_FOUND);
+  UT_ASSERT_EQUAL (KnobB, 0xDEADBEEF);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for GetConfigKnobCachedPolicyTest.
+
+  The fingerprint of a list of config knobs should follow their values and the active profile,
+  and a cached policy should only be returned for the fingerprint it was cached with.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+GetConfigKnobCachedPolicyTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS                     Status;
+  UINT64                         KnobA            = 0xDEADBEEFDEADBEEF;
+  UINT32                         KnobB            = 0xDEADBEEF;
+  CONFIG_KNOB_FINGERPRINT        Fingerprint;
+  CONFIG_KNOB_FINGERPRINT        OtherFingerprint;
+  UINT8                          CachedPolicy[0x20];
+  UINT8                          CorruptedPolicy[sizeof (CachedPolicy)];
+  UINT8                          Policy[sizeof (CachedPolicy)];
+  UINTN                          PolicySize;
+  CONFIG_KNOB_POLICY_CACHE_INFO  Info;
+  PPI_STATUS                     PpiStatus        = { .Ppi = &MockVariablePpi, .Status = EFI_SUCCESS };
+  MM_PROTOCOL_STATUS             MmProtocolStatus = { .Protocol = &MockVariableSmm, .Status = EFI_SUCCESS };
+  KNOB_DATA                      Knobs[3] = {
+    { .Knob = 0, .CacheValueAddress = &KnobA, .ValueSize = sizeof (KnobA), .Name = "KnobA", .VendorNamespace = CONFIG_KNOB_GUID },
+    { .Knob = 1, .CacheValueAddress = &KnobB, .ValueSize = sizeof (KnobB), .Name = "KnobB", .VendorNamespace = CONFIG_KNOB_GUID },
+    { .Knob = 2, .CacheValueAddress = NULL,   .ValueSize = 0,              .Name = NULL }
+  };
+
+  Status = GetConfigKnobFingerprint (Knobs, ARRAY_SIZE (Knobs), 0, &Fingerprint);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
+
+  // Another active profile or knob value changes the fingerprint
+  Status = GetConfigKnobFingerprint (Knobs, ARRAY_SIZE (Knobs), 1, &OtherFingerprint);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
+  UT_ASSERT_NOT_EQUAL (CompareMem (&Fingerprint, &OtherFingerprint, sizeof (Fingerprint)), 0);
+
+  KnobB  = 0x7777;
+  Status = GetConfigKnobFingerprint (Knobs, ARRAY_SIZE (Knobs), 0, &OtherFingerprint);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
+  UT_ASSERT_NOT_EQUAL (CompareMem (&Fingerprint, &OtherFingerprint, sizeof (Fingerprint)), 0);
+
+  SetMem (CachedPolicy, sizeof (CachedPolicy), 0x55);
+  CopyMem (CorruptedPolicy, CachedPolicy, sizeof (CachedPolicy));
+  CorruptedPolicy[0] ^= 0xFF;
+
+  Info.Signature  = CONFIG_KNOB_POLICY_CACHE_SIGNATURE;
+  Info.PolicySize = sizeof (CachedPolicy);
+  CopyMem (&Info.Fingerprint, &Fingerprint, sizeof (Info.Fingerprint));
+  UT_ASSERT_TRUE (Sha256HashAll (CachedPolicy, sizeof (CachedPolicy), Info.PolicyDigest));
+
+  // PEI and Standalone MM, don't fail for other phases so that we can keep the unit test common
+  will_return_maybe (PeiServicesLocatePpi, &PpiStatus);
+  will_return_maybe (MockMmLocateProtocol, &MmProtocolStatus);
+  will_return_maybe (GetFirstGuidHob, &mVariableCacheHob);
+  will_return_maybe (BuildGuidHob, &mVariableCacheHob);
+
+  // The policy was cached for other knob values
+  will_return (MockGetVariable, EFI_SUCCESS);
+  will_return (MockGetVariable, sizeof (Info));
+  will_return (MockGetVariable, &Info);
+
+  PolicySize = sizeof (Policy);
+  Status     = GetConfigKnobCachedPolicy (&OtherFingerprint, Policy, &PolicySize);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  // The size of the cached policy is returned first
+  will_return (MockGetVariable, EFI_SUCCESS);
+  will_return (MockGetVariable, sizeof (Info));
+  will_return (MockGetVariable, &Info);
+
+  PolicySize = 0;
+  Status     = GetConfigKnobCachedPolicy (&Fingerprint, NULL, &PolicySize);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (PolicySize, sizeof (CachedPolicy));
+
+  will_return (MockGetVariable, EFI_SUCCESS);
+  will_return (MockGetVariable, sizeof (Info));
+  will_return (MockGetVariable, &Info);
+
+  will_return (MockGetVariable, EFI_SUCCESS);
+  will_return (MockGetVariable, sizeof (CachedPolicy));
+  will_return (MockGetVariable, CachedPolicy);
+
+  Status = GetConfigKnobCachedPolicy (&Fingerprint, Policy, &PolicySize);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_SUCCESS);
+  UT_ASSERT_EQUAL (PolicySize, sizeof (CachedPolicy));
+  UT_ASSERT_MEM_EQUAL (Policy, CachedPolicy, sizeof (CachedPolicy));
+
+  // A policy not matching its info is not returned
+  will_return (MockGetVariable, EFI_SUCCESS);
+  will_return (MockGetVariable, sizeof (Info));
+  will_return (MockGetVariable, &Info);
+
+  will_return (MockGetVariable, EFI_SUCCESS);
+  will_return (MockGetVariable, sizeof (CorruptedPolicy));
+  will_return (MockGetVariable, CorruptedPolicy);
+
+  Status = GetConfigKnobCachedPolicy (&Fingerprint, Policy, &PolicySize);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+
+  return UNIT_TEST_PASSED;
+}
+
 /**
   Initialize the unit test framework, suite, and unit tests for the
   ConfigKnobShimLibCommon and run the ConfigKnobShimLibCommon unit test.
@@ -472,14 +1070,20 @@ UnitTestingEntry (
   // Failure Tests
   //
   AddTestCase (ConfigKnobShimLibCommon, "Null params should return null", "GetConfigKnobOverrideInvalidParamTest", GetConfigKnobOverrideInvalidParamTest, NULL, NULL, NULL);
+  AddTestCase (ConfigKnobShimLibCommon, "Null batch params should return invalid param", "GetConfigKnobOverridesInvalidParamTest", GetConfigKnobOverridesInvalidParamTest, NULL, NULL, NULL);
 
   //
   // Success Tests
   //
-  AddTestCase (ConfigKnobShimLibCommon, "Retrieving config from variable should succeed", "GetConfigKnobOverrideFromVariableStorageSucceedTest", GetConfigKnobOverrideFromVariableStorageSucceedTest, NULL, NULL, NULL);
-  AddTestCase (ConfigKnobShimLibCommon, "Retrieving default profile value should succeed", "GetConfigKnobOverrideFromVariableStorageFailTest", GetConfigKnobOverrideFromVariableStorageFailTest, NULL, NULL, NULL);
-  AddTestCase (ConfigKnobShimLibCommon, "Retrieving default profile value should succeed", "GetConfigKnobOverrideFromVariableStorageFailSizeTest", GetConfigKnobOverrideFromVariableStorageFailSizeTest, NULL, NULL, NULL);
-  AddTestCase (ConfigKnobShimLibCommon, "Retrieving default profile value should succeed", "GetConfigKnobOverrideFromVariableStorageFailPpiTest", GetConfigKnobOverrideFromVariableStorageFailPpiTest, NULL, NULL, NULL);
+  AddTestCase (ConfigKnobShimLibCommon, "Retrieving config from variable should succeed", "GetConfigKnobOverrideFromVariableStorageSucceedTest", GetConfigKnobOverrideFromVariableStorageSucceedTest, ResetVariableServicesCache, NULL, NULL);
+  AddTestCase (ConfigKnobShimLibCommon, "Retrieving default profile value should succeed", "GetConfigKnobOverrideFromVariableStorageFailTest", GetConfigKnobOverrideFromVariableStorageFailTest, ResetVariableServicesCache, NULL, NULL);
+  AddTestCase (ConfigKnobShimLibCommon, "Retrieving default profile value should succeed", "GetConfigKnobOverrideFromVariableStorageFailSizeTest", GetConfigKnobOverrideFromVariableStorageFailSizeTest, ResetVariableServicesCache, NULL, NULL);
+  AddTestCase (ConfigKnobShimLibCommon, "Retrieving default profile value should succeed", "GetConfigKnobOverrideFromVariableStorageFailPpiTest", GetConfigKnobOverrideFromVariableStorageFailPpiTest, ResetVariableServicesCache, NULL, NULL);
+  AddTestCase (ConfigKnobShimLibCommon, "Retrieving a batch of configs from variable should succeed", "GetConfigKnobOverridesSucceedTest", GetConfigKnobOverridesSucceedTest, ResetVariableServicesCache, NULL, NULL);
+  AddTestCase (ConfigKnobShimLibCommon, "Retrieving a batch of default profile values should succeed", "GetConfigKnobOverridesFailPpiTest", GetConfigKnobOverridesFailPpiTest, ResetVariableServicesCache, NULL, NULL);
+  AddTestCase (ConfigKnobShimLibCommon, "Variable services should only be located once", "GetConfigKnobOverrideCachedVariableServicesTest", GetConfigKnobOverrideCachedVariableServicesTest, ResetVariableServicesCache, NULL, NULL);
+  AddTestCase (ConfigKnobShimLibCommon, "A batch of configs should be retrieved from a snapshot HOB", "GetConfigKnobOverridesSnapshotTest", GetConfigKnobOverridesSnapshotTest, ResetVariableServicesCache, NULL, NULL);
+  AddTestCase (ConfigKnobShimLibCommon, "A cached policy should only be returned for its fingerprint", "GetConfigKnobCachedPolicyTest", GetConfigKnobCachedPolicyTest, ResetVariableServicesCache, NULL, NULL);
 
   //
   // Execute the tests.
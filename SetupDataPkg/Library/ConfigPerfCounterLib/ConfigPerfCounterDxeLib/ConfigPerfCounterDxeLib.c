@@ -0,0 +1,175 @@
+/** @file ConfigPerfCounterDxeLib.c
+  DXE library instance of ConfigPerfCounterLib, counting in a configuration table shared by every DXE driver and UEFI
+  application. The first module to count installs the table, with a copy of the counters of the PEI HOB.
+
+  The table is boot services data, this instance is not to be used after ExitBootServices.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <PiDxe.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/HobLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Library/ConfigPerfCounterLib.h>
+
+STATIC CONFIG_PERF_COUNTER_TABLE  *mConfigPerfCounterTable = NULL;
+
+/**
+  Find the counter table configuration table, installing it if requested and it does not exist yet.
+
+  @param[in]  Create    Whether to install the table if it does not exist.
+
+  @return The counter table, or NULL if it does not exist and could not or was not to be installed.
+
+**/
+STATIC
+CONFIG_PERF_COUNTER_TABLE *
+LocateConfigPerfCounterTable (
+  IN  BOOLEAN  Create
+  )
+{
+  EFI_STATUS                 Status;
+  EFI_HOB_GUID_TYPE          *GuidHob;
+  CONFIG_PERF_COUNTER_TABLE  *Table;
+  CONFIG_PERF_COUNTER_TABLE  *PeiTable;
+
+  if (mConfigPerfCounterTable != NULL) {
+    return mConfigPerfCounterTable;
+  }
+
+  Status = EfiGetSystemConfigurationTable (&gConfigPerfCounterTableGuid, (VOID **)&Table);
+  if (!EFI_ERROR (Status) && (Table != NULL)) {
+    if ((Table->Signature != CONFIG_PERF_COUNTER_TABLE_SIGNATURE) || (Table->CounterCount != ConfigPerfCounterMax)) {
+      // Installed by a module with another version of this library, do not write past its counters
+      return NULL;
+    }
+
+    mConfigPerfCounterTable = Table;
+    return Table;
+  }
+
+  if (!Create) {
+    return NULL;
+  }
+
+  Table = AllocateZeroPool (sizeof (*Table));
+  if (Table == NULL) {
+    DEBUG ((DEBUG_WARN, "%a: Failed to allocate the config counter table\n", __FUNCTION__));
+    return NULL;
+  }
+
+  Table->Signature    = CONFIG_PERF_COUNTER_TABLE_SIGNATURE;
+  Table->Version      = CONFIG_PERF_COUNTER_TABLE_VERSION;
+  Table->CounterCount = ConfigPerfCounterMax;
+
+  GuidHob = GetFirstGuidHob (&gConfigPerfCounterTableGuid);
+  if ((GuidHob != NULL) && (GET_GUID_HOB_DATA_SIZE (GuidHob) >= sizeof (*PeiTable))) {
+    PeiTable = (CONFIG_PERF_COUNTER_TABLE *)GET_GUID_HOB_DATA (GuidHob);
+    if ((PeiTable->Signature == CONFIG_PERF_COUNTER_TABLE_SIGNATURE) &&
+        (PeiTable->CounterCount == ConfigPerfCounterMax))
+    {
+      CopyMem (Table->PeiCounters, PeiTable->PeiCounters, sizeof (Table->PeiCounters));
+    }
+  }
+
+  Status = gBS->InstallConfigurationTable (&gConfigPerfCounterTableGuid, Table);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "%a: Failed to install the config counter table - %r\n", __FUNCTION__, Status));
+    FreePool (Table);
+    return NULL;
+  }
+
+  mConfigPerfCounterTable = Table;
+  return Table;
+}
+
+/**
+  Add to a counter of the current phase. The counter table of the phase is created on first use.
+
+  The counters are best effort: they are silently dropped if the table cannot be created.
+
+  @param[in]  Counter   The counter to add to.
+  @param[in]  Value     The amount to add.
+
+**/
+VOID
+EFIAPI
+ConfigPerfCounterAdd (
+  IN CONFIG_PERF_COUNTER  Counter,
+  IN UINT64               Value
+  )
+{
+  CONFIG_PERF_COUNTER_TABLE  *Table;
+
+  if ((UINTN)Counter >= ConfigPerfCounterMax) {
+    ASSERT ((UINTN)Counter < ConfigPerfCounterMax);
+    return;
+  }
+
+  Table = LocateConfigPerfCounterTable (TRUE);
+  if (Table != NULL) {
+    Table->DxeCounters[Counter] += Value;
+  }
+}
+
+/**
+  Get the counter table of the current phase.
+
+  @param[out] Table     The counter table. It is owned by the library and must not be freed.
+
+  @retval EFI_INVALID_PARAMETER   Table is NULL.
+  @retval EFI_NOT_FOUND           Nothing has been counted in this phase yet.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+GetConfigPerfCounterTable (
+  OUT CONFIG_PERF_COUNTER_TABLE  **Table
+  )
+{
+  if (Table == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *Table = LocateConfigPerfCounterTable (FALSE);
+
+  return (*Table == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
+}
+
+/**
+  Copy the counter table of the current phase to the CONFIG_PERF_COUNTER_VARIABLE_NAME volatile variable, so that
+  it can be read once the OS is running. Platforms are expected to call this at ReadyToBoot.
+
+  @retval EFI_NOT_FOUND           Nothing has been counted in this phase yet.
+  @retval Others                  The variable could not be written.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+SaveConfigPerfCounterTable (
+  VOID
+  )
+{
+  CONFIG_PERF_COUNTER_TABLE  *Table;
+
+  Table = LocateConfigPerfCounterTable (FALSE);
+  if (Table == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  return gRT->SetVariable (
+                CONFIG_PERF_COUNTER_VARIABLE_NAME,
+                &gConfigPerfCounterTableGuid,
+                CONFIG_PERF_COUNTER_VARIABLE_ATTRIBUTES,
+                sizeof (*Table),
+                Table
+                );
+}
@@ -0,0 +1,134 @@
+/** @file ConfigPerfCounterPeiLib.c
+  PEI library instance of ConfigPerfCounterLib, counting in a GUID HOB shared by every PEIM. The HOB is looked up on
+  each call, as PEIMs may run in place without writable globals.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <PiPei.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/HobLib.h>
+#include <Library/ConfigPerfCounterLib.h>
+
+/**
+  Find the counter table HOB, building it if requested and it does not exist yet.
+
+  @param[in]  Create    Whether to build the HOB if it does not exist.
+
+  @return The counter table, or NULL if it does not exist and could not or was not to be built.
+
+**/
+STATIC
+CONFIG_PERF_COUNTER_TABLE *
+LocateConfigPerfCounterTable (
+  IN  BOOLEAN  Create
+  )
+{
+  EFI_HOB_GUID_TYPE          *GuidHob;
+  CONFIG_PERF_COUNTER_TABLE  *Table;
+
+  GuidHob = GetFirstGuidHob (&gConfigPerfCounterTableGuid);
+  if (GuidHob != NULL) {
+    Table = (CONFIG_PERF_COUNTER_TABLE *)GET_GUID_HOB_DATA (GuidHob);
+    if ((GET_GUID_HOB_DATA_SIZE (GuidHob) < sizeof (*Table)) ||
+        (Table->Signature != CONFIG_PERF_COUNTER_TABLE_SIGNATURE) ||
+        (Table->CounterCount != ConfigPerfCounterMax))
+    {
+      // Built by a PEIM with another version of this library, do not write past its counters
+      return NULL;
+    }
+
+    return Table;
+  }
+
+  if (!Create) {
+    return NULL;
+  }
+
+  Table = (CONFIG_PERF_COUNTER_TABLE *)BuildGuidHob (&gConfigPerfCounterTableGuid, sizeof (*Table));
+  if (Table == NULL) {
+    DEBUG ((DEBUG_WARN, "%a: Failed to build the config counter HOB\n", __FUNCTION__));
+    return NULL;
+  }
+
+  ZeroMem (Table, sizeof (*Table));
+  Table->Signature    = CONFIG_PERF_COUNTER_TABLE_SIGNATURE;
+  Table->Version      = CONFIG_PERF_COUNTER_TABLE_VERSION;
+  Table->CounterCount = ConfigPerfCounterMax;
+
+  return Table;
+}
+
+/**
+  Add to a counter of the current phase. The counter table of the phase is created on first use.
+
+  The counters are best effort: they are silently dropped if the table cannot be created.
+
+  @param[in]  Counter   The counter to add to.
+  @param[in]  Value     The amount to add.
+
+**/
+VOID
+EFIAPI
+ConfigPerfCounterAdd (
+  IN CONFIG_PERF_COUNTER  Counter,
+  IN UINT64               Value
+  )
+{
+  CONFIG_PERF_COUNTER_TABLE  *Table;
+
+  if ((UINTN)Counter >= ConfigPerfCounterMax) {
+    ASSERT ((UINTN)Counter < ConfigPerfCounterMax);
+    return;
+  }
+
+  Table = LocateConfigPerfCounterTable (TRUE);
+  if (Table != NULL) {
+    Table->PeiCounters[Counter] += Value;
+  }
+}
+
+/**
+  Get the counter table of the current phase.
+
+  @param[out] Table     The counter table. It is owned by the library and must not be freed.
+
+  @retval EFI_INVALID_PARAMETER   Table is NULL.
+  @retval EFI_NOT_FOUND           Nothing has been counted in this phase yet.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+GetConfigPerfCounterTable (
+  OUT CONFIG_PERF_COUNTER_TABLE  **Table
+  )
+{
+  if (Table == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *Table = LocateConfigPerfCounterTable (FALSE);
+
+  return (*Table == NULL) ? EFI_NOT_FOUND : EFI_SUCCESS;
+}
+
+/**
+  Copy the counter table of the current phase to the CONFIG_PERF_COUNTER_VARIABLE_NAME volatile variable, so that
+  it can be read once the OS is running. Platforms are expected to call this at ReadyToBoot.
+
+  Variable storage cannot be written in PEI, the PEI counters are published with the DXE configuration table.
+
+  @retval EFI_UNSUPPORTED         This phase does not publish a variable.
+
+**/
+EFI_STATUS
+EFIAPI
+SaveConfigPerfCounterTable (
+  VOID
+  )
+{
+  return EFI_UNSUPPORTED;
+}
@@ -0,0 +1,201 @@
+/** @file
+  Unit tests of the ConfigPerfCounterPeiLib instance.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <PiPei.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/ConfigPerfCounterLib.h>
+
+#include <Library/UnitTestLib.h>
+#include <SetupDataPkgUnitTestStructs.h>
+
+#define UNIT_TEST_APP_NAME     "Config Perf Counter PEI Lib Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+MOCK_GUID_HOB  mCounterHob;
+
+/**
+  Clean up the counter HOB before each test.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED      Test case prerequisite succeeded.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigPerfCounterPrerequisite (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  ZeroMem (&mCounterHob, sizeof (mCounterHob));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Test that the first count builds the counter HOB and later counts add to it.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigPerfCounterAddTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS                 Status;
+  CONFIG_PERF_COUNTER_TABLE  *Table;
+
+  // Nothing has been counted yet
+  will_return (GetFirstGuidHob, &mCounterHob);
+  Status = GetConfigPerfCounterTable (&Table);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+  UT_ASSERT_TRUE (Table == NULL);
+
+  // The first count builds the HOB, the second finds it
+  will_return (GetFirstGuidHob, &mCounterHob);
+  will_return (BuildGuidHob, &mCounterHob);
+  ConfigPerfCounterAdd (ConfigPerfCounterGetVariableCalls, 2);
+
+  will_return (GetFirstGuidHob, &mCounterHob);
+  ConfigPerfCounterAdd (ConfigPerfCounterGetVariableCalls, 3);
+
+  will_return (GetFirstGuidHob, &mCounterHob);
+  Status = GetConfigPerfCounterTable (&Table);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_TRUE (Table == (CONFIG_PERF_COUNTER_TABLE *)mCounterHob.Data);
+  UT_ASSERT_EQUAL (Table->Signature, CONFIG_PERF_COUNTER_TABLE_SIGNATURE);
+  UT_ASSERT_EQUAL (Table->CounterCount, ConfigPerfCounterMax);
+  UT_ASSERT_EQUAL (Table->PeiCounters[ConfigPerfCounterGetVariableCalls], 5);
+  UT_ASSERT_EQUAL (Table->PeiCounters[ConfigPerfCounterSetVariableCalls], 0);
+  UT_ASSERT_EQUAL (Table->DxeCounters[ConfigPerfCounterGetVariableCalls], 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Test that a counter HOB of another counter count is left alone.
+
+  @param[in]  Context    Unused.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigPerfCounterMismatchTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_STATUS                 Status;
+  CONFIG_PERF_COUNTER_TABLE  *Table;
+
+  will_return (GetFirstGuidHob, &mCounterHob);
+  will_return (BuildGuidHob, &mCounterHob);
+  ConfigPerfCounterAdd (ConfigPerfCounterOverrideHits, 1);
+
+  Table               = (CONFIG_PERF_COUNTER_TABLE *)mCounterHob.Data;
+  Table->CounterCount = ConfigPerfCounterMax - 1;
+
+  // No new HOB is built and nothing is written
+  will_return (GetFirstGuidHob, &mCounterHob);
+  ConfigPerfCounterAdd (ConfigPerfCounterOverrideHits, 1);
+  UT_ASSERT_EQUAL (Table->PeiCounters[ConfigPerfCounterOverrideHits], 1);
+
+  will_return (GetFirstGuidHob, &mCounterHob);
+  Status = GetConfigPerfCounterTable (&Table);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  sample unit tests and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      ConfigPerfCounterLib;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the ConfigPerfCounterPeiLib Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&ConfigPerfCounterLib, Framework, "ConfigPerfCounterPeiLib Tests", "ConfigPerfCounterLib.Pei", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for ConfigPerfCounterPeiLib\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----------Description--------------Name----------Function--------Pre---Post-------------------Context-----------
+  //
+  AddTestCase (ConfigPerfCounterLib, "Counts should build and add to the counter HOB", "ConfigPerfCounterAddTest", ConfigPerfCounterAddTest, ConfigPerfCounterPrerequisite, NULL, NULL);
+  AddTestCase (ConfigPerfCounterLib, "Counter HOB of another layout should be left alone", "ConfigPerfCounterMismatchTest", ConfigPerfCounterMismatchTest, ConfigPerfCounterPrerequisite, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
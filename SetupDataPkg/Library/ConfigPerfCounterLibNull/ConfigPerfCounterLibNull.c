@@ -0,0 +1,61 @@
+/** @file ConfigPerfCounterLibNull.c
+  Null library instance of ConfigPerfCounterLib, for phases and platforms that do not count the work done by the
+  configuration libraries.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <Uefi.h>
+#include <Library/ConfigPerfCounterLib.h>
+
+/**
+  Add to a counter of the current phase. The counter table of the phase is created on first use.
+
+  The counters are best effort: they are silently dropped if the table cannot be created.
+
+  @param[in]  Counter   The counter to add to.
+  @param[in]  Value     The amount to add.
+
+**/
+VOID
+EFIAPI
+ConfigPerfCounterAdd (
+  IN CONFIG_PERF_COUNTER  Counter,
+  IN UINT64               Value
+  )
+{
+}
+
+/**
+  Get the counter table of the current phase.
+
+  @param[out] Table     The counter table. It is owned by the library and must not be freed.
+
+  @retval EFI_UNSUPPORTED         This library instance does not count.
+
+**/
+EFI_STATUS
+EFIAPI
+GetConfigPerfCounterTable (
+  OUT CONFIG_PERF_COUNTER_TABLE  **Table
+  )
+{
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Copy the counter table of the current phase to the CONFIG_PERF_COUNTER_VARIABLE_NAME volatile variable, so that
+  it can be read once the OS is running. Platforms are expected to call this at ReadyToBoot.
+
+  @retval EFI_UNSUPPORTED         This library instance does not publish a variable.
+
+**/
+EFI_STATUS
+EFIAPI
+SaveConfigPerfCounterTable (
+  VOID
+  )
+{
+  return EFI_UNSUPPORTED;
+}
@@ -10,49 +10,62 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/DebugLib.h>
-#include <PiDxe.h>
-#include <Library/DxeServicesLib.h>
-#include <Library/PcdLib.h>
 #include <Library/ConfigVariableListLib.h>
 #include <Library/SafeIntLib.h>
+#include <Library/ConfigCrcLib.h>
+#include <Library/ConfigPerfCounterLib.h>
+#include <Library/PerformanceLib.h>
+#include "ConfigVariableListLibCommon.h"
+
+// Alignment of each entry data in a single allocation variable list
+#define CONFIG_VAR_LIST_ARENA_DATA_ALIGNMENT  8
 
 /**
-  Return the size of the variable list given a NameSize (including null terminator) and DataSize
+  Internal helper to copy the name and data of a validated entry view into newly allocated buffers.
+
+  @param[in]  EntryView       Pointer to view of a validated variable list entry.
+  @param[out] VariableEntry   Pointer to converted variable entry. Upon successful return,
+                              callers are responsible for freeing the Name and Data fields.
 
-  @param[in]  NameSize    Size in bytes of the CHAR16 name of the config knob including null terminator
-  @param[in]  DataSize    Size in bytes of the Data of the config knob
-  @param[out] NeededSize  Size in bytes of the variable list based on these inputs. Unchanged if not EFI_SUCCESS returned.
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_SUCCESS             The operation succeeds.
 
-  @retval EFI_INVALID_PARAMETER NeededSize was null
-  @retval EFI_BUFFER_TOO_SMALL  Overflow occurred on addition
-  @retval EFI_SUCCESS           NeededSize contains the variable list size
 **/
+STATIC
 EFI_STATUS
-EFIAPI
-GetVarListSize (
-  IN  UINT32  NameSize,
-  IN  UINT32  DataSize,
-  OUT UINT32  *NeededSize
+CopyEntryViewToVariableEntry (
+  IN  CONST CONFIG_VAR_LIST_ENTRY_VIEW  *EntryView,
+  OUT CONFIG_VAR_LIST_ENTRY             *VariableEntry
   )
 {
-  UINT32         CalculatedSize = sizeof (CONFIG_VAR_LIST_HDR) + sizeof (EFI_GUID) + sizeof (UINT32) + sizeof (UINT32);
-  RETURN_STATUS  Status;
+  CHAR16  *VarName;
+  CHAR8   *Data;
 
-  if (NeededSize == NULL) {
-    return EFI_INVALID_PARAMETER;
+  VarName = AllocatePool (EntryView->NameSize);
+  if (VarName == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to allocate memory for VarName size: %u\n", __FUNCTION__, EntryView->NameSize));
+    return EFI_OUT_OF_RESOURCES;
   }
 
-  Status = SafeUint32Add (CalculatedSize, NameSize, &CalculatedSize);
-  if (RETURN_ERROR (Status)) {
-    return (EFI_STATUS)Status;
-  }
+  ConfigPerfCounterAdd (ConfigPerfCounterAllocations, 1);
+  CopyMem (VarName, EntryView->Name, EntryView->NameSize);
 
-  Status = SafeUint32Add (CalculatedSize, DataSize, &CalculatedSize);
-  if (RETURN_ERROR (Status)) {
-    return (EFI_STATUS)Status;
+  Data = AllocatePool (EntryView->DataSize);
+  if (Data == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to allocate memory for Data size: %u\n", __FUNCTION__, EntryView->DataSize));
+    FreePool (VarName);
+    return EFI_OUT_OF_RESOURCES;
   }
 
-  *NeededSize = CalculatedSize;
+  ConfigPerfCounterAdd (ConfigPerfCounterAllocations, 1);
+  CopyMem (Data, EntryView->Data, EntryView->DataSize);
+
+  // Add correct values to this entry in the blob
+  VariableEntry->Name       = VarName;
+  VariableEntry->Attributes = EntryView->Attributes;
+  VariableEntry->Data       = Data;
+  VariableEntry->DataSize   = EntryView->DataSize;
+  CopyMem (&VariableEntry->Guid, EntryView->Guid, sizeof (EFI_GUID));
 
   return EFI_SUCCESS;
 }
@@ -82,19 +95,8 @@ ConvertVariableListToVariableEntry (
   OUT CONFIG_VAR_LIST_ENTRY  *VariableEntry
   )
 {
-  CONST EFI_GUID             *Guid;
-  CONST CHAR16               *NameInBin;
-  CONST CHAR8                *DataInBin;
-  CONST CONFIG_VAR_LIST_HDR  *VarList = NULL;
-  UINTN                      BinSize  = 0;
-  EFI_STATUS                 Status   = EFI_SUCCESS;
-  CHAR16                     *VarName = NULL;
-  CHAR8                      *Data    = NULL;
-  UINT32                     Attributes;
-  UINT32                     CRC32;
-  UINT32                     CalcCRC32;
-  UINT32                     NeededSize = 0;
-  CONFIG_VAR_LIST_ENTRY      *Entry;
+  EFI_STATUS                  Status = EFI_SUCCESS;
+  CONFIG_VAR_LIST_ENTRY_VIEW  View;
 
   // Sanity check for input parameters
   if ((VariableListBuffer == NULL) || (Size == NULL) || (VariableEntry == NULL)) {
@@ -102,197 +104,298 @@ ConvertVariableListToVariableEntry (
     goto Exit;
   }
 
-  if (*Size < sizeof (*VarList)) {
-    Status = EFI_BUFFER_TOO_SMALL;
+  Status = ValidateVariableListInPlace (VariableListBuffer, Size, TRUE, &View);
+  if (EFI_ERROR (Status)) {
     goto Exit;
   }
 
-  // index into variable list
-  BinSize = *Size;
-  VarList = (CONST CONFIG_VAR_LIST_HDR *)((CHAR8 *)VariableListBuffer);
-  Status  = GetVarListSize (VarList->NameSize, VarList->DataSize, &NeededSize);
+  Status = CopyEntryViewToVariableEntry (&View, VariableEntry);
+
+Exit:
+  return Status;
+}
+
+/**
+  Parse an aligned Active Config Variable List and return full list or specific entry if VarName parameter != NULL
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer, starting with a
+                                      CONFIG_VAR_LIST_ALIGNED_HDR.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[out] ConfigVarListPtr        Pointer to configuration data. User is responsible to free the
+                                      returned buffer and the Data, Name fields for each entry.
+  @param[out] ConfigVarListCount      Number of variable list entries.
+  @param[in]  ConfigVarName           If NULL, return full list, else return entry for that variable
+  @param[in]  VerifyCrc               Whether to verify the CRC32 in the header.
 
+  @retval EFI_INVALID_PARAMETER   The buffer is not aligned to CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT.
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_NOT_FOUND           The requested variable is not found in VariableListBuffer.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains data that does not fit within the structure defined.
+  @retval EFI_UNSUPPORTED         The aligned variable list buffer has an unknown version.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+STATIC
+EFI_STATUS
+ParseAlignedConfigVarList (
+  IN  CONST VOID             *VariableListBuffer,
+  IN  UINTN                  VariableListBufferSize,
+  OUT CONFIG_VAR_LIST_ENTRY  **ConfigVarListPtr,
+  OUT UINTN                  *ConfigVarListCount,
+  IN  CONST CHAR16           *ConfigVarName,
+  IN  BOOLEAN                VerifyCrc
+  )
+{
+  CONST CONFIG_VAR_LIST_ALIGNED_HDR  *Hdr;
+  CONFIG_VAR_LIST_ENTRY_VIEW         View;
+  EFI_STATUS                         Status;
+  UINTN                              EntryIndex;
+  UINTN                              AllocationSize;
+
+  Status = ValidateAlignedConfigVarList (VariableListBuffer, VariableListBufferSize, VerifyCrc);
   if (EFI_ERROR (Status)) {
-    // we overflowed
-    DEBUG ((
-      DEBUG_ERROR,
-      "%a VarList size overflowed, too large of config! NameSize: 0x%x DataSize: 0x%x\n",
-      __FUNCTION__,
-      VarList->NameSize,
-      VarList->DataSize
-      ));
     goto Exit;
   }
 
-  if ((UINTN)NeededSize > BinSize) {
-    // the NameSize and DataInBinSize have bad values and are pushing us past the end of the binary
-    DEBUG ((DEBUG_ERROR, "%a VarList buffer does not have needed size (actual: %x, expected: %x)\n", __FUNCTION__, BinSize, NeededSize));
-    *Size  = (UINTN)NeededSize;
-    Status = EFI_BUFFER_TOO_SMALL;
+  Hdr = (CONST CONFIG_VAR_LIST_ALIGNED_HDR *)VariableListBuffer;
+  if (Hdr->EntryCount == 0) {
+    DEBUG ((DEBUG_ERROR, "%a Aligned variable list has no entries\n", __FUNCTION__));
+    Status = EFI_NOT_FOUND;
     goto Exit;
   }
 
-  // Use this as stub to indicate how much buffer used.
-  *Size = (UINTN)NeededSize;
-
-  /*
-    * Var List is in DmpStore format:
-    *
-    *  struct {
-    *    CONFIG_VAR_LIST_HDR VarList;
-    *    CHAR16 Name[VarList->NameSize/2];
-    *    EFI_GUID Guid;
-    *    UINT32 Attributes;
-    *    CHAR8 DataInBin[VarList-DataSize];
-    *    UINT32 CRC32; // CRC32 of all bytes from VarList to end of DataInBin
-    *  }
-    */
-  NameInBin = (CONST CHAR16 *)(VarList + 1);
-  Guid      = (CONST EFI_GUID *)((CHAR8 *)NameInBin + VarList->NameSize);
-  CopyMem (&Attributes, (Guid + 1), sizeof (UINT32));
-  DataInBin = (CONST CHAR8 *)Guid + sizeof (*Guid) + sizeof (Attributes);
-  CopyMem (&CRC32, (DataInBin + VarList->DataSize), sizeof (UINT32));
-
-  // validate CRC32
-  CalcCRC32 = CalculateCrc32 ((VOID *)VarList, NeededSize - sizeof (CRC32));
-  if (CRC32 != CalcCRC32) {
-    DEBUG ((DEBUG_ERROR, "%a CRC is off in the variable list: actual: %x, expect %x\n", __FUNCTION__, CRC32, CalcCRC32));
-    Status = EFI_COMPROMISED_DATA;
-    goto Exit;
-  }
+  if (ConfigVarName == NULL) {
+    // The entry count is known up front, so the list is allocated once
+    Status = SafeUintnMult (Hdr->EntryCount, sizeof (CONFIG_VAR_LIST_ENTRY), &AllocationSize);
+    if (EFI_ERROR (Status)) {
+      goto Exit;
+    }
 
-  VarName = AllocatePool (VarList->NameSize);
-  if (VarName == NULL) {
-    DEBUG ((DEBUG_ERROR, "%a Failed to allocate memory for VarName size: %u\n", __FUNCTION__, VarList->NameSize));
-    Status = EFI_OUT_OF_RESOURCES;
-    goto Exit;
+    *ConfigVarListPtr = AllocateZeroPool (AllocationSize);
+    if (*ConfigVarListPtr == NULL) {
+      DEBUG ((DEBUG_ERROR, "%a Failed to allocate memory for ConfigVarListPtr count: %u\n", __FUNCTION__, Hdr->EntryCount));
+      Status = EFI_OUT_OF_RESOURCES;
+      goto Exit;
+    }
+
+    ConfigPerfCounterAdd (ConfigPerfCounterAllocations, 1);
   }
 
-  CopyMem (VarName, NameInBin, VarList->NameSize);
+  for (EntryIndex = 0; EntryIndex < Hdr->EntryCount; EntryIndex++) {
+    Status = GetAlignedConfigVarListEntry (Hdr, EntryIndex, &View);
+    if (EFI_ERROR (Status)) {
+      goto Exit;
+    }
 
-  Data = AllocatePool (VarList->DataSize);
-  if (Data == NULL) {
-    DEBUG ((DEBUG_ERROR, "%a Failed to allocate memory for Data size: %u\n", __FUNCTION__, VarList->DataSize));
-    Status = EFI_OUT_OF_RESOURCES;
-    // Free VarName here, as other memory gets freed in exit routine
-    FreePool (VarName);
-    goto Exit;
-  }
+    // Only copy out the entry we are looking for
+    if ((ConfigVarName != NULL) && (0 != StrnCmp (ConfigVarName, View.Name, View.NameSize / 2))) {
+      continue;
+    }
 
-  CopyMem (Data, DataInBin, VarList->DataSize);
+    Status = CopyEntryViewToVariableEntry (&View, &(*ConfigVarListPtr)[*ConfigVarListCount]);
+    if (EFI_ERROR (Status)) {
+      goto Exit;
+    }
 
-  // Add correct values to this entry in the blob
-  Entry = VariableEntry;
+    (*ConfigVarListCount)++;
 
-  Entry->Name       = VarName;
-  Entry->Guid       = *Guid;
-  Entry->Attributes = Attributes;
-  Entry->Data       = Data;
-  Entry->DataSize   = VarList->DataSize;
+    if (ConfigVarName != NULL) {
+      // Found the entry we are looking for
+      break;
+    }
+  }
 
-  Status = EFI_SUCCESS;
+  if (*ConfigVarListCount == 0) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to find varname in var list: %s\n", __FUNCTION__, ConfigVarName));
+    Status = EFI_NOT_FOUND;
+  }
 
 Exit:
+  if (EFI_ERROR (Status)) {
+    while (*ConfigVarListCount > 0) {
+      (*ConfigVarListCount)--;
+      FreePool ((*ConfigVarListPtr)[*ConfigVarListCount].Name);
+      FreePool ((*ConfigVarListPtr)[*ConfigVarListCount].Data);
+    }
+
+    // only free *ConfigVarListPtr if we allocated it
+    if ((*ConfigVarListPtr != NULL) && (ConfigVarName == NULL)) {
+      FreePool (*ConfigVarListPtr);
+      *ConfigVarListPtr = NULL;
+    }
+  }
+
   return Status;
 }
 
 /**
-  Helper function to convert variable entry to variable list.
+  Internal helper to allocate the scratch memory of a compressed variable list and initialize a stream over it.
 
-  @param[in]      VariableEntry         Pointer to variable entry to be converted.
-  @param[out]     VariableListBuffer    Pointer to buffer holding returned variable list.
-  @param[in,out]  Size                  On input, it indicates the size of input buffer. On output,
-                                        it indicates the buffer needed for converting from
-                                        VariableEntry. Updated on successful conversion and EFI_BUFFER_TOO_SMALL
-                                        returns.
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer, starting with a
+                                      CONFIG_VAR_LIST_COMPRESSED_HDR.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[out] Stream                  Pointer to stream to be initialized.
+  @param[out] Scratch                 Pointer to the scratch memory of the stream, to be freed by the caller
+                                      with FreePool once the stream is no longer used.
 
-  @retval EFI_INVALID_PARAMETER   One or more input arguments are null.
   @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
-  @retval EFI_BUFFER_TOO_SMALL    The input buffer does not contain a full variable list.
-  @retval EFI_COMPROMISED_DATA    The input variable list buffer has a corrupted CRC.
+  @retval EFI_COMPROMISED_DATA    The compressed variable list is corrupted.
+  @retval EFI_UNSUPPORTED         The compressed variable list buffer has an unknown version.
   @retval EFI_SUCCESS             The operation succeeds.
 
 **/
+STATIC
 EFI_STATUS
-EFIAPI
-ConvertVariableEntryToVariableList (
-  IN  CONST CONFIG_VAR_LIST_ENTRY  *VariableEntry,
-  OUT VOID                         *VariableListBuffer,
-  IN OUT UINTN                     *Size
+InitCompressedConfigVarListStream (
+  IN  CONST VOID              *VariableListBuffer,
+  IN  UINTN                   VariableListBufferSize,
+  OUT CONFIG_VAR_LIST_STREAM  *Stream,
+  OUT VOID                    **Scratch
   )
 {
   EFI_STATUS  Status;
-  UINT32      NameSize;
-  UINT32      NeededSize;
-  UINTN       Offset;
-  UINT32      Crc32;
+  UINTN       ScratchSize;
 
-  // Sanity check for input parameters
-  if ((Size == NULL) || (VariableEntry == NULL) || ((VariableListBuffer == NULL) && (*Size != 0))) {
-    Status = EFI_INVALID_PARAMETER;
-    goto Exit;
+  *Scratch    = NULL;
+  ScratchSize = 0;
+  Status      = ConfigVarListStreamInit (VariableListBuffer, VariableListBufferSize, NULL, &ScratchSize, Stream);
+  if (Status != EFI_BUFFER_TOO_SMALL) {
+    return EFI_ERROR (Status) ? Status : EFI_COMPROMISED_DATA;
   }
 
-  // Sanity check 2 for input parameters
-  if ((VariableEntry->Name == NULL) || (VariableEntry->Data == NULL)) {
-    Status = EFI_INVALID_PARAMETER;
-    goto Exit;
+  *Scratch = AllocatePool (MAX (ScratchSize, 1));
+  if (*Scratch == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to allocate scratch memory size: 0x%x\n", __FUNCTION__, ScratchSize));
+    return EFI_OUT_OF_RESOURCES;
   }
 
-  NameSize = (UINT32)StrnSizeS (VariableEntry->Name, CONF_VAR_NAME_LEN);
-  Status   = GetVarListSize (NameSize, VariableEntry->DataSize, &NeededSize);
+  ConfigPerfCounterAdd (ConfigPerfCounterAllocations, 1);
 
+  Status = ConfigVarListStreamInit (VariableListBuffer, VariableListBufferSize, *Scratch, &ScratchSize, Stream);
   if (EFI_ERROR (Status)) {
-    // overflowed...
-    DEBUG ((DEBUG_ERROR, "%a VarList size overflowed, too large of config!\n", __FUNCTION__));
-    goto Exit;
+    FreePool (*Scratch);
+    *Scratch = NULL;
   }
 
-  if (*Size < (UINTN)NeededSize) {
-    Status = EFI_BUFFER_TOO_SMALL;
-    *Size  = (UINTN)NeededSize;
+  return Status;
+}
+
+/**
+  Parse a compressed Active Config Variable List and return full list or specific entry if VarName parameter != NULL
+
+  The entries are decompressed one at a time, and only the ones returned are copied.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer, starting with a
+                                      CONFIG_VAR_LIST_COMPRESSED_HDR.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[out] ConfigVarListPtr        Pointer to configuration data. User is responsible to free the
+                                      returned buffer and the Data, Name fields for each entry.
+  @param[out] ConfigVarListCount      Number of variable list entries.
+  @param[in]  ConfigVarName           If NULL, return full list, else return entry for that variable
+
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_NOT_FOUND           The requested variable is not found in VariableListBuffer.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains data that does not fit within the structure defined.
+  @retval EFI_UNSUPPORTED         The compressed variable list buffer has an unknown version.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+STATIC
+EFI_STATUS
+ParseCompressedConfigVarList (
+  IN  CONST VOID             *VariableListBuffer,
+  IN  UINTN                  VariableListBufferSize,
+  OUT CONFIG_VAR_LIST_ENTRY  **ConfigVarListPtr,
+  OUT UINTN                  *ConfigVarListCount,
+  IN  CONST CHAR16           *ConfigVarName
+  )
+{
+  CONFIG_VAR_LIST_STREAM      Stream;
+  CONFIG_VAR_LIST_ENTRY_VIEW  View;
+  EFI_STATUS                  Status;
+  VOID                        *Scratch;
+  UINTN                       AllocationSize;
+
+  Status = InitCompressedConfigVarListStream (VariableListBuffer, VariableListBufferSize, &Stream, &Scratch);
+  if (EFI_ERROR (Status)) {
     goto Exit;
   }
 
-  Offset = 0;
-  // Header
-  ((CONFIG_VAR_LIST_HDR *)VariableListBuffer)->NameSize = (UINT32)NameSize;
-  ((CONFIG_VAR_LIST_HDR *)VariableListBuffer)->DataSize = (UINT32)VariableEntry->DataSize;
-  Offset                                               += sizeof (CONFIG_VAR_LIST_HDR);
-
-  // Name
-  CopyMem ((UINT8 *)(VariableListBuffer) + Offset, VariableEntry->Name, NameSize);
-  Offset += NameSize;
-
-  // Guid
-  CopyMem ((UINT8 *)(VariableListBuffer) + Offset, &VariableEntry->Guid, sizeof (VariableEntry->Guid));
-  Offset += sizeof (VariableEntry->Guid);
-
-  // Attributes
-  CopyMem ((UINT8 *)(VariableListBuffer) + Offset, &VariableEntry->Attributes, sizeof (VariableEntry->Attributes));
-  Offset += sizeof (VariableEntry->Attributes);
-
-  // Data
-  CopyMem ((UINT8 *)(VariableListBuffer) + Offset, VariableEntry->Data, VariableEntry->DataSize);
-  Offset += VariableEntry->DataSize;
-
-  // CRC32
-  Crc32 = CalculateCrc32 (VariableListBuffer, Offset);
-  CopyMem ((UINT8 *)(VariableListBuffer) + Offset, &Crc32, sizeof (UINT32));
-  Offset += sizeof (UINT32);
-
-  *Size = (UINTN)NeededSize;
-
-  // They should still match in size...
-  if (Offset != (UINTN)NeededSize) {
-    ASSERT (Offset == (UINTN)NeededSize);
-    Status = EFI_COMPROMISED_DATA;
+  if (Stream.EntryCount == 0) {
+    DEBUG ((DEBUG_ERROR, "%a Compressed variable list has no entries\n", __FUNCTION__));
+    Status = EFI_NOT_FOUND;
     goto Exit;
   }
 
-  Status = EFI_SUCCESS;
+  if (ConfigVarName == NULL) {
+    // The entry count is known up front, so the list is allocated once
+    Status = SafeUintnMult (Stream.EntryCount, sizeof (CONFIG_VAR_LIST_ENTRY), &AllocationSize);
+    if (EFI_ERROR (Status)) {
+      goto Exit;
+    }
+
+    *ConfigVarListPtr = AllocateZeroPool (AllocationSize);
+    if (*ConfigVarListPtr == NULL) {
+      DEBUG ((DEBUG_ERROR, "%a Failed to allocate memory for ConfigVarListPtr count: %u\n", __FUNCTION__, Stream.EntryCount));
+      Status = EFI_OUT_OF_RESOURCES;
+      goto Exit;
+    }
+
+    ConfigPerfCounterAdd (ConfigPerfCounterAllocations, 1);
+  }
+
+  while (TRUE) {
+    Status = ConfigVarListStreamNext (&Stream, &View);
+    if (EFI_ERROR (Status)) {
+      if (Status == EFI_NOT_FOUND) {
+        Status = EFI_SUCCESS;
+      }
+
+      break;
+    }
+
+    // Only copy out the entry we are looking for
+    if ((ConfigVarName != NULL) && (0 != StrnCmp (ConfigVarName, View.Name, View.NameSize / 2))) {
+      continue;
+    }
+
+    Status = CopyEntryViewToVariableEntry (&View, &(*ConfigVarListPtr)[*ConfigVarListCount]);
+    if (EFI_ERROR (Status)) {
+      goto Exit;
+    }
+
+    (*ConfigVarListCount)++;
+
+    if (ConfigVarName != NULL) {
+      // Found the entry we are looking for
+      break;
+    }
+  }
+
+  if (!EFI_ERROR (Status) && (*ConfigVarListCount == 0)) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to find varname in var list: %s\n", __FUNCTION__, ConfigVarName));
+    Status = EFI_NOT_FOUND;
+  }
 
 Exit:
+  if (EFI_ERROR (Status)) {
+    while (*ConfigVarListCount > 0) {
+      (*ConfigVarListCount)--;
+      FreePool ((*ConfigVarListPtr)[*ConfigVarListCount].Name);
+      FreePool ((*ConfigVarListPtr)[*ConfigVarListCount].Data);
+    }
+
+    // only free *ConfigVarListPtr if we allocated it
+    if ((*ConfigVarListPtr != NULL) && (ConfigVarName == NULL)) {
+      FreePool (*ConfigVarListPtr);
+      *ConfigVarListPtr = NULL;
+    }
+  }
+
+  if (Scratch != NULL) {
+    FreePool (Scratch);
+  }
+
   return Status;
 }
 
@@ -305,6 +408,9 @@ Exit:
                                       returned buffer and the Data, Name fields for each entry.
   @param[out] ConfigVarListCount      Number of variable list entries.
   @param[in]  ConfigVarName           If NULL, return full list, else return entry for that variable
+  @param[in]  VerifyCrc               Whether to verify the CRC32 of each entry, or of the aligned
+                                      variable list. Only to be skipped for buffers that were already
+                                      validated as a whole.
 
   @retval EFI_INVALID_PARAMETER   Input argument is null.
   @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
@@ -319,14 +425,16 @@ ParseActiveConfigVarList (
   IN  UINTN                  VariableListBufferSize,
   OUT CONFIG_VAR_LIST_ENTRY  **ConfigVarListPtr,
   OUT UINTN                  *ConfigVarListCount,
-  IN  CONST CHAR16           *ConfigVarName
+  IN  CONST CHAR16           *ConfigVarName,
+  IN  BOOLEAN                VerifyCrc
   )
 {
-  UINTN                      LeftSize       = 0;
-  CONST CONFIG_VAR_LIST_HDR  *VarList       = NULL;
-  EFI_STATUS                 Status         = EFI_SUCCESS;
-  UINTN                      ListIndex      = 0;
-  UINTN                      AllocatedCount = 1;
+  UINTN                       LeftSize       = 0;
+  CONST CONFIG_VAR_LIST_HDR   *VarList       = NULL;
+  EFI_STATUS                  Status         = EFI_SUCCESS;
+  UINTN                       ListIndex      = 0;
+  UINTN                       AllocatedCount = 1;
+  CONFIG_VAR_LIST_ENTRY_VIEW  View;
 
   if ((ConfigVarListPtr == NULL) || (ConfigVarListCount == NULL)) {
     DEBUG ((DEBUG_ERROR, "%a Null parameter passed\n", __FUNCTION__));
@@ -351,6 +459,22 @@ ParseActiveConfigVarList (
     goto Exit;
   }
 
+  if (IsAlignedConfigVarList (VariableListBuffer, VariableListBufferSize)) {
+    if (ConfigVarName == NULL) {
+      *ConfigVarListPtr = NULL;
+    }
+
+    return ParseAlignedConfigVarList (VariableListBuffer, VariableListBufferSize, ConfigVarListPtr, ConfigVarListCount, ConfigVarName, VerifyCrc);
+  }
+
+  if (IsCompressedConfigVarList (VariableListBuffer, VariableListBufferSize)) {
+    if (ConfigVarName == NULL) {
+      *ConfigVarListPtr = NULL;
+    }
+
+    return ParseCompressedConfigVarList (VariableListBuffer, VariableListBufferSize, ConfigVarListPtr, ConfigVarListCount, ConfigVarName);
+  }
+
   if (ConfigVarName == NULL) {
     // We don't know how many entries there are, for now allocate 1 entry and extend the size when needed.
     *ConfigVarListPtr = NULL;
@@ -363,12 +487,19 @@ ParseActiveConfigVarList (
     goto Exit;
   }
 
+  if (ConfigVarName == NULL) {
+    ConfigPerfCounterAdd (ConfigPerfCounterAllocations, 1);
+  }
+
   while (ListIndex < VariableListBufferSize) {
     // index into variable list
     VarList = (CONST CONFIG_VAR_LIST_HDR *)((CHAR8 *)VariableListBuffer + ListIndex);
 
     LeftSize = VariableListBufferSize - ListIndex;
-    Status   = ConvertVariableListToVariableEntry (VarList, &LeftSize, &(*ConfigVarListPtr)[*ConfigVarListCount]);
+    Status   = ValidateVariableListInPlace (VarList, &LeftSize, VerifyCrc, &View);
+    if (!EFI_ERROR (Status)) {
+      Status = CopyEntryViewToVariableEntry (&View, &(*ConfigVarListPtr)[*ConfigVarListCount]);
+    }
 
     if (EFI_ERROR (Status)) {
       // Unable to convert this specific variable list
@@ -406,6 +537,7 @@ ParseActiveConfigVarList (
         goto Exit;
       }
 
+      ConfigPerfCounterAdd (ConfigPerfCounterAllocations, 1);
       AllocatedCount = AllocatedCount * 2;
     }
   }
@@ -446,6 +578,8 @@ Exit:
 /**
   Find all active configuration variables for this platform.
 
+  The buffer may be in the packed, the aligned or the compressed variable list format.
+
   @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
   @param[in]  VariableListBufferSize  Size of VariableListBuffer.
   @param[out] ConfigVarListPtr        Pointer to configuration data. User is responsible to free the
@@ -456,6 +590,7 @@ Exit:
   @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
   @retval EFI_NOT_FOUND           The requested variable is not found in VariableListBuffer.
   @retval EFI_COMPROMISED_DATA    The variable list buffer contains data that does not fit within the structure defined.
+  @retval EFI_UNSUPPORTED         The aligned variable list buffer has an unknown version.
   @retval EFI_SUCCESS             The operation succeeds.
 
 **/
@@ -468,18 +603,381 @@ RetrieveActiveConfigVarList (
   OUT UINTN                  *ConfigVarListCount
   )
 {
-  return ParseActiveConfigVarList (VariableListBuffer, VariableListBufferSize, ConfigVarListPtr, ConfigVarListCount, NULL);
+  EFI_STATUS  Status;
+
+  PERF_FUNCTION_BEGIN ();
+  Status = ParseActiveConfigVarList (VariableListBuffer, VariableListBufferSize, ConfigVarListPtr, ConfigVarListCount, NULL, TRUE);
+  PERF_FUNCTION_END ();
+
+  return Status;
+}
+
+/**
+  Find all active configuration variables for this platform, from a buffer whose producer
+  provides the CRC32 of the whole buffer, e.g. the generated default profile. The buffer is
+  checked against that CRC32 once, instead of checking the CRC32 of each entry.
+
+  The buffer may be in the packed, the aligned or the compressed variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]  BlobCrc32               CRC32 of all VariableListBufferSize bytes of VariableListBuffer.
+  @param[out] ConfigVarListPtr        Pointer to configuration data. User is responsible to free the
+                                      returned buffer and the Data, Name fields for each entry.
+  @param[out] ConfigVarListCount      Number of variable list entries.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null.
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_NOT_FOUND           The requested variable is not found in VariableListBuffer.
+  @retval EFI_COMPROMISED_DATA    The CRC32 of the buffer does not match BlobCrc32, or the variable
+                                  list buffer contains data that does not fit within the structure defined.
+  @retval EFI_UNSUPPORTED         The aligned variable list buffer has an unknown version.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+RetrieveActiveConfigVarListWithBlobCrc (
+  IN  CONST VOID             *VariableListBuffer,
+  IN  UINTN                  VariableListBufferSize,
+  IN  UINT32                 BlobCrc32,
+  OUT CONFIG_VAR_LIST_ENTRY  **ConfigVarListPtr,
+  OUT UINTN                  *ConfigVarListCount
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      CalcCRC32;
+
+  PERF_FUNCTION_BEGIN ();
+
+  if ((VariableListBuffer != NULL) && (VariableListBufferSize != 0)) {
+    CalcCRC32 = ConfigCalculateCrc32 (VariableListBuffer, VariableListBufferSize);
+    if (CalcCRC32 != BlobCrc32) {
+      DEBUG ((DEBUG_ERROR, "%a CRC is off in the variable list blob: actual: %x, expect %x\n", __FUNCTION__, BlobCrc32, CalcCRC32));
+      if (ConfigVarListPtr != NULL) {
+        *ConfigVarListPtr = NULL;
+      }
+
+      if (ConfigVarListCount != NULL) {
+        *ConfigVarListCount = 0;
+      }
+
+      Status = EFI_COMPROMISED_DATA;
+      goto Exit;
+    }
+  }
+
+  // The structure is still validated, only the per entry CRC32 is covered by the blob CRC32
+  Status = ParseActiveConfigVarList (VariableListBuffer, VariableListBufferSize, ConfigVarListPtr, ConfigVarListCount, NULL, FALSE);
+
+Exit:
+  PERF_FUNCTION_END ();
+  return Status;
+}
+
+/**
+  Find all active configuration variables for this platform, returned in a single allocation.
+
+  The buffer is walked once to validate and size all entries, then the entry array and all
+  of its names and data are copied into one pool allocation. Each entry data is aligned to
+  CONFIG_VAR_LIST_ARENA_DATA_ALIGNMENT bytes. The buffer may be in the packed, the
+  aligned or the compressed variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[out] ConfigVarListPtr        Pointer to configuration data. User is responsible to free the
+                                      returned buffer with FreeConfigVarList only, the Name and Data
+                                      fields of the entries must not be freed separately.
+  @param[out] ConfigVarListCount      Number of variable list entries.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null.
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_NOT_FOUND           VariableListBuffer contains no entries.
+  @retval EFI_BUFFER_TOO_SMALL    The buffer does not contain a full variable list.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains data that does not fit within the structure defined.
+  @retval EFI_UNSUPPORTED         The aligned variable list buffer has an unknown version.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+RetrieveActiveConfigVarListSingleAllocation (
+  IN  CONST VOID             *VariableListBuffer,
+  IN  UINTN                  VariableListBufferSize,
+  OUT CONFIG_VAR_LIST_ENTRY  **ConfigVarListPtr,
+  OUT UINTN                  *ConfigVarListCount
+  )
+{
+  CONFIG_VAR_LIST_WALKER      Walker;
+  CONFIG_VAR_LIST_ENTRY_VIEW  View;
+  CONFIG_VAR_LIST_ENTRY       *Entries = NULL;
+  VOID                        *Packed  = NULL;
+  UINTN                       PackedSize;
+  UINT8                       *DataPtr;
+  UINT8                       *NamePtr;
+  EFI_STATUS                  Status;
+  UINTN                       Count     = 0;
+  UINTN                       DataSize  = 0;
+  UINTN                       NamesSize = 0;
+  UINTN                       EntriesSize;
+  UINTN                       TotalSize;
+  UINTN                       Index;
+
+  PERF_FUNCTION_BEGIN ();
+
+  if ((ConfigVarListPtr == NULL) || (ConfigVarListCount == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a Null parameter passed\n", __FUNCTION__));
+    Status = EFI_INVALID_PARAMETER;
+    goto Exit;
+  }
+
+  *ConfigVarListPtr   = NULL;
+  *ConfigVarListCount = 0;
+
+  if ((VariableListBuffer == NULL) || (VariableListBufferSize == 0)) {
+    DEBUG ((DEBUG_ERROR, "%a Incoming variable list buffer (base: %p, size: 0x%x) invalid\n", __FUNCTION__, VariableListBuffer, VariableListBufferSize));
+    Status = EFI_INVALID_PARAMETER;
+    goto Exit;
+  }
+
+  if (IsCompressedConfigVarList (VariableListBuffer, VariableListBufferSize)) {
+    // Both passes below walk the buffer in place, so walk the packed form of a compressed list instead
+    Status = RetrieveDecompressedConfigVarList (VariableListBuffer, VariableListBufferSize, &Packed, &PackedSize);
+    if (EFI_ERROR (Status)) {
+      goto Exit;
+    }
+
+    VariableListBuffer     = Packed;
+    VariableListBufferSize = PackedSize;
+  }
+
+  // Sizing pass, which also validates every entry
+  Status = ConfigVarListWalkInit (&Walker, VariableListBuffer, VariableListBufferSize, TRUE);
+  while (!EFI_ERROR (Status)) {
+    Status = ConfigVarListWalkNext (&Walker, &View);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    // Entry sizes are bounded by the input buffer, so only the sums can overflow
+    Count++;
+    Status = SafeUintnAdd (DataSize, ALIGN_VALUE (View.DataSize, CONFIG_VAR_LIST_ARENA_DATA_ALIGNMENT), &DataSize);
+    if (!EFI_ERROR (Status)) {
+      Status = SafeUintnAdd (NamesSize, ALIGN_VALUE (View.NameSize, sizeof (CHAR16)), &NamesSize);
+    }
+  }
+
+  if (Status != EFI_NOT_FOUND) {
+    DEBUG ((DEBUG_ERROR, "%a Variable list entry %u is invalid - %r\n", __FUNCTION__, Count, Status));
+    goto Exit;
+  }
+
+  if (Count == 0) {
+    DEBUG ((DEBUG_ERROR, "%a Variable list has no entries\n", __FUNCTION__));
+    goto Exit;
+  }
+
+  Status = SafeUintnMult (Count, sizeof (CONFIG_VAR_LIST_ENTRY), &EntriesSize);
+  if (!EFI_ERROR (Status)) {
+    EntriesSize = ALIGN_VALUE (EntriesSize, CONFIG_VAR_LIST_ARENA_DATA_ALIGNMENT);
+    Status      = SafeUintnAdd (EntriesSize, DataSize, &TotalSize);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = SafeUintnAdd (TotalSize, NamesSize, &TotalSize);
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a Variable list is too large to fit one allocation\n", __FUNCTION__));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  Entries = AllocatePool (TotalSize);
+  if (Entries == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to allocate memory for variable list size: 0x%x\n", __FUNCTION__, TotalSize));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  ConfigPerfCounterAdd (ConfigPerfCounterAllocations, 1);
+
+  // Data first, as it has the larger alignment, then the names
+  DataPtr = (UINT8 *)Entries + EntriesSize;
+  NamePtr = DataPtr + DataSize;
+
+  // Copy pass, the entries were all validated above
+  Status = ConfigVarListWalkInit (&Walker, VariableListBuffer, VariableListBufferSize, FALSE);
+  for (Index = 0; (Index < Count) && !EFI_ERROR (Status); Index++) {
+    Status = ConfigVarListWalkNext (&Walker, &View);
+    if (EFI_ERROR (Status)) {
+      ASSERT_EFI_ERROR (Status);
+      break;
+    }
+
+    CopyMem (NamePtr, View.Name, View.NameSize);
+    CopyMem (DataPtr, View.Data, View.DataSize);
+
+    Entries[Index].Name       = (CHAR16 *)NamePtr;
+    Entries[Index].Attributes = View.Attributes;
+    Entries[Index].Data       = DataPtr;
+    Entries[Index].DataSize   = View.DataSize;
+    CopyMem (&Entries[Index].Guid, View.Guid, sizeof (EFI_GUID));
+
+    NamePtr += ALIGN_VALUE (View.NameSize, sizeof (CHAR16));
+    DataPtr += ALIGN_VALUE (View.DataSize, CONFIG_VAR_LIST_ARENA_DATA_ALIGNMENT);
+  }
+
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  *ConfigVarListPtr   = Entries;
+  *ConfigVarListCount = Count;
+  Entries             = NULL;
+
+Exit:
+  if (Entries != NULL) {
+    FreePool (Entries);
+  }
+
+  if (Packed != NULL) {
+    FreePool (Packed);
+  }
+
+  PERF_FUNCTION_END ();
+  return Status;
+}
+
+/**
+  Free a variable list returned by RetrieveActiveConfigVarListSingleAllocation.
+
+  @param[in]  ConfigVarList   Pointer to the variable list, may be NULL.
+
+**/
+VOID
+EFIAPI
+FreeConfigVarList (
+  IN CONFIG_VAR_LIST_ENTRY  *ConfigVarList
+  )
+{
+  if (ConfigVarList != NULL) {
+    FreePool (ConfigVarList);
+  }
+}
+
+/**
+  Expand a compressed variable list buffer into a newly allocated buffer holding the same entries in the packed
+  variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw compressed variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[out] PackedBuffer            Pointer to the packed variable list, to be freed by the caller with FreePool.
+  @param[out] PackedBufferSize        Size of PackedBuffer.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null.
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_COMPROMISED_DATA    The compressed variable list is corrupted.
+  @retval EFI_UNSUPPORTED         This library instance does not allocate, or the buffer is not a compressed
+                                  variable list of a known version.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+RetrieveDecompressedConfigVarList (
+  IN  CONST VOID  *VariableListBuffer,
+  IN  UINTN       VariableListBufferSize,
+  OUT VOID        **PackedBuffer,
+  OUT UINTN       *PackedBufferSize
+  )
+{
+  CONFIG_VAR_LIST_STREAM      Stream;
+  CONFIG_VAR_LIST_ENTRY_VIEW  View;
+  EFI_STATUS                  Status;
+  VOID                        *Scratch = NULL;
+  UINT8                       *Packed  = NULL;
+  UINTN                       Offset;
+
+  PERF_FUNCTION_BEGIN ();
+
+  if ((VariableListBuffer == NULL) || (PackedBuffer == NULL) || (PackedBufferSize == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a Null parameter passed\n", __FUNCTION__));
+    Status = EFI_INVALID_PARAMETER;
+    goto Exit;
+  }
+
+  *PackedBuffer     = NULL;
+  *PackedBufferSize = 0;
+
+  Status = InitCompressedConfigVarListStream (VariableListBuffer, VariableListBufferSize, &Stream, &Scratch);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  // The header gives the packed size, so the packed list is allocated once
+  Packed = AllocatePool (MAX (Stream.PackedSize, 1));
+  if (Packed == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to allocate memory for packed variable list size: 0x%x\n", __FUNCTION__, Stream.PackedSize));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  ConfigPerfCounterAdd (ConfigPerfCounterAllocations, 1);
+
+  Offset = 0;
+  while (TRUE) {
+    Status = ConfigVarListStreamNext (&Stream, &View);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    if (View.RawSize > Stream.PackedSize - Offset) {
+      Status = EFI_COMPROMISED_DATA;
+      break;
+    }
+
+    CopyMem (Packed + Offset, View.Raw, View.RawSize);
+    Offset += View.RawSize;
+  }
+
+  if (Status == EFI_NOT_FOUND) {
+    Status = (Offset == Stream.PackedSize) ? EFI_SUCCESS : EFI_COMPROMISED_DATA;
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a Compressed variable list does not expand to its packed size 0x%x - %r\n", __FUNCTION__, Stream.PackedSize, Status));
+    goto Exit;
+  }
+
+  *PackedBuffer     = Packed;
+  *PackedBufferSize = Offset;
+  Packed            = NULL;
+
+Exit:
+  if (Packed != NULL) {
+    FreePool (Packed);
+  }
+
+  if (Scratch != NULL) {
+    FreePool (Scratch);
+  }
+
+  PERF_FUNCTION_END ();
+  return Status;
 }
 
 /**
   Find specified active configuration variable for this platform.
 
+  The buffer may be in the packed, the aligned or the compressed variable list format.
+
   @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
   @param[in]  VariableListBufferSize  Size of VariableListBuffer.
   @param[in]  VarListName             NULL terminated unicode variable name of interest.
   @param[out] ConfigVarListPtr        Pointer to hold variable list entry from VariableListBuffer.
 
-  @retval EFI_UNSUPPORTED         Unsupported operation on this platform.
+  @retval EFI_UNSUPPORTED         Unsupported operation on this platform, or unknown aligned variable list version.
   @retval EFI_INVALID_PARAMETER   Input argument is null.
   @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
   @retval EFI_NOT_FOUND           The requested variable is not found in VariableListBuffer.
@@ -503,18 +1001,20 @@ QuerySingleActiveConfigUnicodeVarList (
     return EFI_INVALID_PARAMETER;
   }
 
-  return ParseActiveConfigVarList (VariableListBuffer, VariableListBufferSize, &ConfigVarListPtr, &ConfigVarListCount, VarName);
+  return ParseActiveConfigVarList (VariableListBuffer, VariableListBufferSize, &ConfigVarListPtr, &ConfigVarListCount, VarName, TRUE);
 }
 
 /**
   Find specified active configuration variable for this platform.
 
+  The buffer may be in the packed, the aligned or the compressed variable list format.
+
   @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
   @param[in]  VariableListBufferSize  Size of VariableListBuffer.
   @param[in]  VarListName             NULL terminated ascii variable name of interest.
   @param[out] ConfigVarListPtr        Pointer to hold variable list entry from VariableListBuffer.
 
-  @retval EFI_UNSUPPORTED         Unsupported operation on this platform.
+  @retval EFI_UNSUPPORTED         Unsupported operation on this platform, or unknown aligned variable list version.
   @retval EFI_INVALID_PARAMETER   Input argument is null.
   @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
   @retval EFI_NOT_FOUND           The requested variable is not found in VariableListBuffer.
@@ -548,7 +1048,108 @@ QuerySingleActiveConfigAsciiVarList (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  ConfigPerfCounterAdd (ConfigPerfCounterAllocations, 1);
   AsciiStrToUnicodeStrS (VarName, UniVarName, UniVarNameLen);
 
-  return ParseActiveConfigVarList (VariableListBuffer, VariableListBufferSize, &ConfigVarListPtr, &ConfigVarListCount, UniVarName);
+  return ParseActiveConfigVarList (VariableListBuffer, VariableListBufferSize, &ConfigVarListPtr, &ConfigVarListCount, UniVarName, TRUE);
+}
+
+/**
+  Validate all entries of a raw packed or aligned variable list buffer once and build a hash index of them, keyed
+  on variable name and namespace GUID, so that subsequent queries do not need to rescan the buffer.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer. Must remain valid
+                                      and unchanged for as long as the index is in use.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[out] Index                   Pointer to the created index. Caller is responsible to free
+                                      it with FreeConfigVarListIndex.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null or VariableListBufferSize is 0.
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_BAD_BUFFER_SIZE     VariableListBufferSize is too large to be indexed.
+  @retval EFI_BUFFER_TOO_SMALL    The buffer does not end with a full variable list.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains an entry with a corrupted CRC.
+  @retval EFI_SUCCESS             The index is created.
+
+**/
+EFI_STATUS
+EFIAPI
+BuildConfigVarListIndex (
+  IN  CONST VOID             *VariableListBuffer,
+  IN  UINTN                  VariableListBufferSize,
+  OUT CONFIG_VAR_LIST_INDEX  **Index
+  )
+{
+  EFI_STATUS             Status;
+  CONFIG_VAR_LIST_INDEX  *NewIndex = NULL;
+  UINTN                  SlotCount;
+
+  PERF_FUNCTION_BEGIN ();
+
+  if ((VariableListBuffer == NULL) || (VariableListBufferSize == 0) || (Index == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a Invalid parameter passed\n", __FUNCTION__));
+    Status = EFI_INVALID_PARAMETER;
+    goto Exit;
+  }
+
+  *Index = NULL;
+
+  // First pass validates every entry and sizes the slots
+  SlotCount = 0;
+  Status    = InitConfigVarListIndexInternal (VariableListBuffer, VariableListBufferSize, NULL, &SlotCount, TRUE, NULL);
+  if (Status != EFI_OUT_OF_RESOURCES) {
+    goto Exit;
+  }
+
+  // Index header and slots share one allocation
+  NewIndex = AllocateZeroPool (sizeof (CONFIG_VAR_LIST_INDEX) + SlotCount * sizeof (CONFIG_VAR_LIST_INDEX_SLOT));
+  if (NewIndex == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to allocate index of %u slots\n", __FUNCTION__, SlotCount));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  ConfigPerfCounterAdd (ConfigPerfCounterAllocations, 1);
+
+  // Second pass inserts the entries, the buffer was validated above so skip the CRCs
+  Status = InitConfigVarListIndexInternal (
+             VariableListBuffer,
+             VariableListBufferSize,
+             (CONFIG_VAR_LIST_INDEX_SLOT *)(NewIndex + 1),
+             &SlotCount,
+             FALSE,
+             NewIndex
+             );
+  if (EFI_ERROR (Status)) {
+    ASSERT_EFI_ERROR (Status);
+    goto Exit;
+  }
+
+  *Index   = NewIndex;
+  NewIndex = NULL;
+
+Exit:
+  if (NewIndex != NULL) {
+    FreePool (NewIndex);
+  }
+
+  PERF_FUNCTION_END ();
+  return Status;
+}
+
+/**
+  Free an index created by BuildConfigVarListIndex. The indexed buffer is not freed.
+
+  @param[in]  Index   Pointer to the index to free, NULL is ignored.
+
+**/
+VOID
+EFIAPI
+FreeConfigVarListIndex (
+  IN  CONFIG_VAR_LIST_INDEX  *Index
+  )
+{
+  if (Index != NULL) {
+    FreePool (Index);
+  }
 }
@@ -0,0 +1,1180 @@
+/** @file
+  Allocation free functionality shared by the ConfigVariableListLib instances, to validate, walk, index and query
+  variable list buffers in place.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/ConfigVariableListLib.h>
+#include <Library/SafeIntLib.h>
+#include <Library/ConfigCrcLib.h>
+#include <Library/ConfigPerfCounterLib.h>
+#include "ConfigVariableListLibCommon.h"
+
+// FNV-1a parameters used to hash variable names for the variable list index
+#define CONFIG_VAR_LIST_HASH_SEED   0x811C9DC5
+#define CONFIG_VAR_LIST_HASH_PRIME  0x01000193
+
+// Smallest index table, must be a power of 2
+#define CONFIG_VAR_LIST_INDEX_MIN_SLOTS  8
+
+/**
+  Return the size of the variable list given a NameSize (including null terminator) and DataSize
+
+  @param[in]  NameSize    Size in bytes of the CHAR16 name of the config knob including null terminator
+  @param[in]  DataSize    Size in bytes of the Data of the config knob
+  @param[out] NeededSize  Size in bytes of the variable list based on these inputs. Unchanged if not EFI_SUCCESS returned.
+
+  @retval EFI_INVALID_PARAMETER NeededSize was null
+  @retval EFI_BUFFER_TOO_SMALL  Overflow occurred on addition
+  @retval EFI_SUCCESS           NeededSize contains the variable list size
+**/
+EFI_STATUS
+EFIAPI
+GetVarListSize (
+  IN  UINT32  NameSize,
+  IN  UINT32  DataSize,
+  OUT UINT32  *NeededSize
+  )
+{
+  UINT32         CalculatedSize = sizeof (CONFIG_VAR_LIST_HDR) + sizeof (EFI_GUID) + sizeof (UINT32) + sizeof (UINT32);
+  RETURN_STATUS  Status;
+
+  if (NeededSize == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = SafeUint32Add (CalculatedSize, NameSize, &CalculatedSize);
+  if (RETURN_ERROR (Status)) {
+    return (EFI_STATUS)Status;
+  }
+
+  Status = SafeUint32Add (CalculatedSize, DataSize, &CalculatedSize);
+  if (RETURN_ERROR (Status)) {
+    return (EFI_STATUS)Status;
+  }
+
+  *NeededSize = CalculatedSize;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Internal helper to validate a single variable list entry in place and describe it
+  with pointers into the input buffer.
+
+  @param[in]      VariableListBuffer    Pointer to buffer containing target variable list.
+  @param[in,out]  Size                  On input, it indicates the size of input buffer. On output,
+                                        it indicates the buffer consumed by this variable list.
+                                        Also updated on EFI_BUFFER_TOO_SMALL returns when the
+                                        header could be read.
+  @param[in]      VerifyCrc             Whether to verify the CRC32 of this variable list. Only to be
+                                        skipped for buffers that were already validated.
+  @param[out]     EntryView             Pointer to view of the validated entry.
+
+  @retval EFI_INVALID_PARAMETER   One or more input arguments are null.
+  @retval EFI_BUFFER_TOO_SMALL    The input buffer does not contain a full variable list.
+  @retval EFI_COMPROMISED_DATA    The input variable list buffer has a corrupted CRC.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+ValidateVariableListInPlace (
+  IN      CONST VOID              *VariableListBuffer,
+  IN  OUT UINTN                   *Size,
+  IN      BOOLEAN                 VerifyCrc,
+  OUT CONFIG_VAR_LIST_ENTRY_VIEW  *EntryView
+  )
+{
+  CONST EFI_GUID             *Guid;
+  CONST CHAR16               *NameInBin;
+  CONST CHAR8                *DataInBin;
+  CONST CONFIG_VAR_LIST_HDR  *VarList = NULL;
+  UINTN                      BinSize  = 0;
+  EFI_STATUS                 Status   = EFI_SUCCESS;
+  UINT32                     Attributes;
+  UINT32                     CRC32;
+  UINT32                     CalcCRC32;
+  UINT32                     NeededSize = 0;
+
+  // Sanity check for input parameters
+  if ((VariableListBuffer == NULL) || (Size == NULL) || (EntryView == NULL)) {
+    Status = EFI_INVALID_PARAMETER;
+    goto Exit;
+  }
+
+  if (*Size < sizeof (*VarList)) {
+    Status = EFI_BUFFER_TOO_SMALL;
+    goto Exit;
+  }
+
+  // index into variable list
+  BinSize = *Size;
+  VarList = (CONST CONFIG_VAR_LIST_HDR *)((CHAR8 *)VariableListBuffer);
+  Status  = GetVarListSize (VarList->NameSize, VarList->DataSize, &NeededSize);
+
+  if (EFI_ERROR (Status)) {
+    // we overflowed
+    DEBUG ((
+      DEBUG_ERROR,
+      "%a VarList size overflowed, too large of config! NameSize: 0x%x DataSize: 0x%x\n",
+      __FUNCTION__,
+      VarList->NameSize,
+      VarList->DataSize
+      ));
+    goto Exit;
+  }
+
+  if ((UINTN)NeededSize > BinSize) {
+    // the NameSize and DataInBinSize have bad values and are pushing us past the end of the binary
+    DEBUG ((DEBUG_ERROR, "%a VarList buffer does not have needed size (actual: %x, expected: %x)\n", __FUNCTION__, BinSize, NeededSize));
+    *Size  = (UINTN)NeededSize;
+    Status = EFI_BUFFER_TOO_SMALL;
+    goto Exit;
+  }
+
+  // Use this as stub to indicate how much buffer used.
+  *Size = (UINTN)NeededSize;
+
+  /*
+    * Var List is in DmpStore format:
+    *
+    *  struct {
+    *    CONFIG_VAR_LIST_HDR VarList;
+    *    CHAR16 Name[VarList->NameSize/2];
+    *    EFI_GUID Guid;
+    *    UINT32 Attributes;
+    *    CHAR8 DataInBin[VarList-DataSize];
+    *    UINT32 CRC32; // CRC32 of all bytes from VarList to end of DataInBin
+    *  }
+    */
+  NameInBin = (CONST CHAR16 *)(VarList + 1);
+  Guid      = (CONST EFI_GUID *)((CHAR8 *)NameInBin + VarList->NameSize);
+  CopyMem (&Attributes, (Guid + 1), sizeof (UINT32));
+  DataInBin = (CONST CHAR8 *)Guid + sizeof (*Guid) + sizeof (Attributes);
+  CopyMem (&CRC32, (DataInBin + VarList->DataSize), sizeof (UINT32));
+
+  // validate CRC32
+  if (VerifyCrc) {
+    CalcCRC32 = ConfigCalculateCrc32 (VarList, NeededSize - sizeof (CRC32));
+    if (CRC32 != CalcCRC32) {
+      DEBUG ((DEBUG_ERROR, "%a CRC is off in the variable list: actual: %x, expect %x\n", __FUNCTION__, CRC32, CalcCRC32));
+      Status = EFI_COMPROMISED_DATA;
+      goto Exit;
+    }
+  }
+
+  EntryView->Name       = NameInBin;
+  EntryView->NameSize   = VarList->NameSize;
+  EntryView->Guid       = Guid;
+  EntryView->Attributes = Attributes;
+  EntryView->Data       = DataInBin;
+  EntryView->DataSize   = VarList->DataSize;
+  EntryView->Raw        = VarList;
+  EntryView->RawSize    = NeededSize;
+
+  ConfigPerfCounterAdd (ConfigPerfCounterEntriesParsed, 1);
+  Status = EFI_SUCCESS;
+
+Exit:
+  return Status;
+}
+
+/**
+  Initialize an iterator to walk the variable list entries of a raw packed or aligned variable list buffer
+  without allocating or copying any of the entries. The header and CRC32 of an aligned buffer are checked here.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer. Must remain valid
+                                      for as long as the iterator is in use.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[out] Iterator                Pointer to iterator to be initialized.
+
+  @retval EFI_INVALID_PARAMETER   Iterator is null, VariableListBuffer is null with a non-zero size, or the
+                                  aligned buffer is not aligned to CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT.
+  @retval EFI_UNSUPPORTED         The aligned variable list buffer has an unknown version, or the buffer is a
+                                  compressed variable list, to be read with ConfigVarListStreamNext.
+  @retval EFI_COMPROMISED_DATA    The aligned variable list header or CRC32 is corrupted.
+  @retval EFI_SUCCESS             The iterator is initialized.
+
+**/
+EFI_STATUS
+EFIAPI
+ConfigVarListIterInit (
+  IN  CONST VOID                *VariableListBuffer,
+  IN  UINTN                     VariableListBufferSize,
+  OUT CONFIG_VAR_LIST_ITERATOR  *Iterator
+  )
+{
+  EFI_STATUS              Status;
+  CONFIG_VAR_LIST_WALKER  Walker;
+
+  if ((Iterator == NULL) || ((VariableListBuffer == NULL) && (VariableListBufferSize != 0))) {
+    DEBUG ((DEBUG_ERROR, "%a Invalid parameter passed\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ZeroMem (Iterator, sizeof (*Iterator));
+  if (VariableListBuffer == NULL) {
+    return EFI_SUCCESS;
+  }
+
+  Status = ConfigVarListWalkInit (&Walker, VariableListBuffer, VariableListBufferSize, TRUE);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a Variable list buffer %p can't be iterated - %r\n", __FUNCTION__, VariableListBuffer, Status));
+    return Status;
+  }
+
+  Iterator->Buffer     = (CONST UINT8 *)VariableListBuffer;
+  Iterator->BufferSize = VariableListBufferSize;
+  Iterator->AlignedHdr = Walker.AlignedHdr;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Validate the next variable list entry in place and return a view into the original buffer.
+  The iterator only advances when the entry is valid.
+
+  @param[in,out]  Iterator    Pointer to iterator initialized by ConfigVarListIterInit.
+  @param[out]     EntryView   Pointer to view of the next entry. Upon successful return, the
+                              pointers in this view reference the iterated buffer.
+
+  @retval EFI_INVALID_PARAMETER   One or more input arguments are null.
+  @retval EFI_NOT_FOUND           There are no more entries in the buffer.
+  @retval EFI_BUFFER_TOO_SMALL    The remaining buffer does not contain a full variable list.
+  @retval EFI_COMPROMISED_DATA    The next variable list entry has a corrupted CRC, or does not fit the regions
+                                  of an aligned variable list.
+  @retval EFI_SUCCESS             EntryView describes the next entry.
+
+**/
+EFI_STATUS
+EFIAPI
+ConfigVarListIterNext (
+  IN OUT CONFIG_VAR_LIST_ITERATOR    *Iterator,
+  OUT    CONFIG_VAR_LIST_ENTRY_VIEW  *EntryView
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       LeftSize;
+
+  if ((Iterator == NULL) || (EntryView == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a Null parameter passed\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Iterator->AlignedHdr != NULL) {
+    // The CRC32 of the whole aligned buffer was checked by ConfigVarListIterInit
+    if (Iterator->Index >= Iterator->AlignedHdr->EntryCount) {
+      return EFI_NOT_FOUND;
+    }
+
+    Status = GetAlignedConfigVarListEntry (Iterator->AlignedHdr, Iterator->Index, EntryView);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Iterator->Index++;
+    return EFI_SUCCESS;
+  }
+
+  if ((Iterator->Buffer == NULL) || (Iterator->Offset >= Iterator->BufferSize)) {
+    return EFI_NOT_FOUND;
+  }
+
+  LeftSize = Iterator->BufferSize - Iterator->Offset;
+  Status   = ValidateVariableListInPlace (Iterator->Buffer + Iterator->Offset, &LeftSize, TRUE, EntryView);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a Variable list at offset 0x%x is invalid - %r\n", __FUNCTION__, Iterator->Offset, Status));
+    return Status;
+  }
+
+  Iterator->Offset += LeftSize;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Helper function to convert variable entry to variable list.
+
+  @param[in]      VariableEntry         Pointer to variable entry to be converted.
+  @param[out]     VariableListBuffer    Pointer to buffer holding returned variable list.
+  @param[in,out]  Size                  On input, it indicates the size of input buffer. On output,
+                                        it indicates the buffer needed for converting from
+                                        VariableEntry. Updated on successful conversion and EFI_BUFFER_TOO_SMALL
+                                        returns.
+
+  @retval EFI_INVALID_PARAMETER   One or more input arguments are null.
+  @retval EFI_OUT_OF_RESOURCES    Memory allocation failed.
+  @retval EFI_BUFFER_TOO_SMALL    The input buffer does not contain a full variable list.
+  @retval EFI_COMPROMISED_DATA    The input variable list buffer has a corrupted CRC.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+ConvertVariableEntryToVariableList (
+  IN  CONST CONFIG_VAR_LIST_ENTRY  *VariableEntry,
+  OUT VOID                         *VariableListBuffer,
+  IN OUT UINTN                     *Size
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      NameSize;
+  UINT32      NeededSize;
+  UINTN       Offset;
+  UINT32      Crc32;
+
+  // Sanity check for input parameters
+  if ((Size == NULL) || (VariableEntry == NULL) || ((VariableListBuffer == NULL) && (*Size != 0))) {
+    Status = EFI_INVALID_PARAMETER;
+    goto Exit;
+  }
+
+  // Sanity check 2 for input parameters
+  if ((VariableEntry->Name == NULL) || (VariableEntry->Data == NULL)) {
+    Status = EFI_INVALID_PARAMETER;
+    goto Exit;
+  }
+
+  NameSize = (UINT32)StrnSizeS (VariableEntry->Name, CONF_VAR_NAME_LEN);
+  Status   = GetVarListSize (NameSize, VariableEntry->DataSize, &NeededSize);
+
+  if (EFI_ERROR (Status)) {
+    // overflowed...
+    DEBUG ((DEBUG_ERROR, "%a VarList size overflowed, too large of config!\n", __FUNCTION__));
+    goto Exit;
+  }
+
+  if (*Size < (UINTN)NeededSize) {
+    Status = EFI_BUFFER_TOO_SMALL;
+    *Size  = (UINTN)NeededSize;
+    goto Exit;
+  }
+
+  Offset = 0;
+  // Header
+  ((CONFIG_VAR_LIST_HDR *)VariableListBuffer)->NameSize = (UINT32)NameSize;
+  ((CONFIG_VAR_LIST_HDR *)VariableListBuffer)->DataSize = (UINT32)VariableEntry->DataSize;
+  Offset                                               += sizeof (CONFIG_VAR_LIST_HDR);
+
+  // Name
+  CopyMem ((UINT8 *)(VariableListBuffer) + Offset, VariableEntry->Name, NameSize);
+  Offset += NameSize;
+
+  // Guid
+  CopyMem ((UINT8 *)(VariableListBuffer) + Offset, &VariableEntry->Guid, sizeof (VariableEntry->Guid));
+  Offset += sizeof (VariableEntry->Guid);
+
+  // Attributes
+  CopyMem ((UINT8 *)(VariableListBuffer) + Offset, &VariableEntry->Attributes, sizeof (VariableEntry->Attributes));
+  Offset += sizeof (VariableEntry->Attributes);
+
+  // Data
+  CopyMem ((UINT8 *)(VariableListBuffer) + Offset, VariableEntry->Data, VariableEntry->DataSize);
+  Offset += VariableEntry->DataSize;
+
+  // CRC32
+  Crc32 = ConfigCalculateCrc32 (VariableListBuffer, Offset);
+  CopyMem ((UINT8 *)(VariableListBuffer) + Offset, &Crc32, sizeof (UINT32));
+  Offset += sizeof (UINT32);
+
+  *Size = (UINTN)NeededSize;
+
+  // They should still match in size...
+  if (Offset != (UINTN)NeededSize) {
+    ASSERT (Offset == (UINTN)NeededSize);
+    Status = EFI_COMPROMISED_DATA;
+    goto Exit;
+  }
+
+  Status = EFI_SUCCESS;
+
+Exit:
+  return Status;
+}
+
+/**
+  Internal helper to check whether a variable list buffer is in the aligned variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+
+  @retval TRUE    The buffer starts with an aligned variable list header.
+  @retval FALSE   The buffer is to be parsed as packed variable list entries.
+**/
+BOOLEAN
+IsAlignedConfigVarList (
+  IN  CONST VOID  *VariableListBuffer,
+  IN  UINTN       VariableListBufferSize
+  )
+{
+  // A packed entry would need a NameSize as large as the signature, which never fits a real buffer
+  return (BOOLEAN)((VariableListBufferSize >= sizeof (CONFIG_VAR_LIST_ALIGNED_HDR)) &&
+                   (ReadUnaligned32 ((CONST UINT32 *)VariableListBuffer) == CONFIG_VAR_LIST_ALIGNED_SIGNATURE));
+}
+
+/**
+  Internal helper to validate the header, region bounds and CRC32 of an aligned variable list buffer.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer, starting with a
+                                      CONFIG_VAR_LIST_ALIGNED_HDR.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]  VerifyCrc               Whether to verify the CRC32 in the header. Only to be
+                                      skipped for buffers that were already validated.
+
+  @retval EFI_INVALID_PARAMETER   The buffer is not aligned to CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT.
+  @retval EFI_UNSUPPORTED         The header has an unknown version.
+  @retval EFI_COMPROMISED_DATA    The regions do not fit the buffer or the CRC32 does not match.
+  @retval EFI_SUCCESS             The buffer is a valid aligned variable list.
+
+**/
+EFI_STATUS
+ValidateAlignedConfigVarList (
+  IN  CONST VOID  *VariableListBuffer,
+  IN  UINTN       VariableListBufferSize,
+  IN  BOOLEAN     VerifyCrc
+  )
+{
+  CONST CONFIG_VAR_LIST_ALIGNED_HDR  *Hdr;
+  RETURN_STATUS                      Status;
+  UINT32                             EntriesEnd;
+  UINT32                             NamesEnd;
+  UINT32                             DataEnd;
+  UINT32                             CalcCRC32;
+
+  if (((UINTN)VariableListBuffer & (CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT - 1)) != 0) {
+    DEBUG ((DEBUG_ERROR, "%a Aligned variable list buffer %p is not aligned\n", __FUNCTION__, VariableListBuffer));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Hdr = (CONST CONFIG_VAR_LIST_ALIGNED_HDR *)VariableListBuffer;
+  if (Hdr->Version != CONFIG_VAR_LIST_ALIGNED_VERSION) {
+    DEBUG ((DEBUG_ERROR, "%a Unsupported aligned variable list version %u\n", __FUNCTION__, Hdr->Version));
+    return EFI_UNSUPPORTED;
+  }
+
+  if ((Hdr->HeaderSize < sizeof (*Hdr)) || ((Hdr->HeaderSize % CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT) != 0)) {
+    DEBUG ((DEBUG_ERROR, "%a Bad aligned variable list header size 0x%x\n", __FUNCTION__, Hdr->HeaderSize));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  // The descriptors, names and data follow each other in that order and the data ends the buffer
+  Status = SafeUint32Mult (Hdr->EntryCount, sizeof (CONFIG_VAR_LIST_ALIGNED_ENTRY), &EntriesEnd);
+  if (!RETURN_ERROR (Status)) {
+    Status = SafeUint32Add (EntriesEnd, Hdr->HeaderSize, &EntriesEnd);
+  }
+
+  if (!RETURN_ERROR (Status)) {
+    Status = SafeUint32Add (Hdr->NamesOffset, Hdr->NamesSize, &NamesEnd);
+  }
+
+  if (!RETURN_ERROR (Status)) {
+    Status = SafeUint32Add (Hdr->DataOffset, Hdr->DataSize, &DataEnd);
+  }
+
+  if (RETURN_ERROR (Status) ||
+      (EntriesEnd > Hdr->NamesOffset) ||
+      (NamesEnd > Hdr->DataOffset) ||
+      ((UINTN)DataEnd != VariableListBufferSize) ||
+      ((Hdr->NamesOffset % sizeof (CHAR16)) != 0) ||
+      ((Hdr->DataOffset % CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT) != 0))
+  {
+    DEBUG ((DEBUG_ERROR, "%a Aligned variable list regions do not fit buffer size 0x%x\n", __FUNCTION__, VariableListBufferSize));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  if (VerifyCrc) {
+    CalcCRC32 = ConfigCalculateCrc32 ((CONST UINT8 *)VariableListBuffer + Hdr->HeaderSize, VariableListBufferSize - Hdr->HeaderSize);
+    if (CalcCRC32 != Hdr->Crc32) {
+      DEBUG ((DEBUG_ERROR, "%a CRC is off in the aligned variable list: actual: %x, expect %x\n", __FUNCTION__, Hdr->Crc32, CalcCRC32));
+      return EFI_COMPROMISED_DATA;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Internal helper to describe one entry of a validated aligned variable list with pointers into the buffer.
+
+  @param[in]  Hdr         Pointer to the header of an aligned variable list validated by ValidateAlignedConfigVarList.
+  @param[in]  EntryIndex  Index of the entry, must be less than Hdr->EntryCount.
+  @param[out] EntryView   Pointer to view of the entry.
+
+  @retval EFI_COMPROMISED_DATA    The entry name or data does not fit its region.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+GetAlignedConfigVarListEntry (
+  IN  CONST CONFIG_VAR_LIST_ALIGNED_HDR  *Hdr,
+  IN  UINTN                              EntryIndex,
+  OUT CONFIG_VAR_LIST_ENTRY_VIEW         *EntryView
+  )
+{
+  CONST CONFIG_VAR_LIST_ALIGNED_ENTRY  *Entry;
+  CONST CHAR16                         *NameInBin;
+
+  Entry = (CONST CONFIG_VAR_LIST_ALIGNED_ENTRY *)((CONST UINT8 *)Hdr + Hdr->HeaderSize) + EntryIndex;
+
+  if ((Entry->NameSize < sizeof (CHAR16)) ||
+      ((Entry->NameSize % sizeof (CHAR16)) != 0) ||
+      ((Entry->NameOffset % sizeof (CHAR16)) != 0) ||
+      (Entry->NameOffset > Hdr->NamesSize) ||
+      (Entry->NameSize > Hdr->NamesSize - Entry->NameOffset) ||
+      ((Entry->DataOffset % CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT) != 0) ||
+      (Entry->DataOffset > Hdr->DataSize) ||
+      (Entry->DataSize > Hdr->DataSize - Entry->DataOffset))
+  {
+    DEBUG ((DEBUG_ERROR, "%a Aligned variable list entry %u does not fit its regions\n", __FUNCTION__, EntryIndex));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  NameInBin = (CONST CHAR16 *)((CONST UINT8 *)Hdr + Hdr->NamesOffset + Entry->NameOffset);
+  if (NameInBin[Entry->NameSize / sizeof (CHAR16) - 1] != L'\0') {
+    DEBUG ((DEBUG_ERROR, "%a Aligned variable list entry %u has an unterminated name\n", __FUNCTION__, EntryIndex));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  EntryView->Name       = NameInBin;
+  EntryView->NameSize   = Entry->NameSize;
+  EntryView->Guid       = &Entry->Guid;
+  EntryView->Attributes = Entry->Attributes;
+  EntryView->Data       = (CONST UINT8 *)Hdr + Hdr->DataOffset + Entry->DataOffset;
+  EntryView->DataSize   = Entry->DataSize;
+  EntryView->Raw        = Entry;
+  EntryView->RawSize    = sizeof (*Entry);
+
+  ConfigPerfCounterAdd (ConfigPerfCounterEntriesParsed, 1);
+  return EFI_SUCCESS;
+}
+
+/**
+  Internal helper to start walking the entries of a packed or aligned variable list buffer.
+
+  @param[out] Walker                  Pointer to walker to be initialized.
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer. Must remain valid
+                                      for as long as the walker is in use.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]  VerifyCrc               Whether to verify the CRC32 of the variable list. Only to be
+                                      skipped for buffers that were already validated.
+
+  @retval EFI_INVALID_PARAMETER   The aligned buffer is not aligned to CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT.
+  @retval EFI_UNSUPPORTED         The aligned variable list buffer has an unknown version, or the buffer is a
+                                  compressed variable list.
+  @retval EFI_COMPROMISED_DATA    The aligned variable list header is corrupted.
+  @retval EFI_SUCCESS             The walker is initialized.
+
+**/
+EFI_STATUS
+ConfigVarListWalkInit (
+  OUT CONFIG_VAR_LIST_WALKER  *Walker,
+  IN  CONST VOID              *VariableListBuffer,
+  IN  UINTN                   VariableListBufferSize,
+  IN  BOOLEAN                 VerifyCrc
+  )
+{
+  EFI_STATUS  Status;
+
+  ZeroMem (Walker, sizeof (*Walker));
+  Walker->Buffer     = (CONST UINT8 *)VariableListBuffer;
+  Walker->BufferSize = VariableListBufferSize;
+  Walker->VerifyCrc  = VerifyCrc;
+
+  if (IsCompressedConfigVarList (VariableListBuffer, VariableListBufferSize)) {
+    // Compressed entries have no place in the buffer to point to, they are read with ConfigVarListStreamNext
+    DEBUG ((DEBUG_ERROR, "%a Compressed variable list buffer %p can't be walked in place\n", __FUNCTION__, VariableListBuffer));
+    return EFI_UNSUPPORTED;
+  }
+
+  if (IsAlignedConfigVarList (VariableListBuffer, VariableListBufferSize)) {
+    // The aligned format carries one CRC32 for all entries, so it is checked here
+    Status = ValidateAlignedConfigVarList (VariableListBuffer, VariableListBufferSize, VerifyCrc);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Walker->AlignedHdr = (CONST CONFIG_VAR_LIST_ALIGNED_HDR *)VariableListBuffer;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Internal helper to validate the next entry of a walked variable list and describe it
+  with pointers into the walked buffer.
+
+  @param[in,out]  Walker      Pointer to walker initialized by ConfigVarListWalkInit.
+  @param[out]     EntryView   Pointer to view of the next entry.
+
+  @retval EFI_NOT_FOUND           There are no more entries in the buffer.
+  @retval EFI_BUFFER_TOO_SMALL    The remaining buffer does not contain a full variable list.
+  @retval EFI_COMPROMISED_DATA    The next entry is corrupted.
+  @retval EFI_SUCCESS             EntryView describes the next entry.
+
+**/
+EFI_STATUS
+ConfigVarListWalkNext (
+  IN OUT CONFIG_VAR_LIST_WALKER      *Walker,
+  OUT    CONFIG_VAR_LIST_ENTRY_VIEW  *EntryView
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       LeftSize;
+
+  if (Walker->AlignedHdr != NULL) {
+    if (Walker->Index >= Walker->AlignedHdr->EntryCount) {
+      return EFI_NOT_FOUND;
+    }
+
+    Status = GetAlignedConfigVarListEntry (Walker->AlignedHdr, Walker->Index, EntryView);
+    if (!EFI_ERROR (Status)) {
+      Walker->Index++;
+    }
+
+    return Status;
+  }
+
+  if (Walker->Offset >= Walker->BufferSize) {
+    return EFI_NOT_FOUND;
+  }
+
+  LeftSize = Walker->BufferSize - Walker->Offset;
+  Status   = ValidateVariableListInPlace (Walker->Buffer + Walker->Offset, &LeftSize, Walker->VerifyCrc, EntryView);
+  if (!EFI_ERROR (Status)) {
+    Walker->Offset += LeftSize;
+  }
+
+  return Status;
+}
+
+/**
+  Internal helper to compare the name of a variable list entry view with a variable name, given either as unicode
+  or ascii, without converting either of them.
+
+  @param[in]  EntryView   Pointer to view of a validated variable list entry.
+  @param[in]  UniName     NULL terminated unicode variable name, NULL if AsciiName is used.
+  @param[in]  AsciiName   NULL terminated ascii variable name, NULL if UniName is used.
+  @param[in]  NameSize    Size in bytes of the UTF-16LE form of the name, including null terminator.
+
+  @retval TRUE    The entry has this name.
+  @retval FALSE   The entry has another name.
+**/
+STATIC
+BOOLEAN
+ConfigVarListEntryNameMatch (
+  IN  CONST CONFIG_VAR_LIST_ENTRY_VIEW  *EntryView,
+  IN  CONST CHAR16                      *UniName,
+  IN  CONST CHAR8                       *AsciiName,
+  IN  UINTN                             NameSize
+  )
+{
+  CONST UINT8  *NameInBin;
+  UINTN        CharIndex;
+
+  if (EntryView->NameSize != NameSize) {
+    return FALSE;
+  }
+
+  NameInBin = (CONST UINT8 *)EntryView->Name;
+  if (UniName != NULL) {
+    return (BOOLEAN)(CompareMem (NameInBin, UniName, NameSize) == 0);
+  }
+
+  for (CharIndex = 0; CharIndex < NameSize / sizeof (CHAR16); CharIndex++) {
+    if ((NameInBin[CharIndex * 2] != (UINT8)AsciiName[CharIndex]) || (NameInBin[CharIndex * 2 + 1] != 0)) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Internal helper to find a variable list entry by name, given either as unicode or ascii, and namespace.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]  UniName                 NULL terminated unicode variable name, NULL if AsciiName is used.
+  @param[in]  AsciiName               NULL terminated ascii variable name, NULL if UniName is used.
+  @param[in]  VarGuid                 Namespace GUID of the variable of interest, or NULL to match any.
+  @param[out] EntryView               Pointer to view of the entry, pointing into VariableListBuffer.
+
+  @retval EFI_INVALID_PARAMETER   The aligned buffer is not aligned to CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT.
+  @retval EFI_NOT_FOUND           The requested variable is not found in VariableListBuffer.
+  @retval EFI_BUFFER_TOO_SMALL    The buffer does not contain a full variable list.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains data that does not fit within the structure defined.
+  @retval EFI_UNSUPPORTED         The aligned variable list buffer has an unknown version.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+STATIC
+EFI_STATUS
+FindConfigVarListView (
+  IN  CONST VOID                  *VariableListBuffer,
+  IN  UINTN                       VariableListBufferSize,
+  IN  CONST CHAR16                *UniName,
+  IN  CONST CHAR8                 *AsciiName,
+  IN  CONST EFI_GUID              *VarGuid OPTIONAL,
+  OUT CONFIG_VAR_LIST_ENTRY_VIEW  *EntryView
+  )
+{
+  CONFIG_VAR_LIST_WALKER  Walker;
+  EFI_STATUS              Status;
+  UINTN                   NameSize;
+
+  if ((VariableListBuffer == NULL) || (VariableListBufferSize == 0)) {
+    DEBUG ((DEBUG_ERROR, "%a Incoming variable list buffer (base: %p, size: 0x%x) invalid\n", __FUNCTION__, VariableListBuffer, VariableListBufferSize));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (UniName != NULL) {
+    NameSize = StrnSizeS (UniName, CONF_VAR_NAME_LEN);
+  } else {
+    NameSize = AsciiStrnSizeS (AsciiName, CONF_VAR_NAME_LEN) * sizeof (CHAR16);
+  }
+
+  // Entries before the match are validated as they are walked, the ones after it are never touched
+  Status = ConfigVarListWalkInit (&Walker, VariableListBuffer, VariableListBufferSize, TRUE);
+  while (!EFI_ERROR (Status)) {
+    Status = ConfigVarListWalkNext (&Walker, EntryView);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    if (ConfigVarListEntryNameMatch (EntryView, UniName, AsciiName, NameSize) &&
+        ((VarGuid == NULL) || CompareGuid (VarGuid, EntryView->Guid)))
+    {
+      return EFI_SUCCESS;
+    }
+  }
+
+  if (Status != EFI_NOT_FOUND) {
+    DEBUG ((DEBUG_ERROR, "%a Variable list buffer is invalid - %r\n", __FUNCTION__, Status));
+  }
+
+  return Status;
+}
+
+/**
+  Find specified configuration variable in a raw variable list buffer and return a view into that buffer,
+  without allocating or copying the entry.
+
+  The buffer may be in either the packed or the aligned variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]  VarName                 NULL terminated unicode variable name of interest.
+  @param[in]  VarGuid                 Namespace GUID of the variable of interest. If NULL, the first entry
+                                      in the buffer with a matching name is returned.
+  @param[out] EntryView               Pointer to view of the entry, pointing into VariableListBuffer.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null, or the aligned buffer is not aligned.
+  @retval EFI_NOT_FOUND           The requested variable is not found in VariableListBuffer.
+  @retval EFI_BUFFER_TOO_SMALL    The buffer does not contain a full variable list.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains data that does not fit within the structure defined.
+  @retval EFI_UNSUPPORTED         The aligned variable list buffer has an unknown version, or the buffer is a
+                                  compressed variable list, to be read with ConfigVarListStreamNext.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+QueryConfigVarListViewUnicode (
+  IN  CONST VOID                  *VariableListBuffer,
+  IN  UINTN                       VariableListBufferSize,
+  IN  CONST CHAR16                *VarName,
+  IN  CONST EFI_GUID              *VarGuid OPTIONAL,
+  OUT CONFIG_VAR_LIST_ENTRY_VIEW  *EntryView
+  )
+{
+  if ((VarName == NULL) || (EntryView == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a Null parameter passed\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return FindConfigVarListView (VariableListBuffer, VariableListBufferSize, VarName, NULL, VarGuid, EntryView);
+}
+
+/**
+  Find specified configuration variable in a raw variable list buffer and return a view into that buffer,
+  without allocating or copying the entry.
+
+  The buffer may be in either the packed or the aligned variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]  VarName                 NULL terminated ascii variable name of interest.
+  @param[in]  VarGuid                 Namespace GUID of the variable of interest. If NULL, the first entry
+                                      in the buffer with a matching name is returned.
+  @param[out] EntryView               Pointer to view of the entry, pointing into VariableListBuffer.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null, or the aligned buffer is not aligned.
+  @retval EFI_NOT_FOUND           The requested variable is not found in VariableListBuffer.
+  @retval EFI_BUFFER_TOO_SMALL    The buffer does not contain a full variable list.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains data that does not fit within the structure defined.
+  @retval EFI_UNSUPPORTED         The aligned variable list buffer has an unknown version, or the buffer is a
+                                  compressed variable list, to be read with ConfigVarListStreamNext.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+QueryConfigVarListViewAscii (
+  IN  CONST VOID                  *VariableListBuffer,
+  IN  UINTN                       VariableListBufferSize,
+  IN  CONST CHAR8                 *VarName,
+  IN  CONST EFI_GUID              *VarGuid OPTIONAL,
+  OUT CONFIG_VAR_LIST_ENTRY_VIEW  *EntryView
+  )
+{
+  if ((VarName == NULL) || (EntryView == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a Null parameter passed\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return FindConfigVarListView (VariableListBuffer, VariableListBufferSize, NULL, VarName, VarGuid, EntryView);
+}
+
+/**
+  Internal helper to hash a variable name as stored in the variable list, i.e. UTF-16LE bytes
+  including the null terminator, with FNV-1a.
+
+  @param[in]  Name      Pointer to the name bytes, does not need to be aligned.
+  @param[in]  NameSize  Size of the name in bytes.
+
+  @return The hash of the name.
+**/
+STATIC
+UINT32
+HashConfigVarName (
+  IN CONST UINT8  *Name,
+  IN UINTN        NameSize
+  )
+{
+  UINT32  Hash = CONFIG_VAR_LIST_HASH_SEED;
+  UINTN   Index;
+
+  for (Index = 0; Index < NameSize; Index++) {
+    Hash = (Hash ^ Name[Index]) * CONFIG_VAR_LIST_HASH_PRIME;
+  }
+
+  return Hash;
+}
+
+/**
+  Internal helper to hash an ascii variable name as if it were converted to its UTF-16LE form,
+  so that it matches HashConfigVarName without a conversion buffer.
+
+  @param[in]  Name      NULL terminated ascii name.
+  @param[out] NameSize  Size in bytes of the UTF-16LE form of the name, including null terminator.
+
+  @return The hash of the name.
+**/
+STATIC
+UINT32
+HashConfigVarAsciiName (
+  IN  CONST CHAR8  *Name,
+  OUT UINTN        *NameSize
+  )
+{
+  UINT32  Hash = CONFIG_VAR_LIST_HASH_SEED;
+  UINTN   Index;
+
+  Index = 0;
+  do {
+    Hash = (Hash ^ (UINT8)Name[Index]) * CONFIG_VAR_LIST_HASH_PRIME;
+    // High byte of the UTF-16LE character is always 0
+    Hash = Hash * CONFIG_VAR_LIST_HASH_PRIME;
+  } while (Name[Index++] != '\0');
+
+  *NameSize = Index * sizeof (CHAR16);
+  return Hash;
+}
+
+/**
+  Validate all entries of a raw packed or aligned variable list buffer and index them into caller provided slots.
+
+  @param[in]      VariableListBuffer      Pointer to raw variable list buffer. Must remain valid
+                                          and unchanged for as long as the index is in use.
+  @param[in]      VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]      Slots                   Array of *SlotCount slots, may be NULL to only get the slot count.
+  @param[in,out]  SlotCount               On input, the number of slots in Slots, a power of 2. On output,
+                                          the number of slots needed to index the buffer.
+  @param[in]      VerifyCrc               Whether to verify the CRC32 of each entry. Only to be skipped for
+                                          buffers that were already validated.
+  @param[out]     Index                   Pointer to the index to initialize, may be NULL if Slots is NULL.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null, VariableListBufferSize is 0 or *SlotCount is not a
+                                  power of 2.
+  @retval EFI_OUT_OF_RESOURCES    Slots is NULL or too small, *SlotCount holds the slot count needed.
+  @retval EFI_BAD_BUFFER_SIZE     VariableListBufferSize is too large to be indexed.
+  @retval EFI_BUFFER_TOO_SMALL    The buffer does not end with a full variable list.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains an entry with a corrupted CRC.
+  @retval EFI_SUCCESS             The index is initialized.
+
+**/
+EFI_STATUS
+InitConfigVarListIndexInternal (
+  IN      CONST VOID                  *VariableListBuffer,
+  IN      UINTN                       VariableListBufferSize,
+  IN      CONFIG_VAR_LIST_INDEX_SLOT  *Slots OPTIONAL,
+  IN OUT  UINTN                       *SlotCount,
+  IN      BOOLEAN                     VerifyCrc,
+  OUT     CONFIG_VAR_LIST_INDEX       *Index OPTIONAL
+  )
+{
+  EFI_STATUS                  Status;
+  CONFIG_VAR_LIST_WALKER      Walker;
+  CONFIG_VAR_LIST_ENTRY_VIEW  Entry;
+  UINTN                       EntryCount;
+  UINTN                       NeededCount;
+  UINTN                       Slot;
+  UINTN                       Offset;
+  UINT32                      Hash;
+
+  if ((VariableListBuffer == NULL) || (VariableListBufferSize == 0) || (SlotCount == NULL) ||
+      ((Slots != NULL) && ((Index == NULL) || (*SlotCount == 0) || ((*SlotCount & (*SlotCount - 1)) != 0))))
+  {
+    DEBUG ((DEBUG_ERROR, "%a Invalid parameter passed\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  // Offsets are kept as biased UINT32 values in the slots
+  if (VariableListBufferSize >= MAX_UINT32) {
+    DEBUG ((DEBUG_ERROR, "%a Variable list buffer too large to index: 0x%x\n", __FUNCTION__, VariableListBufferSize));
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  if (Slots != NULL) {
+    ZeroMem (Slots, *SlotCount * sizeof (CONFIG_VAR_LIST_INDEX_SLOT));
+  }
+
+  Status = ConfigVarListWalkInit (&Walker, VariableListBuffer, VariableListBufferSize, VerifyCrc);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to validate variable list buffer - %r\n", __FUNCTION__, Status));
+    return Status;
+  }
+
+  // Single pass validates and counts every entry, inserting them as long as the slots stay at most half full.
+  // Slots locate a packed entry by its offset in the buffer and an aligned one by its index
+  EntryCount = 0;
+  while (TRUE) {
+    Offset = (Walker.AlignedHdr != NULL) ? Walker.Index : Walker.Offset;
+    Status = ConfigVarListWalkNext (&Walker, &Entry);
+    if (Status == EFI_NOT_FOUND) {
+      break;
+    } else if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a Failed to validate variable list buffer - %r\n", __FUNCTION__, Status));
+      return Status;
+    }
+
+    EntryCount++;
+    if ((Slots != NULL) && (EntryCount * 2 <= *SlotCount)) {
+      Hash = HashConfigVarName ((CONST UINT8 *)Entry.Name, Entry.NameSize);
+      Slot = Hash & (*SlotCount - 1);
+      while (Slots[Slot].Offset != 0) {
+        Slot = (Slot + 1) & (*SlotCount - 1);
+      }
+
+      Slots[Slot].Hash   = Hash;
+      Slots[Slot].Offset = (UINT32)Offset + 1;
+    }
+  }
+
+  // Keep the table at most half full so probe sequences stay short
+  NeededCount = CONFIG_VAR_LIST_INDEX_MIN_SLOTS;
+  while (NeededCount < EntryCount * 2) {
+    NeededCount *= 2;
+  }
+
+  if ((Slots == NULL) || (*SlotCount < NeededCount)) {
+    *SlotCount = NeededCount;
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Index->Buffer     = (CONST UINT8 *)VariableListBuffer;
+  Index->BufferSize = VariableListBufferSize;
+  Index->EntryCount = EntryCount;
+  Index->SlotCount  = *SlotCount;
+  Index->Slots      = Slots;
+  Index->AlignedHdr = Walker.AlignedHdr;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Validate all entries of a raw packed or aligned variable list buffer once and build a hash index of them into caller
+  provided slots, without allocating. The index is queried as one created by BuildConfigVarListIndex, but must
+  not be freed with FreeConfigVarListIndex.
+
+  @param[in]      VariableListBuffer      Pointer to raw variable list buffer. Must remain valid
+                                          and unchanged for as long as the index is in use.
+  @param[in]      VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]      Slots                   Array of *SlotCount slots, may be NULL to only get the slot count.
+                                          Must remain valid for as long as the index is in use.
+  @param[in,out]  SlotCount               On input, the number of slots in Slots, a power of 2. On output,
+                                          the number of slots needed to index the buffer.
+  @param[out]     Index                   Pointer to the index to initialize.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null, VariableListBufferSize is 0 or *SlotCount is not a
+                                  power of 2.
+  @retval EFI_OUT_OF_RESOURCES    Slots is NULL or too small, *SlotCount holds the slot count needed.
+  @retval EFI_BAD_BUFFER_SIZE     VariableListBufferSize is too large to be indexed.
+  @retval EFI_BUFFER_TOO_SMALL    The buffer does not end with a full variable list.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains an entry with a corrupted CRC.
+  @retval EFI_SUCCESS             The index is initialized.
+
+**/
+EFI_STATUS
+EFIAPI
+InitConfigVarListIndex (
+  IN      CONST VOID                  *VariableListBuffer,
+  IN      UINTN                       VariableListBufferSize,
+  IN      CONFIG_VAR_LIST_INDEX_SLOT  *Slots OPTIONAL,
+  IN OUT  UINTN                       *SlotCount,
+  OUT     CONFIG_VAR_LIST_INDEX       *Index
+  )
+{
+  if (Index == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a Null parameter passed\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return InitConfigVarListIndexInternal (VariableListBuffer, VariableListBufferSize, Slots, SlotCount, TRUE, Index);
+}
+
+/**
+  Internal helper to probe an index for a variable name, given either as unicode or ascii.
+
+  @param[in]  Index       Pointer to index of the variable list buffer.
+  @param[in]  UniName     NULL terminated unicode variable name, NULL if AsciiName is used.
+  @param[in]  AsciiName   NULL terminated ascii variable name, NULL if UniName is used.
+  @param[in]  VarGuid     Namespace GUID of the variable of interest, or NULL to match any.
+  @param[out] EntryView   Pointer to view of the entry, pointing into the indexed buffer.
+
+  @retval EFI_NOT_FOUND           The requested variable is not found in the index.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+STATIC
+EFI_STATUS
+LookupConfigVarListIndex (
+  IN  CONST CONFIG_VAR_LIST_INDEX  *Index,
+  IN  CONST CHAR16                 *UniName,
+  IN  CONST CHAR8                  *AsciiName,
+  IN  CONST EFI_GUID               *VarGuid OPTIONAL,
+  OUT CONFIG_VAR_LIST_ENTRY_VIEW   *EntryView
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       NameSize;
+  UINTN       LeftSize;
+  UINTN       Slot;
+  UINTN       Probes;
+  UINT32      Hash;
+
+  if (UniName != NULL) {
+    NameSize = StrnSizeS (UniName, CONF_VAR_NAME_LEN);
+    Hash     = HashConfigVarName ((CONST UINT8 *)UniName, NameSize);
+  } else {
+    Hash = HashConfigVarAsciiName (AsciiName, &NameSize);
+  }
+
+  Slot = Hash & (Index->SlotCount - 1);
+  for (Probes = 0; Probes < Index->SlotCount; Probes++) {
+    if (Index->Slots[Slot].Offset == 0) {
+      // Hit an empty slot, the name is not in the table
+      break;
+    }
+
+    if (Index->Slots[Slot].Hash == Hash) {
+      if (Index->AlignedHdr != NULL) {
+        Status = GetAlignedConfigVarListEntry (Index->AlignedHdr, Index->Slots[Slot].Offset - 1, EntryView);
+      } else {
+        LeftSize = Index->BufferSize - (Index->Slots[Slot].Offset - 1);
+        Status   = ValidateVariableListInPlace (Index->Buffer + Index->Slots[Slot].Offset - 1, &LeftSize, FALSE, EntryView);
+      }
+
+      if (!EFI_ERROR (Status) &&
+          ConfigVarListEntryNameMatch (EntryView, UniName, AsciiName, NameSize) &&
+          ((VarGuid == NULL) || CompareGuid (VarGuid, EntryView->Guid)))
+      {
+        return EFI_SUCCESS;
+      }
+    }
+
+    Slot = (Slot + 1) & (Index->SlotCount - 1);
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Find specified configuration variable through an index built by BuildConfigVarListIndex or
+  InitConfigVarListIndex.
+
+  @param[in]  Index       Pointer to index of the variable list buffer.
+  @param[in]  VarName     NULL terminated unicode variable name of interest.
+  @param[in]  VarGuid     Namespace GUID of the variable of interest. If NULL, the first entry
+                          in the buffer with a matching name is returned.
+  @param[out] EntryView   Pointer to view of the entry, pointing into the indexed buffer.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null.
+  @retval EFI_NOT_FOUND           The requested variable is not found in the index.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+QueryConfigVarListIndexUnicode (
+  IN  CONST CONFIG_VAR_LIST_INDEX  *Index,
+  IN  CONST CHAR16                 *VarName,
+  IN  CONST EFI_GUID               *VarGuid OPTIONAL,
+  OUT CONFIG_VAR_LIST_ENTRY_VIEW   *EntryView
+  )
+{
+  if ((Index == NULL) || (VarName == NULL) || (EntryView == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a Null parameter passed\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return LookupConfigVarListIndex (Index, VarName, NULL, VarGuid, EntryView);
+}
+
+/**
+  Find specified configuration variable through an index built by BuildConfigVarListIndex or
+  InitConfigVarListIndex.
+
+  @param[in]  Index       Pointer to index of the variable list buffer.
+  @param[in]  VarName     NULL terminated ascii variable name of interest.
+  @param[in]  VarGuid     Namespace GUID of the variable of interest. If NULL, the first entry
+                          in the buffer with a matching name is returned.
+  @param[out] EntryView   Pointer to view of the entry, pointing into the indexed buffer.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null.
+  @retval EFI_NOT_FOUND           The requested variable is not found in the index.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+EFIAPI
+QueryConfigVarListIndexAscii (
+  IN  CONST CONFIG_VAR_LIST_INDEX  *Index,
+  IN  CONST CHAR8                  *VarName,
+  IN  CONST EFI_GUID               *VarGuid OPTIONAL,
+  OUT CONFIG_VAR_LIST_ENTRY_VIEW   *EntryView
+  )
+{
+  if ((Index == NULL) || (VarName == NULL) || (EntryView == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a Null parameter passed\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return LookupConfigVarListIndex (Index, NULL, VarName, VarGuid, EntryView);
+}
@@ -0,0 +1,183 @@
+/** @file
+  Internal interface shared by the ConfigVariableListLib instances, to validate and walk variable list buffers in
+  place without allocating.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef CONFIG_VARIABLE_LIST_LIB_COMMON_H_
+#define CONFIG_VARIABLE_LIST_LIB_COMMON_H_
+
+//
+// Walks the entries of either variable list format, without copying them.
+//
+typedef struct {
+  CONST CONFIG_VAR_LIST_ALIGNED_HDR  *AlignedHdr; // NULL for a packed variable list
+  CONST UINT8                        *Buffer;
+  UINTN                              BufferSize;
+  UINTN                              Offset; // Next packed entry
+  UINTN                              Index;  // Next aligned entry
+  BOOLEAN                            VerifyCrc;
+} CONFIG_VAR_LIST_WALKER;
+
+/**
+  Internal helper to validate a single variable list entry in place and describe it
+  with pointers into the input buffer.
+
+  @param[in]      VariableListBuffer    Pointer to buffer containing target variable list.
+  @param[in,out]  Size                  On input, it indicates the size of input buffer. On output,
+                                        it indicates the buffer consumed by this variable list.
+                                        Also updated on EFI_BUFFER_TOO_SMALL returns when the
+                                        header could be read.
+  @param[in]      VerifyCrc             Whether to verify the CRC32 of this variable list. Only to be
+                                        skipped for buffers that were already validated.
+  @param[out]     EntryView             Pointer to view of the validated entry.
+
+  @retval EFI_INVALID_PARAMETER   One or more input arguments are null.
+  @retval EFI_BUFFER_TOO_SMALL    The input buffer does not contain a full variable list.
+  @retval EFI_COMPROMISED_DATA    The input variable list buffer has a corrupted CRC.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+ValidateVariableListInPlace (
+  IN      CONST VOID              *VariableListBuffer,
+  IN  OUT UINTN                   *Size,
+  IN      BOOLEAN                 VerifyCrc,
+  OUT CONFIG_VAR_LIST_ENTRY_VIEW  *EntryView
+  );
+
+/**
+  Internal helper to check whether a variable list buffer is in the aligned variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+
+  @retval TRUE    The buffer starts with an aligned variable list header.
+  @retval FALSE   The buffer is to be parsed as packed variable list entries.
+**/
+BOOLEAN
+IsAlignedConfigVarList (
+  IN  CONST VOID  *VariableListBuffer,
+  IN  UINTN       VariableListBufferSize
+  );
+
+/**
+  Internal helper to validate the header, region bounds and CRC32 of an aligned variable list buffer.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer, starting with a
+                                      CONFIG_VAR_LIST_ALIGNED_HDR.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]  VerifyCrc               Whether to verify the CRC32 in the header. Only to be
+                                      skipped for buffers that were already validated.
+
+  @retval EFI_INVALID_PARAMETER   The buffer is not aligned to CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT.
+  @retval EFI_UNSUPPORTED         The header has an unknown version.
+  @retval EFI_COMPROMISED_DATA    The regions do not fit the buffer or the CRC32 does not match.
+  @retval EFI_SUCCESS             The buffer is a valid aligned variable list.
+
+**/
+EFI_STATUS
+ValidateAlignedConfigVarList (
+  IN  CONST VOID  *VariableListBuffer,
+  IN  UINTN       VariableListBufferSize,
+  IN  BOOLEAN     VerifyCrc
+  );
+
+/**
+  Internal helper to describe one entry of a validated aligned variable list with pointers into the buffer.
+
+  @param[in]  Hdr         Pointer to the header of an aligned variable list validated by ValidateAlignedConfigVarList.
+  @param[in]  EntryIndex  Index of the entry, must be less than Hdr->EntryCount.
+  @param[out] EntryView   Pointer to view of the entry.
+
+  @retval EFI_COMPROMISED_DATA    The entry name or data does not fit its region.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+EFI_STATUS
+GetAlignedConfigVarListEntry (
+  IN  CONST CONFIG_VAR_LIST_ALIGNED_HDR  *Hdr,
+  IN  UINTN                              EntryIndex,
+  OUT CONFIG_VAR_LIST_ENTRY_VIEW         *EntryView
+  );
+
+/**
+  Internal helper to start walking the entries of a packed or aligned variable list buffer.
+
+  @param[out] Walker                  Pointer to walker to be initialized.
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer. Must remain valid
+                                      for as long as the walker is in use.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]  VerifyCrc               Whether to verify the CRC32 of the variable list. Only to be
+                                      skipped for buffers that were already validated.
+
+  @retval EFI_INVALID_PARAMETER   The aligned buffer is not aligned to CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT.
+  @retval EFI_UNSUPPORTED         The aligned variable list buffer has an unknown version, or the buffer is a
+                                  compressed variable list.
+  @retval EFI_COMPROMISED_DATA    The aligned variable list header is corrupted.
+  @retval EFI_SUCCESS             The walker is initialized.
+
+**/
+EFI_STATUS
+ConfigVarListWalkInit (
+  OUT CONFIG_VAR_LIST_WALKER  *Walker,
+  IN  CONST VOID              *VariableListBuffer,
+  IN  UINTN                   VariableListBufferSize,
+  IN  BOOLEAN                 VerifyCrc
+  );
+
+/**
+  Internal helper to validate the next entry of a walked variable list and describe it
+  with pointers into the walked buffer.
+
+  @param[in,out]  Walker      Pointer to walker initialized by ConfigVarListWalkInit.
+  @param[out]     EntryView   Pointer to view of the next entry.
+
+  @retval EFI_NOT_FOUND           There are no more entries in the buffer.
+  @retval EFI_BUFFER_TOO_SMALL    The remaining buffer does not contain a full variable list.
+  @retval EFI_COMPROMISED_DATA    The next entry is corrupted.
+  @retval EFI_SUCCESS             EntryView describes the next entry.
+
+**/
+EFI_STATUS
+ConfigVarListWalkNext (
+  IN OUT CONFIG_VAR_LIST_WALKER      *Walker,
+  OUT    CONFIG_VAR_LIST_ENTRY_VIEW  *EntryView
+  );
+
+/**
+  Validate all entries of a raw packed or aligned variable list buffer and index them into caller provided slots.
+
+  @param[in]      VariableListBuffer      Pointer to raw variable list buffer. Must remain valid
+                                          and unchanged for as long as the index is in use.
+  @param[in]      VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]      Slots                   Array of *SlotCount slots, may be NULL to only get the slot count.
+  @param[in,out]  SlotCount               On input, the number of slots in Slots, a power of 2. On output,
+                                          the number of slots needed to index the buffer.
+  @param[in]      VerifyCrc               Whether to verify the CRC32 of each entry. Only to be skipped for
+                                          buffers that were already validated.
+  @param[out]     Index                   Pointer to the index to initialize, may be NULL if Slots is NULL.
+
+  @retval EFI_INVALID_PARAMETER   Input argument is null, VariableListBufferSize is 0 or *SlotCount is not a
+                                  power of 2.
+  @retval EFI_OUT_OF_RESOURCES    Slots is NULL or too small, *SlotCount holds the slot count needed.
+  @retval EFI_BAD_BUFFER_SIZE     VariableListBufferSize is too large to be indexed.
+  @retval EFI_BUFFER_TOO_SMALL    The buffer does not end with a full variable list.
+  @retval EFI_COMPROMISED_DATA    The variable list buffer contains an entry with a corrupted CRC.
+  @retval EFI_SUCCESS             The index is initialized.
+
+**/
+EFI_STATUS
+InitConfigVarListIndexInternal (
+  IN      CONST VOID                  *VariableListBuffer,
+  IN      UINTN                       VariableListBufferSize,
+  IN      CONFIG_VAR_LIST_INDEX_SLOT  *Slots OPTIONAL,
+  IN OUT  UINTN                       *SlotCount,
+  IN      BOOLEAN                     VerifyCrc,
+  OUT     CONFIG_VAR_LIST_INDEX       *Index OPTIONAL
+  );
+
+#endif // CONFIG_VARIABLE_LIST_LIB_COMMON_H_
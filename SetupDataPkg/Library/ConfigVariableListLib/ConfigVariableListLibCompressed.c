@@ -0,0 +1,417 @@
+/** @file
+  Allocation free functionality shared by the ConfigVariableListLib instances, to stream the entries of compressed
+  variable list buffers one at a time.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/ConfigVariableListLib.h>
+#include <Library/SafeIntLib.h>
+#include <Library/ConfigCrcLib.h>
+#include "ConfigVariableListLibCommon.h"
+
+// Largest encoding of a 32 bit varint
+#define CONFIG_VAR_LIST_VARINT_MAX_BYTES  5
+
+/**
+  Internal helper to decode an unsigned LEB128 varint of up to 32 bits.
+
+  @param[in]      Buffer      Pointer to the buffer holding the varint.
+  @param[in]      BufferSize  Size of Buffer.
+  @param[in,out]  Offset      On input, the offset of the varint in Buffer. On output, the offset following it.
+                              Only updated on success.
+  @param[out]     Value       The decoded value.
+
+  @retval EFI_COMPROMISED_DATA    The varint does not fit the buffer or 32 bits.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+STATIC
+EFI_STATUS
+ReadConfigVarListVarint (
+  IN      CONST UINT8  *Buffer,
+  IN      UINTN        BufferSize,
+  IN OUT  UINTN        *Offset,
+  OUT     UINT32       *Value
+  )
+{
+  UINTN   Index;
+  UINTN   Position;
+  UINT64  Result;
+  UINT8   Byte;
+
+  Result   = 0;
+  Position = *Offset;
+  for (Index = 0; (Index < CONFIG_VAR_LIST_VARINT_MAX_BYTES) && (Position < BufferSize); Index++) {
+    Byte    = Buffer[Position++];
+    Result |= LShiftU64 (Byte & 0x7F, Index * 7);
+    if ((Byte & 0x80) == 0) {
+      if (Result > MAX_UINT32) {
+        break;
+      }
+
+      *Offset = Position;
+      *Value  = (UINT32)Result;
+      return EFI_SUCCESS;
+    }
+  }
+
+  DEBUG ((DEBUG_ERROR, "%a Bad varint at offset 0x%x\n", __FUNCTION__, *Offset));
+  return EFI_COMPROMISED_DATA;
+}
+
+/**
+  Internal helper to decompress a LZ block of a compressed variable list.
+
+  @param[in]      Buffer      Pointer to the compressed variable list buffer.
+  @param[in]      BufferSize  Size of Buffer.
+  @param[in,out]  Offset      On input, the offset of the block in Buffer. On output, the offset following it.
+                              Only updated on success.
+  @param[out]     Output      Pointer to OutputSize bytes receiving the decompressed block.
+  @param[in]      OutputSize  Size in bytes of the decompressed block.
+
+  @retval EFI_COMPROMISED_DATA    The block does not fit the buffer, or does not decompress to OutputSize bytes.
+  @retval EFI_SUCCESS             The operation succeeds.
+
+**/
+STATIC
+EFI_STATUS
+DecompressConfigVarListBlock (
+  IN      CONST UINT8  *Buffer,
+  IN      UINTN        BufferSize,
+  IN OUT  UINTN        *Offset,
+  OUT     UINT8        *Output,
+  IN      UINTN        OutputSize
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Position;
+  UINTN       Produced;
+  UINTN       Length;
+  UINTN       Index;
+  UINT32      Distance;
+  UINT8       Token;
+
+  Position = *Offset;
+  Produced = 0;
+  while (Produced < OutputSize) {
+    if (Position >= BufferSize) {
+      DEBUG ((DEBUG_ERROR, "%a LZ block at offset 0x%x does not fit the buffer\n", __FUNCTION__, *Offset));
+      return EFI_COMPROMISED_DATA;
+    }
+
+    Token = Buffer[Position++];
+    if (Token < CONFIG_VAR_LIST_LZ_MATCH_FLAG) {
+      Length = (UINTN)Token + 1;
+      if ((Length > BufferSize - Position) || (Length > OutputSize - Produced)) {
+        DEBUG ((DEBUG_ERROR, "%a LZ literals at offset 0x%x do not fit the block\n", __FUNCTION__, Position - 1));
+        return EFI_COMPROMISED_DATA;
+      }
+
+      CopyMem (Output + Produced, Buffer + Position, Length);
+      Position += Length;
+      Produced += Length;
+      continue;
+    }
+
+    Length = (UINTN)(Token & ~CONFIG_VAR_LIST_LZ_MATCH_FLAG) + CONFIG_VAR_LIST_LZ_MIN_MATCH;
+    Status = ReadConfigVarListVarint (Buffer, BufferSize, &Position, &Distance);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if ((Distance == 0) || (Distance > Produced) || (Length > OutputSize - Produced)) {
+      DEBUG ((DEBUG_ERROR, "%a LZ match at offset 0x%x does not fit the block\n", __FUNCTION__, Position));
+      return EFI_COMPROMISED_DATA;
+    }
+
+    // The match may overlap the bytes it produces, e.g. for a run of zeros, so copy a byte at a time
+    for (Index = 0; Index < Length; Index++) {
+      Output[Produced + Index] = Output[Produced + Index - Distance];
+    }
+
+    Produced += Length;
+  }
+
+  *Offset = Position;
+  return EFI_SUCCESS;
+}
+
+/**
+  Check whether a raw variable list buffer is in the compressed variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+
+  @retval TRUE    The buffer starts with a compressed variable list header.
+  @retval FALSE   The buffer is in the packed or aligned variable list format.
+**/
+BOOLEAN
+EFIAPI
+IsCompressedConfigVarList (
+  IN  CONST VOID  *VariableListBuffer,
+  IN  UINTN       VariableListBufferSize
+  )
+{
+  // As for the aligned format, a packed entry would need a NameSize as large as the signature
+  return (BOOLEAN)((VariableListBuffer != NULL) &&
+                   (VariableListBufferSize >= sizeof (CONFIG_VAR_LIST_COMPRESSED_HDR)) &&
+                   (ReadUnaligned32 ((CONST UINT32 *)VariableListBuffer) == CONFIG_VAR_LIST_COMPRESSED_SIGNATURE));
+}
+
+/**
+  Initialize a stream to walk the entries of a compressed variable list buffer, decompressing one entry at a time
+  into caller provided scratch memory, so that the whole list is never expanded.
+
+  The CRC32 of the buffer, which covers the header, and the header are checked here before the scratch size is
+  returned, so that a corrupted header cannot size the scratch memory. The dictionary is then decompressed into the
+  scratch memory.
+
+  @param[in]      VariableListBuffer      Pointer to raw compressed variable list buffer. Must remain valid for as
+                                          long as the stream is in use.
+  @param[in]      VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]      Scratch                 Scratch memory used by the stream, may be NULL to query its size. Must
+                                          remain valid for as long as the stream is in use.
+  @param[in,out]  ScratchSize             On input, the size of Scratch. On output, the size of scratch memory
+                                          the stream needs. Updated on EFI_SUCCESS and EFI_BUFFER_TOO_SMALL returns.
+  @param[out]     Stream                  Pointer to stream to be initialized.
+
+  @retval EFI_INVALID_PARAMETER   One or more input arguments are null.
+  @retval EFI_UNSUPPORTED         The buffer is not a compressed variable list, or has an unknown version.
+  @retval EFI_BUFFER_TOO_SMALL    Scratch is too small, ScratchSize is updated with the size needed.
+  @retval EFI_COMPROMISED_DATA    The header, dictionary or CRC32 of the buffer is corrupted, or the header sizes
+                                  exceed the packed size of the list.
+  @retval EFI_SUCCESS             The stream is initialized.
+
+**/
+EFI_STATUS
+EFIAPI
+ConfigVarListStreamInit (
+  IN      CONST VOID              *VariableListBuffer,
+  IN      UINTN                   VariableListBufferSize,
+  IN      VOID                    *Scratch OPTIONAL,
+  IN OUT  UINTN                   *ScratchSize,
+  OUT     CONFIG_VAR_LIST_STREAM  *Stream
+  )
+{
+  CONFIG_VAR_LIST_COMPRESSED_HDR  Hdr;
+  EFI_STATUS                      Status;
+  UINTN                           NeededSize;
+  UINTN                           Offset;
+  UINT32                          GuidsSize;
+  UINT32                          CalcCRC32;
+  UINT32                          ExpectCRC32;
+
+  if ((VariableListBuffer == NULL) || (ScratchSize == NULL) || (Stream == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a Null parameter passed\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (!IsCompressedConfigVarList (VariableListBuffer, VariableListBufferSize)) {
+    DEBUG ((DEBUG_ERROR, "%a Buffer %p is not a compressed variable list\n", __FUNCTION__, VariableListBuffer));
+    return EFI_UNSUPPORTED;
+  }
+
+  // The buffer may come from anywhere, e.g. a decoded settings packet, so the header is not read in place
+  CopyMem (&Hdr, VariableListBuffer, sizeof (Hdr));
+  if (Hdr.Version != CONFIG_VAR_LIST_COMPRESSED_VERSION) {
+    DEBUG ((DEBUG_ERROR, "%a Unsupported compressed variable list version %u\n", __FUNCTION__, Hdr.Version));
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = SafeUint32Mult (Hdr.GuidCount, sizeof (EFI_GUID), &GuidsSize);
+  if (!EFI_ERROR (Status)) {
+    Status = SafeUintnAdd (Hdr.MaxEntrySize, Hdr.DictionarySize, &NeededSize);
+  }
+
+  // The CRC32 covers the header with its Crc32 field zeroed, then the rest of the buffer
+  ExpectCRC32 = Hdr.Crc32;
+  Hdr.Crc32   = 0;
+  CalcCRC32   = ConfigUpdateCrc32 (0, &Hdr, sizeof (Hdr));
+  CalcCRC32   = ConfigUpdateCrc32 (CalcCRC32, (CONST UINT8 *)VariableListBuffer + sizeof (Hdr), VariableListBufferSize - sizeof (Hdr));
+  if (CalcCRC32 != ExpectCRC32) {
+    DEBUG ((DEBUG_ERROR, "%a CRC is off in the compressed variable list: actual: %x, expect %x\n", __FUNCTION__, ExpectCRC32, CalcCRC32));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  // Neither the dictionary nor an entry can be larger than all entries expanded, which bounds the scratch memory by
+  // the allocation the allocating calls make for the whole list
+  if (EFI_ERROR (Status) ||
+      (Hdr.HeaderSize < sizeof (Hdr)) ||
+      (Hdr.HeaderSize > VariableListBufferSize) ||
+      (GuidsSize > Hdr.DictionarySize) ||
+      (Hdr.DictionarySize > Hdr.PackedSize) ||
+      (Hdr.MaxEntrySize > Hdr.PackedSize))
+  {
+    DEBUG ((DEBUG_ERROR, "%a Compressed variable list header does not fit buffer size 0x%x\n", __FUNCTION__, VariableListBufferSize));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  if ((Scratch == NULL) || (*ScratchSize < NeededSize)) {
+    *ScratchSize = NeededSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  // Entries are decompressed at the start of the scratch memory, the dictionary lives right after them
+  Offset = Hdr.HeaderSize;
+  Status = DecompressConfigVarListBlock (
+             VariableListBuffer,
+             VariableListBufferSize,
+             &Offset,
+             (UINT8 *)Scratch + Hdr.MaxEntrySize,
+             Hdr.DictionarySize
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to decompress the dictionary - %r\n", __FUNCTION__, Status));
+    return Status;
+  }
+
+  Stream->Buffer         = (CONST UINT8 *)VariableListBuffer;
+  Stream->BufferSize     = VariableListBufferSize;
+  Stream->Offset         = Offset;
+  Stream->Index          = 0;
+  Stream->EntryCount     = Hdr.EntryCount;
+  Stream->GuidCount      = Hdr.GuidCount;
+  Stream->Dictionary     = (CONST UINT8 *)Scratch + Hdr.MaxEntrySize;
+  Stream->DictionarySize = Hdr.DictionarySize;
+  Stream->Entry          = (UINT8 *)Scratch;
+  Stream->MaxEntrySize   = Hdr.MaxEntrySize;
+  Stream->PackedSize     = Hdr.PackedSize;
+
+  *ScratchSize = NeededSize;
+  return EFI_SUCCESS;
+}
+
+/**
+  Decompress the next entry of a compressed variable list into the scratch memory of the stream and return a view
+  of it. The entry is rebuilt in the packed variable list format, with its CRC32, so Raw and RawSize describe a
+  packed entry. The stream only advances when the entry is valid.
+
+  @param[in,out]  Stream      Pointer to stream initialized by ConfigVarListStreamInit.
+  @param[out]     EntryView   Pointer to view of the next entry. Upon successful return, the pointers in this view
+                              reference the scratch memory of the stream, and are only valid until the next call.
+
+  @retval EFI_INVALID_PARAMETER   One or more input arguments are null.
+  @retval EFI_NOT_FOUND           There are no more entries in the buffer.
+  @retval EFI_COMPROMISED_DATA    The next entry record is corrupted.
+  @retval EFI_SUCCESS             EntryView describes the next entry.
+
+**/
+EFI_STATUS
+EFIAPI
+ConfigVarListStreamNext (
+  IN OUT CONFIG_VAR_LIST_STREAM      *Stream,
+  OUT    CONFIG_VAR_LIST_ENTRY_VIEW  *EntryView
+  )
+{
+  EFI_STATUS   Status;
+  UINTN        Offset;
+  UINTN        NamesSize;
+  UINTN        EntrySize;
+  UINT32       GuidIndex;
+  UINT32       NameOffset;
+  UINT32       NameSize;
+  UINT32       Attributes;
+  UINT32       DataSize;
+  UINT32       NeededSize;
+  CONST UINT8  *Name;
+  UINT8        *Data;
+
+  if ((Stream == NULL) || (EntryView == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a Null parameter passed\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((Stream->Buffer == NULL) || (Stream->Index >= Stream->EntryCount)) {
+    if ((Stream->Buffer != NULL) && (Stream->Offset != Stream->BufferSize)) {
+      DEBUG ((DEBUG_ERROR, "%a Compressed variable list has 0x%x trailing bytes\n", __FUNCTION__, Stream->BufferSize - Stream->Offset));
+      return EFI_COMPROMISED_DATA;
+    }
+
+    return EFI_NOT_FOUND;
+  }
+
+  Offset = Stream->Offset;
+  Status = ReadConfigVarListVarint (Stream->Buffer, Stream->BufferSize, &Offset, &GuidIndex);
+  if (!EFI_ERROR (Status)) {
+    Status = ReadConfigVarListVarint (Stream->Buffer, Stream->BufferSize, &Offset, &NameOffset);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = ReadConfigVarListVarint (Stream->Buffer, Stream->BufferSize, &Offset, &NameSize);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = ReadConfigVarListVarint (Stream->Buffer, Stream->BufferSize, &Offset, &Attributes);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = ReadConfigVarListVarint (Stream->Buffer, Stream->BufferSize, &Offset, &DataSize);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = GetVarListSize (NameSize, DataSize, &NeededSize);
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a Compressed variable list entry %u has a bad record - %r\n", __FUNCTION__, Stream->Index, Status));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  // The names follow the guids in the dictionary, and every name is null terminated
+  NamesSize = Stream->DictionarySize - Stream->GuidCount * sizeof (EFI_GUID);
+  if ((GuidIndex >= Stream->GuidCount) ||
+      (NameSize < sizeof (CHAR16)) ||
+      ((NameSize % sizeof (CHAR16)) != 0) ||
+      (NameOffset > NamesSize) ||
+      (NameSize > NamesSize - NameOffset) ||
+      ((UINTN)NeededSize > Stream->MaxEntrySize))
+  {
+    DEBUG ((DEBUG_ERROR, "%a Compressed variable list entry %u does not fit its dictionary\n", __FUNCTION__, Stream->Index));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  Name = Stream->Dictionary + Stream->GuidCount * sizeof (EFI_GUID) + NameOffset;
+  if (ReadUnaligned16 ((CONST UINT16 *)(Name + NameSize - sizeof (CHAR16))) != L'\0') {
+    DEBUG ((DEBUG_ERROR, "%a Compressed variable list entry %u has an unterminated name\n", __FUNCTION__, Stream->Index));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  // Rebuild the packed entry, see CONFIG_VAR_LIST_HDR
+  EntrySize = NeededSize;
+  WriteUnaligned32 ((UINT32 *)Stream->Entry, NameSize);
+  WriteUnaligned32 ((UINT32 *)(Stream->Entry + sizeof (UINT32)), DataSize);
+  CopyMem (Stream->Entry + sizeof (CONFIG_VAR_LIST_HDR), Name, NameSize);
+  CopyMem (
+    Stream->Entry + sizeof (CONFIG_VAR_LIST_HDR) + NameSize,
+    Stream->Dictionary + GuidIndex * sizeof (EFI_GUID),
+    sizeof (EFI_GUID)
+    );
+  WriteUnaligned32 ((UINT32 *)(Stream->Entry + sizeof (CONFIG_VAR_LIST_HDR) + NameSize + sizeof (EFI_GUID)), Attributes);
+
+  Data   = Stream->Entry + EntrySize - sizeof (UINT32) - DataSize;
+  Status = DecompressConfigVarListBlock (Stream->Buffer, Stream->BufferSize, &Offset, Data, DataSize);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a Failed to decompress entry %u - %r\n", __FUNCTION__, Stream->Index, Status));
+    return Status;
+  }
+
+  WriteUnaligned32 ((UINT32 *)(Data + DataSize), ConfigCalculateCrc32 (Stream->Entry, EntrySize - sizeof (UINT32)));
+
+  // The buffer CRC32 was checked by ConfigVarListStreamInit, and the entry CRC32 was just computed
+  Status = ValidateVariableListInPlace (Stream->Entry, &EntrySize, FALSE, EntryView);
+  if (EFI_ERROR (Status)) {
+    ASSERT_EFI_ERROR (Status);
+    return Status;
+  }
+
+  Stream->Offset = Offset;
+  Stream->Index++;
+
+  return EFI_SUCCESS;
+}
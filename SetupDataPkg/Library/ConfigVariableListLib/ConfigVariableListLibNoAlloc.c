@@ -0,0 +1,260 @@
+/** @file
+  Allocation free instance of the library interface to process the list of configuration variables, for modules
+  without a usable heap, e.g. SEC and pre-memory PEI modules.
+
+  Only the functions working in place over caller provided buffers are implemented, by the common code shared with
+  ConfigVariableListLib. Use ConfigVarListIterNext, ConfigVarListStreamNext, QueryConfigVarListView* or
+  InitConfigVarListIndex in place of the functions below, which would allocate and return EFI_UNSUPPORTED here.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+#include <Uefi.h>
+#include <Library/DebugLib.h>
+#include <Library/ConfigVariableListLib.h>
+
+/**
+  Expand a compressed variable list buffer into a newly allocated buffer holding the same entries in the packed
+  variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw compressed variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[out] PackedBuffer            Pointer to the packed variable list, to be freed by the caller with FreePool.
+  @param[out] PackedBufferSize        Size of PackedBuffer.
+
+  @retval EFI_UNSUPPORTED         This library instance does not allocate.
+
+**/
+EFI_STATUS
+EFIAPI
+RetrieveDecompressedConfigVarList (
+  IN  CONST VOID  *VariableListBuffer,
+  IN  UINTN       VariableListBufferSize,
+  OUT VOID        **PackedBuffer,
+  OUT UINTN       *PackedBufferSize
+  )
+{
+  DEBUG ((DEBUG_ERROR, "%a is not supported without memory allocation\n", __FUNCTION__));
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Helper function to convert variable list to variable entry.
+
+  @param[in]      VariableListBuffer    Pointer to buffer containing target variable list.
+  @param[in,out]  Size                  On input, it indicates the size of input buffer. On output,
+                                        it indicates the buffer consumed after converting to
+                                        VariableEntry.
+  @param[out]     VariableEntry         Pointer to converted variable entry. Upon successful return,
+                                        callers are responsible for freeing the Name and Data fields.
+
+  @retval EFI_UNSUPPORTED         This library instance does not allocate.
+
+**/
+EFI_STATUS
+EFIAPI
+ConvertVariableListToVariableEntry (
+  IN      CONST VOID         *VariableListBuffer,
+  IN  OUT UINTN              *Size,
+  OUT CONFIG_VAR_LIST_ENTRY  *VariableEntry
+  )
+{
+  DEBUG ((DEBUG_ERROR, "%a is not supported without memory allocation\n", __FUNCTION__));
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Find all active configuration variables for this platform.
+
+  The buffer may be in either the packed or the aligned variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[out] ConfigVarListPtr        Pointer to configuration data. User is responsible to free the
+                                      returned buffer and the Data, Name fields for each entry.
+  @param[out] ConfigVarListCount      Number of variable list entries.
+
+  @retval EFI_UNSUPPORTED         This library instance does not allocate.
+
+**/
+EFI_STATUS
+EFIAPI
+RetrieveActiveConfigVarList (
+  IN  CONST VOID             *VariableListBuffer,
+  IN  UINTN                  VariableListBufferSize,
+  OUT CONFIG_VAR_LIST_ENTRY  **ConfigVarListPtr,
+  OUT UINTN                  *ConfigVarListCount
+  )
+{
+  DEBUG ((DEBUG_ERROR, "%a is not supported without memory allocation\n", __FUNCTION__));
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Find all active configuration variables for this platform, from a buffer whose producer
+  provides the CRC32 of the whole buffer, e.g. the generated default profile. The buffer is
+  checked against that CRC32 once, instead of checking the CRC32 of each entry.
+
+  The buffer may be in either the packed or the aligned variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]  BlobCrc32               CRC32 of all VariableListBufferSize bytes of VariableListBuffer.
+  @param[out] ConfigVarListPtr        Pointer to configuration data. User is responsible to free the
+                                      returned buffer and the Data, Name fields for each entry.
+  @param[out] ConfigVarListCount      Number of variable list entries.
+
+  @retval EFI_UNSUPPORTED         This library instance does not allocate.
+
+**/
+EFI_STATUS
+EFIAPI
+RetrieveActiveConfigVarListWithBlobCrc (
+  IN  CONST VOID             *VariableListBuffer,
+  IN  UINTN                  VariableListBufferSize,
+  IN  UINT32                 BlobCrc32,
+  OUT CONFIG_VAR_LIST_ENTRY  **ConfigVarListPtr,
+  OUT UINTN                  *ConfigVarListCount
+  )
+{
+  DEBUG ((DEBUG_ERROR, "%a is not supported without memory allocation\n", __FUNCTION__));
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Find all active configuration variables for this platform, returned in a single allocation.
+
+  The buffer is walked once to validate and size all entries, then the entry array and all
+  of its names and data are copied into one pool allocation. Each entry data is aligned to
+  8 bytes. The buffer may be in either the packed or the aligned variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[out] ConfigVarListPtr        Pointer to configuration data. User is responsible to free the
+                                      returned buffer with FreeConfigVarList only, the Name and Data
+                                      fields of the entries must not be freed separately.
+  @param[out] ConfigVarListCount      Number of variable list entries.
+
+  @retval EFI_UNSUPPORTED         This library instance does not allocate.
+
+**/
+EFI_STATUS
+EFIAPI
+RetrieveActiveConfigVarListSingleAllocation (
+  IN  CONST VOID             *VariableListBuffer,
+  IN  UINTN                  VariableListBufferSize,
+  OUT CONFIG_VAR_LIST_ENTRY  **ConfigVarListPtr,
+  OUT UINTN                  *ConfigVarListCount
+  )
+{
+  DEBUG ((DEBUG_ERROR, "%a is not supported without memory allocation\n", __FUNCTION__));
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Free a variable list returned by RetrieveActiveConfigVarListSingleAllocation.
+
+  @param[in]  ConfigVarList   Pointer to the variable list, may be NULL.
+
+**/
+VOID
+EFIAPI
+FreeConfigVarList (
+  IN CONFIG_VAR_LIST_ENTRY  *ConfigVarList
+  )
+{
+  ASSERT (ConfigVarList == NULL);
+}
+
+/**
+  Find specified active configuration variable for this platform.
+
+  The buffer may be in either the packed or the aligned variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]  VarListName             NULL terminated unicode variable name of interest.
+  @param[out] ConfigVarListPtr        Pointer to hold variable list entry from VariableListBuffer.
+
+  @retval EFI_UNSUPPORTED         This library instance does not allocate.
+
+**/
+EFI_STATUS
+EFIAPI
+QuerySingleActiveConfigUnicodeVarList (
+  IN  VOID                   *VariableListBuffer,
+  IN  UINTN                  VariableListBufferSize,
+  IN  CONST CHAR16           *VarName,
+  OUT CONFIG_VAR_LIST_ENTRY  *ConfigVarListPtr
+  )
+{
+  DEBUG ((DEBUG_ERROR, "%a is not supported without memory allocation\n", __FUNCTION__));
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Find specified active configuration variable for this platform.
+
+  The buffer may be in either the packed or the aligned variable list format.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[in]  VarListName             NULL terminated ascii variable name of interest.
+  @param[out] ConfigVarListPtr        Pointer to hold variable list entry from VariableListBuffer.
+
+  @retval EFI_UNSUPPORTED         This library instance does not allocate.
+
+**/
+EFI_STATUS
+EFIAPI
+QuerySingleActiveConfigAsciiVarList (
+  IN  VOID                   *VariableListBuffer,
+  IN  UINTN                  VariableListBufferSize,
+  IN  CONST CHAR8            *VarName,
+  OUT CONFIG_VAR_LIST_ENTRY  *ConfigVarListPtr
+  )
+{
+  DEBUG ((DEBUG_ERROR, "%a is not supported without memory allocation\n", __FUNCTION__));
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Validate all entries of a raw packed variable list buffer once and build a hash index of them, keyed
+  on variable name and namespace GUID, so that subsequent queries do not need to rescan the buffer.
+
+  @param[in]  VariableListBuffer      Pointer to raw variable list buffer. Must remain valid
+                                      and unchanged for as long as the index is in use.
+  @param[in]  VariableListBufferSize  Size of VariableListBuffer.
+  @param[out] Index                   Pointer to the created index. Caller is responsible to free
+                                      it with FreeConfigVarListIndex.
+
+  @retval EFI_UNSUPPORTED         This library instance does not allocate.
+
+**/
+EFI_STATUS
+EFIAPI
+BuildConfigVarListIndex (
+  IN  CONST VOID             *VariableListBuffer,
+  IN  UINTN                  VariableListBufferSize,
+  OUT CONFIG_VAR_LIST_INDEX  **Index
+  )
+{
+  DEBUG ((DEBUG_ERROR, "%a is not supported without memory allocation\n", __FUNCTION__));
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Free an index created by BuildConfigVarListIndex. The indexed buffer is not freed.
+
+  @param[in]  Index   Pointer to the index to free, NULL is ignored.
+
+**/
+VOID
+EFIAPI
+FreeConfigVarListIndex (
+  IN  CONFIG_VAR_LIST_INDEX  *Index
+  )
+{
+  ASSERT (Index == NULL);
+}
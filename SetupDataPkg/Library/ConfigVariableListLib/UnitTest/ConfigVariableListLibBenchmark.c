@@ -0,0 +1,472 @@
+/** @file
+  Host based benchmark of the ConfigVariableListLib parse and serialize paths.
+
+  Synthetic variable lists of 10 to 10,000 knobs with varied name and data sizes are built and then
+  parsed through each of the library interfaces. Results are written to stdout as CSV, one line per
+  operation and knob count, so that runs can be compared against each other:
+
+    Operation,KnobCount,BufferSize,Iterations,NsPerOp,AllocationsPerOp
+
+  The pool allocation routines used by the library are redirected to this file by the INF build
+  options, so that the allocations made by each operation can be counted.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/DebugLib.h>
+#include <Library/ConfigVariableListLib.h>
+
+#define BENCHMARK_NAME_PREFIX_LEN  10
+#define BENCHMARK_MAX_NAME_LEN     64
+#define BENCHMARK_MAX_DATA_SIZE    512
+#define BENCHMARK_LARGE_DATA_SIZE  4096
+#define BENCHMARK_QUERY_COUNT      64
+
+// Each whole list operation processes about this many knobs in total, whatever the list size
+#define BENCHMARK_KNOBS_PER_OPERATION  200000
+
+STATIC CONST UINTN  mKnobCounts[] = { 10, 100, 1000, 10000 };
+
+STATIC UINT64  mAllocationCount;
+STATIC UINT32  mRandomState;
+
+/**
+  Count and perform a pool allocation for the benchmarked library.
+
+  @param[in]  AllocationSize  The number of bytes to allocate.
+
+  @return A pointer to the allocated buffer or NULL if allocation fails.
+**/
+VOID *
+EFIAPI
+BenchmarkAllocatePool (
+  IN UINTN  AllocationSize
+  )
+{
+  mAllocationCount++;
+  return malloc (AllocationSize);
+}
+
+/**
+  Count and perform a zeroed pool allocation for the benchmarked library.
+
+  @param[in]  AllocationSize  The number of bytes to allocate and zero.
+
+  @return A pointer to the allocated buffer or NULL if allocation fails.
+**/
+VOID *
+EFIAPI
+BenchmarkAllocateZeroPool (
+  IN UINTN  AllocationSize
+  )
+{
+  mAllocationCount++;
+  return calloc (1, AllocationSize);
+}
+
+/**
+  Count and perform a pool reallocation for the benchmarked library.
+
+  @param[in]  OldSize       The size, in bytes, of OldBuffer.
+  @param[in]  NewSize       The size, in bytes, of the buffer to reallocate.
+  @param[in]  OldBuffer     The buffer to copy to the allocated buffer, may be NULL.
+
+  @return A pointer to the allocated buffer or NULL if allocation fails.
+**/
+VOID *
+EFIAPI
+BenchmarkReallocatePool (
+  IN UINTN  OldSize,
+  IN UINTN  NewSize,
+  IN VOID   *OldBuffer  OPTIONAL
+  )
+{
+  mAllocationCount++;
+  return realloc (OldBuffer, NewSize);
+}
+
+/**
+  Free a pool allocation made by one of the benchmark allocation routines.
+
+  @param[in]  Buffer        The pointer to the buffer to free.
+**/
+VOID
+EFIAPI
+BenchmarkFreePool (
+  IN VOID  *Buffer
+  )
+{
+  free (Buffer);
+}
+
+/**
+  Return the next value of a fixed seed pseudo random sequence, so every run uses the same lists.
+
+  @return The next pseudo random value.
+**/
+STATIC
+UINT32
+BenchmarkRandom (
+  VOID
+  )
+{
+  mRandomState = mRandomState * 1103515245 + 12345;
+  return mRandomState >> 8;
+}
+
+/**
+  Return a monotonic timestamp in nanoseconds.
+
+  @return The current timestamp.
+**/
+STATIC
+UINT64
+BenchmarkNow (
+  VOID
+  )
+{
+  struct timespec  Now;
+
+  timespec_get (&Now, TIME_UTC);
+  return (UINT64)Now.tv_sec * 1000000000ULL + (UINT64)Now.tv_nsec;
+}
+
+/**
+  Write one result line.
+
+  @param[in]  Operation     Name of the benchmarked operation.
+  @param[in]  KnobCount     Number of knobs in the benchmarked list.
+  @param[in]  BufferSize    Size in bytes of the benchmarked list.
+  @param[in]  Iterations    Number of times the operation was performed.
+  @param[in]  Start         Timestamp taken before the first iteration.
+  @param[in]  Allocations   Number of allocations made by all iterations.
+**/
+STATIC
+VOID
+BenchmarkReport (
+  IN CONST CHAR8  *Operation,
+  IN UINTN        KnobCount,
+  IN UINTN        BufferSize,
+  IN UINTN        Iterations,
+  IN UINT64       Start,
+  IN UINT64       Allocations
+  )
+{
+  UINT64  Elapsed;
+
+  Elapsed = BenchmarkNow () - Start;
+  printf (
+    "%s,%llu,%llu,%llu,%llu,%.2f\n",
+    Operation,
+    (unsigned long long)KnobCount,
+    (unsigned long long)BufferSize,
+    (unsigned long long)Iterations,
+    (unsigned long long)(Elapsed / Iterations),
+    (double)Allocations / (double)Iterations
+    );
+}
+
+/**
+  Create a synthetic set of variable list entries. Names are 11 to 64 characters, most data is 1 to
+  512 bytes and every 97th knob has 4KB of data, spread over 4 namespace GUIDs.
+
+  @param[in]  KnobCount     Number of entries to create.
+
+  @return The entries, or NULL if allocation fails.
+**/
+STATIC
+CONFIG_VAR_LIST_ENTRY *
+CreateEntries (
+  IN UINTN  KnobCount
+  )
+{
+  CONFIG_VAR_LIST_ENTRY  *Entries;
+  CHAR8                  AsciiName[BENCHMARK_MAX_NAME_LEN + 1];
+  UINTN                  NameLen;
+  UINTN                  Index;
+  UINTN                  Char;
+
+  Entries = calloc (KnobCount, sizeof (CONFIG_VAR_LIST_ENTRY));
+  if (Entries == NULL) {
+    return NULL;
+  }
+
+  for (Index = 0; Index < KnobCount; Index++) {
+    NameLen = BENCHMARK_NAME_PREFIX_LEN + 1 + BenchmarkRandom () % (BENCHMARK_MAX_NAME_LEN - BENCHMARK_NAME_PREFIX_LEN);
+    snprintf (AsciiName, sizeof (AsciiName), "Knob%06u", (unsigned)Index);
+    for (Char = BENCHMARK_NAME_PREFIX_LEN; Char < NameLen; Char++) {
+      AsciiName[Char] = (CHAR8)('a' + BenchmarkRandom () % 26);
+    }
+
+    AsciiName[NameLen]  = '\0';
+    Entries[Index].Name = calloc (NameLen + 1, sizeof (CHAR16));
+    if (Entries[Index].Name == NULL) {
+      return NULL;
+    }
+
+    AsciiStrToUnicodeStrS (AsciiName, Entries[Index].Name, NameLen + 1);
+
+    Entries[Index].Guid.Data1 = 0x6BC2D2F6 + (UINT32)(Index % 4);
+    Entries[Index].Guid.Data2 = 0x4E43;
+    Entries[Index].Guid.Data3 = 0x8F1B;
+    Entries[Index].Attributes = EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS;
+    Entries[Index].DataSize   = (Index % 97 == 96) ? BENCHMARK_LARGE_DATA_SIZE : 1 + BenchmarkRandom () % BENCHMARK_MAX_DATA_SIZE;
+    Entries[Index].Data       = malloc (Entries[Index].DataSize);
+    if (Entries[Index].Data == NULL) {
+      return NULL;
+    }
+
+    for (Char = 0; Char < Entries[Index].DataSize; Char++) {
+      ((UINT8 *)Entries[Index].Data)[Char] = (UINT8)BenchmarkRandom ();
+    }
+  }
+
+  return Entries;
+}
+
+/**
+  Serialize entries into a packed variable list buffer.
+
+  @param[in]  Entries       Entries to serialize.
+  @param[in]  KnobCount     Number of entries.
+  @param[in]  Buffer        Buffer to serialize into.
+  @param[in]  BufferSize    Size in bytes of Buffer.
+
+  @return The size in bytes of the serialized list, 0 on failure.
+**/
+STATIC
+UINTN
+SerializeEntries (
+  IN CONST CONFIG_VAR_LIST_ENTRY  *Entries,
+  IN UINTN                        KnobCount,
+  IN UINT8                        *Buffer,
+  IN UINTN                        BufferSize
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Offset;
+  UINTN       Size;
+  UINTN       Index;
+
+  Offset = 0;
+  for (Index = 0; Index < KnobCount; Index++) {
+    Size   = BufferSize - Offset;
+    Status = ConvertVariableEntryToVariableList (&Entries[Index], Buffer + Offset, &Size);
+    if (EFI_ERROR (Status)) {
+      return 0;
+    }
+
+    Offset += Size;
+  }
+
+  return Offset;
+}
+
+/**
+  Benchmark every parse and serialize path against one synthetic variable list.
+
+  @param[in]  KnobCount     Number of knobs in the variable list.
+
+  @retval EFI_SUCCESS       All operations succeeded and were reported.
+  @retval Others            An operation failed.
+**/
+STATIC
+EFI_STATUS
+BenchmarkKnobCount (
+  IN UINTN  KnobCount
+  )
+{
+  EFI_STATUS                  Status;
+  CONFIG_VAR_LIST_ENTRY       *Entries;
+  CONFIG_VAR_LIST_ENTRY       *ConfigVarList;
+  CONFIG_VAR_LIST_ENTRY       ConfigVar;
+  CONFIG_VAR_LIST_ITERATOR    Iterator;
+  CONFIG_VAR_LIST_ENTRY_VIEW  View;
+  CONFIG_VAR_LIST_INDEX       *ListIndex;
+  UINT8                       *Buffer;
+  UINTN                       MaxBufferSize;
+  UINTN                       BufferSize;
+  UINTN                       ConfigVarListCount;
+  UINTN                       Iterations;
+  UINTN                       QueryStride;
+  UINTN                       Iteration;
+  UINTN                       Index;
+  UINT64                      Start;
+  UINT64                      Allocations;
+
+  Entries = CreateEntries (KnobCount);
+  if (Entries == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  MaxBufferSize = 0;
+  for (Index = 0; Index < KnobCount; Index++) {
+    MaxBufferSize += sizeof (CONFIG_VAR_LIST_HDR) + StrSize (Entries[Index].Name) + sizeof (EFI_GUID) +
+                     sizeof (UINT32) + Entries[Index].DataSize + sizeof (UINT32);
+  }
+
+  Buffer = malloc (MaxBufferSize);
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Iterations  = BENCHMARK_KNOBS_PER_OPERATION / KnobCount;
+  QueryStride = (KnobCount > BENCHMARK_QUERY_COUNT) ? KnobCount / BENCHMARK_QUERY_COUNT : 1;
+  BufferSize  = 0;
+
+  Allocations = mAllocationCount;
+  Start       = BenchmarkNow ();
+  for (Iteration = 0; Iteration < Iterations; Iteration++) {
+    BufferSize = SerializeEntries (Entries, KnobCount, Buffer, MaxBufferSize);
+    if (BufferSize == 0) {
+      return EFI_COMPROMISED_DATA;
+    }
+  }
+
+  BenchmarkReport ("ConvertVariableEntryToVariableList", KnobCount, BufferSize, Iterations, Start, mAllocationCount - Allocations);
+
+  Allocations = mAllocationCount;
+  Start       = BenchmarkNow ();
+  for (Iteration = 0; Iteration < Iterations; Iteration++) {
+    Status = RetrieveActiveConfigVarList (Buffer, BufferSize, &ConfigVarList, &ConfigVarListCount);
+    if (EFI_ERROR (Status) || (ConfigVarListCount != KnobCount)) {
+      return EFI_ERROR (Status) ? Status : EFI_COMPROMISED_DATA;
+    }
+
+    for (Index = 0; Index < ConfigVarListCount; Index++) {
+      FreePool (ConfigVarList[Index].Name);
+      FreePool (ConfigVarList[Index].Data);
+    }
+
+    FreePool (ConfigVarList);
+  }
+
+  BenchmarkReport ("RetrieveActiveConfigVarList", KnobCount, BufferSize, Iterations, Start, mAllocationCount - Allocations);
+
+  Allocations = mAllocationCount;
+  Start       = BenchmarkNow ();
+  for (Iteration = 0; Iteration < Iterations; Iteration++) {
+    Status = RetrieveActiveConfigVarListSingleAllocation (Buffer, BufferSize, &ConfigVarList, &ConfigVarListCount);
+    if (EFI_ERROR (Status) || (ConfigVarListCount != KnobCount)) {
+      return EFI_ERROR (Status) ? Status : EFI_COMPROMISED_DATA;
+    }
+
+    FreeConfigVarList (ConfigVarList);
+  }
+
+  BenchmarkReport ("RetrieveActiveConfigVarListSingleAllocation", KnobCount, BufferSize, Iterations, Start, mAllocationCount - Allocations);
+
+  Allocations = mAllocationCount;
+  Start       = BenchmarkNow ();
+  for (Iteration = 0; Iteration < Iterations; Iteration++) {
+    ConfigVarListIterInit (Buffer, BufferSize, &Iterator);
+    for (Index = 0; Index < KnobCount; Index++) {
+      Status = ConfigVarListIterNext (&Iterator, &View);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+  }
+
+  BenchmarkReport ("ConfigVarListIterNext", KnobCount, BufferSize, Iterations, Start, mAllocationCount - Allocations);
+
+  Allocations = mAllocationCount;
+  Start       = BenchmarkNow ();
+  for (Iteration = 0; Iteration < Iterations; Iteration++) {
+    Status = BuildConfigVarListIndex (Buffer, BufferSize, &ListIndex);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    FreeConfigVarListIndex (ListIndex);
+  }
+
+  BenchmarkReport ("BuildConfigVarListIndex", KnobCount, BufferSize, Iterations, Start, mAllocationCount - Allocations);
+
+  // The queries are reported per query, over a sample of names spread across the list
+  Iterations  = 0;
+  Allocations = mAllocationCount;
+  Start       = BenchmarkNow ();
+  for (Index = 0; Index < KnobCount; Index += QueryStride) {
+    Status = QuerySingleActiveConfigUnicodeVarList (Buffer, BufferSize, Entries[Index].Name, &ConfigVar);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    FreePool (ConfigVar.Name);
+    FreePool (ConfigVar.Data);
+    Iterations++;
+  }
+
+  BenchmarkReport ("QuerySingleActiveConfigUnicodeVarList", KnobCount, BufferSize, Iterations, Start, mAllocationCount - Allocations);
+
+  Status = BuildConfigVarListIndex (Buffer, BufferSize, &ListIndex);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Iterations  = 0;
+  Allocations = mAllocationCount;
+  Start       = BenchmarkNow ();
+  for (Index = 0; Index < KnobCount; Index += QueryStride) {
+    Status = QueryConfigVarListIndexUnicode (ListIndex, Entries[Index].Name, &Entries[Index].Guid, &View);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    Iterations++;
+  }
+
+  BenchmarkReport ("QueryConfigVarListIndexUnicode", KnobCount, BufferSize, Iterations, Start, mAllocationCount - Allocations);
+
+  FreeConfigVarListIndex (ListIndex);
+  for (Index = 0; Index < KnobCount; Index++) {
+    free (Entries[Index].Name);
+    free (Entries[Index].Data);
+  }
+
+  free (Entries);
+  free (Buffer);
+  return EFI_SUCCESS;
+}
+
+/**
+  Benchmark entry point.
+
+  @param[in]  argc  Number of command line arguments, unused.
+  @param[in]  argv  Command line arguments, unused.
+
+  @retval 0   All benchmarks completed.
+  @retval 1   A benchmarked operation failed.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Index;
+
+  mRandomState = 0x5EED;
+  printf ("Operation,KnobCount,BufferSize,Iterations,NsPerOp,AllocationsPerOp\n");
+  for (Index = 0; Index < ARRAY_SIZE (mKnobCounts); Index++) {
+    Status = BenchmarkKnobCount (mKnobCounts[Index]);
+    if (EFI_ERROR (Status)) {
+      fprintf (stderr, "Benchmark of %llu knobs failed: %llx\n", (unsigned long long)mKnobCounts[Index], (unsigned long long)Status);
+      return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,452 @@
+/** @file
+  Unit tests of the ConfigVariableListLibNoAlloc instance.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/ConfigVariableListLib.h>
+
+#include <Library/UnitTestLib.h>
+#include <Good_Config_Data.h>
+
+#define UNIT_TEST_APP_NAME     "Conf Variable List Lib No Alloc Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+// Slots needed to index the 9 entries of mKnown_Good_Generic_Profile at most half full
+#define KNOWN_GOOD_INDEX_SLOT_COUNT  32
+
+/**
+  Unit test for QueryConfigVarListViewUnicode and QueryConfigVarListViewAscii.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigVarListViewQueryNormal (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY_VIEW  Entry;
+  EFI_STATUS                  Status;
+  CHAR8                       AsciiName[CONF_VAR_NAME_LEN];
+  EFI_GUID                    *Guid;
+  UINT32                      i;
+
+  for (i = 0; i < KNOWN_GOOD_TAG_COUNT; i++) {
+    Guid = (i < 2) ? &mKnown_Good_Yaml_Guid : &mKnown_Good_Xml_Guid;
+
+    Status = QueryConfigVarListViewUnicode (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), mKnown_Good_VarList_Names[i], Guid, &Entry);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Names[i], Entry.Name, Entry.NameSize);
+    UT_ASSERT_MEM_EQUAL (Guid, Entry.Guid, sizeof (EFI_GUID));
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], Entry.DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], Entry.Data, Entry.DataSize);
+
+    // Data should be handed back from the original buffer
+    UT_ASSERT_TRUE ((CONST UINT8 *)Entry.Data >= mKnown_Good_Generic_Profile);
+    UT_ASSERT_TRUE ((CONST UINT8 *)Entry.Data < mKnown_Good_Generic_Profile + sizeof (mKnown_Good_Generic_Profile));
+
+    UnicodeStrToAsciiStrS (mKnown_Good_VarList_Names[i], AsciiName, sizeof (AsciiName));
+    Status = QueryConfigVarListViewAscii (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), AsciiName, NULL, &Entry);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Names[i], Entry.Name, Entry.NameSize);
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], Entry.DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], Entry.Data, Entry.DataSize);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for QueryConfigVarListViewUnicode and QueryConfigVarListViewAscii for names or
+  namespaces that are not in the buffer, bad data and null inputs.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigVarListViewQueryFail (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY_VIEW  Entry;
+  EFI_STATUS                  Status;
+
+  Status = QueryConfigVarListViewUnicode (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), L"InvalidName", NULL, &Entry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  Status = QueryConfigVarListViewAscii (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), "InvalidName", NULL, &Entry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  // Right name, wrong namespace
+  Status = QueryConfigVarListViewUnicode (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), mKnown_Good_VarList_Names[0], &mKnown_Good_Xml_Guid, &Entry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  Status = QueryConfigVarListViewUnicode (mKnown_Bad_Config_Data, sizeof (mKnown_Bad_Config_Data), mKnown_Good_VarList_Names[0], NULL, &Entry);
+  UT_ASSERT_TRUE (EFI_ERROR (Status));
+  UT_ASSERT_NOT_EQUAL (Status, EFI_NOT_FOUND);
+
+  Status = QueryConfigVarListViewUnicode (NULL, sizeof (mKnown_Good_Generic_Profile), mKnown_Good_VarList_Names[0], NULL, &Entry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = QueryConfigVarListViewUnicode (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), NULL, NULL, &Entry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = QueryConfigVarListViewAscii (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), "INTEGER_KNOB", NULL, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for InitConfigVarListIndex over caller provided slots.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigVarListIndexInitNormal (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_INDEX_SLOT  Slots[KNOWN_GOOD_INDEX_SLOT_COUNT];
+  CONFIG_VAR_LIST_INDEX       Index;
+  CONFIG_VAR_LIST_ENTRY_VIEW  Entry;
+  EFI_STATUS                  Status;
+  CHAR8                       AsciiName[CONF_VAR_NAME_LEN];
+  UINTN                       SlotCount;
+  UINT32                      i;
+
+  // Sizing only
+  SlotCount = 0;
+  Status    = InitConfigVarListIndex (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), NULL, &SlotCount, &Index);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_OUT_OF_RESOURCES);
+  UT_ASSERT_EQUAL (SlotCount, KNOWN_GOOD_INDEX_SLOT_COUNT);
+
+  // Too few slots
+  SlotCount = KNOWN_GOOD_INDEX_SLOT_COUNT / 2;
+  Status    = InitConfigVarListIndex (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), Slots, &SlotCount, &Index);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_OUT_OF_RESOURCES);
+  UT_ASSERT_EQUAL (SlotCount, KNOWN_GOOD_INDEX_SLOT_COUNT);
+
+  Status = InitConfigVarListIndex (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), Slots, &SlotCount, &Index);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Index.EntryCount, KNOWN_GOOD_TAG_COUNT);
+  UT_ASSERT_EQUAL (Index.SlotCount, KNOWN_GOOD_INDEX_SLOT_COUNT);
+
+  for (i = 0; i < KNOWN_GOOD_TAG_COUNT; i++) {
+    Status = QueryConfigVarListIndexUnicode (&Index, mKnown_Good_VarList_Names[i], NULL, &Entry);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], Entry.DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], Entry.Data, Entry.DataSize);
+
+    UnicodeStrToAsciiStrS (mKnown_Good_VarList_Names[i], AsciiName, sizeof (AsciiName));
+    Status = QueryConfigVarListIndexAscii (&Index, AsciiName, NULL, &Entry);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Names[i], Entry.Name, Entry.NameSize);
+  }
+
+  Status = QueryConfigVarListIndexUnicode (&Index, L"InvalidName", NULL, &Entry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for InitConfigVarListIndex for bad CRCed input and bad parameters.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigVarListIndexInitFail (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_INDEX_SLOT  Slots[KNOWN_GOOD_INDEX_SLOT_COUNT];
+  CONFIG_VAR_LIST_INDEX       Index;
+  EFI_STATUS                  Status;
+  UINT8                       Buffer[sizeof (mKnown_Good_Generic_Profile)];
+  UINTN                       SlotCount;
+
+  // Corrupt the CRC of the last entry
+  CopyMem (Buffer, mKnown_Good_Generic_Profile, sizeof (Buffer));
+  Buffer[sizeof (Buffer) - 1] ^= 0xFF;
+
+  SlotCount = KNOWN_GOOD_INDEX_SLOT_COUNT;
+  Status    = InitConfigVarListIndex (Buffer, sizeof (Buffer), Slots, &SlotCount, &Index);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+
+  // Not a power of 2
+  SlotCount = KNOWN_GOOD_INDEX_SLOT_COUNT - 1;
+  Status    = InitConfigVarListIndex (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), Slots, &SlotCount, &Index);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  SlotCount = KNOWN_GOOD_INDEX_SLOT_COUNT;
+  Status    = InitConfigVarListIndex (NULL, sizeof (mKnown_Good_Generic_Profile), Slots, &SlotCount, &Index);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = InitConfigVarListIndex (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), Slots, NULL, &Index);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = InitConfigVarListIndex (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), Slots, &SlotCount, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for ConfigVarListStreamInit and ConfigVarListStreamNext over caller provided scratch memory.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigVarListStreamNormal (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_STREAM      Stream;
+  CONFIG_VAR_LIST_ITERATOR    Iterator;
+  CONFIG_VAR_LIST_ENTRY_VIEW  Entry;
+  CONFIG_VAR_LIST_ENTRY_VIEW  PackedEntry;
+  EFI_STATUS                  Status;
+  UINT8                       Scratch[512];
+  UINTN                       ScratchSize;
+  UINT32                      i;
+
+  // Sizing only
+  ScratchSize = 0;
+  Status      = ConfigVarListStreamInit (mKnown_Good_Compressed_Generic_Profile, sizeof (mKnown_Good_Compressed_Generic_Profile), NULL, &ScratchSize, &Stream);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_BUFFER_TOO_SMALL);
+  UT_ASSERT_TRUE (ScratchSize <= sizeof (Scratch));
+
+  Status = ConfigVarListStreamInit (mKnown_Good_Compressed_Generic_Profile, sizeof (mKnown_Good_Compressed_Generic_Profile), Scratch, &ScratchSize, &Stream);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Stream.EntryCount, KNOWN_GOOD_TAG_COUNT);
+  UT_ASSERT_EQUAL (Stream.PackedSize, sizeof (mKnown_Good_Generic_Profile));
+
+  Status = ConfigVarListIterInit (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), &Iterator);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  // Each streamed entry is rebuilt as the very packed entry it was compressed from
+  for (i = 0; i < KNOWN_GOOD_TAG_COUNT; i++) {
+    Status = ConfigVarListStreamNext (&Stream, &Entry);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    Status = ConfigVarListIterNext (&Iterator, &PackedEntry);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+
+    UT_ASSERT_EQUAL (Entry.RawSize, PackedEntry.RawSize);
+    UT_ASSERT_MEM_EQUAL (Entry.Raw, PackedEntry.Raw, Entry.RawSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Names[i], Entry.Name, Entry.NameSize);
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], Entry.DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], Entry.Data, Entry.DataSize);
+    UT_ASSERT_MEM_EQUAL ((i < 2) ? &mKnown_Good_Yaml_Guid : &mKnown_Good_Xml_Guid, Entry.Guid, sizeof (EFI_GUID));
+  }
+
+  Status = ConfigVarListStreamNext (&Stream, &Entry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  Status = ConfigVarListStreamInit (NULL, sizeof (mKnown_Good_Compressed_Generic_Profile), Scratch, &ScratchSize, &Stream);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = ConfigVarListStreamNext (&Stream, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test that the functions needing allocations are not supported by this instance.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigVarListAllocationUnsupported (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY  *ConfigVarListPtr  = NULL;
+  UINTN                  ConfigVarListCount = 0;
+  CONFIG_VAR_LIST_ENTRY  SingleEntry;
+  CONFIG_VAR_LIST_INDEX  *Index = NULL;
+  VOID                   *Packed;
+  EFI_STATUS             Status;
+  UINTN                  Size;
+
+  Status = RetrieveActiveConfigVarList (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_UNSUPPORTED);
+
+  Status = RetrieveActiveConfigVarListSingleAllocation (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_UNSUPPORTED);
+
+  Status = QuerySingleActiveConfigUnicodeVarList (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), mKnown_Good_VarList_Names[0], &SingleEntry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_UNSUPPORTED);
+
+  Size   = sizeof (mKnown_Good_Generic_Profile);
+  Status = ConvertVariableListToVariableEntry (mKnown_Good_Generic_Profile, &Size, &SingleEntry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_UNSUPPORTED);
+
+  Status = BuildConfigVarListIndex (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), &Index);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_UNSUPPORTED);
+
+  Status = RetrieveDecompressedConfigVarList (mKnown_Good_Compressed_Generic_Profile, sizeof (mKnown_Good_Compressed_Generic_Profile), &Packed, &Size);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_UNSUPPORTED);
+
+  // Should be no-ops
+  FreeConfigVarList (NULL);
+  FreeConfigVarListIndex (NULL);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  ConfigVariableListLibNoAlloc and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      ConfigVariableListLib;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the ConfigVariableListLibNoAlloc Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&ConfigVariableListLib, Framework, "ConfigVariableListLibNoAlloc In Place Tests", "ConfigVariableListLibNoAlloc.InPlace", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for ConfigVariableListLibNoAlloc\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----------Description--------------Name----------Function--------Pre---Post-------------------Context-----------
+  //
+  AddTestCase (ConfigVariableListLib, "Query in place should succeed", "ConfigVarListViewQueryNormal", ConfigVarListViewQueryNormal, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Bad name, namespace or data should fail", "ConfigVarListViewQueryFail", ConfigVarListViewQueryFail, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Index into caller slots should succeed", "ConfigVarListIndexInitNormal", ConfigVarListIndexInitNormal, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Bad CRC or params should fail", "ConfigVarListIndexInitFail", ConfigVarListIndexInitFail, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Stream into caller scratch should succeed", "ConfigVarListStreamNormal", ConfigVarListStreamNormal, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Allocating calls should be unsupported", "ConfigVarListAllocationUnsupported", ConfigVarListAllocationUnsupported, NULL, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
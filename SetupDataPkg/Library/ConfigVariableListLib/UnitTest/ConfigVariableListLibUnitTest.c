@@ -1128,6 +1128,1180 @@ GetVarListSizeOverflow (
   return UNIT_TEST_PASSED;
 }
 
+/**
+  Unit test for ConfigVarListIterNext walking a full profile in place.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigVarListIterateNormal (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ITERATOR    Iterator;
+  CONFIG_VAR_LIST_ENTRY_VIEW  Entry;
+  EFI_STATUS                  Status;
+  UINTN                       Consumed = 0;
+  UINT32                      i        = 0;
+
+  Status = ConfigVarListIterInit (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), &Iterator);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  while (TRUE) {
+    Status = ConfigVarListIterNext (&Iterator, &Entry);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    UT_ASSERT_TRUE (i < 9);
+
+    // Everything handed back should point into the original buffer
+    UT_ASSERT_TRUE ((CONST UINT8 *)Entry.Raw == mKnown_Good_Generic_Profile + Consumed);
+    UT_ASSERT_TRUE ((CONST UINT8 *)Entry.Data > (CONST UINT8 *)Entry.Raw);
+    UT_ASSERT_TRUE ((CONST UINT8 *)Entry.Data + Entry.DataSize < (CONST UINT8 *)Entry.Raw + Entry.RawSize);
+
+    UT_ASSERT_EQUAL (StrSize (mKnown_Good_VarList_Names[i]), Entry.NameSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Names[i], Entry.Name, Entry.NameSize);
+    if (i < 2) {
+      UT_ASSERT_MEM_EQUAL (&mKnown_Good_Yaml_Guid, Entry.Guid, sizeof (mKnown_Good_Yaml_Guid));
+      UT_ASSERT_EQUAL (3, Entry.Attributes);
+    } else {
+      // Xml part of blob
+      UT_ASSERT_MEM_EQUAL (&mKnown_Good_Xml_Guid, Entry.Guid, sizeof (mKnown_Good_Xml_Guid));
+      UT_ASSERT_EQUAL (7, Entry.Attributes);
+    }
+
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], Entry.DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], Entry.Data, Entry.DataSize);
+
+    Consumed += Entry.RawSize;
+    i++;
+  }
+
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+  UT_ASSERT_EQUAL (i, 9);
+  UT_ASSERT_EQUAL (Consumed, sizeof (mKnown_Good_Generic_Profile));
+
+  // Iterator should stay at the end
+  Status = ConfigVarListIterNext (&Iterator, &Entry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for ConfigVarListIterNext for bad CRCed input.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigVarListIterateBadCrc (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ITERATOR    Iterator;
+  CONFIG_VAR_LIST_ENTRY_VIEW  Entry;
+  EFI_STATUS                  Status;
+  UINT32                      FirstSize;
+  UINT8                       *Buffer;
+
+  Status = GetVarListSize ((UINT32)StrSize (mKnown_Good_VarList_Names[0]), (UINT32)mKnown_Good_VarList_DataSizes[0], &FirstSize);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  Buffer = AllocateCopyPool (sizeof (mKnown_Good_Generic_Profile), mKnown_Good_Generic_Profile);
+  UT_ASSERT_NOT_NULL (Buffer);
+
+  // Corrupt the name of the second entry, which will throw off its CRC
+  Buffer[FirstSize + sizeof (CONFIG_VAR_LIST_HDR)] = Buffer[FirstSize + sizeof (CONFIG_VAR_LIST_HDR)] + 1;
+
+  Status = ConfigVarListIterInit (Buffer, sizeof (mKnown_Good_Generic_Profile), &Iterator);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  Status = ConfigVarListIterNext (&Iterator, &Entry);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Entry.RawSize, FirstSize);
+
+  Status = ConfigVarListIterNext (&Iterator, &Entry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+
+  // Iterator should not advance past a bad entry
+  Status = ConfigVarListIterNext (&Iterator, &Entry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+
+  FreePool (Buffer);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for ConfigVarListIterNext for truncated input.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigVarListIterateBadSize (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ITERATOR    Iterator;
+  CONFIG_VAR_LIST_ENTRY_VIEW  Entry;
+  EFI_STATUS                  Status;
+
+  Status = ConfigVarListIterInit (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile) - 1, &Iterator);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  do {
+    Status = ConfigVarListIterNext (&Iterator, &Entry);
+  } while (!EFI_ERROR (Status));
+
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_BUFFER_TOO_SMALL);
+
+  // Empty buffer simply has nothing to iterate
+  Status = ConfigVarListIterInit (NULL, 0, &Iterator);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  Status = ConfigVarListIterNext (&Iterator, &Entry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for ConfigVarListIterInit and ConfigVarListIterNext for null input.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigVarListIterateNull (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ITERATOR    Iterator;
+  CONFIG_VAR_LIST_ENTRY_VIEW  Entry;
+  EFI_STATUS                  Status;
+
+  Status = ConfigVarListIterInit (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = ConfigVarListIterInit (NULL, sizeof (mKnown_Good_Generic_Profile), &Iterator);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = ConfigVarListIterInit (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), &Iterator);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  Status = ConfigVarListIterNext (NULL, &Entry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = ConfigVarListIterNext (&Iterator, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for QueryConfigVarListIndexUnicode and QueryConfigVarListIndexAscii.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigVarListIndexQueryNormal (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_INDEX       *Index = NULL;
+  CONFIG_VAR_LIST_ENTRY_VIEW  Entry;
+  EFI_STATUS                  Status;
+  CHAR8                       AsciiName[CONF_VAR_NAME_LEN];
+  EFI_GUID                    *Guid;
+  UINT32                      i;
+
+  Status = BuildConfigVarListIndex (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), &Index);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_NOT_NULL (Index);
+  UT_ASSERT_EQUAL (Index->EntryCount, 9);
+
+  // Query in reverse order to make sure no state is carried between lookups
+  for (i = 9; i > 0; i--) {
+    Guid = (i - 1 < 2) ? &mKnown_Good_Yaml_Guid : &mKnown_Good_Xml_Guid;
+
+    Status = QueryConfigVarListIndexUnicode (Index, mKnown_Good_VarList_Names[i - 1], Guid, &Entry);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Names[i - 1], Entry.Name, Entry.NameSize);
+    UT_ASSERT_MEM_EQUAL (Guid, Entry.Guid, sizeof (EFI_GUID));
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i - 1], Entry.DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i - 1], Entry.Data, Entry.DataSize);
+
+    // Data should be handed back from the original buffer
+    UT_ASSERT_TRUE ((CONST UINT8 *)Entry.Raw >= mKnown_Good_Generic_Profile);
+    UT_ASSERT_TRUE ((CONST UINT8 *)Entry.Raw < mKnown_Good_Generic_Profile + sizeof (mKnown_Good_Generic_Profile));
+
+    UnicodeStrToAsciiStrS (mKnown_Good_VarList_Names[i - 1], AsciiName, sizeof (AsciiName));
+    Status = QueryConfigVarListIndexAscii (Index, AsciiName, NULL, &Entry);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Names[i - 1], Entry.Name, Entry.NameSize);
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i - 1], Entry.DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i - 1], Entry.Data, Entry.DataSize);
+  }
+
+  FreeConfigVarListIndex (Index);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for QueryConfigVarListIndexUnicode and QueryConfigVarListIndexAscii for names or
+  namespaces that are not in the buffer.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigVarListIndexQueryNotFound (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_INDEX       *Index = NULL;
+  CONFIG_VAR_LIST_ENTRY_VIEW  Entry;
+  EFI_STATUS                  Status;
+
+  Status = BuildConfigVarListIndex (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), &Index);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  Status = QueryConfigVarListIndexUnicode (Index, L"InvalidName", NULL, &Entry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  Status = QueryConfigVarListIndexAscii (Index, "InvalidName", NULL, &Entry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  // Right name, wrong namespace
+  Status = QueryConfigVarListIndexUnicode (Index, mKnown_Good_VarList_Names[0], &mKnown_Good_Xml_Guid, &Entry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  Status = QueryConfigVarListIndexUnicode (Index, mKnown_Good_VarList_Names[0], &mKnown_Good_Yaml_Guid, &Entry);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  FreeConfigVarListIndex (Index);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for BuildConfigVarListIndex for bad CRCed input.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigVarListIndexBuildBadCrc (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_INDEX  *Index = NULL;
+  EFI_STATUS             Status;
+  UINT8                  *Buffer;
+
+  Buffer = AllocateCopyPool (sizeof (mKnown_Good_Generic_Profile), mKnown_Good_Generic_Profile);
+  UT_ASSERT_NOT_NULL (Buffer);
+
+  // Corrupt the CRC of the last entry
+  Buffer[sizeof (mKnown_Good_Generic_Profile) - 1] = Buffer[sizeof (mKnown_Good_Generic_Profile) - 1] + 1;
+
+  Status = BuildConfigVarListIndex (Buffer, sizeof (mKnown_Good_Generic_Profile), &Index);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+  UT_ASSERT_EQUAL (Index, NULL);
+
+  FreePool (Buffer);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for BuildConfigVarListIndex and index queries for null input.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConfigVarListIndexNull (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_INDEX       *Index = NULL;
+  CONFIG_VAR_LIST_ENTRY_VIEW  Entry;
+  EFI_STATUS                  Status;
+
+  Status = BuildConfigVarListIndex (NULL, sizeof (mKnown_Good_Generic_Profile), &Index);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = BuildConfigVarListIndex (mKnown_Good_Generic_Profile, 0, &Index);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = BuildConfigVarListIndex (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = BuildConfigVarListIndex (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), &Index);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  Status = QueryConfigVarListIndexUnicode (NULL, mKnown_Good_VarList_Names[0], NULL, &Entry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = QueryConfigVarListIndexUnicode (Index, NULL, NULL, &Entry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = QueryConfigVarListIndexAscii (Index, "INTEGER_KNOB", NULL, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  FreeConfigVarListIndex (Index);
+
+  // Should be a no-op
+  FreeConfigVarListIndex (NULL);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Build an aligned variable list buffer holding the same entries as a packed variable list buffer.
+
+  @param[in]  PackedBuffer        Pointer to packed variable list buffer.
+  @param[in]  PackedBufferSize    Size of PackedBuffer.
+  @param[out] AlignedBufferSize   Size of the returned buffer.
+
+  @return Pointer to the aligned variable list buffer, to be freed by the caller. NULL on failure.
+**/
+STATIC
+VOID *
+BuildAlignedVarList (
+  IN  CONST VOID  *PackedBuffer,
+  IN  UINTN       PackedBufferSize,
+  OUT UINTN       *AlignedBufferSize
+  )
+{
+  CONFIG_VAR_LIST_ITERATOR       Iterator;
+  CONFIG_VAR_LIST_ENTRY_VIEW     View;
+  CONFIG_VAR_LIST_ALIGNED_HDR    *Hdr;
+  CONFIG_VAR_LIST_ALIGNED_ENTRY  *Entry;
+  UINT8                          *Buffer;
+  UINT32                         EntryCount = 0;
+  UINT32                         NamesSize  = 0;
+  UINT32                         DataSize   = 0;
+  UINT32                         NamesOffset;
+  UINT32                         DataOffset;
+
+  // First pass sizes the regions
+  ConfigVarListIterInit (PackedBuffer, PackedBufferSize, &Iterator);
+  while (!EFI_ERROR (ConfigVarListIterNext (&Iterator, &View))) {
+    EntryCount++;
+    NamesSize += View.NameSize;
+    DataSize   = ALIGN_VALUE (DataSize, CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT) + View.DataSize;
+  }
+
+  NamesOffset = sizeof (CONFIG_VAR_LIST_ALIGNED_HDR) + EntryCount * sizeof (CONFIG_VAR_LIST_ALIGNED_ENTRY);
+  DataOffset  = ALIGN_VALUE (NamesOffset + NamesSize, CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT);
+
+  *AlignedBufferSize = DataOffset + DataSize;
+  Buffer             = AllocateZeroPool (*AlignedBufferSize);
+  if (Buffer == NULL) {
+    return NULL;
+  }
+
+  Hdr              = (CONFIG_VAR_LIST_ALIGNED_HDR *)Buffer;
+  Hdr->Signature   = CONFIG_VAR_LIST_ALIGNED_SIGNATURE;
+  Hdr->Version     = CONFIG_VAR_LIST_ALIGNED_VERSION;
+  Hdr->HeaderSize  = sizeof (CONFIG_VAR_LIST_ALIGNED_HDR);
+  Hdr->EntryCount  = EntryCount;
+  Hdr->NamesOffset = NamesOffset;
+  Hdr->NamesSize   = NamesSize;
+  Hdr->DataOffset  = DataOffset;
+  Hdr->DataSize    = DataSize;
+
+  // Second pass fills them
+  Entry     = (CONFIG_VAR_LIST_ALIGNED_ENTRY *)(Hdr + 1);
+  NamesSize = 0;
+  DataSize  = 0;
+  ConfigVarListIterInit (PackedBuffer, PackedBufferSize, &Iterator);
+  while (!EFI_ERROR (ConfigVarListIterNext (&Iterator, &View))) {
+    DataSize = ALIGN_VALUE (DataSize, CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT);
+
+    CopyMem (&Entry->Guid, View.Guid, sizeof (EFI_GUID));
+    Entry->Attributes = View.Attributes;
+    Entry->NameOffset = NamesSize;
+    Entry->NameSize   = View.NameSize;
+    Entry->DataOffset = DataSize;
+    Entry->DataSize   = View.DataSize;
+    CopyMem (Buffer + NamesOffset + NamesSize, View.Name, View.NameSize);
+    CopyMem (Buffer + DataOffset + DataSize, View.Data, View.DataSize);
+
+    NamesSize += View.NameSize;
+    DataSize  += View.DataSize;
+    Entry++;
+  }
+
+  Hdr->Crc32 = CalculateCrc32 (Buffer + Hdr->HeaderSize, *AlignedBufferSize - Hdr->HeaderSize);
+
+  return Buffer;
+}
+
+/**
+  Unit test for RetrieveActiveConfigVarList and QuerySingleActiveConfigUnicodeVarList with an aligned variable list.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RetrieveActiveConfigVarListAlignedTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY       *ConfigVarListPtr  = NULL;
+  CONFIG_VAR_LIST_ENTRY       SingleEntry;
+  UINTN                       ConfigVarListCount = 0;
+  UINTN                       AlignedSize;
+  VOID                        *AlignedBuffer;
+  CONFIG_VAR_LIST_ITERATOR    Iterator;
+  CONFIG_VAR_LIST_ENTRY_VIEW  View;
+  CONFIG_VAR_LIST_INDEX       *Index = NULL;
+  EFI_STATUS                  Status;
+  UINT32                      i = 0;
+
+  AlignedBuffer = BuildAlignedVarList (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), &AlignedSize);
+  UT_ASSERT_NOT_NULL (AlignedBuffer);
+
+  // The iterator and the index read the aligned entries in place
+  Status = ConfigVarListIterInit (AlignedBuffer, AlignedSize, &Iterator);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  Status = BuildConfigVarListIndex (AlignedBuffer, AlignedSize, &Index);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  for (i = 0; i < 9; i++) {
+    Status = ConfigVarListIterNext (&Iterator, &View);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Names[i], View.Name, StrSize (mKnown_Good_VarList_Names[i]));
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], View.DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], View.Data, View.DataSize);
+
+    Status = QueryConfigVarListIndexUnicode (Index, mKnown_Good_VarList_Names[i], NULL, &View);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], View.DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], View.Data, View.DataSize);
+  }
+
+  Status = ConfigVarListIterNext (&Iterator, &View);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  Status = QueryConfigVarListIndexUnicode (Index, L"NoSuchKnob", NULL, &View);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+  FreeConfigVarListIndex (Index);
+
+  i = 0;
+
+  Status = RetrieveActiveConfigVarList (AlignedBuffer, AlignedSize, &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (ConfigVarListCount, 9);
+
+  for ( ; i < ConfigVarListCount; i++) {
+    // StrLen * 2 as we compare all bytes, not just number of Unicode chars
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Names[i], ConfigVarListPtr[i].Name, StrLen (mKnown_Good_VarList_Names[i]) * 2);
+    if (i < 2) {
+      UT_ASSERT_MEM_EQUAL (&mKnown_Good_Yaml_Guid, &ConfigVarListPtr[i].Guid, sizeof (mKnown_Good_Yaml_Guid));
+      UT_ASSERT_EQUAL (3, ConfigVarListPtr[i].Attributes);
+    } else {
+      // Xml part of blob
+      UT_ASSERT_MEM_EQUAL (&mKnown_Good_Xml_Guid, &ConfigVarListPtr[i].Guid, sizeof (mKnown_Good_Xml_Guid));
+      UT_ASSERT_EQUAL (7, ConfigVarListPtr[i].Attributes);
+    }
+
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], ConfigVarListPtr[i].DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], ConfigVarListPtr[i].Data, ConfigVarListPtr[i].DataSize);
+
+    Status = QuerySingleActiveConfigUnicodeVarList (AlignedBuffer, AlignedSize, mKnown_Good_VarList_Names[i], &SingleEntry);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], SingleEntry.DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], SingleEntry.Data, SingleEntry.DataSize);
+
+    FreePool (SingleEntry.Name);
+    FreePool (SingleEntry.Data);
+    FreePool (ConfigVarListPtr[i].Name);
+    FreePool (ConfigVarListPtr[i].Data);
+  }
+
+  FreePool (ConfigVarListPtr);
+
+  Status = QuerySingleActiveConfigUnicodeVarList (AlignedBuffer, AlignedSize, L"NoSuchKnob", &SingleEntry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  FreePool (AlignedBuffer);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for RetrieveActiveConfigVarList with a corrupted aligned variable list.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RetrieveActiveConfigVarListAlignedBadDataTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY        *ConfigVarListPtr;
+  UINTN                        ConfigVarListCount;
+  UINTN                        AlignedSize;
+  UINT8                        *AlignedBuffer;
+  CONFIG_VAR_LIST_ALIGNED_HDR  *Hdr;
+  CONFIG_VAR_LIST_ITERATOR     Iterator;
+  CONFIG_VAR_LIST_ENTRY_VIEW   View;
+  EFI_STATUS                   Status;
+
+  AlignedBuffer = BuildAlignedVarList (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), &AlignedSize);
+  UT_ASSERT_NOT_NULL (AlignedBuffer);
+  Hdr = (CONFIG_VAR_LIST_ALIGNED_HDR *)AlignedBuffer;
+
+  // Corrupted data
+  AlignedBuffer[AlignedSize - 1] ^= 0xFF;
+  Status                          = RetrieveActiveConfigVarList (AlignedBuffer, AlignedSize, &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+  UT_ASSERT_EQUAL (ConfigVarListCount, 0);
+  UT_ASSERT_EQUAL (ConfigVarListPtr, NULL);
+  Status = ConfigVarListIterInit (AlignedBuffer, AlignedSize, &Iterator);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+  AlignedBuffer[AlignedSize - 1] ^= 0xFF;
+
+  // Truncated buffer
+  Status = RetrieveActiveConfigVarList (AlignedBuffer, AlignedSize - 1, &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+
+  // Entry pointing past its region, with a valid CRC
+  ((CONFIG_VAR_LIST_ALIGNED_ENTRY *)(Hdr + 1))->DataOffset = Hdr->DataSize + CONFIG_VAR_LIST_ALIGNED_DATA_ALIGNMENT;
+  Hdr->Crc32                                               = CalculateCrc32 (AlignedBuffer + Hdr->HeaderSize, AlignedSize - Hdr->HeaderSize);
+  Status                                                   = RetrieveActiveConfigVarList (AlignedBuffer, AlignedSize, &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+  Status = ConfigVarListIterInit (AlignedBuffer, AlignedSize, &Iterator);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  Status = ConfigVarListIterNext (&Iterator, &View);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+
+  // Unknown version
+  Hdr->Version = CONFIG_VAR_LIST_ALIGNED_VERSION + 1;
+  Status       = RetrieveActiveConfigVarList (AlignedBuffer, AlignedSize, &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_UNSUPPORTED);
+
+  FreePool (AlignedBuffer);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for RetrieveActiveConfigVarListWithBlobCrc.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RetrieveActiveConfigVarListWithBlobCrcTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY  *ConfigVarListPtr  = NULL;
+  UINTN                  ConfigVarListCount = 0;
+  UINTN                  AlignedSize;
+  VOID                   *AlignedBuffer;
+  EFI_STATUS             Status;
+  UINT32                 i = 0;
+
+  Status = RetrieveActiveConfigVarListWithBlobCrc (
+             mKnown_Good_Generic_Profile,
+             sizeof (mKnown_Good_Generic_Profile),
+             CalculateCrc32 (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile)),
+             &ConfigVarListPtr,
+             &ConfigVarListCount
+             );
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (ConfigVarListCount, 9);
+
+  for ( ; i < ConfigVarListCount; i++) {
+    // StrLen * 2 as we compare all bytes, not just number of Unicode chars
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Names[i], ConfigVarListPtr[i].Name, StrLen (mKnown_Good_VarList_Names[i]) * 2);
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], ConfigVarListPtr[i].DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], ConfigVarListPtr[i].Data, ConfigVarListPtr[i].DataSize);
+
+    FreePool (ConfigVarListPtr[i].Name);
+    FreePool (ConfigVarListPtr[i].Data);
+  }
+
+  FreePool (ConfigVarListPtr);
+
+  // The aligned format is covered by the blob CRC the same way
+  AlignedBuffer = BuildAlignedVarList (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), &AlignedSize);
+  UT_ASSERT_NOT_NULL (AlignedBuffer);
+
+  Status = RetrieveActiveConfigVarListWithBlobCrc (AlignedBuffer, AlignedSize, CalculateCrc32 (AlignedBuffer, AlignedSize), &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (ConfigVarListCount, 9);
+
+  for (i = 0; i < ConfigVarListCount; i++) {
+    FreePool (ConfigVarListPtr[i].Name);
+    FreePool (ConfigVarListPtr[i].Data);
+  }
+
+  FreePool (ConfigVarListPtr);
+  FreePool (AlignedBuffer);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for RetrieveActiveConfigVarListWithBlobCrc with a blob CRC that does not match,
+  and with per entry CRCs that are no longer checked once the blob CRC matches.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RetrieveActiveConfigVarListWithBlobCrcBadCrcTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY  *ConfigVarListPtr;
+  UINTN                  ConfigVarListCount;
+  UINT8                  *Buffer;
+  UINTN                  BufferSize;
+  UINT32                 BlobCrc32;
+  CONFIG_VAR_LIST_HDR    *VarList;
+  EFI_STATUS             Status;
+  UINT32                 i;
+
+  BufferSize = sizeof (mKnown_Good_Generic_Profile);
+  Buffer     = AllocateCopyPool (BufferSize, mKnown_Good_Generic_Profile);
+  UT_ASSERT_NOT_NULL (Buffer);
+  BlobCrc32 = CalculateCrc32 (Buffer, BufferSize);
+
+  // Wrong blob CRC
+  Status = RetrieveActiveConfigVarListWithBlobCrc (Buffer, BufferSize, BlobCrc32 ^ 1, &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+  UT_ASSERT_EQUAL (ConfigVarListCount, 0);
+  UT_ASSERT_EQUAL (ConfigVarListPtr, NULL);
+
+  // Corrupted data with the original blob CRC
+  Buffer[BufferSize / 2] ^= 0xFF;
+  Status                  = RetrieveActiveConfigVarListWithBlobCrc (Buffer, BufferSize, BlobCrc32, &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+  Buffer[BufferSize / 2] ^= 0xFF;
+
+  // A bad CRC on the first entry is only caught when checking entries
+  VarList = (CONFIG_VAR_LIST_HDR *)Buffer;
+  Buffer[sizeof (*VarList) + VarList->NameSize + sizeof (EFI_GUID) + sizeof (UINT32) + VarList->DataSize] ^= 0xFF;
+  BlobCrc32 = CalculateCrc32 (Buffer, BufferSize);
+
+  Status = RetrieveActiveConfigVarList (Buffer, BufferSize, &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+
+  Status = RetrieveActiveConfigVarListWithBlobCrc (Buffer, BufferSize, BlobCrc32, &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (ConfigVarListCount, 9);
+
+  for (i = 0; i < ConfigVarListCount; i++) {
+    FreePool (ConfigVarListPtr[i].Name);
+    FreePool (ConfigVarListPtr[i].Data);
+  }
+
+  FreePool (ConfigVarListPtr);
+  FreePool (Buffer);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for RetrieveActiveConfigVarListSingleAllocation.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RetrieveActiveConfigVarListSingleAllocationTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY  *ConfigVarListPtr  = NULL;
+  UINTN                  ConfigVarListCount = 0;
+  UINTN                  AlignedSize;
+  VOID                   *AlignedBuffer;
+  EFI_STATUS             Status;
+  UINT32                 i = 0;
+
+  Status = RetrieveActiveConfigVarListSingleAllocation (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (ConfigVarListCount, 9);
+
+  for ( ; i < ConfigVarListCount; i++) {
+    // StrLen * 2 as we compare all bytes, not just number of Unicode chars
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Names[i], ConfigVarListPtr[i].Name, StrLen (mKnown_Good_VarList_Names[i]) * 2);
+    if (i < 2) {
+      UT_ASSERT_MEM_EQUAL (&mKnown_Good_Yaml_Guid, &ConfigVarListPtr[i].Guid, sizeof (mKnown_Good_Yaml_Guid));
+      UT_ASSERT_EQUAL (3, ConfigVarListPtr[i].Attributes);
+    } else {
+      // Xml part of blob
+      UT_ASSERT_MEM_EQUAL (&mKnown_Good_Xml_Guid, &ConfigVarListPtr[i].Guid, sizeof (mKnown_Good_Xml_Guid));
+      UT_ASSERT_EQUAL (7, ConfigVarListPtr[i].Attributes);
+    }
+
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], ConfigVarListPtr[i].DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], ConfigVarListPtr[i].Data, ConfigVarListPtr[i].DataSize);
+
+    // Data is aligned within the allocation
+    UT_ASSERT_EQUAL ((UINTN)ConfigVarListPtr[i].Data % 8, 0);
+  }
+
+  // Names and data live in the same allocation, so only the list is freed
+  FreeConfigVarList (ConfigVarListPtr);
+
+  AlignedBuffer = BuildAlignedVarList (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), &AlignedSize);
+  UT_ASSERT_NOT_NULL (AlignedBuffer);
+
+  Status = RetrieveActiveConfigVarListSingleAllocation (AlignedBuffer, AlignedSize, &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (ConfigVarListCount, 9);
+
+  for (i = 0; i < ConfigVarListCount; i++) {
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Names[i], ConfigVarListPtr[i].Name, StrLen (mKnown_Good_VarList_Names[i]) * 2);
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], ConfigVarListPtr[i].DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], ConfigVarListPtr[i].Data, ConfigVarListPtr[i].DataSize);
+  }
+
+  FreeConfigVarList (ConfigVarListPtr);
+  FreePool (AlignedBuffer);
+
+  // Freeing nothing is allowed
+  FreeConfigVarList (NULL);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for RetrieveActiveConfigVarListSingleAllocation with bad inputs.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RetrieveActiveConfigVarListSingleAllocationBadDataTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY  *ConfigVarListPtr;
+  UINTN                  ConfigVarListCount;
+  UINT8                  *Buffer;
+  UINTN                  BufferSize;
+  EFI_STATUS             Status;
+
+  Status = RetrieveActiveConfigVarListSingleAllocation (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), NULL, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = RetrieveActiveConfigVarListSingleAllocation (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), &ConfigVarListPtr, NULL);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  Status = RetrieveActiveConfigVarListSingleAllocation (NULL, sizeof (mKnown_Good_Generic_Profile), &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+  UT_ASSERT_EQUAL (ConfigVarListCount, 0);
+  UT_ASSERT_EQUAL (ConfigVarListPtr, NULL);
+
+  BufferSize = sizeof (mKnown_Good_Generic_Profile);
+  Buffer     = AllocateCopyPool (BufferSize, mKnown_Good_Generic_Profile);
+  UT_ASSERT_NOT_NULL (Buffer);
+
+  // A corrupted last entry fails the sizing pass, nothing is returned
+  Buffer[BufferSize - 5] ^= 0xFF;
+  Status                  = RetrieveActiveConfigVarListSingleAllocation (Buffer, BufferSize, &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+  UT_ASSERT_EQUAL (ConfigVarListCount, 0);
+  UT_ASSERT_EQUAL (ConfigVarListPtr, NULL);
+  Buffer[BufferSize - 5] ^= 0xFF;
+
+  // Truncated last entry
+  Status = RetrieveActiveConfigVarListSingleAllocation (Buffer, BufferSize - 1, &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (ConfigVarListPtr, NULL);
+
+  FreePool (Buffer);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for RetrieveActiveConfigVarList, QuerySingleActiveConfigUnicodeVarList and
+  RetrieveDecompressedConfigVarList with a compressed variable list.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RetrieveActiveConfigVarListCompressedTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY  *ConfigVarListPtr  = NULL;
+  CONFIG_VAR_LIST_ENTRY  SingleEntry;
+  UINTN                  ConfigVarListCount = 0;
+  VOID                   *PackedBuffer;
+  UINTN                  PackedSize;
+  EFI_STATUS             Status;
+  UINT32                 i = 0;
+
+  UT_ASSERT_TRUE (IsCompressedConfigVarList (mKnown_Good_Compressed_Generic_Profile, sizeof (mKnown_Good_Compressed_Generic_Profile)));
+  UT_ASSERT_FALSE (IsCompressedConfigVarList (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile)));
+
+  // Expanded back to the exact packed bytes, CRCs included
+  Status = RetrieveDecompressedConfigVarList (mKnown_Good_Compressed_Generic_Profile, sizeof (mKnown_Good_Compressed_Generic_Profile), &PackedBuffer, &PackedSize);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (PackedSize, sizeof (mKnown_Good_Generic_Profile));
+  UT_ASSERT_MEM_EQUAL (mKnown_Good_Generic_Profile, PackedBuffer, PackedSize);
+  FreePool (PackedBuffer);
+
+  Status = RetrieveActiveConfigVarList (mKnown_Good_Compressed_Generic_Profile, sizeof (mKnown_Good_Compressed_Generic_Profile), &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (ConfigVarListCount, 9);
+
+  for ( ; i < ConfigVarListCount; i++) {
+    // StrLen * 2 as we compare all bytes, not just number of Unicode chars
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Names[i], ConfigVarListPtr[i].Name, StrLen (mKnown_Good_VarList_Names[i]) * 2);
+    if (i < 2) {
+      UT_ASSERT_MEM_EQUAL (&mKnown_Good_Yaml_Guid, &ConfigVarListPtr[i].Guid, sizeof (mKnown_Good_Yaml_Guid));
+      UT_ASSERT_EQUAL (3, ConfigVarListPtr[i].Attributes);
+    } else {
+      // Xml part of blob
+      UT_ASSERT_MEM_EQUAL (&mKnown_Good_Xml_Guid, &ConfigVarListPtr[i].Guid, sizeof (mKnown_Good_Xml_Guid));
+      UT_ASSERT_EQUAL (7, ConfigVarListPtr[i].Attributes);
+    }
+
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], ConfigVarListPtr[i].DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], ConfigVarListPtr[i].Data, ConfigVarListPtr[i].DataSize);
+
+    Status = QuerySingleActiveConfigUnicodeVarList (mKnown_Good_Compressed_Generic_Profile, sizeof (mKnown_Good_Compressed_Generic_Profile), mKnown_Good_VarList_Names[i], &SingleEntry);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], SingleEntry.DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], SingleEntry.Data, SingleEntry.DataSize);
+
+    FreePool (SingleEntry.Name);
+    FreePool (SingleEntry.Data);
+    FreePool (ConfigVarListPtr[i].Name);
+    FreePool (ConfigVarListPtr[i].Data);
+  }
+
+  FreePool (ConfigVarListPtr);
+
+  Status = QuerySingleActiveConfigUnicodeVarList (mKnown_Good_Compressed_Generic_Profile, sizeof (mKnown_Good_Compressed_Generic_Profile), L"NoSuchKnob", &SingleEntry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  Status = RetrieveActiveConfigVarListSingleAllocation (mKnown_Good_Compressed_Generic_Profile, sizeof (mKnown_Good_Compressed_Generic_Profile), &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (ConfigVarListCount, 9);
+
+  for (i = 0; i < ConfigVarListCount; i++) {
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Names[i], ConfigVarListPtr[i].Name, StrLen (mKnown_Good_VarList_Names[i]) * 2);
+    UT_ASSERT_EQUAL (mKnown_Good_VarList_DataSizes[i], ConfigVarListPtr[i].DataSize);
+    UT_ASSERT_MEM_EQUAL (mKnown_Good_VarList_Entries[i], ConfigVarListPtr[i].Data, ConfigVarListPtr[i].DataSize);
+  }
+
+  FreeConfigVarList (ConfigVarListPtr);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Recompute the CRC32 of a compressed variable list buffer, which covers its header with Crc32 taken as 0.
+
+  @param[in,out]  Buffer      Pointer to the compressed variable list buffer.
+  @param[in]      BufferSize  Size of Buffer.
+**/
+STATIC
+VOID
+UpdateCompressedConfigVarListCrc (
+  IN OUT UINT8  *Buffer,
+  IN     UINTN  BufferSize
+  )
+{
+  CONFIG_VAR_LIST_COMPRESSED_HDR  *Hdr;
+
+  Hdr        = (CONFIG_VAR_LIST_COMPRESSED_HDR *)Buffer;
+  Hdr->Crc32 = 0;
+  Hdr->Crc32 = CalculateCrc32 (Buffer, BufferSize);
+}
+
+/**
+  Unit test for RetrieveActiveConfigVarList, ConfigVarListStreamInit and ConfigVarListStreamNext with a corrupted
+  compressed variable list.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RetrieveActiveConfigVarListCompressedBadDataTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONFIG_VAR_LIST_ENTRY           *ConfigVarListPtr;
+  UINTN                           ConfigVarListCount;
+  CONFIG_VAR_LIST_ENTRY_VIEW      Entry;
+  CONFIG_VAR_LIST_STREAM          Stream;
+  CONFIG_VAR_LIST_COMPRESSED_HDR  *Hdr;
+  UINT8                           Buffer[sizeof (mKnown_Good_Compressed_Generic_Profile)];
+  UINT8                           Scratch[512];
+  UINTN                           ScratchSize;
+  VOID                            *PackedBuffer;
+  UINTN                           PackedSize;
+  EFI_STATUS                      Status;
+
+  CopyMem (Buffer, mKnown_Good_Compressed_Generic_Profile, sizeof (Buffer));
+  Hdr = (CONFIG_VAR_LIST_COMPRESSED_HDR *)Buffer;
+
+  // Corrupted data
+  Buffer[sizeof (Buffer) - 1] ^= 0xFF;
+  Status                       = RetrieveActiveConfigVarList (Buffer, sizeof (Buffer), &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+  UT_ASSERT_EQUAL (ConfigVarListCount, 0);
+  UT_ASSERT_EQUAL (ConfigVarListPtr, NULL);
+  Buffer[sizeof (Buffer) - 1] ^= 0xFF;
+
+  // Corrupted header
+  Hdr->EntryCount ^= 1;
+  Status           = RetrieveActiveConfigVarList (Buffer, sizeof (Buffer), &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+  Hdr->EntryCount ^= 1;
+
+  // Last entry record cut short, with a valid CRC
+  UpdateCompressedConfigVarListCrc (Buffer, sizeof (Buffer) - 1);
+  Status = RetrieveActiveConfigVarList (Buffer, sizeof (Buffer) - 1, &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+
+  // Every entry but the last streams fine before the record is found corrupted
+  ScratchSize = sizeof (Scratch);
+  Status      = ConfigVarListStreamInit (Buffer, sizeof (Buffer) - 1, Scratch, &ScratchSize, &Stream);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  for (ConfigVarListCount = 0; ConfigVarListCount < KNOWN_GOOD_TAG_COUNT - 1; ConfigVarListCount++) {
+    Status = ConfigVarListStreamNext (&Stream, &Entry);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+  }
+
+  Status = ConfigVarListStreamNext (&Stream, &Entry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+
+  // Dictionary size off, with a valid CRC
+  Hdr->DictionarySize += 1;
+  UpdateCompressedConfigVarListCrc (Buffer, sizeof (Buffer));
+  Status = RetrieveDecompressedConfigVarList (Buffer, sizeof (Buffer), &PackedBuffer, &PackedSize);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+  Hdr->DictionarySize -= 1;
+
+  // Scratch sizes larger than the whole packed list are rejected before the scratch size is returned
+  Hdr->MaxEntrySize = Hdr->PackedSize + 1;
+  UpdateCompressedConfigVarListCrc (Buffer, sizeof (Buffer));
+  ScratchSize = 0;
+  Status      = ConfigVarListStreamInit (Buffer, sizeof (Buffer), NULL, &ScratchSize, &Stream);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+  UT_ASSERT_EQUAL (ScratchSize, 0);
+
+  CopyMem (Buffer, mKnown_Good_Compressed_Generic_Profile, sizeof (Buffer));
+  Hdr->DictionarySize = Hdr->PackedSize + 1;
+  UpdateCompressedConfigVarListCrc (Buffer, sizeof (Buffer));
+  Status = ConfigVarListStreamInit (Buffer, sizeof (Buffer), NULL, &ScratchSize, &Stream);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+  UT_ASSERT_EQUAL (ScratchSize, 0);
+
+  CopyMem (Buffer, mKnown_Good_Compressed_Generic_Profile, sizeof (Buffer));
+
+  // Scratch too small
+  ScratchSize = 1;
+  Status      = ConfigVarListStreamInit (Buffer, sizeof (Buffer), Scratch, &ScratchSize, &Stream);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (ScratchSize, Hdr->MaxEntrySize + Hdr->DictionarySize);
+
+  // Not a compressed variable list
+  ScratchSize = sizeof (Scratch);
+  Status      = ConfigVarListStreamInit (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), Scratch, &ScratchSize, &Stream);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_UNSUPPORTED);
+
+  Status = RetrieveDecompressedConfigVarList (mKnown_Good_Generic_Profile, sizeof (mKnown_Good_Generic_Profile), &PackedBuffer, &PackedSize);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_UNSUPPORTED);
+
+  // The in place views cannot describe compressed entries
+  Status = QueryConfigVarListViewUnicode (Buffer, sizeof (Buffer), mKnown_Good_VarList_Names[0], NULL, &Entry);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_UNSUPPORTED);
+
+  // Unknown version, with a valid CRC
+  Hdr->Version = CONFIG_VAR_LIST_COMPRESSED_VERSION + 1;
+  UpdateCompressedConfigVarListCrc (Buffer, sizeof (Buffer));
+  Status       = RetrieveActiveConfigVarList (Buffer, sizeof (Buffer), &ConfigVarListPtr, &ConfigVarListCount);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_UNSUPPORTED);
+
+  return UNIT_TEST_PASSED;
+}
+
 /**
   Initialize the unit test framework, suite, and unit tests for the
   ConfigVariableListLib and run the ConfigVariableListLib unit test.
@@ -1223,6 +2397,34 @@ UnitTestingEntry (
   AddTestCase (ConfigVariableListLib, "Bad params should fail", "GetVarListSizeInvalidParam", GetVarListSizeInvalidParam, NULL, NULL, NULL);
   AddTestCase (ConfigVariableListLib, "Big inputs should overflow", "GetVarListSizeOverflow", GetVarListSizeOverflow, NULL, NULL, NULL);
 
+  // In place iteration
+  AddTestCase (ConfigVariableListLib, "Iterating entire config should succeed", "ConfigVarListIterateNormal", ConfigVarListIterateNormal, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Bad CRCed input buffer should fail", "ConfigVarListIterateBadCrc", ConfigVarListIterateBadCrc, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Bad sized input buffer should fail", "ConfigVarListIterateBadSize", ConfigVarListIterateBadSize, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Null inputs should fail", "ConfigVarListIterateNull", ConfigVarListIterateNull, NULL, NULL, NULL);
+
+  // Indexed query
+  AddTestCase (ConfigVariableListLib, "Indexed query should succeed", "ConfigVarListIndexQueryNormal", ConfigVarListIndexQueryNormal, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Bad name or namespace should fail", "ConfigVarListIndexQueryNotFound", ConfigVarListIndexQueryNotFound, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Bad CRCed input buffer should fail", "ConfigVarListIndexBuildBadCrc", ConfigVarListIndexBuildBadCrc, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Null inputs should fail", "ConfigVarListIndexNull", ConfigVarListIndexNull, NULL, NULL, NULL);
+
+  // Aligned variable list format
+  AddTestCase (ConfigVariableListLib, "Retrieve aligned config should succeed", "RetrieveActiveConfigVarListAlignedTest", RetrieveActiveConfigVarListAlignedTest, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Bad aligned data should fail", "RetrieveActiveConfigVarListAlignedBadDataTest", RetrieveActiveConfigVarListAlignedBadDataTest, NULL, NULL, NULL);
+
+  // Whole blob CRC
+  AddTestCase (ConfigVariableListLib, "Retrieve with matching blob CRC should succeed", "RetrieveActiveConfigVarListWithBlobCrcTest", RetrieveActiveConfigVarListWithBlobCrcTest, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Retrieve with mismatched blob CRC should fail", "RetrieveActiveConfigVarListWithBlobCrcBadCrcTest", RetrieveActiveConfigVarListWithBlobCrcBadCrcTest, NULL, NULL, NULL);
+
+  // Single allocation retrieval
+  AddTestCase (ConfigVariableListLib, "Retrieve into one allocation should succeed", "RetrieveActiveConfigVarListSingleAllocationTest", RetrieveActiveConfigVarListSingleAllocationTest, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Bad data into one allocation should fail", "RetrieveActiveConfigVarListSingleAllocationBadDataTest", RetrieveActiveConfigVarListSingleAllocationBadDataTest, NULL, NULL, NULL);
+
+  // Compressed variable list format
+  AddTestCase (ConfigVariableListLib, "Retrieve compressed config should succeed", "RetrieveActiveConfigVarListCompressedTest", RetrieveActiveConfigVarListCompressedTest, NULL, NULL, NULL);
+  AddTestCase (ConfigVariableListLib, "Bad compressed data should fail", "RetrieveActiveConfigVarListCompressedBadDataTest", RetrieveActiveConfigVarListCompressedBadDataTest, NULL, NULL, NULL);
+
   //
   // Execute the tests.
   //
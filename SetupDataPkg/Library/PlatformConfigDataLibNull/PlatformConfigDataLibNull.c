@@ -14,8 +14,49 @@ KNOB_DATA  gKnobData[1] = { 0 };
 
 UINTN  gNumKnobs = 0;
 
+CONFIG_POLICY_RANGE  gConfigPolicyRanges[1] = { 0 };
+
+UINTN  gNumConfigPolicies = 0;
+
 PROFILE  gProfileData[1] = { 0 };
 
 UINTN  gNumProfiles = 0;
 
 CHAR8  *gProfileFlavorNames[1] = { NULL };
+
+PROFILE_BITMAP  gProfileBitmapData[1] = { 0 };
+
+PROFILE_POLICY  gProfilePolicyData[1] = { 0 };
+
+KNOB_DATA *
+LookupKnobByName (
+  IN CONST EFI_GUID  *VendorNamespace,
+  IN CONST CHAR8     *Name
+  )
+{
+  return NULL;
+}
+
+BOOLEAN
+ValidateKnobValues (
+  IN CONST VOID  *KnobValues
+  )
+{
+  return TRUE;
+}
+
+BOOLEAN
+ApplyProfileBitmap (
+  IN CONST PROFILE_BITMAP  *Profile
+  )
+{
+  return FALSE;
+}
+
+CONST PROFILE_POLICY *
+GetProfilePolicy (
+  IN UINT32  ProfileIndex
+  )
+{
+  return NULL;
+}
@@ -276,6 +276,42 @@ SetOutputSettingsStatus (
   return EFI_SUCCESS;
 }
 
+/**
+Add the <FlashWrites> element to a ResultsPacket
+
+@param[in] ResultsPacketNode:  The <ResultsPacket> element node
+@param[in] FlashWrites:        Decimal string of the number of variable writes issued
+
+@retval Success if created and added to the xml successfully
+@retval Error if it could not be created or added to the xml
+**/
+EFI_STATUS
+EFIAPI
+AddResultsFlashWritesNode (
+  IN CONST XmlNode  *ResultsPacketNode,
+  IN CONST CHAR8    *FlashWrites
+  )
+{
+  EFI_STATUS  Status;
+
+  if ((ResultsPacketNode == NULL) || (FlashWrites == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  // Make sure its our expected node
+  if (AsciiStrnCmp (ResultsPacketNode->Name, RESULTS_PACKET_ELEMENT_NAME, sizeof (RESULTS_PACKET_ELEMENT_NAME)) != 0) {
+    DEBUG ((DEBUG_ERROR, "%a - ResultsPacketNode is not Results Packet Element\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = AddNode ((XmlNode *)ResultsPacketNode, RESULTS_FLASH_WRITES_ELEMENT_NAME, FlashWrites, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a - Failed to create FlashWrites node %r\n", __FUNCTION__, Status));
+  }
+
+  return Status;
+}
+
 ///// CURRENT SETTINGS
 
 XmlNode *
@@ -0,0 +1,574 @@
+/** @file
+SvdXmlSettingsReader.c
+
+Pull reader for the Settings Input XML, which yields one setting at a time from the packet
+buffer without building an XML tree or copying any of the packet.
+
+Only the subset of XML used by settings packets is understood: elements, attributes, comments,
+processing instructions and declarations. Text is returned as it appears in the packet, with
+surrounding whitespace removed and without entity decoding.
+
+Copyright (c) Microsoft Corporation.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <XmlTypes.h>
+
+#include <Library/DebugLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/SvdXmlSettingSchemaSupportLib.h>
+
+typedef struct {
+  CONST CHAR8    *Name;
+  UINTN          NameLength;
+  BOOLEAN        IsEnd;      // </Name>
+  BOOLEAN        IsEmpty;    // <Name/>
+  CONST CHAR8    *Text;      // Text between the previous markup and this tag
+  UINTN          TextLength;
+} SVD_XML_TAG;
+
+/**
+Check whether a character is XML whitespace.
+
+@param[in]  Char:   Character to check
+
+@retval TRUE if Char is whitespace.
+**/
+STATIC
+BOOLEAN
+SvdIsSpace (
+  IN CHAR8  Char
+  )
+{
+  return (BOOLEAN)((Char == ' ') || (Char == '\t') || (Char == '\r') || (Char == '\n'));
+}
+
+/**
+Check whether the buffer continues with a string at an offset.
+
+@param[in]  Buffer:       Buffer to check
+@param[in]  BufferSize:   Size of Buffer
+@param[in]  Offset:       Offset in Buffer, at most BufferSize
+@param[in]  String:       String to compare
+
+@retval TRUE if String is found at Offset.
+**/
+STATIC
+BOOLEAN
+SvdStartsWith (
+  IN CONST CHAR8  *Buffer,
+  IN UINTN        BufferSize,
+  IN UINTN        Offset,
+  IN CONST CHAR8  *String
+  )
+{
+  UINTN  Length;
+
+  Length = AsciiStrLen (String);
+  return (BOOLEAN)((BufferSize - Offset >= Length) && (CompareMem (Buffer + Offset, String, Length) == 0));
+}
+
+/**
+Find a string in the buffer, starting at an offset.
+
+@param[in]  Buffer:       Buffer to search
+@param[in]  BufferSize:   Size of Buffer
+@param[in]  Offset:       Offset to start the search at
+@param[in]  String:       String to search for
+
+@retval The offset of the string, or BufferSize if it is not found.
+**/
+STATIC
+UINTN
+SvdFind (
+  IN CONST CHAR8  *Buffer,
+  IN UINTN        BufferSize,
+  IN UINTN        Offset,
+  IN CONST CHAR8  *String
+  )
+{
+  for ( ; Offset < BufferSize; Offset++) {
+    if ((Buffer[Offset] == String[0]) && SvdStartsWith (Buffer, BufferSize, Offset, String)) {
+      return Offset;
+    }
+  }
+
+  return BufferSize;
+}
+
+/**
+Check whether a tag has the given element name.
+
+@param[in]  Tag:    Tag to check
+@param[in]  Name:   Element name
+
+@retval TRUE if the tag is for a Name element.
+**/
+STATIC
+BOOLEAN
+SvdTagIs (
+  IN CONST SVD_XML_TAG  *Tag,
+  IN CONST CHAR8        *Name
+  )
+{
+  return (BOOLEAN)((Tag->NameLength == AsciiStrLen (Name)) && (CompareMem (Tag->Name, Name, Tag->NameLength) == 0));
+}
+
+/**
+Read the next start, end or empty element tag, skipping comments, processing instructions and
+declarations. The text before the tag is returned with the tag.
+
+@param[in]      Buffer:       Packet buffer
+@param[in]      BufferSize:   Size of Buffer
+@param[in,out]  Offset:       Offset to read from, updated to just past the tag
+@param[out]     Tag:          The tag that was read
+
+@retval EFI_SUCCESS           Tag describes the next tag.
+@retval EFI_COMPROMISED_DATA  The packet ends before, or in the middle of, a tag.
+@retval EFI_UNSUPPORTED       The packet uses CDATA sections.
+**/
+STATIC
+EFI_STATUS
+SvdNextTag (
+  IN     CONST CHAR8  *Buffer,
+  IN     UINTN        BufferSize,
+  IN OUT UINTN        *Offset,
+  OUT    SVD_XML_TAG  *Tag
+  )
+{
+  UINTN  Start;
+  UINTN  End;
+  CHAR8  Quote;
+
+  while (TRUE) {
+    // Text up to the next markup, trimmed
+    Start = *Offset;
+    End   = SvdFind (Buffer, BufferSize, Start, "<");
+    if (End >= BufferSize) {
+      DEBUG ((DEBUG_ERROR, "%a - Unexpected end of packet at 0x%x\n", __FUNCTION__, Start));
+      return EFI_COMPROMISED_DATA;
+    }
+
+    *Offset = End;
+    while ((Start < End) && SvdIsSpace (Buffer[Start])) {
+      Start++;
+    }
+
+    while ((End > Start) && SvdIsSpace (Buffer[End - 1])) {
+      End--;
+    }
+
+    Tag->Text       = Buffer + Start;
+    Tag->TextLength = End - Start;
+
+    if (SvdStartsWith (Buffer, BufferSize, *Offset, "<!--")) {
+      End = SvdFind (Buffer, BufferSize, *Offset + 4, "-->");
+      if (End >= BufferSize) {
+        DEBUG ((DEBUG_ERROR, "%a - Unterminated comment at 0x%x\n", __FUNCTION__, *Offset));
+        return EFI_COMPROMISED_DATA;
+      }
+
+      *Offset = End + 3;
+      continue;
+    }
+
+    if (SvdStartsWith (Buffer, BufferSize, *Offset, "<![CDATA[")) {
+      DEBUG ((DEBUG_ERROR, "%a - CDATA at 0x%x is not supported\n", __FUNCTION__, *Offset));
+      return EFI_UNSUPPORTED;
+    }
+
+    if (SvdStartsWith (Buffer, BufferSize, *Offset, "<?") || SvdStartsWith (Buffer, BufferSize, *Offset, "<!")) {
+      End = SvdFind (Buffer, BufferSize, *Offset + 2, (Buffer[*Offset + 1] == '?') ? "?>" : ">");
+      if (End >= BufferSize) {
+        DEBUG ((DEBUG_ERROR, "%a - Unterminated declaration at 0x%x\n", __FUNCTION__, *Offset));
+        return EFI_COMPROMISED_DATA;
+      }
+
+      *Offset = End + ((Buffer[*Offset + 1] == '?') ? 2 : 1);
+      continue;
+    }
+
+    break;
+  }
+
+  // Element tag
+  End        = *Offset + 1;
+  Tag->IsEnd = FALSE;
+  if ((End < BufferSize) && (Buffer[End] == '/')) {
+    Tag->IsEnd = TRUE;
+    End++;
+  }
+
+  Tag->Name = Buffer + End;
+  while ((End < BufferSize) && !SvdIsSpace (Buffer[End]) && (Buffer[End] != '>') && (Buffer[End] != '/')) {
+    End++;
+  }
+
+  Tag->NameLength = (UINTN)(Buffer + End - Tag->Name);
+  if (Tag->NameLength == 0) {
+    DEBUG ((DEBUG_ERROR, "%a - Tag without a name at 0x%x\n", __FUNCTION__, *Offset));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  // Attributes are skipped, values may contain '>'
+  Quote = '\0';
+  for ( ; End < BufferSize; End++) {
+    if (Quote != '\0') {
+      if (Buffer[End] == Quote) {
+        Quote = '\0';
+      }
+    } else if ((Buffer[End] == '"') || (Buffer[End] == '\'')) {
+      Quote = Buffer[End];
+    } else if (Buffer[End] == '>') {
+      break;
+    }
+  }
+
+  if (End >= BufferSize) {
+    DEBUG ((DEBUG_ERROR, "%a - Unterminated tag at 0x%x\n", __FUNCTION__, *Offset));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  Tag->IsEmpty = (BOOLEAN)(!Tag->IsEnd && (Buffer[End - 1] == '/'));
+  *Offset      = End + 1;
+
+  return EFI_SUCCESS;
+}
+
+/**
+Skip the content and end tag of an element.
+
+@param[in]      Buffer:       Packet buffer
+@param[in]      BufferSize:   Size of Buffer
+@param[in,out]  Offset:       Offset just past the start tag, updated to just past the end tag
+@param[in]      StartTag:     The start tag of the element
+
+@retval EFI_SUCCESS           The element is skipped.
+@retval EFI_COMPROMISED_DATA  The element is not properly closed.
+**/
+STATIC
+EFI_STATUS
+SvdSkipElement (
+  IN     CONST CHAR8        *Buffer,
+  IN     UINTN              BufferSize,
+  IN OUT UINTN              *Offset,
+  IN     CONST SVD_XML_TAG  *StartTag
+  )
+{
+  EFI_STATUS   Status;
+  SVD_XML_TAG  Tag;
+  UINTN        Depth;
+
+  if (StartTag->IsEmpty) {
+    return EFI_SUCCESS;
+  }
+
+  Depth = 1;
+  while (Depth > 0) {
+    Status = SvdNextTag (Buffer, BufferSize, Offset, &Tag);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (Tag.IsEnd) {
+      Depth--;
+    } else if (!Tag.IsEmpty) {
+      Depth++;
+    }
+  }
+
+  if ((Tag.NameLength != StartTag->NameLength) || (CompareMem (Tag.Name, StartTag->Name, Tag.NameLength) != 0)) {
+    DEBUG ((DEBUG_ERROR, "%a - Mismatched end tag at 0x%x\n", __FUNCTION__, *Offset));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+Read the text of an element that only contains text.
+
+@param[in]      Buffer:       Packet buffer
+@param[in]      BufferSize:   Size of Buffer
+@param[in,out]  Offset:       Offset just past the start tag, updated to just past the end tag
+@param[in]      StartTag:     The start tag of the element
+@param[out]     Text:         Text of the element, not NULL terminated
+@param[out]     TextLength:   Length of Text
+
+@retval EFI_SUCCESS           Text is the content of the element.
+@retval EFI_COMPROMISED_DATA  The element contains other elements or is not properly closed.
+**/
+STATIC
+EFI_STATUS
+SvdReadTextElement (
+  IN     CONST CHAR8        *Buffer,
+  IN     UINTN              BufferSize,
+  IN OUT UINTN              *Offset,
+  IN     CONST SVD_XML_TAG  *StartTag,
+  OUT    CONST CHAR8        **Text,
+  OUT    UINTN              *TextLength
+  )
+{
+  EFI_STATUS   Status;
+  SVD_XML_TAG  Tag;
+
+  if (StartTag->IsEmpty) {
+    *Text       = StartTag->Name + StartTag->NameLength;
+    *TextLength = 0;
+    return EFI_SUCCESS;
+  }
+
+  Status = SvdNextTag (Buffer, BufferSize, Offset, &Tag);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (!Tag.IsEnd || (Tag.NameLength != StartTag->NameLength) || (CompareMem (Tag.Name, StartTag->Name, Tag.NameLength) != 0)) {
+    DEBUG ((DEBUG_ERROR, "%a - Element %.*a is expected to only contain text\n", __FUNCTION__, StartTag->NameLength, StartTag->Name));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  *Text       = Tag.Text;
+  *TextLength = Tag.TextLength;
+  return EFI_SUCCESS;
+}
+
+/**
+Convert decimal text that is not NULL terminated.
+
+@param[in]  Text:         Text to convert
+@param[in]  TextLength:   Length of Text
+@param[out] Value:        Converted value
+
+@retval EFI_SUCCESS           Value is updated.
+@retval EFI_COMPROMISED_DATA  Text is empty, not decimal or too large.
+**/
+STATIC
+EFI_STATUS
+SvdDecimalToUintn (
+  IN  CONST CHAR8  *Text,
+  IN  UINTN        TextLength,
+  OUT UINTN        *Value
+  )
+{
+  UINTN  Index;
+  UINTN  Result;
+
+  if (TextLength == 0) {
+    return EFI_COMPROMISED_DATA;
+  }
+
+  Result = 0;
+  for (Index = 0; Index < TextLength; Index++) {
+    if ((Text[Index] < '0') || (Text[Index] > '9') || (Result > (MAX_UINTN - (Text[Index] - '0')) / 10)) {
+      return EFI_COMPROMISED_DATA;
+    }
+
+    Result = Result * 10 + (Text[Index] - '0');
+  }
+
+  *Value = Result;
+  return EFI_SUCCESS;
+}
+
+/**
+Start reading a Settings Input XML packet.
+
+The whole packet structure is checked, and the Version and LowestSupportedVersion are read,
+but none of the settings are decoded until SvdSettingsReaderNext is called.
+
+@param[out] Reader:       Reader to initialize
+@param[in]  Buffer:       Packet buffer, must remain valid while the reader is in use
+@param[in]  BufferSize:   Size of Buffer, excluding any NULL terminator
+
+@retval EFI_SUCCESS           The reader is positioned before the first setting.
+@retval EFI_INVALID_PARAMETER An argument is NULL.
+@retval EFI_NOT_FOUND         The packet does not have a Version, LowestSupportedVersion or Settings element.
+@retval EFI_COMPROMISED_DATA  The packet is not well formed, or a version is not decimal.
+@retval EFI_UNSUPPORTED       The packet uses XML features not supported by the reader.
+**/
+EFI_STATUS
+EFIAPI
+SvdSettingsReaderInit (
+  OUT SVD_SETTINGS_READER  *Reader,
+  IN  CONST CHAR8          *Buffer,
+  IN  UINTN                BufferSize
+  )
+{
+  EFI_STATUS   Status;
+  SVD_XML_TAG  Tag;
+  UINTN        Offset;
+  CONST CHAR8  *Text;
+  UINTN        TextLength;
+  BOOLEAN      FoundVersion;
+  BOOLEAN      FoundLsv;
+  BOOLEAN      FoundSettings;
+
+  if ((Reader == NULL) || (Buffer == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ZeroMem (Reader, sizeof (*Reader));
+  Reader->Buffer     = Buffer;
+  Reader->BufferSize = BufferSize;
+
+  FoundVersion  = FALSE;
+  FoundLsv      = FALSE;
+  FoundSettings = FALSE;
+  Offset        = 0;
+
+  Status = SvdNextTag (Buffer, BufferSize, &Offset, &Tag);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (Tag.IsEnd || Tag.IsEmpty || (Tag.TextLength != 0) || !SvdTagIs (&Tag, SETTINGS_PACKET_ELEMENT_NAME)) {
+    DEBUG ((DEBUG_ERROR, "%a - Root element is not a Settings Packet Element\n", __FUNCTION__));
+    return EFI_NOT_FOUND;
+  }
+
+  // Only the first of each element counts, like FindFirstChildNodeByName
+  while (TRUE) {
+    Status = SvdNextTag (Buffer, BufferSize, &Offset, &Tag);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (Tag.IsEnd) {
+      break;
+    }
+
+    if (!FoundVersion && SvdTagIs (&Tag, SETTINGS_VERSION_ELEMENT_NAME)) {
+      Status = SvdReadTextElement (Buffer, BufferSize, &Offset, &Tag, &Text, &TextLength);
+      if (!EFI_ERROR (Status)) {
+        Status = SvdDecimalToUintn (Text, TextLength, &Reader->Version);
+      }
+
+      FoundVersion = TRUE;
+    } else if (!FoundLsv && SvdTagIs (&Tag, SETTINGS_LSV_ELEMENT_NAME)) {
+      Status = SvdReadTextElement (Buffer, BufferSize, &Offset, &Tag, &Text, &TextLength);
+      if (!EFI_ERROR (Status)) {
+        Status = SvdDecimalToUintn (Text, TextLength, &Reader->Lsv);
+      }
+
+      FoundLsv = TRUE;
+    } else if (!FoundSettings && SvdTagIs (&Tag, SETTINGS_LIST_ELEMENT_NAME)) {
+      // The settings are only walked for structure here, they are decoded by SvdSettingsReaderNext
+      Reader->SettingsOffset = Offset;
+      Reader->SettingsEmpty  = Tag.IsEmpty;
+      Status                 = SvdSkipElement (Buffer, BufferSize, &Offset, &Tag);
+      FoundSettings          = TRUE;
+    } else {
+      Status = SvdSkipElement (Buffer, BufferSize, &Offset, &Tag);
+    }
+
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a - Failed to read %.*a element - %r\n", __FUNCTION__, Tag.NameLength, Tag.Name, Status));
+      return Status;
+    }
+  }
+
+  if (!SvdTagIs (&Tag, SETTINGS_PACKET_ELEMENT_NAME)) {
+    DEBUG ((DEBUG_ERROR, "%a - Mismatched Settings Packet end tag\n", __FUNCTION__));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  if (!FoundVersion || !FoundLsv || !FoundSettings) {
+    DEBUG ((DEBUG_ERROR, "%a - Missing element, Version: %d LSV: %d Settings: %d\n", __FUNCTION__, FoundVersion, FoundLsv, FoundSettings));
+    return EFI_NOT_FOUND;
+  }
+
+  Reader->Offset = Reader->SettingsOffset;
+  return EFI_SUCCESS;
+}
+
+/**
+Read the next setting of a Settings Input XML packet.
+
+Don't free the outputs as they point into the packet buffer. They are not NULL terminated.
+
+@param[in,out]  Reader:       Reader initialized by SvdSettingsReaderInit
+@param[out]     Id:           Updated to point to the Id of the setting
+@param[out]     IdLength:     Length of Id
+@param[out]     Value:        Updated to point to the Value of the setting
+@param[out]     ValueLength:  Length of Value
+
+@retval EFI_SUCCESS           Id and Value describe the next setting.
+@retval EFI_INVALID_PARAMETER An argument is NULL.
+@retval EFI_NOT_FOUND         There are no more settings.
+@retval EFI_COMPROMISED_DATA  The next setting has no Id or Value, or is not well formed.
+**/
+EFI_STATUS
+EFIAPI
+SvdSettingsReaderNext (
+  IN OUT SVD_SETTINGS_READER  *Reader,
+  OUT    CONST CHAR8          **Id,
+  OUT    UINTN                *IdLength,
+  OUT    CONST CHAR8          **Value,
+  OUT    UINTN                *ValueLength
+  )
+{
+  EFI_STATUS   Status;
+  SVD_XML_TAG  Tag;
+  SVD_XML_TAG  Child;
+  UINTN        Offset;
+  BOOLEAN      FoundId;
+  BOOLEAN      FoundValue;
+
+  if ((Reader == NULL) || (Id == NULL) || (IdLength == NULL) || (Value == NULL) || (ValueLength == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Reader->SettingsEmpty) {
+    return EFI_NOT_FOUND;
+  }
+
+  Offset = Reader->Offset;
+  Status = SvdNextTag (Reader->Buffer, Reader->BufferSize, &Offset, &Tag);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  // The end of the Settings element, its structure was checked by SvdSettingsReaderInit
+  if (Tag.IsEnd) {
+    return EFI_NOT_FOUND;
+  }
+
+  FoundId    = FALSE;
+  FoundValue = FALSE;
+  while (!Tag.IsEmpty) {
+    Status = SvdNextTag (Reader->Buffer, Reader->BufferSize, &Offset, &Child);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (Child.IsEnd) {
+      break;
+    }
+
+    if (!FoundId && SvdTagIs (&Child, SETTING_ID_ELEMENT_NAME)) {
+      Status  = SvdReadTextElement (Reader->Buffer, Reader->BufferSize, &Offset, &Child, Id, IdLength);
+      FoundId = TRUE;
+    } else if (!FoundValue && SvdTagIs (&Child, SETTING_VALUE_ELEMENT_NAME)) {
+      Status     = SvdReadTextElement (Reader->Buffer, Reader->BufferSize, &Offset, &Child, Value, ValueLength);
+      FoundValue = TRUE;
+    } else {
+      Status = SvdSkipElement (Reader->Buffer, Reader->BufferSize, &Offset, &Child);
+    }
+
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  if (!FoundId || !FoundValue) {
+    DEBUG ((DEBUG_ERROR, "%a - Setting is missing its %a Element\n", __FUNCTION__, FoundId ? "Value" : "Id"));
+    return EFI_COMPROMISED_DATA;
+  }
+
+  Reader->Offset = Offset;
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,325 @@
+/** @file
+  Unit tests of the Settings Input XML reader in SvdXmlSettingSchemaSupportLib.
+
+  Copyright (c) Microsoft Corporation.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <Uefi.h>
+#include <XmlTypes.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/SvdXmlSettingSchemaSupportLib.h>
+
+#include <Library/UnitTestLib.h>
+#include <Good_Config_Data.h>
+
+#define UNIT_TEST_APP_NAME     "Svd Xml Settings Reader Unit Tests"
+#define UNIT_TEST_APP_VERSION  "1.0"
+
+// Formatted like SettingsPacket_Example.xml, with the Settings list before the versions
+#define FORMATTED_SETTINGS_XML                \
+  "<?xml version=\"1.0\" encoding=\"us-ascii\"?>\r\n" \
+  "<!-- Formatted packet -->\r\n"             \
+  "<SettingsPacket xmlns=\"urn:UefiSettings-Schema\">\r\n" \
+  "  <CreatedBy>UserName</CreatedBy>\r\n"     \
+  "  <Settings>\r\n"                          \
+  "    <Setting Type=\"Asset>Tag\">\r\n"      \
+  "      <!-- Asset Tag -->\r\n"              \
+  "      <Id>100</Id>\r\n"                    \
+  "      <Value>\r\n        7897897890\r\n      </Value>\r\n" \
+  "    </Setting>\r\n"                        \
+  "    <Setting><Value>MsOnly</Value><Extra><Id>1</Id></Extra><Id>200</Id></Setting>\r\n" \
+  "    <Setting><Id>300</Id><Value/></Setting>\r\n" \
+  "  </Settings>\r\n"                         \
+  "  <Version>12</Version>\r\n"               \
+  "  <LowestSupportedVersion> 3 </LowestSupportedVersion>\r\n" \
+  "</SettingsPacket>\r\n"
+
+/**
+  Check the next setting read from a reader.
+
+  @param[in]  Reader          Reader to read from.
+  @param[in]  ExpectedId      Expected Id.
+  @param[in]  ExpectedValue   Expected Value.
+
+  @retval  UNIT_TEST_PASSED             The setting matches.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+STATIC
+UNIT_TEST_STATUS
+CheckNextSetting (
+  IN SVD_SETTINGS_READER  *Reader,
+  IN CONST CHAR8          *ExpectedId,
+  IN CONST CHAR8          *ExpectedValue
+  )
+{
+  EFI_STATUS   Status;
+  CONST CHAR8  *Id;
+  CONST CHAR8  *Value;
+  UINTN        IdLength;
+  UINTN        ValueLength;
+
+  Status = SvdSettingsReaderNext (Reader, &Id, &IdLength, &Value, &ValueLength);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (IdLength, AsciiStrLen (ExpectedId));
+  UT_ASSERT_MEM_EQUAL (Id, ExpectedId, IdLength);
+  UT_ASSERT_EQUAL (ValueLength, AsciiStrLen (ExpectedValue));
+  UT_ASSERT_MEM_EQUAL (Value, ExpectedValue, ValueLength);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for reading the known good settings packet.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SvdSettingsReaderKnownGood (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SVD_SETTINGS_READER  Reader;
+  EFI_STATUS           Status;
+  CONST CHAR8          *Id;
+  CONST CHAR8          *Value;
+  UINTN                IdLength;
+  UINTN                ValueLength;
+
+  Status = SvdSettingsReaderInit (&Reader, KNOWN_GOOD_VARLIST_XML, sizeof (KNOWN_GOOD_VARLIST_XML) - 1);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Reader.Version, 1);
+  UT_ASSERT_EQUAL (Reader.Lsv, 1);
+
+  UT_ASSERT_EQUAL (CheckNextSetting (&Reader, "COMPLEX_KNOB1a", "HgAAAAkAAABDAE8ATQBQAEwARQBYAF8ASwBOAE8AQgAxAGEAAAD+PtSfsXNB7ZB2NWZh1GpCBgAAAAECAwQFAAAAAC9A3Vk="), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (CheckNextSetting (&Reader, "INTEGER_KNOB", "GgAAAAQAAABJAE4AVABFAEcARQBSAF8ASwBOAE8AQgAAAP4+1J+xc0HtkHY1ZmHUakIGAAAAZAAAAA/g+N8="), UNIT_TEST_PASSED);
+
+  // The end is sticky
+  Status = SvdSettingsReaderNext (&Reader, &Id, &IdLength, &Value, &ValueLength);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+  Status = SvdSettingsReaderNext (&Reader, &Id, &IdLength, &Value, &ValueLength);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for reading a formatted settings packet with comments, attributes and other elements.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SvdSettingsReaderFormatted (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SVD_SETTINGS_READER  Reader;
+  EFI_STATUS           Status;
+  CONST CHAR8          *Id;
+  CONST CHAR8          *Value;
+  UINTN                IdLength;
+  UINTN                ValueLength;
+  CONST CHAR8          *Packet;
+
+  Status = SvdSettingsReaderInit (&Reader, FORMATTED_SETTINGS_XML, sizeof (FORMATTED_SETTINGS_XML) - 1);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Reader.Version, 12);
+  UT_ASSERT_EQUAL (Reader.Lsv, 3);
+
+  UT_ASSERT_EQUAL (CheckNextSetting (&Reader, "100", "7897897890"), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (CheckNextSetting (&Reader, "200", "MsOnly"), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (CheckNextSetting (&Reader, "300", ""), UNIT_TEST_PASSED);
+
+  Status = SvdSettingsReaderNext (&Reader, &Id, &IdLength, &Value, &ValueLength);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  // An empty settings list has no settings
+  Packet = "<SettingsPacket><Version>1</Version><LowestSupportedVersion>1</LowestSupportedVersion><Settings/></SettingsPacket>";
+  Status = SvdSettingsReaderInit (&Reader, Packet, AsciiStrLen (Packet));
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  Status = SvdSettingsReaderNext (&Reader, &Id, &IdLength, &Value, &ValueLength);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unit test for rejecting malformed settings packets.
+
+  @param[in]  Context    [Optional] An optional parameter that enables:
+                         1) test-case reuse with varied parameters and
+                         2) test-case re-entry for Target tests that need a
+                         reboot.  This parameter is a VOID* and it is the
+                         responsibility of the test author to ensure that the
+                         contents are well understood by all test cases that may
+                         consume it.
+
+  @retval  UNIT_TEST_PASSED             The Unit test has completed and the test
+                                        case was successful.
+  @retval  UNIT_TEST_ERROR_TEST_FAILED  A test case assertion has failed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SvdSettingsReaderMalformed (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SVD_SETTINGS_READER  Reader;
+  EFI_STATUS           Status;
+  CONST CHAR8          *Id;
+  CONST CHAR8          *Value;
+  UINTN                IdLength;
+  UINTN                ValueLength;
+  CONST CHAR8          *Packet;
+
+  Status = SvdSettingsReaderInit (NULL, KNOWN_GOOD_VARLIST_XML, sizeof (KNOWN_GOOD_VARLIST_XML) - 1);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_INVALID_PARAMETER);
+
+  // Truncated anywhere
+  Status = SvdSettingsReaderInit (&Reader, KNOWN_GOOD_VARLIST_XML, sizeof (KNOWN_GOOD_VARLIST_XML) - 2);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+  Status = SvdSettingsReaderInit (&Reader, KNOWN_GOOD_VARLIST_XML, sizeof (KNOWN_GOOD_VARLIST_XML) / 2);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+
+  // Wrong root
+  Packet = "<ResultsPacket><Version>1</Version><LowestSupportedVersion>1</LowestSupportedVersion><Settings/></ResultsPacket>";
+  Status = SvdSettingsReaderInit (&Reader, Packet, AsciiStrLen (Packet));
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  // Missing LSV
+  Packet = "<SettingsPacket><Version>1</Version><Settings/></SettingsPacket>";
+  Status = SvdSettingsReaderInit (&Reader, Packet, AsciiStrLen (Packet));
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_NOT_FOUND);
+
+  // Version is not decimal
+  Packet = "<SettingsPacket><Version>0x1</Version><LowestSupportedVersion>1</LowestSupportedVersion><Settings/></SettingsPacket>";
+  Status = SvdSettingsReaderInit (&Reader, Packet, AsciiStrLen (Packet));
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+
+  // Mismatched end tag inside the settings
+  Packet = "<SettingsPacket><Version>1</Version><LowestSupportedVersion>1</LowestSupportedVersion><Settings><Setting></Settings></Setting></SettingsPacket>";
+  Status = SvdSettingsReaderInit (&Reader, Packet, AsciiStrLen (Packet));
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+
+  // Setting without a Value
+  Packet = "<SettingsPacket><Version>1</Version><LowestSupportedVersion>1</LowestSupportedVersion><Settings><Setting><Id>1</Id></Setting></Settings></SettingsPacket>";
+  Status = SvdSettingsReaderInit (&Reader, Packet, AsciiStrLen (Packet));
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  Status = SvdSettingsReaderNext (&Reader, &Id, &IdLength, &Value, &ValueLength);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+
+  // Value with an element inside
+  Packet = "<SettingsPacket><Version>1</Version><LowestSupportedVersion>1</LowestSupportedVersion><Settings><Setting><Id>1</Id><Value><b>1</b></Value></Setting></Settings></SettingsPacket>";
+  Status = SvdSettingsReaderInit (&Reader, Packet, AsciiStrLen (Packet));
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  Status = SvdSettingsReaderNext (&Reader, &Id, &IdLength, &Value, &ValueLength);
+  UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  sample unit tests and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+UnitTestingEntry (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      SettingsReader;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Populate the Settings Reader Unit Test Suite.
+  //
+  Status = CreateUnitTestSuite (&SettingsReader, Framework, "Svd Settings Reader Tests", "SvdXmlSettingSchemaSupportLib.Reader", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for SettingsReader\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // --------------Suite-----------Description--------------Name----------Function--------Pre---Post-------------------Context-----------
+  //
+  AddTestCase (SettingsReader, "Known good packet should be read", "SvdSettingsReaderKnownGood", SvdSettingsReaderKnownGood, NULL, NULL, NULL);
+  AddTestCase (SettingsReader, "Formatted packet should be read", "SvdSettingsReaderFormatted", SvdSettingsReaderFormatted, NULL, NULL, NULL);
+  AddTestCase (SettingsReader, "Malformed packets should fail", "SvdSettingsReaderMalformed", SvdSettingsReaderMalformed, NULL, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UnitTestingEntry ();
+}
@@ -1,6 +1,6 @@
 ##
 # This plugin generates setup data binary blobs
-# from platform supplied YAML configurations.
+# from platform supplied YAML or XML configurations.
 #
 # Copyright (c) Microsoft Corporation
 # SPDX-License-Identifier: BSD-2-Clause-Patent
@@ -8,6 +8,7 @@
 
 import logging
 import os
+import sys
 from edk2toolext.environment.plugintypes.uefi_build_plugin import IUefiBuildPlugin
 from edk2toollib.utility_functions import RunPythonScript
 
@@ -47,15 +48,62 @@ class GenSetupDataBin(IUefiBuildPlugin):
 
         return 0
 
+    # Generate all the profiles of a XML configuration in this process, from the XML schema and a CSV file per
+    # additional profile. The schema is parsed once, and the profiles are generated in parallel
+    def generate_xml_profiles(self, thebuilder, xml_file, delta_files, compressed=False):
+        op_dir = thebuilder.mws.join(thebuilder.ws, thebuilder.env.GetValue("BUILD_OUTPUT_BASE"), "ConfPolicy")
+        if not os.path.isdir(op_dir):
+            os.makedirs(op_dir)
+
+        tools_dir = thebuilder.mws.join(thebuilder.ws, "SetupDataPkg", "Tools")
+        if tools_dir not in sys.path:
+            sys.path.append(tools_dir)
+        from GenNCCfgData import generate_profile_binaries
+
+        # the generic profile comes first, every CSV file is applied to the defaults of the schema
+        profiles = []
+        for idx, csv_file in enumerate([None] + delta_files):
+            profiles.append((csv_file, os.path.join(op_dir, "ConfPolicyVarBin_" + str(idx) + ".bin")))
+
+        errors = generate_profile_binaries(xml_file, profiles, compressed=compressed)
+        if len(errors) != 0:
+            for error in errors:
+                logging.error(error)
+            return -1
+
+        for idx, (_, bin_file) in enumerate(profiles):
+            thebuilder.env.SetValue("BLD_*_CONF_BIN_FILE_" + str(idx), bin_file, "Plugin generated")
+
+        return 0
+
     # Attempt to run GenCfgData to generate setup data binary blob, output will be placed at
     # ConfPolicyVarBin_*.bin
     #
     # Consumes build environment variables:
     # "BUILD_OUTPUT_BASE": root of build output
-    # "YAML_CONF_FILE": absolute file path of a YAML configuration file
+    # "YAML_CONF_FILE": absolute file path of a YAML configuration file, or of a XML schema
     # "DELTA_CONF_POLICY": semicolon delimited list of absolute file paths for YAML delta files to be built as
     #                      additional profiles. Only valid if YAML_CONF_FILE is populated and multiple profiles desired.
+    #                      CSV files for a XML schema.
+    # "CONF_POLICY_COMPRESSED": "TRUE" to generate the profiles of a XML schema in the compressed variable list
+    #                           format, which ConfigVariableListLib expands or streams when reading them.
     def do_pre_build(self, thebuilder):
+        conf_file = thebuilder.env.GetValue("YAML_CONF_FILE")
+        if conf_file is not None and conf_file.lower().endswith(".xml"):
+            if not os.path.isfile(conf_file):
+                logging.error(f"XML schema file \"{conf_file}\" is not found")
+                return -1
+
+            delta_conf = thebuilder.env.GetValue("DELTA_CONF_POLICY")
+            if delta_conf is None:
+                logging.warn("DELTA_CONF_POLICY not set. Only generic profile generated.")
+                delta_conf = []
+            else:
+                delta_conf = delta_conf.split(";")
+
+            compressed = thebuilder.env.GetValue("CONF_POLICY_COMPRESSED", "FALSE").upper() == "TRUE"
+            return self.generate_xml_profiles(thebuilder, conf_file, delta_conf, compressed)
+
         # Generate Generic Profile
         ret = self.generate_profile(thebuilder, None, 0)
 
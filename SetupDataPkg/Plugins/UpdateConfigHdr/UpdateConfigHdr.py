@@ -6,6 +6,7 @@
 # SPDX-License-Identifier: BSD-2-Clause-Patent
 ##
 
+import hashlib
 import logging
 import os
 from edk2toolext.environment.plugintypes.uefi_build_plugin import IUefiBuildPlugin
@@ -14,10 +15,30 @@ from edk2toollib.utility_functions import RunPythonScript
 
 class UpdateConfigHdr(IUefiBuildPlugin):
 
+    # Records the hash of the generator inputs of the headers in the Generated dir
+    INPUTS_HASH_FILE_NAME = "ConfigGenerated.hash"
+
+    # Returns a hash of everything the generated headers depend on: the generator scripts, their parameters,
+    # the schema and the profile CSVs. Returns None when an input can't be read, so that the generator runs
+    # and reports the problem
+    @staticmethod
+    def get_inputs_hash(generator_files, params, input_files, working_dir):
+        inputs_hash = hashlib.sha256()
+        inputs_hash.update(" ".join(params).encode("utf-8"))
+        for input_file in generator_files + input_files:
+            try:
+                with open(os.path.join(working_dir, input_file), "rb") as f:
+                    inputs_hash.update(b"\0" + f.read())
+            except OSError:
+                return None
+
+        return inputs_hash.hexdigest()
+
     # Attempt to run GenCfgData to generate C header files
     #
     # Consumes build environment variables: "CONF_AUTOGEN_INCLUDE_PATH", "MU_SCHEMA_DIR",
-    # "MU_SCHEMA_FILE_NAME", "CONF_PROFILE_PATHS" and "CONF_PROFILE_NAMES"
+    # "MU_SCHEMA_FILE_NAME", "CONF_PROFILE_PATHS", "CONF_PROFILE_NAMES", "CONF_PROFILE_BITMAP",
+    # "CONF_PROFILE_POLICY_BLOBS", "CONF_POLICY_MAX_SIZE" and "CONF_CONSTRAINT_TABLE"
     def do_pre_build(self, thebuilder):
         default_generated_path = thebuilder.mws.join(thebuilder.ws, "SetupDataPkg", "Test", "Include")
 
@@ -56,6 +77,22 @@ class UpdateConfigHdr(IUefiBuildPlugin):
         # the profiles. This field is optional.
         profile_names = thebuilder.env.GetValue("CONF_PROFILE_NAMES", "")
 
+        # set to TRUE to encode the profiles as bitmaps applied with ApplyProfileBitmap, instead of
+        # the gProfileData KNOB_OVERRIDE arrays. This field is optional.
+        bitmap_profiles = thebuilder.env.GetValue("CONF_PROFILE_BITMAP", "FALSE")
+
+        # set to TRUE to also generate the ready to publish config policy of every profile, returned by
+        # GetProfilePolicy. This field is optional.
+        policy_blobs = thebuilder.env.GetValue("CONF_PROFILE_POLICY_BLOBS", "FALSE")
+
+        # the largest config policy in bytes, knobs beyond it are packed in additional config policies
+        # published under the next GUIDs of PcdConfigurationPolicyGuid. This field is optional.
+        policy_max_size = thebuilder.env.GetValue("CONF_POLICY_MAX_SIZE", "")
+
+        # set to TRUE to generate the knob validators from a single constraint table, along with
+        # ValidateKnobValues. This field is optional.
+        constraint_table = thebuilder.env.GetValue("CONF_CONSTRAINT_TABLE", "FALSE")
+
         params = ["generateheader_efi"]
 
         params.append(schema_file)
@@ -64,6 +101,13 @@ class UpdateConfigHdr(IUefiBuildPlugin):
         params.append("ConfigServiceGenerated.h")
         params.append("ConfigDataGenerated.h")
 
+        if constraint_table.upper() == "TRUE":
+            params.append("--constrainttable")
+
+        if policy_max_size != "":
+            params.append("--policysize")
+            params.append(policy_max_size)
+
         if profile_paths != "":
             params.append("ConfigProfilesGenerated.h")
             params.append(profile_paths)
@@ -72,5 +116,36 @@ class UpdateConfigHdr(IUefiBuildPlugin):
                 params.append("-pn")
                 params.append(profile_names)
 
+            if bitmap_profiles.upper() == "TRUE":
+                params.append("--bitmapprofiles")
+
+            if policy_blobs.upper() == "TRUE":
+                params.append("--policyblobs")
+
+        # Skip the generation when none of its inputs changed since the headers were last generated. KnobService
+        # also leaves headers with unchanged content untouched, so that dependent modules don't rebuild
+        tools_dir = os.path.dirname(cmd)
+        generator_files = [cmd, os.path.join(tools_dir, "VariableList.py")]
+        input_files = [schema_file] + profile_paths.split()
+        output_files = [param for param in params if param.endswith("Generated.h")]
+        hash_file = os.path.join(final_dir, self.INPUTS_HASH_FILE_NAME)
+
+        inputs_hash = self.get_inputs_hash(generator_files, params, input_files, final_dir)
+        if inputs_hash is not None and \
+           all(os.path.isfile(os.path.join(final_dir, output)) for output in output_files) and \
+           os.path.isfile(hash_file):
+            with open(hash_file, "r") as f:
+                if f.read().strip() == inputs_hash:
+                    logging.info("Config headers are up to date, skipping generation")
+                    return 0
+
+        # remove the hash first, so that a failed generation is retried by the next build
+        if os.path.isfile(hash_file):
+            os.remove(hash_file)
+
         ret = RunPythonScript(cmd, " ".join(params), workingdir=final_dir)
+        if ret == 0 and inputs_hash is not None:
+            with open(hash_file, "w") as f:
+                f.write(inputs_hash)
+
         return ret
@@ -79,6 +79,35 @@ UINT8  mKnown_Good_Generic_Profile[] = {
   0x96, 0x60, 0xF6
 };
 
+//
+// mKnown_Good_Generic_Profile in the compressed variable list format, as written by VariableList.py
+//
+UINT8  mKnown_Good_Compressed_Generic_Profile[] = {
+  0x43, 0x56, 0x4C, 0x5A, 0x02, 0x00, 0x20, 0x00, 0x09, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
+  0x5E, 0x01, 0x00, 0x00, 0x6A, 0x00, 0x00, 0x00, 0xA3, 0x02, 0x00, 0x00, 0xB6, 0xD4, 0xC7, 0xBB,
+  0x28, 0x9F, 0x55, 0x64, 0x76, 0x9E, 0x82, 0xE8, 0x48, 0xA4, 0x73, 0xF1, 0x2A, 0xDA, 0xD1, 0xDD,
+  0xD2, 0xFE, 0x3E, 0xD4, 0x9F, 0xB1, 0x73, 0x41, 0xED, 0x90, 0x76, 0x35, 0x66, 0x61, 0xD4, 0x6A,
+  0x42, 0x44, 0x00, 0x65, 0x00, 0x76, 0x00, 0x69, 0x00, 0x63, 0x80, 0x08, 0x08, 0x2E, 0x00, 0x43,
+  0x00, 0x6F, 0x00, 0x6E, 0x00, 0x66, 0x80, 0x10, 0x06, 0x67, 0x00, 0x44, 0x00, 0x61, 0x00, 0x74,
+  0x80, 0x04, 0x02, 0x2E, 0x00, 0x54, 0x80, 0x06, 0x02, 0x67, 0x00, 0x49, 0x80, 0x12, 0x02, 0x5F,
+  0x00, 0x30, 0x86, 0x02, 0x02, 0x32, 0x00, 0x38, 0x80, 0x06, 0x00, 0x00, 0x80, 0x16, 0xB5, 0x42,
+  0x00, 0x33, 0x82, 0x06, 0x00, 0x00, 0x80, 0x34, 0x0A, 0x4F, 0x00, 0x4D, 0x00, 0x50, 0x00, 0x4C,
+  0x00, 0x45, 0x00, 0x58, 0x80, 0x22, 0x02, 0x4B, 0x00, 0x4E, 0x80, 0x12, 0x02, 0x42, 0x00, 0x31,
+  0x80, 0x36, 0x99, 0x1E, 0x00, 0x62, 0x98, 0x1E, 0x00, 0x32, 0x80, 0x1C, 0x00, 0x49, 0x80, 0x0C,
+  0x00, 0x54, 0x80, 0x18, 0x00, 0x47, 0x80, 0x04, 0x00, 0x52, 0x88, 0x1C, 0x00, 0x00, 0x80, 0x04,
+  0x00, 0x4F, 0x80, 0x02, 0x81, 0x34, 0x00, 0x41, 0x80, 0x14, 0x89, 0x1A, 0x00, 0x44, 0x80, 0x08,
+  0x00, 0x55, 0x80, 0x0A, 0x81, 0x1C, 0x89, 0x18, 0x00, 0x46, 0x80, 0x12, 0x00, 0x4F, 0x80, 0x2E,
+  0x00, 0x54, 0x8A, 0x16, 0x00, 0x00, 0x42, 0x03, 0x08, 0x04, 0x43, 0x43, 0x76, 0x31, 0x00, 0x80,
+  0x01, 0x00, 0x42, 0x42, 0x03, 0x04, 0x03, 0x01, 0x00, 0x00, 0x00, 0x01, 0x84, 0x01, 0x1E, 0x07,
+  0x09, 0x05, 0x01, 0x02, 0x03, 0x04, 0x05, 0x00, 0x80, 0x01, 0x01, 0xA2, 0x01, 0x1E, 0x07, 0x09,
+  0x08, 0x01, 0x02, 0x03, 0x04, 0x05, 0x01, 0x00, 0x00, 0x00, 0x01, 0xC0, 0x01, 0x1C, 0x07, 0x16,
+  0x08, 0x02, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x80, 0x08, 0x06, 0x00, 0x06, 0x07,
+  0x08, 0x09, 0x0A, 0x01, 0x80, 0x09, 0x01, 0xDC, 0x01, 0x1A, 0x07, 0x04, 0x03, 0x64, 0x00, 0x00,
+  0x00, 0x01, 0xF6, 0x01, 0x1A, 0x07, 0x01, 0x00, 0x01, 0x01, 0x90, 0x02, 0x18, 0x07, 0x08, 0x07,
+  0x4A, 0xD8, 0x12, 0x4D, 0xFB, 0x21, 0x09, 0x40, 0x01, 0xA8, 0x02, 0x16, 0x07, 0x04, 0x03, 0xF4,
+  0xFD, 0xB4, 0x3F
+};
+
 UINT8  mKnown_Good_VarList_Entries[KNOWN_GOOD_TAG_COUNT][KNOWN_GOOD_TAG_MAX_LEN] = {
   { 0x43, 0x43, 0x76, 0x31, 0x00, 0x00, 0x00, 0x00 },
   { 0x01, 0x00, 0x00, 0x00 },
@@ -10,15 +10,25 @@
 #define SETUPDATAPKG_UNIT_TEST_STRUCTS_H_
 
 #include <Uefi.h>
+#include <PiPei.h>
 
 typedef struct _PPI_STATUS {
   VOID          *Ppi;
   EFI_STATUS    Status;
+  // Incremented by the mock on every locate, so tests can check how often the PPI database is walked
+  UINTN         LocateCount;
 } PPI_STATUS;
 
 typedef struct _MM_PROTOCOL_STATUS {
   VOID          *Protocol;
   EFI_STATUS    Status;
+  // Incremented by the mock on every locate, so tests can check how often the protocol database is walked
+  UINTN         LocateCount;
 } MM_PROTOCOL_STATUS;
 
+typedef struct _MOCK_GUID_HOB {
+  EFI_HOB_GUID_TYPE    Header;
+  UINT64               Data[32];
+} MOCK_GUID_HOB;
+
 #endif // SETUPDATAPKG_UNIT_TEST_STRUCTS_H_
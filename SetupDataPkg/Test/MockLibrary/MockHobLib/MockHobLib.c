@@ -0,0 +1,80 @@
+/** @file
+  Mocked version of HobLib for SetupDataPkg unit tests.
+
+  The HOB list is backed by a single MOCK_GUID_HOB owned by the test, so each test starts from a clean list.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <PiPei.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/UnitTestLib.h>
+#include <SetupDataPkgUnitTestStructs.h>
+
+/**
+  Mock finding the first instance of a HOB with a given GUID.
+
+  Returns the MOCK_GUID_HOB provided by the test if it has been built with a matching GUID.
+
+  @param  Guid          The GUID to match with in the HOB list.
+
+  @return The first GUID HOB instance that matches the GUID, or NULL if none is found.
+
+**/
+VOID *
+EFIAPI
+GetFirstGuidHob (
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  MOCK_GUID_HOB  *GuidHob = (MOCK_GUID_HOB *)mock ();
+
+  if ((GuidHob == NULL) || (GuidHob->Header.Header.HobType != EFI_HOB_TYPE_GUID_EXTENSION) ||
+      !CompareGuid (&GuidHob->Header.Name, Guid))
+  {
+    return NULL;
+  }
+
+  return GuidHob;
+}
+
+/**
+  Mock building a GUID HOB with a certain data length.
+
+  Fills in the MOCK_GUID_HOB provided by the test and returns its data buffer.
+
+  @param  Guid          The GUID to tag the customized HOB.
+  @param  DataLength    The size of the data payload for the GUID HOB.
+
+  @return The start address of GUID HOB data, or NULL if the test did not provide a HOB or it is too small.
+
+**/
+VOID *
+EFIAPI
+BuildGuidHob (
+  IN CONST EFI_GUID  *Guid,
+  IN UINTN           DataLength
+  )
+{
+  MOCK_GUID_HOB  *GuidHob = (MOCK_GUID_HOB *)mock ();
+
+  if ((GuidHob == NULL) || (DataLength > sizeof (GuidHob->Data))) {
+    return NULL;
+  }
+
+  GuidHob->Header.Header.HobType   = EFI_HOB_TYPE_GUID_EXTENSION;
+  GuidHob->Header.Header.HobLength = (UINT16)(sizeof (EFI_HOB_GUID_TYPE) + DataLength);
+  CopyGuid (&GuidHob->Header.Name, Guid);
+
+  return GuidHob->Data;
+}
@@ -42,6 +42,28 @@ PeiServicesLocatePpi (
 {
   PPI_STATUS  *PpiStatus = (PPI_STATUS *)mock ();
 
+  PpiStatus->LocateCount++;
   *Ppi = PpiStatus->Ppi;
   return PpiStatus->Status;
 }
+
+/**
+  This service enables PEIMs to register a given service to be invoked when another service is
+  installed or reinstalled.
+
+  The notification list is accepted but never dispatched in unit tests.
+
+  @param  NotifyList            A pointer to the list of notification interfaces
+                                that the caller shall install.
+
+  @retval EFI_SUCCESS           The interface was successfully installed.
+
+**/
+EFI_STATUS
+EFIAPI
+PeiServicesNotifyPpi (
+  IN CONST EFI_PEI_NOTIFY_DESCRIPTOR  *NotifyList
+  )
+{
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,273 @@
+# @file
+#
+# Classify variable list (.vl) dumps, e.g. saved by ReadUefiVarsToConfVarList.py, by the
+# profile they most closely match, and summarize the drift of each knob from those profiles
+#
+# Copyright (c), Microsoft Corporation
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+
+import os
+import sys
+import csv
+import uuid
+import logging
+import argparse
+from concurrent.futures import ProcessPoolExecutor
+from VariableList import Schema, Profile, load_profiles, iter_vlist_entries, get_vlist_entry_key
+
+# Name of the candidate holding the schema defaults, as for the generic profile of KnobService
+GENERIC_PROFILE_NAME = "Generic"
+
+
+def option_parser():
+    parser = argparse.ArgumentParser()
+
+    parser.add_argument(
+        "-x",
+        "--xml",
+        dest="configuration_file",
+        required=True,
+        type=str,
+        help="""Specify the schema XML of the dumps""",
+    )
+
+    parser.add_argument(
+        "-p",
+        "--profiles",
+        dest="profile_files",
+        nargs="*",
+        default=[],
+        type=str,
+        help="""Specify the profile CSVs to match the dumps against, in the order of gProfileData""",
+    )
+
+    parser.add_argument(
+        "-pn",
+        "--profilenames",
+        dest="profile_names",
+        type=str,
+        default=None,
+        help="""Specify the comma separated flavor names of the profiles, the CSV names by default""",
+    )
+
+    parser.add_argument(
+        "-o",
+        "--output",
+        dest="output_file",
+        type=str,
+        default="classification.csv",
+        help="""Specify the CSV the profile matched by each dump is written to""",
+    )
+
+    parser.add_argument(
+        "-d",
+        "--drift",
+        dest="drift_file",
+        type=str,
+        default="drift.csv",
+        help="""Specify the CSV the drift of each knob is written to""",
+    )
+
+    parser.add_argument(
+        "-j",
+        "--jobs",
+        dest="jobs",
+        type=int,
+        default=None,
+        help="""Specify the number of dumps classified in parallel, the processor count by default""",
+    )
+
+    parser.add_argument(
+        "dumps",
+        nargs="+",
+        help="""Specify the .vl dumps to classify, or folders of them""",
+    )
+
+    arguments = parser.parse_args()
+
+    if not os.path.isfile(arguments.configuration_file):
+        print("Invalid input file: %s" % arguments.configuration_file)
+        sys.exit(1)
+
+    return arguments
+
+
+#
+# The data each profile expects for each knob of a schema. The knobs are keyed by their raw
+# variable list entry guid and name, and each knob maps the data it can hold to the bitmask
+# of the profiles expecting that data, so a dump entry is scored against every profile with
+# a single lookup
+#
+class ProfileTable:
+    def __init__(self, schema, profiles):
+        self.names = [profile.name for profile in profiles]
+        self.knobs = []
+        self.entries = {}
+
+        profile_values = [profile.get_values(schema) for profile in profiles]
+        for index, knob in enumerate(schema.knobs):
+            values = {}
+            for bit, knob_values in enumerate(profile_values):
+                data = knob.format.object_to_binary(knob_values[index][1])
+                values[data] = values.get(data, 0) | (1 << bit)
+
+            key = get_vlist_entry_key(uuid.UUID(knob.namespace).bytes_le, knob.name.encode("UTF-16LE"))
+            self.entries[key] = (index, values)
+            self.knobs.append((knob.namespace, knob.name))
+
+    #
+    # Score a variable list buffer against every profile in a single pass over its entries
+    # return a tuple of the index of the closest profile, the matching knob count of each
+    # profile, the indices of the knobs differing from the closest profile and the indices
+    # of the knobs missing from the dump
+    #
+    def classify(self, vlist):
+        matches = {}
+        with memoryview(vlist) as view:
+            for guid, name, _, data in iter_vlist_entries(view):
+                entry = self.entries.get(get_vlist_entry_key(guid, name))
+                if entry is not None:
+                    (index, values) = entry
+                    matches[index] = values.get(bytes(data), 0)
+
+        scores = [0] * len(self.names)
+        for mask in matches.values():
+            while mask:
+                bit = mask & -mask
+                scores[bit.bit_length() - 1] += 1
+                mask ^= bit
+
+        # ties go to the first profile, in the order of gProfileData
+        best = scores.index(max(scores))
+        drifted = [index for index, mask in matches.items() if not (mask >> best) & 1]
+        missing = [index for index in range(len(self.knobs)) if index not in matches]
+        return (best, scores, drifted, missing)
+
+
+# The profile table of a worker process
+_profile_table = None
+
+
+def _init_classify_worker(table):
+    global _profile_table
+    _profile_table = table
+
+
+def _classify_dump(dump_file):
+    try:
+        with open(dump_file, "rb") as dump:
+            return (_profile_table.classify(dump.read()), None)
+    except Exception as e:
+        return (None, str(e))
+
+
+#
+# Classify a list of dumps against a profile table, with the dumps read and scored in parallel
+# in a pool of worker processes that are each handed the table once
+# return the list of (classification, error string) of the dumps, in the order of the dumps
+#
+def classify_dumps(table, dump_files, max_workers=None):
+    if len(dump_files) <= 1:
+        _init_classify_worker(table)
+        return [_classify_dump(dump_file) for dump_file in dump_files]
+
+    with ProcessPoolExecutor(max_workers=max_workers, initializer=_init_classify_worker,
+                             initargs=(table,)) as executor:
+        return list(executor.map(_classify_dump, dump_files, chunksize=16))
+
+
+#
+# Expand the folders of a list of dumps into the .vl files they hold
+#
+def find_dump_files(paths):
+    dump_files = []
+    for path in paths:
+        if os.path.isdir(path):
+            for subdir, _, files in os.walk(path):
+                dump_files.extend(os.path.join(subdir, file) for file in sorted(files) if file.endswith(".vl"))
+        else:
+            dump_files.append(path)
+    return dump_files
+
+
+def write_classification(output_file, table, dump_files, results):
+    with open(output_file, "w", newline="") as csv_file:
+        writer = csv.writer(csv_file)
+        writer.writerow(["Dump", "Profile", "MatchedKnobs", "DriftedKnobs", "MissingKnobs", "Error"])
+        for dump_file, (classification, error) in zip(dump_files, results):
+            if classification is None:
+                writer.writerow([dump_file, "", "", "", "", error])
+                continue
+
+            (best, scores, drifted, missing) = classification
+            writer.writerow([
+                dump_file,
+                table.names[best],
+                scores[best],
+                " ".join(table.knobs[index][1] for index in drifted),
+                len(missing),
+                ""])
+
+
+def write_drift(drift_file, table, results):
+    drifted_counts = [0] * len(table.knobs)
+    missing_counts = [0] * len(table.knobs)
+    for classification, _ in results:
+        if classification is not None:
+            for index in classification[2]:
+                drifted_counts[index] += 1
+            for index in classification[3]:
+                missing_counts[index] += 1
+
+    with open(drift_file, "w", newline="") as csv_file:
+        writer = csv.writer(csv_file)
+        writer.writerow(["Guid", "Knob", "DriftedDumps", "MissingDumps"])
+        for index, (namespace, name) in enumerate(table.knobs):
+            writer.writerow([namespace, name, drifted_counts[index], missing_counts[index]])
+
+
+#
+# main script function
+#
+def main():
+    arguments = option_parser()
+
+    schema = Schema.load(arguments.configuration_file)
+
+    names = None
+    if arguments.profile_names is not None:
+        names = arguments.profile_names.split(",")
+        if len(names) != len(arguments.profile_files):
+            print("The profile names count does not match the profiles count")
+            return 1
+
+    profiles = load_profiles(schema, arguments.profile_files, names, arguments.jobs)
+    profiles.append(Profile(GENERIC_PROFILE_NAME, []))
+    table = ProfileTable(schema, profiles)
+
+    dump_files = find_dump_files(arguments.dumps)
+    results = classify_dumps(table, dump_files, arguments.jobs)
+
+    write_classification(arguments.output_file, table, dump_files, results)
+    write_drift(arguments.drift_file, table, results)
+
+    # Summarize the dump count of each profile
+    counts = [0] * len(table.names)
+    failed = 0
+    for dump_file, (classification, error) in zip(dump_files, results):
+        if classification is None:
+            logging.error(f"Failed to classify {dump_file}: {error}")
+            failed += 1
+        else:
+            counts[classification[0]] += 1
+
+    for name, count in zip(table.names, counts):
+        print(f"{name}: {count} dumps")
+    if failed:
+        print(f"{failed} dumps failed to classify")
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
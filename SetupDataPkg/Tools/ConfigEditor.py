@@ -163,6 +163,8 @@ class validating_entry(tkinter.Entry):
 class custom_table(ttk.Treeview):
     _Padding = 20
     _Char_width = 6
+    # Rows shown at once, longer tables scroll within the widget
+    _Max_visible_rows = 32
 
     def __init__(self, parent, col_hdr, bins):
         cols = len(col_hdr)
@@ -178,6 +180,9 @@ class custom_table(ttk.Treeview):
         self.cols = cols
         self.col_byte_len = col_byte_len
         self.col_hdr = col_hdr
+        # byte offset of each column within a row
+        self.row_byte_len = sum(col_byte_len)
+        self.col_offset = [sum(col_byte_len[:col]) for col in range(cols)]
 
         self.size = len(bins)
         self.last_dir = ""
@@ -189,7 +194,7 @@ class custom_table(ttk.Treeview):
         ttk.Treeview.__init__(
             self,
             parent,
-            height=rows,
+            height=min(rows, custom_table._Max_visible_rows),
             columns=[""] + col_hdr,
             show="headings",
             style="Custom.Treeview",
@@ -220,7 +225,7 @@ class custom_table(ttk.Treeview):
             for col in range(cols):  # Columns
                 if idx >= len(bins):
                     break
-                byte_len = int(col_hdr[col].split(":")[1])
+                byte_len = col_byte_len[col]
                 value = bytes_to_value(bins[idx: idx + byte_len])
                 hex = ("%%0%dX" % (byte_len * 2)) % value
                 vals.append(hex)
@@ -246,13 +251,11 @@ class custom_table(ttk.Treeview):
 
         # Reload binary into widget
         bin_len = len(bins)
-        for row in range(self.rows):
-            iid = self.get_children()[row]
+        for row, iid in enumerate(self.get_children()):
             for col in range(self.cols):
-                idx = row * sum(self.col_byte_len) + sum(self.col_byte_len[:col])
+                idx = row * self.row_byte_len + self.col_offset[col]
                 byte_len = self.col_byte_len[col]
                 if idx + byte_len <= self.size:
-                    byte_len = int(self.col_hdr[col].split(":")[1])
                     if idx + byte_len > bin_len:
                         val = 0
                     else:
@@ -271,7 +274,7 @@ class custom_table(ttk.Treeview):
         if col > self.cols:
             col = 1
             row += 1
-        cnt = row * sum(self.col_byte_len) + sum(self.col_byte_len[:col])
+        cnt = row * self.row_byte_len + sum(self.col_byte_len[:col])
         if cnt > self.size:
             # Reached the last cell, so roll back to beginning
             row = 0
@@ -337,12 +340,13 @@ class custom_table(ttk.Treeview):
         row_ids = self.get_children()
         for row_id in row_ids:
             row = int("0x" + row_id[1:], 0) - 1
+            row_values = self.item(row_id, "values")
             for col in range(self.cols):
-                idx = row * sum(self.col_byte_len) + sum(self.col_byte_len[:col])
+                idx = row * self.row_byte_len + self.col_offset[col]
                 byte_len = self.col_byte_len[col]
                 if idx + byte_len > self.size:
                     break
-                hex = self.item(row_id, "values")[col + 1]
+                hex = row_values[col + 1]
                 values = value_to_bytes(
                     int(hex, 16) & ((1 << byte_len * 8) - 1), byte_len
                 )
@@ -382,6 +386,11 @@ class application(tkinter.Frame):
         # this maps page id to cfg_data index, needed for when user changes pages
         # self.page_cfg_map[page_id] = cfg_data_idx
         self.page_cfg_map = {}
+        # the items of the current page, of which only the first page_items_built have widgets.
+        # The others are built as they are scrolled into view
+        self.page_items = []
+        self.page_items_built = 0
+        self.page_build_pending = False
 
         # Check if current directory contains a file with a .yaml extension
         # if not default self.last_dir to a Platform directory where it is
@@ -447,7 +456,7 @@ class application(tkinter.Frame):
 
         self.conf_canvas = tkinter.Canvas(frame_right, highlightthickness=0)
         self.page_scroll = ttk.Scrollbar(
-            frame_right, orient="vertical", command=self.conf_canvas.yview
+            frame_right, orient="vertical", command=self.on_page_scroll_bar
         )
         self.right_grid = ttk.Frame(self.conf_canvas)
         self.conf_canvas.configure(yscrollcommand=self.page_scroll.set)
@@ -562,6 +571,10 @@ class application(tkinter.Frame):
 
     def on_canvas_configure(self, event):
         self.right_grid.grid_columnconfigure(0, minsize=event.width)
+        # a taller page may show items that are not built yet
+        if not self.page_build_pending:
+            self.page_build_pending = True
+            self.after_idle(self.build_visible_config_items)
 
     def on_tree_scroll(self, event):
         if not self.in_left.get() and self.in_right.get():
@@ -576,6 +589,11 @@ class application(tkinter.Frame):
             min, max = self.page_scroll.get()
             if not ((min == 0.0) and (max == 1.0)):
                 self.conf_canvas.yview_scroll(-1 * int(event.delta / 120), "units")
+                self.build_visible_config_items()
+
+    def on_page_scroll_bar(self, *args):
+        self.conf_canvas.yview(*args)
+        self.build_visible_config_items()
 
     def update_visibility_for_widget(self, widget, args):
 
@@ -656,6 +674,7 @@ class application(tkinter.Frame):
             self.build_config_data_page(page_id)
             self.update_widgets_visibility_on_page()
             self.update_page_scroll_bar()
+            self.build_visible_config_items()
 
     def walk_widgets_in_layout(self, parent, callback_function, args=None):
         for widget in parent.winfo_children():
@@ -670,14 +689,15 @@ class application(tkinter.Frame):
 
         parent.grid_forget()
         self.conf_list.clear()
+        self.page_items = []
+        self.page_items_built = 0
 
     def build_config_page_tree(self, cfg_page, parent, file_id):
         for page in cfg_page["child"]:
             page_id = next(iter(page))
-            # Put CFG items into related page list
+            # The CFG items of the page are only listed when the page is first shown
             self.page_cfg_map[page_id] = file_id
-            self.page_list[page_id] = self.cfg_data_list[file_id].cfg_data_obj.get_cfg_list(page_id)
-            self.page_list[page_id].sort(key=lambda x: x["order"])
+            self.page_list.pop(page_id, None)
             page_name = self.cfg_data_list[file_id].cfg_data_obj.get_page_title(page_id)
             child = self.left.insert(
                 parent, "end", iid=page_id, text=page_name, value=0
@@ -686,7 +706,7 @@ class application(tkinter.Frame):
                 self.build_config_page_tree(page[page_id], child, file_id)
 
     def is_config_data_loaded(self):
-        return True if len(self.page_list) else False
+        return True if len(self.page_cfg_map) else False
 
     def set_current_config_page(self, page_id):
         self.page_id = page_id
@@ -696,22 +716,41 @@ class application(tkinter.Frame):
 
     def get_current_config_data(self):
         page_id = self.get_current_config_page()
-        if page_id in self.page_list:
-            return self.page_list[page_id]
-        else:
+        if page_id not in self.page_cfg_map:
             return []
 
+        if page_id not in self.page_list:
+            # Put CFG items into related page list
+            file_id = self.page_cfg_map[page_id]
+            self.page_list[page_id] = self.cfg_data_list[file_id].cfg_data_obj.get_cfg_list(page_id)
+            self.page_list[page_id].sort(key=lambda x: x["order"])
+        return self.page_list[page_id]
+
     def build_config_data_page(self, page_id):
         self.clear_widgets_inLayout()
         self.set_current_config_page(page_id)
-        disp_list = []
-        for item in self.get_current_config_data():
-            disp_list.append(item)
-        row = 0
-        disp_list.sort(key=lambda x: x["order"])
-        for item in disp_list:
-            self.add_config_item(item, row, self.page_cfg_map[page_id])
-            row += 2
+        self.page_items = self.get_current_config_data()
+        self.page_items_built = 0
+        self.add_config_items_on_page()
+
+    def add_config_items_on_page(self, count=64):
+        # Build the widgets of the next items of the page, returns False once all of them are built
+        if self.page_items_built >= len(self.page_items):
+            return False
+
+        file_id = self.page_cfg_map[self.get_current_config_page()]
+        end = min(len(self.page_items), self.page_items_built + count)
+        for idx in range(self.page_items_built, end):
+            self.add_config_item(self.page_items[idx], idx * 2, file_id)
+        self.page_items_built = end
+        return True
+
+    def build_visible_config_items(self):
+        # Keep building items while the end of the page is in view
+        self.page_build_pending = False
+        while self.conf_canvas.yview()[1] >= 0.9 and self.add_config_items_on_page():
+            self.update_widgets_visibility_on_page()
+            self.update_page_scroll_bar()
 
     def load_config_data(self, file_name):
         if file_name.endswith('.xml'):
@@ -843,6 +882,8 @@ class application(tkinter.Frame):
             self.clear_widgets_inLayout()
             self.left.delete(*self.left.get_children())
             self.cfg_data_list = {}
+            self.page_list = {}
+            self.page_cfg_map = {}
 
         self.cfg_data_list[file_id] = cfg_data()
 
@@ -1057,7 +1098,7 @@ class application(tkinter.Frame):
 
     def get_config_data_item_from_widget(self, widget, label=False):
         name, file_id = self.get_object_name(widget)
-        if not name or not len(self.page_list):
+        if not name or not len(self.page_cfg_map):
             return None
 
         if name.startswith("LABEL_"):
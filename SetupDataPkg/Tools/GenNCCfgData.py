@@ -6,9 +6,11 @@
 #
 ##
 
+import os
 import sys
 import re
 from collections import OrderedDict
+from concurrent.futures import ProcessPoolExecutor
 import base64
 
 from SettingSupport.DFCI_SupportLib import DFCI_SupportLib  # noqa: E402
@@ -22,15 +24,33 @@ from VariableList import (
     StructFormat,
     ArrayFormat,
     vlist_to_binary,
+    Profile,
+    vlist_to_aligned_binary,
     read_vlist_from_buffer,
     uefi_variables_to_knobs,
     write_csv,
     read_csv,
     create_vlist_buffer,
-    get_delta_vlist
+    get_delta_vlist,
+    diff_vlists,
+    decode_knob_deltas,
+    write_knob_delta_csv
 )
 
 
+# An item of the shim between the ConfigEditor UI and the schema. The value string of the item
+# is only formatted when it is first read, as most items are never displayed, and then kept
+# until sync_shim_and_schema
+class CCfgItem(OrderedDict):
+    def __missing__(self, key):
+        if key != "value":
+            raise KeyError(key)
+        data = self["inst"]
+        value = data.format.object_to_string(data.value)
+        self["value"] = value
+        return value
+
+
 class CGenNCCfgData:
     def __init__(self, file_name):
         self.load_xml(file_name)
@@ -54,13 +74,12 @@ class CGenNCCfgData:
             # return full list
             return self.knob_shim
         else:
-            # build a new list for items under a page ID
-            cfgs = [
-                i
-                for i in self.knob_shim
-                if (".".join(i["path"].split(".")[:2]) == page_id)
-            ]
-            return cfgs
+            # build a new list for items under a page ID, the pages being indexed on first use
+            if self._page_index is None:
+                self._page_index = {}
+                for i in self.knob_shim:
+                    self._page_index.setdefault(".".join(i["path"].split(".")[:2]), []).append(i)
+            return list(self._page_index.get(page_id, []))
 
     def get_cfg_page(self):
         return self._cfg_page
@@ -96,6 +115,8 @@ class CGenNCCfgData:
         if item is None:
             raise Exception("Cannot accept item being None for xml parser!!!")
         subknob = item["inst"]
+        # the value string of the item is kept until the next sync, so format it before the change
+        item["value"]
         subknob.value = subknob.format.string_to_object(value_str)
         new_value = subknob.format.object_to_string(subknob.value)
         return new_value
@@ -126,17 +147,13 @@ class CGenNCCfgData:
         return None
 
     def get_item_by_path(self, path):
-        for each in self.knob_shim:
-            path_list = path.split(".")
-            namespace = path_list[0]
-            var_path = ".".join(path_list[1:])
-            if (
-                each["inst"].knob.namespace == namespace
-                and each["inst"].name == var_path
-                and each["inst"].leaf is True
-            ):
-                return each
-        return None
+        # the leaf items are indexed by path on first use, the first item of a path winning
+        if self._path_index is None:
+            self._path_index = {}
+            for each in self.knob_shim:
+                if each["inst"].leaf is True:
+                    self._path_index.setdefault(each["path"], each)
+        return self._path_index.get(path)
 
     def add_cfg_page(self, child, parent, title=""):
         def _add_cfg_page(cfg_page, child, parent):
@@ -177,7 +194,7 @@ class CGenNCCfgData:
         for idx, data in enumerate(self.schema.subknobs):
             itype = type(data.format)
             name = data.name
-            ord_dict = OrderedDict()
+            ord_dict = CCfgItem()
             if itype is IntValueFormat:
                 ord_dict["type"] = "INTEGER_KNOB"
             elif itype is FloatValueFormat:
@@ -196,7 +213,6 @@ class CGenNCCfgData:
             ord_dict["order"] = idx
             ord_dict["name"] = name
             ord_dict["cname"] = name
-            ord_dict["value"] = data.format.object_to_string(data.value)
             ord_dict["path"] = ".".join([data.knob.namespace, name])
             ord_dict["help"] = data.help
             ret_list.append(ord_dict)
@@ -204,9 +220,9 @@ class CGenNCCfgData:
         return ret_list
 
     def sync_shim_and_schema(self):
+        # drop the cached value strings, so they are formatted again from the schema when read
         for shim in self.knob_shim:
-            data = shim["inst"]
-            shim["value"] = data.format.object_to_string(data.value)
+            shim.pop("value", None)
 
     def generate_delta_svd_from_bin(self, old_data, new_data):
         # return list of UEFI vars in buffers that have changed data and list of names of vars
@@ -268,9 +284,14 @@ class CGenNCCfgData:
 
         return bin
 
-    def generate_binary(self, bin_file_name):
+    def generate_binary(self, bin_file_name, aligned=False, compressed=False):
         bin_file = open(bin_file_name, "wb")
-        bin_file.write(self.generate_binary_array(True))
+        if aligned:
+            bin_file.write(vlist_to_aligned_binary(self.schema))
+        elif compressed:
+            bin_file.write(vlist_to_binary(self.schema, compressed=True))
+        else:
+            bin_file.write(self.generate_binary_array(True))
         bin_file.close()
         return 0
 
@@ -310,9 +331,85 @@ class CGenNCCfgData:
             knob.value = knob.default
 
         self.knob_shim = self.build_cfg_list()
+        self._page_index = None
+        self._path_index = None
         return 0
 
 
+# The schema the profile binaries of a worker process are generated from
+_profile_schema = None
+
+
+def _init_profile_worker(schema):
+    global _profile_schema
+    _profile_schema = schema
+
+
+def _generate_profile_binary(csv_file, bin_file, compressed=False):
+    # the profile is applied to the knob defaults without touching the shared schema
+    if csv_file:
+        profile = Profile.load(_profile_schema, csv_file)
+    else:
+        profile = Profile("", [])
+
+    with open(bin_file, "wb") as bin_out:
+        bin_out.write(profile.to_binary(_profile_schema, compressed))
+
+
+# Generates the variable list binaries of a set of profiles of a XML schema, given as a list of
+# (CsvFile or None for the schema defaults, BinOutFile). The schema is loaded once, and then handed
+# to a pool of worker processes that generate the profiles in parallel, in the compressed variable
+# list format if requested. Returns the list of errors, in the order of the profiles, which is empty
+# when every profile was generated
+def generate_profile_binaries(xml_file, profiles, max_workers=None, compressed=False):
+    schema = Schema.load(xml_file)
+
+    errors = []
+    with ProcessPoolExecutor(max_workers=max_workers, initializer=_init_profile_worker,
+                             initargs=(schema,)) as executor:
+        futures = [executor.submit(_generate_profile_binary, csv_file, bin_file, compressed)
+                   for csv_file, bin_file in profiles]
+        for (csv_file, bin_file), future in zip(profiles, futures):
+            try:
+                future.result()
+            except Exception as e:
+                errors.append("Failed to generate '{}' from '{}': {}".format(bin_file, csv_file or xml_file, e))
+
+    return errors
+
+
+# Compares each dump variable list against one baseline variable list, or the schema defaults when no baseline
+# is given. For each dump, the knobs that differ are written with their dump values to the "<dump name>.csv"
+# of out_dir, and a summary line is printed. Returns the list of errors, in the order of the dumps
+def generate_delta_files(xml_file, baseline_file, dump_files, out_dir):
+    schema = Schema.load(xml_file)
+    if baseline_file:
+        with open(baseline_file, "rb") as baseline_in:
+            baseline = baseline_in.read()
+    else:
+        baseline = Profile("", []).to_binary(schema)
+
+    os.makedirs(out_dir, exist_ok=True)
+
+    errors = []
+    for dump_file in dump_files:
+        try:
+            with open(dump_file, "rb") as dump_in:
+                deltas = diff_vlists(baseline, dump_in.read())
+
+            knob_deltas = decode_knob_deltas(schema, deltas)
+            csv_file = os.path.join(out_dir, os.path.splitext(os.path.basename(dump_file))[0] + ".csv")
+            write_knob_delta_csv(csv_file, knob_deltas)
+
+            changed = sum(1 for (_, _, value) in knob_deltas if value is not None)
+            print("%s: %d knobs differ, %d knobs missing, %d other variables differ" % (
+                dump_file, changed, len(knob_deltas) - changed, len(deltas) - len(knob_deltas)))
+        except Exception as e:
+            errors.append("Failed to compare '{}' to '{}': {}".format(dump_file, baseline_file or xml_file, e))
+
+    return errors
+
+
 def usage():
     print(
         "\n".join(
@@ -320,7 +417,10 @@ def usage():
                 "GenNCCfgData Version 0.1",
                 "Usage:",
                 "    GenNCCfgData  GENBIN  XmlFile[;CsvFile]   BinOutFile",
+                "    GenNCCfgData  GENALIGNEDBIN  XmlFile[;CsvFile]   BinOutFile",
+                "    GenNCCfgData  GENCOMPRESSEDBIN  XmlFile[;CsvFile]   BinOutFile",
                 "    GenNCCfgData  GENCSV  XmlFile[;BinFile]   CsvOutFile",
+                "    GenNCCfgData  GENDELTA  XmlFile[;BaselineBinFile]   DumpBinFile[;DumpBinFile...]   CsvOutDir",
             ]
         )
     )
@@ -334,6 +434,18 @@ def main():
         return 1
 
     command = sys.argv[1].upper()
+    if command == "GENDELTA":
+        if argc != 5:
+            usage()
+            return 1
+
+        file_list = sys.argv[2].split(";")
+        baseline_file = file_list[1] if len(file_list) >= 2 else ""
+        errors = generate_delta_files(file_list[0], baseline_file, sys.argv[3].split(";"), sys.argv[4])
+        for error in errors:
+            print("ERROR: " + error)
+        return 1 if errors else 0
+
     out_file = sys.argv[3]
 
     file_list = sys.argv[2].split(";")
@@ -376,6 +488,12 @@ def main():
 
         gen_cfg_data.generate_binary(out_file)
 
+    elif command == "GENALIGNEDBIN":
+        gen_cfg_data.generate_binary(out_file, aligned=True)
+
+    elif command == "GENCOMPRESSEDBIN":
+        gen_cfg_data.generate_binary(out_file, compressed=True)
+
     elif command == "GENCSV":
         gen_cfg_data.generate_csv_file(out_file, cfg_bin_file, cfg_bin_file2)
 
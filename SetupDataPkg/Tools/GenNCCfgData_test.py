@@ -9,8 +9,10 @@
 import unittest
 import copy
 import os
+import tempfile
 
-from GenNCCfgData import CGenNCCfgData
+from GenNCCfgData import CGenNCCfgData, generate_profile_binaries
+from VariableList import decompress_vlist
 
 
 class UncoreCfgUnitTests(unittest.TestCase):
@@ -313,6 +315,80 @@ class UncoreCfgUnitTests(unittest.TestCase):
         for each in cdata.knob_shim:
             self.assertEqual(each['value'], each['inst'].format.object_to_string(each['inst'].value))
 
+    def test_xml_generate_profile_binaries(self):
+        if os.path.exists("sampleschema.xml"):
+            # Load for local testing
+            sample_path = "sampleschema.xml"
+        elif os.path.exists("SetupDataPkg/Tools/sampleschema.xml"):
+            # Load for Linux CI
+            sample_path = "SetupDataPkg/Tools/sampleschema.xml"
+        else:
+            # Load for Windows CI
+            sample_path = "SetupDataPkg\\Tools\\sampleschema.xml"
+
+        with tempfile.TemporaryDirectory() as temp_dir:
+            csv_path = os.path.join(temp_dir, "profile.csv")
+            with open(csv_path, "w") as csv_file:
+                csv_file.write("Guid,Knob,Value\nFE3ED49F-B173-41ED-9076-356661D46A42,INTEGER_KNOB,1234\n")
+
+            profiles = [(None, os.path.join(temp_dir, "ConfPolicyVarBin_0.bin")),
+                        (csv_path, os.path.join(temp_dir, "ConfPolicyVarBin_1.bin")),
+                        (os.path.join(temp_dir, "missing.csv"), os.path.join(temp_dir, "ConfPolicyVarBin_2.bin")),
+                        (None, os.path.join(temp_dir, "ConfPolicyVarBin_3.bin"))]
+            errors = generate_profile_binaries(sample_path, profiles, 2)
+
+            # Only the profile with a missing CSV fails, and the others are still generated
+            self.assertEqual(len(errors), 1)
+            self.assertIn("missing.csv", errors[0])
+
+            # The binaries match the ones generated one at a time
+            cdata = CGenNCCfgData(sample_path)
+            with open(profiles[0][1], "rb") as bin_file:
+                self.assertEqual(bin_file.read(), cdata.generate_binary_array(True))
+            with open(profiles[3][1], "rb") as bin_file:
+                self.assertEqual(bin_file.read(), cdata.generate_binary_array(True))
+
+            cdata.override_default_value(csv_path)
+            with open(profiles[1][1], "rb") as bin_file:
+                self.assertEqual(bin_file.read(), cdata.generate_binary_array(True))
+
+            # The compressed binaries expand to the same variable lists
+            compressed_profiles = [(csv_file, bin_file + ".cvlz") for csv_file, bin_file in profiles[:2]]
+            self.assertEqual(generate_profile_binaries(sample_path, compressed_profiles, 2, compressed=True), [])
+            for (_, bin_path), (_, compressed_path) in zip(profiles, compressed_profiles):
+                with open(bin_path, "rb") as bin_file, open(compressed_path, "rb") as compressed_file:
+                    self.assertEqual(decompress_vlist(compressed_file.read()), bin_file.read())
+
+    # The value strings of the items are formatted on first use, and only updated on sync
+    def test_xml_cfg_item_value_cache(self):
+        if os.path.exists("sampleschema.xml"):
+            # Load for local testing
+            sample_path = "sampleschema.xml"
+        elif os.path.exists("SetupDataPkg/Tools/sampleschema.xml"):
+            # Load for Linux CI
+            sample_path = "SetupDataPkg/Tools/sampleschema.xml"
+        else:
+            # Load for Windows CI
+            sample_path = "SetupDataPkg\\Tools\\sampleschema.xml"
+
+        cdata = CGenNCCfgData(sample_path)
+
+        for each in cdata.knob_shim:
+            self.assertNotIn('value', each)
+
+        ret = cdata.get_item_by_path('FE3ED49F-B173-41ED-9076-356661D46A42.INTEGER_KNOB')
+        self.assertIs(ret, cdata.get_cfg_list('FE3ED49F-B173-41ED-9076-356661D46A42.INTEGER_KNOB')[0])
+        self.assertEqual(ret['value'], ret['inst'].format.object_to_string(ret['inst'].value))
+        self.assertIn('value', ret)
+
+        # A value changed behind the shim shows after a sync
+        ret['inst'].value = 1234
+        self.assertNotEqual(ret['value'], '1234')
+        cdata.sync_shim_and_schema()
+        self.assertEqual(ret['value'], '1234')
+
+        with self.assertRaises(KeyError):
+            ret['missing']
 
 if __name__ == '__main__':
     unittest.main()
@@ -1,1255 +1,2723 @@
-# @ KnobService.py
-#
-# Generates C header files for a firmware component to consume UEFI variables
-# as configurable knobs
-#
-# Copyright (c) 2022, Microsoft Corporation. All rights reserved.
-#
-import os
-import sys
-import uuid
-import argparse
-import re
-import VariableList
-
-
-# Converts a type name from standard C to UEFI
-def get_type_string(type_name, uefi=False):
-    uefi_type = {
-        "int8_t": "INT8",
-        "int16_t": "INT16",
-        "int32_t": "INT32",
-        "int64_t": "INT64",
-        "uint8_t": "UINT8",
-        "uint16_t": "UINT16",
-        "uint32_t": "UINT32",
-        "uint64_t": "UINT64",
-        "bool": "BOOLEAN",
-        "float": "float",
-        "double": "double",
-        "size_t": "UINTN",
-        "int": "INTN",
-        "const": "CONST",
-        "void*": "VOID *",
-        "char*": "CHAR8 *",
-        "config_guid_t": "EFI_GUID",
-        "void": "VOID"
-    }
-    if uefi:
-        if type_name in uefi_type:
-            return uefi_type[type_name]
-
-    return type_name
-
-
-# Converts a value from standard C to UEFI
-def get_value_string(value, uefi=False):
-    if value == "true" and uefi:
-        return "TRUE"
-    elif value == "false" and uefi:
-        return "FALSE"
-    else:
-        return value
-
-
-# UEFI uses 2 spaces, stdlibc uses 4 spaces
-def get_spacing_string(uefi=False, num=1):
-    spaces = ""
-    for i in range(0, num):
-        if uefi is True:
-            spaces += "  "
-        else:
-            spaces += "    "
-
-    return spaces
-
-
-# UEFI style uses CRLF line endings
-def get_line_ending(uefi=False):
-    if uefi is True:
-        return "\r\n"
-
-    return "\n"
-
-
-# UEFI style uses #ifdef instead of pragma once
-def get_include_once_style(name, uefi=False, header=True):
-    if uefi is True:
-        # convert . to _
-        while match := re.search(r'\.', name):
-            name = name[:match.start()] + "_" + name[match.end():]
-        if header is True:
-            return "#ifndef " + name.upper() + get_line_ending(uefi) + "#define " + name.upper() + get_line_ending(uefi)
-        else:
-            return "#endif // " + name.upper() + get_line_ending(uefi)
-    elif header is True:
-        return "#pragma once" + get_line_ending(uefi)
-    else:
-        return get_line_ending(uefi)
-
-
-# Convert std libc variable/structure/type naming conventions to UEFI naming conventions
-def naming_convention_filter(value, type, uefi=False):
-    if not uefi:
-        return value
-
-    if type is True:
-        # types will be in format THIS_IS_THE_TYPE_NAME
-        # std libc likes to append '_t' to type names, strip that for UEFI
-        if value[-2:] == "_t":
-            value = value[:-2]
-        return value.upper()
-    else:
-        # fields and functions will be in format ThisIsTheName
-
-        # if the first char is an underscore, strip it
-        if value[0] == "_":
-            value = value[1:]
-
-        # capitalize first word (may be single word)
-        value = value[0].upper() + value[1:]
-
-        # remove any trailing underscore
-        if value[-1] == "_":
-            value = value[:-1]
-
-        # remove the underscores and capitalize each word
-        while match := re.search("_", value):
-            value = value[:match.start()] + value[match.end()].upper() + value[match.end() + 1:]
-
-    return value
-
-
-# return proper assert style for efi/non-efi builds
-def get_assert_style(uefi, assert_string, msg):
-    if uefi is True:
-        return "STATIC_ASSERT" + assert_string + ", " + msg + ");"
-
-    return "C_ASSERT" + assert_string + ");"
-
-
-# put a SPDX header on the generated files
-def get_spdx_header(header, efi_type):
-    spdx = "/** @file {}".format(header)
-    spdx += get_line_ending(efi_type) + get_line_ending(efi_type)
-    spdx += get_spacing_string(efi_type)
-    spdx += "Autogenerated configuration headers from mu_feature_config"
-    spdx += get_line_ending(efi_type) + get_line_ending(efi_type)
-    spdx += get_spacing_string(efi_type)
-    spdx += "Copyright (c) Microsoft Corporation."
-    spdx += get_line_ending(efi_type)
-    spdx += get_spacing_string(efi_type)
-    spdx += "SPDX-License-Identifier: BSD-2-Clause-Patent"
-    spdx += get_line_ending(efi_type)
-    spdx += get_line_ending(efi_type)
-    spdx += "**/"
-    spdx += get_line_ending(efi_type)
-    spdx += get_line_ending(efi_type)
-    return spdx
-
-
-# for UEFI, calculate what variable list size is for a given knob
-def get_variable_list_size(knob):
-    # fixed size per knob is Guid, Attributes, CRC, NameSize, DataSize
-    # we have to calculate the c sizes, not the bloated python sizes
-    # hence why __sizeof__() is not used here
-    size = 16 + 4 + 4 + 4 + 4
-
-    # variable size per knob is len of data and name
-    # the name we convert from schema ASCII to UEFI unicode
-    # And + 1 is to account for null terminator
-    size += (len(knob.name) + 1) * 2
-    size += knob.format.size_in_bytes()
-
-    return size
-
-
-# in UEFI builds we need to know what the size of the variable list constructed
-# from this data will be. Return value in bytes
-def get_conf_policy_size(schema):
-    size = 0
-    for knob in schema.knobs:
-        size += get_variable_list_size(knob)
-
-    return size
-
-
-# write getter implementations. In stdlibc projects this is part of the data header
-# for UEFI, this is separate from the data header
-def write_uefi_getter_implementations(efi_type, out, schema):
-    out.write("// Schema-defined knobs" + get_line_ending(efi_type))
-    offset = 0
-    for knob in schema.knobs:
-        out.write("// {} knob".format(knob.name) + get_line_ending(efi_type))
-        if knob.help != "":
-            out.write("// {}".format(knob.help) + get_line_ending(efi_type))
-
-        out.write("// Get the current value of the {} knob".format(knob.name) + get_line_ending(efi_type))
-        out.write("EFI_STATUS {}{} (".format(
-            naming_convention_filter("config_get_", False, efi_type),
-            knob.name
-        ) + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type))
-        out.write("{} *Knob".format(
-            get_type_string(knob.format.c_type, efi_type)
-        ) + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type) + ")" + get_line_ending(efi_type))
-        out.write("{" + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type) + "EFI_STATUS Status;")
-        out.write(get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type))
-        # offset to data is the size of the variable list format of the knob
-        # minus the data size and CRC32, which comes after the data
-        offset += get_variable_list_size(knob)
-        offset -= 4 + knob.format.size_in_bytes()
-        out.write("CONST UINTN Offset = {};".format(
-            offset
-        ) + get_line_ending(efi_type))
-        out.write(get_line_ending(efi_type))
-
-        # for the next offset, move past data and CRC32
-        offset += 4 + knob.format.size_in_bytes()
-
-        out.write(get_spacing_string(efi_type))
-        out.write("if (Knob == NULL) {" + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, num=2))
-        out.write("return EFI_INVALID_PARAMETER;" + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type))
-        out.write("}" + get_line_ending(efi_type))
-        out.write(get_line_ending(efi_type))
-
-        out.write(get_spacing_string(efi_type))
-        out.write("if (!CachedPolicyInitialized) {" + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, num=2))
-        out.write("Status = InitConfigPolicyCache ();" + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, num=2))
-        out.write("if (EFI_ERROR (Status)) {" + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, num=3))
-        out.write("ASSERT (FALSE);" + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, num=3))
-        out.write("return Status;" + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, num=2))
-        out.write("}" + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type))
-        out.write("}" + get_line_ending(efi_type))
-        out.write(get_line_ending(efi_type))
-
-        out.write(get_spacing_string(efi_type))
-        out.write("if (Offset + sizeof({}) > CachedPolicySize) {{".format(
-            get_type_string(knob.format.c_type, efi_type)
-        ) + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, num=2))
-        out.write("ASSERT (FALSE);" + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, num=2))
-        out.write("return EFI_COMPROMISED_DATA;" + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type))
-        out.write("}" + get_line_ending(efi_type))
-        out.write(get_line_ending(efi_type))
-
-        out.write(get_spacing_string(efi_type))
-        out.write("CopyMem(Knob, CachedPolicy + Offset, sizeof ({}));".format(
-            get_type_string(knob.format.c_type, efi_type)
-        ) + get_line_ending(efi_type))
-
-        out.write(get_spacing_string(efi_type))
-        out.write("return EFI_SUCCESS;" + get_line_ending(efi_type))
-        out.write("}" + get_line_ending(efi_type))
-        out.write(get_line_ending(efi_type))
-        pass
-
-
-def generate_public_header(schema, header_path, efi_type=False):
-
-    format_options = VariableList.StringFormatOptions()
-    format_options.c_format = True
-    format_options.efi_format = efi_type
-
-    with open(header_path, 'w', newline='') as out:
-        out.write(get_spdx_header(header_path, efi_type))
-        out.write(get_include_once_style(header_path, uefi=efi_type, header=True))
-        # UEFI uses Uefi.h instead of std libc headers
-        if efi_type:
-            out.write("#include <Uefi.h>" + get_line_ending(efi_type))
-        else:
-            out.write("#include <stdint.h>" + get_line_ending(efi_type))
-            out.write("#include <stddef.h>" + get_line_ending(efi_type))
-            out.write("#include <stdbool.h>" + get_line_ending(efi_type))
-        out.write("// Generated Header" + get_line_ending(efi_type))
-        out.write("//  Script: {}".format(sys.argv[0]) + get_line_ending(efi_type))
-        out.write("//  Schema: {}".format(schema.path) + get_line_ending(efi_type))
-        out.write("" + get_line_ending(efi_type))
-        # UEFI code uses STATIC_ASSERT, already defined in the environment
-        if not efi_type:
-            out.write("#ifndef C_ASSERT" + get_line_ending(efi_type))
-            out.write("// Statically verify an expression" + get_line_ending(efi_type))
-            out.write("#define C_ASSERT(e) typedef char __C_ASSERT__[(e)?1:-1]" + get_line_ending(efi_type))
-            out.write("#endif" + get_line_ending(efi_type))
-            out.write("" + get_line_ending(efi_type))
-        out.write("#pragma pack(push, 1)")
-        out.write("" + get_line_ending(efi_type))
-        out.write("// Schema-defined enums" + get_line_ending(efi_type))
-        for enum in schema.enums:
-            if enum.help != "":
-                out.write("// {}".format(enum.help) + get_line_ending(efi_type))
-            out.write("typedef enum {" + get_line_ending(efi_type))
-            has_negative = False
-            for value in enum.values:
-                if value.help != "":
-                    out.write(get_spacing_string(efi_type) + "{}_{} = {}, // {}".format(
-                        enum.name,
-                        value.name,
-                        value.number,
-                        value.help
-                    ) + get_line_ending(efi_type))
-                else:
-                    out.write(get_spacing_string(efi_type) + "{}_{} = {},".format(
-                        enum.name,
-                        value.name,
-                        value.number
-                    ) + get_line_ending(efi_type))
-
-                if value.number < 0:
-                    has_negative = True
-            if has_negative:
-                out.write(get_spacing_string(efi_type) + "_{}_PADDING = 0x7fffffff // Force packing to int size".format(
-                    enum.name
-                ) + get_line_ending(efi_type))
-            else:
-                out.write(get_spacing_string(efi_type) + "_{}_PADDING = 0xffffffff // Force packing to int size".format(
-                    enum.name
-                ) + get_line_ending(efi_type))
-            out.write("}} {};".format(enum.name) + get_line_ending(efi_type))
-            out.write("" + get_line_ending(efi_type))
-            assert_string = f"(sizeof({enum.name}) == sizeof({get_type_string('uint32_t', efi_type)})"
-            out.write(get_assert_style(efi_type, assert_string, '"enum must be unsigned 32 bit int"'))
-            out.write(get_line_ending(efi_type))
-            out.write("" + get_line_ending(efi_type))
-            pass
-
-        out.write("// Schema-defined structures" + get_line_ending(efi_type))
-        for struct_definition in schema.structs:
-            if struct_definition.help != "":
-                out.write("// {}".format(struct_definition.help) + get_line_ending(efi_type))
-            out.write("typedef struct {" + get_line_ending(efi_type))
-            for member in struct_definition.members:
-                if member.help != "":
-                    out.write(get_spacing_string(efi_type) + "// {}".format(member.help) + get_line_ending(efi_type))
-                if member.count == 1:
-                    out.write(get_spacing_string(efi_type) + "{} {};".format(
-                        get_type_string(member.format.c_type, efi_type),
-                        member.name) + get_line_ending(efi_type))
-                else:
-                    out.write(get_spacing_string(efi_type) + "{} {}[{}];".format(
-                        get_type_string(member.format.c_type, efi_type),
-                        member.name,
-                        member.count) + get_line_ending(efi_type))
-
-            out.write("}} {};".format(struct_definition.name) + get_line_ending(efi_type))
-            out.write("" + get_line_ending(efi_type))
-            out.write(get_assert_style(efi_type, "(sizeof({}) == {}".format(
-                struct_definition.name,
-                struct_definition.size_in_bytes()
-            ), '"structure size must be consistent"') + get_line_ending(efi_type))
-            out.write("" + get_line_ending(efi_type))
-            pass
-        out.write("#pragma pack(pop)" + get_line_ending(efi_type))
-        out.write("" + get_line_ending(efi_type))
-        out.write("// Schema-defined knobs" + get_line_ending(efi_type))
-        for knob in schema.knobs:
-            out.write("// {} knob".format(knob.name) + get_line_ending(efi_type))
-            if knob.help != "":
-                out.write("// {}".format(knob.help) + get_line_ending(efi_type))
-
-            out.write("" + get_line_ending(efi_type))
-            for subknob in knob.subknobs:
-                if subknob.leaf:
-                    define_name = subknob.name.replace('[', '_').replace(']', '_').replace('.', '__')
-                    if subknob.min != subknob.format.min:
-                        out.write("#define KNOB__{}__MIN {}".format(
-                            define_name,
-                            subknob.format.object_to_string(subknob.min, format_options)) + get_line_ending(efi_type))
-                    if subknob.max != subknob.format.max:
-                        out.write("#define KNOB__{}__MAX {}".format(
-                            define_name,
-                            subknob.format.object_to_string(subknob.max, format_options)) + get_line_ending(efi_type))
-
-            out.write("" + get_line_ending(efi_type))
-            # uefi has getters return a status and pass in a ptr
-            if not efi_type:
-                out.write("// Get the current value of the {} knob".format(knob.name) + get_line_ending(efi_type))
-                out.write("{} {}{}();".format(
-                    get_type_string(knob.format.c_type, efi_type),
-                    naming_convention_filter("config_get_",
-                                             False,
-                                             efi_type),
-                    knob.name))
-                out.write("" + get_line_ending(efi_type))
-            else:
-                out.write("EFI_STATUS {}{} (".format(
-                    naming_convention_filter("config_get_", False, efi_type),
-                    knob.name
-                ))
-                out.write("{} *Knob);".format(
-                    get_type_string(knob.format.c_type, efi_type)
-                ) + get_line_ending(efi_type))
-
-            # no concept of setting config variables in UEFI
-            if not efi_type:
-                out.write("#ifdef CONFIG_SET_VARIABLES" + get_line_ending(efi_type))
-                out.write("// Set the current value of the {} knob".format(knob.name) + get_line_ending(efi_type))
-                out.write("{} config_set_{}({} value);".format(
-                    get_type_string('bool', efi_type),
-                    knob.name,
-                    get_type_string(knob.format.c_type, efi_type),
-                ) + get_line_ending(efi_type))
-                out.write("#endif // CONFIG_SET_VARIABLES" + get_line_ending(efi_type))
-                out.write("" + get_line_ending(efi_type))
-            pass
-
-        out.write("" + get_line_ending(efi_type))
-        # UEFI uses a core header with the standard definitions
-        # so we must use #defines instead of the enum
-        if efi_type is False:
-            out.write("typedef enum {" + get_line_ending(efi_type))
-            for knob in schema.knobs:
-                out.write(get_spacing_string(efi_type) + "KNOB_{},".format(knob.name) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "KNOB_MAX" + get_line_ending(efi_type))
-            out.write("}" + " {};".format(
-                naming_convention_filter("knob_t", True, efi_type)) + get_line_ending(efi_type))
-        else:
-            idx = 0
-            for knob in schema.knobs:
-                out.write("#define KNOB_{} {}".format(
-                    knob.name,
-                    idx
-                ) + get_line_ending(efi_type))
-                idx += 1
-            out.write("#define KNOB_MAX {}".format(idx))
-        out.write("" + get_line_ending(efi_type))
-        # UEFI already defines EFI_GUID and puts these
-        # definitions in a standard core header
-        if not efi_type:
-            out.write("typedef struct {" + get_line_ending(efi_type))
-            out.write("    unsigned long  Data1;" + get_line_ending(efi_type))
-            out.write("    unsigned short Data2;" + get_line_ending(efi_type))
-            out.write("    unsigned short Data3;" + get_line_ending(efi_type))
-            out.write("    unsigned char  Data4[8];" + get_line_ending(efi_type))
-            out.write("} config_guid_t;" + get_line_ending(efi_type))
-            out.write("" + get_line_ending(efi_type))
-            out.write("typedef struct {" + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "{} {};".format(
-                get_type_string("int", efi_type),
-                naming_convention_filter("get_count", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "{} {};".format(
-                get_type_string("int", efi_type),
-                naming_convention_filter("set_count", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write("}" + " {};".format(
-                naming_convention_filter("knob_statistics_t", True, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write("" + get_line_ending(efi_type))
-            out.write("typedef {} ({})({} {});".format(
-                get_type_string('bool', efi_type),
-                naming_convention_filter("knob_validation_fn", True, efi_type),
-                get_type_string("const", efi_type),
-                get_type_string("void*", efi_type)
-            ) + get_line_ending(efi_type))
-            out.write("" + get_line_ending(efi_type))
-            out.write("typedef struct {" + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "{} {};".format(
-                naming_convention_filter("knob_t", True, efi_type),
-                naming_convention_filter("knob", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "{} {} {};".format(
-                get_type_string("const", efi_type),
-                get_type_string("void*", efi_type),
-                naming_convention_filter("default_value_address", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "{} {};".format(
-                get_type_string("void*", efi_type),
-                naming_convention_filter("cache_value_address", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "{} {};".format(
-                get_type_string('size_t', efi_type),
-                naming_convention_filter("value_size", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "{} {} {};".format(
-                get_type_string("const", efi_type),
-                get_type_string("char*", efi_type),
-                naming_convention_filter("name", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "{} {};".format(
-                get_type_string('size_t', efi_type),
-                naming_convention_filter("name_size", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "{} {};".format(
-                get_type_string("config_guid_t", efi_type),
-                naming_convention_filter("vendor_namespace", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "{} {};".format(
-                get_type_string("int", efi_type),
-                naming_convention_filter("attributes", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "{} {};".format(
-                naming_convention_filter("knob_statistics_t", True, efi_type),
-                naming_convention_filter("statistics", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "{} {};".format(
-                naming_convention_filter("knob_validation_fn*", True, efi_type),
-                naming_convention_filter("validator", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write("}" + " {};".format(
-                naming_convention_filter("knob_data_t", True, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write("" + get_line_ending(efi_type))
-            out.write("typedef struct {" + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "{} {};".format(
-                naming_convention_filter("knob_t", True, efi_type),
-                naming_convention_filter("knob", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "{} {};".format(
-                get_type_string("void*", efi_type),
-                naming_convention_filter("value", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write("}" + " {};".format(
-                naming_convention_filter("knob_override_t", True, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write("" + get_line_ending(efi_type))
-            out.write("typedef struct {" + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "{}* {};".format(
-                naming_convention_filter("knob_override_t", True, efi_type),
-                naming_convention_filter("overrides", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "{} {};".format(
-                get_type_string('size_t', efi_type),
-                naming_convention_filter("override_count", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write("}" + " {};".format(
-                naming_convention_filter("profile_t", True, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write("" + get_line_ending(efi_type))
-        out.write(get_include_once_style(header_path, uefi=efi_type, header=False))
-
-
-def format_guid(guid):
-    u = uuid.UUID(guid)
-
-    byte_sequence = u.fields[3].to_bytes(1, byteorder='big') + \
-                    u.fields[4].to_bytes(1, byteorder='big') + \
-                    u.fields[5].to_bytes(6, byteorder='big')
-
-    return "{{{},{},{},{{{},{},{},{},{},{},{},{}}}}}".format(
-        hex(u.fields[0]),
-        hex(u.fields[1]),
-        hex(u.fields[2]),
-        hex(byte_sequence[0]),
-        hex(byte_sequence[1]),
-        hex(byte_sequence[2]),
-        hex(byte_sequence[3]),
-        hex(byte_sequence[4]),
-        hex(byte_sequence[5]),
-        hex(byte_sequence[6]),
-        hex(byte_sequence[7]))
-
-
-def generate_cached_implementation(schema, header_path, efi_type=False):
-    with open(header_path, 'w', newline='') as out:
-        out.write(get_spdx_header(header_path, efi_type))
-        out.write(get_include_once_style(header_path, uefi=efi_type, header=True))
-        out.write("// The config public header must be included prior to this file" + get_line_ending(efi_type))
-        out.write("// Generated Header" + get_line_ending(efi_type))
-        out.write("//  Script: {}".format(sys.argv[0]) + get_line_ending(efi_type))
-        out.write("//  Schema: {}".format(schema.path) + get_line_ending(efi_type))
-        out.write("" + get_line_ending(efi_type))
-
-        out.write("typedef struct {" + get_line_ending(efi_type))
-        for knob in schema.knobs:
-            out.write(get_spacing_string(efi_type) + "{} {};".format(
-                get_type_string(knob.format.c_type, efi_type),
-                knob.name) + get_line_ending(efi_type))
-        out.write("}" + " {};".format(
-            naming_convention_filter("knob_values_t", True, efi_type)
-        ) + get_line_ending(efi_type))
-        out.write("" + get_line_ending(efi_type))
-
-        format_options = VariableList.StringFormatOptions()
-        format_options.c_format = True
-        format_options.efi_format = efi_type
-
-        out.write("{} {} g{} = ".format(
-            get_type_string("const", efi_type),
-            naming_convention_filter("knob_values_t", True, efi_type),
-            naming_convention_filter("_knob_default_values", False, efi_type)
-        ) + get_line_ending(efi_type) + "{" + get_line_ending(efi_type))
-        for knob in schema.knobs:
-            out.write(get_spacing_string(efi_type) + ".{}={},".format(
-                knob.name,
-                knob.format.object_to_string(knob.default, format_options)
-            ) + get_line_ending(efi_type))
-        out.write("};" + get_line_ending(efi_type))
-
-        out.write("#ifdef CONFIG_INCLUDE_CACHE" + get_line_ending(efi_type))
-        out.write("{} g{} = ".format(
-            naming_convention_filter("knob_values_t", True, efi_type),
-            naming_convention_filter("_knob_cached_values", False, efi_type)
-        ) + get_line_ending(efi_type) + "{" + get_line_ending(efi_type))
-        for knob in schema.knobs:
-            out.write("    .{}={},".format(
-                knob.name,
-                knob.format.object_to_string(knob.default, format_options)
-            ) + get_line_ending(efi_type))
-        out.write("};" + get_line_ending(efi_type))
-        # macro use of 'knob', leave alone
-        out.write("#define CONFIG_CACHE_ADDRESS(knob) (&g{}.knob)".format(
-            naming_convention_filter("_knob_cached_values", False, efi_type)
-        ) + get_line_ending(efi_type))
-        out.write("#else // CONFIG_INCLUDE_CACHE" + get_line_ending(efi_type))
-        out.write("#define CONFIG_CACHE_ADDRESS({}) (NULL)".format(
-            naming_convention_filter("knob", False, efi_type)
-        ) + get_line_ending(efi_type))
-        out.write("#endif // CONFIG_INCLUDE_CACHE" + get_line_ending(efi_type))
-        out.write("" + get_line_ending(efi_type))
-
-        for enum in schema.enums:
-            lowest_value = enum.values[0].number
-            highest_value = enum.values[0].number
-            for value in enum.values:
-                if value.number < lowest_value:
-                    lowest_value = value.number
-                if value.number > highest_value:
-                    highest_value = value.number
-
-            out.write("{} {}{}({} {})".format(
-                get_type_string('bool', efi_type),
-                naming_convention_filter("validate_enum_value_", False, efi_type),
-                enum.name,
-                enum.name,
-                naming_convention_filter("value", False, efi_type)) + get_line_ending(efi_type))
-            out.write("{" + get_line_ending(efi_type))
-
-            if highest_value - lowest_value > len(enum.values):
-                out.write(get_spacing_string(efi_type) + "switch ({}) ".format(
-                    naming_convention_filter("value", False, efi_type)
-                ) + get_line_ending(efi_type) + "{" + get_line_ending(efi_type))
-
-                for value in enum.values:
-                    out.write(get_spacing_string(efi_type, 2) + "case {}_{}:".format(
-                        enum.name,
-                        value.name
-                    ) + get_line_ending(efi_type))
-                    out.write(get_spacing_string(efi_type, 3) + "return {};".format(
-                        get_value_string('true', efi_type)) + get_line_ending(efi_type))
-                out.write(get_spacing_string(efi_type) + "}" + get_line_ending(efi_type))
-                out.write(get_spacing_string(efi_type) + "return {};".format(
-                    get_value_string('false', efi_type)
-                ) + get_line_ending(efi_type))
-            else:
-                out.write(get_spacing_string(efi_type) + "{} {} = ({}){};".format(
-                    get_type_string("int", efi_type),
-                    naming_convention_filter("numeric_value", False, efi_type),
-                    get_type_string("int", efi_type),
-                    naming_convention_filter("value", False, efi_type)
-                ) + get_line_ending(efi_type))
-                out.write(get_spacing_string(efi_type) + "if ({} < {}) return {};".format(
-                    naming_convention_filter("numeric_value", False, efi_type),
-                    lowest_value,
-                    get_value_string('false', efi_type)) + get_line_ending(efi_type))
-                out.write(get_spacing_string(efi_type) + "if ({} > {}) return {};".format(
-                    naming_convention_filter("numeric_value", False, efi_type),
-                    highest_value,
-                    get_value_string('false', efi_type)) + get_line_ending(efi_type))
-                for i in range(lowest_value, highest_value):
-                    found = False
-                    for value in enum.values:
-                        if value.number == i:
-                            found = True
-                            break
-                    if not found:
-                        out.write(get_spacing_string(efi_type) + "if ({} == {}) return {};".format(
-                            naming_convention_filter("numeric_value", False, efi_type),
-                            i,
-                            get_value_string('false', efi_type)) + get_line_ending(efi_type))
-                out.write(get_spacing_string(efi_type) + "return {};".format(
-                    get_value_string('true', efi_type)
-                ) + get_line_ending(efi_type))
-            out.write("}" + get_line_ending(efi_type))
-            out.write("" + get_line_ending(efi_type))
-
-        out.write("" + get_line_ending(efi_type))
-
-        out.write("{} {}({} {} {})".format(
-            get_type_string('bool', efi_type),
-            naming_convention_filter("validate_knob_no_constraints", False, efi_type),
-            get_type_string("const", efi_type),
-            get_type_string("void*", efi_type),
-            naming_convention_filter("buffer", False, efi_type)
-        ) + get_line_ending(efi_type))
-        out.write("{" + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type) + "({}){};".format(
-            get_type_string("void", efi_type),
-            naming_convention_filter("buffer", False, efi_type)
-        ) + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type) + "return {};".format(
-            get_value_string('true', efi_type)
-        ) + get_line_ending(efi_type))
-        out.write("}" + get_line_ending(efi_type))
-        out.write("" + get_line_ending(efi_type))
-        for knob in schema.knobs:
-            constraint_present = False
-            for subknob in knob.subknobs:
-                if subknob.leaf:
-                    if isinstance(subknob.format, VariableList.EnumFormat):
-                        constraint_present = True
-                    else:
-                        if subknob.min != subknob.format.min:
-                            constraint_present = True
-                        if subknob.max != subknob.format.max:
-                            constraint_present = True
-
-            if constraint_present:
-                out.write("{} {}{}({} {} {})".format(
-                    get_type_string('bool', efi_type),
-                    naming_convention_filter("validate_knob_content_", False, efi_type),
-                    knob.name,
-                    get_type_string("const", efi_type),
-                    get_type_string("void*", efi_type),
-                    naming_convention_filter("buffer", False, efi_type)) + get_line_ending(efi_type))
-                out.write("{" + get_line_ending(efi_type))
-                out.write(get_spacing_string(efi_type) + "{}* {} = ({}*){};".format(
-                    get_type_string(knob.format.c_type, efi_type),
-                    naming_convention_filter("value", False, efi_type),
-                    get_type_string(knob.format.c_type, efi_type),
-                    naming_convention_filter("buffer", False, efi_type)
-                ) + get_line_ending(efi_type))
-
-                for subknob in knob.subknobs:
-                    if subknob.leaf:
-                        path = subknob.name[len(knob.name):]
-                        define_name = subknob.name.replace('[', '_').replace(']', '_').replace('.', '__')
-                        if isinstance(subknob.format, VariableList.EnumFormat):
-                            if path.find('.') != -1:
-                                # this is an enum inside of a struct
-                                out.write(get_spacing_string(efi_type) + "if (!{}{}({}->{})) {{".format(
-                                    naming_convention_filter("validate_enum_value_", False, efi_type),
-                                    subknob.format.name,
-                                    naming_convention_filter("value", False, efi_type),
-                                    # don't take the '.'
-                                    path[1:]
-                                ))
-                            else:
-                                # this is a standalone enum knob
-                                out.write(get_spacing_string(efi_type) + "if (!{}{}(*{})) {{".format(
-                                    naming_convention_filter("validate_enum_value_", False, efi_type),
-                                    subknob.format.name,
-                                    naming_convention_filter("value", False, efi_type)
-                                ))
-
-                            out.write(get_line_ending(efi_type))
-                            out.write(get_spacing_string(efi_type, num=2))
-                            out.write("return {};".format(
-                                get_value_string('false', efi_type))
-                                + get_line_ending(efi_type)
-                            )
-                            out.write(get_spacing_string(efi_type) + "}" + get_line_ending(efi_type))
-                        else:
-                            if subknob.min != subknob.format.min:
-                                out.write(get_spacing_string(efi_type))
-                                out.write("if ({}->{} < KNOB__{}__MIN) {{".format(
-                                    naming_convention_filter("value", False, efi_type),
-                                    # don't take the '.'
-                                    path[1:],
-                                    define_name
-                                ))
-                                out.write(get_line_ending(efi_type))
-                                out.write(get_spacing_string(efi_type, num=2))
-                                out.write("return {};".format(
-                                    get_value_string('false', efi_type))
-                                    + get_line_ending(efi_type)
-                                )
-                                out.write(get_spacing_string(efi_type) + "}" + get_line_ending(efi_type))
-                            if subknob.max != subknob.format.max:
-                                out.write(get_spacing_string(efi_type))
-                                out.write("if ({}->{} > KNOB__{}__MAX) {{".format(
-                                    naming_convention_filter("value", False, efi_type),
-                                    # don't take the '.'
-                                    path[1:],
-                                    define_name
-                                ))
-                                out.write(get_line_ending(efi_type))
-                                out.write(get_spacing_string(efi_type, num=2))
-                                out.write("return {};".format(
-                                    get_value_string('false', efi_type))
-                                    + get_line_ending(efi_type)
-                                )
-                                out.write(get_spacing_string(efi_type) + "}" + get_line_ending(efi_type))
-                out.write(get_spacing_string(efi_type) + "return {};".format(
-                    get_value_string('true', efi_type)
-                ) + get_line_ending(efi_type))
-                out.write("}" + get_line_ending(efi_type))
-                out.write("" + get_line_ending(efi_type))
-            else:
-                out.write("#define {}{} {}".format(
-                    naming_convention_filter("validate_knob_content_", False, efi_type),
-                    knob.name,
-                    naming_convention_filter("validate_knob_no_constraints", False, efi_type)
-                ) + get_line_ending(efi_type))
-                out.write("" + get_line_ending(efi_type))
-
-        out.write("" + get_line_ending(efi_type))
-        out.write("{} g{}[{}] = {{".format(
-            naming_convention_filter("knob_data_t", True, efi_type),
-            naming_convention_filter("_knob_data", False, efi_type),
-            len(schema.knobs) + 1
-        ) + get_line_ending(efi_type))
-        for knob in schema.knobs:
-            out.write(get_spacing_string(efi_type) + "{" + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type, 2) + "KNOB_{},".format(knob.name) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type, 2) + "&g{}.{},".format(
-                naming_convention_filter("_knob_default_values", False, efi_type),
-                knob.name
-            ) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type, 2))
-            out.write("CONFIG_CACHE_ADDRESS({}),".format(knob.name) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type, 2))
-            out.write("sizeof({}),".format(get_type_string(knob.format.c_type, efi_type)) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type, 2))
-            out.write("\"{}\",".format(knob.name) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type, 2))
-            out.write("{}, // Length of name (including NULL terminator)".format(
-                len(knob.name) + 1
-            ) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type, 2))
-            out.write("{}, // {}".format(format_guid(knob.namespace), knob.namespace) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type, 2))
-            out.write("{},".format(7) + get_line_ending(efi_type))
-            # statistics not implemented in uefi design
-            if efi_type is False:
-                out.write(get_spacing_string(efi_type, 2))
-                out.write("{0, 0}," + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type, 2) + "&{}{}".format(
-                naming_convention_filter("validate_knob_content_", False, efi_type),
-                knob.name
-            ) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "}," + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type) + "{" + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, 2) + "KNOB_MAX," + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, 2) + "NULL," + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, 2) + "NULL," + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, 2) + "0," + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, 2) + "NULL," + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, 2) + "0," + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, 2))
-        out.write("{0,0,0,{0,0,0,0,0,0,0,0}}," + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, 2) + "0," + get_line_ending(efi_type))
-        # statistics not implemented in uefi design
-        if efi_type is False:
-            out.write(get_spacing_string(efi_type, 2) + "{0, 0}," + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, 2) + "NULL")
-        out.write(get_line_ending(efi_type) + get_spacing_string(efi_type) + "}" + get_line_ending(efi_type))
-        out.write("};" + get_line_ending(efi_type))
-
-        if not efi_type:
-            # UEFI does not use get_knob_value
-            out.write("" + get_line_ending(efi_type))
-            out.write("{} {}({} {});".format(
-                get_type_string("void*", efi_type),
-                naming_convention_filter("get_knob_value", False, efi_type),
-                naming_convention_filter("knob_t", True, efi_type),
-                naming_convention_filter("knob", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write("" + get_line_ending(efi_type))
-            # no concept of setting config variables in UEFI
-            out.write("#ifdef CONFIG_SET_VARIABLES" + get_line_ending(efi_type))
-            out.write("{} set_knob_value(knob_t knob, void* value);".format(
-                get_type_string('bool', efi_type)
-            ) + get_line_ending(efi_type))
-            out.write("#endif // CONFIG_SET_VARIABLES" + get_line_ending(efi_type))
-            out.write("" + get_line_ending(efi_type))
-
-            # UEFI utilizes a separate header for getter implementations
-            out.write("// Schema-defined knobs" + get_line_ending(efi_type))
-            for knob in schema.knobs:
-                out.write("// {} knob".format(knob.name) + get_line_ending(efi_type))
-                if knob.help != "":
-                    out.write("// {}".format(knob.help) + get_line_ending(efi_type))
-
-                out.write("// Get the current value of the {} knob".format(knob.name) + get_line_ending(efi_type))
-                out.write("{} {}{}({}) {{".format(
-                    get_type_string(knob.format.c_type, efi_type),
-                    naming_convention_filter("config_get_", False, efi_type),
-                    knob.name,
-                    get_type_string("void", efi_type)
-                ) + get_line_ending(efi_type))
-                out.write(get_spacing_string(efi_type) + "return *(({}*){}(KNOB_{}));".format(
-                    get_type_string(knob.format.c_type, efi_type),
-                    naming_convention_filter("get_knob_value", False, efi_type),
-                    knob.name
-                ) + get_line_ending(efi_type))
-                out.write("}" + get_line_ending(efi_type))
-                out.write("" + get_line_ending(efi_type))
-                # no concept of setting config variables in UEFI
-                if not efi_type:
-                    out.write("#ifdef CONFIG_SET_VARIABLES" + get_line_ending(efi_type))
-                    out.write("// Set the current value of the {} knob".format(knob.name) + get_line_ending(efi_type))
-                    out.write("{} config_set_{}({} value) {{".format(
-                        get_type_string('bool', efi_type),
-                        knob.name,
-                        knob.format.c_type) + get_line_ending(efi_type))
-                    out.write(get_spacing_string(efi_type) + "return set_knob_value(KNOB_{}, &value);".format(
-                        knob.name
-                    ) + get_line_ending(efi_type))
-                    out.write("}" + get_line_ending(efi_type))
-                    out.write("#endif // CONFIG_SET_VARIABLES" + get_line_ending(efi_type))
-                    out.write("" + get_line_ending(efi_type))
-                pass
-        else:
-            # give UEFI core components a knob count
-            out.write(get_line_ending(efi_type))
-            out.write(get_type_string("size_t", efi_type) + " g{} = KNOB_MAX;".format(
-                naming_convention_filter("_num_knobs", False, efi_type))
-            )
-            out.write(get_line_ending(efi_type))
-        out.write(get_include_once_style(header_path, uefi=efi_type, header=False))
-
-
-# UEFI utilizes a third header file to hold the getter implementation
-def generate_getter_implementation(schema, header_path, efi_type):
-    with open(header_path, 'w', newline='') as out:
-        out.write(get_spdx_header(header_path, efi_type))
-        out.write(get_include_once_style(header_path, uefi=efi_type, header=True))
-        out.write("// The config public header must be included prior to this file" + get_line_ending(efi_type))
-        out.write("// Generated Header" + get_line_ending(efi_type))
-        out.write("//  Script: {}".format(sys.argv[0]) + get_line_ending(efi_type))
-        out.write("//  Schema: {}".format(schema.path) + get_line_ending(efi_type))
-        out.write(get_line_ending(efi_type))
-
-        policy_size = hex(get_conf_policy_size(schema))
-        out.write("STATIC CONST UINT16  CachedPolicySize = {};".format(
-            policy_size
-        ) + get_line_ending(efi_type))
-        out.write("STATIC CHAR8 CachedPolicy[{}];".format(
-            policy_size
-        ) + get_line_ending(efi_type))
-        out.write("STATIC BOOLEAN CachedPolicyInitialized = FALSE;")
-        out.write(get_line_ending(efi_type))
-        out.write(get_assert_style(efi_type, "({} <= MAX_UINT16".format(
-            policy_size
-        ), '"Config too large!"'))
-        out.write(get_line_ending(efi_type))
-        out.write(get_line_ending(efi_type))
-
-        # InitConfigPolicyCache
-        out.write("STATIC" + get_line_ending())
-        out.write("EFI_STATUS" + get_line_ending(efi_type))
-        out.write(naming_convention_filter("init_config_policy_cache (", False, efi_type))
-        out.write(get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type) + get_type_string("void", efi_type))
-        out.write(get_line_ending(efi_type) + ")" + get_line_ending(efi_type) + "{")
-        out.write(get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type))
-        out.write("EFI_STATUS Status;" + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type))
-        out.write("UINT16 ConfPolSize = CachedPolicySize;" + get_line_ending(efi_type))
-        out.write(get_line_ending(efi_type))
-
-        out.write(get_spacing_string(efi_type))
-        out.write("Status = GetPolicy (")
-        out.write("PcdGetPtr (PcdConfigurationPolicyGuid), NULL,")
-        out.write(" CachedPolicy, &ConfPolSize);" + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type))
-        out.write("if ((EFI_ERROR (Status)) || (ConfPolSize != CachedPolicySize)) {" + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, num=2) + "ASSERT (FALSE);")
-        out.write(get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, num=2))
-        out.write("return Status;" + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type))
-        out.write("}" + get_line_ending(efi_type))
-        out.write(get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type))
-        out.write("CachedPolicyInitialized = TRUE;" + get_line_ending(efi_type))
-        out.write(get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type))
-        out.write("return Status;" + get_line_ending(efi_type))
-        out.write("}" + get_line_ending(efi_type))
-        out.write(get_line_ending(efi_type))
-
-        write_uefi_getter_implementations(efi_type, out, schema)
-
-        out.write(get_include_once_style(header_path, uefi=efi_type, header=False))
-
-
-def generate_profiles(schema, profile_header_path, profile_paths, efi_type, profile_names=None):
-    with open(profile_header_path, 'w', newline='') as out:
-        out.write(get_spdx_header(profile_header_path, efi_type))
-        out.write(get_include_once_style(profile_header_path, uefi=efi_type, header=True))
-        out.write("// The config public header must be included prior to this file" + get_line_ending(efi_type))
-        out.write("// Generated Header" + get_line_ending(efi_type))
-        out.write("//  Script: {}".format(sys.argv[0]) + get_line_ending(efi_type))
-        out.write("//  Schema: {}".format(schema.path) + get_line_ending(efi_type))
-        for profile_path in profile_paths:
-            out.write("//  Profile: {}".format(profile_path) + get_line_ending(efi_type))
-
-        out.write("" + get_line_ending(efi_type))
-
-        format_options = VariableList.StringFormatOptions()
-        format_options.c_format = True
-        format_options.efi_format = efi_type
-
-        profiles = []
-        for profile_path in profile_paths:
-            base_name = os.path.splitext(os.path.basename(profile_path))[0]
-            out.write("// Profile {}".format(base_name) + get_line_ending(efi_type))
-            # Reset the schema to defaults
-            for knob in schema.knobs:
-                knob.value = None
-
-            # Read the csv to override the values in the schema
-            VariableList.read_csv(schema, profile_path)
-
-            override_count = 0
-
-            out.write("typedef struct {" + get_line_ending(efi_type))
-            for knob in schema.knobs:
-                if knob.value is not None:
-                    override_count = override_count + 1
-                    out.write(get_spacing_string(efi_type) + "{} {};".format(
-                        get_type_string(knob.format.c_type, efi_type),
-                        knob.name) + get_line_ending(efi_type))
-            out.write("}} {}{}{};".format(
-                naming_convention_filter("profile_", True, efi_type),
-                base_name,
-                naming_convention_filter("_data_t", True, efi_type)
-            ) + get_line_ending(efi_type))
-
-            out.write("" + get_line_ending(efi_type))
-            out.write("{}{}{} {}{}{} = {{".format(
-                naming_convention_filter("profile_", True, efi_type),
-                base_name,
-                naming_convention_filter("_data_t", True, efi_type),
-                naming_convention_filter("profile_", False, efi_type),
-                base_name,
-                naming_convention_filter("_data", False, efi_type)
-            ) + get_line_ending(efi_type))
-            for knob in schema.knobs:
-                if knob.value is not None:
-                    out.write("    .{}={},".format(
-                        knob.name,
-                        knob.format.object_to_string(knob.value, format_options)) + get_line_ending(efi_type))
-            out.write("};" + get_line_ending(efi_type))
-            out.write("" + get_line_ending(efi_type))
-            out.write("#define PROFILE_{}_OVERRIDES".format(base_name.upper()) + get_line_ending(efi_type))
-            out.write("#define PROFILE_{}_OVERRIDES_COUNT {}".format(
-                base_name.upper(),
-                override_count
-            ) + get_line_ending(efi_type))
-            out.write("{} {}{}{}[PROFILE_{}_OVERRIDES_COUNT + 1] = {{".format(
-                naming_convention_filter("knob_override_t", True, efi_type),
-                naming_convention_filter("profile_", False, efi_type),
-                base_name,
-                naming_convention_filter("_overrides", False, efi_type),
-                base_name.upper()
-            ) + get_line_ending(efi_type))
-
-            for knob in schema.knobs:
-                if knob.value is not None:
-                    out.write(get_spacing_string(efi_type) + "{" + get_line_ending(efi_type))
-                    out.write(get_spacing_string(efi_type, 2) + ".{} = KNOB_{},".format(
-                        naming_convention_filter("knob", False, efi_type),
-                        knob.name
-                    ) + get_line_ending(efi_type))
-                    out.write(get_spacing_string(efi_type, 2) + ".{} = &{}{}{}.{},".format(
-                        naming_convention_filter("value", False, efi_type),
-                        naming_convention_filter("profile_", False, efi_type),
-                        base_name,
-                        naming_convention_filter("_data", False, efi_type),
-                        knob.name
-                    ) + get_line_ending(efi_type))
-                    out.write(get_spacing_string(efi_type) + "}," + get_line_ending(efi_type))
-
-            out.write(get_spacing_string(efi_type) + "{" + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type, 2) + ".{} = KNOB_MAX,".format(
-                naming_convention_filter("knob", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type, 2) + ".{} = NULL,".format(
-                naming_convention_filter("value", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "}" + get_line_ending(efi_type))
-            out.write("};" + get_line_ending(efi_type))
-            out.write("" + get_line_ending(efi_type))
-
-            profiles.append((base_name, override_count))
-        out.write("" + get_line_ending(efi_type))
-        out.write("#define PROFILE_COUNT {}".format(len(profiles)) + get_line_ending(efi_type))
-        if not efi_type:
-            out.write("{} {}[PROFILE_COUNT + 1] = ".format(
-                naming_convention_filter("profile_t", True, efi_type),
-                naming_convention_filter("profiles", False, efi_type)
-            ) + get_line_ending(efi_type) + "{" + get_line_ending(efi_type))
-        else:
-            out.write("{} g{}[PROFILE_COUNT + 1] = ".format(
-                naming_convention_filter("profile_t", True, efi_type),
-                naming_convention_filter("profile_data", False, efi_type)
-            ) + get_line_ending(efi_type) + "{" + get_line_ending(efi_type))
-        for (profile, override_count) in profiles:
-            out.write(get_spacing_string(efi_type) + "{" + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type, 2) + ".{} = {}{}{},".format(
-                naming_convention_filter("overrides", False, efi_type),
-                naming_convention_filter("profile_", False, efi_type),
-                profile,
-                naming_convention_filter("_overrides", False, efi_type)
-            ) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type, 2) + ".{} = {},".format(
-                naming_convention_filter("override_count", False, efi_type),
-                override_count
-            ) + get_line_ending(efi_type))
-            out.write(get_spacing_string(efi_type) + "}," + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type) + "{" + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, 2) + ".{} = NULL,".format(
-            naming_convention_filter("overrides", False, efi_type)
-        ) + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type, 2) + ".{} = 0,".format(
-            naming_convention_filter("override_count", False, efi_type)
-        ) + get_line_ending(efi_type))
-        out.write(get_spacing_string(efi_type) + "}" + get_line_ending(efi_type))
-        out.write("};" + get_line_ending(efi_type))
-        if efi_type:
-            if profile_names is not None:
-                names_list = profile_names.split(",")
-            else:
-                # If not specified, the indices will be the default profile names
-                names_list = [format(i, '02x') for i in range(len(profile_paths))]
-
-            out.write(get_line_ending(efi_type))
-            out.write(get_type_string("char*", efi_type) + " g{}[PROFILE_COUNT]".format(
-                naming_convention_filter("_profile_flavor_names", False, efi_type)) + " = {"
-            )
-            out.write(get_line_ending(efi_type))
-            for profile_name in names_list:
-                out.write(get_spacing_string(efi_type) + '"' + profile_name + '",' + get_line_ending(efi_type))
-            out.write("};" + get_line_ending(efi_type))
-            out.write(get_line_ending(efi_type))
-            out.write(get_type_string("size_t", efi_type) + " g{} = PROFILE_COUNT;".format(
-                naming_convention_filter("_num_profiles", False, efi_type))
-            )
-            out.write(get_line_ending(efi_type))
-
-        out.write(get_include_once_style(profile_header_path, uefi=efi_type, header=False))
-
-
-def generate_sources(schema, public_header, service_header, data_header, efi_type):
-    generate_public_header(schema, public_header, efi_type)
-    # in UEFI builds, getter implementations go to service_header and data to
-    # data_header. In non-UEFI builds, both go to service_header
-    if efi_type is True:
-        generate_getter_implementation(schema, service_header, efi_type)
-        generate_cached_implementation(schema, data_header, efi_type)
-    else:
-        generate_cached_implementation(schema, service_header, efi_type)
-
-
-def usage():
-    print("Commands:\n")
-    print("  generateheader[_efi] <schema.xml> <public_header.h> <service_header.h> "
-          "[<data_header.h>] [<profile_header.h> <profile.csv>...]")
-    print("")
-    print("schema.xml       : An XML with the definition of a set of known")
-    print("                   config knobs and types to interpret them\n")
-    print("public_header.h  : Output header for use by config consumers\n")
-    print("service_header.h : Output header for use by config provider. In UEFI builds")
-    print("                   this only contains getter implementations\n")
-    print("data_header.h    : Output header for UEFI builds only. This contains only")
-    print("                   the data. In non-UEFI builds, service_header.h and")
-    print("                   data_header.h are combined\n")
-    print("profile_header.h : Output header for the profile data for consumption")
-    print("                   by config providers.")
-    print("profile.csv...   : n-number of profile csvs that describe the platform's")
-    print("                   overridden config knobs")
-    print("-pn names        : n-number of 2-character profile names that uniquely identify the")
-    print("                   profiles specified in profile.csv")
-
-
-def arg_parse():
-    parser = argparse.ArgumentParser()
-
-    parser.add_argument(
-        '-pn', '--profilenames', dest='profile_names', type=str, default=None,
-        help='''Specify the comma separated profile names by passing -pn <Name1,Name2> '''
-             '''or --profilenames <Name1,Name2,Name3>.''')
-
-    return parser.parse_known_args()
-
-
-def main():
-    # We should not overload the positional argument anymore given we are accepting nondeterministic number of space
-    # separated profile paths... So please add the new ones here...
-    known_args, left_over = arg_parse()
-    sys.argv = sys.argv[:1] + left_over
-
-    arg_num = 1
-    if len(sys.argv) < 2:
-        usage()
-        sys.stderr.write('Must provide a command.\n')
-        sys.exit(1)
-        return
-
-    if sys.argv[arg_num].lower() == "generateheader" or sys.argv[arg_num].lower() == "generateheader_efi":
-        if sys.argv[arg_num].lower() == "generateheader" and len(sys.argv) < 5:
-            usage()
-            sys.stderr.write('Invalid number of arguments.\n')
-            sys.exit(1)
-            return
-
-        if sys.argv[arg_num].lower() == "generateheader_efi" and len(sys.argv) < 6:
-            usage()
-            sys.stderr.write('Invalid number of arguments.\n')
-            sys.exit(1)
-            return
-
-        efi_type = sys.argv[arg_num].lower() == "generateheader_efi"
-        arg_num += 1
-
-        schema_path = sys.argv[arg_num]
-        arg_num += 1
-        header_path = sys.argv[arg_num]
-        arg_num += 1
-        service_path = sys.argv[arg_num]
-        arg_num += 1
-        data_path = None
-
-        if efi_type is True:
-            data_path = sys.argv[arg_num]
-            arg_num += 1
-
-        # Load the schema
-        schema = VariableList.Schema.load(schema_path)
-
-        generate_sources(schema, header_path, service_path, data_path, efi_type)
-
-        if (len(sys.argv) >= arg_num + 1):
-            profile_header_path = sys.argv[arg_num]
-            arg_num += 1
-            profile_paths = sys.argv[arg_num:]
-
-            if known_args.profile_names is not None:
-                # Do some minimal sanity checks
-                names = known_args.profile_names.split(",")
-                if len(names) != len(profile_paths):
-                    sys.stderr.write('Invalid count of profile names %d.\n' % len(names))
-                    return -1
-
-                lengths = [len(name) for name in names]
-                max_length = max(lengths)
-                min_length = min(lengths)
-
-                if max_length != 2 or min_length != 2:
-                    sys.stderr.write('Invalid profile names, should be 2-character for all entries.\n')
-                    return -1
-
-            generate_profiles(schema, profile_header_path, profile_paths, efi_type,
-                              profile_names=known_args.profile_names)
-        return 0
-
-
-if __name__ == '__main__':
-    sys.exit(main())
+# @ KnobService.py
+#
+# Generates C header files for a firmware component to consume UEFI variables
+# as configurable knobs
+#
+# Copyright (c) 2022, Microsoft Corporation. All rights reserved.
+#
+import os
+import sys
+import uuid
+import argparse
+import re
+import io
+import string
+import contextlib
+import functools
+import VariableList
+
+
+# Standard C type names and their UEFI equivalent
+UEFI_TYPE_STRINGS = {
+    "int8_t": "INT8",
+    "int16_t": "INT16",
+    "int32_t": "INT32",
+    "int64_t": "INT64",
+    "uint8_t": "UINT8",
+    "uint16_t": "UINT16",
+    "uint32_t": "UINT32",
+    "uint64_t": "UINT64",
+    "bool": "BOOLEAN",
+    "float": "float",
+    "double": "double",
+    "size_t": "UINTN",
+    "int": "INTN",
+    "const": "CONST",
+    "void*": "VOID *",
+    "char*": "CHAR8 *",
+    "config_guid_t": "EFI_GUID",
+    "void": "VOID"
+}
+
+
+# Converts a type name from standard C to UEFI
+def get_type_string(type_name, uefi=False):
+    if uefi:
+        return UEFI_TYPE_STRINGS.get(type_name, type_name)
+
+    return type_name
+
+
+# Converts a value from standard C to UEFI
+def get_value_string(value, uefi=False):
+    if value == "true" and uefi:
+        return "TRUE"
+    elif value == "false" and uefi:
+        return "FALSE"
+    else:
+        return value
+
+
+# UEFI uses 2 spaces, stdlibc uses 4 spaces
+def get_spacing_string(uefi=False, num=1):
+    if uefi is True:
+        return "  " * num
+
+    return "    " * num
+
+
+# UEFI style uses CRLF line endings
+def get_line_ending(uefi=False):
+    if uefi is True:
+        return "\r\n"
+
+    return "\n"
+
+
+# UEFI style uses #ifdef instead of pragma once
+def get_include_once_style(name, uefi=False, header=True):
+    if uefi is True:
+        # convert . to _
+        while match := re.search(r'\.', name):
+            name = name[:match.start()] + "_" + name[match.end():]
+        if header is True:
+            return "#ifndef " + name.upper() + get_line_ending(uefi) + "#define " + name.upper() + get_line_ending(uefi)
+        else:
+            return "#endif // " + name.upper() + get_line_ending(uefi)
+    elif header is True:
+        return "#pragma once" + get_line_ending(uefi)
+    else:
+        return get_line_ending(uefi)
+
+
+# Convert std libc variable/structure/type naming conventions to UEFI naming conventions. The same few names are
+# filtered for every knob, so the results are cached
+@functools.lru_cache(maxsize=None)
+def naming_convention_filter(value, type, uefi=False):
+    if not uefi:
+        return value
+
+    if type is True:
+        # types will be in format THIS_IS_THE_TYPE_NAME
+        # std libc likes to append '_t' to type names, strip that for UEFI
+        if value[-2:] == "_t":
+            value = value[:-2]
+        return value.upper()
+    else:
+        # fields and functions will be in format ThisIsTheName
+
+        # if the first char is an underscore, strip it
+        if value[0] == "_":
+            value = value[1:]
+
+        # capitalize first word (may be single word)
+        value = value[0].upper() + value[1:]
+
+        # remove any trailing underscore
+        if value[-1] == "_":
+            value = value[:-1]
+
+        # remove the underscores and capitalize each word
+        while match := re.search("_", value):
+            value = value[:match.start()] + value[match.end()].upper() + value[match.end() + 1:]
+
+    return value
+
+
+# return proper assert style for efi/non-efi builds
+def get_assert_style(uefi, assert_string, msg):
+    if uefi is True:
+        return "STATIC_ASSERT" + assert_string + ", " + msg + ");"
+
+    return "C_ASSERT" + assert_string + ");"
+
+
+# put a SPDX header on the generated files
+def get_spdx_header(header, efi_type):
+    spdx = "/** @file {}".format(header)
+    spdx += get_line_ending(efi_type) + get_line_ending(efi_type)
+    spdx += get_spacing_string(efi_type)
+    spdx += "Autogenerated configuration headers from mu_feature_config"
+    spdx += get_line_ending(efi_type) + get_line_ending(efi_type)
+    spdx += get_spacing_string(efi_type)
+    spdx += "Copyright (c) Microsoft Corporation."
+    spdx += get_line_ending(efi_type)
+    spdx += get_spacing_string(efi_type)
+    spdx += "SPDX-License-Identifier: BSD-2-Clause-Patent"
+    spdx += get_line_ending(efi_type)
+    spdx += get_line_ending(efi_type)
+    spdx += "**/"
+    spdx += get_line_ending(efi_type)
+    spdx += get_line_ending(efi_type)
+    return spdx
+
+
+# for UEFI, calculate what variable list size is for a given knob
+def get_variable_list_size(knob):
+    # fixed size per knob is Guid, Attributes, CRC, NameSize, DataSize
+    # we have to calculate the c sizes, not the bloated python sizes
+    # hence why __sizeof__() is not used here
+    size = 16 + 4 + 4 + 4 + 4
+
+    # variable size per knob is len of data and name
+    # the name we convert from schema ASCII to UEFI unicode
+    # And + 1 is to account for null terminator
+    size += (len(knob.name) + 1) * 2
+    size += knob.format.size_in_bytes()
+
+    return size
+
+
+# for UEFI, return the layout of the aligned variable list holding the given knobs
+def get_aligned_conf_policy_layout(knobs):
+    return VariableList.get_aligned_vlist_layout(
+        [((len(knob.name) + 1) * 2, knob.format.size_in_bytes()) for knob in knobs])
+
+
+# in UEFI builds we need to know what the size of the variable list constructed
+# from this data will be. Return value in bytes
+def get_conf_policy_size(knobs, aligned_policy=False):
+    if aligned_policy:
+        return get_aligned_conf_policy_layout(knobs)[0]
+
+    size = 0
+    for knob in knobs:
+        size += get_variable_list_size(knob)
+
+    return size
+
+
+# in UEFI builds, return the offset of each knob's data in the variable list formatted
+# config policy holding the given knobs, in schema order
+def get_conf_policy_data_offsets(knobs, aligned_policy=False):
+    if aligned_policy:
+        _, _, data_offset, _, data_offsets = get_aligned_conf_policy_layout(knobs)
+        return [data_offset + offset for offset in data_offsets]
+
+    offsets = []
+    offset = 0
+    for knob in knobs:
+        # the data comes after everything but the CRC32
+        offsets.append(offset + get_variable_list_size(knob) - 4 - knob.format.size_in_bytes())
+        offset += get_variable_list_size(knob)
+
+    return offsets
+
+
+# GetPolicy takes a UINT16 size, so this is the largest a single config policy can be
+MAX_CONF_POLICY_SIZE = 0xFFFF
+
+# The largest config policy CONFIG_LAZY_POLICY_CACHE fetches onto the stack, unless the consumer raises
+# CONFIG_LAZY_POLICY_MAX_SIZE
+LAZY_CONF_POLICY_MAX_SIZE = 0x1000
+
+
+# the running layout of a config policy as (knob count, names size, data size, policy size), before any knob
+EMPTY_CONF_POLICY_LAYOUT = (0, 0, 0, 0)
+
+
+# in UEFI builds, return the running layout of a config policy once knob is appended to it. The policy size matches
+# get_conf_policy_size of the knobs so far, without walking them again
+def append_conf_policy_knob(layout, knob, aligned_policy=False):
+    (count, names_size, data_size, size) = layout
+    count += 1
+    names_size += (len(knob.name) + 1) * 2
+    if not aligned_policy:
+        data_size += knob.format.size_in_bytes()
+        return (count, names_size, data_size, size + get_variable_list_size(knob))
+
+    # every value starts on an aligned offset of the data region, which follows the entries and the names
+    data_size = VariableList.align_up(data_size, VariableList.ALIGNED_VLIST_DATA_ALIGNMENT)
+    data_size += knob.format.size_in_bytes()
+    names_offset = VariableList.ALIGNED_VLIST_HEADER.size + VariableList.ALIGNED_VLIST_ENTRY.size * count
+    size = VariableList.align_up(names_offset + names_size, VariableList.ALIGNED_VLIST_DATA_ALIGNMENT) + data_size
+    return (count, names_size, data_size, size)
+
+
+# in UEFI builds, split the knobs in schema order into the config policies they are published in. Each policy is a
+# complete variable list of at most max_size bytes, published under its own GUID of PcdConfigurationPolicyGuid
+def get_conf_policy_chunks(schema, aligned_policy=False, max_size=MAX_CONF_POLICY_SIZE):
+    chunks = []
+    chunk = []
+    layout = EMPTY_CONF_POLICY_LAYOUT
+    for knob in schema.knobs:
+        knob_layout = append_conf_policy_knob(EMPTY_CONF_POLICY_LAYOUT, knob, aligned_policy)
+        if knob_layout[3] > max_size:
+            raise Exception("Knob {} does not fit in a config policy of {} bytes".format(knob.name, max_size))
+
+        layout = append_conf_policy_knob(layout, knob, aligned_policy)
+        if len(chunk) > 0 and layout[3] > max_size:
+            chunks.append(chunk)
+            chunk = []
+            layout = knob_layout
+        chunk.append(knob)
+    chunks.append(chunk)
+
+    return chunks
+
+
+# The constraints of a leaf of a knob, read once from the schema
+class KnobLeafLayout:
+    def __init__(self, knob, subknob):
+        # the path of the leaf from the knob, empty when the knob itself is the leaf
+        self.path = subknob.name[len(knob.name):]
+        self.define_name = subknob.name.replace('[', '_').replace(']', '_').replace('.', '__')
+        self.format = subknob.format
+        self.enum = isinstance(subknob.format, VariableList.EnumFormat)
+        self.min = subknob.min
+        self.max = subknob.max
+        self.has_min = self.min != subknob.format.min
+        self.has_max = self.max != subknob.format.max
+
+
+# The generated layout of a knob: its sizes, its leaves and where it is published
+class KnobLayout:
+    def __init__(self, knob):
+        self.knob = knob
+        self.value_size = knob.format.size_in_bytes()
+        self.leaves = [KnobLeafLayout(knob, subknob) for subknob in knob.subknobs if subknob.leaf]
+        # true if any leaf of the knob is constrained beyond what its type allows
+        self.constrained = any(leaf.enum or leaf.has_min or leaf.has_max for leaf in self.leaves)
+        # in UEFI builds, the config policy holding the knob and the offset of its data in that policy
+        self.policy = None
+        self.policy_offset = None
+
+
+# The layout of every knob of a schema, and in UEFI builds the config policies they are published in. It is computed
+# once and shared by the generated headers, rather than each header walking the knobs again
+class SchemaLayout:
+    def __init__(self, schema, efi_type=False, aligned_policy=False, max_policy_size=MAX_CONF_POLICY_SIZE):
+        self.knobs = [KnobLayout(knob) for knob in schema.knobs]
+        self.knob_layouts = {(layout.knob.namespace, layout.knob.name): layout for layout in self.knobs}
+        self.chunks = None
+        self.policy_sizes = None
+
+        if efi_type:
+            self.chunks = get_conf_policy_chunks(schema, aligned_policy, max_policy_size)
+            self.policy_sizes = [get_conf_policy_size(chunk, aligned_policy) for chunk in self.chunks]
+            for policy, chunk in enumerate(self.chunks):
+                for knob, offset in zip(chunk, get_conf_policy_data_offsets(chunk, aligned_policy)):
+                    self.get_knob_layout(knob).policy = policy
+                    self.get_knob_layout(knob).policy_offset = offset
+
+    # knob names are only unique within a namespace
+    def get_knob_layout(self, knob):
+        return self.knob_layouts[(knob.namespace, knob.name)]
+
+
+# the comment heading the generated declarations and implementations of a knob
+def get_knob_comment(knob, efi_type):
+    comment = "// {} knob".format(knob.name) + get_line_ending(efi_type)
+    if knob.help != "":
+        comment += "// {}".format(knob.help) + get_line_ending(efi_type)
+
+    return comment
+
+
+# Build a template of generated code from its lines, indented by the number of spacing strings each is paired with.
+# The placeholders of the knob are substituted for each knob, so the fixed code is only formatted once
+def get_code_template(efi_type, lines):
+    le = get_line_ending(efi_type)
+    return string.Template("".join(get_spacing_string(efi_type, indent) + line + le for (indent, line) in lines))
+
+
+# write getter implementations. In stdlibc projects this is part of the data header
+# for UEFI, this is separate from the data header
+def write_uefi_getter_implementations(efi_type, out, chunks, layout):
+    getter = get_code_template(efi_type, [
+        (0, "// Get the current value of the ${name} knob"),
+        (0, "EFI_STATUS " + naming_convention_filter("config_get_", False, efi_type) + "${name} ("),
+        (1, "${c_type} *Knob"),
+        (1, ")"),
+        (0, "{"),
+        (1, "EFI_STATUS Status;"),
+        (0, ""),
+        (1, "if (Knob == NULL) {"),
+        (2, "return EFI_INVALID_PARAMETER;"),
+        (1, "}"),
+        (0, ""),
+        (0, "#ifdef CONFIG_LAZY_POLICY_CACHE"),
+        (1, "Status = ReadConfigPolicy (${policy}, ${policy_offset}, Knob, sizeof (${c_type}));"),
+        (1, "if (EFI_ERROR (Status)) {"),
+        (2, "ASSERT (FALSE);"),
+        (2, "return Status;"),
+        (1, "}"),
+        (0, "#else"),
+        (1, "if (!CachedPolicyInitialized[${policy}]) {"),
+        (2, "Status = InitConfigPolicyCache (${policy});"),
+        (2, "if (EFI_ERROR (Status)) {"),
+        (3, "ASSERT (FALSE);"),
+        (3, "return Status;"),
+        (2, "}"),
+        (1, "}"),
+        (0, ""),
+        (1, "CopyMem(Knob, &CachedKnobValues.${name}, sizeof (${c_type}));"),
+        (0, "#endif // CONFIG_LAZY_POLICY_CACHE"),
+        (1, "return EFI_SUCCESS;"),
+        (0, "}"),
+        (0, ""),
+    ])
+
+    out.write("// Schema-defined knobs" + get_line_ending(efi_type))
+    for policy, chunk in enumerate(chunks):
+        for knob in chunk:
+            out.write(get_knob_comment(knob, efi_type) + getter.substitute(
+                name=knob.name,
+                c_type=get_type_string(knob.format.c_type, efi_type),
+                policy=policy,
+                policy_offset=layout.get_knob_layout(knob).policy_offset))
+
+    out.write("#ifdef CONFIG_LAZY_POLICY_CACHE" + get_line_ending(efi_type))
+    out.write(get_code_template(efi_type, [
+        (0, "// Read the current value of every knob at once into Values. Nothing is cached, every config policy is"),
+        (0, "// fetched again into a stack buffer."),
+        (0, "EFI_STATUS"),
+        (0, naming_convention_filter("config_read_knob_values", False, efi_type) + " ("),
+        (1, "OUT KNOB_VALUES  *Values"),
+        (1, ")"),
+        (0, "{"),
+        (1, "EFI_STATUS Status;"),
+        (1, "UINTN      Index;"),
+        (1, "UINT64     Buffer[(CONFIG_POLICY_MAX_SIZE + 7) / 8];"),
+        (0, ""),
+        (1, "if (Values == NULL) {"),
+        (2, "return EFI_INVALID_PARAMETER;"),
+        (1, "}"),
+        (0, ""),
+        (1, "for (Index = 0; Index < CONFIG_POLICY_COUNT; Index++) {"),
+        (2, "Status = FetchConfigPolicy (Index, (CHAR8 *)Buffer);"),
+        (2, "if (EFI_ERROR (Status)) {"),
+        (3, "ASSERT (FALSE);"),
+        (3, "return Status;"),
+        (2, "}"),
+        (0, ""),
+        (2, "DecodeConfigPolicy (Index, (CHAR8 *)Buffer, Values);"),
+        (0, "#ifdef CONFIG_POLICY_TELEMETRY"),
+        (2, "ConfigPerfCounterAdd (ConfigPerfCounterEntriesParsed, CachedPolicyKnobCount[Index]);"),
+        (0, "#endif // CONFIG_POLICY_TELEMETRY"),
+        (1, "}"),
+        (0, ""),
+        (1, "return EFI_SUCCESS;"),
+        (0, "}"),
+        (0, "#else"),
+    ]).substitute())
+
+    out.write("// Get the current value of every knob at once. The values are decoded once into a naturally" +
+              get_line_ending(efi_type))
+    out.write("// aligned structure, so hot consumers can read its fields directly. Returns NULL on failure." +
+              get_line_ending(efi_type))
+    out.write("CONST KNOB_VALUES *" + get_line_ending(efi_type))
+    out.write(naming_convention_filter("config_get_knob_values", False, efi_type) + " (" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type) + "VOID" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type) + ")" + get_line_ending(efi_type))
+    out.write("{" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type) + "EFI_STATUS Status;" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type) + "UINTN      Index;" + get_line_ending(efi_type))
+    out.write(get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type))
+    out.write("for (Index = 0; Index < CONFIG_POLICY_COUNT; Index++) {" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, num=2))
+    out.write("if (!CachedPolicyInitialized[Index]) {" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, num=3))
+    out.write("Status = InitConfigPolicyCache (Index);" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, num=3))
+    out.write("if (EFI_ERROR (Status)) {" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, num=4))
+    out.write("ASSERT (FALSE);" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, num=4))
+    out.write("return NULL;" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, num=3))
+    out.write("}" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, num=2))
+    out.write("}" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type))
+    out.write("}" + get_line_ending(efi_type))
+    out.write(get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type) + "return &CachedKnobValues;" + get_line_ending(efi_type))
+    out.write("}" + get_line_ending(efi_type))
+    out.write("#endif // CONFIG_LAZY_POLICY_CACHE" + get_line_ending(efi_type))
+    out.write(get_line_ending(efi_type))
+
+
+# Opens a generated file for writing. The content is buffered, and the file is only rewritten when the content
+# changes, so that an unchanged header keeps its timestamp and dependent modules are not rebuilt
+@contextlib.contextmanager
+def open_generated_file(path):
+    out = io.StringIO()
+    yield out
+
+    content = out.getvalue()
+    try:
+        with open(path, 'r', newline='') as existing:
+            if existing.read() == content:
+                return
+    except (OSError, UnicodeDecodeError):
+        pass
+
+    with open(path, 'w', newline='') as generated:
+        generated.write(content)
+
+
+def generate_public_header(schema, header_path, efi_type=False, layout=None):
+    if layout is None:
+        layout = SchemaLayout(schema)
+
+    format_options = VariableList.StringFormatOptions()
+    format_options.c_format = True
+    format_options.efi_format = efi_type
+
+    with open_generated_file(header_path) as out:
+        out.write(get_spdx_header(header_path, efi_type))
+        out.write(get_include_once_style(header_path, uefi=efi_type, header=True))
+        # UEFI uses Uefi.h instead of std libc headers
+        if efi_type:
+            out.write("#include <Uefi.h>" + get_line_ending(efi_type))
+        else:
+            out.write("#include <stdint.h>" + get_line_ending(efi_type))
+            out.write("#include <stddef.h>" + get_line_ending(efi_type))
+            out.write("#include <stdbool.h>" + get_line_ending(efi_type))
+        out.write("// Generated Header" + get_line_ending(efi_type))
+        out.write("//  Script: {}".format(sys.argv[0]) + get_line_ending(efi_type))
+        out.write("//  Schema: {}".format(schema.path) + get_line_ending(efi_type))
+        out.write("" + get_line_ending(efi_type))
+        # UEFI code uses STATIC_ASSERT, already defined in the environment
+        if not efi_type:
+            out.write("#ifndef C_ASSERT" + get_line_ending(efi_type))
+            out.write("// Statically verify an expression" + get_line_ending(efi_type))
+            out.write("#define C_ASSERT(e) typedef char __C_ASSERT__[(e)?1:-1]" + get_line_ending(efi_type))
+            out.write("#endif" + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+            out.write("#ifdef CONFIG_KNOB_STATISTICS" + get_line_ending(efi_type))
+            out.write("#include <stdatomic.h>" + get_line_ending(efi_type))
+            out.write("#include <stdio.h>" + get_line_ending(efi_type))
+            out.write("#endif // CONFIG_KNOB_STATISTICS" + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+        out.write("#pragma pack(push, 1)")
+        out.write("" + get_line_ending(efi_type))
+        out.write("// Schema-defined enums" + get_line_ending(efi_type))
+        for enum in schema.enums:
+            if enum.help != "":
+                out.write("// {}".format(enum.help) + get_line_ending(efi_type))
+            out.write("typedef enum {" + get_line_ending(efi_type))
+            has_negative = False
+            for value in enum.values:
+                if value.help != "":
+                    out.write(get_spacing_string(efi_type) + "{}_{} = {}, // {}".format(
+                        enum.name,
+                        value.name,
+                        value.number,
+                        value.help
+                    ) + get_line_ending(efi_type))
+                else:
+                    out.write(get_spacing_string(efi_type) + "{}_{} = {},".format(
+                        enum.name,
+                        value.name,
+                        value.number
+                    ) + get_line_ending(efi_type))
+
+                if value.number < 0:
+                    has_negative = True
+            if has_negative:
+                out.write(get_spacing_string(efi_type) + "_{}_PADDING = 0x7fffffff // Force packing to int size".format(
+                    enum.name
+                ) + get_line_ending(efi_type))
+            else:
+                out.write(get_spacing_string(efi_type) + "_{}_PADDING = 0xffffffff // Force packing to int size".format(
+                    enum.name
+                ) + get_line_ending(efi_type))
+            out.write("}} {};".format(enum.name) + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+            assert_string = f"(sizeof({enum.name}) == sizeof({get_type_string('uint32_t', efi_type)})"
+            out.write(get_assert_style(efi_type, assert_string, '"enum must be unsigned 32 bit int"'))
+            out.write(get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+            pass
+
+        out.write("// Schema-defined structures" + get_line_ending(efi_type))
+        for struct_definition in schema.structs:
+            if struct_definition.help != "":
+                out.write("// {}".format(struct_definition.help) + get_line_ending(efi_type))
+            out.write("typedef struct {" + get_line_ending(efi_type))
+            for member in struct_definition.members:
+                if member.help != "":
+                    out.write(get_spacing_string(efi_type) + "// {}".format(member.help) + get_line_ending(efi_type))
+                if member.count == 1:
+                    out.write(get_spacing_string(efi_type) + "{} {};".format(
+                        get_type_string(member.format.c_type, efi_type),
+                        member.name) + get_line_ending(efi_type))
+                else:
+                    out.write(get_spacing_string(efi_type) + "{} {}[{}];".format(
+                        get_type_string(member.format.c_type, efi_type),
+                        member.name,
+                        member.count) + get_line_ending(efi_type))
+
+            out.write("}} {};".format(struct_definition.name) + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+            out.write(get_assert_style(efi_type, "(sizeof({}) == {}".format(
+                struct_definition.name,
+                struct_definition.size_in_bytes()
+            ), '"structure size must be consistent"') + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+            pass
+        out.write("#pragma pack(pop)" + get_line_ending(efi_type))
+        out.write("" + get_line_ending(efi_type))
+        # the values of every knob, left naturally aligned so consumers can read the fields directly
+        out.write("typedef struct {" + get_line_ending(efi_type))
+        for knob in schema.knobs:
+            out.write(get_spacing_string(efi_type) + "{} {};".format(
+                get_type_string(knob.format.c_type, efi_type),
+                knob.name) + get_line_ending(efi_type))
+        out.write("}" + " {};".format(
+            naming_convention_filter("knob_values_t", True, efi_type)
+        ) + get_line_ending(efi_type))
+        out.write("" + get_line_ending(efi_type))
+        out.write("// Schema-defined knobs" + get_line_ending(efi_type))
+        for knob in schema.knobs:
+            out.write(get_knob_comment(knob, efi_type))
+
+            out.write("" + get_line_ending(efi_type))
+            for leaf in layout.get_knob_layout(knob).leaves:
+                if leaf.has_min:
+                    out.write("#define KNOB__{}__MIN {}".format(
+                        leaf.define_name,
+                        leaf.format.object_to_string(leaf.min, format_options)) + get_line_ending(efi_type))
+                if leaf.has_max:
+                    out.write("#define KNOB__{}__MAX {}".format(
+                        leaf.define_name,
+                        leaf.format.object_to_string(leaf.max, format_options)) + get_line_ending(efi_type))
+
+            out.write("" + get_line_ending(efi_type))
+            # uefi has getters return a status and pass in a ptr
+            if not efi_type:
+                out.write("// Get the current value of the {} knob".format(knob.name) + get_line_ending(efi_type))
+                out.write("{} {}{}();".format(
+                    get_type_string(knob.format.c_type, efi_type),
+                    naming_convention_filter("config_get_",
+                                             False,
+                                             efi_type),
+                    knob.name))
+                out.write("" + get_line_ending(efi_type))
+            else:
+                out.write("EFI_STATUS {}{} (".format(
+                    naming_convention_filter("config_get_", False, efi_type),
+                    knob.name
+                ))
+                out.write("{} *Knob);".format(
+                    get_type_string(knob.format.c_type, efi_type)
+                ) + get_line_ending(efi_type))
+
+            # no concept of setting config variables in UEFI
+            if not efi_type:
+                out.write("#ifdef CONFIG_SET_VARIABLES" + get_line_ending(efi_type))
+                out.write("// Set the current value of the {} knob".format(knob.name) + get_line_ending(efi_type))
+                out.write("{} config_set_{}({} value);".format(
+                    get_type_string('bool', efi_type),
+                    knob.name,
+                    get_type_string(knob.format.c_type, efi_type),
+                ) + get_line_ending(efi_type))
+                out.write("#endif // CONFIG_SET_VARIABLES" + get_line_ending(efi_type))
+                out.write("" + get_line_ending(efi_type))
+            pass
+
+        if not efi_type:
+            out.write("#ifdef CONFIG_CONCURRENT_CACHE" + get_line_ending(efi_type))
+            out.write("// Copy the current value of every knob at once, as one consistent snapshot" +
+                      get_line_ending(efi_type))
+            out.write("void config_get_knob_values(knob_values_t* values);" + get_line_ending(efi_type))
+            out.write("#endif // CONFIG_CONCURRENT_CACHE" + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+            out.write("#ifdef CONFIG_KNOB_STATISTICS" + get_line_ending(efi_type))
+            out.write("// Print the get and set counts of every knob as CSV rows of the knob name, gets and sets" +
+                      get_line_ending(efi_type))
+            out.write("void config_dump_knob_statistics(FILE* stream);" + get_line_ending(efi_type))
+            out.write("// Zero the get and set counts of every knob" + get_line_ending(efi_type))
+            out.write("void config_reset_knob_statistics(void);" + get_line_ending(efi_type))
+            out.write("#endif // CONFIG_KNOB_STATISTICS" + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+
+        if efi_type:
+            out.write("#ifdef CONFIG_LAZY_POLICY_CACHE" + get_line_ending(efi_type))
+            out.write("// Read the current value of every knob at once into Values" + get_line_ending(efi_type))
+            out.write("EFI_STATUS {} (OUT KNOB_VALUES *Values);".format(
+                naming_convention_filter("config_read_knob_values", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("#else" + get_line_ending(efi_type))
+            out.write("// Get the current value of every knob at once, NULL on failure" + get_line_ending(efi_type))
+            out.write("CONST KNOB_VALUES *{} (VOID);".format(
+                naming_convention_filter("config_get_knob_values", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("#endif // CONFIG_LAZY_POLICY_CACHE" + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+
+        out.write("" + get_line_ending(efi_type))
+        # UEFI uses a core header with the standard definitions
+        # so we must use #defines instead of the enum
+        if efi_type is False:
+            out.write("typedef enum {" + get_line_ending(efi_type))
+            for knob in schema.knobs:
+                out.write(get_spacing_string(efi_type) + "KNOB_{},".format(knob.name) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "KNOB_MAX" + get_line_ending(efi_type))
+            out.write("}" + " {};".format(
+                naming_convention_filter("knob_t", True, efi_type)) + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+            out.write("#ifdef CONFIG_CONCURRENT_CACHE" + get_line_ending(efi_type))
+            out.write("// Copy the current value of a knob into value, which holds the value_size of the knob" +
+                      get_line_ending(efi_type))
+            out.write("bool config_read_knob_value(knob_t knob, void* value);" + get_line_ending(efi_type))
+            out.write("#ifdef CONFIG_SET_VARIABLES" + get_line_ending(efi_type))
+            out.write("// Validate value and publish it as the current value of a knob" + get_line_ending(efi_type))
+            out.write("bool config_write_knob_value(knob_t knob, const void* value);" + get_line_ending(efi_type))
+            out.write("#endif // CONFIG_SET_VARIABLES" + get_line_ending(efi_type))
+            out.write("// get_knob_value, set_knob_value, apply_profile_bitmap and the cache_value_address of" +
+                      get_line_ending(efi_type))
+            out.write("// g_knob_data use g_knob_cached_values directly, bypassing the copies above: they are not" +
+                      get_line_ending(efi_type))
+            out.write("// safe while knobs are set concurrently, use the functions above instead" +
+                      get_line_ending(efi_type))
+            out.write("#endif // CONFIG_CONCURRENT_CACHE" + get_line_ending(efi_type))
+        else:
+            idx = 0
+            for knob in schema.knobs:
+                out.write("#define KNOB_{} {}".format(
+                    knob.name,
+                    idx
+                ) + get_line_ending(efi_type))
+                idx += 1
+            out.write("#define KNOB_MAX {}".format(idx))
+        out.write("" + get_line_ending(efi_type))
+        # UEFI already defines EFI_GUID and puts these
+        # definitions in a standard core header
+        if not efi_type:
+            out.write("typedef struct {" + get_line_ending(efi_type))
+            out.write("    unsigned long  Data1;" + get_line_ending(efi_type))
+            out.write("    unsigned short Data2;" + get_line_ending(efi_type))
+            out.write("    unsigned short Data3;" + get_line_ending(efi_type))
+            out.write("    unsigned char  Data4[8];" + get_line_ending(efi_type))
+            out.write("} config_guid_t;" + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+            # the statistics are only counted when CONFIG_KNOB_STATISTICS is defined, with relaxed atomics
+            out.write("typedef struct {" + get_line_ending(efi_type))
+            out.write("#ifdef CONFIG_KNOB_STATISTICS" + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "atomic_ullong {};".format(
+                naming_convention_filter("get_count", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "atomic_ullong {};".format(
+                naming_convention_filter("set_count", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("#else // CONFIG_KNOB_STATISTICS" + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {};".format(
+                get_type_string("int", efi_type),
+                naming_convention_filter("get_count", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {};".format(
+                get_type_string("int", efi_type),
+                naming_convention_filter("set_count", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("#endif // CONFIG_KNOB_STATISTICS" + get_line_ending(efi_type))
+            out.write("}" + " {};".format(
+                naming_convention_filter("knob_statistics_t", True, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+            out.write("typedef {} ({})({} {});".format(
+                get_type_string('bool', efi_type),
+                naming_convention_filter("knob_validation_fn", True, efi_type),
+                get_type_string("const", efi_type),
+                get_type_string("void*", efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+            out.write("typedef struct {" + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {};".format(
+                naming_convention_filter("knob_t", True, efi_type),
+                naming_convention_filter("knob", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {} {};".format(
+                get_type_string("const", efi_type),
+                get_type_string("void*", efi_type),
+                naming_convention_filter("default_value_address", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {};".format(
+                get_type_string("void*", efi_type),
+                naming_convention_filter("cache_value_address", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {};".format(
+                get_type_string('size_t', efi_type),
+                naming_convention_filter("value_size", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {} {};".format(
+                get_type_string("const", efi_type),
+                get_type_string("char*", efi_type),
+                naming_convention_filter("name", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {};".format(
+                get_type_string('size_t', efi_type),
+                naming_convention_filter("name_size", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {};".format(
+                get_type_string("config_guid_t", efi_type),
+                naming_convention_filter("vendor_namespace", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {};".format(
+                get_type_string("int", efi_type),
+                naming_convention_filter("attributes", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {};".format(
+                naming_convention_filter("knob_statistics_t", True, efi_type),
+                naming_convention_filter("statistics", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {};".format(
+                naming_convention_filter("knob_validation_fn*", True, efi_type),
+                naming_convention_filter("validator", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("}" + " {};".format(
+                naming_convention_filter("knob_data_t", True, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+            out.write("typedef struct {" + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {};".format(
+                naming_convention_filter("knob_t", True, efi_type),
+                naming_convention_filter("knob", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {};".format(
+                get_type_string("void*", efi_type),
+                naming_convention_filter("value", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("}" + " {};".format(
+                naming_convention_filter("knob_override_t", True, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+            out.write("typedef struct {" + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{}* {};".format(
+                naming_convention_filter("knob_override_t", True, efi_type),
+                naming_convention_filter("overrides", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {};".format(
+                get_type_string('size_t', efi_type),
+                naming_convention_filter("override_count", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("}" + " {};".format(
+                naming_convention_filter("profile_t", True, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+            out.write("typedef struct {" + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {}* {};".format(
+                get_type_string("const", efi_type),
+                get_type_string("uint8_t", efi_type),
+                naming_convention_filter("bitmap", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {}* {};".format(
+                get_type_string("const", efi_type),
+                get_type_string("uint8_t", efi_type),
+                naming_convention_filter("values", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {};".format(
+                get_type_string('size_t', efi_type),
+                naming_convention_filter("values_size", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("}" + " {};".format(
+                naming_convention_filter("profile_bitmap_t", True, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+            out.write("typedef struct {" + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {}* {};".format(
+                get_type_string("const", efi_type),
+                get_type_string("uint8_t", efi_type),
+                naming_convention_filter("policy", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "{} {};".format(
+                get_type_string('size_t', efi_type),
+                naming_convention_filter("policy_size", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("}" + " {};".format(
+                naming_convention_filter("profile_policy_t", True, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+            out.write("#define KNOB_CONSTRAINT_UNSIGNED {}".format(KNOB_CONSTRAINT_UNSIGNED) +
+                      get_line_ending(efi_type))
+            out.write("#define KNOB_CONSTRAINT_SIGNED {}".format(KNOB_CONSTRAINT_SIGNED) + get_line_ending(efi_type))
+            out.write("#define KNOB_CONSTRAINT_ENUM {}".format(KNOB_CONSTRAINT_ENUM) + get_line_ending(efi_type))
+            out.write("typedef struct {" + get_line_ending(efi_type))
+            for (field_type, field) in [("uint64_t", "min"), ("uint64_t", "max"), ("uint32_t", "value_offset"),
+                                        ("uint32_t", "offset"), ("uint8_t", "width"), ("uint8_t", "kind")]:
+                out.write(get_spacing_string(efi_type) + "{} {};".format(
+                    get_type_string(field_type, efi_type),
+                    naming_convention_filter(field, False, efi_type)
+                ) + get_line_ending(efi_type))
+            out.write("}" + " {};".format(
+                naming_convention_filter("knob_constraint_t", True, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+        out.write(get_include_once_style(header_path, uefi=efi_type, header=False))
+
+
+# every knob of a namespace shares its GUID, so the formatted GUIDs are cached
+@functools.lru_cache(maxsize=None)
+def format_guid(guid):
+    u = uuid.UUID(guid)
+
+    byte_sequence = u.fields[3].to_bytes(1, byteorder='big') + \
+                    u.fields[4].to_bytes(1, byteorder='big') + \
+                    u.fields[5].to_bytes(6, byteorder='big')
+
+    return "{{{},{},{},{{{},{},{},{},{},{},{},{}}}}}".format(
+        hex(u.fields[0]),
+        hex(u.fields[1]),
+        hex(u.fields[2]),
+        hex(byte_sequence[0]),
+        hex(byte_sequence[1]),
+        hex(byte_sequence[2]),
+        hex(byte_sequence[3]),
+        hex(byte_sequence[4]),
+        hex(byte_sequence[5]),
+        hex(byte_sequence[6]),
+        hex(byte_sequence[7]))
+
+
+# FNV-1a parameters used to hash (VendorNamespace, Name) of a knob, mirrored by the generated KnobNameHash
+KNOB_HASH_PRIME = 0x01000193
+KNOB_HASH_OFFSET_BASIS = 0x811c9dc5
+
+
+# Hash a knob name followed by its namespace GUID fields, byte by byte and least significant byte first, so that the
+# result does not depend on the size of the GUID fields in the target environment
+def knob_name_hash(namespace, name, seed):
+    u = uuid.UUID(namespace)
+    data = name.encode("ascii")
+    data += u.fields[0].to_bytes(4, byteorder='little')
+    data += u.fields[1].to_bytes(2, byteorder='little')
+    data += u.fields[2].to_bytes(2, byteorder='little')
+    data += u.bytes[8:]
+
+    hash = seed
+    for byte in data:
+        hash = ((hash ^ byte) * KNOB_HASH_PRIME) & 0xFFFFFFFF
+
+    return hash
+
+
+# Scramble a knob hash after it was displaced, mirrored by the generated LookupKnobByName
+def knob_hash_mix(value):
+    value ^= value >> 16
+    value = (value * 0x45d9f3b) & 0xFFFFFFFF
+    value ^= value >> 16
+    return value
+
+
+# Build a minimal perfect hash over (VendorNamespace, Name) of the schema knobs using hash and displace: each knob
+# hash selects a bucket, and each bucket gets a displacement that sends all of its knobs to distinct free slots.
+# Returns the seed, the per bucket displacements and the knob index held by each slot
+def build_knob_perfect_hash(knobs, max_seeds=64, max_displacement=0x100000):
+    slot_count = len(knobs)
+    bucket_count = max(1, (slot_count + 3) // 4)
+
+    for seed in range(KNOB_HASH_OFFSET_BASIS, KNOB_HASH_OFFSET_BASIS + max_seeds):
+        hashes = [knob_name_hash(knob.namespace, knob.name, seed) for knob in knobs]
+        if len(set(hashes)) != len(hashes):
+            # two knobs share a full hash, no displacement can separate them
+            continue
+
+        buckets = [[] for _ in range(bucket_count)]
+        for idx, hash in enumerate(hashes):
+            buckets[hash % bucket_count].append(idx)
+
+        displacements = [0] * bucket_count
+        slots = [None] * slot_count
+        # place the largest buckets first, while most slots are still free
+        for bucket in sorted(range(bucket_count), key=lambda b: len(buckets[b]), reverse=True):
+            if len(buckets[bucket]) == 0:
+                break
+
+            bucket_hashes = [hashes[idx] for idx in buckets[bucket]]
+            for displacement in range(max_displacement):
+                # most displacements of the last buckets hit a taken slot with their first knob, stop there
+                candidate = []
+                for hash in bucket_hashes:
+                    slot = knob_hash_mix(hash ^ displacement) % slot_count
+                    if slots[slot] is not None or slot in candidate:
+                        break
+                    candidate.append(slot)
+                else:
+                    break
+            else:
+                break
+
+            displacements[bucket] = displacement
+            for idx, slot in zip(buckets[bucket], candidate):
+                slots[slot] = idx
+
+        if None not in slots:
+            return seed, displacements, slots
+
+    raise ValueError("Unable to build a perfect hash over the schema knob names")
+
+
+# Write the perfect hash tables and LookupKnobByName, which finds a knob by (VendorNamespace, Name) with one hash
+# and one compare
+def write_knob_lookup_implementation(efi_type, out, schema):
+    u32 = get_type_string("uint32_t", efi_type)
+    u8 = get_type_string("uint8_t", efi_type)
+    size = get_type_string("size_t", efi_type)
+    const = get_type_string("const", efi_type)
+    guid = get_type_string("config_guid_t", efi_type)
+    char = get_type_string("char*", efi_type).rstrip(" *")
+    knob_data = naming_convention_filter("knob_data_t", True, efi_type)
+    knob_data_global = "g" + naming_convention_filter("_knob_data", False, efi_type)
+    displacements_global = "g" + naming_convention_filter("_knob_hash_displacements", False, efi_type)
+    slots_global = "g" + naming_convention_filter("_knob_hash_slots", False, efi_type)
+    hash_fn = naming_convention_filter("knob_name_hash", False, efi_type)
+    lookup_fn = naming_convention_filter("lookup_knob_by_name", False, efi_type)
+    vendor_namespace = naming_convention_filter("vendor_namespace", False, efi_type)
+    name = naming_convention_filter("name", False, efi_type)
+    name_size = naming_convention_filter("name_size", False, efi_type)
+    hash_var = naming_convention_filter("hash", False, efi_type)
+    slot_var = naming_convention_filter("slot", False, efi_type)
+    index_var = naming_convention_filter("index", False, efi_type)
+    data_var = naming_convention_filter("data", False, efi_type)
+    null = "NULL"
+    le = get_line_ending(efi_type)
+    sp = get_spacing_string(efi_type)
+
+    out.write(le)
+    out.write("// Find a knob by its namespace and name, returns {} if there is no such knob".format(null) + le)
+    if len(schema.knobs) == 0:
+        out.write("{}* {}({} {}* {}, {} {}* {})".format(
+            knob_data, lookup_fn, const, guid, vendor_namespace, const, char, name) + le)
+        out.write("{" + le)
+        out.write(sp + "({}){};".format(get_type_string("void", efi_type), vendor_namespace) + le)
+        out.write(sp + "({}){};".format(get_type_string("void", efi_type), name) + le)
+        out.write(sp + "return {};".format(null) + le)
+        out.write("}" + le)
+        return
+
+    seed, displacements, slots = build_knob_perfect_hash(schema.knobs)
+
+    out.write("// Minimal perfect hash over (VendorNamespace, Name) of every knob, built by KnobService.py" + le)
+    out.write("#define KNOB_HASH_SEED {}".format(hex(seed)) + le)
+    out.write("#define KNOB_HASH_PRIME {}".format(hex(KNOB_HASH_PRIME)) + le)
+    out.write("#define KNOB_HASH_BUCKETS {}".format(len(displacements)) + le)
+    out.write(le)
+    out.write("{} {} {}[KNOB_HASH_BUCKETS] = {{".format(const, u32, displacements_global) + le)
+    for displacement in displacements:
+        out.write(sp + "{},".format(hex(displacement)) + le)
+    out.write("};" + le)
+    out.write(le)
+    out.write("{} {} {}[KNOB_MAX] = {{".format(const, size, slots_global) + le)
+    for idx in slots:
+        out.write(sp + "KNOB_{},".format(schema.knobs[idx].name) + le)
+    out.write("};" + le)
+    out.write(le)
+
+    # hash the name, then the GUID fields least significant byte first, matching knob_name_hash
+    out.write("{} {}({} {}* {}, {} {}* {})".format(
+        u32, hash_fn, const, guid, vendor_namespace, const, char, name) + le)
+    out.write("{" + le)
+    out.write(sp + "{} {} = KNOB_HASH_SEED;".format(u32, hash_var) + le)
+    out.write(sp + "{} {};".format(size, index_var) + le)
+    out.write(le)
+    out.write(sp + "for ({0} = 0; {1}[{0}] != 0; {0}++) {{".format(index_var, name) + le)
+    out.write(sp * 2 + "{0} = ({0} ^ ({1}){2}[{3}]) * KNOB_HASH_PRIME;".format(hash_var, u8, name, index_var) + le)
+    out.write(sp + "}" + le)
+    for field, length in (("Data1", 4), ("Data2", 2), ("Data3", 2)):
+        out.write(sp + "for ({0} = 0; {0} < {1}; {0}++) {{".format(index_var, length) + le)
+        out.write(sp * 2 + "{0} = ({0} ^ ({1})({2}->{3} >> (8 * {4}))) * KNOB_HASH_PRIME;".format(
+            hash_var, u8, vendor_namespace, field, index_var) + le)
+        out.write(sp + "}" + le)
+    out.write(sp + "for ({0} = 0; {0} < 8; {0}++) {{".format(index_var) + le)
+    out.write(sp * 2 + "{0} = ({0} ^ {1}->Data4[{2}]) * KNOB_HASH_PRIME;".format(
+        hash_var, vendor_namespace, index_var) + le)
+    out.write(sp + "}" + le)
+    out.write(sp + "return {};".format(hash_var) + le)
+    out.write("}" + le)
+    out.write(le)
+
+    out.write("{}* {}({} {}* {}, {} {}* {})".format(
+        knob_data, lookup_fn, const, guid, vendor_namespace, const, char, name) + le)
+    out.write("{" + le)
+    out.write(sp + "{} {};".format(u32, hash_var) + le)
+    out.write(sp + "{} {};".format(u32, slot_var) + le)
+    out.write(sp + "{} {};".format(size, index_var) + le)
+    out.write(sp + "{}* {};".format(knob_data, data_var) + le)
+    out.write(le)
+    out.write(sp + "if (({} == {}) || ({} == {})) {{".format(vendor_namespace, null, name, null) + le)
+    out.write(sp * 2 + "return {};".format(null) + le)
+    out.write(sp + "}" + le)
+    out.write(le)
+    # displace and mix, matching knob_hash_mix
+    out.write(sp + "{} = {}({}, {});".format(hash_var, hash_fn, vendor_namespace, name) + le)
+    out.write(sp + "{0} = {1} ^ {2}[{1} % KNOB_HASH_BUCKETS];".format(slot_var, hash_var, displacements_global) + le)
+    out.write(sp + "{0} ^= {0} >> 16;".format(slot_var) + le)
+    out.write(sp + "{0} *= 0x45d9f3b;".format(slot_var) + le)
+    out.write(sp + "{0} ^= {0} >> 16;".format(slot_var) + le)
+    out.write(sp + "{0} = &{1}[{2}[{3} % KNOB_MAX]];".format(data_var, knob_data_global, slots_global, slot_var) + le)
+    out.write(le)
+    out.write(sp + "// the name size includes the null terminator, so a longer or shorter name mismatches here" + le)
+    out.write(sp + "for ({0} = 0; {0} < {1}->{2}; {0}++) {{".format(index_var, data_var, name_size) + le)
+    out.write(sp * 2 + "if ({0}->{1}[{2}] != {3}[{2}]) {{".format(data_var, name, index_var, name) + le)
+    out.write(sp * 3 + "return {};".format(null) + le)
+    out.write(sp * 2 + "}" + le)
+    out.write(sp + "}" + le)
+    out.write(le)
+    out.write(sp + "if (({0}->{1}.Data1 != {1}->Data1) || ({0}->{1}.Data2 != {1}->Data2) ||".format(
+        data_var, vendor_namespace) + le)
+    out.write(sp * 2 + "({0}->{1}.Data3 != {1}->Data3)) {{".format(data_var, vendor_namespace) + le)
+    out.write(sp * 2 + "return {};".format(null) + le)
+    out.write(sp + "}" + le)
+    out.write(le)
+    out.write(sp + "for ({0} = 0; {0} < 8; {0}++) {{".format(index_var) + le)
+    out.write(sp * 2 + "if ({0}->{1}.Data4[{2}] != {1}->Data4[{2}]) {{".format(
+        data_var, vendor_namespace, index_var) + le)
+    out.write(sp * 3 + "return {};".format(null) + le)
+    out.write(sp * 2 + "}" + le)
+    out.write(sp + "}" + le)
+    out.write(le)
+    out.write(sp + "return {};".format(data_var) + le)
+    out.write("}" + le)
+
+
+# true if any leaf of the knob is constrained beyond what its type allows
+def knob_constraint_present(knob):
+    return KnobLayout(knob).constrained
+
+
+# the expression reading a leaf of a knob through the typed value pointer of its validator
+def get_leaf_value_expression(efi_type, path):
+    if path == "":
+        # the knob itself is the leaf
+        return "*" + naming_convention_filter("value", False, efi_type)
+
+    # don't take the '.'
+    return "{}->{}".format(naming_convention_filter("value", False, efi_type), path[1:])
+
+
+# writes the validator of a knob as a function checking each of its constrained leaves
+def write_knob_content_validator(efi_type, out, knob, knob_layout=None):
+    if knob_layout is None:
+        knob_layout = KnobLayout(knob)
+
+    le = get_line_ending(efi_type)
+    sp = get_spacing_string(efi_type)
+    c_type = get_type_string(knob.format.c_type, efi_type)
+    value = naming_convention_filter("value", False, efi_type)
+    buffer = naming_convention_filter("buffer", False, efi_type)
+    fail = sp * 2 + "return {};".format(get_value_string('false', efi_type)) + le + sp + "}" + le
+
+    lines = ["{} {}{}({} {} {})".format(
+        get_type_string('bool', efi_type),
+        naming_convention_filter("validate_knob_content_", False, efi_type),
+        knob.name,
+        get_type_string("const", efi_type),
+        get_type_string("void*", efi_type),
+        buffer) + le]
+    lines.append("{" + le)
+    lines.append(sp + "{}* {} = ({}*){};".format(c_type, value, c_type, buffer) + le)
+
+    for leaf in knob_layout.leaves:
+        if leaf.enum:
+            lines.append(sp + "if (!{}{}({})) {{".format(
+                naming_convention_filter("validate_enum_value_", False, efi_type),
+                leaf.format.name,
+                get_leaf_value_expression(efi_type, leaf.path)
+            ) + le + fail)
+        else:
+            if leaf.has_min:
+                lines.append(sp + "if ({} < KNOB__{}__MIN) {{".format(
+                    get_leaf_value_expression(efi_type, leaf.path),
+                    leaf.define_name
+                ) + le + fail)
+            if leaf.has_max:
+                lines.append(sp + "if ({} > KNOB__{}__MAX) {{".format(
+                    get_leaf_value_expression(efi_type, leaf.path),
+                    leaf.define_name
+                ) + le + fail)
+    lines.append(sp + "return {};".format(get_value_string('true', efi_type)) + le)
+    lines.append("}" + le)
+    lines.append(le)
+    out.write("".join(lines))
+
+
+# Kinds of a knob constraint table entry, matching KNOB_CONSTRAINT_* in ConfigStdStructDefs.h
+KNOB_CONSTRAINT_UNSIGNED = 0
+KNOB_CONSTRAINT_SIGNED = 1
+KNOB_CONSTRAINT_ENUM = 2
+
+# an enum constraint is a bitmap of the valid values above the lowest one, held in the max field of its entry
+KNOB_CONSTRAINT_ENUM_BITS = 64
+
+
+# returns the constraint table entries of a knob as (path, width, kind, min, max), one per constrained leaf, or None
+# if a constraint cannot be expressed in the table
+def get_knob_constraints(knob, knob_layout=None):
+    if knob_layout is None:
+        knob_layout = KnobLayout(knob)
+
+    constraints = []
+    for leaf in knob_layout.leaves:
+        if leaf.enum:
+            # enums are stored as 32 bit signed integers
+            numbers = [value.number - (1 << 32) if value.number >= (1 << 31) else value.number
+                       for value in leaf.format.values]
+            lowest = min(numbers)
+            if max(numbers) - lowest >= KNOB_CONSTRAINT_ENUM_BITS:
+                return None
+
+            bits = 0
+            for number in numbers:
+                bits |= 1 << (number - lowest)
+            constraints.append((leaf.path, leaf.format.size_in_bytes(), KNOB_CONSTRAINT_ENUM, lowest, bits))
+        elif leaf.has_min or leaf.has_max:
+            if not isinstance(leaf.format, VariableList.IntValueFormat):
+                return None
+
+            kind = KNOB_CONSTRAINT_SIGNED if leaf.format.min < 0 else KNOB_CONSTRAINT_UNSIGNED
+            constraints.append((leaf.path, leaf.format.size_in_bytes(), kind, leaf.min, leaf.max))
+
+    return constraints
+
+
+# writes the constraint table of every knob it can express. Returns a map of those knob names to the first entry and
+# count of their constraints, the knobs missing from it keep their own validator
+def write_knob_constraint_table(efi_type, out, schema, layout=None):
+    if layout is None:
+        layout = SchemaLayout(schema)
+
+    le = get_line_ending(efi_type)
+    sp = get_spacing_string(efi_type)
+    offset_of = "OFFSET_OF" if efi_type else "offsetof"
+    knob_values = naming_convention_filter("knob_values_t", True, efi_type)
+
+    table = {}
+    entries = []
+    for knob in schema.knobs:
+        constraints = get_knob_constraints(knob, layout.get_knob_layout(knob))
+        if constraints is None:
+            continue
+
+        table[knob.name] = (len(entries), len(constraints))
+        for (path, width, kind, low, high) in constraints:
+            entries.append((knob, path, width, kind, low, high))
+
+    out.write("// Constraints of every knob leaf, checked by {}".format(
+        naming_convention_filter("check_knob_constraints", False, efi_type)) + le)
+    out.write("#define KNOB_CONSTRAINT_COUNT {}".format(len(entries)) + le)
+    # the terminating entry keeps the table from being empty
+    out.write("{} {} g{}[KNOB_CONSTRAINT_COUNT + 1] = {{".format(
+        get_type_string("const", efi_type),
+        naming_convention_filter("knob_constraint_t", True, efi_type),
+        naming_convention_filter("_knob_constraints", False, efi_type)
+    ) + le)
+    for (knob, path, width, kind, low, high) in entries:
+        leaf_offset = "0" if path == "" else "{}({}, {})".format(
+            offset_of,
+            get_type_string(knob.format.c_type, efi_type),
+            path[1:])
+        out.write(sp + "{{ {}ull, {}ull, {}({}, {}{}), {}, {}, {} }}, // {}{}".format(
+            hex(low & 0xFFFFFFFFFFFFFFFF),
+            hex(high & 0xFFFFFFFFFFFFFFFF),
+            offset_of,
+            knob_values,
+            knob.name,
+            path,
+            leaf_offset,
+            width,
+            ["KNOB_CONSTRAINT_UNSIGNED", "KNOB_CONSTRAINT_SIGNED", "KNOB_CONSTRAINT_ENUM"][kind],
+            knob.name,
+            path
+        ) + le)
+    out.write(sp + "{ 0, 0, 0, 0, 0, 0 }" + le)
+    out.write("};" + le)
+    out.write(le)
+
+    return table
+
+
+# writes the loop checking a range of the constraint table against the leaves found from a base address
+def write_knob_constraint_check_implementation(efi_type, out):
+    u8 = get_type_string("uint8_t", efi_type)
+    u64 = get_type_string("uint64_t", efi_type)
+    i64 = get_type_string("int64_t", efi_type)
+    size = get_type_string("size_t", efi_type)
+    const = get_type_string("const", efi_type)
+    bool_type = get_type_string("bool", efi_type)
+    knob_constraint = naming_convention_filter("knob_constraint_t", True, efi_type)
+    constraints_global = "g" + naming_convention_filter("_knob_constraints", False, efi_type)
+    check_fn = naming_convention_filter("check_knob_constraints", False, efi_type)
+    base = naming_convention_filter("base", False, efi_type)
+    first = naming_convention_filter("first", False, efi_type)
+    count = naming_convention_filter("count", False, efi_type)
+    whole_values = naming_convention_filter("whole_values", False, efi_type)
+    constraint = naming_convention_filter("constraint", False, efi_type)
+    leaf = naming_convention_filter("leaf", False, efi_type)
+    value = naming_convention_filter("value", False, efi_type)
+    index = naming_convention_filter("index", False, efi_type)
+    byte = naming_convention_filter("byte", False, efi_type)
+    min_field = naming_convention_filter("min", False, efi_type)
+    max_field = naming_convention_filter("max", False, efi_type)
+    value_offset = naming_convention_filter("value_offset", False, efi_type)
+    offset = naming_convention_filter("offset", False, efi_type)
+    width = naming_convention_filter("width", False, efi_type)
+    kind = naming_convention_filter("kind", False, efi_type)
+    true = get_value_string("true", efi_type)
+    false = get_value_string("false", efi_type)
+    le = get_line_ending(efi_type)
+    sp = get_spacing_string(efi_type)
+
+    out.write("// Check count entries of the constraint table from first. Each leaf is found at base plus the offset of"
+              + le)
+    out.write("// its entry, into the whole knob values structure when {} is set, otherwise into its knob".format(
+        whole_values) + le)
+    out.write("{} {}({} {}* {}, {} {}, {} {}, {} {})".format(
+        bool_type, check_fn, const, u8, base, size, first, size, count, bool_type, whole_values) + le)
+    out.write("{" + le)
+    out.write(sp + "{} {}* {};".format(const, knob_constraint, constraint) + le)
+    out.write(sp + "{} {}* {};".format(const, u8, leaf) + le)
+    out.write(sp + "{} {};".format(u64, value) + le)
+    out.write(sp + "{} {};".format(size, index) + le)
+    out.write(sp + "{} {};".format(size, byte) + le)
+    out.write(le)
+    out.write(sp + "for ({0} = {1}; {0} < {1} + {2}; {0}++) {{".format(index, first, count) + le)
+    out.write(sp * 2 + "{} = &{}[{}];".format(constraint, constraints_global, index) + le)
+    out.write(sp * 2 + "{} = {} + ({} ? {}->{} : {}->{});".format(
+        leaf, base, whole_values, constraint, value_offset, constraint, offset) + le)
+    out.write(le)
+    out.write(sp * 2 + "// assemble the little endian leaf a byte at a time, as struct members may be unaligned" + le)
+    out.write(sp * 2 + "{} = 0;".format(value) + le)
+    out.write(sp * 2 + "for ({0} = 0; {0} < {1}->{2}; {0}++) {{".format(byte, constraint, width) + le)
+    out.write(sp * 3 + "{} |= ({}){}[{}] << ({} * 8);".format(value, u64, leaf, byte, byte) + le)
+    out.write(sp * 2 + "}" + le)
+    out.write(le)
+    out.write(sp * 2 + "if ({}->{} == KNOB_CONSTRAINT_UNSIGNED) {{".format(constraint, kind) + le)
+    out.write(sp * 3 + "if (({0} < {1}->{2}) || ({0} > {1}->{3})) {{".format(
+        value, constraint, min_field, max_field) + le)
+    out.write(sp * 4 + "return {};".format(false) + le)
+    out.write(sp * 3 + "}" + le)
+    out.write(sp * 3 + "continue;" + le)
+    out.write(sp * 2 + "}" + le)
+    out.write(le)
+    out.write(sp * 2 + "// sign extend the narrower signed leaves" + le)
+    out.write(sp * 2 + "if (({0}->{1} < 8) && ((({2} >> ({0}->{1} * 8 - 1)) & 1) != 0)) {{".format(
+        constraint, width, value) + le)
+    out.write(sp * 3 + "{} |= ~({})0 << ({}->{} * 8);".format(value, u64, constraint, width) + le)
+    out.write(sp * 2 + "}" + le)
+    out.write(le)
+    out.write(sp * 2 + "if ({}->{} == KNOB_CONSTRAINT_ENUM) {{".format(constraint, kind) + le)
+    out.write(sp * 3 + "// {} is the lowest valid value, {} has a bit set for each valid value above it".format(
+        min_field, max_field) + le)
+    out.write(sp * 3 + "{0} -= {1}->{2};".format(value, constraint, min_field) + le)
+    out.write(sp * 3 + "if (({0} >= {1}) || ((({2}->{3} >> {0}) & 1) == 0)) {{".format(
+        value, KNOB_CONSTRAINT_ENUM_BITS, constraint, max_field) + le)
+    out.write(sp * 4 + "return {};".format(false) + le)
+    out.write(sp * 3 + "}" + le)
+    out.write(sp * 2 + "}} else if ((({0}){1} < ({0}){2}->{3}) || (({0}){1} > ({0}){2}->{4})) {{".format(
+        i64, value, constraint, min_field, max_field) + le)
+    out.write(sp * 3 + "return {};".format(false) + le)
+    out.write(sp * 2 + "}" + le)
+    out.write(sp + "}" + le)
+    out.write(le)
+    out.write(sp + "return {};".format(true) + le)
+    out.write("}" + le)
+    out.write(le)
+
+
+# writes the validator of a knob whose constraints are all in the constraint table
+def write_knob_constraint_validator(efi_type, out, knob, first, count):
+    out.write("{} {}{}({} {} {})".format(
+        get_type_string('bool', efi_type),
+        naming_convention_filter("validate_knob_content_", False, efi_type),
+        knob.name,
+        get_type_string("const", efi_type),
+        get_type_string("void*", efi_type),
+        naming_convention_filter("buffer", False, efi_type)) + get_line_ending(efi_type))
+    out.write("{" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type) + "return {}(({} {}*){}, {}, {}, {});".format(
+        naming_convention_filter("check_knob_constraints", False, efi_type),
+        get_type_string("const", efi_type),
+        get_type_string("uint8_t", efi_type),
+        naming_convention_filter("buffer", False, efi_type),
+        first,
+        count,
+        get_value_string("false", efi_type)
+    ) + get_line_ending(efi_type))
+    out.write("}" + get_line_ending(efi_type))
+    out.write("" + get_line_ending(efi_type))
+
+
+# writes the validator of a whole knob values structure, a single pass over the constraint table followed by the
+# validators of the knobs the table cannot express
+def write_knob_values_validator(efi_type, out, schema, table, layout=None):
+    if layout is None:
+        layout = SchemaLayout(schema)
+
+    const = get_type_string("const", efi_type)
+    u8 = get_type_string("uint8_t", efi_type)
+    knob_values = naming_convention_filter("knob_values_t", True, efi_type)
+    values = naming_convention_filter("values", False, efi_type)
+    le = get_line_ending(efi_type)
+    sp = get_spacing_string(efi_type)
+
+    out.write("// Validate every knob of a {} structure, e.g. the cached knob values".format(knob_values) + le)
+    out.write("{} {}({} {} {})".format(
+        get_type_string('bool', efi_type),
+        naming_convention_filter("validate_knob_values", False, efi_type),
+        const,
+        get_type_string("void*", efi_type),
+        values
+    ) + le)
+    out.write("{" + le)
+    out.write(sp + "if (!{}(({} {}*){}, 0, KNOB_CONSTRAINT_COUNT, {})) {{".format(
+        naming_convention_filter("check_knob_constraints", False, efi_type),
+        const,
+        u8,
+        values,
+        get_value_string("true", efi_type)
+    ) + le)
+    out.write(sp * 2 + "return {};".format(get_value_string("false", efi_type)) + le)
+    out.write(sp + "}" + le)
+    for knob in schema.knobs:
+        if knob.name in table or not layout.get_knob_layout(knob).constrained:
+            continue
+
+        out.write(le)
+        out.write(sp + "if (!{}{}(&(({} {}*){})->{})) {{".format(
+            naming_convention_filter("validate_knob_content_", False, efi_type),
+            knob.name,
+            const,
+            knob_values,
+            values,
+            knob.name
+        ) + le)
+        out.write(sp * 2 + "return {};".format(get_value_string("false", efi_type)) + le)
+        out.write(sp + "}" + le)
+    out.write(le)
+    out.write(sp + "return {};".format(get_value_string("true", efi_type)) + le)
+    out.write("}" + le)
+    out.write(le)
+
+# The stdlib cache can be read by any number of threads while it is set, when CONFIG_CONCURRENT_CACHE is defined.
+# The knob values are kept in two copies: readers announce themselves on the reader count of the current version and
+# read the copy that is not being written, so getters never wait or retry. A setter writes the other copy, points the
+# readers at it, waits for the readers of the old copy to leave and then writes the old copy too (the Left-Right
+# technique). Setters are serialized by a spin lock, each publishes its knob atomically.
+def write_concurrent_cache_implementation(out, schema, format_options):
+    le = get_line_ending(False)
+    sp = get_spacing_string(False)
+
+    out.write("// Define CONFIG_CONCURRENT_CACHE, along with CONFIG_INCLUDE_CACHE, for knob getters that are" + le)
+    out.write("// wait-free from any number of threads while setters publish each knob atomically. C11 atomics" + le)
+    out.write("// are then required." + le)
+    out.write("#ifdef CONFIG_CONCURRENT_CACHE" + le)
+    out.write("#ifndef CONFIG_INCLUDE_CACHE" + le)
+    out.write("#error \"CONFIG_CONCURRENT_CACHE requires CONFIG_INCLUDE_CACHE\"" + le)
+    out.write("#endif // CONFIG_INCLUDE_CACHE" + le)
+    out.write("#include <stdatomic.h>" + le)
+    out.write("#include <string.h>" + le)
+    out.write(le)
+    out.write("// Setters spin while readers leave the copy they update. Define CONFIG_CONCURRENT_CACHE_WAIT to" + le)
+    out.write("// yield the processor instead, e.g. to sched_yield(), when threads can outnumber processors" + le)
+    out.write("#ifndef CONFIG_CONCURRENT_CACHE_WAIT" + le)
+    out.write("#define CONFIG_CONCURRENT_CACHE_WAIT()" + le)
+    out.write("#endif // CONFIG_CONCURRENT_CACHE_WAIT" + le)
+    out.write(le)
+    out.write("// Second copy of the knob cache, readers are always pointed at the copy that is not being written" + le)
+    out.write("knob_values_t g_knob_cached_values_shadow = " + le + "{" + le)
+    for knob in schema.knobs:
+        out.write(sp + ".{}={},".format(
+            knob.name,
+            knob.format.object_to_string(knob.default, format_options)
+        ) + le)
+    out.write("};" + le)
+    out.write("static knob_values_t* const g_knob_cache_copies[2] = { &g_knob_cached_values, "
+              "&g_knob_cached_values_shadow };" + le)
+    out.write("static atomic_uint g_knob_cache_read_copy = 0;" + le)
+    out.write("static atomic_uint g_knob_cache_version = 0;" + le)
+    out.write("static atomic_size_t g_knob_cache_readers[2] = { 0, 0 };" + le)
+    out.write("static atomic_flag g_knob_cache_writer = ATOMIC_FLAG_INIT;" + le)
+    out.write(le)
+
+    out.write("// Announce a reader on the current version and get the copy it reads until config_cache_read_end" + le)
+    out.write("static inline const knob_values_t* config_cache_read_begin(unsigned* version)" + le)
+    out.write("{" + le)
+    out.write(sp + "*version = atomic_load(&g_knob_cache_version);" + le)
+    out.write(sp + "atomic_fetch_add(&g_knob_cache_readers[*version], 1);" + le)
+    out.write(sp + "return g_knob_cache_copies[atomic_load(&g_knob_cache_read_copy)];" + le)
+    out.write("}" + le)
+    out.write(le)
+    out.write("static inline void config_cache_read_end(unsigned version)" + le)
+    out.write("{" + le)
+    out.write(sp + "atomic_fetch_sub(&g_knob_cache_readers[version], 1);" + le)
+    out.write("}" + le)
+    out.write(le)
+
+    out.write("// Copy the current value of every knob at once, as one consistent snapshot" + le)
+    out.write("void config_get_knob_values(knob_values_t* values)" + le)
+    out.write("{" + le)
+    out.write(sp + "unsigned version;" + le)
+    out.write(sp + "memcpy(values, config_cache_read_begin(&version), sizeof(knob_values_t));" + le)
+    out.write(sp + "config_cache_read_end(version);" + le)
+    out.write("}" + le)
+    out.write(le)
+
+    out.write("#ifdef CONFIG_SET_VARIABLES" + le)
+    out.write("// Write size bytes at offset into both copies of the cache, readers see all or none of them" + le)
+    out.write("static void config_cache_write(size_t offset, const void* value, size_t size)" + le)
+    out.write("{" + le)
+    out.write(sp + "unsigned read_copy;" + le)
+    out.write(sp + "unsigned version;" + le)
+    out.write(le)
+    out.write(sp + "while (atomic_flag_test_and_set_explicit(&g_knob_cache_writer, memory_order_acquire)) {" + le)
+    out.write(sp * 2 + "CONFIG_CONCURRENT_CACHE_WAIT();" + le)
+    out.write(sp + "}" + le)
+    out.write(le)
+    out.write(sp + "read_copy = atomic_load(&g_knob_cache_read_copy);" + le)
+    out.write(sp + "memcpy((uint8_t*)g_knob_cache_copies[read_copy ^ 1] + offset, value, size);" + le)
+    out.write(sp + "atomic_store(&g_knob_cache_read_copy, read_copy ^ 1);" + le)
+    out.write(le)
+    out.write(sp + "// Move new readers to the other version, then wait for the readers still on the old copy" + le)
+    out.write(sp + "version = atomic_load(&g_knob_cache_version);" + le)
+    out.write(sp + "while (atomic_load(&g_knob_cache_readers[version ^ 1]) != 0) {" + le)
+    out.write(sp * 2 + "CONFIG_CONCURRENT_CACHE_WAIT();" + le)
+    out.write(sp + "}" + le)
+    out.write(sp + "atomic_store(&g_knob_cache_version, version ^ 1);" + le)
+    out.write(sp + "while (atomic_load(&g_knob_cache_readers[version]) != 0) {" + le)
+    out.write(sp * 2 + "CONFIG_CONCURRENT_CACHE_WAIT();" + le)
+    out.write(sp + "}" + le)
+    out.write(le)
+    out.write(sp + "memcpy((uint8_t*)g_knob_cache_copies[read_copy] + offset, value, size);" + le)
+    out.write(sp + "atomic_flag_clear_explicit(&g_knob_cache_writer, memory_order_release);" + le)
+    out.write("}" + le)
+    out.write("#endif // CONFIG_SET_VARIABLES" + le)
+    out.write("#endif // CONFIG_CONCURRENT_CACHE" + le)
+    out.write(le)
+
+
+# Knob indexed access to the copies of the concurrent cache, for callers that would otherwise go through the
+# cache_value_address of the knob. The offset of a knob in either copy is that of its address in g_knob_cached_values
+def write_concurrent_knob_access_implementation(out):
+    le = get_line_ending(False)
+    sp = get_spacing_string(False)
+    offset = "(size_t)((uint8_t*)g_knob_data[knob].cache_value_address - (uint8_t*)&g_knob_cached_values)"
+
+    out.write("#ifdef CONFIG_CONCURRENT_CACHE" + le)
+    out.write("bool config_read_knob_value(knob_t knob, void* value)" + le)
+    out.write("{" + le)
+    out.write(sp + "unsigned version;" + le)
+    out.write(le)
+    out.write(sp + "if ((knob >= KNOB_MAX) || (value == NULL)) {" + le)
+    out.write(sp * 2 + "return false;" + le)
+    out.write(sp + "}" + le)
+    out.write(le)
+    out.write(sp + "memcpy(value, (const uint8_t*)config_cache_read_begin(&version) + " + offset + "," + le)
+    out.write(sp * 2 + "g_knob_data[knob].value_size);" + le)
+    out.write(sp + "config_cache_read_end(version);" + le)
+    out.write(sp + "CONFIG_COUNT_KNOB_GET(knob);" + le)
+    out.write(sp + "return true;" + le)
+    out.write("}" + le)
+    out.write(le)
+    out.write("#ifdef CONFIG_SET_VARIABLES" + le)
+    out.write("bool config_write_knob_value(knob_t knob, const void* value)" + le)
+    out.write("{" + le)
+    out.write(sp + "if ((knob >= KNOB_MAX) || (value == NULL) || !g_knob_data[knob].validator(value)) {" + le)
+    out.write(sp * 2 + "return false;" + le)
+    out.write(sp + "}" + le)
+    out.write(le)
+    out.write(sp + "config_cache_write(" + offset + ", value, g_knob_data[knob].value_size);" + le)
+    out.write(sp + "CONFIG_COUNT_KNOB_SET(knob);" + le)
+    out.write(sp + "return true;" + le)
+    out.write("}" + le)
+    out.write("#endif // CONFIG_SET_VARIABLES" + le)
+    out.write("#endif // CONFIG_CONCURRENT_CACHE" + le)
+    out.write(le)
+
+
+# The generated stdlib getters and setters count each call in the statistics of their knob in gKnobData when
+# CONFIG_KNOB_STATISTICS is defined, with relaxed atomics so that counting never orders or serializes the callers.
+# Otherwise the counting macros are empty and the getters and setters are as without statistics
+def write_knob_statistics_implementation(out):
+    le = get_line_ending(False)
+    sp = get_spacing_string(False)
+
+    out.write("// Define CONFIG_KNOB_STATISTICS prior to this file to count the gets and sets of each knob in the" + le)
+    out.write("// statistics of g_knob_data, e.g. to find the hot knobs. C11 atomics are then required." + le)
+    out.write("#ifdef CONFIG_KNOB_STATISTICS" + le)
+    out.write("#define CONFIG_COUNT_KNOB_GET(knob) atomic_fetch_add_explicit(&g_knob_data[knob].statistics.get_count, "
+              "1, memory_order_relaxed)" + le)
+    out.write("#define CONFIG_COUNT_KNOB_SET(knob) atomic_fetch_add_explicit(&g_knob_data[knob].statistics.set_count, "
+              "1, memory_order_relaxed)" + le)
+    out.write(le)
+    out.write("void config_dump_knob_statistics(FILE* stream)" + le)
+    out.write("{" + le)
+    out.write(sp + "size_t index;" + le)
+    out.write(le)
+    out.write(sp + "fprintf(stream, \"Knob,Gets,Sets\\n\");" + le)
+    out.write(sp + "for (index = 0; index < KNOB_MAX; index++) {" + le)
+    out.write(sp * 2 + "fprintf(stream, \"%s,%llu,%llu\\n\", g_knob_data[index].name," + le)
+    out.write(sp * 3 + "atomic_load_explicit(&g_knob_data[index].statistics.get_count, memory_order_relaxed)," + le)
+    out.write(sp * 3 + "atomic_load_explicit(&g_knob_data[index].statistics.set_count, memory_order_relaxed));" + le)
+    out.write(sp + "}" + le)
+    out.write("}" + le)
+    out.write(le)
+    out.write("void config_reset_knob_statistics(void)" + le)
+    out.write("{" + le)
+    out.write(sp + "size_t index;" + le)
+    out.write(le)
+    out.write(sp + "for (index = 0; index < KNOB_MAX; index++) {" + le)
+    out.write(sp * 2 + "atomic_store_explicit(&g_knob_data[index].statistics.get_count, 0, memory_order_relaxed);" + le)
+    out.write(sp * 2 + "atomic_store_explicit(&g_knob_data[index].statistics.set_count, 0, memory_order_relaxed);" + le)
+    out.write(sp + "}" + le)
+    out.write("}" + le)
+    out.write("#else // CONFIG_KNOB_STATISTICS" + le)
+    out.write("#define CONFIG_COUNT_KNOB_GET(knob)" + le)
+    out.write("#define CONFIG_COUNT_KNOB_SET(knob)" + le)
+    out.write("#endif // CONFIG_KNOB_STATISTICS" + le)
+    out.write(le)
+
+
+def generate_cached_implementation(schema, header_path, efi_type=False, aligned_policy=False,
+                                   max_policy_size=MAX_CONF_POLICY_SIZE, constraint_table_mode=False, layout=None):
+    if layout is None:
+        layout = SchemaLayout(schema, efi_type, aligned_policy, max_policy_size)
+
+    with open_generated_file(header_path) as out:
+        out.write(get_spdx_header(header_path, efi_type))
+        out.write(get_include_once_style(header_path, uefi=efi_type, header=True))
+        out.write("// The config public header must be included prior to this file" + get_line_ending(efi_type))
+        out.write("// Generated Header" + get_line_ending(efi_type))
+        out.write("//  Script: {}".format(sys.argv[0]) + get_line_ending(efi_type))
+        out.write("//  Schema: {}".format(schema.path) + get_line_ending(efi_type))
+        out.write("" + get_line_ending(efi_type))
+
+        format_options = VariableList.StringFormatOptions()
+        format_options.c_format = True
+        format_options.efi_format = efi_type
+
+        out.write("{} {} g{} = ".format(
+            get_type_string("const", efi_type),
+            naming_convention_filter("knob_values_t", True, efi_type),
+            naming_convention_filter("_knob_default_values", False, efi_type)
+        ) + get_line_ending(efi_type) + "{" + get_line_ending(efi_type))
+        for knob in schema.knobs:
+            out.write(get_spacing_string(efi_type) + ".{}={},".format(
+                knob.name,
+                knob.format.object_to_string(knob.default, format_options)
+            ) + get_line_ending(efi_type))
+        out.write("};" + get_line_ending(efi_type))
+
+        out.write("#ifdef CONFIG_INCLUDE_CACHE" + get_line_ending(efi_type))
+        out.write("{} g{} = ".format(
+            naming_convention_filter("knob_values_t", True, efi_type),
+            naming_convention_filter("_knob_cached_values", False, efi_type)
+        ) + get_line_ending(efi_type) + "{" + get_line_ending(efi_type))
+        for knob in schema.knobs:
+            out.write("    .{}={},".format(
+                knob.name,
+                knob.format.object_to_string(knob.default, format_options)
+            ) + get_line_ending(efi_type))
+        out.write("};" + get_line_ending(efi_type))
+        # macro use of 'knob', leave alone
+        out.write("#define CONFIG_CACHE_ADDRESS(knob) (&g{}.knob)".format(
+            naming_convention_filter("_knob_cached_values", False, efi_type)
+        ) + get_line_ending(efi_type))
+        out.write("#else // CONFIG_INCLUDE_CACHE" + get_line_ending(efi_type))
+        out.write("#define CONFIG_CACHE_ADDRESS({}) (NULL)".format(
+            naming_convention_filter("knob", False, efi_type)
+        ) + get_line_ending(efi_type))
+        out.write("#endif // CONFIG_INCLUDE_CACHE" + get_line_ending(efi_type))
+        out.write("" + get_line_ending(efi_type))
+
+        if not efi_type:
+            write_concurrent_cache_implementation(out, schema, format_options)
+
+        for enum in schema.enums:
+            numbers = set(value.number for value in enum.values)
+            lowest_value = min(numbers)
+            highest_value = max(numbers)
+
+            out.write("{} {}{}({} {})".format(
+                get_type_string('bool', efi_type),
+                naming_convention_filter("validate_enum_value_", False, efi_type),
+                enum.name,
+                enum.name,
+                naming_convention_filter("value", False, efi_type)) + get_line_ending(efi_type))
+            out.write("{" + get_line_ending(efi_type))
+
+            if highest_value - lowest_value > len(enum.values):
+                out.write(get_spacing_string(efi_type) + "switch ({}) ".format(
+                    naming_convention_filter("value", False, efi_type)
+                ) + get_line_ending(efi_type) + "{" + get_line_ending(efi_type))
+
+                case_return = get_spacing_string(efi_type, 3) + "return {};".format(
+                    get_value_string('true', efi_type)) + get_line_ending(efi_type)
+                out.write("".join(get_spacing_string(efi_type, 2) + "case {}_{}:".format(
+                    enum.name,
+                    value.name
+                ) + get_line_ending(efi_type) + case_return for value in enum.values))
+                out.write(get_spacing_string(efi_type) + "}" + get_line_ending(efi_type))
+                out.write(get_spacing_string(efi_type) + "return {};".format(
+                    get_value_string('false', efi_type)
+                ) + get_line_ending(efi_type))
+            else:
+                out.write(get_spacing_string(efi_type) + "{} {} = ({}){};".format(
+                    get_type_string("int", efi_type),
+                    naming_convention_filter("numeric_value", False, efi_type),
+                    get_type_string("int", efi_type),
+                    naming_convention_filter("value", False, efi_type)
+                ) + get_line_ending(efi_type))
+                out.write(get_spacing_string(efi_type) + "if ({} < {}) return {};".format(
+                    naming_convention_filter("numeric_value", False, efi_type),
+                    lowest_value,
+                    get_value_string('false', efi_type)) + get_line_ending(efi_type))
+                out.write(get_spacing_string(efi_type) + "if ({} > {}) return {};".format(
+                    naming_convention_filter("numeric_value", False, efi_type),
+                    highest_value,
+                    get_value_string('false', efi_type)) + get_line_ending(efi_type))
+                # the range holds at most one gap per value, each found with a single set lookup
+                for i in range(lowest_value, highest_value):
+                    if i not in numbers:
+                        out.write(get_spacing_string(efi_type) + "if ({} == {}) return {};".format(
+                            naming_convention_filter("numeric_value", False, efi_type),
+                            i,
+                            get_value_string('false', efi_type)) + get_line_ending(efi_type))
+                out.write(get_spacing_string(efi_type) + "return {};".format(
+                    get_value_string('true', efi_type)
+                ) + get_line_ending(efi_type))
+            out.write("}" + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+
+        out.write("" + get_line_ending(efi_type))
+
+        out.write("{} {}({} {} {})".format(
+            get_type_string('bool', efi_type),
+            naming_convention_filter("validate_knob_no_constraints", False, efi_type),
+            get_type_string("const", efi_type),
+            get_type_string("void*", efi_type),
+            naming_convention_filter("buffer", False, efi_type)
+        ) + get_line_ending(efi_type))
+        out.write("{" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type) + "({}){};".format(
+            get_type_string("void", efi_type),
+            naming_convention_filter("buffer", False, efi_type)
+        ) + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type) + "return {};".format(
+            get_value_string('true', efi_type)
+        ) + get_line_ending(efi_type))
+        out.write("}" + get_line_ending(efi_type))
+        out.write("" + get_line_ending(efi_type))
+        constraint_table = None
+        if constraint_table_mode:
+            constraint_table = write_knob_constraint_table(efi_type, out, schema, layout)
+            write_knob_constraint_check_implementation(efi_type, out)
+
+        for knob in schema.knobs:
+            knob_layout = layout.get_knob_layout(knob)
+            if constraint_table is not None and knob.name in constraint_table:
+                (first, count) = constraint_table[knob.name]
+                if count > 0:
+                    write_knob_constraint_validator(efi_type, out, knob, first, count)
+                    continue
+            elif knob_layout.constrained:
+                write_knob_content_validator(efi_type, out, knob, knob_layout)
+                continue
+
+            out.write("#define {}{} {}".format(
+                naming_convention_filter("validate_knob_content_", False, efi_type),
+                knob.name,
+                naming_convention_filter("validate_knob_no_constraints", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+
+        if constraint_table is not None:
+            write_knob_values_validator(efi_type, out, schema, constraint_table, layout)
+
+        out.write("" + get_line_ending(efi_type))
+        out.write("{} g{}[{}] = {{".format(
+            naming_convention_filter("knob_data_t", True, efi_type),
+            naming_convention_filter("_knob_data", False, efi_type),
+            len(schema.knobs) + 1
+        ) + get_line_ending(efi_type))
+        knob_data_lines = [
+            (1, "{"),
+            (2, "KNOB_${name},"),
+            (2, "&g" + naming_convention_filter("_knob_default_values", False, efi_type) + ".${name},"),
+            (2, "CONFIG_CACHE_ADDRESS(${name}),"),
+            (2, "sizeof(${c_type}),"),
+            (2, "\"${name}\","),
+            (2, "${name_length}, // Length of name (including NULL terminator)"),
+            (2, "${guid}, // ${namespace}"),
+            (2, "7,")
+        ]
+        # statistics not implemented in uefi design
+        if efi_type is False:
+            knob_data_lines.append((2, "{0, 0},"))
+        knob_data_lines.append((2, "&" + naming_convention_filter("validate_knob_content_", False, efi_type) +
+                                "${name}"))
+        knob_data_lines.append((1, "},"))
+        knob_data = get_code_template(efi_type, knob_data_lines)
+        for knob in schema.knobs:
+            out.write(knob_data.substitute(
+                name=knob.name,
+                c_type=get_type_string(knob.format.c_type, efi_type),
+                name_length=len(knob.name) + 1,
+                guid=format_guid(knob.namespace),
+                namespace=knob.namespace))
+        out.write(get_spacing_string(efi_type) + "{" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, 2) + "KNOB_MAX," + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, 2) + "NULL," + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, 2) + "NULL," + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, 2) + "0," + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, 2) + "NULL," + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, 2) + "0," + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, 2))
+        out.write("{0,0,0,{0,0,0,0,0,0,0,0}}," + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, 2) + "0," + get_line_ending(efi_type))
+        # statistics not implemented in uefi design
+        if efi_type is False:
+            out.write(get_spacing_string(efi_type, 2) + "{0, 0}," + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, 2) + "NULL")
+        out.write(get_line_ending(efi_type) + get_spacing_string(efi_type) + "}" + get_line_ending(efi_type))
+        out.write("};" + get_line_ending(efi_type))
+
+        write_knob_lookup_implementation(efi_type, out, schema)
+
+        if not efi_type:
+            # UEFI does not use get_knob_value
+            out.write("" + get_line_ending(efi_type))
+            out.write("// Not safe against concurrent setters with CONFIG_CONCURRENT_CACHE, as is set_knob_value"
+                      + get_line_ending(efi_type))
+            out.write("{} {}({} {});".format(
+                get_type_string("void*", efi_type),
+                naming_convention_filter("get_knob_value", False, efi_type),
+                naming_convention_filter("knob_t", True, efi_type),
+                naming_convention_filter("knob", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+            # no concept of setting config variables in UEFI
+            out.write("#ifdef CONFIG_SET_VARIABLES" + get_line_ending(efi_type))
+            out.write("{} set_knob_value(knob_t knob, void* value);".format(
+                get_type_string('bool', efi_type)
+            ) + get_line_ending(efi_type))
+            out.write("#endif // CONFIG_SET_VARIABLES" + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+
+            write_knob_statistics_implementation(out)
+            write_concurrent_knob_access_implementation(out)
+
+            # UEFI utilizes a separate header for getter implementations
+            getter = get_code_template(efi_type, [
+                (0, "// Get the current value of the ${name} knob"),
+                (0, "${c_type} config_get_${name}(void) {"),
+                (0, "#ifdef CONFIG_CONCURRENT_CACHE"),
+                (1, "unsigned version;"),
+                (1, "${c_type} value = config_cache_read_begin(&version)->${name};"),
+                (1, "config_cache_read_end(version);"),
+                (0, "#else // CONFIG_CONCURRENT_CACHE"),
+                (1, "${c_type} value = *((${c_type}*)get_knob_value(KNOB_${name}));"),
+                (0, "#endif // CONFIG_CONCURRENT_CACHE"),
+                (1, "CONFIG_COUNT_KNOB_GET(KNOB_${name});"),
+                (1, "return value;"),
+                (0, "}"),
+                (0, ""),
+                # no concept of setting config variables in UEFI
+                (0, "#ifdef CONFIG_SET_VARIABLES"),
+                (0, "// Set the current value of the ${name} knob"),
+                (0, "bool config_set_${name}(${c_type} value) {"),
+                (0, "#ifdef CONFIG_CONCURRENT_CACHE"),
+                (1, "if (!g_knob_data[KNOB_${name}].validator(&value)) {"),
+                (2, "return false;"),
+                (1, "}"),
+                (1, "config_cache_write(offsetof(knob_values_t, ${name}), &value, sizeof(value));"),
+                (0, "#else // CONFIG_CONCURRENT_CACHE"),
+                (1, "if (!set_knob_value(KNOB_${name}, &value)) {"),
+                (2, "return false;"),
+                (1, "}"),
+                (0, "#endif // CONFIG_CONCURRENT_CACHE"),
+                (1, "CONFIG_COUNT_KNOB_SET(KNOB_${name});"),
+                (1, "return true;"),
+                (0, "}"),
+                (0, "#endif // CONFIG_SET_VARIABLES"),
+                (0, ""),
+            ])
+
+            out.write("// Schema-defined knobs" + get_line_ending(efi_type))
+            for knob in schema.knobs:
+                out.write(get_knob_comment(knob, efi_type) + getter.substitute(
+                    name=knob.name,
+                    c_type=knob.format.c_type))
+        else:
+            # give UEFI core components a knob count
+            out.write(get_line_ending(efi_type))
+            out.write(get_type_string("size_t", efi_type) + " g{} = KNOB_MAX;".format(
+                naming_convention_filter("_num_knobs", False, efi_type))
+            )
+            out.write(get_line_ending(efi_type))
+
+            # tell the policy creator which knobs go in which config policy, the Nth of them is published under the
+            # Nth GUID of PcdConfigurationPolicyGuid
+            chunks = layout.chunks
+            out.write(get_line_ending(efi_type))
+            out.write("CONFIG_POLICY_RANGE gConfigPolicyRanges[{}] = {{".format(len(chunks)) +
+                      get_line_ending(efi_type))
+            for chunk, policy_size in zip(chunks, layout.policy_sizes):
+                out.write(get_spacing_string(efi_type) + "{" + get_line_ending(efi_type))
+                out.write(get_spacing_string(efi_type, 2) + ".FirstKnob = {},".format(
+                    "KNOB_" + chunk[0].name if len(chunk) > 0 else "0") + get_line_ending(efi_type))
+                out.write(get_spacing_string(efi_type, 2) + ".KnobCount = {},".format(len(chunk)) +
+                          get_line_ending(efi_type))
+                out.write(get_spacing_string(efi_type, 2) + ".PolicySize = {},".format(
+                    hex(policy_size)) + get_line_ending(efi_type))
+                out.write(get_spacing_string(efi_type) + "}," + get_line_ending(efi_type))
+            out.write("};" + get_line_ending(efi_type))
+            out.write(get_line_ending(efi_type))
+            out.write("UINTN gNumConfigPolicies = {};".format(len(chunks)) + get_line_ending(efi_type))
+        out.write(get_include_once_style(header_path, uefi=efi_type, header=False))
+
+
+# UEFI utilizes a third header file to hold the getter implementation
+def generate_getter_implementation(schema, header_path, efi_type, aligned_policy=False,
+                                   max_policy_size=MAX_CONF_POLICY_SIZE, layout=None):
+    if layout is None:
+        layout = SchemaLayout(schema, efi_type, aligned_policy, max_policy_size)
+
+    chunks = layout.chunks
+    with open_generated_file(header_path) as out:
+        out.write(get_spdx_header(header_path, efi_type))
+        out.write(get_include_once_style(header_path, uefi=efi_type, header=True))
+        out.write("// The config public header must be included prior to this file" + get_line_ending(efi_type))
+        out.write("// Define CONFIG_LAZY_POLICY_CACHE prior to this file and to the config public header to cache" +
+                  get_line_ending(efi_type))
+        out.write("// nothing. Each read then fetches the whole config policy holding its knob into a stack buffer" +
+                  get_line_ending(efi_type))
+        out.write("// of CONFIG_POLICY_MAX_SIZE bytes, instead of the first read fetching every config policy into" +
+                  get_line_ending(efi_type))
+        out.write("// static buffers and decoding it into static knob values. That stack cost is capped at" +
+                  get_line_ending(efi_type))
+        out.write("// CONFIG_LAZY_POLICY_MAX_SIZE, {} bytes unless defined prior to this file: generate the".format(
+                  hex(LAZY_CONF_POLICY_MAX_SIZE)) + get_line_ending(efi_type))
+        out.write("// headers of lazy consumers with a --policysize their stack can take." + get_line_ending(efi_type))
+        out.write("// Define CONFIG_POLICY_TELEMETRY prior to this file to count the knobs decoded through" +
+                  get_line_ending(efi_type))
+        out.write("// ConfigPerfCounterLib, which is then required." + get_line_ending(efi_type))
+        out.write("// Generated Header" + get_line_ending(efi_type))
+        out.write("//  Script: {}".format(sys.argv[0]) + get_line_ending(efi_type))
+        out.write("//  Schema: {}".format(schema.path) + get_line_ending(efi_type))
+        out.write(get_line_ending(efi_type))
+
+        # the knobs are published in CONFIG_POLICY_COUNT config policies, the Nth of them under the Nth GUID of
+        # PcdConfigurationPolicyGuid
+        policy_sizes = [hex(policy_size) for policy_size in layout.policy_sizes]
+        out.write("#define CONFIG_POLICY_COUNT  {}".format(len(chunks)) + get_line_ending(efi_type))
+        out.write("#define CONFIG_POLICY_MAX_SIZE  {}".format(
+            hex(max(layout.policy_sizes))
+        ) + get_line_ending(efi_type))
+        out.write(get_line_ending(efi_type))
+        out.write(get_code_template(efi_type, [
+            (0, "#ifdef CONFIG_LAZY_POLICY_CACHE"),
+            (0, "#ifndef CONFIG_LAZY_POLICY_MAX_SIZE"),
+            (0, "#define CONFIG_LAZY_POLICY_MAX_SIZE  " + hex(LAZY_CONF_POLICY_MAX_SIZE)),
+            (0, "#endif // CONFIG_LAZY_POLICY_MAX_SIZE"),
+            (0, "#if CONFIG_POLICY_MAX_SIZE > CONFIG_LAZY_POLICY_MAX_SIZE"),
+            (0, "#error \"CONFIG_LAZY_POLICY_CACHE fetches a whole config policy onto the stack, lower --policysize\""),
+            (0, "#endif"),
+            (0, "#endif // CONFIG_LAZY_POLICY_CACHE"),
+            (0, ""),
+        ]).substitute())
+        out.write("STATIC CONST UINT16  CachedPolicySize[CONFIG_POLICY_COUNT] = {{ {} }};".format(
+            ", ".join(policy_sizes)
+        ) + get_line_ending(efi_type))
+        out.write("#ifdef CONFIG_POLICY_TELEMETRY" + get_line_ending(efi_type))
+        out.write("STATIC CONST UINT16  CachedPolicyKnobCount[CONFIG_POLICY_COUNT] = {{ {} }};".format(
+            ", ".join(str(len(chunk)) for chunk in chunks)
+        ) + get_line_ending(efi_type))
+        out.write("#endif // CONFIG_POLICY_TELEMETRY" + get_line_ending(efi_type))
+        for policy_size in policy_sizes:
+            out.write(get_assert_style(efi_type, "({} <= MAX_UINT16".format(
+                policy_size
+            ), '"Config too large!"'))
+            out.write(get_line_ending(efi_type))
+        out.write(get_line_ending(efi_type))
+
+        out.write("#ifndef CONFIG_LAZY_POLICY_CACHE" + get_line_ending(efi_type))
+        out.write("STATIC BOOLEAN CachedPolicyInitialized[CONFIG_POLICY_COUNT];" + get_line_ending(efi_type))
+        out.write("STATIC KNOB_VALUES CachedKnobValues;" + get_line_ending(efi_type))
+        for policy, policy_size in enumerate(policy_sizes):
+            if aligned_policy:
+                # back the aligned policy with UINT64 storage so its data offsets stay aligned in memory
+                out.write("STATIC UINT64 CachedPolicyBuffer{}[({} + 7) / 8];".format(
+                    policy,
+                    policy_size
+                ) + get_line_ending(efi_type))
+            else:
+                out.write("STATIC CHAR8 CachedPolicyBuffer{}[{}];".format(
+                    policy,
+                    policy_size
+                ) + get_line_ending(efi_type))
+        out.write("STATIC CHAR8 *CONST CachedPolicy[CONFIG_POLICY_COUNT] = {" + get_line_ending(efi_type))
+        for policy in range(len(chunks)):
+            out.write(get_spacing_string(efi_type) + "(CHAR8 *)CachedPolicyBuffer{},".format(policy) +
+                      get_line_ending(efi_type))
+        out.write("};" + get_line_ending(efi_type))
+        out.write("#endif // CONFIG_LAZY_POLICY_CACHE" + get_line_ending(efi_type))
+        out.write(get_line_ending(efi_type))
+
+        # DecodeConfigPolicy
+        out.write("// Decode the knobs held by one config policy into Values" + get_line_ending(efi_type))
+        out.write("STATIC" + get_line_ending(efi_type))
+        out.write("VOID" + get_line_ending(efi_type))
+        out.write("DecodeConfigPolicy (" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type) + "IN UINTN         Policy," + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type) + "IN CONST CHAR8   *Buffer," + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type) + "OUT KNOB_VALUES  *Values" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type) + ")" + get_line_ending(efi_type))
+        out.write("{" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type) + "switch (Policy) {" + get_line_ending(efi_type))
+        for policy, chunk in enumerate(chunks):
+            out.write(get_spacing_string(efi_type, num=2) + "case {}:".format(policy) + get_line_ending(efi_type))
+            out.write("".join(get_spacing_string(efi_type, num=3) +
+                              "CopyMem (&Values->{}, Buffer + {}, sizeof (Values->{}));".format(
+                                  knob.name,
+                                  layout.get_knob_layout(knob).policy_offset,
+                                  knob.name
+                              ) + get_line_ending(efi_type) for knob in chunk))
+            out.write(get_spacing_string(efi_type, num=3) + "break;" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, num=2) + "default:" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, num=3) + "ASSERT (FALSE);" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, num=3) + "break;" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type) + "}" + get_line_ending(efi_type))
+        out.write("}" + get_line_ending(efi_type))
+        out.write(get_line_ending(efi_type))
+
+        # FetchConfigPolicy
+        out.write("// Fetch a config policy into Buffer, of CachedPolicySize[Policy] bytes" + get_line_ending(efi_type))
+        out.write("STATIC" + get_line_ending(efi_type))
+        out.write("EFI_STATUS" + get_line_ending(efi_type))
+        out.write("FetchConfigPolicy (" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type) + "IN UINTN   Policy," + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type) + "OUT CHAR8  *Buffer" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type) + ")" + get_line_ending(efi_type))
+        out.write("{" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type))
+        out.write("EFI_STATUS Status;" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type))
+        out.write("UINT16 ConfPolSize = CachedPolicySize[Policy];" + get_line_ending(efi_type))
+        out.write(get_line_ending(efi_type))
+
+        out.write(get_spacing_string(efi_type))
+        out.write("if (PcdGetSize (PcdConfigurationPolicyGuid) < (Policy + 1) * sizeof (EFI_GUID)) {" +
+                  get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, num=2) + "ASSERT (FALSE);" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, num=2))
+        out.write("return EFI_NOT_FOUND;" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type))
+        out.write("}" + get_line_ending(efi_type))
+        out.write(get_line_ending(efi_type))
+
+        out.write(get_spacing_string(efi_type))
+        out.write("Status = GetPolicy (")
+        out.write("&((EFI_GUID *)PcdGetPtr (PcdConfigurationPolicyGuid))[Policy], NULL,")
+        out.write(" Buffer, &ConfPolSize);" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type))
+        out.write("if ((EFI_ERROR (Status)) || (ConfPolSize != CachedPolicySize[Policy])) {" +
+                  get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, num=2) + "ASSERT (FALSE);")
+        out.write(get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, num=2))
+        out.write("return EFI_ERROR (Status) ? Status : EFI_BAD_BUFFER_SIZE;" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type))
+        out.write("}" + get_line_ending(efi_type))
+        out.write(get_line_ending(efi_type))
+        if aligned_policy:
+            # the offsets below only hold for the aligned variable list format
+            out.write(get_spacing_string(efi_type))
+            out.write("if (*(UINT32 *)Buffer != SIGNATURE_32 ('C', 'V', 'L', 'A')) {" + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type, num=2) + "ASSERT (FALSE);" + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type, num=2))
+            out.write("return EFI_COMPROMISED_DATA;" + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type))
+            out.write("}" + get_line_ending(efi_type))
+            out.write(get_line_ending(efi_type))
+
+        out.write(get_spacing_string(efi_type))
+        out.write("return EFI_SUCCESS;" + get_line_ending(efi_type))
+        out.write("}" + get_line_ending(efi_type))
+        out.write(get_line_ending(efi_type))
+
+        out.write("#ifdef CONFIG_LAZY_POLICY_CACHE" + get_line_ending(efi_type))
+        # ReadConfigPolicy, the buffer is on the stack as a pool buffer would never be reclaimed in PEI
+        out.write(get_code_template(efi_type, [
+            (0, "// Read Size bytes at Offset of a config policy, fetched into a stack buffer"),
+            (0, "STATIC"),
+            (0, "EFI_STATUS"),
+            (0, "ReadConfigPolicy ("),
+            (1, "IN UINTN   Policy,"),
+            (1, "IN UINTN   Offset,"),
+            (1, "OUT VOID   *Value,"),
+            (1, "IN UINTN   Size"),
+            (1, ")"),
+            (0, "{"),
+            (1, "EFI_STATUS Status;"),
+            (1, "UINT64     Buffer[(CONFIG_POLICY_MAX_SIZE + 7) / 8];"),
+            (0, ""),
+            (1, "Status = FetchConfigPolicy (Policy, (CHAR8 *)Buffer);"),
+            (1, "if (EFI_ERROR (Status)) {"),
+            (2, "return Status;"),
+            (1, "}"),
+            (0, ""),
+            (1, "CopyMem (Value, (CHAR8 *)Buffer + Offset, Size);"),
+            (0, "#ifdef CONFIG_POLICY_TELEMETRY"),
+            (1, "ConfigPerfCounterAdd (ConfigPerfCounterEntriesParsed, 1);"),
+            (0, "#endif // CONFIG_POLICY_TELEMETRY"),
+            (1, "return EFI_SUCCESS;"),
+            (0, "}"),
+            (0, "#else"),
+            # InitConfigPolicyCache
+            (0, "// Initialize the cache of the config policy holding the knobs about to be read"),
+            (0, "STATIC"),
+            (0, "EFI_STATUS"),
+            (0, naming_convention_filter("init_config_policy_cache (", False, efi_type)),
+            (1, "IN UINTN  Policy"),
+            (1, ")"),
+            (0, "{"),
+            (1, "EFI_STATUS Status;"),
+            (1, "UINTN      Index;"),
+            (0, ""),
+            (1, "// the first read fetches and decodes every config policy"),
+            (1, "for (Index = 0; Index < CONFIG_POLICY_COUNT; Index++) {"),
+            (2, "Status = FetchConfigPolicy (Index, CachedPolicy[Index]);"),
+            (2, "if (EFI_ERROR (Status)) {"),
+            (3, "return Status;"),
+            (2, "}"),
+            (0, ""),
+            (2, "DecodeConfigPolicy (Index, CachedPolicy[Index], &CachedKnobValues);"),
+            (0, "#ifdef CONFIG_POLICY_TELEMETRY"),
+            (2, "ConfigPerfCounterAdd (ConfigPerfCounterEntriesParsed, CachedPolicyKnobCount[Index]);"),
+            (0, "#endif // CONFIG_POLICY_TELEMETRY"),
+            (2, "CachedPolicyInitialized[Index] = TRUE;"),
+            (1, "}"),
+            (0, ""),
+            (1, "return EFI_SUCCESS;"),
+            (0, "}"),
+            (0, "#endif // CONFIG_LAZY_POLICY_CACHE"),
+            (0, ""),
+        ]).substitute())
+
+        write_uefi_getter_implementations(efi_type, out, chunks, layout)
+
+        out.write(get_include_once_style(header_path, uefi=efi_type, header=False))
+
+
+# The table of every profile's KNOB_OVERRIDE array
+def write_profile_override_table(efi_type, out, profiles):
+    if not efi_type:
+        out.write("{} {}[PROFILE_COUNT + 1] = ".format(
+            naming_convention_filter("profile_t", True, efi_type),
+            naming_convention_filter("profiles", False, efi_type)
+        ) + get_line_ending(efi_type) + "{" + get_line_ending(efi_type))
+    else:
+        out.write("{} g{}[PROFILE_COUNT + 1] = ".format(
+            naming_convention_filter("profile_t", True, efi_type),
+            naming_convention_filter("profile_data", False, efi_type)
+        ) + get_line_ending(efi_type) + "{" + get_line_ending(efi_type))
+    for (profile, override_count) in profiles:
+        out.write(get_spacing_string(efi_type) + "{" + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, 2) + ".{} = {}{}{},".format(
+            naming_convention_filter("overrides", False, efi_type),
+            naming_convention_filter("profile_", False, efi_type),
+            profile,
+            naming_convention_filter("_overrides", False, efi_type)
+        ) + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type, 2) + ".{} = {},".format(
+            naming_convention_filter("override_count", False, efi_type),
+            override_count
+        ) + get_line_ending(efi_type))
+        out.write(get_spacing_string(efi_type) + "}," + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type) + "{" + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, 2) + ".{} = NULL,".format(
+        naming_convention_filter("overrides", False, efi_type)
+    ) + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type, 2) + ".{} = 0,".format(
+        naming_convention_filter("override_count", False, efi_type)
+    ) + get_line_ending(efi_type))
+    out.write(get_spacing_string(efi_type) + "}" + get_line_ending(efi_type))
+    out.write("};" + get_line_ending(efi_type))
+
+
+# Writes a profile as a bitmap of its overridden knobs and the values of those knobs packed in knob order, returns the
+# size of the values
+def write_profile_bitmap(efi_type, out, schema, profile):
+    u8 = get_type_string("uint8_t", efi_type)
+    const = get_type_string("const", efi_type)
+    le = get_line_ending(efi_type)
+    sp = get_spacing_string(efi_type)
+
+    base_name = profile.name
+    bitmap = bytearray((len(schema.knobs) + 7) // 8)
+    values = []
+    for idx, knob in enumerate(schema.knobs):
+        value = profile.get_value(knob)
+        if value is not None:
+            bitmap[idx // 8] |= 1 << (idx % 8)
+            values.append((knob, knob.format.object_to_binary(value)))
+
+    out.write("// Knobs overridden by the profile, one bit per knob in knob order" + le)
+    out.write("{} {} {}{}{}[(KNOB_MAX + 7) / 8] = {{".format(
+        const,
+        u8,
+        naming_convention_filter("profile_", False, efi_type),
+        base_name,
+        naming_convention_filter("_bitmap", False, efi_type)
+    ) + le)
+    for start in range(0, len(bitmap), 16):
+        out.write(sp + " ".join("0x{:02x},".format(byte) for byte in bitmap[start:start + 16]) + le)
+    out.write("};" + le)
+    out.write(le)
+
+    values_size = sum(len(value) for (_, value) in values)
+    if values_size == 0:
+        return 0
+
+    out.write("// Values of the overridden knobs, packed in knob order" + le)
+    out.write("#define PROFILE_{}_VALUES_SIZE {}".format(base_name.upper(), values_size) + le)
+    out.write(get_assert_style(efi_type, "({} == PROFILE_{}_VALUES_SIZE".format(
+        " + ".join("sizeof({})".format(get_type_string(knob.format.c_type, efi_type)) for (knob, _) in values),
+        base_name.upper()
+    ), '"profile values must match the knob sizes"') + le)
+    out.write("{} {} {}{}{}[PROFILE_{}_VALUES_SIZE] = {{".format(
+        const,
+        u8,
+        naming_convention_filter("profile_", False, efi_type),
+        base_name,
+        naming_convention_filter("_values", False, efi_type),
+        base_name.upper()
+    ) + le)
+    for (knob, value) in values:
+        for start in range(0, len(value), 16):
+            line = sp + " ".join("0x{:02x},".format(byte) for byte in value[start:start + 16])
+            if start == 0:
+                line += " // {}".format(knob.name)
+            out.write(line + le)
+    out.write("};" + le)
+    out.write(le)
+
+    return values_size
+
+
+# The table of every profile's bitmap and values
+def write_profile_bitmap_table(efi_type, out, profiles):
+    le = get_line_ending(efi_type)
+    sp = get_spacing_string(efi_type)
+    bitmap_field = naming_convention_filter("bitmap", False, efi_type)
+    values_field = naming_convention_filter("values", False, efi_type)
+    values_size_field = naming_convention_filter("values_size", False, efi_type)
+
+    if not efi_type:
+        out.write("{} {}[PROFILE_COUNT + 1] = ".format(
+            naming_convention_filter("profile_bitmap_t", True, efi_type),
+            naming_convention_filter("profile_bitmaps", False, efi_type)
+        ) + le + "{" + le)
+    else:
+        out.write("{} g{}[PROFILE_COUNT + 1] = ".format(
+            naming_convention_filter("profile_bitmap_t", True, efi_type),
+            naming_convention_filter("profile_bitmap_data", False, efi_type)
+        ) + le + "{" + le)
+    for (profile, values_size) in profiles:
+        out.write(sp + "{" + le)
+        out.write(sp * 2 + ".{} = {}{}{},".format(
+            bitmap_field,
+            naming_convention_filter("profile_", False, efi_type),
+            profile,
+            naming_convention_filter("_bitmap", False, efi_type)
+        ) + le)
+        if values_size == 0:
+            out.write(sp * 2 + ".{} = NULL,".format(values_field) + le)
+            out.write(sp * 2 + ".{} = 0,".format(values_size_field) + le)
+        else:
+            out.write(sp * 2 + ".{} = {}{}{},".format(
+                values_field,
+                naming_convention_filter("profile_", False, efi_type),
+                profile,
+                naming_convention_filter("_values", False, efi_type)
+            ) + le)
+            out.write(sp * 2 + ".{} = PROFILE_{}_VALUES_SIZE,".format(values_size_field, profile.upper()) + le)
+        out.write(sp + "}," + le)
+    out.write(sp + "{" + le)
+    out.write(sp * 2 + ".{} = NULL,".format(bitmap_field) + le)
+    out.write(sp * 2 + ".{} = NULL,".format(values_field) + le)
+    out.write(sp * 2 + ".{} = 0,".format(values_size_field) + le)
+    out.write(sp + "}" + le)
+    out.write("};" + le)
+
+
+# Copies the values of a bitmap encoded profile to the cache of each knob, walking the bitmap once
+def write_profile_bitmap_apply_implementation(efi_type, out):
+    u8 = get_type_string("uint8_t", efi_type)
+    size = get_type_string("size_t", efi_type)
+    const = get_type_string("const", efi_type)
+    bool_type = get_type_string("bool", efi_type)
+    profile_bitmap = naming_convention_filter("profile_bitmap_t", True, efi_type)
+    knob_data_global = "g" + naming_convention_filter("_knob_data", False, efi_type)
+    apply_fn = naming_convention_filter("apply_profile_bitmap", False, efi_type)
+    profile_var = naming_convention_filter("profile", False, efi_type)
+    knob_var = naming_convention_filter("knob", False, efi_type)
+    offset_var = naming_convention_filter("offset", False, efi_type)
+    index_var = naming_convention_filter("index", False, efi_type)
+    cache_var = naming_convention_filter("cache", False, efi_type)
+    bitmap = naming_convention_filter("bitmap", False, efi_type)
+    values = naming_convention_filter("values", False, efi_type)
+    values_size = naming_convention_filter("values_size", False, efi_type)
+    cache_value_address = naming_convention_filter("cache_value_address", False, efi_type)
+    value_size = naming_convention_filter("value_size", False, efi_type)
+    true = get_value_string("true", efi_type)
+    false = get_value_string("false", efi_type)
+    null = "NULL"
+    le = get_line_ending(efi_type)
+    sp = get_spacing_string(efi_type)
+
+    out.write(le)
+    out.write("// Apply a bitmap encoded profile to the cached knob values in one pass over its bitmap. Returns {}"
+              .format(false) + le)
+    out.write("// if the profile does not fit the knobs, or an overridden knob has no cache." + le)
+    out.write("{} {}({} {}* {})".format(bool_type, apply_fn, const, profile_bitmap, profile_var) + le)
+    out.write("{" + le)
+    out.write(sp + "{} {};".format(size, knob_var) + le)
+    out.write(sp + "{} {};".format(size, offset_var) + le)
+    out.write(sp + "{} {};".format(size, index_var) + le)
+    out.write(sp + "{}* {};".format(u8, cache_var) + le)
+    out.write(le)
+    out.write(sp + "if (({} == {}) || ({}->{} == {})) {{".format(profile_var, null, profile_var, bitmap, null) + le)
+    out.write(sp * 2 + "return {};".format(false) + le)
+    out.write(sp + "}" + le)
+    out.write(le)
+    out.write(sp + "{} = 0;".format(offset_var) + le)
+    out.write(sp + "for ({0} = 0; {0} < KNOB_MAX; {0}++) {{".format(knob_var) + le)
+    out.write(sp * 2 + "// skip a whole byte of the bitmap when none of its knobs are overridden" + le)
+    out.write(sp * 2 + "if ((({0} % 8) == 0) && ({1}->{2}[{0} / 8] == 0)) {{".format(
+        knob_var, profile_var, bitmap) + le)
+    out.write(sp * 3 + "{} += 7;".format(knob_var) + le)
+    out.write(sp * 3 + "continue;" + le)
+    out.write(sp * 2 + "}" + le)
+    out.write(le)
+    out.write(sp * 2 + "if (({1}->{2}[{0} / 8] & (1 << ({0} % 8))) == 0) {{".format(
+        knob_var, profile_var, bitmap) + le)
+    out.write(sp * 3 + "continue;" + le)
+    out.write(sp * 2 + "}" + le)
+    out.write(le)
+    out.write(sp * 2 + "{} = ({}*){}[{}].{};".format(
+        cache_var, u8, knob_data_global, knob_var, cache_value_address) + le)
+    out.write(sp * 2 + "if (({} == {}) || ({} + {}[{}].{} > {}->{})) {{".format(
+        cache_var, null, offset_var, knob_data_global, knob_var, value_size, profile_var, values_size) + le)
+    out.write(sp * 3 + "return {};".format(false) + le)
+    out.write(sp * 2 + "}" + le)
+    out.write(le)
+    out.write(sp * 2 + "for ({0} = 0; {0} < {1}[{2}].{3}; {0}++) {{".format(
+        index_var, knob_data_global, knob_var, value_size) + le)
+    out.write(sp * 3 + "{}[{}] = {}->{}[{} + {}];".format(
+        cache_var, index_var, profile_var, values, offset_var, index_var) + le)
+    out.write(sp * 2 + "}" + le)
+    out.write(le)
+    out.write(sp * 2 + "{} += {}[{}].{};".format(offset_var, knob_data_global, knob_var, value_size) + le)
+    out.write(sp + "}" + le)
+    out.write(le)
+    out.write(sp + "return ({} == {}->{}) ? {} : {};".format(offset_var, profile_var, values_size, true, false) + le)
+    out.write("}" + le)
+
+
+# Base name of the generic profile's config policy blob
+GENERIC_PROFILE_POLICY_NAME = "Generic"
+
+
+# Returns the config policy of a profile in the variable list format, the same bytes a policy creator would publish
+# after applying the profile to the knob defaults
+def get_profile_policy_blob(schema, profile):
+    return profile.to_binary(schema)
+
+
+# Writes the ready to publish config policy of a profile as a byte array, returns its size
+def write_profile_policy_blob(efi_type, out, schema, profile):
+    u8 = get_type_string("uint8_t", efi_type)
+    const = get_type_string("const", efi_type)
+    le = get_line_ending(efi_type)
+    sp = get_spacing_string(efi_type)
+
+    base_name = profile.name
+    blob = get_profile_policy_blob(schema, profile)
+    if len(blob) > MAX_CONF_POLICY_SIZE:
+        raise Exception("Config policy of profile {} does not fit in a single config policy".format(base_name))
+
+    out.write("// Config policy of the profile in the variable list format, CRCs included" + le)
+    out.write("#define PROFILE_{}_POLICY_SIZE {}".format(base_name.upper(), len(blob)) + le)
+    out.write("{} {} {}{}{}[PROFILE_{}_POLICY_SIZE] = {{".format(
+        const,
+        u8,
+        naming_convention_filter("profile_", False, efi_type),
+        base_name,
+        naming_convention_filter("_policy", False, efi_type),
+        base_name.upper()
+    ) + le)
+    for start in range(0, len(blob), 16):
+        out.write(sp + " ".join("0x{:02x},".format(byte) for byte in blob[start:start + 16]) + le)
+    out.write("};" + le)
+    out.write(le)
+
+    return len(blob)
+
+
+# The table of every profile's config policy, followed by the generic profile, and a getter mapping a profile index to
+# its entry
+def write_profile_policy_table(efi_type, out, profiles):
+    le = get_line_ending(efi_type)
+    sp = get_spacing_string(efi_type)
+    const = get_type_string("const", efi_type)
+    profile_policy = naming_convention_filter("profile_policy_t", True, efi_type)
+    policy_field = naming_convention_filter("policy", False, efi_type)
+    policy_size_field = naming_convention_filter("policy_size", False, efi_type)
+    index_var = naming_convention_filter("profile_index", False, efi_type)
+
+    if not efi_type:
+        table = naming_convention_filter("profile_policies", False, efi_type)
+    else:
+        table = "g" + naming_convention_filter("profile_policy_data", False, efi_type)
+
+    out.write(le)
+    out.write("// The last entry is the generic profile, the knob defaults" + le)
+    out.write("{} {}[PROFILE_COUNT + 1] = ".format(profile_policy, table) + le + "{" + le)
+    for profile in profiles + [GENERIC_PROFILE_POLICY_NAME]:
+        out.write(sp + "{" + le)
+        out.write(sp * 2 + ".{} = {}{}{},".format(
+            policy_field,
+            naming_convention_filter("profile_", False, efi_type),
+            profile,
+            naming_convention_filter("_policy", False, efi_type)
+        ) + le)
+        out.write(sp * 2 + ".{} = PROFILE_{}_POLICY_SIZE,".format(policy_size_field, profile.upper()) + le)
+        out.write(sp + "}," + le)
+    out.write("};" + le)
+
+    out.write(le)
+    out.write("// Return the config policy of a profile, or of the generic profile for any index that is not a profile"
+              + le)
+    out.write("{} {}* {}({} {})".format(
+        const,
+        profile_policy,
+        naming_convention_filter("get_profile_policy", False, efi_type),
+        get_type_string("uint32_t", efi_type),
+        index_var
+    ) + le)
+    out.write("{" + le)
+    if len(profiles) == 0:
+        # Every index is the generic profile. Comparing it against a PROFILE_COUNT of 0 would trip -Wtype-limits
+        out.write(sp + "return &{}[PROFILE_COUNT];".format(table) + le)
+        out.write("}" + le)
+        return
+
+    out.write(sp + "if ({} >= PROFILE_COUNT) {{".format(index_var) + le)
+    out.write(sp * 2 + "return &{}[PROFILE_COUNT];".format(table) + le)
+    out.write(sp + "}" + le)
+    out.write(le)
+    out.write(sp + "return &{}[{}];".format(table, index_var) + le)
+    out.write("}" + le)
+
+
+# Generates the profile header of a list of profile CSVs. The CSVs are loaded into profiles, unless already loaded
+# profiles (VariableList.Profile) are passed instead, and the knob values of the schema are left untouched
+def generate_profiles(schema, profile_header_path, profile_paths, efi_type, profile_names=None,
+                      bitmap_profiles=False, policy_blobs=False, profiles=None):
+    if profiles is None:
+        profiles = VariableList.load_profiles(schema, profile_paths)
+
+    with open_generated_file(profile_header_path) as out:
+        out.write(get_spdx_header(profile_header_path, efi_type))
+        out.write(get_include_once_style(profile_header_path, uefi=efi_type, header=True))
+        out.write("// The config public header must be included prior to this file" + get_line_ending(efi_type))
+        if bitmap_profiles:
+            out.write("// The config data header must also be included prior to this file" + get_line_ending(efi_type))
+        out.write("// Generated Header" + get_line_ending(efi_type))
+        out.write("//  Script: {}".format(sys.argv[0]) + get_line_ending(efi_type))
+        out.write("//  Schema: {}".format(schema.path) + get_line_ending(efi_type))
+        for profile in profiles:
+            out.write("//  Profile: {}".format(profile.path) + get_line_ending(efi_type))
+
+        out.write("" + get_line_ending(efi_type))
+
+        format_options = VariableList.StringFormatOptions()
+        format_options.c_format = True
+        format_options.efi_format = efi_type
+
+        profile_entries = []
+        for profile in profiles:
+            base_name = profile.name
+            out.write("// Profile {}".format(base_name) + get_line_ending(efi_type))
+
+            if policy_blobs:
+                write_profile_policy_blob(efi_type, out, schema, profile)
+
+            if bitmap_profiles:
+                profile_entries.append((base_name, write_profile_bitmap(efi_type, out, schema, profile)))
+                continue
+
+            overrides = profile.get_overrides(schema)
+            override_count = len(overrides)
+
+            out.write("typedef struct {" + get_line_ending(efi_type))
+            for knob, value in overrides:
+                out.write(get_spacing_string(efi_type) + "{} {};".format(
+                    get_type_string(knob.format.c_type, efi_type),
+                    knob.name) + get_line_ending(efi_type))
+            out.write("}} {}{}{};".format(
+                naming_convention_filter("profile_", True, efi_type),
+                base_name,
+                naming_convention_filter("_data_t", True, efi_type)
+            ) + get_line_ending(efi_type))
+
+            out.write("" + get_line_ending(efi_type))
+            out.write("{}{}{} {}{}{} = {{".format(
+                naming_convention_filter("profile_", True, efi_type),
+                base_name,
+                naming_convention_filter("_data_t", True, efi_type),
+                naming_convention_filter("profile_", False, efi_type),
+                base_name,
+                naming_convention_filter("_data", False, efi_type)
+            ) + get_line_ending(efi_type))
+            for knob, value in overrides:
+                out.write("    .{}={},".format(
+                    knob.name,
+                    knob.format.object_to_string(value, format_options)) + get_line_ending(efi_type))
+            out.write("};" + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+            out.write("#define PROFILE_{}_OVERRIDES".format(base_name.upper()) + get_line_ending(efi_type))
+            out.write("#define PROFILE_{}_OVERRIDES_COUNT {}".format(
+                base_name.upper(),
+                override_count
+            ) + get_line_ending(efi_type))
+            out.write("{} {}{}{}[PROFILE_{}_OVERRIDES_COUNT + 1] = {{".format(
+                naming_convention_filter("knob_override_t", True, efi_type),
+                naming_convention_filter("profile_", False, efi_type),
+                base_name,
+                naming_convention_filter("_overrides", False, efi_type),
+                base_name.upper()
+            ) + get_line_ending(efi_type))
+
+            for knob, _ in overrides:
+                out.write(get_spacing_string(efi_type) + "{" + get_line_ending(efi_type))
+                out.write(get_spacing_string(efi_type, 2) + ".{} = KNOB_{},".format(
+                    naming_convention_filter("knob", False, efi_type),
+                    knob.name
+                ) + get_line_ending(efi_type))
+                out.write(get_spacing_string(efi_type, 2) + ".{} = &{}{}{}.{},".format(
+                    naming_convention_filter("value", False, efi_type),
+                    naming_convention_filter("profile_", False, efi_type),
+                    base_name,
+                    naming_convention_filter("_data", False, efi_type),
+                    knob.name
+                ) + get_line_ending(efi_type))
+                out.write(get_spacing_string(efi_type) + "}," + get_line_ending(efi_type))
+
+            out.write(get_spacing_string(efi_type) + "{" + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type, 2) + ".{} = KNOB_MAX,".format(
+                naming_convention_filter("knob", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type, 2) + ".{} = NULL,".format(
+                naming_convention_filter("value", False, efi_type)
+            ) + get_line_ending(efi_type))
+            out.write(get_spacing_string(efi_type) + "}" + get_line_ending(efi_type))
+            out.write("};" + get_line_ending(efi_type))
+            out.write("" + get_line_ending(efi_type))
+
+            profile_entries.append((base_name, override_count))
+        out.write("" + get_line_ending(efi_type))
+        out.write("#define PROFILE_COUNT {}".format(len(profile_entries)) + get_line_ending(efi_type))
+        if bitmap_profiles:
+            write_profile_bitmap_table(efi_type, out, profile_entries)
+            write_profile_bitmap_apply_implementation(efi_type, out)
+        else:
+            write_profile_override_table(efi_type, out, profile_entries)
+        if policy_blobs:
+            # The generic profile carries no overrides, so its blob holds the schema defaults
+            out.write(get_line_ending(efi_type))
+            out.write("// Profile {}".format(GENERIC_PROFILE_POLICY_NAME) + get_line_ending(efi_type))
+            write_profile_policy_blob(efi_type, out, schema, VariableList.Profile(GENERIC_PROFILE_POLICY_NAME, []))
+            write_profile_policy_table(efi_type, out, [name for (name, _) in profile_entries])
+        if efi_type:
+            if profile_names is not None:
+                names_list = profile_names.split(",")
+            else:
+                # If not specified, the indices will be the default profile names
+                names_list = [format(i, '02x') for i in range(len(profiles))]
+
+            out.write(get_line_ending(efi_type))
+            out.write(get_type_string("char*", efi_type) + " g{}[PROFILE_COUNT]".format(
+                naming_convention_filter("_profile_flavor_names", False, efi_type)) + " = {"
+            )
+            out.write(get_line_ending(efi_type))
+            for profile_name in names_list:
+                out.write(get_spacing_string(efi_type) + '"' + profile_name + '",' + get_line_ending(efi_type))
+            out.write("};" + get_line_ending(efi_type))
+            out.write(get_line_ending(efi_type))
+            out.write(get_type_string("size_t", efi_type) + " g{} = PROFILE_COUNT;".format(
+                naming_convention_filter("_num_profiles", False, efi_type))
+            )
+            out.write(get_line_ending(efi_type))
+
+        out.write(get_include_once_style(profile_header_path, uefi=efi_type, header=False))
+
+
+def generate_sources(schema, public_header, service_header, data_header, efi_type, aligned_policy=False,
+                     max_policy_size=MAX_CONF_POLICY_SIZE, constraint_table=False):
+    # the layout of the knobs is computed once for all of the headers
+    layout = SchemaLayout(schema, efi_type is True, aligned_policy, max_policy_size)
+    generate_public_header(schema, public_header, efi_type, layout)
+    # in UEFI builds, getter implementations go to service_header and data to
+    # data_header. In non-UEFI builds, both go to service_header
+    if efi_type is True:
+        generate_getter_implementation(schema, service_header, efi_type, aligned_policy, max_policy_size, layout)
+        generate_cached_implementation(schema, data_header, efi_type, aligned_policy, max_policy_size,
+                                       constraint_table, layout)
+    else:
+        generate_cached_implementation(schema, service_header, efi_type, constraint_table_mode=constraint_table,
+                                       layout=layout)
+
+
+def usage():
+    print("Commands:\n")
+    print("  generateheader[_efi] <schema.xml> <public_header.h> <service_header.h> "
+          "[<data_header.h>] [<profile_header.h> <profile.csv>...]")
+    print("")
+    print("schema.xml       : An XML with the definition of a set of known")
+    print("                   config knobs and types to interpret them\n")
+    print("public_header.h  : Output header for use by config consumers\n")
+    print("service_header.h : Output header for use by config provider. In UEFI builds")
+    print("                   this only contains getter implementations\n")
+    print("data_header.h    : Output header for UEFI builds only. This contains only")
+    print("                   the data. In non-UEFI builds, service_header.h and")
+    print("                   data_header.h are combined\n")
+    print("profile_header.h : Output header for the profile data for consumption")
+    print("                   by config providers.")
+    print("profile.csv...   : n-number of profile csvs that describe the platform's")
+    print("                   overridden config knobs")
+    print("-pn names        : n-number of 2-character profile names that uniquely identify the")
+    print("                   profiles specified in profile.csv")
+    print("--alignedpolicy  : UEFI builds only. The config policy is published in the aligned")
+    print("                   variable list format instead of packed variable list entries")
+    print("--policysize N   : UEFI builds only. The largest config policy in bytes, at most and by")
+    print("                   default MAX_UINT16. Knobs that do not fit are packed in additional")
+    print("                   config policies, published under the next GUIDs of")
+    print("                   PcdConfigurationPolicyGuid. Consumers defining CONFIG_LAZY_POLICY_CACHE")
+    print("                   fetch a whole policy onto the stack, and need it at most")
+    print("                   CONFIG_LAZY_POLICY_MAX_SIZE, 0x1000 bytes by default")
+    print("--constrainttable: Validate the knobs through a table of leaf constraints checked by one")
+    print("                   generic loop, and emit validate_knob_values for a whole knob values")
+    print("                   structure, instead of a function per constrained knob")
+    print("--bitmapprofiles : Encode each profile as a bitmap over the knobs and the packed values")
+    print("                   of the overridden knobs, applied with apply_profile_bitmap, instead")
+    print("                   of the KNOB_OVERRIDE arrays")
+    print("--policyblobs    : Also emit the config policy of each profile and of the generic profile")
+    print("                   as ready to publish variable lists, selected with get_profile_policy")
+
+
+def arg_parse():
+    parser = argparse.ArgumentParser()
+
+    parser.add_argument(
+        '-pn', '--profilenames', dest='profile_names', type=str, default=None,
+        help='''Specify the comma separated profile names by passing -pn <Name1,Name2> '''
+             '''or --profilenames <Name1,Name2,Name3>.''')
+
+    parser.add_argument(
+        '--alignedpolicy', dest='aligned_policy', action='store_true', default=False,
+        help='''Generate getters for a config policy in the aligned variable list format.''')
+
+    parser.add_argument(
+        '--policysize', dest='max_policy_size', type=lambda x: int(x, 0), default=MAX_CONF_POLICY_SIZE,
+        help='''Largest config policy in bytes, the knobs are packed across as many config policies as needed.''')
+
+    parser.add_argument(
+        '--constrainttable', dest='constraint_table', action='store_true', default=False,
+        help='''Generate the knob validators from a table of leaf constraints checked by one generic loop.''')
+
+    parser.add_argument(
+        '--bitmapprofiles', dest='bitmap_profiles', action='store_true', default=False,
+        help='''Encode each profile as a bitmap of overridden knobs and a packed stream of their values.''')
+
+    parser.add_argument(
+        '--policyblobs', dest='policy_blobs', action='store_true', default=False,
+        help='''Emit a precomputed config policy in the variable list format for each profile.''')
+
+    return parser.parse_known_args()
+
+
+def main():
+    # We should not overload the positional argument anymore given we are accepting nondeterministic number of space
+    # separated profile paths... So please add the new ones here...
+    known_args, left_over = arg_parse()
+    sys.argv = sys.argv[:1] + left_over
+
+    arg_num = 1
+    if len(sys.argv) < 2:
+        usage()
+        sys.stderr.write('Must provide a command.\n')
+        sys.exit(1)
+        return
+
+    if sys.argv[arg_num].lower() == "generateheader" or sys.argv[arg_num].lower() == "generateheader_efi":
+        if sys.argv[arg_num].lower() == "generateheader" and len(sys.argv) < 5:
+            usage()
+            sys.stderr.write('Invalid number of arguments.\n')
+            sys.exit(1)
+            return
+
+        if sys.argv[arg_num].lower() == "generateheader_efi" and len(sys.argv) < 6:
+            usage()
+            sys.stderr.write('Invalid number of arguments.\n')
+            sys.exit(1)
+            return
+
+        efi_type = sys.argv[arg_num].lower() == "generateheader_efi"
+        arg_num += 1
+
+        schema_path = sys.argv[arg_num]
+        arg_num += 1
+        header_path = sys.argv[arg_num]
+        arg_num += 1
+        service_path = sys.argv[arg_num]
+        arg_num += 1
+        data_path = None
+
+        if efi_type is True:
+            data_path = sys.argv[arg_num]
+            arg_num += 1
+
+        # Load the schema
+        schema = VariableList.Schema.load(schema_path)
+
+        if known_args.max_policy_size <= 0 or known_args.max_policy_size > MAX_CONF_POLICY_SIZE:
+            sys.stderr.write('Invalid config policy size %d.\n' % known_args.max_policy_size)
+            return -1
+
+        generate_sources(schema, header_path, service_path, data_path, efi_type, known_args.aligned_policy,
+                         known_args.max_policy_size, known_args.constraint_table)
+
+        if (len(sys.argv) >= arg_num + 1):
+            profile_header_path = sys.argv[arg_num]
+            arg_num += 1
+            profile_paths = sys.argv[arg_num:]
+
+            if known_args.profile_names is not None:
+                # Do some minimal sanity checks
+                names = known_args.profile_names.split(",")
+                if len(names) != len(profile_paths):
+                    sys.stderr.write('Invalid count of profile names %d.\n' % len(names))
+                    return -1
+
+                lengths = [len(name) for name in names]
+                max_length = max(lengths)
+                min_length = min(lengths)
+
+                if max_length != 2 or min_length != 2:
+                    sys.stderr.write('Invalid profile names, should be 2-character for all entries.\n')
+                    return -1
+
+            generate_profiles(schema, profile_header_path, profile_paths, efi_type,
+                              profile_names=known_args.profile_names,
+                              bitmap_profiles=known_args.bitmap_profiles,
+                              policy_blobs=known_args.policy_blobs)
+        return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
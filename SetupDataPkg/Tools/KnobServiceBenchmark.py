@@ -0,0 +1,143 @@
+# @ KnobServiceBenchmark.py
+#
+# Measures how KnobService.py scales, generating the headers of synthetic schemas of 100 to 20,000 knobs with wide
+# enums. Each knob count is generated in the stdlib, UEFI and UEFI aligned policy styles, and one CSV row is printed
+# per schema and style with the time taken and the size of the generated headers, so runs can be compared.
+#
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+import os
+import sys
+import time
+import argparse
+import tempfile
+
+import VariableList
+import KnobService
+
+BENCHMARK_NAMESPACE = "{6F4A2C1E-3B5D-4E7F-9A1B-2C3D4E5F6A7B}"
+
+# (style, efi_type, aligned_policy)
+BENCHMARK_STYLES = [
+    ("stdlib", False, False),
+    ("uefi", True, False),
+    ("uefi_aligned", True, True),
+]
+
+
+#
+# Build the XML of a synthetic schema of knob_count knobs, cycling through constrained integers, the enums, a
+# struct holding an array and the enums, and plain integers. There is a dense enum of enum_values values with a single
+# gap, validated by a range check, and a sparse one spread over a range enum_step times wider, validated by a switch
+#
+def create_schema_xml(knob_count, enum_values, enum_step):
+    lines = []
+    lines.append('<ConfigSchema xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance"'
+                 ' xsi:noNamespaceSchemaLocation="configschema.xsd">')
+    lines.append("  <Enums>")
+    lines.append('    <Enum name="e_dense_t" help="Dense enum">')
+    for number in range(enum_values + 1):
+        if number != enum_values // 2:
+            lines.append('      <Value name="v_{}" value="{}" />'.format(number, number))
+    lines.append("    </Enum>")
+    lines.append('    <Enum name="e_sparse_t" help="Sparse enum">')
+    for number in range(enum_values):
+        lines.append('      <Value name="v_{}" value="{}" help="Value {}" />'.format(
+            number, number * enum_step, number))
+    lines.append("    </Enum>")
+    lines.append("  </Enums>")
+
+    lines.append("  <Structs>")
+    lines.append('    <Struct name="s_bench_t" help="Benchmark struct">')
+    lines.append('      <Member name="m_uint8_t_c8_max100" type="uint8_t" count="8" max="{100}" />')
+    lines.append('      <Member name="m_uint32_t_min5" type="uint32_t" default="10" min="5" />')
+    lines.append('      <Member name="m_dense" type="e_dense_t" default="v_0" />')
+    lines.append('      <Member name="m_sparse" type="e_sparse_t" default="v_1" />')
+    lines.append("    </Struct>")
+    lines.append("  </Structs>")
+
+    lines.append('  <Knobs namespace="{}">'.format(BENCHMARK_NAMESPACE))
+    for index in range(knob_count):
+        kind = index % 5
+        if kind == 0:
+            lines.append('    <Knob type="uint16_t" name="k_{:05d}" default="100" min="10" max="1000"'
+                         ' help="Constrained knob {}" />'.format(index, index))
+        elif kind == 1:
+            lines.append('    <Knob type="e_dense_t" name="k_{:05d}" default="v_1" />'.format(index))
+        elif kind == 2:
+            lines.append('    <Knob type="s_bench_t" name="k_{:05d}" help="Struct knob {}" />'.format(index, index))
+        elif kind == 3:
+            lines.append('    <Knob type="e_sparse_t" name="k_{:05d}" default="v_2" />'.format(index))
+        else:
+            lines.append('    <Knob type="uint64_t" name="k_{:05d}" default="{}" />'.format(index, index))
+    lines.append("  </Knobs>")
+    lines.append("</ConfigSchema>")
+    return "\n".join(lines)
+
+
+#
+# Generate the headers of a schema in a style into output_dir
+# return the seconds taken and the total size in bytes of the headers
+#
+def generate(schema, output_dir, efi_type, aligned_policy):
+    paths = [os.path.join(output_dir, name) for name in ("public.h", "service.h", "data.h")]
+    for path in paths:
+        if os.path.exists(path):
+            os.remove(path)
+
+    start = time.perf_counter()
+    KnobService.generate_sources(schema, paths[0], paths[1], paths[2], efi_type, aligned_policy)
+    seconds = time.perf_counter() - start
+
+    return seconds, sum(os.path.getsize(path) for path in paths if os.path.exists(path))
+
+
+def arg_parse():
+    parser = argparse.ArgumentParser(description="Measure the header generation time of KnobService.py")
+    parser.add_argument(
+        "--knobs", dest="knob_counts", type=lambda x: [int(count) for count in x.split(",")],
+        default=[100, 1000, 5000, 20000],
+        help="Comma separated knob counts of the generated schemas")
+    parser.add_argument(
+        "--enumvalues", dest="enum_values", type=int, default=4096,
+        help="Number of values of each of the wide enums")
+    parser.add_argument(
+        "--enumstep", dest="enum_step", type=int, default=97,
+        help="Distance between the values of the sparse enum")
+    parser.add_argument(
+        "--repeat", dest="repeat", type=int, default=1,
+        help="Number of times each schema is generated, the fastest run is reported")
+    return parser.parse_args()
+
+
+def main():
+    args = arg_parse()
+
+    print("Style,Knobs,EnumValues,SchemaSeconds,GenerateSeconds,OutputBytes,KnobsPerSecond")
+    with tempfile.TemporaryDirectory() as output_dir:
+        for knob_count in args.knob_counts:
+            xml = create_schema_xml(knob_count, args.enum_values, args.enum_step)
+            start = time.perf_counter()
+            schema = VariableList.Schema.parse(xml)
+            schema_seconds = time.perf_counter() - start
+            schema.path = "benchmark_{}.xml".format(knob_count)
+
+            for (style, efi_type, aligned_policy) in BENCHMARK_STYLES:
+                runs = [generate(schema, output_dir, efi_type, aligned_policy) for _ in range(args.repeat)]
+                (seconds, output_bytes) = min(runs)
+                print("{},{},{},{:.3f},{:.3f},{},{:.0f}".format(
+                    style,
+                    knob_count,
+                    args.enum_values,
+                    schema_seconds,
+                    seconds,
+                    output_bytes,
+                    knob_count / seconds if seconds > 0 else 0))
+                sys.stdout.flush()
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
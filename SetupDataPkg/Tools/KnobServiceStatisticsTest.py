@@ -0,0 +1,283 @@
+# @ KnobServiceStatisticsTest.py
+#
+# Host check of the per knob statistics of the stdlib headers, CONFIG_KNOB_STATISTICS. The headers of a small schema
+# are generated and built with a driver that gets and sets the knobs a known number of times, from several threads
+# for one of them. The driver is built with and without CONFIG_KNOB_STATISTICS, each with and without
+# CONFIG_CONCURRENT_CACHE. With statistics, the counters, their CSV dump and their reset must match the calls made.
+# Without, the counters must stay 0 and the preprocessed driver must hold neither the counting nor the statistics
+# functions, so that they compile away. One line is printed per build.
+#
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+import os
+import sys
+import argparse
+import tempfile
+import subprocess
+
+import VariableList
+import KnobService
+
+STATISTICS_NAMESPACE = "{8E4F2A61-3C7B-4D95-A0E8-5B1C9D7F3A24}"
+
+# (build, compiler flags, whether the statistics are counted)
+STATISTICS_BUILDS = [
+    ("statistics", ["-DCONFIG_KNOB_STATISTICS"], True),
+    ("statistics_concurrent", ["-DCONFIG_KNOB_STATISTICS", "-DCONFIG_CONCURRENT_CACHE"], True),
+    ("disabled", [], False),
+    ("disabled_concurrent", ["-DCONFIG_CONCURRENT_CACHE"], False),
+]
+
+# Only found in the preprocessed driver when the statistics are compiled in
+STATISTICS_MARKERS = [
+    "statistics.get_count",
+    "statistics.set_count",
+    "config_dump_knob_statistics",
+    "config_reset_knob_statistics",
+]
+
+# k_threaded is only read by the threads of the driver. k_limited is never set past its maximum, so a set rejected by
+# its validator must not be counted
+STATISTICS_SCHEMA_XML = """<ConfigSchema xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance"
+  xsi:noNamespaceSchemaLocation="configschema.xsd">
+  <Knobs namespace="{}">
+    <Knob type="uint32_t" name="k_plain" />
+    <Knob type="uint32_t" name="k_limited" default="1" max="10" />
+    <Knob type="uint64_t" name="k_threaded" />
+  </Knobs>
+</ConfigSchema>
+""".format(STATISTICS_NAMESPACE)
+
+STATISTICS_DRIVER_C = r"""
+#define CONFIG_INCLUDE_CACHE
+#define CONFIG_SET_VARIABLES
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "public.h"
+#include "service.h"
+
+#define THREAD_COUNT 4
+#define THREAD_GETS 10000
+
+static int g_failures = 0;
+
+#ifndef CONFIG_CONCURRENT_CACHE
+// Left to the integrator without the concurrent cache
+void* get_knob_value(knob_t knob)
+{
+    return g_knob_data[knob].cache_value_address;
+}
+
+bool set_knob_value(knob_t knob, void* value)
+{
+    if (!g_knob_data[knob].validator(value)) {
+        return false;
+    }
+
+    memcpy(g_knob_data[knob].cache_value_address, value, g_knob_data[knob].value_size);
+    return true;
+}
+#endif // CONFIG_CONCURRENT_CACHE
+
+static void check(int condition, const char* message)
+{
+    if (!condition) {
+        fprintf(stderr, "%s\n", message);
+        g_failures++;
+    }
+}
+
+static void* reader(void* context)
+{
+    unsigned index;
+    uint64_t sum = 0;
+
+    (void)context;
+    for (index = 0; index < THREAD_GETS; index++) {
+        sum += config_get_k_threaded();
+    }
+
+    return (void*)(uintptr_t)sum;
+}
+
+#ifdef CONFIG_KNOB_STATISTICS
+static long long get_count(knob_t knob)
+{
+    return (long long)atomic_load(&g_knob_data[knob].statistics.get_count);
+}
+
+static long long set_count(knob_t knob)
+{
+    return (long long)atomic_load(&g_knob_data[knob].statistics.set_count);
+}
+#endif // CONFIG_KNOB_STATISTICS
+
+int main(void)
+{
+    pthread_t threads[THREAD_COUNT];
+    unsigned index;
+    uint32_t value;
+    long long plain_gets = 3;
+    long long plain_sets = 2;
+
+    config_get_k_plain();
+    config_get_k_plain();
+    config_get_k_plain();
+    check(config_set_k_plain(5), "config_set_k_plain failed");
+    check(config_set_k_plain(6), "config_set_k_plain failed");
+
+#ifdef CONFIG_CONCURRENT_CACHE
+    // The knob indexed accessors count as the typed getters and setters do
+    check(config_read_knob_value(KNOB_k_plain, &value) && (value == 6), "config_read_knob_value failed");
+    check(config_write_knob_value(KNOB_k_plain, &value), "config_write_knob_value failed");
+    plain_gets++;
+    plain_sets++;
+#endif
+
+    config_get_k_limited();
+    check(!config_set_k_limited(11), "config_set_k_limited did not validate");
+    check(config_set_k_limited(10), "config_set_k_limited failed");
+
+    for (index = 0; index < THREAD_COUNT; index++) {
+        check(pthread_create(&threads[index], NULL, reader, NULL) == 0, "pthread_create failed");
+    }
+    for (index = 0; index < THREAD_COUNT; index++) {
+        pthread_join(threads[index], NULL);
+    }
+
+#ifdef CONFIG_KNOB_STATISTICS
+    char expected[256];
+    char dump[256] = { 0 };
+    FILE* stream;
+
+    check(get_count(KNOB_k_plain) == plain_gets, "k_plain gets are off");
+    check(set_count(KNOB_k_plain) == plain_sets, "k_plain sets are off");
+    check(get_count(KNOB_k_limited) == 1, "k_limited gets are off");
+    check(set_count(KNOB_k_limited) == 1, "k_limited sets are off, counting the rejected one");
+    check(get_count(KNOB_k_threaded) == THREAD_COUNT * THREAD_GETS, "k_threaded lost gets across threads");
+    check(set_count(KNOB_k_threaded) == 0, "k_threaded sets are off");
+
+    snprintf(expected, sizeof(expected), "Knob,Gets,Sets\nk_plain,%lld,%lld\nk_limited,1,1\nk_threaded,%d,0\n",
+             plain_gets, plain_sets, THREAD_COUNT * THREAD_GETS);
+    stream = tmpfile();
+    check(stream != NULL, "tmpfile failed");
+    if (stream != NULL) {
+        config_dump_knob_statistics(stream);
+        rewind(stream);
+        check(fread(dump, 1, sizeof(dump) - 1, stream) > 0, "config_dump_knob_statistics wrote nothing");
+        fclose(stream);
+        check(strcmp(dump, expected) == 0, "config_dump_knob_statistics does not match the counts");
+    }
+
+    config_reset_knob_statistics();
+    for (index = 0; index < KNOB_MAX; index++) {
+        check((get_count((knob_t)index) == 0) && (set_count((knob_t)index) == 0),
+              "config_reset_knob_statistics left a count");
+    }
+#else
+    // Copied as a whole, so that this driver names no counter that should have compiled away
+    knob_statistics_t counts;
+
+    (void)plain_gets;
+    (void)plain_sets;
+    for (index = 0; index < KNOB_MAX; index++) {
+        counts = g_knob_data[index].statistics;
+        check((counts.get_count == 0) && (counts.set_count == 0),
+              "a knob was counted without CONFIG_KNOB_STATISTICS");
+    }
+#endif
+
+    (void)value;
+    return (g_failures == 0) ? 0 : 1;
+}
+"""
+
+
+#
+# Generate the stdlib headers of the statistics schema and the driver into output_dir, return the driver path
+#
+def generate(output_dir):
+    schema_path = os.path.join(output_dir, "statistics.xml")
+    with open(schema_path, "w") as file:
+        file.write(STATISTICS_SCHEMA_XML)
+
+    schema = VariableList.Schema.load(schema_path)
+    KnobService.generate_sources(
+        schema, os.path.join(output_dir, "public.h"), os.path.join(output_dir, "service.h"), None, False)
+
+    driver_path = os.path.join(output_dir, "driver.c")
+    with open(driver_path, "w") as file:
+        file.write(STATISTICS_DRIVER_C)
+    return driver_path
+
+
+#
+# Check that the statistics are compiled in the driver only when counted, return an error message or None
+#
+def check_preprocessed(compiler, driver_path, build, flags, counted):
+    command = [compiler, "-std=c11", "-E", "-P"] + flags + [driver_path]
+    result = subprocess.run(command, capture_output=True, text=True)
+    if result.returncode != 0:
+        return "{} preprocessing failed:\n{}".format(build, result.stderr)
+
+    for marker in STATISTICS_MARKERS:
+        if (marker in result.stdout) != counted:
+            return "{} {} {}".format(build, "lacks" if counted else "still holds", marker)
+
+    return None
+
+
+#
+# Build the driver with flags and run it, return an error message or None
+#
+def build_and_run(compiler, driver_path, build, flags, counted):
+    error = check_preprocessed(compiler, driver_path, build, flags, counted)
+    if error is not None:
+        return error
+
+    binary = os.path.join(os.path.dirname(driver_path), "driver_" + build)
+    command = [compiler, "-std=c11", "-Wall", "-Werror", "-O2", "-pthread"] + flags + [driver_path, "-o", binary]
+    result = subprocess.run(command, capture_output=True, text=True)
+    if result.returncode != 0:
+        return "{} build failed:\n{}".format(build, result.stderr)
+
+    result = subprocess.run([binary], capture_output=True, text=True)
+    if result.returncode != 0:
+        return "{} run failed with {}:\n{}".format(build, result.returncode, result.stderr)
+
+    return None
+
+
+def arg_parse():
+    parser = argparse.ArgumentParser(description="Check the knob statistics of the KnobService.py headers")
+    parser.add_argument(
+        "--cc", dest="compiler", default=os.environ.get("CC", "cc"),
+        help="C11 compiler with pthread support")
+    return parser.parse_args()
+
+
+def main():
+    args = arg_parse()
+    failed = False
+
+    with tempfile.TemporaryDirectory() as output_dir:
+        driver_path = generate(output_dir)
+        for (build, flags, counted) in STATISTICS_BUILDS:
+            error = build_and_run(args.compiler, driver_path, build, flags, counted)
+            if error is not None:
+                sys.stderr.write(error + "\n")
+                failed = True
+                continue
+            print("{}: passed".format(build))
+            sys.stdout.flush()
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
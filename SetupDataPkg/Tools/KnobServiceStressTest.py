@@ -0,0 +1,264 @@
+# @ KnobServiceStressTest.py
+#
+# Stress test of the concurrent knob cache of the stdlib headers, CONFIG_CONCURRENT_CACHE. The headers of a small
+# schema are generated and built with a driver in which reader threads check that no knob is ever seen half set, while
+# writer threads keep setting the knobs. The driver is built once with ThreadSanitizer, which fails the run on any
+# data race, and once optimized, to measure the readers. One CSV row is printed per build.
+#
+# Copyright (c) Microsoft Corporation.
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+#
+import os
+import sys
+import argparse
+import tempfile
+import subprocess
+
+import VariableList
+import KnobService
+
+STRESS_NAMESPACE = "{3D7C1B2A-6E5F-4A8B-9C0D-1E2F3A4B5C6D}"
+
+# (build, compiler flags)
+STRESS_BUILDS = [
+    ("tsan", ["-O1", "-g", "-fsanitize=thread"]),
+    ("release", ["-O2"]),
+]
+
+# The halves of k_pair are always set equal, so a reader seeing them differ saw a torn value. k_counter is only set
+# by the first writer, counting up, so readers must never see it go back. k_limited is never set past its maximum
+STRESS_SCHEMA_XML = """<ConfigSchema xmlns:xsi="http://www.w3.org/2001/XMLSchema-instance"
+  xsi:noNamespaceSchemaLocation="configschema.xsd">
+  <Structs>
+    <Struct name="s_pair_t" help="Two halves that are always set equal">
+      <Member name="m_low" type="uint64_t" />
+      <Member name="m_high" type="uint64_t" />
+    </Struct>
+  </Structs>
+  <Knobs namespace="{}">
+    <Knob type="s_pair_t" name="k_pair" />
+    <Knob type="uint64_t" name="k_counter" />
+    <Knob type="uint32_t" name="k_limited" default="1" max="10" />
+  </Knobs>
+</ConfigSchema>
+""".format(STRESS_NAMESPACE)
+
+STRESS_DRIVER_C = r"""
+#define CONFIG_INCLUDE_CACHE
+#define CONFIG_CONCURRENT_CACHE
+#define CONFIG_SET_VARIABLES
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define CONFIG_CONCURRENT_CACHE_WAIT() sched_yield()
+
+#include "public.h"
+#include "service.h"
+
+static unsigned long g_iterations;
+static unsigned long g_writers;
+static atomic_ulong g_failures = 0;
+
+static void fail(const char* message)
+{
+    if (atomic_fetch_add(&g_failures, 1) == 0) {
+        fprintf(stderr, "%s\n", message);
+    }
+}
+
+static void* reader(void* context)
+{
+    unsigned long index;
+    uint64_t last_counter = 0;
+    uint64_t counter;
+    s_pair_t pair;
+    knob_values_t values;
+
+    (void)context;
+    for (index = 0; index < g_iterations; index++) {
+        pair = config_get_k_pair();
+        if (pair.m_low != pair.m_high) {
+            fail("config_get_k_pair returned a torn value");
+        }
+
+        config_get_knob_values(&values);
+        if (values.k_pair.m_low != values.k_pair.m_high) {
+            fail("config_get_knob_values returned a torn value");
+        }
+
+        if (!config_read_knob_value(KNOB_k_counter, &counter) || (counter < last_counter)) {
+            fail("config_read_knob_value went back");
+        }
+        last_counter = counter;
+
+        if (config_get_k_limited() > 10) {
+            fail("config_get_k_limited is out of range");
+        }
+    }
+
+    return NULL;
+}
+
+static void* writer(void* context)
+{
+    unsigned long id = (unsigned long)(uintptr_t)context;
+    unsigned long index;
+    uint64_t counter;
+    uint32_t limited;
+    s_pair_t pair;
+
+    for (index = 0; index < g_iterations; index++) {
+        pair.m_low = pair.m_high = (uint64_t)index * g_writers + id;
+        if (!config_set_k_pair(pair)) {
+            fail("config_set_k_pair failed");
+        }
+
+        if (id == 0) {
+            counter = index + 1;
+            if (!config_write_knob_value(KNOB_k_counter, &counter)) {
+                fail("config_write_knob_value failed");
+            }
+        }
+
+        limited = (uint32_t)(index % 12);
+        if (config_set_k_limited(limited) != (limited <= 10)) {
+            fail("config_set_k_limited did not validate");
+        }
+    }
+
+    return NULL;
+}
+
+int main(int argc, char** argv)
+{
+    unsigned long readers;
+    unsigned long index;
+    pthread_t* threads;
+    struct timespec start;
+    struct timespec end;
+    double seconds;
+    uint64_t counter;
+
+    if (argc != 4) {
+        fprintf(stderr, "usage: %s <readers> <writers> <iterations>\n", argv[0]);
+        return 2;
+    }
+
+    readers = strtoul(argv[1], NULL, 0);
+    g_writers = strtoul(argv[2], NULL, 0);
+    g_iterations = strtoul(argv[3], NULL, 0);
+    threads = calloc(readers + g_writers, sizeof(pthread_t));
+    if (threads == NULL) {
+        return 2;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (index = 0; index < readers + g_writers; index++) {
+        if (pthread_create(&threads[index], NULL, (index < readers) ? reader : writer,
+                           (void*)(uintptr_t)(index - ((index < readers) ? 0 : readers))) != 0) {
+            return 2;
+        }
+    }
+    for (index = 0; index < readers + g_writers; index++) {
+        pthread_join(threads[index], NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    free(threads);
+
+    if ((g_writers != 0) && (!config_read_knob_value(KNOB_k_counter, &counter) || (counter != g_iterations))) {
+        fail("k_counter does not hold the last value set");
+    }
+
+    seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+    printf("%lu,%lu,%lu,%.3f,%.0f\n", readers, g_writers, g_iterations, seconds,
+           (double)readers * g_iterations / seconds);
+    return (atomic_load(&g_failures) == 0) ? 0 : 1;
+}
+"""
+
+
+#
+# Generate the stdlib headers of the stress schema and the driver into output_dir, return the driver path
+#
+def generate(output_dir):
+    schema_path = os.path.join(output_dir, "stress.xml")
+    with open(schema_path, "w") as file:
+        file.write(STRESS_SCHEMA_XML)
+
+    schema = VariableList.Schema.load(schema_path)
+    KnobService.generate_sources(
+        schema, os.path.join(output_dir, "public.h"), os.path.join(output_dir, "service.h"), None, False)
+
+    driver_path = os.path.join(output_dir, "driver.c")
+    with open(driver_path, "w") as file:
+        file.write(STRESS_DRIVER_C)
+    return driver_path
+
+
+#
+# Build the driver with flags and run it, return the CSV row of its timings or None on failure
+#
+def build_and_run(compiler, driver_path, build, flags, args, iterations):
+    binary = os.path.join(os.path.dirname(driver_path), "driver_" + build)
+    command = [compiler, "-std=c11", "-Wall", "-Werror", "-pthread"] + flags + [driver_path, "-o", binary]
+    result = subprocess.run(command, capture_output=True, text=True)
+    if result.returncode != 0:
+        sys.stderr.write("{} build failed:\n{}\n".format(build, result.stderr))
+        return None
+
+    environment = dict(os.environ, TSAN_OPTIONS="halt_on_error=1 exitcode=66")
+    result = subprocess.run(
+        [binary, str(args.readers), str(args.writers), str(iterations)],
+        capture_output=True, text=True, env=environment)
+    if result.returncode != 0:
+        sys.stderr.write("{} run failed with {}:\n{}\n".format(build, result.returncode, result.stderr))
+        return None
+
+    return result.stdout.strip()
+
+
+def arg_parse():
+    parser = argparse.ArgumentParser(description="Stress the concurrent knob cache of the KnobService.py headers")
+    parser.add_argument(
+        "--cc", dest="compiler", default=os.environ.get("CC", "cc"),
+        help="C11 compiler with ThreadSanitizer support")
+    parser.add_argument(
+        "--readers", dest="readers", type=int, default=4,
+        help="Number of reader threads")
+    parser.add_argument(
+        "--writers", dest="writers", type=int, default=2,
+        help="Number of writer threads")
+    parser.add_argument(
+        "--iterations", dest="iterations", type=int, default=1000000,
+        help="Iterations of each thread of the optimized build")
+    parser.add_argument(
+        "--tsaniterations", dest="tsan_iterations", type=int, default=20000,
+        help="Iterations of each thread of the ThreadSanitizer build")
+    return parser.parse_args()
+
+
+def main():
+    args = arg_parse()
+    failed = False
+
+    print("Build,Readers,Writers,Iterations,Seconds,ReadsPerSecond")
+    with tempfile.TemporaryDirectory() as output_dir:
+        driver_path = generate(output_dir)
+        for (build, flags) in STRESS_BUILDS:
+            iterations = args.tsan_iterations if build == "tsan" else args.iterations
+            row = build_and_run(args.compiler, driver_path, build, flags, args, iterations)
+            if row is None:
+                failed = True
+                continue
+            print("{},{}".format(build, row))
+            sys.stdout.flush()
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
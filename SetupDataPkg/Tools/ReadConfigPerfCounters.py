@@ -0,0 +1,136 @@
+# @file
+#
+# Read the configuration library counters of the current boot, published by ConfigPerfCounterLib
+# in the ConfigPerfCounters variable, and print them or append them to a CSV
+#
+# Copyright (c), Microsoft Corporation
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+
+import os
+import sys
+import csv
+import struct
+import logging
+import argparse
+from SettingSupport.UefiVariablesSupportLib import UefiVariable
+
+# Must match CONFIG_PERF_COUNTER_VARIABLE_NAME and gConfigPerfCounterTableGuid of SetupDataPkg
+CONFIG_PERF_COUNTER_VARIABLE_NAME = "ConfigPerfCounters"
+CONFIG_PERF_COUNTER_TABLE_GUID = "5e0f93a4-7c1b-4d62-9e38-1fa64b0dc287"
+CONFIG_PERF_COUNTER_TABLE_SIGNATURE = struct.unpack("<I", b"CPCT")[0]
+
+# Signature, Version, CounterCount and Reserved of CONFIG_PERF_COUNTER_TABLE
+CONFIG_PERF_COUNTER_HEADER_FORMAT = "<IIII"
+
+# Names of the counters, in the order of the CONFIG_PERF_COUNTER enum. Counters newer than this
+# tool are reported by their index
+CONFIG_PERF_COUNTER_NAMES = [
+    "EntriesParsed",
+    "BytesCrced",
+    "Allocations",
+    "GetVariableCalls",
+    "SetVariableCalls",
+    "OverrideHits",
+    "OverrideMisses",
+]
+
+
+def option_parser():
+    parser = argparse.ArgumentParser()
+
+    parser.add_argument(
+        "-i",
+        "--input",
+        dest="input_file",
+        required=False,
+        type=str,
+        default=None,
+        help="""Specify a saved copy of the variable to read instead of the UEFI variable""",
+    )
+
+    parser.add_argument(
+        "-o",
+        "--output",
+        dest="output_file",
+        required=False,
+        type=str,
+        default=None,
+        help="""Specify a CSV to append the counters of this boot to, as a single row""",
+    )
+
+    arguments = parser.parse_args()
+
+    if arguments.input_file is not None and not os.path.isfile(arguments.input_file):
+        print("Invalid input file: %s" % arguments.input_file)
+        sys.exit(1)
+
+    return arguments
+
+
+#
+# Parse the data of the ConfigPerfCounters variable
+# return a list of (counter name, PEI count, DXE count) tuples
+#
+def parse_config_perf_counters(data):
+    header_size = struct.calcsize(CONFIG_PERF_COUNTER_HEADER_FORMAT)
+    if len(data) < header_size:
+        raise Exception("Counter table too small: %d bytes" % len(data))
+
+    (signature, version, count, _) = struct.unpack_from(CONFIG_PERF_COUNTER_HEADER_FORMAT, data)
+    if signature != CONFIG_PERF_COUNTER_TABLE_SIGNATURE:
+        raise Exception("Invalid counter table signature: 0x%08x" % signature)
+
+    counter_format = "<%dQ" % count
+    if len(data) < header_size + 2 * struct.calcsize(counter_format):
+        raise Exception("Counter table too small for %d counters: %d bytes" % (count, len(data)))
+
+    pei = struct.unpack_from(counter_format, data, header_size)
+    dxe = struct.unpack_from(counter_format, data, header_size + struct.calcsize(counter_format))
+
+    names = CONFIG_PERF_COUNTER_NAMES + ["Counter%d" % index for index in range(len(CONFIG_PERF_COUNTER_NAMES), count)]
+    return list(zip(names, pei, dxe))
+
+
+def write_counters_csv(output_file, counters):
+    write_header = not os.path.isfile(output_file) or os.path.getsize(output_file) == 0
+    with open(output_file, "a", newline="") as csv_file:
+        writer = csv.writer(csv_file)
+        if write_header:
+            writer.writerow([f"{phase}{name}" for phase in ("Pei", "Dxe") for (name, _, _) in counters])
+        writer.writerow([counter[1] for counter in counters] + [counter[2] for counter in counters])
+
+
+#
+# main script function
+#
+def main():
+    arguments = option_parser()
+
+    if arguments.input_file is not None:
+        with open(arguments.input_file, "rb") as file:
+            data = file.read()
+    else:
+        (rc, data, error_string) = UefiVariable().GetUefiVar(CONFIG_PERF_COUNTER_VARIABLE_NAME,
+                                                             CONFIG_PERF_COUNTER_TABLE_GUID)
+        if rc != 0:
+            logging.error(f"Error returned from GetUefiVar: {rc} ({error_string}), is ConfigPerfCounterLib in use?")
+            return 1
+
+    try:
+        counters = parse_config_perf_counters(data)
+    except Exception as e:
+        logging.error(str(e))
+        return 1
+
+    print("%-20s %12s %12s" % ("Counter", "PEI", "DXE"))
+    for (name, pei, dxe) in counters:
+        print("%-20s %12d %12d" % (name, pei, dxe))
+
+    if arguments.output_file is not None:
+        write_counters_csv(arguments.output_file, counters)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -12,7 +12,7 @@ import argparse
 import struct
 import uuid
 import ctypes
-from SettingSupport.UefiVariablesSupportLib import UefiVariable
+from SettingSupport.UefiVariablesSupportLib import UefiVariable, print_batch_progress
 from VariableList import Schema, UEFIVariable, create_vlist_buffer
 
 
@@ -38,6 +38,15 @@ def option_parser():
         help="""Specify the output file path and name, in vl format""",
     )
 
+    parser.add_argument(
+        "-q",
+        "--quiet",
+        dest="quiet",
+        action="store_true",
+        default=False,
+        help="""Do not print the progress of the variable reads""",
+    )
+
     arguments = parser.parse_args()
 
     if arguments.configuration_file is not None and not os.path.isfile(arguments.configuration_file):
@@ -48,21 +57,24 @@ def option_parser():
 
 
 #
-# With given UEFI variable name and namespace (GUID), query the variable from
-# UEFI variable storage and convert the output to variable list formatted byte
-# array
+# With given list of UEFI variable names and namespaces (GUID), query the variables from
+# UEFI variable storage and convert the output to variable list formatted byte array
 #
-def read_variable_into_variable_list(uefi_var, name, namespace):
-    (rc, var, _) = uefi_var.GetUefiVar(name, namespace)
-    if rc != 0:
-        if rc != UefiVariable.ERROR_ENVVAR_NOT_FOUND:
-            # only log the errors other than EFI_NOT_FOUND, because not found is normal in this case...
-            logging.error(f"Error returned from GetUefiVar: {rc} on Name: {name}, Guid: {namespace}")
-        return b''
+def read_variables_into_variable_list(uefi_var, variables, progress=None):
+    (results, stats) = uefi_var.GetUefiVars(variables, progress)
 
-    variable = UEFIVariable(name, namespace, var)
-    b_array = create_vlist_buffer(variable)
-    return b_array
+    b_arrays = []
+    for (name, namespace), (rc, var) in zip(variables, results):
+        if rc != 0:
+            if rc != UefiVariable.ERROR_ENVVAR_NOT_FOUND:
+                # only log the errors other than EFI_NOT_FOUND, because not found is normal in this case...
+                logging.error(f"Error returned from GetUefiVar: {rc} on Name: {name}, Guid: {namespace}")
+            continue
+
+        b_arrays.append(create_vlist_buffer(UEFIVariable(name, namespace, var)))
+
+    print(stats)
+    return b"".join(b_arrays)
 
 
 #
@@ -72,10 +84,11 @@ def main():
     arguments = option_parser()
 
     UefiVar = UefiVariable()
+    progress = None if arguments.quiet else print_batch_progress
 
     # Get ready to write vl file
     with open(arguments.output_file, "wb") as file:
-        ret = b''
+        variables = []
         if arguments.configuration_file is None:
             # Read all the variables
             (rc, efi_var_names, error_string) = UefiVar.GetUefiAllVarNames()
@@ -87,19 +100,20 @@ def main():
             int_format = "<I"
             int_size = struct.calcsize(int_format)
             while offset < len(efi_var_names):
-                (next_offset,) = struct.unpack_from(int_format, efi_var_names[offset:])
+                (next_offset,) = struct.unpack_from(int_format, efi_var_names, offset)
                 if next_offset == 0:
                     # This is the end... But we still need to go through the last loop
                     next_offset = len(efi_var_names) - offset
                 namespace = uuid.UUID(bytes_le=efi_var_names[offset + int_size: offset + int_size + UUID_BYTES_SIZE])
                 name = efi_var_names[offset + int_size + UUID_BYTES_SIZE: offset + next_offset].decode('utf16')
-                ret += read_variable_into_variable_list(UefiVar, name, namespace)
+                variables.append((name, namespace))
                 offset += next_offset
         else:
             # Read the variables for each config knobs
             schema = Schema.load(arguments.configuration_file)
-            for knob in schema.knobs:
-                ret += read_variable_into_variable_list(UefiVar, knob.name, knob.namespace)
+            variables = [(knob.name, knob.namespace) for knob in schema.knobs]
+
+        ret = read_variables_into_variable_list(UefiVar, variables, progress)
 
         if len(ret) != 0:
             file.write(ret)
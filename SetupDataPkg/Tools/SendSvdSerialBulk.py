@@ -0,0 +1,163 @@
+# @file
+#
+# Send a SVD to ConfApp over the serial port as a single bulk transfer frame
+#
+# Copyright (c), Microsoft Corporation
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+
+##
+##
+## Select "Update from Serial Port" in ConfApp, close the serial terminal, then run this script against the same port.
+## It starts the transfer with Ctrl-B, waits for ConfApp to take the port over from its terminal and reports whether
+## the settings were applied. Needs pyserial.
+##
+
+import os
+import sys
+import time
+import zlib
+import struct
+import logging
+import argparse
+
+SVD_SERIAL_BULK_START = b"\x02"  # Ctrl-B
+SVD_SERIAL_BULK_SIGNATURE = b"SVDB"
+SVD_SERIAL_BULK_READY = b"SVDR"
+SVD_SERIAL_BULK_ACK = b"SVDA"
+SVD_SERIAL_BULK_NAK = b"SVDN"
+SVD_SERIAL_BULK_MAX_SIZE = 16 * 1024 * 1024
+
+# Signature and payload size, matching SVD_SERIAL_BULK_HEADER
+SVD_SERIAL_BULK_HEADER = struct.Struct("<4sI")
+SVD_SERIAL_BULK_CRC = struct.Struct("<I")
+
+
+def build_frame(payload):
+    if len(payload) == 0 or len(payload) > SVD_SERIAL_BULK_MAX_SIZE:
+        raise ValueError("Payload size %d is out of range" % len(payload))
+
+    return (
+        SVD_SERIAL_BULK_HEADER.pack(SVD_SERIAL_BULK_SIGNATURE, len(payload))
+        + payload
+        + SVD_SERIAL_BULK_CRC.pack(zlib.crc32(payload))
+    )
+
+
+#
+# Read from the port until one of codes shows up, skipping whatever the console prints before it
+#
+def wait_for_code(port, codes, timeout):
+    received = b""
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        received += port.read(1)
+        for code in codes:
+            if received.endswith(code):
+                return code
+        received = received[-4:]
+
+    raise TimeoutError("ConfApp did not answer within %d seconds" % timeout)
+
+
+def send_svd(port, payload, ready_timeout, result_timeout):
+    frame = build_frame(payload)
+
+    port.reset_input_buffer()
+    port.write(SVD_SERIAL_BULK_START)
+
+    # Anything sent before this would be taken by the terminal driver as keystrokes
+    wait_for_code(port, [SVD_SERIAL_BULK_READY], ready_timeout)
+    logging.info("ConfApp is ready, sending %d bytes" % len(payload))
+
+    port.write(frame)
+    port.flush()
+
+    return wait_for_code(port, [SVD_SERIAL_BULK_ACK, SVD_SERIAL_BULK_NAK], result_timeout) == SVD_SERIAL_BULK_ACK
+
+
+# Setup import and argument parser
+def path_parse():
+
+    parser = argparse.ArgumentParser()
+
+    parser.add_argument(
+        "-i",
+        "--InputSVDFile",
+        dest="InputSVDFile",
+        required=True,
+        type=str,
+        help="""Specify the path to the XML SVD or binary settings packet to send.""",
+    )
+    parser.add_argument(
+        "-p",
+        "--Port",
+        dest="Port",
+        required=True,
+        type=str,
+        help="""Specify the serial port ConfApp reads its console input from, e.g. COM3 or /dev/ttyUSB0.""",
+    )
+    parser.add_argument(
+        "-b",
+        "--BaudRate",
+        dest="BaudRate",
+        type=int,
+        default=115200,
+        help="""Specify the baud rate of the serial port.""",
+    )
+    parser.add_argument(
+        "-t",
+        "--Timeout",
+        dest="Timeout",
+        type=int,
+        default=60,
+        help="""Specify the seconds to wait for ConfApp to apply the settings.""",
+    )
+
+    Paths = parser.parse_args()
+
+    if not os.path.isfile(Paths.InputSVDFile):
+        raise Exception("Invalid input file %s" % Paths.InputSVDFile)
+
+    return Paths
+
+
+#
+# main script function
+#
+def main():
+
+    Paths = path_parse()
+
+    import serial
+
+    with open(Paths.InputSVDFile, "rb") as file:
+        payload = file.read()
+
+    # Short reads so that the waits check their deadline
+    with serial.Serial(Paths.Port, Paths.BaudRate, timeout=0.1) as port:
+        if not send_svd(port, payload, 10, Paths.Timeout):
+            logging.error("ConfApp rejected the settings")
+            return 1
+
+    logging.info("Settings applied, the system is rebooting")
+    return 0
+
+
+if __name__ == "__main__":
+    # setup main console as logger
+    logger = logging.getLogger("")
+    logger.setLevel(logging.DEBUG)
+    formatter = logging.Formatter("%(levelname)s - %(message)s")
+    console = logging.StreamHandler()
+    console.setLevel(logging.INFO)
+    console.setFormatter(formatter)
+    logger.addHandler(console)
+
+    # call main worker function
+    retcode = main()
+
+    if retcode != 0:
+        logging.critical("Failed.  Return Code: %i" % retcode)
+    # end logging
+    logging.shutdown()
+    sys.exit(retcode)
@@ -0,0 +1,255 @@
+# @file
+#
+# Support to build and sign a batch of DFCI packets, e.g. one packet per device serial number
+#
+# Copyright (c), Microsoft Corporation
+# SPDX-License-Identifier: BSD-2-Clause-Patent
+##
+
+##
+## A batch is described by a manifest CSV with one packet per row. The columns are named after
+## the options of the packet script they override for that packet, e.g.
+##
+##   XmlFilePath,FinalizeResultFile,SMBIOSSerial
+##   Settings.xml,Out/Device1.bin,SN0001
+##   Settings.xml,Out/Device2.bin,SN0002
+##
+## Relative paths are relative to the manifest and empty cells keep the value of the option.
+##
+## The packets are split in chunks that are built by a pool of worker processes. A worker signs
+## all the packets of its chunk with a single signtool invocation, so the PFX is loaded once per
+## chunk rather than once per packet.
+##
+
+import os
+import csv
+import math
+import time
+import random
+import logging
+import argparse
+from concurrent.futures import ProcessPoolExecutor
+
+from edk2toollib.utility_functions import RunCmd
+
+# Most packets signed by one signtool invocation, to keep its command line well within limits
+MAX_SIGN_CHUNK_SIZE = 64
+
+# Manifest columns holding paths, resolved relative to the manifest
+PATH_COLUMNS = ("XmlFilePath", "FinalizeResultFile")
+
+
+#
+# Read a packet manifest
+# return the list of the options of each packet, a copy of options with the columns of its row
+#
+def LoadPacketManifest(manifest_file, columns, options):
+    packets = []
+    manifest_dir = os.path.dirname(os.path.abspath(manifest_file))
+
+    with open(manifest_file, "r", newline="") as csv_file:
+        reader = csv.DictReader(csv_file)
+        fieldnames = reader.fieldnames or []
+        for column in PATH_COLUMNS:
+            if column not in fieldnames:
+                raise Exception(f"Manifest {manifest_file} has no {column} column")
+
+        for column in fieldnames:
+            if column not in columns:
+                raise Exception(f"Manifest {manifest_file} has unsupported column {column}")
+
+        for row in reader:
+            values = {column: value.strip() for (column, value) in row.items() if value and value.strip()}
+            if len(values) == 0:
+                continue
+
+            packet = argparse.Namespace(**vars(options))
+            for (column, value) in values.items():
+                if column in PATH_COLUMNS and not os.path.isabs(value):
+                    value = os.path.join(manifest_dir, value)
+                setattr(packet, column, value)
+
+            if not getattr(packet, "FinalizeResultFile", None):
+                raise Exception(f"Manifest {manifest_file} line {reader.line_num} has no FinalizeResultFile")
+
+            packets.append(packet)
+
+    return packets
+
+
+#
+# Sign a list of files with a single signtool invocation, with the same parameters as
+# DetachedSignWithSignTool. The detached signature of each file is written to output_dir
+# as the file name with a .p7 extension, so the file names must be unique
+#
+def DetachedSignFilesWithSignTool(signtool_path, files, output_dir, pfx_file, pfx_password, oid):
+    params = [
+        "sign",
+        "/fd sha256",
+        "/p7ce DetachedSignedData",
+        "/p7co " + oid,
+        '/p7 "' + output_dir + '"',
+        '/f "' + pfx_file + '"',
+    ]
+    if pfx_password is not None:
+        params.append("/p " + pfx_password)
+    params.append("/debug /v")
+    params.extend('"' + file + '"' for file in files)
+
+    ret = RunCmd(signtool_path, " ".join(params))
+    if ret != 0:
+        logging.error("Signtool failed to sign %d files: %d" % (len(files), ret))
+    return ret
+
+
+#
+# The result of a packet of a batch, with the seconds spent in each step on it. The signing
+# time of a chunk is shared evenly by its packets
+#
+class PacketResult(object):
+    def __init__(self, output_file):
+        self.OutputFile = output_file
+        self.Error = None
+        self.PrepSeconds = 0.0
+        self.SignSeconds = 0.0
+        self.FinalizeSeconds = 0.0
+
+
+#
+# A batch of packets built by the prep and finalize functions of a packet script, which must be
+# module level functions so they can be handed to the worker processes:
+#   prep(packet_options, output_file) returns 0 once the unsigned packet is written
+#   finalize(input_file, signature_file, output_file) writes the signed packet
+#
+class PacketBatch(object):
+    def __init__(self, prep, finalize, signtool_path, pfx_file, pfx_password, oid, tempdir):
+        self.Prep = prep
+        self.Finalize = finalize
+        self.SignToolPath = signtool_path
+        self.PfxFile = pfx_file
+        self.PfxPassword = pfx_password
+        self.Oid = oid
+        self.TempDir = os.path.abspath(tempdir)
+
+    def _BuildChunk(self, first, packets):
+        chunk_dir = os.path.join(self.TempDir, "Chunk%d" % first)
+        os.makedirs(chunk_dir)
+
+        results = [PacketResult(packet.FinalizeResultFile) for packet in packets]
+        to_sign = []
+        for (offset, packet) in enumerate(packets):
+            start = time.perf_counter()
+            payload_file = os.path.join(chunk_dir, "Packet%d.bin" % (first + offset))
+            try:
+                ret = self.Prep(packet, payload_file)
+                if ret != 0:
+                    results[offset].Error = "Prep failed: %d" % ret
+                else:
+                    to_sign.append((offset, payload_file))
+            except Exception as e:
+                results[offset].Error = "Prep failed: %s" % e
+            results[offset].PrepSeconds = time.perf_counter() - start
+
+        if len(to_sign) == 0:
+            return results
+
+        start = time.perf_counter()
+        ret = DetachedSignFilesWithSignTool(
+            self.SignToolPath,
+            [payload_file for (_, payload_file) in to_sign],
+            chunk_dir,
+            self.PfxFile,
+            self.PfxPassword,
+            self.Oid,
+        )
+        sign_seconds = (time.perf_counter() - start) / len(to_sign)
+
+        for (offset, payload_file) in to_sign:
+            results[offset].SignSeconds = sign_seconds
+            if ret != 0:
+                results[offset].Error = "Signing failed: %d" % ret
+                continue
+
+            start = time.perf_counter()
+            try:
+                os.makedirs(os.path.dirname(os.path.abspath(packets[offset].FinalizeResultFile)), exist_ok=True)
+                self.Finalize(payload_file, payload_file + ".p7", packets[offset].FinalizeResultFile)
+            except Exception as e:
+                results[offset].Error = "Finalize failed: %s" % e
+            results[offset].FinalizeSeconds = time.perf_counter() - start
+
+        return results
+
+    #
+    # Build and sign the packets, max_workers chunks at a time
+    # return the list of the PacketResult of each packet, in the order of the packets
+    #
+    def Build(self, packets, max_workers=None):
+        if max_workers is None:
+            max_workers = os.cpu_count() or 1
+
+        chunk_size = min(MAX_SIGN_CHUNK_SIZE, max(1, math.ceil(len(packets) / max_workers)))
+        firsts = list(range(0, len(packets), chunk_size))
+        chunks = [packets[first:first + chunk_size] for first in firsts]
+
+        if len(chunks) <= 1:
+            return [result for (first, chunk) in zip(firsts, chunks) for result in self._BuildChunk(first, chunk)]
+
+        with ProcessPoolExecutor(max_workers=max_workers, initializer=_InitBatchWorker, initargs=(self,)) as executor:
+            return [result for results in executor.map(_BuildBatchChunk, firsts, chunks) for result in results]
+
+
+# The batch of a worker process
+_batch = None
+
+
+def _InitBatchWorker(batch):
+    global _batch
+    _batch = batch
+    # forked workers would otherwise draw the same session ids
+    random.seed()
+
+
+def _BuildBatchChunk(first, packets):
+    return _batch._BuildChunk(first, packets)
+
+
+#
+# Log the timing of a batch, and write the result of each packet to summary_file if given
+# return the count of the packets that failed
+#
+def WriteBatchSummary(results, elapsed_seconds, summary_file=None):
+    failed = [result for result in results if result.Error is not None]
+    for result in failed:
+        logging.critical("Failed to build %s: %s" % (result.OutputFile, result.Error))
+
+    logging.critical(
+        "Built %d of %d packets in %.2fs (%.1f packets/s)" % (
+            len(results) - len(failed),
+            len(results),
+            elapsed_seconds,
+            len(results) / elapsed_seconds if elapsed_seconds > 0 else 0,
+        )
+    )
+    logging.critical(
+        "Worker time: prep %.2fs, sign %.2fs, finalize %.2fs" % (
+            sum(result.PrepSeconds for result in results),
+            sum(result.SignSeconds for result in results),
+            sum(result.FinalizeSeconds for result in results),
+        )
+    )
+
+    if summary_file:
+        with open(summary_file, "w", newline="") as csv_file:
+            writer = csv.writer(csv_file)
+            writer.writerow(["FinalizeResultFile", "PrepSeconds", "SignSeconds", "FinalizeSeconds", "Error"])
+            for result in results:
+                writer.writerow([
+                    result.OutputFile,
+                    "%.4f" % result.PrepSeconds,
+                    "%.4f" % result.SignSeconds,
+                    "%.4f" % result.FinalizeSeconds,
+                    result.Error or "",
+                ])
+
+    return len(failed)
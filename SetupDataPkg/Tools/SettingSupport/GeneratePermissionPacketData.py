@@ -39,6 +39,7 @@ sp = os.path.dirname(os.path.realpath(sys.argv[0]))
 # setup python path for build modules
 sys.path.append(sp)
 
+from BatchPacketSupport import PacketBatch, LoadPacketManifest, WriteBatchSummary  # noqa: E402
 from DFCI_SupportLib import DFCI_SupportLib                         # noqa: E402
 from edk2toollib.uefi.wincert import WinCertUefiGuid                # noqa: E402
 from edk2toollib.utility_functions import DetachedSignWithSignTool  # noqa: E402
@@ -50,6 +51,17 @@ from Data.PermissionPacketVariable import PermissionResultVariable  # noqa: E402
 gOid = "1.2.840.113549.1.7.2"
 gPath2SignTool = None
 
+# Options a batch manifest can set for each packet
+gBatchManifestColumns = (
+    "XmlFilePath",
+    "FinalizeResultFile",
+    "HdrVersion",
+    "SnTarget",
+    "SMBIOSMfg",
+    "SMBIOSProd",
+    "SMBIOSSerial",
+)
+
 
 def PrintSEM(filepath):
     if filepath and os.path.isfile(filepath):
@@ -94,6 +106,90 @@ def SignSEMData(options):
     )
 
 
+#
+# Build the unsigned packet of Step1 to output_file
+#
+def PrepSEMData(options, output_file):
+    SEM = PermissionApplyVariable(None, int(options.HdrVersion))
+
+    if int(options.HdrVersion) == PermissionApplyVariable.VERSION_V1:
+        SEM.SNTarget = int(options.SnTarget)
+    elif int(options.HdrVersion) == PermissionApplyVariable.VERSION_V2:
+        if options.SMBIOSMfg is None:
+            SEM.Manufacturer = "OEMSH"
+        else:
+            SEM.Manufacturer = options.SMBIOSMfg
+
+        if options.SMBIOSProd is None:
+            SEM.ProductName = "OEMSH Product"
+        else:
+            SEM.ProductName = options.SMBIOSProd
+
+        if options.SMBIOSSerial is None:
+            SEM.SerialNumber = "789789789"
+        else:
+            SEM.SerialNumber = options.SMBIOSSerial
+    else:
+        logging.critical("Invalid header version specified")
+        return -31
+
+    a = open(options.XmlFilePath, "r")
+    SEM.AddXmlPayload(a.read())
+    a.close()
+
+    of = open(output_file, "wb")
+    SEM.Write(of)
+    of.close()
+    return 0
+
+
+#
+# Build the signed packet of Step3 to output_file, from the packet of Step1 and its detached signature
+#
+def FinalizeSEMData(input_file, signature_file, output_file):
+    sstep1file = open(input_file, "rb")
+    SEM = PermissionApplyVariable(sstep1file)
+    sstep1file.close()
+    SEM.Signature = WinCertUefiGuid()
+    detached = open(signature_file, "rb")
+    SEM.Signature.AddCertData(detached)
+    detached.close()
+    SEM.SessionId = random.randint(0, 4294967295)  # generate a random session id
+
+    of = open(output_file, "wb")
+    SEM.Write(of)
+    of.close()
+
+
+#
+# Build and sign each packet of the batch manifest with a pool of workers
+#
+def BuildSEMBatch(options, tempdir):
+    global gPath2SignTool
+    if gPath2SignTool is None:
+        a = DFCI_SupportLib()
+        gPath2SignTool = a.get_signtool_path()
+
+    packets = LoadPacketManifest(options.BatchManifest, gBatchManifestColumns, options)
+    logging.critical("Batch of %d packets Started" % len(packets))
+
+    start = time.perf_counter()
+    batch = PacketBatch(
+        PrepSEMData,
+        FinalizeSEMData,
+        gPath2SignTool,
+        options.SigningPfxFile,
+        options.SigningPfxPw,
+        gOid,
+        tempdir,
+    )
+    results = batch.Build(packets, options.BatchJobs)
+
+    if WriteBatchSummary(results, time.perf_counter() - start, options.BatchSummaryFile) != 0:
+        return -41
+    return 0
+
+
 #
 # main script function
 #
@@ -250,6 +346,31 @@ def main():
         default=None,
     )
 
+    BatchGroup = parser.add_argument_group(
+        title="Batch",
+        description="Build and sign a packet for each row of a manifest CSV, with columns named after "
+        "the Step1 options and FinalizeResultFile.  Uses the Step2 signing options.",
+    )
+    BatchGroup.add_argument(
+        "--BatchManifest",
+        dest="BatchManifest",
+        help="Manifest CSV of the packets to build",
+        default=None,
+    )
+    BatchGroup.add_argument(
+        "--BatchJobs",
+        dest="BatchJobs",
+        help="Number of packet chunks built in parallel, the processor count by default",
+        type=int,
+        default=None,
+    )
+    BatchGroup.add_argument(
+        "--BatchSummaryFile",
+        dest="BatchSummaryFile",
+        help="Optional CSV for the result and timing of each packet of the batch",
+        default=None,
+    )
+
     # Turn on debug level logging
     parser.add_argument(
         "--debug",
@@ -281,6 +402,21 @@ def main():
         + datetime.datetime.strftime(datetime.datetime.now(), "%A, %B %d, %Y %I:%M%p")
     )
 
+    # Batch
+    if options.BatchManifest:
+        logging.debug("Batch Enabled")
+        if not os.path.isfile(options.BatchManifest):
+            logging.critical("For Batch there must be a valid manifest file")
+            return -40
+
+        if not options.SigningPfxFile:
+            logging.critical("For Batch you must supply a path to a PFX file for signing")
+            return -10
+
+        if options.Step1Enable or options.Step2Enable or options.Step3Enable:
+            logging.critical("Batch can't be combined with the steps")
+            return -42
+
     # Step 1 Prep
     if options.Step1Enable:
         logging.debug("Step 1 Enabled")
@@ -379,40 +515,20 @@ def main():
     logging.critical("Temp directory is: " + os.path.join(os.getcwd(), tempdir))
     os.makedirs(tempdir)
 
+    # BATCH - All steps for each packet of the manifest
+    if options.BatchManifest:
+        ret = BuildSEMBatch(options, tempdir)
+        if not options.dirty:
+            shutil.rmtree(tempdir)
+        return ret
+
     # STEP 1 - Prep Var
     if options.Step1Enable:
         logging.critical("Step1 Started")
         Step1OutFile = os.path.join(tempdir, "Step1Out.bin")
-        SEM = PermissionApplyVariable(None, int(options.HdrVersion))
-
-        if int(options.HdrVersion) == PermissionApplyVariable.VERSION_V1:
-            SEM.SNTarget = int(options.SnTarget)
-        elif int(options.HdrVersion) == PermissionApplyVariable.VERSION_V2:
-            if options.SMBIOSMfg is None:
-                SEM.Manufacturer = "OEMSH"
-            else:
-                SEM.Manufacturer = options.SMBIOSMfg
-
-            if options.SMBIOSProd is None:
-                SEM.ProductName = "OEMSH Product"
-            else:
-                SEM.ProductName = options.SMBIOSProd
-
-            if options.SMBIOSSerial is None:
-                SEM.SerialNumber = "789789789"
-            else:
-                SEM.SerialNumber = options.SMBIOSSerial
-        else:
-            logging.critical("Invalid header version specified")
-            return -31
-
-        a = open(options.XmlFilePath, "r")
-        SEM.AddXmlPayload(a.read())
-        a.close()
-
-        of = open(Step1OutFile, "wb")
-        SEM.Write(of)
-        of.close()
+        ret = PrepSEMData(options, Step1OutFile)
+        if ret != 0:
+            return ret
 
         # if user requested a step1 output file copy the temp file
         if options.PrepResultFile:
@@ -446,21 +562,14 @@ def main():
     # STEP 3 - Write Signature Structure and complete file
     if options.Step3Enable:
         logging.critical("Step3 Started")
-        sstep1file = open(options.FinalizeInputFile, "rb")
-        SEM = PermissionApplyVariable(sstep1file)
-        sstep1file.close()
-        SEM.Signature = WinCertUefiGuid()
-        detached = open(options.FinalizeInputDetachedSignatureFile, "rb")
-        SEM.Signature.AddCertData(detached)
-        detached.close()
-        SEM.SessionId = random.randint(0, 4294967295)  # generate a random session id
-
         if not options.FinalizeResultFile:
             options.FinalizeResultFile = os.path.join(tempdir, "Step3Out.bin")
 
-        of = open(options.FinalizeResultFile, "wb")
-        SEM.Write(of)
-        of.close()
+        FinalizeSEMData(
+            options.FinalizeInputFile,
+            options.FinalizeInputDetachedSignatureFile,
+            options.FinalizeResultFile,
+        )
 
     #
     # Function to print SEM
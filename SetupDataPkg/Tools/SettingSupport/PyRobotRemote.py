@@ -18,11 +18,12 @@ import win32security
 import winnt
 
 from Lib.UefiVariablesSupportLib import UefiVariable
+from Lib.VariableList import read_vlist_from_buffer
 
 
 # update this whenever you make a change
-RobotRemoteChangeDate = "2020-10-02 09:30"
-RobotRemoteVersion = 1.05
+RobotRemoteChangeDate = "2026-10-14 10:00"
+RobotRemoteVersion = 1.06
 
 
 class UefiRemoteTesting(object):
@@ -34,6 +35,16 @@ class UefiRemoteTesting(object):
     def __init__(self):
         self.filepath = None
         self.lines = []
+        self.uefi_var = None
+
+    #
+    # The UefiVariable shared by every variable keyword, so that the privilege and firmware
+    # variable API setup is only done once
+    #
+    def _GetUefiVariableLib(self):
+        if self.uefi_var is None:
+            self.uefi_var = UefiVariable()
+        return self.uefi_var
 
     def Run_Command_And_Return_Output(self, cmdline):
         cmd = shlex.split(cmdline)
@@ -53,7 +64,7 @@ class UefiRemoteTesting(object):
     # confuse Python, so get rid of the NULL when it is expected
     #
     def GetUefiVariable(self, name, guid, trim):
-        UefiVar = UefiVariable()
+        UefiVar = self._GetUefiVariableLib()
         logging.info("Calling GetUefiVar(name='%s', GUID='%s')" % (name, "{%s}" % guid))
         (rc, var, error_string) = UefiVar.GetUefiVar(name, guid)
         var2 = var
@@ -64,10 +75,68 @@ class UefiRemoteTesting(object):
         return (rc, var2, error_string)
 
     def SetUefiVariable(self, name, guid, attrs=None, contents=None):
-        UefiVar = UefiVariable()
+        UefiVar = self._GetUefiVariableLib()
         (rc, err, error_string) = UefiVar.SetUefiVar(name, guid, contents, attrs)
         return rc
 
+    #
+    # Batched variable keywords, reading or writing a whole list of variables in a single call
+    # Each returns a tuple of the list of results in the order of the variables, each followed by
+    # the seconds spent on the variable, and a summary of the batch
+    #
+
+    #
+    # Get a list of [name, guid] variables
+    # return the list of [rc, data, seconds] of each variable, the data trimmed as by GetUefiVariable
+    #
+    def GetUefiVariables(self, variables, trim=None):
+        UefiVar = self._GetUefiVariableLib()
+        (results, stats) = UefiVar.GetUefiVars((name, guid) for (name, guid) in variables)
+        values = []
+        for ((rc, var), seconds) in zip(results, stats.timings):
+            if (trim == 'trim') and (len(var) > 1):
+                var = var[0: len(var) - 1]
+            values.append([rc, var, seconds])
+        logging.info("GetUefiVariables: %s" % stats)
+        return (values, str(stats))
+
+    #
+    # Set a list of [name, guid, attrs, contents] variables, with the same meaning as the
+    # SetUefiVariable parameters. When skip_unchanged is set, variables already holding the
+    # contents are not written
+    # return the list of [rc, error code, seconds] of each variable, rc as returned by SetUefiVariable
+    #
+    def SetUefiVariables(self, variables, skip_unchanged=False):
+        UefiVar = self._GetUefiVariableLib()
+        (results, stats) = UefiVar.SetUefiVars(
+            ((name, guid, contents, attrs) for (name, guid, attrs, contents) in variables),
+            skip_unchanged=skip_unchanged,
+        )
+        logging.info("SetUefiVariables: %s" % stats)
+        return ([[rc, err, seconds] for ((rc, err, _), seconds) in zip(results, stats.timings)], str(stats))
+
+    #
+    # Read every variable of a variable list (.vl) buffer from the system, e.g. to verify a
+    # previous SetUefiVariableList
+    # return the list of [name, guid, rc, data, seconds] of each variable of the list
+    #
+    def GetUefiVariableList(self, vlist):
+        variables = read_vlist_from_buffer(vlist)
+        (results, summary) = self.GetUefiVariables([(var.name, str(var.guid)) for var in variables])
+        return ([[var.name, str(var.guid)] + result for (var, result) in zip(variables, results)], summary)
+
+    #
+    # Write every variable of a variable list (.vl) buffer to the system, with its attributes
+    # return the list of [name, guid, rc, error code, seconds] of each variable of the list
+    #
+    def SetUefiVariableList(self, vlist, skip_unchanged=False):
+        variables = read_vlist_from_buffer(vlist)
+        (results, summary) = self.SetUefiVariables(
+            [(var.name, str(var.guid), var.attributes, var.data) for var in variables],
+            skip_unchanged,
+        )
+        return ([[var.name, str(var.guid)] + result for (var, result) in zip(variables, results)], summary)
+
     def remote_ack(self):
         return True
 
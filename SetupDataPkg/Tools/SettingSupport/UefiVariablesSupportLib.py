@@ -13,10 +13,14 @@ from ctypes import (
     c_char,
     create_string_buffer,
     WinError,
-    pointer
+    pointer,
+    byref,
+    POINTER
 )
 from ctypes.wintypes import DWORD
 import logging
+import sys
+import time
 from win32 import win32api
 from win32 import win32process
 from win32 import win32security
@@ -25,10 +29,46 @@ kernel32 = windll.kernel32
 EFI_VAR_MAX_BUFFER_SIZE = 1024 * 1024
 
 
+#
+# Counters of a batch of variable reads or writes, and the time spent in it and on each variable,
+# in the order of the variables
+#
+class UefiVariableBatchStats(object):
+    def __init__(self):
+        self.read = 0
+        self.written = 0
+        self.skipped = 0
+        self.not_found = 0
+        self.failed = 0
+        self.elapsed = 0.0
+        self.timings = []
+
+    def __str__(self):
+        count = self.read + self.written + self.skipped + self.not_found + self.failed
+        return "%d variables in %.3f s: %d read, %d written, %d unchanged, %d not found, %d failed" % (
+            count, self.elapsed, self.read, self.written, self.skipped, self.not_found, self.failed
+        )
+
+
+#
+# Progress callback of the batched variable functions, printing the variable count on a single console line
+#
+def print_batch_progress(index, count, name):
+    sys.stdout.write("\r%d/%d %s\033[K" % (index, count, name))
+    if index == count:
+        sys.stdout.write("\n")
+    sys.stdout.flush()
+
+
 class UefiVariable(object):
     ERROR_ENVVAR_NOT_FOUND = 0xcb
 
     def __init__(self):
+        # the read buffer is allocated on the first read, and then reused by every read
+        self._read_buffer = None
+        self._read_attributes = DWORD(0)
+        self._GetFirmwareEnvironmentVariableEx = None
+
         # enable required SeSystemEnvironmentPrivilege privilege
         privilege = win32security.LookupPrivilegeValue(
             None, "SeSystemEnvironmentPrivilege"
@@ -84,6 +124,17 @@ class UefiVariable(object):
                 c_int,
                 c_int,
             ]
+            self._GetFirmwareEnvironmentVariableEx = (
+                kernel32.GetFirmwareEnvironmentVariableExW
+            )
+            self._GetFirmwareEnvironmentVariableEx.restype = c_int
+            self._GetFirmwareEnvironmentVariableEx.argtypes = [
+                c_wchar_p,
+                c_wchar_p,
+                c_void_p,
+                c_int,
+                POINTER(DWORD),
+            ]
         except:
             logging.warn(
                 "G[S]etFirmwareEnvironmentVariableW function doesn't seem to exist"
@@ -112,31 +163,74 @@ class UefiVariable(object):
         raise TypeError(init)
 
     #
-    # Function to get variable
-    # return a tuple of error code and variable data as string
+    # Helper function to read a variable into the shared read buffer. The attributes are read
+    # into self._read_attributes when with_attributes is set
+    # return a tuple of error code and a copy of the variable data
     #
-    def GetUefiVar(self, name, guid):
+    def _ReadUefiVar(self, name, guid_string, with_attributes=False):
         # success
         err = 0
-        efi_var = create_string_buffer(EFI_VAR_MAX_BUFFER_SIZE)
-        if self._GetFirmwareEnvironmentVariable is not None:
-            logging.info(
-                "calling GetFirmwareEnvironmentVariable( name='%s', GUID='%s' ).."
-                % (name, "{%s}" % guid)
+        length = 0
+        if self._read_buffer is None:
+            self._read_buffer = create_string_buffer(EFI_VAR_MAX_BUFFER_SIZE)
+        efi_var = self._read_buffer
+        if with_attributes and self._GetFirmwareEnvironmentVariableEx is not None:
+            length = self._GetFirmwareEnvironmentVariableEx(
+                name, guid_string, efi_var, EFI_VAR_MAX_BUFFER_SIZE, byref(self._read_attributes)
             )
+        elif self._GetFirmwareEnvironmentVariable is not None:
             length = self._GetFirmwareEnvironmentVariable(
-                name, "{%s}" % guid, efi_var, EFI_VAR_MAX_BUFFER_SIZE
+                name, guid_string, efi_var, EFI_VAR_MAX_BUFFER_SIZE
             )
-        if (0 == length) or (efi_var is None):
+        if 0 == length:
             err = kernel32.GetLastError()
             if err != 0 and err != UefiVariable.ERROR_ENVVAR_NOT_FOUND:
                 logging.error(
                     "GetFirmwareEnvironmentVariable[Ex] failed (GetLastError = 0x%x)" % err
                 )
-                logging.error(WinError())
-            if efi_var is None:
-                return (err, None, WinError(err))
-        return (err, efi_var[:length], WinError(err))
+                logging.error(WinError(err))
+        return (err, efi_var[:length])
+
+    #
+    # Function to get variable
+    # return a tuple of error code and variable data as string
+    #
+    def GetUefiVar(self, name, guid):
+        logging.info(
+            "calling GetFirmwareEnvironmentVariable( name='%s', GUID='%s' ).."
+            % (name, "{%s}" % guid)
+        )
+        (err, data) = self._ReadUefiVar(name, "{%s}" % guid)
+        return (err, data, WinError(err))
+
+    #
+    # Function to get a batch of variables, given as an iterable of (name, guid). The read buffer
+    # is shared by every read, and progress is an optional callable(index, count, name) called
+    # after each variable
+    # return a tuple of the list of (error code, variable data) in the order of the variables,
+    # and the UefiVariableBatchStats of the batch
+    #
+    def GetUefiVars(self, variables, progress=None):
+        variables = list(variables)
+        stats = UefiVariableBatchStats()
+        results = []
+        start = time.perf_counter()
+        for index, (name, guid) in enumerate(variables):
+            variable_start = time.perf_counter()
+            logging.debug("Reading variable (name='%s', Guid='{%s}')" % (name, guid))
+            (err, data) = self._ReadUefiVar(name, "{%s}" % guid)
+            if err == 0:
+                stats.read += 1
+            elif err == UefiVariable.ERROR_ENVVAR_NOT_FOUND:
+                stats.not_found += 1
+            else:
+                stats.failed += 1
+            results.append((err, data))
+            stats.timings.append(time.perf_counter() - variable_start)
+            if progress is not None:
+                progress(index + 1, len(variables), name)
+        stats.elapsed = time.perf_counter() - start
+        return (results, stats)
 
     #
     # Function to get all variable names
@@ -223,3 +317,49 @@ class UefiVariable(object):
             logging.error(WinError())
             error_string = WinError(err)
         return (success, err, error_string)
+
+    #
+    # Helper function to check whether a variable already holds the given data, and the given
+    # attributes if any. A variable that does not exist matches empty data, as writing it is a delete
+    #
+    def _IsUefiVarUnchanged(self, name, guid_string, var, attrs):
+        (err, current) = self._ReadUefiVar(name, guid_string, attrs is not None)
+        if err == UefiVariable.ERROR_ENVVAR_NOT_FOUND:
+            return len(var) == 0
+        if err != 0 or current != bytes(var):
+            return False
+        if attrs is not None and self._GetFirmwareEnvironmentVariableEx is not None:
+            return self._read_attributes.value == int(attrs)
+        return True
+
+    #
+    # Function to set a batch of variables, given as an iterable of (name, guid, var, attrs) with the
+    # same meaning as the SetUefiVar parameters. When skip_unchanged is set, each variable is read
+    # first and only written if its current data or attributes differ. progress is an optional
+    # callable(index, count, name) called after each variable
+    # return a tuple of the list of SetUefiVar results in the order of the variables, a skipped
+    # variable reporting success, and the UefiVariableBatchStats of the batch
+    #
+    def SetUefiVars(self, variables, skip_unchanged=False, progress=None):
+        variables = list(variables)
+        stats = UefiVariableBatchStats()
+        results = []
+        start = time.perf_counter()
+        for index, (name, guid, var, attrs) in enumerate(variables):
+            variable_start = time.perf_counter()
+            if skip_unchanged and self._IsUefiVarUnchanged(name, "{%s}" % guid, var or bytes(0), attrs):
+                logging.debug("Skipping unchanged variable (name='%s', Guid='{%s}')" % (name, guid))
+                stats.skipped += 1
+                results.append((1, 0, None))
+            else:
+                result = self.SetUefiVar(name, guid, var, attrs)
+                if result[0] == 0:
+                    stats.failed += 1
+                else:
+                    stats.written += 1
+                results.append(result)
+            stats.timings.append(time.perf_counter() - variable_start)
+            if progress is not None:
+                progress(index + 1, len(variables), name)
+        stats.elapsed = time.perf_counter() - start
+        return (results, stats)
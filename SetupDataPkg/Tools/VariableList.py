@@ -6,14 +6,22 @@
 
 import sys
 import re
+import base64
 import struct
 import csv
 from collections import OrderedDict
 import uuid
 import zlib
 import copy
+import itertools
 import os
-from xml.dom.minidom import parse, parseString
+import mmap
+import pickle
+import hashlib
+import hmac
+import tempfile
+from concurrent.futures import ProcessPoolExecutor
+from xml.dom.minidom import parseString
 from enum import Enum
 
 
@@ -125,8 +133,46 @@ class DataFormat:
         self.c_type = c_type
         self.min = None
         self.max = None
+        self._binary_struct = None
         pass
 
+    # The binary layout of this format as a single compiled struct.Struct, covering any nested structs
+    # and arrays. It is compiled on first use, as struct members are added after the format is created
+    @property
+    def binary_struct(self):
+        if self._binary_struct is None:
+            self._binary_struct = struct.Struct("<" + self.pack_codes())
+        return self._binary_struct
+
+    # Returns the struct module format characters of each value in the flattened layout of this format
+    def pack_codes(self):
+        raise NotImplementedError
+
+    # Append the values of the flattened layout of an object to a list, in binary order
+    def flatten(self, object_representation, values):
+        values.append(object_representation)
+
+    # Rebuild an object from an iterator over the values of its flattened layout
+    def unflatten(self, values):
+        return next(values)
+
+    def object_to_binary(self, object_representation):
+        values = []
+        self.flatten(object_representation, values)
+        return self.binary_struct.pack(*values)
+
+    # Write the binary representation of an object into a writable buffer at the given offset
+    def pack_into(self, buffer, offset, object_representation):
+        values = []
+        self.flatten(object_representation, values)
+        self.binary_struct.pack_into(buffer, offset, *values)
+
+    def binary_to_object(self, binary_representation):
+        return self.unflatten(iter(self.binary_struct.unpack_from(binary_representation)))
+
+    def size_in_bytes(self):
+        return self.binary_struct.size
+
 
 # Represents all data types that have an object representation as a
 # Python int
@@ -164,14 +210,8 @@ class IntValueFormat(DataFormat):
         else:
             return str(object_representation)
 
-    def object_to_binary(self, object_representation):
-        return struct.pack(self.pack_format, object_representation)
-
-    def binary_to_object(self, binary_representation):
-        return struct.unpack(self.pack_format, binary_representation)[0]
-
-    def size_in_bytes(self):
-        return struct.calcsize(self.pack_format)
+    def pack_codes(self):
+        return self.pack_format.lstrip("<")
 
     def check_bounds(self, value, min, max):
         if value is not None:
@@ -214,14 +254,8 @@ class FloatValueFormat(DataFormat):
         else:
             return str(object_representation)
 
-    def object_to_binary(self, object_representation):
-        return struct.pack(self.pack_format, object_representation)
-
-    def binary_to_object(self, binary_representation):
-        return struct.unpack(self.pack_format, binary_representation)[0]
-
-    def size_in_bytes(self):
-        return struct.calcsize(self.pack_format)
+    def pack_codes(self):
+        return self.pack_format.lstrip("<")
 
     def check_bounds(self, value, min, max):
         if value is not None and min is not None:
@@ -263,14 +297,8 @@ class BoolFormat(DataFormat):
             else:
                 return 'false'
 
-    def object_to_binary(self, object_representation):
-        return struct.pack("<?", object_representation)
-
-    def binary_to_object(self, binary_representation):
-        return struct.unpack("<?", binary_representation)[0]
-
-    def size_in_bytes(self):
-        return struct.calcsize("<?")
+    def pack_codes(self):
+        return "?"
 
     def check_bounds(self, value, min, max):
         if min is not None:
@@ -379,14 +407,8 @@ class EnumFormat(DataFormat):
                     return value.name
         return str(object_representation)
 
-    def object_to_binary(self, object_representation):
-        return struct.pack("<i", object_representation)
-
-    def binary_to_object(self, binary_representation):
-        return struct.unpack("<i", binary_representation)[0]
-
-    def size_in_bytes(self):
-        return struct.calcsize("<i")
+    def pack_codes(self):
+        return "i"
 
     def check_bounds(self, value, min, max):
         if min is not None:
@@ -469,23 +491,27 @@ class ArrayFormat(DataFormat):
 
         return "{{{}}}".format(",".join(element_strings))
 
-    def object_to_binary(self, object_representation):
-        binary = b''
-        for element in object_representation:
-            binary += self.format.object_to_binary(element)
-        return binary
+    def pack_codes(self):
+        return self.format.pack_codes() * self.count
 
-    def binary_to_object(self, binary_representation):
-        values = []
-        element_size = self.format.size_in_bytes()
-        for i in range(self.count):
-            element_binary = binary_representation[
-                (i * element_size):((i + 1) * element_size)]
-            values.append(self.format.binary_to_object(element_binary))
-        return values
+    def flatten(self, object_representation, values):
+        if len(object_representation) != self.count:
+            raise ParseError(
+                "Member '{}' of struct '{}' should have {} elements, but {} were found".format(
+                    self.member_name, self.struct_name, self.count, len(object_representation)))
 
-    def size_in_bytes(self):
-        return self.format.size_in_bytes() * self.count
+        # the elements of arrays of scalars are their own flattened values
+        if isinstance(self.format, (StructFormat, ArrayFormat)):
+            for element in object_representation:
+                self.format.flatten(element, values)
+        else:
+            values.extend(object_representation)
+
+    def unflatten(self, values):
+        if isinstance(self.format, (StructFormat, ArrayFormat)):
+            return [self.format.unflatten(values) for i in range(self.count)]
+
+        return list(itertools.islice(values, self.count))
 
     def check_bounds(self, value, min, max):
         for i in range(self.count):
@@ -693,32 +719,19 @@ class StructFormat(DataFormat):
 
         return "{{{}}}".format(",".join(member_strings))
 
-    def object_to_binary(self, object_representation):
-        binary_representation = b''
+    def pack_codes(self):
+        return "".join(member.format.pack_codes() for member in self.members)
+
+    def flatten(self, object_representation, values):
         for member in self.members:
-            value = object_representation[member.name]
-            member_binary = member.object_to_binary(value)
-            binary_representation += member_binary
-            assert len(member_binary) == member.size_in_bytes()
-        return binary_representation
+            member.format.flatten(object_representation[member.name], values)
 
-    def binary_to_object(self, binary_representation):
-        position = 0
+    def unflatten(self, values):
         obj = OrderedDict()
         for member in self.members:
-            member_binary = binary_representation[
-                position:(position + member.size_in_bytes())]
-            member_value = member.binary_to_object(member_binary)
-            obj[member.name] = member_value
-            position += member.size_in_bytes()
+            obj[member.name] = member.format.unflatten(values)
         return obj
 
-    def size_in_bytes(self):
-        total_size = 0
-        for member in self.members:
-            total_size += member.size_in_bytes()
-        return total_size
-
     def check_bounds(self, value, min, max):
         for member in self.members:
             member_value = value[member.name]
@@ -851,11 +864,18 @@ class Knob:
         return child_object
 
     def _set_child_value(self, child_path, value):
+        self.value = self.get_updated_value(self._value, child_path, value)
+
+    # Returns a copy of a value of this knob, or of its default when None, with the member at child_path set.
+    # Neither the given value nor the knob is modified
+    def get_updated_value(self, base_value, child_path, value):
         if child_path == self.name:
-            self.value = value
+            if value is not None:
+                self.format.check_bounds(value, self._min, self._max)
+            return copy.deepcopy(value)
         else:
             path_elements = child_path.split(".")
-            child_object = self.value
+            child_object = copy.deepcopy(base_value)
 
             if child_object is None:
                 child_object = self.default
@@ -892,9 +912,10 @@ class Knob:
             else:
                 child_object[name][index] = value
 
-            # Update the knob to the value of the full_object, which has been modified by virtue of
-            # updating the child object (which was a pointer to an internal structure of the full object)
-            self.value = full_object
+            # Return the value of the full_object, which has been modified by virtue of updating the
+            # child object (which was a pointer to an internal structure of the full object)
+            self.format.check_bounds(full_object, self._min, self._max)
+            return full_object
 
     def _decode_subpath(self, subpath_segment):
         match = re.match(
@@ -923,11 +944,15 @@ class SubKnob:
         self.format = format
         self.help = help
         self.leaf = leaf
+        # The (member name, index) of each step from the knob value down to this subknob, decoded once so that
+        # lookups don't parse the name again. Empty for the subknob of the whole knob
+        self.path = tuple(knob._decode_subpath(element) for element in path.split(".")[1:])
         pass
 
+    # The getters only copy the member, not the whole knob value
     @property
     def value(self):
-        return self.knob._get_child_value(self.name, self.knob.value)
+        return copy.deepcopy(get_subknob_value(self.knob._value, self.path))
 
     @value.setter
     def value(self, value):
@@ -936,15 +961,61 @@ class SubKnob:
 
     @property
     def default(self):
-        return self.knob._get_child_value(self.name, self.knob.default)
+        return copy.deepcopy(get_subknob_value(self.knob._default, self.path))
 
     @property
     def min(self):
-        return self.knob._get_child_value(self.name, self.knob.min)
+        return copy.deepcopy(get_subknob_value(self.knob._min, self.path))
 
     @property
     def max(self):
-        return self.knob._get_child_value(self.name, self.knob.max)
+        return copy.deepcopy(get_subknob_value(self.knob._max, self.path))
+
+
+# Returns the member of a knob value at the path of a subknob, see SubKnob.path. The member is not copied
+def get_subknob_value(value, path):
+    for (name, index) in path:
+        value = value[name] if index is None else value[name][index]
+    return value
+
+
+# Sets the member of a knob value at the path of a subknob, in place. The path must not be empty
+def set_subknob_value(value, path, member_value):
+    value = get_subknob_value(value, path[:-1])
+    (name, index) = path[-1]
+    if index is None:
+        value[name] = member_value
+    else:
+        value[name][index] = member_value
+
+
+# Accumulates the values that knob CSV rows set, each row setting a whole knob or one of its members. A knob value
+# is copied once, when the first of its members is set, and bounds checked once by items(), rather than for every
+# row as setting SubKnob.value does
+class KnobValueBuilder:
+    def __init__(self):
+        self._values = OrderedDict()
+
+    # Set a subknob to a value, on top of base_value for the first member of a knob set. A base_value of None
+    # is the knob default
+    def set(self, subknob, value, base_value=None):
+        knob = subknob.knob
+        if len(subknob.path) == 0:
+            self._values[knob] = value
+            return
+
+        knob_value = self._values.get(knob)
+        if knob_value is None:
+            knob_value = knob.default if base_value is None else copy.deepcopy(base_value)
+            self._values[knob] = knob_value
+        set_subknob_value(knob_value, subknob.path, value)
+
+    # Returns the (knob, value) of every knob set, in the order they were first set. Raises InvalidRangeError
+    # for a value out of the range of its knob
+    def items(self):
+        for (knob, value) in self._values.items():
+            knob.format.check_bounds(value, knob._min, knob._max)
+        return list(self._values.items())
 
 
 class Schema:
@@ -952,8 +1023,13 @@ class Schema:
         self.enums = []
         self.structs = []
         self.knobs = []
+        self.subknobs = []
         self.path = origin_path
 
+        # Knobs and subknobs indexed by (namespace, name), so lookups don't scan every subknob
+        self._knob_index = {}
+        self._subknob_index = {}
+
         for section in dom.getElementsByTagName('Enums'):
             for enum in section.getElementsByTagName('Enum'):
                 self.enums.append(EnumFormat(enum))
@@ -965,45 +1041,69 @@ class Schema:
         for section in dom.getElementsByTagName('Knobs'):
             namespace = re.sub('[{}]', '', section.getAttribute('namespace'))
             for knob in section.getElementsByTagName('Knob'):
-                self.knobs.append(Knob(self, knob, namespace))
-
-        self.subknobs = []
-        for knob in self.knobs:
-            self.subknobs += knob.subknobs
+                self.add_knob(Knob(self, knob, namespace))
 
         pass
 
+    # Key of the knob lookup indices. The namespace guid lives at the Knob level, not the subknob level
+    def _index_key(guid, name):
+        return (str(guid).upper(), name)
+
+    # Add a knob and its subknobs to the schema and its lookup indices
+    def add_knob(self, knob):
+        self.knobs.append(knob)
+        self.subknobs += knob.subknobs
+
+        # when names repeat, the first knob or subknob added is the one found, as with a linear search
+        self._knob_index.setdefault(Schema._index_key(knob.namespace, knob.name), knob)
+        for subknob in knob.subknobs:
+            self._subknob_index.setdefault(Schema._index_key(knob.namespace, subknob.name), subknob)
+
     # Load a schema given a path to a schema xml file
-    def load(path):
+    # A schema that was validated and built before is loaded from the compiled schema cache instead,
+    # see get_schema_cache_path
+    def load(path, use_cache=True):
+
+        with open(path, "rb") as xml_file:
+            content = xml_file.read()
 
         # Per instructions from PyInstaller:
         # https://pyinstaller.org/en/stable/runtime-information.html#run-time-information
-        if getattr(sys, "frozen", False) and hasattr(sys, '_MEIPASS'):
+        frozen = getattr(sys, "frozen", False) and hasattr(sys, '_MEIPASS')
+        cache_path = get_schema_cache_path(content) if use_cache and not frozen else None
+
+        schema = _read_schema_cache(cache_path)
+        if schema is not None:
+            schema.path = path
+            return schema
+
+        if frozen:
             # The application is frozen
             print("Running bundled VariableList!\n")
         else:
             # The application is not frozen, perform schema check
             import xmlschema
             # Get the XML schema from the current path
-            xsd = xmlschema.XMLSchema(os.path.join(os.path.dirname(os.path.abspath(__file__)), "configschema.xsd"))
+            xsd = xmlschema.XMLSchema(SCHEMA_XSD_PATH)
 
             # raises exception if validation fails
             xsd.validate(path)
 
-        return Schema(parse(path), path)
+        schema = Schema(parseString(content), path)
+        _write_schema_cache(cache_path, schema)
+        return schema
 
     # Parse a schema given a string representation of the xml content
     def parse(string):
         return Schema(parseString(string))
 
-    # Get a knob by name
+    # Get a knob or subknob by name, subknobs are named by their full path, e.g. "knob.member[1]"
     def get_knob(self, guid, knob_name):
-        for knob in self.subknobs:
-            # namespace guid lives at the Knob level, not the subknob level
-            if str(knob.knob.namespace).upper() == str(guid).upper() and knob.name == knob_name:
-                return knob
+        return self._subknob_index.get(Schema._index_key(guid, knob_name))
 
-        return None
+    # Get a whole knob by name, e.g. the knob stored in a UEFI variable
+    def get_root_knob(self, guid, knob_name):
+        return self._knob_index.get(Schema._index_key(guid, knob_name))
 
     # Get a format by name
     def get_format(self, type_name):
@@ -1029,11 +1129,167 @@ class Schema:
             "Data type '{}' is not defined".format(type_name))
 
 
+# The compiled schema cache holds the Schema objects built from a schema XML, pickled, so that tools
+# loaded with the same XML skip the XSD validation and the DOM walk. The entries live in a per-user cache
+# folder, mu_feature_config/schema under LOCALAPPDATA on Windows or XDG_CACHE_HOME (~/.cache) elsewhere, or in
+# the folder named by the CONF_SCHEMA_CACHE_DIR environment variable. Setting the variable to an empty string
+# disables the cache
+SCHEMA_CACHE_DIR_ENV = "CONF_SCHEMA_CACHE_DIR"
+
+# Bump when the pickled layout of the Schema objects changes in a way the script hash does not catch
+SCHEMA_CACHE_VERSION = 1
+
+# Every entry starts with the HMAC-SHA256 of its pickle, keyed by a random key private to the cache folder. An
+# entry is only unpickled once its HMAC matches, so a file planted in the folder is a miss rather than code run
+SCHEMA_CACHE_KEY_NAME = "schema-cache.key"
+SCHEMA_CACHE_KEY_SIZE = 32
+SCHEMA_CACHE_MAC_SIZE = hashlib.sha256().digest_size
+
+# The XSD the schemas are validated against
+SCHEMA_XSD_PATH = os.path.join(os.path.dirname(os.path.abspath(__file__)), "configschema.xsd")
+
+# Hash of this script and of the XSD, so that an edited loader or XSD never reads the objects of an older one
+_schema_loader_hash = None
+
+
+def _get_schema_loader_hash():
+    global _schema_loader_hash
+    if _schema_loader_hash is None:
+        loader = hashlib.sha256(f"{SCHEMA_CACHE_VERSION}:{sys.version_info[0]}.{sys.version_info[1]}".encode())
+        for path in (os.path.abspath(__file__), SCHEMA_XSD_PATH):
+            with open(path, "rb") as loader_file:
+                loader.update(loader_file.read())
+        _schema_loader_hash = loader.digest()
+    return _schema_loader_hash
+
+
+#
+# Get the folder of the compiled schema cache
+# return None when the cache is disabled
+#
+def get_schema_cache_dir():
+    cache_dir = os.environ.get(SCHEMA_CACHE_DIR_ENV)
+    if cache_dir is not None:
+        return cache_dir if cache_dir != "" else None
+
+    if sys.platform == "win32":
+        user_cache = os.environ.get("LOCALAPPDATA") or os.path.join(os.path.expanduser("~"), "AppData", "Local")
+    else:
+        user_cache = os.environ.get("XDG_CACHE_HOME") or os.path.join(os.path.expanduser("~"), ".cache")
+    return os.path.join(user_cache, "mu_feature_config", "schema")
+
+
+#
+# Get the path of the compiled schema cache entry for the content of a schema XML
+# return None when the cache is disabled
+#
+def get_schema_cache_path(content):
+    cache_dir = get_schema_cache_dir()
+    if cache_dir is None:
+        return None
+
+    key = hashlib.sha256(_get_schema_loader_hash() + content).hexdigest()
+    return os.path.join(cache_dir, f"schema-{key}.pickle")
+
+
+#
+# Get the key signing the entries of a cache folder, creating it readable by the current user only when create is
+# set and the folder has none yet
+# return None when there is no key
+#
+def _get_schema_cache_key(cache_dir, create=False):
+    key_path = os.path.join(cache_dir, SCHEMA_CACHE_KEY_NAME)
+    try:
+        with open(key_path, "rb") as key_file:
+            key = key_file.read()
+        if len(key) == SCHEMA_CACHE_KEY_SIZE:
+            return key
+    except OSError:
+        pass
+
+    if not create:
+        return None
+
+    # mkstemp creates the file readable and writable by its owner only
+    os.makedirs(cache_dir, mode=0o700, exist_ok=True)
+    (handle, temp_path) = tempfile.mkstemp(dir=cache_dir, suffix=".tmp")
+    try:
+        key = os.urandom(SCHEMA_CACHE_KEY_SIZE)
+        with os.fdopen(handle, "wb") as key_file:
+            key_file.write(key)
+        os.replace(temp_path, key_path)
+    except Exception:
+        os.remove(temp_path)
+        raise
+
+    return key
+
+
+# Read a schema from the cache, any missing, unreadable or unsigned entry is a miss
+def _read_schema_cache(cache_path):
+    if cache_path is None:
+        return None
+
+    try:
+        key = _get_schema_cache_key(os.path.dirname(cache_path))
+        if key is None:
+            return None
+
+        with open(cache_path, "rb") as cache_file:
+            entry = cache_file.read()
+
+        mac = hmac.new(key, entry[SCHEMA_CACHE_MAC_SIZE:], hashlib.sha256).digest()
+        if not hmac.compare_digest(mac, entry[:SCHEMA_CACHE_MAC_SIZE]):
+            return None
+
+        schema = pickle.loads(entry[SCHEMA_CACHE_MAC_SIZE:])
+    except Exception:
+        return None
+
+    return schema if isinstance(schema, Schema) else None
+
+
+# Write a schema to the cache, the cache is best effort so a failed write is ignored. Entries are
+# written to a temporary file and then renamed, so concurrent tools never read a partial entry
+def _write_schema_cache(cache_path, schema):
+    if cache_path is None:
+        return
+
+    temp_path = None
+    try:
+        cache_dir = os.path.dirname(cache_path)
+        key = _get_schema_cache_key(cache_dir, create=True)
+        payload = pickle.dumps(schema, protocol=pickle.HIGHEST_PROTOCOL)
+        with tempfile.NamedTemporaryFile("wb", dir=cache_dir, suffix=".tmp", delete=False) as cache_file:
+            temp_path = cache_file.name
+            cache_file.write(hmac.new(key, payload, hashlib.sha256).digest())
+            cache_file.write(payload)
+        os.replace(temp_path, cache_path)
+    except Exception:
+        if temp_path is not None:
+            try:
+                os.remove(temp_path)
+            except OSError:
+                pass
+
+
+# The packed variable list format is a sequence of entries, each a NameSize, DataSize header, then the name,
+# namespace Guid, attributes and data, followed by the CRC32 of all of the entry bytes before it.
+# See CONFIG_VAR_LIST_HDR in ConfigVariableListLib.h
+VLIST_ENTRY_HEADER = struct.Struct("<ii")
+VLIST_ENTRY_GUID_SIZE = 16
+VLIST_ENTRY_UINT32 = struct.Struct("<I")
+
+
+# EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS
+UEFI_VARIABLE_DEFAULT_ATTRIBUTES = 7
+
+
 # Represents a UEFI variable
 # Knobs are stored within UEFI variables and can be serialized to a
 # variable list file
 class UEFIVariable:
-    def __init__(self, name, guid, data, attributes=7):
+    def __init__(self, name, guid, data, attributes=UEFI_VARIABLE_DEFAULT_ATTRIBUTES):
         self.name = name
         if isinstance(guid, uuid.UUID):
             self.guid = guid
@@ -1072,6 +1328,41 @@ def create_vlist_buffer(variable):
     return payload + struct.pack("<I", crc)
 
 
+# Size in bytes of the packed variable list entry of a variable, given its encoded name and data size
+def get_vlist_entry_size(name, data_size):
+    return VLIST_ENTRY_HEADER.size + len(name) + VLIST_ENTRY_GUID_SIZE + VLIST_ENTRY_UINT32.size + data_size + \
+        VLIST_ENTRY_UINT32.size
+
+
+# Create a single buffer holding the packed variable list entries of a list of (knob, value). The buffer is
+# allocated once and each value is packed straight into it by the compiled layout of its knob format
+def create_knob_vlist_buffer(knob_values):
+    names = [(knob.name + "\0").encode("utf-16le") for knob, _ in knob_values]
+    buffer = bytearray(sum(get_vlist_entry_size(name, knob.format.size_in_bytes())
+                           for name, (knob, _) in zip(names, knob_values)))
+
+    offset = 0
+    with memoryview(buffer) as view:
+        for name, (knob, value) in zip(names, knob_values):
+            data_size = knob.format.size_in_bytes()
+            name_offset = offset + VLIST_ENTRY_HEADER.size
+            guid_offset = name_offset + len(name)
+            attributes_offset = guid_offset + VLIST_ENTRY_GUID_SIZE
+            data_offset = attributes_offset + VLIST_ENTRY_UINT32.size
+            crc_offset = data_offset + data_size
+
+            VLIST_ENTRY_HEADER.pack_into(buffer, offset, len(name), data_size)
+            view[name_offset:guid_offset] = name
+            view[guid_offset:attributes_offset] = uuid.UUID(knob.namespace).bytes_le
+            VLIST_ENTRY_UINT32.pack_into(buffer, attributes_offset, UEFI_VARIABLE_DEFAULT_ATTRIBUTES)
+            knob.format.pack_into(buffer, data_offset, value)
+            VLIST_ENTRY_UINT32.pack_into(buffer, crc_offset, zlib.crc32(view[offset:crc_offset]))
+
+            offset = crc_offset + VLIST_ENTRY_UINT32.size
+
+    return bytes(buffer)
+
+
 def get_delta_vlist(schema):
     name_list = []
     var_list = []
@@ -1079,208 +1370,1009 @@ def get_delta_vlist(schema):
         if knob.default == knob.value:
             # knob value didn't change
             continue
-        value_bytes = knob.format.object_to_binary(knob.value)
 
-        variable = UEFIVariable(knob.name, knob.namespace, value_bytes)
-        var_list.append(create_vlist_buffer(variable))
+        var_list.append(create_knob_vlist_buffer([(knob, knob.value)]))
         name_list.append(knob.name)
 
     return name_list, var_list
 
 
-# Create a byte array for all the knobs in this schema
-def vlist_to_binary(schema):
-
-    ret = b''
+# Create a byte array for all the knobs in this schema, optionally in the compressed variable list format
+def vlist_to_binary(schema, compressed=False):
+    # the values are only read, so skip the copy the value property makes for callers that modify it
+    buffer = create_knob_vlist_buffer([(knob, knob._value) for knob in schema.knobs if knob._value is not None])
+    if compressed:
+        return compress_vlist(buffer)
+    return buffer
+
+
+# The aligned variable list format keeps fixed size entry descriptors, names and naturally
+# aligned data in separate regions. See CONFIG_VAR_LIST_ALIGNED_HDR in ConfigVariableListLib.h
+ALIGNED_VLIST_SIGNATURE = b"CVLA"
+ALIGNED_VLIST_VERSION = 1
+ALIGNED_VLIST_DATA_ALIGNMENT = 8
+
+# Signature, Version, HeaderSize, EntryCount, NamesOffset, NamesSize, DataOffset, DataSize, Crc32
+ALIGNED_VLIST_HEADER = struct.Struct("<4sHHIIIIII")
+
+# Guid, Attributes, NameOffset, NameSize, DataOffset, DataSize, Reserved
+ALIGNED_VLIST_ENTRY = struct.Struct("<16sIIIIII")
+
+
+def align_up(value, alignment):
+    return (value + alignment - 1) & ~(alignment - 1)
+
+
+# Compute the layout of an aligned variable list from the (name_size, data_size) in bytes
+# of each entry. Returns the total size, the offsets of the name and data regions and the
+# offsets of each name and data relative to their region
+def get_aligned_vlist_layout(sizes):
+    names_offset = ALIGNED_VLIST_HEADER.size + ALIGNED_VLIST_ENTRY.size * len(sizes)
+
+    name_offsets = []
+    names_size = 0
+    for name_size, _ in sizes:
+        name_offsets.append(names_size)
+        names_size += name_size
+
+    # the data region and every value in it start on an aligned offset from the start of the buffer
+    data_offset = align_up(names_offset + names_size, ALIGNED_VLIST_DATA_ALIGNMENT)
+    data_offsets = []
+    data_size = 0
+    for _, value_size in sizes:
+        data_size = align_up(data_size, ALIGNED_VLIST_DATA_ALIGNMENT)
+        data_offsets.append(data_size)
+        data_size += value_size
+
+    return data_offset + data_size, names_offset, data_offset, name_offsets, data_offsets
+
+
+# Create an aligned variable list buffer holding all of the variables
+def create_aligned_vlist_buffer(variables):
+    names = [(variable.name + "\0").encode("utf-16le") for variable in variables]
+    sizes = [(len(name), len(variable.data)) for name, variable in zip(names, variables)]
+    total_size, names_offset, data_offset, name_offsets, data_offsets = get_aligned_vlist_layout(sizes)
+
+    buffer = bytearray(total_size)
+    for index, variable in enumerate(variables):
+        ALIGNED_VLIST_ENTRY.pack_into(
+            buffer,
+            ALIGNED_VLIST_HEADER.size + ALIGNED_VLIST_ENTRY.size * index,
+            variable.guid.bytes_le,
+            variable.attributes,
+            name_offsets[index],
+            len(names[index]),
+            data_offsets[index],
+            len(variable.data),
+            0)
+
+        start = names_offset + name_offsets[index]
+        buffer[start:start + len(names[index])] = names[index]
+        start = data_offset + data_offsets[index]
+        buffer[start:start + len(variable.data)] = variable.data
+
+    names_size = sum(len(name) for name in names)
+    crc = zlib.crc32(buffer[ALIGNED_VLIST_HEADER.size:])
+    ALIGNED_VLIST_HEADER.pack_into(
+        buffer,
+        0,
+        ALIGNED_VLIST_SIGNATURE,
+        ALIGNED_VLIST_VERSION,
+        ALIGNED_VLIST_HEADER.size,
+        len(variables),
+        names_offset,
+        names_size,
+        data_offset,
+        total_size - data_offset,
+        crc)
+
+    return bytes(buffer)
+
+
+# Create an aligned variable list byte array for all the knobs in this schema
+def vlist_to_aligned_binary(schema):
+    variables = []
     for knob in schema.knobs:
         if knob.value is not None:
             value_bytes = knob.format.object_to_binary(knob.value)
+            variables.append(UEFIVariable(knob.name, knob.namespace, value_bytes))
 
-            variable = UEFIVariable(knob.name, knob.namespace, value_bytes)
-            ret += create_vlist_buffer(variable)
+    return create_aligned_vlist_buffer(variables)
 
-    return ret
 
+# Iterate over the UEFIVariables of an aligned variable list buffer
+def iter_aligned_vlist_entries(array):
+    (signature, version, header_size, entry_count, names_offset, names_size,
+     data_offset, data_size, crc) = ALIGNED_VLIST_HEADER.unpack_from(array, 0)
 
-# Read a set of UEFIVariables from a variable list file
-def read_vlist(file):
+    if version != ALIGNED_VLIST_VERSION:
+        raise Exception("Unsupported aligned variable list version {}".format(version))
+
+    if data_offset + data_size != len(array) or \
+       header_size + ALIGNED_VLIST_ENTRY.size * entry_count > names_offset or \
+       names_offset + names_size > data_offset:
+        raise Exception("Aligned variable list regions do not fit the buffer")
+
+    if crc != zlib.crc32(array[header_size:]):
+        raise Exception("CRC mismatch")
+
+    for index in range(entry_count):
+        (guid_bytes, attributes, name_offset, name_size, value_offset, value_size,
+         _) = ALIGNED_VLIST_ENTRY.unpack_from(array, header_size + ALIGNED_VLIST_ENTRY.size * index)
+
+        if name_offset + name_size > names_size or value_offset + value_size > data_size:
+            raise Exception("Aligned variable list entry {} does not fit its regions".format(index))
+
+        start = names_offset + name_offset
+        name = array[start:start + name_size]
+        start = data_offset + value_offset
+        data = array[start:start + value_size]
+
+        yield (guid_bytes, name, attributes, data)
+
+
+# Iterate over the UEFIVariables of an aligned variable list buffer
+def iter_aligned_vlist(array):
+    for guid, name, attributes, data in iter_aligned_vlist_entries(array):
+        yield UEFIVariable(decode_vlist_name(name), uuid.UUID(bytes_le=bytes(guid)), bytes(data), attributes)
+
+
+# Read a set of UEFIVariables from an aligned variable list buffer
+def read_aligned_vlist_from_buffer(array):
+    with memoryview(array) as view:
+        return list(iter_aligned_vlist(view))
+
+
+# The compressed variable list format holds a dictionary of the guids and names of all entries,
+# followed by a record per entry whose data is LZ compressed. See CONFIG_VAR_LIST_COMPRESSED_HDR
+# in ConfigVariableListLib.h
+COMPRESSED_VLIST_SIGNATURE = b"CVLZ"
+COMPRESSED_VLIST_VERSION = 2
+
+# Signature, Version, HeaderSize, EntryCount, GuidCount, DictionarySize, MaxEntrySize, PackedSize, Crc32.
+# The CRC32 covers the whole buffer, this header included with its Crc32 taken as 0
+COMPRESSED_VLIST_HEADER = struct.Struct("<4sHHIIIIII")
+COMPRESSED_VLIST_CRC_OFFSET = COMPRESSED_VLIST_HEADER.size - 4
+
+
+# CRC32 of a compressed variable list buffer, with the Crc32 field of its header taken as 0
+def get_compressed_vlist_crc(view):
+    crc = zlib.crc32(view[:COMPRESSED_VLIST_CRC_OFFSET])
+    crc = zlib.crc32(b"\0\0\0\0", crc)
+    return zlib.crc32(view[COMPRESSED_VLIST_HEADER.size:], crc)
+
+# A LZ token below VLIST_LZ_MATCH_FLAG is followed by token + 1 literal bytes, any other token
+# copies (token & ~VLIST_LZ_MATCH_FLAG) + VLIST_LZ_MIN_MATCH bytes from a varint distance back
+VLIST_LZ_MATCH_FLAG = 0x80
+VLIST_LZ_MIN_MATCH = 3
+VLIST_LZ_MAX_MATCH = (VLIST_LZ_MATCH_FLAG - 1) + VLIST_LZ_MIN_MATCH
+VLIST_LZ_MAX_LITERALS = VLIST_LZ_MATCH_FLAG
+
+# Number of earlier positions of a prefix tried for each match
+VLIST_LZ_MAX_CHAIN = 16
+
+
+# Append the LEB128 encoding of an unsigned 32 bit value
+def encode_varint(out, value):
+    if value < 0 or value > 0xFFFFFFFF:
+        raise Exception("Value {} does not fit a varint".format(value))
+
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+
+
+# Decode a LEB128 unsigned 32 bit value, return the value and the offset following it
+def decode_varint(view, offset):
+    value = 0
+    for shift in range(0, 35, 7):
+        if offset >= len(view):
+            raise Exception("Varint does not fit the buffer")
+
+        byte = view[offset]
+        offset += 1
+        value |= (byte & 0x7F) << shift
+        if byte < 0x80:
+            if value > 0xFFFFFFFF:
+                break
+            return value, offset
+
+    raise Exception("Varint does not fit 32 bits")
+
+
+# LZ compress a block of bytes, only matching within the block so that every block can be
+# decompressed on its own
+def lz_compress(data):
+    data = bytes(data)
+    out = bytearray()
+    chains = {}
+    literal_start = 0
+    position = 0
+
+    def add_literals(end):
+        start = literal_start
+        while start < end:
+            count = min(end - start, VLIST_LZ_MAX_LITERALS)
+            out.append(count - 1)
+            out.extend(data[start:start + count])
+            start += count
+
+    def add_positions(start, end):
+        for index in range(start, min(end, len(data) - VLIST_LZ_MIN_MATCH + 1)):
+            chains.setdefault(data[index:index + VLIST_LZ_MIN_MATCH], []).append(index)
+
+    while position < len(data):
+        best_length = 0
+        best_distance = 0
+        limit = min(VLIST_LZ_MAX_MATCH, len(data) - position)
+        if limit >= VLIST_LZ_MIN_MATCH:
+            chain = chains.get(data[position:position + VLIST_LZ_MIN_MATCH], [])
+            for candidate in reversed(chain[-VLIST_LZ_MAX_CHAIN:]):
+                length = VLIST_LZ_MIN_MATCH
+                while length < limit and data[candidate + length] == data[position + length]:
+                    length += 1
+                if length > best_length:
+                    best_length = length
+                    best_distance = position - candidate
+                    if length == limit:
+                        break
+
+        if best_length == 0:
+            add_positions(position, position + 1)
+            position += 1
+            continue
+
+        add_literals(position)
+        out.append(VLIST_LZ_MATCH_FLAG | (best_length - VLIST_LZ_MIN_MATCH))
+        encode_varint(out, best_distance)
+        add_positions(position, position + best_length)
+        position += best_length
+        literal_start = position
+
+    add_literals(len(data))
+    return bytes(out)
+
+
+# Decompress a LZ block of size bytes starting at offset, return the bytes and the offset following the block
+def lz_decompress(view, offset, size):
+    out = bytearray()
+    while len(out) < size:
+        if offset >= len(view):
+            raise Exception("LZ block does not fit the buffer")
+
+        token = view[offset]
+        offset += 1
+        if token < VLIST_LZ_MATCH_FLAG:
+            count = token + 1
+            if offset + count > len(view) or len(out) + count > size:
+                raise Exception("LZ literals do not fit the block")
+            out += view[offset:offset + count]
+            offset += count
+            continue
+
+        length = (token & ~VLIST_LZ_MATCH_FLAG) + VLIST_LZ_MIN_MATCH
+        distance, offset = decode_varint(view, offset)
+        if distance == 0 or distance > len(out) or len(out) + length > size:
+            raise Exception("LZ match does not fit the block")
+
+        start = len(out) - distance
+        if distance >= length:
+            out += out[start:start + length]
+        else:
+            # the match overlaps the bytes it produces, e.g. a run of zeros
+            for index in range(length):
+                out.append(out[start + index])
+
+    return bytes(out), offset
+
+
+# Compress a variable list buffer in the packed or aligned format. All guids and names go to a
+# single dictionary, compressed as one block, and the data of each entry is compressed by itself
+def compress_vlist(array):
+    guids = {}
+    names = {}
+    names_size = 0
+    records = bytearray()
+    entry_count = 0
+    max_entry_size = 0
+    packed_size = 0
+
+    with memoryview(array) as view:
+        if view[:len(COMPRESSED_VLIST_SIGNATURE)] == COMPRESSED_VLIST_SIGNATURE:
+            raise Exception("Variable list is already compressed")
+
+        for guid, name, attributes, data in iter_vlist_entries(view):
+            guid = bytes(guid)
+            name = bytes(name)
+            if len(name) < 2 or len(name) % 2 != 0 or name[-2:] != b"\0\0":
+                raise Exception("Variable list entry {} has an unterminated name".format(entry_count))
+
+            if guid not in guids:
+                guids[guid] = len(guids)
+            if name not in names:
+                names[name] = names_size
+                names_size += len(name)
+
+            encode_varint(records, guids[guid])
+            encode_varint(records, names[name])
+            encode_varint(records, len(name))
+            encode_varint(records, attributes)
+            encode_varint(records, len(data))
+            records += lz_compress(data)
+
+            entry_size = get_vlist_entry_size(name, len(data))
+            max_entry_size = max(max_entry_size, entry_size)
+            packed_size += entry_size
+            entry_count += 1
+
+    dictionary = b"".join(guids) + b"".join(names)
+    body = lz_compress(dictionary) + records
+    buffer = bytearray(COMPRESSED_VLIST_HEADER.pack(
+        COMPRESSED_VLIST_SIGNATURE,
+        COMPRESSED_VLIST_VERSION,
+        COMPRESSED_VLIST_HEADER.size,
+        entry_count,
+        len(guids),
+        len(dictionary),
+        max_entry_size,
+        packed_size,
+        0)) + body
+    VLIST_ENTRY_UINT32.pack_into(buffer, COMPRESSED_VLIST_CRC_OFFSET, get_compressed_vlist_crc(buffer))
+
+    return bytes(buffer)
+
+
+# Iterate over the raw (guid, name, attributes, data) of the entries of a compressed variable list buffer.
+# Only the dictionary is held for the whole walk, the data of each entry is decompressed when it is reached
+def iter_compressed_vlist_entries(view):
+    if len(view) < COMPRESSED_VLIST_HEADER.size:
+        raise Exception("Compressed variable list is smaller than its header")
+
+    (signature, version, header_size, entry_count, guid_count, dictionary_size, max_entry_size,
+     packed_size, crc) = COMPRESSED_VLIST_HEADER.unpack_from(view, 0)
+
+    if version != COMPRESSED_VLIST_VERSION:
+        raise Exception("Unsupported compressed variable list version {}".format(version))
+
+    if crc != get_compressed_vlist_crc(view):
+        raise Exception("CRC mismatch")
+
+    # Neither the dictionary nor an entry can be larger than all entries expanded
+    if header_size < COMPRESSED_VLIST_HEADER.size or header_size > len(view) or \
+       guid_count * VLIST_ENTRY_GUID_SIZE > dictionary_size or \
+       dictionary_size > packed_size or max_entry_size > packed_size:
+        raise Exception("Compressed variable list header does not fit the buffer")
+
+    dictionary, offset = lz_decompress(view, header_size, dictionary_size)
+    names_offset = guid_count * VLIST_ENTRY_GUID_SIZE
+    names_size = dictionary_size - names_offset
+
+    for index in range(entry_count):
+        guid_index, offset = decode_varint(view, offset)
+        name_offset, offset = decode_varint(view, offset)
+        name_size, offset = decode_varint(view, offset)
+        attributes, offset = decode_varint(view, offset)
+        data_size, offset = decode_varint(view, offset)
+
+        if guid_index >= guid_count or name_offset + name_size > names_size or \
+           get_vlist_entry_size(b"\0" * name_size, data_size) > max_entry_size:
+            raise Exception("Compressed variable list entry {} does not fit its dictionary".format(index))
+
+        data, offset = lz_decompress(view, offset, data_size)
+        guid_offset = guid_index * VLIST_ENTRY_GUID_SIZE
+        name_offset += names_offset
+
+        yield (dictionary[guid_offset:guid_offset + VLIST_ENTRY_GUID_SIZE],
+               dictionary[name_offset:name_offset + name_size],
+               attributes,
+               data)
+
+    if offset != len(view):
+        raise Exception("Compressed variable list has trailing bytes")
+
+
+# Expand a compressed variable list buffer into the equivalent packed variable list buffer
+def decompress_vlist(array):
+    entries = []
+    with memoryview(array) as view:
+        for guid, name, attributes, data in iter_compressed_vlist_entries(view):
+            payload = VLIST_ENTRY_HEADER.pack(len(name), len(data)) + name + guid + \
+                VLIST_ENTRY_UINT32.pack(attributes) + data
+            entries.append(payload + VLIST_ENTRY_UINT32.pack(zlib.crc32(payload)))
+
+    return b"".join(entries)
+
+
+# Decode the UTF-16 name of a variable list entry
+def decode_vlist_name(name):
+    return bytes(name).decode(encoding="UTF-16LE").strip("\0")
+
+
+# Iterate over the raw (guid, name, attributes, data) of the entries of a packed variable list buffer,
+# the guid, name and data being slices of the buffer, which are checked but not decoded
+def iter_packed_vlist_entries(view):
+    offset = 0
+    while offset < len(view):
+        if offset + VLIST_ENTRY_HEADER.size > len(view):
+            raise Exception("Variable list entry at offset {} does not fit the buffer".format(offset))
+
+        name_size, data_size = VLIST_ENTRY_HEADER.unpack_from(view, offset)
+
+        # The CRC covers the header, name, guid, attributes and data of the entry
+        name_offset = offset + VLIST_ENTRY_HEADER.size
+        guid_offset = name_offset + name_size
+        attributes_offset = guid_offset + VLIST_ENTRY_GUID_SIZE
+        data_offset = attributes_offset + VLIST_ENTRY_UINT32.size
+        crc_offset = data_offset + data_size
+        if name_size < 0 or data_size < 0 or crc_offset + VLIST_ENTRY_UINT32.size > len(view):
+            raise Exception("Variable list entry at offset {} does not fit the buffer".format(offset))
+
+        crc = VLIST_ENTRY_UINT32.unpack_from(view, crc_offset)[0]
+        if crc != zlib.crc32(view[offset:crc_offset]):
+            raise Exception("CRC mismatch")
+
+        attributes = VLIST_ENTRY_UINT32.unpack_from(view, attributes_offset)[0]
+
+        yield (view[guid_offset:attributes_offset], view[name_offset:guid_offset], attributes,
+               view[data_offset:crc_offset])
+
+        offset = crc_offset + VLIST_ENTRY_UINT32.size
+
+
+# Iterate over the raw entries of a memoryview of a variable list buffer, in the packed, aligned or compressed format
+def iter_vlist_entries(view):
+    if view[:len(ALIGNED_VLIST_SIGNATURE)] == ALIGNED_VLIST_SIGNATURE:
+        return iter_aligned_vlist_entries(view)
+    if view[:len(COMPRESSED_VLIST_SIGNATURE)] == COMPRESSED_VLIST_SIGNATURE:
+        return iter_compressed_vlist_entries(view)
+    return iter_packed_vlist_entries(view)
+
+
+# Iterate over the UEFIVariables of a variable list buffer, in the packed, aligned or compressed format.
+# The buffer can be any object supporting the buffer protocol, e.g. bytes or a mmap. Entries are
+# decoded and checked one at a time by offset, so the buffer is never copied. Each variable's name
+# and data are copied out of the buffer, so they remain valid after the buffer is released.
+def iter_vlist(array):
+    with memoryview(array) as view:
+        for guid, name, attributes, data in iter_vlist_entries(view):
+            yield UEFIVariable(decode_vlist_name(name), uuid.UUID(bytes_le=bytes(guid)), bytes(data), attributes)
+
+
+# Iterate over the UEFIVariables of a variable list file, which is memory mapped rather than read
+def iter_vlist_file(file):
     with open(file, 'rb') as vl_file:
-        variables = read_vlist_from_buffer(vl_file.read())
+        # an empty file can't be mapped, and holds no variables
+        if os.fstat(vl_file.fileno()).st_size == 0:
+            return
+
+        with mmap.mmap(vl_file.fileno(), 0, access=mmap.ACCESS_READ) as vl_map:
+            yield from iter_vlist(vl_map)
+
 
-    return variables
+# Read a set of UEFIVariables from a variable list file
+def read_vlist(file):
+    return list(iter_vlist_file(file))
 
 
-# Read a set of UEFIVariables from a variable list buffer
+# Read a set of UEFIVariables from a variable list buffer, in the packed, aligned or compressed format
 def read_vlist_from_buffer(array):
-    variables = []
-    temp_arr = array
-    while len(temp_arr):
-        # Try reading the first part
-        name_size_bytes = temp_arr[:4]
-        temp_arr = temp_arr[4:]
-
-        # Decode the name size and read the data size
-        name_size = struct.unpack("<i", name_size_bytes)[0]
-        data_size = struct.unpack("<i", temp_arr[:4])[0]
-        temp_arr = temp_arr[4:]
-
-        # These portions are fixed size
-        guid_size = 16
-        attr_size = 4
-
-        # This is the number of bytes *after* the two size integers
-        # *until before* the CRC
-        remaining_bytes = name_size + guid_size + attr_size + data_size
-
-        # Payload will now contain all of the bytes including the size
-        # bytes, but not the CRC
-        payload = struct.pack("<ii", name_size, data_size) + \
-            temp_arr[:remaining_bytes]
-        temp_arr = temp_arr[remaining_bytes:]
-
-        # Read the CRC separately
-        crc = struct.unpack("<I", temp_arr[:4])[0]
-        temp_arr = temp_arr[4:]
-
-        # Validate the CRC
-        if crc != zlib.crc32(payload):
-            raise Exception("CRC mismatch")
+    return list(iter_vlist(array))
+
+
+# A variable that differs between a baseline variable list and another one. Either side is an UEFIVariable,
+# or None when the variable is missing from that list
+class VariableDelta:
+    def __init__(self, baseline, variable):
+        self.baseline = baseline
+        self.variable = variable
+
+    @property
+    def name(self):
+        return (self.variable or self.baseline).name
+
+    @property
+    def guid(self):
+        return (self.variable or self.baseline).guid
+
+
+# The key of a raw variable list entry, its guid and name bytes without the trailing NUL characters
+def get_vlist_entry_key(guid, name):
+    name = bytes(name)
+    end = len(name) & ~1
+    while end >= 2 and name[end - 2:end] == b"\0\0":
+        end -= 2
+    return (bytes(guid), name[:end])
+
+
+def _decode_vlist_entry(entry):
+    if entry is None:
+        return None
+    (guid, name, attributes, data) = entry
+    return UEFIVariable(decode_vlist_name(name), uuid.UUID(bytes_le=bytes(guid)), bytes(data), attributes)
+
+
+# Compare two variable list buffers, in either format. The entries are matched by their raw guid and name,
+# and their raw data and attributes compared, so only the entries that differ are decoded. As when applying
+# a list, the last entry of a variable wins. Returns the VariableDelta of each differing variable, in the
+# order of the other list, followed by the variables only found in the baseline
+def diff_vlists(baseline, other):
+    with memoryview(baseline) as baseline_view, memoryview(other) as other_view:
+        baseline_entries = {}
+        for entry in iter_vlist_entries(baseline_view):
+            baseline_entries[get_vlist_entry_key(entry[0], entry[1])] = entry
+
+        other_entries = {}
+        for entry in iter_vlist_entries(other_view):
+            other_entries[get_vlist_entry_key(entry[0], entry[1])] = entry
+
+        deltas = []
+        for key, entry in other_entries.items():
+            baseline_entry = baseline_entries.pop(key, None)
+            if baseline_entry is not None and baseline_entry[2] == entry[2] and \
+               len(baseline_entry[3]) == len(entry[3]) and bytes(baseline_entry[3]) == bytes(entry[3]):
+                continue
+            deltas.append(VariableDelta(_decode_vlist_entry(baseline_entry), _decode_vlist_entry(entry)))
+
+        for baseline_entry in baseline_entries.values():
+            deltas.append(VariableDelta(_decode_vlist_entry(baseline_entry), None))
+
+    return deltas
+
+
+# Decode the knob values of a list of VariableDelta. Returns (knob, baseline value, value) for each delta of
+# a knob of the schema, with a value of None for a side missing the variable. Other variables are dropped
+def decode_knob_deltas(schema, deltas):
+    knob_deltas = []
+    for delta in deltas:
+        knob = schema.get_root_knob(delta.guid, delta.name)
+        if knob is None:
+            continue
+
+        (baseline_value, value) = [None if variable is None else knob.format.binary_to_object(variable.data)
+                                   for variable in (delta.baseline, delta.variable)]
+        knob_deltas.append((knob, baseline_value, value))
+
+    return knob_deltas
+
+
+# The binary settings packet carries the variable list of a SVD directly, rather than Base64 encoded inside XML,
+# followed by a detached PKCS7 signature of the header and variable list. See SVD_BINARY_PACKET_HEADER in ConfApp.h
+SVD_BINARY_PACKET_SIGNATURE = b"SVDP"
+SVD_BINARY_PACKET_HEADER_VERSION = 2
+
+# Signature, HeaderVersion, HeaderSize, Version, LowestSupportedVersion, PayloadSize, PayloadCrc32
+SVD_BINARY_PACKET_HEADER = struct.Struct("<4sHHIIII")
+
+# WIN_CERTIFICATE_UEFI_GUID holding the signature: dwLength, wRevision, wCertificateType, CertType
+SVD_BINARY_PACKET_CERT_HEADER = struct.Struct("<IHH16s")
+WIN_CERT_REVISION = 0x0200
+WIN_CERT_TYPE_EFI_GUID = 0x0EF1
+EFI_CERT_TYPE_PKCS7_GUID = uuid.UUID("4aafd29d-68df-49ee-8aa9-347d375665a7")
+
+
+# Wrap a variable list buffer in a binary settings packet, which is to be signed by sign_binary_svd_packet, or
+# GenerateSettingsPacketData.py --BinarySvdFile, before ConfApp accepts it
+def create_binary_svd_packet(vlist, version=1, lsv=1):
+    if lsv > version:
+        raise Exception("Lowest supported version {} can't be larger than version {}".format(lsv, version))
+
+    header = SVD_BINARY_PACKET_HEADER.pack(SVD_BINARY_PACKET_SIGNATURE,
+                                           SVD_BINARY_PACKET_HEADER_VERSION,
+                                           SVD_BINARY_PACKET_HEADER.size,
+                                           version,
+                                           lsv,
+                                           len(vlist),
+                                           zlib.crc32(vlist))
+    return header + vlist
+
+
+# Returns the signed part of a binary settings packet and its detached PKCS7 signature, which is None if the packet
+# is not signed yet
+def split_binary_svd_packet(packet):
+    if len(packet) < SVD_BINARY_PACKET_HEADER.size:
+        raise Exception("Binary settings packet is smaller than its header")
+
+    (signature, header_version, header_size, _, _, payload_size, _) = SVD_BINARY_PACKET_HEADER.unpack_from(packet, 0)
+
+    if signature != SVD_BINARY_PACKET_SIGNATURE or header_version != SVD_BINARY_PACKET_HEADER_VERSION:
+        raise Exception("Not a binary settings packet")
+
+    if header_size < SVD_BINARY_PACKET_HEADER.size or header_size + payload_size > len(packet):
+        raise Exception("Binary settings packet payload does not fit the buffer")
+
+    signed_size = header_size + payload_size
+    if signed_size == len(packet):
+        return bytes(packet), None
+
+    if len(packet) - signed_size <= SVD_BINARY_PACKET_CERT_HEADER.size:
+        raise Exception("Binary settings packet signature is truncated")
+
+    (length, revision, cert_type, guid) = SVD_BINARY_PACKET_CERT_HEADER.unpack_from(packet, signed_size)
+    if (length != len(packet) - signed_size or revision != WIN_CERT_REVISION or cert_type != WIN_CERT_TYPE_EFI_GUID
+            or uuid.UUID(bytes_le=guid) != EFI_CERT_TYPE_PKCS7_GUID):
+        raise Exception("Binary settings packet signature is not a PKCS7 WIN_CERTIFICATE_UEFI_GUID")
+
+    return bytes(packet[:signed_size]), bytes(packet[signed_size + SVD_BINARY_PACKET_CERT_HEADER.size:])
+
+
+# Append the detached PKCS7 signature of the header and variable list to an unsigned binary settings packet
+def sign_binary_svd_packet(packet, signature):
+    (signed_data, existing) = split_binary_svd_packet(packet)
+    if existing is not None:
+        raise Exception("Binary settings packet is already signed")
+
+    cert_header = SVD_BINARY_PACKET_CERT_HEADER.pack(SVD_BINARY_PACKET_CERT_HEADER.size + len(signature),
+                                                     WIN_CERT_REVISION,
+                                                     WIN_CERT_TYPE_EFI_GUID,
+                                                     EFI_CERT_TYPE_PKCS7_GUID.bytes_le)
+    return signed_data + cert_header + signature
+
+
+# Returns the version, lowest supported version and variable list buffer of a signed or unsigned binary settings
+# packet. The signature is not verified, only ConfApp holds the trusted certificate
+def read_binary_svd_packet(packet):
+    (signed_data, _) = split_binary_svd_packet(packet)
+    (_, _, header_size, version, lsv, _, crc) = SVD_BINARY_PACKET_HEADER.unpack_from(signed_data, 0)
+
+    vlist = signed_data[header_size:]
+    if crc != zlib.crc32(vlist):
+        raise Exception("CRC mismatch")
+
+    return version, lsv, vlist
+
 
-        # Decode the elements of the payload
-        name = payload[8:(name_size + 8)].decode(encoding="UTF-16LE").strip("\0")
-        guid_bytes = payload[(name_size + 8):(name_size + 8 + 16)]
-        guid = uuid.UUID(bytes_le=guid_bytes)
-        attributes_bytes = payload[(name_size + 8 + 16):(name_size + 8 + 16 + 4)]
-        attributes = struct.unpack("<I", attributes_bytes)[0]
-        data = payload[(name_size + 8 + 16 + 4):]
+# Convert a XML SVD into a binary settings packet carrying the same variables
+def svd_to_binary_packet(svd_string):
+    dom = parseString(svd_string)
+    packet = dom.getElementsByTagName("SettingsPacket")[0]
+    version = int(packet.getElementsByTagName("Version")[0].firstChild.nodeValue)
+    lsv = int(packet.getElementsByTagName("LowestSupportedVersion")[0].firstChild.nodeValue)
 
-        variables.append(UEFIVariable(name, guid, data, attributes))
+    vlist = b''
+    for setting in packet.getElementsByTagName("Setting"):
+        value = setting.getElementsByTagName("Value")[0].firstChild
+        if value is not None:
+            vlist += base64.b64decode(value.nodeValue.strip())
 
-    # If there are no more entries left, returns
-    return variables
+    return create_binary_svd_packet(vlist, version, lsv)
 
 
 def uefi_variables_to_knobs(schema, variables):
     for variable in variables:
-        knob = schema.get_knob(variable.guid, variable.name)
+        knob = schema.get_root_knob(variable.guid, variable.name)
         if knob is not None:
             knob.value = knob.format.binary_to_object(variable.data)
 
 
-def read_csv(schema, csv_path):
-    updated_knobs = 0
-    with open(csv_path, 'r') as csv_file:
-        guid = None
-        reader = csv.reader(csv_file)
-        header = next(reader)
+# Columns of a knob CSV that are not the value of a device
+CSV_KNOB_COLUMNS = ('Guid', 'Knob', 'Binary', 'Help')
+
 
-        knob_index = 0
-        value_index = 0
-        guid_index = 0
+# Streams the rows of a knob CSV, one at a time. A knob CSV has a Guid and a Knob column and a value column per
+# device: one named Value in the layout of write_csv, or one named after each device in the layout of
+# write_device_csv. A guid of '*' repeats the guid of the previous row, and blank rows are skipped
+class KnobCsvReader:
+    def __init__(self, csv_file):
+        self._reader = csv.reader(csv_file)
+        header = next(self._reader, [])
 
         try:
-            guid_index = header.index('Guid')
+            self._guid_index = header.index('Guid')
         except ValueError:
             raise ParseError("CSV is missing 'Guid' column header. Ensure CSV was generated with latest changes.")
 
         try:
-            knob_index = header.index('Knob')
+            self._knob_index = header.index('Knob')
         except ValueError:
             raise ParseError("CSV is missing 'Knob' column header")
 
-        try:
-            value_index = header.index('Value')
-        except ValueError:
-            raise ParseError("CSV is missing 'Value' column header")
+        # the name and column index of each device
+        self.devices = [(name, index) for (index, name) in enumerate(header) if name not in CSV_KNOB_COLUMNS]
+
+    # Iterates over the (guid, knob name, value strings) of each row, with the value string of each device in the
+    # order of devices. A row shorter than the header has empty value strings
+    def __iter__(self):
+        guid = None
+        for row in self._reader:
+            if not any(cell.strip() for cell in row):
+                continue
 
-        for row in reader:
-            read_guid = row[guid_index]
+            read_guid = row[self._guid_index]
             if read_guid != '*':
                 guid = read_guid
-            knob_name = row[knob_index]
-            knob_value_string = row[value_index]
 
-            knob = schema.get_knob(guid, knob_name)
-            if knob is not None:
-                knob.value = knob.format.string_to_object(knob_value_string)
-                updated_knobs += 1
+            yield guid, row[self._knob_index], [row[index] if index < len(row) else '' for (_, index) in self.devices]
+
+
+# Iterates over the (guid, knob name, value string) of each row of a knob CSV in the layout of write_csv
+def read_csv_rows(csv_path):
+    with open(csv_path, 'r', newline='') as csv_file:
+        reader = KnobCsvReader(csv_file)
+        value_indices = [device for (device, (name, _)) in enumerate(reader.devices) if name == 'Value']
+        if len(value_indices) == 0:
+            raise ParseError("CSV is missing 'Value' column header")
+
+        value_index = value_indices[0]
+        for guid, knob_name, value_strings in reader:
+            yield guid, knob_name, value_strings[value_index]
+
+
+# Set the knob values of a schema to the rows of a knob CSV, set on top of the current values
+# return the count of the rows of knobs in the schema
+def read_csv(schema, csv_path):
+    updated_knobs = 0
+    values = KnobValueBuilder()
+    for guid, knob_name, knob_value_string in read_csv_rows(csv_path):
+        subknob = schema.get_knob(guid, knob_name)
+        if subknob is not None:
+            # the current value is only copied by the builder, so skip the copy the value property makes
+            values.set(subknob, subknob.format.string_to_object(knob_value_string), subknob.knob._value)
+            updated_knobs += 1
+
+    # the values are bounds checked and owned by the builder
+    for (knob, value) in values.items():
+        knob._value = value
     return updated_knobs
 
 
+# An immutable set of knob overrides, e.g. read from a profile CSV. A profile is kept apart from the knob values of
+# the schema, so that it can be loaded once and then used for any number of headers and binaries, and as it only
+# refers to knobs by namespace and name, it can be shared with other processes
+class Profile:
+    def __init__(self, name, overrides, path=""):
+        self._name = name
+        self._path = path
+        # (namespace, name) -> value of every overridden knob, in the order given
+        self._overrides = OrderedDict((key, copy.deepcopy(value)) for key, value in overrides)
+
+    @property
+    def name(self):
+        return self._name
+
+    @property
+    def path(self):
+        return self._path
+
+    # Load a profile from a knob CSV, whose rows can override whole knobs or members of them. The profile is named
+    # after the CSV file unless a name is given
+    def load(schema, csv_path, name=None):
+        values = KnobValueBuilder()
+        for guid, knob_name, value_string in read_csv_rows(csv_path):
+            subknob = schema.get_knob(guid, knob_name)
+            if subknob is not None:
+                values.set(subknob, subknob.format.string_to_object(value_string))
+
+        if name is None:
+            name = os.path.splitext(os.path.basename(csv_path))[0]
+
+        return Profile.from_values(schema, name, values.items(), csv_path)
+
+    # Create a profile of the (knob, value) given, with the overrides in schema order, which is the order they are
+    # generated in
+    def from_values(schema, name, knob_values, path=""):
+        values = {Schema._index_key(knob.namespace, knob.name): value for (knob, value) in knob_values}
+        overrides = []
+        for knob in schema.knobs:
+            key = Schema._index_key(knob.namespace, knob.name)
+            if key in values:
+                overrides.append((key, values[key]))
+
+        return Profile(name, overrides, path)
+
+    # Create a profile of the knobs stored in a list of UEFI variables, e.g. read from the variable list dump of
+    # a device. Variables that are not knobs of the schema are ignored
+    def from_variables(schema, name, variables, path=""):
+        knob_values = []
+        for variable in variables:
+            knob = schema.get_root_knob(variable.guid, variable.name)
+            if knob is not None:
+                knob_values.append((knob, knob.format.binary_to_object(variable.data)))
+
+        return Profile.from_values(schema, name, knob_values, path)
+
+    # Returns a copy of the value of a knob in this profile, or None if the profile does not override it
+    def get_value(self, knob):
+        return copy.deepcopy(self._overrides.get(Schema._index_key(knob.namespace, knob.name)))
+
+    # Returns the (knob, value) of every knob of the schema overridden by this profile, in schema order
+    def get_overrides(self, schema):
+        overrides = []
+        for knob in schema.knobs:
+            value = self._overrides.get(Schema._index_key(knob.namespace, knob.name))
+            if value is not None:
+                overrides.append((knob, copy.deepcopy(value)))
+        return overrides
+
+    # Returns the (knob, value) of every knob of the schema, with the value of this profile or the knob default
+    def get_values(self, schema):
+        values = []
+        for knob in schema.knobs:
+            value = self._overrides.get(Schema._index_key(knob.namespace, knob.name))
+            values.append((knob, knob.default if value is None else copy.deepcopy(value)))
+        return values
+
+    # Set the knob values of a schema to the overrides of this profile, and every other knob to None
+    def apply(self, schema):
+        for knob in schema.knobs:
+            knob.value = self.get_value(knob)
+
+    # Returns the variable list of every knob of the schema with the values of this profile applied to the defaults
+    def to_binary(self, schema, compressed=False):
+        buffer = create_knob_vlist_buffer(self.get_values(schema))
+        if compressed:
+            return compress_vlist(buffer)
+        return buffer
+
+
+# The schema the profiles of a worker process are loaded against
+_profile_schema = None
+
+
+def _init_profile_worker(schema):
+    global _profile_schema
+    _profile_schema = schema
+
+
+def _load_profile(csv_path, name):
+    return Profile.load(_profile_schema, csv_path, name)
+
+
+# Load the profiles of a list of knob CSVs against a schema. With more than one CSV, the CSVs are parsed in parallel
+# in a pool of worker processes, that are each handed the schema once. The profiles are returned in the order of
+# the CSVs, and names can be given for each of them
+def load_profiles(schema, csv_paths, names=None, max_workers=None):
+    if names is None:
+        names = [None] * len(csv_paths)
+
+    if len(csv_paths) <= 1:
+        return [Profile.load(schema, csv_path, name) for csv_path, name in zip(csv_paths, names)]
+
+    with ProcessPoolExecutor(max_workers=max_workers, initializer=_init_profile_worker,
+                             initargs=(schema,)) as executor:
+        return list(executor.map(_load_profile, csv_paths, names))
+
+
+# Load a profile for each device column of a knob CSV in the layout of write_device_csv, in a single pass over the
+# CSV. The profiles are named after their column, and an empty cell leaves the knob of that device to its default
+# return the profiles in the order of the columns
+def load_device_profiles(schema, csv_path):
+    with open(csv_path, 'r', newline='') as csv_file:
+        reader = KnobCsvReader(csv_file)
+        builders = [KnobValueBuilder() for _ in reader.devices]
+        for guid, knob_name, value_strings in reader:
+            subknob = schema.get_knob(guid, knob_name)
+            if subknob is None:
+                continue
+
+            for (value_string, builder) in zip(value_strings, builders):
+                if value_string.strip() != '':
+                    builder.set(subknob, subknob.format.string_to_object(value_string))
+
+        return [Profile.from_values(schema, name, builder.items(), csv_path)
+                for ((name, _), builder) in zip(reader.devices, builders)]
+
+
+# Writes the knob values of a schema to a CSV, one row at a time. Unless full is set, only the knobs whose value
+# differs from their default are written, and with subknobs only their members that differ from the default
 def write_csv(schema, csv_path, full, subknobs=True):
     with open(csv_path, 'w', newline='') as csv_file:
         writer = csv.writer(csv_file)
-        guid = None
+        writer.writerow(['Guid', 'Knob', 'Value', 'Binary', 'Help'])
+
+        # the values are only read, so skip the copy the value property makes
+        knob_values = ((knob, knob._value) for knob in schema.knobs if full or knob._value != knob._default)
+        write_knob_csv_rows(writer, knob_values, subknobs, not full)
+
+
+# Writes a CSV row for each (knob, value) given, and with subknobs a row for each of its members. The members are
+# looked up in the knob value by their decoded path, so the value is not copied for each row. With changed_only,
+# the members whose value is their default are left out
+def write_knob_csv_rows(writer, knob_values, subknobs=False, changed_only=False):
+    guid = None
+    for knob, value in knob_values:
+        for subknob in knob.subknobs if subknobs else knob.subknobs[:1]:
+            member = get_subknob_value(value, subknob.path)
+            if changed_only and member == get_subknob_value(knob._default, subknob.path):
+                continue
+
+            # We print the guid on the first row and then only print
+            # another guid if it changes
+            writer.writerow([
+                '*' if knob.namespace == guid else knob.namespace,
+                subknob.name,
+                subknob.format.object_to_string(member),
+                subknob.format.object_to_binary(member).hex(" "),
+                subknob.help])
+            guid = knob.namespace
+
+
+# Writes the knob values of a list of profiles, e.g. one per device, to a CSV with a value column named after each
+# profile, which load_device_profiles reads back in a single pass. A knob a profile does not override has its
+# default value. Unless full is set, only the knobs, or with subknobs their members, that differ from their default
+# in at least one profile are written
+def write_device_csv(schema, csv_path, profiles, full=False, subknobs=True):
+    names = [profile.name for profile in profiles]
+    for name in names:
+        if name in CSV_KNOB_COLUMNS or name == '' or names.count(name) > 1:
+            raise Exception("'{}' can't be the name of a device column".format(name))
 
-        # get_delta_vlist is a tuple of name_list, var_list
-        name_list = get_delta_vlist(schema)[0]
-
-        if subknobs:
-            writer.writerow(['Guid', 'Knob', 'Value', 'Binary', 'Help'])
-            for subknob in schema.subknobs:
-                if full or subknob.name in name_list:
-                    binary = subknob.format.object_to_binary(subknob.value)
-                    string_binary = " ".join(map("%2.2x".__mod__, binary))
-                    if subknob.namespace != guid:
-                        # We print the guid on the first row and then only print
-                        # another guid if it changes
-                        guid = subknob.namespace
-
-                        writer.writerow([
-                            guid,
-                            subknob.name,
-                            subknob.format.object_to_string(subknob.value),
-                            string_binary,
-                            subknob.help])
-                    else:
-                        writer.writerow([
-                            '*',
-                            subknob.name,
-                            subknob.format.object_to_string(subknob.value),
-                            string_binary,
-                            subknob.help])
-        else:
-            writer.writerow(['Guid', 'Knob', 'Value', 'Binary', 'Help'])
-            for knob in schema.knobs:
-                if full or knob.name in name_list:
-                    binary = knob.format.object_to_binary(knob.value)
-                    string_binary = " ".join(map("%2.2x".__mod__, binary))
-                    if knob.namespace != guid:
-                        # We print the guid on the first row and then only print
-                        # another guid if it changes
-                        guid = knob.namespace
-
-                        writer.writerow([
-                            guid,
-                            knob.name,
-                            knob.format.object_to_string(knob.value),
-                            string_binary,
-                            knob.help])
-                    else:
-                        writer.writerow([
-                            '*',
-                            knob.name,
-                            knob.format.object_to_string(knob.value),
-                            string_binary,
-                            knob.help])
+    with open(csv_path, 'w', newline='') as csv_file:
+        writer = csv.writer(csv_file)
+        writer.writerow(['Guid', 'Knob'] + names + ['Help'])
 
+        guid = None
+        for knob in schema.knobs:
+            # the overrides are only read, so skip the copy Profile.get_value makes
+            key = Schema._index_key(knob.namespace, knob.name)
+            values = [profile._overrides.get(key, knob._default) for profile in profiles]
+            if not full and all(value == knob._default for value in values):
+                continue
+
+            for subknob in knob.subknobs if subknobs else knob.subknobs[:1]:
+                members = [get_subknob_value(value, subknob.path) for value in values]
+                default = get_subknob_value(knob._default, subknob.path)
+                if not full and all(member == default for member in members):
+                    continue
+
+                row = ['*' if knob.namespace == guid else knob.namespace, subknob.name]
+                row += [subknob.format.object_to_string(member) for member in members]
+                row.append(subknob.help)
+                writer.writerow(row)
+                guid = knob.namespace
+
+
+# Writes the knobs of a list of knob deltas with their new values to a CSV, which can be read back as a
+# profile. The knobs whose variable is missing from the new list have no value and are left out
+def write_knob_delta_csv(csv_path, knob_deltas):
+    with open(csv_path, 'w', newline='') as csv_file:
+        writer = csv.writer(csv_file)
+        writer.writerow(['Guid', 'Knob', 'Value', 'Binary', 'Help'])
+        write_knob_csv_rows(writer, [(knob, value) for (knob, _, value) in knob_deltas if value is not None])
 
-def write_vlist(schema, vlist_path):
+
+def write_vlist(schema, vlist_path, aligned=False, compressed=False):
     with open(vlist_path, 'wb') as vlist_file:
-        buf = vlist_to_binary(schema)
+        if aligned:
+            buf = vlist_to_aligned_binary(schema)
+        else:
+            buf = vlist_to_binary(schema, compressed)
         vlist_file.write(buf)
 
 
+
+def write_svd_binary(schema, packet_path, version=1, lsv=1, compressed=False):
+    with open(packet_path, 'wb') as packet_file:
+        packet_file.write(create_binary_svd_packet(vlist_to_binary(schema, compressed), version, lsv))
+
+
 def usage():
     print("Commands:\n")
     print("  write_vl <schema.xml> [<values.csv>] <blob.vl>")
+    print("  write_vl_aligned <schema.xml> [<values.csv>] <blob.vl>")
+    print("  write_vl_compressed <schema.xml> [<values.csv>] <blob.vl>")
     print("  write_csv <schema.xml> [<blob.vl>] <values.csv>")
+    print("  write_device_csv <schema.xml> <blob.vl> [<blob.vl> ...] <values.csv>")
+    print("  write_device_vl <schema.xml> <values.csv> <directory>")
+    print("  write_svd_bin <schema.xml> [<values.csv>] <packet.svd>")
+    print("  write_svd_bin_compressed <schema.xml> [<values.csv>] <packet.svd>")
+    print("  svd_to_bin <settings.svd> <packet.svd>")
     print("")
     print("schema.xml : An XML with the definition of a set of known")
     print("             UEFI variables ('knobs') and types to interpret them")
     print("blob.vl : file is a binary list of UEFI variables in the")
-    print("          format used by the EFI 'dmpstore' command")
-    print("values.csv : file is a text list of knobs")
+    print("          format used by the EFI 'dmpstore' command, or in the")
+    print("          aligned variable list format for write_vl_aligned, or")
+    print("          in the compressed variable list format for write_vl_compressed")
+    print("values.csv : file is a text list of knobs, with a value column per")
+    print("             device for write_device_csv and write_device_vl. Devices")
+    print("             are named after their blob.vl, and a <device>.vl is")
+    print("             written to the directory for each of them")
+    print("settings.svd : file is a XML settings packet")
+    print("packet.svd : file is an unsigned binary settings packet. Once signed by")
+    print("             GenerateSettingsPacketData.py --BinarySvdFile, ConfApp accepts")
+    print("             it in place of a XML settings packet. The variable list")
+    print("             it carries is compressed for write_svd_bin_compressed")
 
 
 def main():
@@ -1290,7 +2382,9 @@ def main():
         sys.exit(1)
         return
 
-    if sys.argv[1].lower() == "write_vl":
+    if sys.argv[1].lower() in ("write_vl", "write_vl_aligned", "write_vl_compressed"):
+        aligned = sys.argv[1].lower() == "write_vl_aligned"
+        compressed = sys.argv[1].lower() == "write_vl_compressed"
         if len(sys.argv) == 4:
             schema_path = sys.argv[2]
             vlist_path = sys.argv[3]
@@ -1303,7 +2397,7 @@ def main():
                 knob.value = knob.default
 
             # Write the vlist
-            write_vlist(schema, vlist_path)
+            write_vlist(schema, vlist_path, aligned, compressed)
         elif len(sys.argv) == 5:
             schema_path = sys.argv[2]
             values_path = sys.argv[3]
@@ -1316,7 +2410,7 @@ def main():
             read_csv(schema, values_path)
 
             # Write the vlist
-            write_vlist(schema, vlist_path)
+            write_vlist(schema, vlist_path, aligned, compressed)
         else:
             usage()
             sys.stderr.write('Invalid number of arguments.\n')
@@ -1345,7 +2439,7 @@ def main():
             schema = Schema.load(schema_path)
 
             # Read values from the vlist
-            read_vlist(schema, vlist_path)
+            uefi_variables_to_knobs(schema, read_vlist(vlist_path))
 
             # Write the full vlist CSV with complete knobs
             write_csv(schema, csv_path, True, False)
@@ -1355,6 +2449,94 @@ def main():
             sys.exit(1)
             return
 
+    if sys.argv[1].lower() == "write_device_csv":
+        if len(sys.argv) >= 5:
+            schema_path = sys.argv[2]
+            vlist_paths = sys.argv[3:-1]
+            csv_path = sys.argv[-1]
+
+            # Load the schema
+            schema = Schema.load(schema_path)
+
+            # Read the knobs of each device from its vlist
+            profiles = [Profile.from_variables(schema, os.path.splitext(os.path.basename(vlist_path))[0],
+                                               read_vlist(vlist_path), vlist_path)
+                        for vlist_path in vlist_paths]
+
+            # Write the knobs that differ on any device, with complete knobs
+            write_device_csv(schema, csv_path, profiles, False, False)
+        else:
+            usage()
+            sys.stderr.write('Invalid number of arguments.\n')
+            sys.exit(1)
+            return
+
+    if sys.argv[1].lower() == "write_device_vl":
+        if len(sys.argv) == 5:
+            schema_path = sys.argv[2]
+            csv_path = sys.argv[3]
+            vlist_dir = sys.argv[4]
+
+            # Load the schema
+            schema = Schema.load(schema_path)
+
+            # Write the vlist of each device, with its values applied to the defaults
+            os.makedirs(vlist_dir, exist_ok=True)
+            for profile in load_device_profiles(schema, csv_path):
+                with open(os.path.join(vlist_dir, profile.name + ".vl"), 'wb') as vlist_file:
+                    vlist_file.write(profile.to_binary(schema))
+        else:
+            usage()
+            sys.stderr.write('Invalid number of arguments.\n')
+            sys.exit(1)
+            return
+
+    if sys.argv[1].lower() in ("write_svd_bin", "write_svd_bin_compressed"):
+        compressed = sys.argv[1].lower() == "write_svd_bin_compressed"
+        if len(sys.argv) == 4:
+            schema_path = sys.argv[2]
+            packet_path = sys.argv[3]
+
+            # Load the schema
+            schema = Schema.load(schema_path)
+
+            # Assign all values to their defaults
+            for knob in schema.knobs:
+                knob.value = knob.default
+
+            # Write the binary settings packet
+            write_svd_binary(schema, packet_path, compressed=compressed)
+        elif len(sys.argv) == 5:
+            schema_path = sys.argv[2]
+            values_path = sys.argv[3]
+            packet_path = sys.argv[4]
+
+            # Load the schema
+            schema = Schema.load(schema_path)
+
+            # Read values from the CSV
+            read_csv(schema, values_path)
+
+            # Write the binary settings packet
+            write_svd_binary(schema, packet_path, compressed=compressed)
+        else:
+            usage()
+            sys.stderr.write('Invalid number of arguments.\n')
+            sys.exit(1)
+            return
+
+    if sys.argv[1].lower() == "svd_to_bin":
+        if len(sys.argv) == 4:
+            with open(sys.argv[2], 'r') as svd_file:
+                packet = svd_to_binary_packet(svd_file.read())
+
+            with open(sys.argv[3], 'wb') as packet_file:
+                packet_file.write(packet)
+        else:
+            usage()
+            sys.stderr.write('Invalid number of arguments.\n')
+            sys.exit(1)
+            return
 
 if __name__ == '__main__':
     sys.exit(main())
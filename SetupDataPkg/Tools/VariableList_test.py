@@ -5,11 +5,58 @@
 #
 #
 
+import base64
+import os
+import pickle
+import tempfile
+import uuid
 import unittest
+from unittest import mock
 import pytest
 from xml.dom.minidom import parseString
 
-from VariableList import Schema, ParseError, InvalidNameError, InvalidRangeError
+from VariableList import (
+    Schema,
+    ParseError,
+    InvalidNameError,
+    InvalidRangeError,
+    vlist_to_binary,
+    vlist_to_aligned_binary,
+    read_vlist_from_buffer,
+    read_vlist,
+    iter_vlist,
+    Profile,
+    load_profiles,
+    load_device_profiles,
+    read_csv,
+    write_csv,
+    write_device_csv,
+    UEFIVariable,
+    create_vlist_buffer,
+    diff_vlists,
+    decode_knob_deltas,
+    create_binary_svd_packet,
+    read_binary_svd_packet,
+    split_binary_svd_packet,
+    sign_binary_svd_packet,
+    svd_to_binary_packet,
+    ALIGNED_VLIST_HEADER,
+    ALIGNED_VLIST_ENTRY,
+    ALIGNED_VLIST_DATA_ALIGNMENT,
+    compress_vlist,
+    decompress_vlist,
+    lz_compress,
+    lz_decompress,
+    get_compressed_vlist_crc,
+    COMPRESSED_VLIST_HEADER,
+    COMPRESSED_VLIST_CRC_OFFSET,
+    get_schema_cache_path,
+    get_schema_cache_dir,
+    SCHEMA_CACHE_KEY_NAME,
+    SCHEMA_CACHE_MAC_SIZE,
+    SCHEMA_XSD_PATH,
+    SCHEMA_CACHE_DIR_ENV
+)
 
 
 class SchemaParseUnitTests(unittest.TestCase):
@@ -549,6 +596,468 @@ class SchemaParseUnitTests(unittest.TestCase):
         with pytest.raises(InvalidRangeError):
             Schema(dom)
 
+    def test_aligned_vlist_round_trip(self):
+        schema = Schema.parse(self.schemaTemplate)
+        for knob in schema.knobs:
+            knob.value = knob.default
+
+        packed = read_vlist_from_buffer(vlist_to_binary(schema))
+        aligned_buffer = vlist_to_aligned_binary(schema)
+        aligned = read_vlist_from_buffer(aligned_buffer)
+
+        self.assertEqual(len(packed), len(aligned))
+        for packed_var, aligned_var in zip(packed, aligned):
+            self.assertEqual(packed_var.name, aligned_var.name)
+            self.assertEqual(packed_var.guid, aligned_var.guid)
+            self.assertEqual(packed_var.attributes, aligned_var.attributes)
+            self.assertEqual(packed_var.data, aligned_var.data)
+
+        # Every value has to start on an aligned offset from the start of the buffer
+        header = ALIGNED_VLIST_HEADER.unpack_from(aligned_buffer, 0)
+        data_offset = header[6]
+        for index in range(len(aligned)):
+            entry = ALIGNED_VLIST_ENTRY.unpack_from(aligned_buffer, header[2] + ALIGNED_VLIST_ENTRY.size * index)
+            self.assertEqual((data_offset + entry[4]) % ALIGNED_VLIST_DATA_ALIGNMENT, 0)
+
+        # Any corruption of the descriptors, names or data must be caught
+        corrupted = bytearray(aligned_buffer)
+        corrupted[-1] ^= 0xFF
+        with pytest.raises(Exception):
+            read_vlist_from_buffer(bytes(corrupted))
+
+    def test_compressed_vlist_round_trip(self):
+        schema = Schema.parse(self.schemaTemplate)
+        for knob in schema.knobs:
+            knob.value = knob.default
+
+        packed_buffer = vlist_to_binary(schema)
+        compressed_buffer = vlist_to_binary(schema, compressed=True)
+        self.assertLess(len(compressed_buffer), len(packed_buffer))
+
+        # The compressed list expands back to the exact packed list, and reads the same
+        self.assertEqual(decompress_vlist(compressed_buffer), packed_buffer)
+        packed = read_vlist_from_buffer(packed_buffer)
+        compressed = read_vlist_from_buffer(compressed_buffer)
+        self.assertEqual(len(packed), len(compressed))
+        for packed_var, compressed_var in zip(packed, compressed):
+            self.assertEqual(packed_var.name, compressed_var.name)
+            self.assertEqual(packed_var.guid, compressed_var.guid)
+            self.assertEqual(packed_var.attributes, compressed_var.attributes)
+            self.assertEqual(packed_var.data, compressed_var.data)
+
+        # The aligned format compresses to the same list
+        self.assertEqual(compress_vlist(vlist_to_aligned_binary(schema)), compressed_buffer)
+
+        # Runs and repeats within a block, including matches overlapping their output
+        for data in [b'', b'\0', b'\0' * 1000, b'abc' * 100 + bytes(range(256)), os.urandom(300)]:
+            block = lz_compress(data)
+            self.assertEqual(lz_decompress(block, 0, len(data)), (data, len(block)))
+
+        # Any corruption of the header, dictionary or records must be caught
+        for index in [COMPRESSED_VLIST_HEADER.size - 12, -1, len(compressed_buffer) // 2]:
+            corrupted = bytearray(compressed_buffer)
+            corrupted[index] ^= 0xFF
+            with pytest.raises(Exception):
+                read_vlist_from_buffer(bytes(corrupted))
+
+        # Sizes larger than the whole packed list are rejected even with a valid CRC
+        fields = list(COMPRESSED_VLIST_HEADER.unpack_from(compressed_buffer, 0))
+        for field in [5, 6]:
+            oversized = list(fields)
+            oversized[field] = fields[7] + 1
+            corrupted = bytearray(COMPRESSED_VLIST_HEADER.pack(*oversized)) + \
+                compressed_buffer[COMPRESSED_VLIST_HEADER.size:]
+            corrupted[COMPRESSED_VLIST_CRC_OFFSET:COMPRESSED_VLIST_HEADER.size] = \
+                get_compressed_vlist_crc(corrupted).to_bytes(4, "little")
+            with pytest.raises(Exception, match="does not fit"):
+                read_vlist_from_buffer(bytes(corrupted))
+
+        with pytest.raises(Exception):
+            read_vlist_from_buffer(compressed_buffer + b'\0')
+
+
+    def test_binary_svd_packet(self):
+        schema = Schema.parse(self.schemaTemplate)
+        for knob in schema.knobs:
+            knob.value = knob.default
+
+        vlist = vlist_to_binary(schema)
+        packet = create_binary_svd_packet(vlist, 3, 2)
+        self.assertEqual(read_binary_svd_packet(packet), (3, 2, vlist))
+
+        # The same variables wrapped in a XML SVD convert to the same packet
+        settings = "".join(
+            "<Setting><Id>{}</Id><Value>{}</Value></Setting>".format(name, base64.b64encode(value).decode("utf-8"))
+            for name, value in [("empty", b''), ("all", vlist)]
+        )
+        svd = '<?xml version="1.0" encoding="utf-8"?><SettingsPacket xmlns="urn:UefiSettings-Schema">' \
+              "<Version>3</Version><LowestSupportedVersion>2</LowestSupportedVersion>" \
+              "<Settings>{}</Settings></SettingsPacket>".format(settings)
+        self.assertEqual(svd_to_binary_packet(svd), packet)
+
+        # Dropping the Base64 and XML wrapping has to make the packet smaller than the SVD
+        self.assertLess(len(packet), len(svd))
+
+        corrupted = bytearray(packet)
+        corrupted[-1] ^= 0xFF
+        with pytest.raises(Exception):
+            read_binary_svd_packet(bytes(corrupted))
+
+        with pytest.raises(Exception):
+            read_binary_svd_packet(packet[:-1])
+
+        with pytest.raises(Exception):
+            create_binary_svd_packet(vlist, 1, 2)
+
+        # The signature follows the variable list and only wraps the detached PKCS7 data, the CRC32 still applies
+        pkcs7 = bytes(range(64))
+        signed = sign_binary_svd_packet(packet, pkcs7)
+        self.assertEqual(split_binary_svd_packet(packet), (packet, None))
+        self.assertEqual(split_binary_svd_packet(signed), (packet, pkcs7))
+        self.assertEqual(read_binary_svd_packet(signed), (3, 2, vlist))
+        self.assertEqual(len(signed), len(packet) + 24 + len(pkcs7))
+
+        with pytest.raises(Exception):
+            sign_binary_svd_packet(signed, pkcs7)
+
+        with pytest.raises(Exception):
+            split_binary_svd_packet(signed[:-1])
+
+        corrupted = bytearray(signed)
+        corrupted[len(packet) + 8] ^= 0xFF
+        with pytest.raises(Exception):
+            split_binary_svd_packet(bytes(corrupted))
+
+    def test_compiled_binary_layout(self):
+        schema = Schema.parse(self.schemaTemplate)
+        for knob in schema.knobs:
+            binary = knob.format.object_to_binary(knob.default)
+            self.assertEqual(len(binary), knob.format.size_in_bytes())
+            self.assertEqual(knob.format.binary_to_object(binary), knob.default)
+
+            # Packing in place gives the same bytes at any offset of a larger buffer
+            buffer = bytearray(len(binary) + 3)
+            knob.format.pack_into(buffer, 3, knob.default)
+            self.assertEqual(bytes(buffer[3:]), binary)
+
+        # Nested structs and arrays are all covered by the one compiled layout of the knob
+        knob = schema.get_root_knob("FE3ED49F-B173-41ED-9076-356661D46A42", "COMPLEX_KNOB2")
+        value = knob.default
+        value["children"][1]["data"][0] = 0x5A
+        binary = knob.format.object_to_binary(value)
+        self.assertEqual(knob.format.binary_to_object(binary), value)
+        self.assertEqual(knob.format.binary_struct.size, len(binary))
+
+        value["children"][1]["data"].append(0)
+        with pytest.raises(ParseError):
+            knob.format.object_to_binary(value)
+
+    def test_get_knob_index(self):
+        schema = Schema.parse(self.schemaTemplate)
+        namespace = "FE3ED49F-B173-41ED-9076-356661D46A42"
+
+        # Every subknob path is found, with a guid string in any case or a UUID
+        for subknob in schema.subknobs:
+            found = schema.get_knob(subknob.knob.namespace.lower(), subknob.name)
+            self.assertEqual(found.name, subknob.name)
+            self.assertIs(found.knob, subknob.knob)
+
+        knob = schema.get_knob(uuid.UUID(namespace), "COMPLEX_KNOB2.children[0].data[1]")
+        self.assertEqual(knob.knob.name, "COMPLEX_KNOB2")
+        self.assertIs(schema.get_root_knob(namespace, "COMPLEX_KNOB2"), knob.knob)
+        self.assertIsNone(schema.get_root_knob(namespace, "COMPLEX_KNOB2.counter"))
+        self.assertIsNone(schema.get_knob(namespace, "COMPLEX_KNOB2.missing"))
+        self.assertIsNone(schema.get_knob("00000000-0000-0000-0000-000000000000", "k_uint8_t"))
+
+        # Knobs added later are found too
+        other = Schema(self.insert_xml("""
+<Knobs namespace="{D3B7C9A1-2F4E-4C8B-9E1A-5C6D7E8F9A0B}">
+    <Knob type="uint8_t" name="k_uint8_t" default="3" />
+</Knobs>"""))
+        schema.add_knob(other.knobs[-1])
+        self.assertIs(schema.get_root_knob("D3B7C9A1-2F4E-4C8B-9E1A-5C6D7E8F9A0B", "k_uint8_t"), other.knobs[-1])
+        self.assertIsNot(schema.get_root_knob(namespace, "k_uint8_t"), other.knobs[-1])
+        self.assertIn(other.knobs[-1].subknobs[0], schema.subknobs)
+
+    def test_iter_vlist(self):
+        schema = Schema.parse(self.schemaTemplate)
+        for knob in schema.knobs:
+            knob.value = knob.default
+
+        vlist = vlist_to_binary(schema)
+        variables = read_vlist_from_buffer(vlist)
+        self.assertEqual(len(variables), len(schema.knobs))
+        for knob, variable in zip(schema.knobs, variables):
+            self.assertEqual(variable.name, knob.name)
+            self.assertEqual(str(variable.guid).upper(), str(knob.namespace).upper())
+            self.assertEqual(variable.data, knob.format.object_to_binary(knob.default))
+
+        # Reading the memory mapped file gives the same variables
+        with tempfile.TemporaryDirectory() as temp_dir:
+            vlist_path = os.path.join(temp_dir, "test.vl")
+            with open(vlist_path, "wb") as vlist_file:
+                vlist_file.write(vlist)
+            self.assertEqual([v.data for v in read_vlist(vlist_path)], [v.data for v in variables])
+
+            with open(vlist_path, "wb"):
+                pass
+            self.assertEqual(read_vlist(vlist_path), [])
+
+        # Entries are decoded lazily, so the entries before a corrupted one are still returned
+        corrupted = bytearray(vlist)
+        corrupted[-1] ^= 0xFF
+        iterator = iter_vlist(corrupted)
+        self.assertEqual(next(iterator).name, variables[0].name)
+        with pytest.raises(Exception):
+            list(iterator)
+
+        # Truncated entries must be caught rather than read past the end of the buffer
+        with pytest.raises(Exception):
+            read_vlist_from_buffer(vlist[:-1])
+
+        with pytest.raises(Exception):
+            read_vlist_from_buffer(vlist[:6])
+
+    def test_profile(self):
+        schema = Schema.parse(self.schemaTemplate)
+        namespace = "FE3ED49F-B173-41ED-9076-356661D46A42"
+
+        with tempfile.TemporaryDirectory() as temp_dir:
+            csv_paths = []
+            for name, counter in [("First", 3), ("Second", 4)]:
+                csv_path = os.path.join(temp_dir, name + ".csv")
+                with open(csv_path, "w", newline="") as csv_file:
+                    csv_file.write("Guid,Knob,Value,Binary,Help\n")
+                    csv_file.write("{},COMPLEX_KNOB2.counter,{},,\n".format(namespace, counter))
+                    csv_file.write("*,COMPLEX_KNOB2.children[1].data[0],60,,\n")
+                    csv_file.write("*,k_uint8_t,7,,\n")
+                csv_paths.append(csv_path)
+
+            profile = Profile.load(schema, csv_paths[0])
+            profiles = load_profiles(schema, csv_paths)
+
+        self.assertEqual(profile.name, "First")
+        self.assertEqual([p.name for p in profiles], ["First", "Second"])
+
+        # Loading a profile leaves the knob values of the schema untouched
+        for knob in schema.knobs:
+            self.assertIsNone(knob.value)
+
+        # Subknob rows are merged into the knob default, in schema order
+        overrides = profile.get_overrides(schema)
+        self.assertEqual([knob.name for (knob, _) in overrides], ["k_uint8_t", "COMPLEX_KNOB2"])
+        complex_knob = schema.get_root_knob(namespace, "COMPLEX_KNOB2")
+        value = profile.get_value(complex_knob)
+        self.assertEqual(value["counter"], 3)
+        self.assertEqual(value["children"][0]["data"][0], 1)
+        self.assertEqual(value["children"][1]["data"][0], 60)
+        self.assertEqual(profiles[1].get_value(complex_knob)["counter"], 4)
+
+        # The values handed out are copies
+        value["counter"] = 9
+        self.assertEqual(profile.get_value(complex_knob)["counter"], 3)
+
+        # The binary of a profile matches the schema with the profile applied over the defaults
+        for knob in schema.knobs:
+            override = profile.get_value(knob)
+            knob.value = knob.default if override is None else override
+        self.assertEqual(profile.to_binary(schema), vlist_to_binary(schema))
+
+        profile.apply(schema)
+        self.assertEqual(schema.get_root_knob(namespace, "k_uint8_t").value, 7)
+        self.assertIsNone(schema.get_root_knob(namespace, "k_s_array_t").value)
+
+    def test_csv_round_trip(self):
+        schema = Schema.parse(self.schemaTemplate)
+        namespace = "FE3ED49F-B173-41ED-9076-356661D46A42"
+        for knob in schema.knobs:
+            knob.value = knob.default
+
+        complex_knob = schema.get_root_knob(namespace, "COMPLEX_KNOB2")
+        value = complex_knob.value
+        value["children"][1]["data"][0] = 60
+        complex_knob.value = value
+
+        with tempfile.TemporaryDirectory() as temp_dir:
+            full_path = os.path.join(temp_dir, "full.csv")
+            delta_path = os.path.join(temp_dir, "delta.csv")
+            write_csv(schema, full_path, True, subknobs=True)
+            write_csv(schema, delta_path, False, subknobs=True)
+
+            with open(delta_path, "r") as csv_file:
+                delta_rows = csv_file.read().splitlines()
+
+            # A blank row is skipped
+            with open(delta_path, "a", newline="") as csv_file:
+                csv_file.write("\r\n,,,,\r\n")
+
+            # The delta only holds the members of the changed knob that changed
+            self.assertEqual(
+                [row.split(",")[1] for row in delta_rows[1:]],
+                ["COMPLEX_KNOB2", "COMPLEX_KNOB2", "COMPLEX_KNOB2.children", "COMPLEX_KNOB2.children[1]",
+                 "COMPLEX_KNOB2.children[1].data", "COMPLEX_KNOB2.children[1].data[0]"])
+            self.assertEqual(delta_rows[1].split(",")[0], namespace)
+            self.assertTrue(all(row.startswith("*,") for row in delta_rows[2:]))
+
+            expected = vlist_to_binary(schema)
+            for csv_path in [full_path, delta_path]:
+                other = Schema.parse(self.schemaTemplate)
+                for knob in other.knobs:
+                    knob.value = knob.default
+                self.assertGreater(read_csv(other, csv_path), 0)
+                self.assertEqual(vlist_to_binary(other), expected)
+
+            # The members of a row are set on top of the current value of the knob
+            other = Schema.parse(self.schemaTemplate)
+            other.get_root_knob(namespace, "COMPLEX_KNOB2").value = value
+            with open(delta_path, "w", newline="") as csv_file:
+                csv_file.write("Guid,Knob,Value\n{},COMPLEX_KNOB2.counter,5\n".format(namespace))
+            self.assertEqual(read_csv(other, delta_path), 1)
+            read_value = other.get_root_knob(namespace, "COMPLEX_KNOB2").value
+            self.assertEqual(read_value["counter"], 5)
+            self.assertEqual(read_value["children"][1]["data"][0], 60)
+
+    def test_device_csv(self):
+        schema = Schema.parse(self.schemaTemplate)
+        namespace = "FE3ED49F-B173-41ED-9076-356661D46A42"
+        complex_knob = schema.get_root_knob(namespace, "COMPLEX_KNOB2")
+        counter = schema.get_knob(namespace, "COMPLEX_KNOB2.counter")
+        uint8_knob = schema.get_root_knob(namespace, "k_uint8_t_d10")
+
+        first_value = complex_knob.default
+        first_value["counter"] = 3
+        profiles = [
+            Profile.from_values(schema, "Device1", [(complex_knob, first_value)]),
+            Profile.from_values(schema, "Device2", [(uint8_knob, 12)]),
+            Profile("Device3", []),
+        ]
+
+        with tempfile.TemporaryDirectory() as temp_dir:
+            csv_path = os.path.join(temp_dir, "devices.csv")
+            write_device_csv(schema, csv_path, profiles)
+            with open(csv_path, "r") as csv_file:
+                rows = csv_file.read().splitlines()
+
+            # Only the knobs and members that differ on some device, with a column per device
+            self.assertEqual(rows[0], "Guid,Knob,Device1,Device2,Device3,Help")
+            self.assertEqual([row.split(",")[1] for row in rows[1:]],
+                             ["k_uint8_t_d10", "COMPLEX_KNOB2", "COMPLEX_KNOB2", counter.name])
+            self.assertEqual(rows[-1].split(",")[:5], ["*", counter.name, "3", "2", "2"])
+
+            loaded = load_device_profiles(schema, csv_path)
+            self.assertEqual([profile.name for profile in loaded], ["Device1", "Device2", "Device3"])
+            for (profile, other) in zip(profiles, loaded):
+                self.assertEqual(other.path, csv_path)
+                self.assertEqual(other.to_binary(schema), profile.to_binary(schema))
+
+            # An empty cell leaves the knob of that device to its default
+            with open(csv_path, "w", newline="") as csv_file:
+                csv_file.write("Guid,Knob,Device1,Device2\n{},k_uint8_t_d10,,14\n".format(namespace))
+            loaded = load_device_profiles(schema, csv_path)
+            self.assertEqual(loaded[0].get_overrides(schema), [])
+            self.assertEqual(loaded[1].get_value(uint8_knob), 14)
+
+            with pytest.raises(Exception):
+                write_device_csv(schema, csv_path, [Profile("Guid", [])])
+
+            with pytest.raises(Exception):
+                write_device_csv(schema, csv_path, [Profile("Device1", []), Profile("Device1", [])])
+
+    def test_schema_cache(self):
+        with tempfile.TemporaryDirectory() as temp_dir:
+            xml_path = os.path.join(temp_dir, "schema.xml")
+            with open(xml_path, "w") as xml_file:
+                xml_file.write(self.schemaTemplate)
+            with open(xml_path, "rb") as xml_file:
+                content = xml_file.read()
+
+            cache_dir = os.path.join(temp_dir, "cache")
+            with mock.patch.dict(os.environ, {SCHEMA_CACHE_DIR_ENV: cache_dir}):
+                cache_path = get_schema_cache_path(content)
+                self.assertEqual(os.path.dirname(cache_path), cache_dir)
+
+                schema = Schema.load(xml_path)
+                self.assertTrue(os.path.isfile(cache_path))
+                self.assertEqual(sorted(os.listdir(cache_dir)),
+                                 sorted([os.path.basename(cache_path), SCHEMA_CACHE_KEY_NAME]))
+
+                # The second load is served from the cache, without touching the DOM
+                with mock.patch("VariableList.parseString", side_effect=AssertionError):
+                    cached = Schema.load(xml_path)
+                self.assertEqual(cached.path, xml_path)
+                self.assertEqual([k.name for k in cached.subknobs], [k.name for k in schema.subknobs])
+                self.assertEqual(vlist_to_binary(cached), vlist_to_binary(schema))
+                self.assertIs(cached.get_root_knob(cached.knobs[0].namespace, cached.knobs[0].name), cached.knobs[0])
+
+                # Knobs of a cached schema do not share state with another load
+                cached.knobs[0].value = cached.knobs[0].default
+                self.assertIsNone(Schema.load(xml_path).knobs[0].value)
+
+                # Any edit of the XML is a different entry
+                self.assertNotEqual(get_schema_cache_path(content + b" "), cache_path)
+
+                # A corrupt entry is a miss and gets rewritten
+                with open(cache_path, "wb") as cache_file:
+                    cache_file.write(b"not a pickle")
+                self.assertEqual(vlist_to_binary(Schema.load(xml_path)), vlist_to_binary(schema))
+                with open(cache_path, "rb") as cache_file:
+                    self.assertNotEqual(cache_file.read(), b"not a pickle")
+
+                # A planted pickle without the HMAC of the cache key is a miss and is never unpickled
+                with open(cache_path, "wb") as cache_file:
+                    cache_file.write(b"\0" * SCHEMA_CACHE_MAC_SIZE + pickle.dumps(schema))
+                with mock.patch("VariableList.pickle.loads", side_effect=AssertionError):
+                    self.assertEqual(vlist_to_binary(Schema.load(xml_path)), vlist_to_binary(schema))
+
+                # An edit of the XSD is a different entry
+                xsd_path = os.path.join(temp_dir, "configschema.xsd")
+                with open(SCHEMA_XSD_PATH, "rb") as xsd_file, open(xsd_path, "wb") as edited_xsd_file:
+                    edited_xsd_file.write(xsd_file.read() + b" ")
+                with mock.patch("VariableList.SCHEMA_XSD_PATH", xsd_path), \
+                     mock.patch("VariableList._schema_loader_hash", None):
+                    self.assertNotEqual(get_schema_cache_path(content), cache_path)
+
+            with mock.patch.dict(os.environ, {SCHEMA_CACHE_DIR_ENV: ""}):
+                self.assertIsNone(get_schema_cache_path(content))
+
+            # By default the cache is per user, never in the source tree
+            with mock.patch.dict(os.environ, {"XDG_CACHE_HOME": temp_dir, "LOCALAPPDATA": temp_dir}):
+                os.environ.pop(SCHEMA_CACHE_DIR_ENV, None)
+                self.assertEqual(get_schema_cache_dir(), os.path.join(temp_dir, "mu_feature_config", "schema"))
+
+    def test_diff_vlists(self):
+        schema = Schema.parse(self.schemaTemplate)
+        namespace = "FE3ED49F-B173-41ED-9076-356661D46A42"
+        for knob in schema.knobs:
+            knob.value = knob.default
+
+        baseline = vlist_to_binary(schema)
+
+        # The same knobs in the aligned format do not differ
+        self.assertEqual(diff_vlists(baseline, vlist_to_aligned_binary(schema)), [])
+
+        changed = schema.get_root_knob(namespace, "COMPLEX_KNOB2")
+        value = changed.value
+        value["counter"] = 7
+        changed.value = value
+        removed = schema.knobs[0]
+        removed.value = None
+        other = vlist_to_binary(schema) + create_vlist_buffer(UEFIVariable("NotAKnob", namespace, b"\x01"))
+
+        deltas = diff_vlists(baseline, other)
+        self.assertEqual([delta.name for delta in deltas], ["COMPLEX_KNOB2", "NotAKnob", removed.name])
+        self.assertIsNone(deltas[1].baseline)
+        self.assertIsNone(deltas[2].variable)
+
+        knob_deltas = decode_knob_deltas(schema, deltas)
+        self.assertEqual(len(knob_deltas), 2)
+        (knob, baseline_value, value) = knob_deltas[0]
+        self.assertIs(knob, changed)
+        self.assertEqual(baseline_value["counter"], 2)
+        self.assertEqual(value["counter"], 7)
+        self.assertIs(knob_deltas[1][0], removed)
+        self.assertIsNone(knob_deltas[1][2])
+
 
 if __name__ == '__main__':
     unittest.main()
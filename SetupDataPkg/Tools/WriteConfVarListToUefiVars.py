@@ -12,7 +12,7 @@ import argparse
 import struct
 import uuid
 import ctypes
-from SettingSupport.UefiVariablesSupportLib import UefiVariable
+from SettingSupport.UefiVariablesSupportLib import UefiVariable, print_batch_progress
 
 gEfiGlobalVariableGuid = "8BE4DF61-93CA-11D2-AA0D-00E098032B8C"
 
@@ -30,6 +30,24 @@ def option_parser():
         help="""Specify the input setting file""",
     )
 
+    parser.add_argument(
+        "-s",
+        "--skip-unchanged",
+        dest="skip_unchanged",
+        action="store_true",
+        default=False,
+        help="""Read each variable first and only write the ones whose data or attributes differ""",
+    )
+
+    parser.add_argument(
+        "-q",
+        "--quiet",
+        dest="quiet",
+        action="store_true",
+        default=False,
+        help="""Do not print the progress of the variable writes""",
+    )
+
     arguments = parser.parse_args()
 
     if not os.path.isfile(arguments.setting_file):
@@ -66,24 +84,28 @@ def create_unpack_statement(NameStringSize, DataBufferSize):
 
 
 #
-# Using the passed byte array, extract the variable data and
-# write it into nvram
-#
-# Return the size of the un
+# Using the passed byte array, extract the variables of the dmpstore
+# Yields a tuple of (name, guid, data, attributes) for each variable
 #
-def extract_single_var_from_file_and_write_nvram(var):
-    # check that the passed byte array has at least enough space for the NameSize and DataSize
-    if len(var) > 8:
-        (NameSize, DataSize) = struct.unpack("<II", var[0:8])
+def extract_vars_from_file(var):
+    offset = 0
+    while offset < len(var):
+        # check that the passed byte array has at least enough space for the NameSize and DataSize
+        if len(var) - offset <= 8:
+            logging.critical("var buffer was too small to be a valid dmpstore")
+            return
+
+        (NameSize, DataSize) = struct.unpack_from("<II", var, offset)
 
         unpack_statement = create_unpack_statement(NameSize, DataSize)
+        unpack_size = struct.calcsize(unpack_statement)
 
         # check that the input byte array has at least enough space for unpack statement
-        if struct.calcsize(unpack_statement) > len(var):
+        if unpack_size > len(var) - offset:
             logging.critical("Input File Parsing error: input buffer is smaller than unpack size")
-            return len(var)
+            return
 
-        result = struct.unpack(unpack_statement, var[0: struct.calcsize(unpack_statement)])
+        result = struct.unpack_from(unpack_statement, var, offset)
 
         VarName = result[2].decode('utf16')
         Guid = uuid.UUID(bytes_le=result[3])
@@ -92,21 +114,8 @@ def extract_single_var_from_file_and_write_nvram(var):
 
         logging.debug(f"Found Variable: {VarName} {Guid} {Attributes}")
 
-        UefiVar = UefiVariable()
-        (rc, err, error_string) = UefiVar.SetUefiVar(
-            VarName,
-            Guid,
-            Data,
-            Attributes,
-        )
-        if rc == 0:
-            logging.debug(f"Error returned from SetUefiVar: {rc}")
-
-        return struct.calcsize(unpack_statement)
-    else:
-        logging.critical("var buffer was too small to be a valid dmpstore")
-
-    return len(var)
+        yield (VarName, Guid, Data, Attributes)
+        offset += unpack_size
 
 
 #
@@ -119,11 +128,18 @@ def main():
     with open(arguments.setting_file, "rb") as file:
         var = file.read()
 
-        # go through the entire file parsing each dmpstore variable
-        start = 0
-        while len(var[start:]) != 0:
-            start = start + extract_single_var_from_file_and_write_nvram(var[start:])
+    # write every dmpstore variable of the file with a single UefiVariable
+    UefiVar = UefiVariable()
+    (results, stats) = UefiVar.SetUefiVars(
+        extract_vars_from_file(var),
+        skip_unchanged=arguments.skip_unchanged,
+        progress=None if arguments.quiet else print_batch_progress,
+    )
+    for (rc, err, error_string) in results:
+        if rc == 0:
+            logging.debug(f"Error returned from SetUefiVar: {err}")
 
+    print(stats)
     return 0
 
 